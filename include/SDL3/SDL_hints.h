@@ -3215,6 +3215,42 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_METAL_PREFER_LOW_POWER_DEVICE "SDL_RENDER_METAL_PREFER_LOW_POWER_DEVICE"
 
+/**
+ * A variable controlling how the 2D render API renders sprites.
+ *
+ * The variable can be set to the following values:
+ *
+ * - "0": Use the driver copy API when the driver has one, and the geometry
+ *   API otherwise. (default)
+ * - "1": Always use the driver geometry API.
+ *
+ * This hint should be set before creating a renderer.
+ *
+ * \since This hint is available since SDL 3.4.0.
+ *
+ * \sa SDL_RenderSprites
+ */
+#define SDL_HINT_RENDER_SPRITES_GEOMETRY "SDL_RENDER_SPRITES_GEOMETRY"
+
+/**
+ * A variable controlling whether renderers pack small textures into shared
+ * atlas textures.
+ *
+ * When this is enabled, small static textures created with
+ * SDL_CreateTextureFromSurface() share larger textures, so drawing different
+ * ones one after another can be batched together.
+ *
+ * The variable can be set to the following values:
+ *
+ * - "0": Each texture is a separate texture. (default)
+ * - "1": Small textures are packed into shared atlas textures.
+ *
+ * This hint should be set before creating a renderer.
+ *
+ * \since This hint is available since SDL 3.4.0.
+ */
+#define SDL_HINT_RENDER_TEXTURE_ATLAS "SDL_RENDER_TEXTURE_ATLAS"
+
 /**
  * A variable controlling whether updates to the SDL screen surface should be
  * synchronized with the vertical refresh, to avoid tearing.
@@ -4505,6 +4541,22 @@ extern "C" {
  */
 #define SDL_HINT_WINDOWS_ERASE_BACKGROUND_MODE "SDL_WINDOWS_ERASE_BACKGROUND_MODE"
 
+/**
+ * A variable controlling the number of threads SDL uses to split up CPU heavy
+ * work, like converting large images with SDL_ConvertPixels().
+ *
+ * The variable can be set to the following values:
+ *
+ * - "0": Use one thread per logical CPU core. (default)
+ * - "1": Do all of the work on the calling thread.
+ * - "N": Use up to N threads, including the calling thread.
+ *
+ * This hint can be set anytime.
+ *
+ * \since This hint is available since SDL 3.4.0.
+ */
+#define SDL_HINT_WORKER_THREADS "SDL_WORKER_THREADS"
+
 /**
  * A variable controlling whether X11 windows are marked as override-redirect.
  *
@@ -93,6 +93,22 @@ typedef struct SDL_Vertex
     SDL_FPoint tex_coord;       /**< Normalized texture coordinates, if needed */
 } SDL_Vertex;
 
+/**
+ * A textured rectangle drawn by SDL_RenderSprites().
+ *
+ * \since This struct is available since SDL 3.4.0.
+ *
+ * \sa SDL_RenderSprites
+ */
+typedef struct SDL_Sprite
+{
+    SDL_FRect srcrect;          /**< The part of the texture to draw, or the whole texture if the width and height are 0 */
+    SDL_FRect dstrect;          /**< Where to draw it, in SDL_Renderer coordinates */
+    SDL_FColor color;           /**< The color the texture is multiplied by, on top of the texture color and alpha mod */
+    double angle;               /**< The rotation in degrees, clockwise around the center of dstrect */
+    SDL_FlipMode flip;          /**< The flipping to apply */
+} SDL_Sprite;
+
 /**
  * The access pattern allowed for a texture.
  *
@@ -293,6 +309,10 @@ extern SDL_DECLSPEC SDL_Renderer * SDLCALL SDL_CreateRenderer(SDL_Window *window
  * - `SDL_PROP_RENDERER_CREATE_PRESENT_VSYNC_NUMBER`: non-zero if you want
  *   present synchronized with the refresh rate. This property can take any
  *   value that is supported by SDL_SetRenderVSync() for the renderer.
+ * - `SDL_PROP_RENDERER_CREATE_TEXTURE_ATLAS_BOOLEAN`: true if small textures
+ *   created with SDL_CreateTextureFromSurface() should be packed into shared
+ *   atlas textures, so drawing different ones can be batched together,
+ *   defaults to the value of SDL_HINT_RENDER_TEXTURE_ATLAS (since SDL 3.4.0).
  *
  * With the SDL GPU renderer (since SDL 3.4.0):
  *
@@ -341,6 +361,7 @@ extern SDL_DECLSPEC SDL_Renderer * SDLCALL SDL_CreateRendererWithProperties(SDL_
 #define SDL_PROP_RENDERER_CREATE_SURFACE_POINTER                            "SDL.renderer.create.surface"
 #define SDL_PROP_RENDERER_CREATE_OUTPUT_COLORSPACE_NUMBER                   "SDL.renderer.create.output_colorspace"
 #define SDL_PROP_RENDERER_CREATE_PRESENT_VSYNC_NUMBER                       "SDL.renderer.create.present_vsync"
+#define SDL_PROP_RENDERER_CREATE_TEXTURE_ATLAS_BOOLEAN                      "SDL.renderer.create.texture_atlas"
 #define SDL_PROP_RENDERER_CREATE_GPU_DEVICE_POINTER                         "SDL.renderer.create.gpu.device"
 #define SDL_PROP_RENDERER_CREATE_GPU_SHADERS_SPIRV_BOOLEAN                  "SDL.renderer.create.gpu.shaders_spirv"
 #define SDL_PROP_RENDERER_CREATE_GPU_SHADERS_DXIL_BOOLEAN                   "SDL.renderer.create.gpu.shaders_dxil"
@@ -1323,6 +1344,78 @@ extern SDL_DECLSPEC bool SDLCALL SDL_GetTextureScaleMode(SDL_Texture *texture, S
  */
 extern SDL_DECLSPEC bool SDLCALL SDL_UpdateTexture(SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch);
 
+/**
+ * Start updating the given texture rectangle with new pixel data, without
+ * waiting for the upload to finish.
+ *
+ * The pixels are copied before this function returns, so the buffer may be
+ * reused right away, but on renderers that support it the copy to the
+ * texture happens on the GPU while the application goes on to prepare the
+ * next frame. Draws using the texture that are issued after this call will
+ * see the new pixels.
+ *
+ * The returned handle can be passed to SDL_IsTextureUploadComplete() or
+ * SDL_WaitForTextureUpload(). Uploads complete in the order they were
+ * started, so checking a handle also covers every upload started before it.
+ *
+ * On renderers without asynchronous uploads this behaves like
+ * SDL_UpdateTexture() and the upload is complete when it returns.
+ *
+ * \param texture the texture to update.
+ * \param rect an SDL_Rect structure representing the area to update, or NULL
+ *             to update the entire texture.
+ * \param pixels the raw pixel data in the format of the texture.
+ * \param pitch the number of bytes in a row of pixel data, including padding
+ *              between lines.
+ * \returns a handle for the upload or 0 on failure; call SDL_GetError() for
+ *          more information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_IsTextureUploadComplete
+ * \sa SDL_UpdateTexture
+ * \sa SDL_WaitForTextureUpload
+ */
+extern SDL_DECLSPEC Uint64 SDLCALL SDL_UpdateTextureAsync(SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch);
+
+/**
+ * Check whether an upload started with SDL_UpdateTextureAsync() has
+ * finished.
+ *
+ * \param renderer the rendering context the texture belongs to.
+ * \param upload the handle returned by SDL_UpdateTextureAsync().
+ * \returns true if the upload has finished or false if it is still in
+ *          progress or the handle is invalid; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_UpdateTextureAsync
+ * \sa SDL_WaitForTextureUpload
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_IsTextureUploadComplete(SDL_Renderer *renderer, Uint64 upload);
+
+/**
+ * Wait for an upload started with SDL_UpdateTextureAsync() to finish.
+ *
+ * \param renderer the rendering context the texture belongs to.
+ * \param upload the handle returned by SDL_UpdateTextureAsync().
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_IsTextureUploadComplete
+ * \sa SDL_UpdateTextureAsync
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_WaitForTextureUpload(SDL_Renderer *renderer, Uint64 upload);
+
 /**
  * Update a rectangle within a planar YV12 or IYUV texture with new pixel
  * data.
@@ -2302,6 +2395,31 @@ extern SDL_DECLSPEC bool SDLCALL SDL_RenderTextureRotated(SDL_Renderer *renderer
                                                      double angle, const SDL_FPoint *center,
                                                      SDL_FlipMode flip);
 
+/**
+ * Draw many parts of a texture to the current rendering target.
+ *
+ * Each sprite is drawn the way SDL_RenderTextureRotated() would draw it,
+ * rotating around the center of its destination rectangle, and tinted by its
+ * color. Drawing them with one call is much cheaper than calling
+ * SDL_RenderTexture() for each of them, and on most renderers they are drawn
+ * as a single batch.
+ *
+ * \param renderer the renderer which should copy parts of a texture.
+ * \param texture the source texture.
+ * \param sprites an array of sprites to draw.
+ * \param count the number of sprites.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_RenderTexture
+ * \sa SDL_RenderTextureRotated
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_RenderSprites(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Sprite *sprites, int count);
+
 /**
  * Copy a portion of the source texture to the current rendering target, with
  * affine transform, at subpixel precision.
@@ -2676,6 +2794,183 @@ extern SDL_DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer *renderer);
  */
 extern SDL_DECLSPEC bool SDLCALL SDL_FlushRenderer(SDL_Renderer *renderer);
 
+/**
+ * Get the number of render commands a renderer has queued and submitted.
+ *
+ * Before queued commands are sent to the render backend, viewport, clip
+ * rectangle and draw color changes that nothing is drawn with are removed,
+ * and consecutive draws that share a texture and render state are merged
+ * into one. The difference between the two counts shows how much of this
+ * happened.
+ *
+ * Commands are counted when they are sent to the backend, so the counts
+ * don't include commands that are still waiting to be flushed. They are
+ * totals since the renderer was created.
+ *
+ * \param renderer the rendering context.
+ * \param queued a pointer filled in with the number of commands queued, may
+ *               be NULL.
+ * \param submitted a pointer filled in with the number of commands submitted
+ *                  to the backend, may be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_FlushRenderer
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_GetRenderCommandCounts(SDL_Renderer *renderer, Uint64 *queued, Uint64 *submitted);
+
+/**
+ * Statistics about a frame drawn by a renderer.
+ *
+ * \since This struct is available since SDL 3.4.0.
+ *
+ * \sa SDL_GetRenderStats
+ */
+typedef struct SDL_RenderStats
+{
+    Uint64 frame;                   /**< The number of the frame, counting from 1 for the first frame presented */
+    Uint64 flush_ns;                /**< The CPU time spent sending render commands to the backend, in nanoseconds */
+    Uint64 present_ns;              /**< The CPU time spent in SDL_RenderPresent(), including sending the last commands and waiting for vsync, in nanoseconds */
+    Uint64 gpu_frame;               /**< The frame gpu_ns was measured for, or 0 if the GPU time isn't known */
+    Uint64 gpu_ns;                  /**< The time the GPU spent drawing gpu_frame, in nanoseconds */
+    Uint64 vertex_bytes;            /**< The number of bytes of vertex data sent to the backend */
+    Uint64 upload_bytes;            /**< The number of bytes of pixels uploaded to textures */
+    Uint64 present_pixels;          /**< The number of pixels sent to the window when the frame was presented, or 0 if the renderer doesn't track this */
+    Uint32 num_flushes;             /**< The number of times render commands were sent to the backend */
+    Uint32 num_commands_queued;     /**< The number of render commands queued */
+    Uint32 num_commands_submitted;  /**< The number of render commands sent to the backend */
+    Uint32 num_draws;               /**< The number of draw commands sent to the backend */
+    Uint32 num_clears;              /**< The number of clear commands sent to the backend */
+    Uint32 num_state_changes;       /**< The number of viewport, clip rectangle and draw color changes sent to the backend */
+    Uint32 num_texture_changes;     /**< The number of draws sent to the backend with a different texture than the draw before them */
+} SDL_RenderStats;
+
+/**
+ * Get statistics about the last frame a renderer presented.
+ *
+ * The statistics cover everything the renderer did from the end of the
+ * previous call to SDL_RenderPresent() to the end of the last one, so they
+ * are ready to read after presenting and don't change until the next frame
+ * is presented. Before the first frame is presented, they are all zero.
+ *
+ * Texture uploads are counted as the pixels handed to the backend by
+ * SDL_UpdateTexture(), SDL_UpdateYUVTexture(), SDL_UpdateNVTexture() and
+ * SDL_UnlockTexture(), including any conversion SDL does for textures in
+ * formats the backend doesn't support. The software renderer locks textures
+ * in place, so unlocking them isn't counted as an upload.
+ *
+ * GPU timing is only available on some renderers, and is usually measured a
+ * few frames late, so `gpu_frame` says which frame `gpu_ns` belongs to. The
+ * software renderer draws on the CPU, so its drawing time is part of
+ * `flush_ns`.
+ *
+ * \param renderer the rendering context.
+ * \param stats a pointer filled in with the statistics of the last frame.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_GetRenderCommandCounts
+ * \sa SDL_RenderPresent
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_GetRenderStats(SDL_Renderer *renderer, SDL_RenderStats *stats);
+
+/**
+ * Get information about the texture atlas of a renderer.
+ *
+ * When a renderer is created with
+ * `SDL_PROP_RENDERER_CREATE_TEXTURE_ATLAS_BOOLEAN` set to true, small static
+ * textures created with SDL_CreateTextureFromSurface() are packed into shared
+ * atlas pages, so that drawing one after another can be batched. Textures in
+ * the atlas can't repeat, so they are always drawn with
+ * SDL_TEXTURE_ADDRESS_CLAMP, and they don't have any of the renderer
+ * specific texture properties.
+ *
+ * \param renderer the rendering context.
+ * \param num_pages a pointer filled in with the number of atlas pages, may be
+ *                  NULL.
+ * \param num_textures a pointer filled in with the number of textures in the
+ *                     atlas, may be NULL.
+ * \param occupancy a pointer filled in with the fraction of the atlas pages
+ *                  covered by textures, from 0.0 to 1.0, may be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_CreateRendererWithProperties
+ * \sa SDL_GetRenderCommandCounts
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_GetRenderTextureAtlasInfo(SDL_Renderer *renderer, int *num_pages, int *num_textures, float *occupancy);
+
+/**
+ * Create a deferred renderer that records drawing for another renderer.
+ *
+ * A deferred renderer can be drawn to on any thread, with the usual drawing
+ * functions and the textures of `renderer`. Nothing is drawn until the
+ * recorded commands are added to the queue of `renderer` with
+ * SDL_SubmitDeferredRenderer(), which runs them as they were recorded.
+ *
+ * This lets several threads build parts of a large scene at the same time,
+ * each with its own deferred renderer, which are then submitted in order on
+ * the thread that uses `renderer`.
+ *
+ * A deferred renderer starts with the view `renderer` currently draws to: the
+ * output size, viewport, clip rectangle, scale and logical presentation. It
+ * has its own draw color, blend mode, viewport, clip rectangle and scale,
+ * which can be changed while recording. It can't create textures, change
+ * the render target or logical presentation, read pixels, or present.
+ *
+ * Textures that a deferred renderer has drawn must not be changed or
+ * destroyed until it has been submitted. The palette of a texture must be up
+ * to date on `renderer` before a deferred renderer can draw it.
+ *
+ * Deferred renderers are destroyed with SDL_DestroyRenderer(), and when
+ * `renderer` is destroyed.
+ *
+ * \param renderer the rendering context to record commands for.
+ * \returns a new deferred renderer or NULL on failure; call SDL_GetError()
+ *          for more information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_DestroyRenderer
+ * \sa SDL_SubmitDeferredRenderer
+ */
+extern SDL_DECLSPEC SDL_Renderer * SDLCALL SDL_CreateDeferredRenderer(SDL_Renderer *renderer);
+
+/**
+ * Add the commands recorded by a deferred renderer to its renderer's queue.
+ *
+ * The commands are drawn after anything already queued on the renderer, as
+ * if they had been drawn there, and the deferred renderer is emptied. It
+ * then picks up the view the renderer currently draws to, ready to record
+ * again.
+ *
+ * \param deferred the deferred renderer to submit.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread,
+ *               while no other thread is drawing with `deferred`.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_CreateDeferredRenderer
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_SubmitDeferredRenderer(SDL_Renderer *deferred);
+
 /**
  * Get the CAMetalLayer associated with the given Metal renderer.
  *
@@ -2804,6 +3099,21 @@ extern SDL_DECLSPEC bool SDLCALL SDL_GetRenderVSync(SDL_Renderer *renderer, int
  */
 #define SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE 8
 
+/**
+ * A string of debug text drawn by SDL_RenderDebugTexts().
+ *
+ * \since This struct is available since SDL 3.4.0.
+ *
+ * \sa SDL_RenderDebugTexts
+ */
+typedef struct SDL_DebugText
+{
+    float x;                    /**< The x coordinate where the top-left corner of the text will draw */
+    float y;                    /**< The y coordinate where the top-left corner of the text will draw */
+    SDL_FColor color;           /**< The color of the text */
+    const char *text;           /**< The UTF-8 string to draw */
+} SDL_DebugText;
+
 /**
  * Draw debug text to an SDL_Renderer.
  *
@@ -2873,6 +3183,33 @@ extern SDL_DECLSPEC bool SDLCALL SDL_RenderDebugText(SDL_Renderer *renderer, flo
  */
 extern SDL_DECLSPEC bool SDLCALL SDL_RenderDebugTextFormat(SDL_Renderer *renderer, float x, float y, SDL_PRINTF_FORMAT_STRING const char *fmt, ...) SDL_PRINTF_VARARG_FUNC(4);
 
+/**
+ * Draw many strings of debug text to an SDL_Renderer.
+ *
+ * Each string is drawn the way SDL_RenderDebugText() would draw it, but in
+ * its own color instead of the one specified by SDL_SetRenderDrawColor().
+ * The characters of all the strings are drawn from the same internal
+ * texture, and on most renderers they are drawn as a single batch, so this
+ * is much cheaper than calling SDL_RenderDebugText() for each of them.
+ *
+ * For the full list of limitations and other useful information, see
+ * SDL_RenderDebugText.
+ *
+ * \param renderer the renderer which should draw the text.
+ * \param texts an array of strings to draw.
+ * \param count the number of strings.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function should only be called on the main thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_RenderDebugText
+ * \sa SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_RenderDebugTexts(SDL_Renderer *renderer, const SDL_DebugText *texts, int count);
+
 /**
  * Set default scale mode for new textures for given renderer.
  *
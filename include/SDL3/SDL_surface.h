@@ -202,6 +202,42 @@ extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_CreateSurface(int width, int heigh
  */
 extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_CreateSurfaceFrom(int width, int height, SDL_PixelFormat format, void *pixels, int pitch);
 
+/**
+ * Create a surface that shares the pixels of a rectangle of another surface.
+ *
+ * No copy is made of the pixel data. The new surface points into the pixels
+ * of the original surface and uses the same pitch, so changes made through
+ * either surface are visible in the other. The view keeps a reference to the
+ * original surface, which stays valid until the view is destroyed.
+ *
+ * The view shares the palette of the original surface and starts with the
+ * same colorspace, properties, color key, blend mode, and color and alpha
+ * modulation. These can be changed on the view independently afterwards.
+ *
+ * The rectangle must lie within the surface. For formats with less than 8
+ * bits per pixel the left edge must fall on a byte boundary. Views of FourCC
+ * formats are not supported.
+ *
+ * If the original surface has RLE acceleration enabled, changes made through
+ * the view are not visible in its encoded pixels. Disable RLE on surfaces
+ * that are modified through views.
+ *
+ * \param surface the SDL_Surface structure to create a view of.
+ * \param rect the SDL_Rect structure representing the rectangle to view, or
+ *             NULL for the entire surface.
+ * \returns the new SDL_Surface structure that is created or NULL on failure;
+ *          call SDL_GetError() for more information.
+ *
+ * \threadsafety This function can be called on different threads with
+ *               different surfaces.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_CreateSurfaceFrom
+ * \sa SDL_DestroySurface
+ */
+extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_CreateSurfaceView(SDL_Surface *surface, const SDL_Rect *rect);
+
 /**
  * Free a surface.
  *
@@ -241,6 +277,36 @@ extern SDL_DECLSPEC void SDLCALL SDL_DestroySurface(SDL_Surface *surface);
  *   left edge of the image, if this surface is being used as a cursor.
  * - `SDL_PROP_SURFACE_HOTSPOT_Y_NUMBER`: the hotspot pixel offset from the
  *   top edge of the image, if this surface is being used as a cursor.
+ * - `SDL_PROP_SURFACE_DITHER_STRING`: the dithering used when converting
+ *   this surface to an 8-bit indexed format. Currently this supports
+ *   "ordered", which applies a 4x4 Bayer pattern, "floyd-steinberg", which
+ *   diffuses the error of each pixel to its neighbors, and "none", which
+ *   maps each pixel to the nearest palette color. This defaults to "none".
+ * - `SDL_PROP_SURFACE_CHROMA_FILTER_STRING`: the filter used to subsample
+ *   chroma when converting RGB pixels to a 4:2:0 YUV format with these
+ *   properties. Currently this supports "box", which averages each 2x2 block
+ *   of pixels, "sited", which weights the neighboring pixels to match the
+ *   chroma location of the destination colorspace, and "point", which uses
+ *   the top-left pixel of each 2x2 block. This defaults to "box".
+ * - `SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER`: the compression level
+ *   used when saving this surface with SDL_SavePNG_IO(), from 0 (no
+ *   compression) to 10 (smallest and slowest). This defaults to 6.
+ * - `SDL_PROP_SURFACE_PNG_FILTER_STRING`: the filter applied to each row
+ *   before it's compressed when saving this surface with SDL_SavePNG_IO().
+ *   Currently this supports the PNG filter types "none", "sub", "up",
+ *   "average" and "paeth", and "adaptive", which picks a filter for each
+ *   row of images that don't have a palette. This defaults to "none".
+ * - `SDL_PROP_SURFACE_PNG_STRATEGY_STRING`: the compression strategy used
+ *   when saving this surface with SDL_SavePNG_IO(). Currently this supports
+ *   "default", "filtered", which ignores short matches, "rle", which only
+ *   looks for runs of the same bytes, "huffman", which doesn't look for
+ *   matches at all, and "fixed", which doesn't build optimized Huffman
+ *   tables. This defaults to "default".
+ * - `SDL_PROP_SURFACE_PNG_PARALLEL_BOOLEAN`: true if large images should be
+ *   compressed in independent blocks on multiple threads when saving this
+ *   surface with SDL_SavePNG_IO(), which makes the file slightly larger. The
+ *   number of threads is controlled by SDL_HINT_WORKER_THREADS. This
+ *   defaults to false.
  *
  * \param surface the SDL_Surface structure to query.
  * \returns a valid property ID on success or 0 on failure; call
@@ -257,6 +323,12 @@ extern SDL_DECLSPEC SDL_PropertiesID SDLCALL SDL_GetSurfaceProperties(SDL_Surfac
 #define SDL_PROP_SURFACE_TONEMAP_OPERATOR_STRING            "SDL.surface.tonemap"
 #define SDL_PROP_SURFACE_HOTSPOT_X_NUMBER                   "SDL.surface.hotspot.x"
 #define SDL_PROP_SURFACE_HOTSPOT_Y_NUMBER                   "SDL.surface.hotspot.y"
+#define SDL_PROP_SURFACE_DITHER_STRING                      "SDL.surface.dither"
+#define SDL_PROP_SURFACE_CHROMA_FILTER_STRING               "SDL.surface.chroma_filter"
+#define SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER       "SDL.surface.png.compression_level"
+#define SDL_PROP_SURFACE_PNG_FILTER_STRING                  "SDL.surface.png.filter"
+#define SDL_PROP_SURFACE_PNG_STRATEGY_STRING                "SDL.surface.png.strategy"
+#define SDL_PROP_SURFACE_PNG_PARALLEL_BOOLEAN               "SDL.surface.png.parallel"
 
 /**
  * Set the colorspace used by a surface.
@@ -542,6 +614,225 @@ extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_LoadSurface_IO(SDL_IOStream *src,
  */
 extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_LoadSurface(const char *file);
 
+/**
+ * Load a BMP, PNG or JPEG image from a seekable SDL data stream, with the
+ * specified properties.
+ *
+ * PNG and JPEG images are decoded directly into the pixels of the new
+ * surface, converting them to the requested format a few rows at a time,
+ * rather than decoding the whole image and converting it afterwards.
+ *
+ * These are the supported properties:
+ *
+ * - `SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER`: an SDL_PixelFormat value, the
+ *   format of the new surface. Defaults to the format of the image.
+ * - `SDL_PROP_SURFACE_LOAD_SCALE_NUMBER`: load the image at 1/scale of its
+ *   size, rounded up. This may be 1, 2, 4 or 8, and defaults to 1. JPEG images
+ *   are scaled while they're decoded, which is much faster than decoding them
+ *   at full size, and useful for thumbnails. Other images are decoded at full
+ *   size and scaled down with SDL_SCALEMODE_LINEAR.
+ *
+ * The new surface should be freed with SDL_DestroySurface(). Not doing so
+ * will result in a memory leak.
+ *
+ * \param src the data stream for the surface.
+ * \param closeio if true, calls SDL_CloseIO() on `src` before returning, even
+ *                in the case of an error.
+ * \param props the properties to use.
+ * \returns a pointer to a new SDL_Surface structure or NULL on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_DestroySurface
+ * \sa SDL_LoadIntoSurface_IO
+ * \sa SDL_LoadSurface_IO
+ */
+extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_LoadSurfaceWithProperties(SDL_IOStream *src, bool closeio, SDL_PropertiesID props);
+
+#define SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER                 "SDL.surface.load.format"
+#define SDL_PROP_SURFACE_LOAD_SCALE_NUMBER                  "SDL.surface.load.scale"
+
+/**
+ * Load a BMP, PNG or JPEG image from a seekable SDL data stream into an
+ * existing surface.
+ *
+ * The image is written to the top left corner of the surface, converted to
+ * the format of the surface. If the image is larger than the surface it is
+ * cropped, and if it is smaller the rest of the surface is left unchanged.
+ * The clipping rectangle of the surface is ignored.
+ *
+ * This lets you reuse a surface, for example for a series of thumbnails,
+ * without allocating memory for each image. PNG and JPEG images are decoded
+ * directly into the pixels of the surface.
+ *
+ * `SDL_PROP_SURFACE_LOAD_SCALE_NUMBER` is supported, see
+ * SDL_LoadSurfaceWithProperties() for details.
+ *
+ * \param src the data stream for the surface.
+ * \param closeio if true, calls SDL_CloseIO() on `src` before returning, even
+ *                in the case of an error.
+ * \param surface the SDL_Surface structure to write the image to, this may
+ *                not have a YUV format.
+ * \param props the properties to use, may be 0.
+ * \param rect an SDL_Rect structure filled in with the area of the surface
+ *             that was written, may be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function can be called on different threads with
+ *               different surfaces.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_LoadSurfaceWithProperties
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_LoadIntoSurface_IO(SDL_IOStream *src, bool closeio, SDL_Surface *surface, SDL_PropertiesID props, SDL_Rect *rect);
+
+/**
+ * An object that loads images in the background.
+ *
+ * Files are read with SDL_LoadFileAsync() and decoded on a set of worker
+ * threads as their data arrives, so many images can be loaded at once, for
+ * example at startup, without blocking the calling thread on disk reads or
+ * decoding.
+ *
+ * \since This struct is available since SDL 3.4.0.
+ *
+ * \sa SDL_CreateSurfaceLoader
+ * \sa SDL_LoadSurfaceAsync
+ * \sa SDL_GetSurfaceLoaderResult
+ */
+typedef struct SDL_SurfaceLoader SDL_SurfaceLoader;
+
+/**
+ * Information about a completed image load.
+ *
+ * \since This struct is available since SDL 3.4.0.
+ *
+ * \sa SDL_GetSurfaceLoaderResult
+ * \sa SDL_WaitSurfaceLoaderResult
+ */
+typedef struct SDL_SurfaceLoaderOutcome
+{
+    SDL_Surface *surface;   /**< the loaded image, which the app should free with SDL_DestroySurface(), or NULL if loading failed. */
+    void *userdata;         /**< pointer provided by the app when starting the load. */
+} SDL_SurfaceLoaderOutcome;
+
+/**
+ * Create an object that loads images in the background.
+ *
+ * These are the supported properties:
+ *
+ * - `SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER` and
+ *   `SDL_PROP_SURFACE_LOAD_SCALE_NUMBER`: apply to every image, see
+ *   SDL_LoadSurfaceWithProperties() for details.
+ * - `SDL_PROP_SURFACE_LOADER_THREADS_NUMBER`: the number of threads decoding
+ *   images. Defaults to the value of SDL_HINT_WORKER_THREADS, or the number
+ *   of logical CPU cores.
+ *
+ * \param props the properties to use, may be 0.
+ * \returns a new SDL_SurfaceLoader or NULL on failure; call SDL_GetError()
+ *          for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_DestroySurfaceLoader
+ * \sa SDL_LoadSurfaceAsync
+ */
+extern SDL_DECLSPEC SDL_SurfaceLoader * SDLCALL SDL_CreateSurfaceLoader(SDL_PropertiesID props);
+
+#define SDL_PROP_SURFACE_LOADER_THREADS_NUMBER              "SDL.surface.loader.threads"
+
+/**
+ * Start loading a BMP, PNG or JPEG image from a file in the background.
+ *
+ * This function returns as quickly as possible. When the image has been
+ * loaded, or has failed to load, its outcome can be retrieved with
+ * SDL_GetSurfaceLoaderResult() or SDL_WaitSurfaceLoaderResult(). Images
+ * finish in any order, so `userdata` can be used to tell them apart.
+ *
+ * \param loader the SDL_SurfaceLoader to load the image with.
+ * \param file the path of the image to load.
+ * \param userdata an app-defined pointer that will be provided with the
+ *                 outcome.
+ * \returns true on success or false if the load couldn't be started; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_GetSurfaceLoaderResult
+ * \sa SDL_WaitSurfaceLoaderResult
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_LoadSurfaceAsync(SDL_SurfaceLoader *loader, const char *file, void *userdata);
+
+/**
+ * Query an SDL_SurfaceLoader for a completed image.
+ *
+ * If an image has finished loading, this will return true and fill in
+ * `outcome`. If the image failed to load, the surface in `outcome` will be
+ * NULL and SDL_GetError() will describe the failure. This function does not
+ * block.
+ *
+ * \param loader the SDL_SurfaceLoader to query.
+ * \param outcome details of a finished load will be written here. May not be
+ *                NULL.
+ * \returns true if a load has completed, false otherwise.
+ *
+ * \threadsafety It is safe to call this function from any thread; a
+ *               completed load will only go to one of the threads.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_WaitSurfaceLoaderResult
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_GetSurfaceLoaderResult(SDL_SurfaceLoader *loader, SDL_SurfaceLoaderOutcome *outcome);
+
+/**
+ * Block until an SDL_SurfaceLoader has a completed image.
+ *
+ * This works like SDL_GetSurfaceLoaderResult(), but waits up to `timeoutMS`
+ * for a load to complete. If there are no loads in progress, this returns
+ * false immediately rather than waiting.
+ *
+ * \param loader the SDL_SurfaceLoader to wait on.
+ * \param outcome details of a finished load will be written here. May not be
+ *                NULL.
+ * \param timeoutMS the maximum time to wait, in milliseconds, or -1 to wait
+ *                  indefinitely.
+ * \returns true if a load has completed, false otherwise.
+ *
+ * \threadsafety It is safe to call this function from any thread; a
+ *               completed load will only go to one of the threads.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_GetSurfaceLoaderResult
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_WaitSurfaceLoaderResult(SDL_SurfaceLoader *loader, SDL_SurfaceLoaderOutcome *outcome, Sint32 timeoutMS);
+
+/**
+ * Destroy an SDL_SurfaceLoader.
+ *
+ * This waits for any loads in progress to finish, and frees any images that
+ * haven't been retrieved.
+ *
+ * \param loader the SDL_SurfaceLoader to destroy.
+ *
+ * \threadsafety No other thread may be using the loader when this is called.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_CreateSurfaceLoader
+ */
+extern SDL_DECLSPEC void SDLCALL SDL_DestroySurfaceLoader(SDL_SurfaceLoader *loader);
+
 /**
  * Load a BMP image from a seekable SDL data stream.
  *
@@ -687,6 +978,10 @@ extern SDL_DECLSPEC SDL_Surface * SDLCALL SDL_LoadPNG(const char *file);
 /**
  * Save a surface to a seekable SDL data stream in PNG format.
  *
+ * The image is written to the stream as it's compressed. The compression
+ * can be tuned with the PNG properties of the surface, see
+ * SDL_GetSurfaceProperties().
+ *
  * \param surface the SDL_Surface structure containing the image to be saved.
  * \param dst a data stream to save to.
  * \param closeio if true, calls SDL_CloseIO() on `dst` before returning, even
@@ -1234,6 +1529,56 @@ extern SDL_DECLSPEC bool SDLCALL SDL_PremultiplyAlpha(int width, int height, SDL
  */
 extern SDL_DECLSPEC bool SDLCALL SDL_PremultiplySurfaceAlpha(SDL_Surface *surface, bool linear);
 
+/**
+ * Remove premultiplied alpha from a block of pixels.
+ *
+ * This divides the color channels of each pixel by its alpha, reversing
+ * SDL_PremultiplyAlpha(). Pixels with an alpha of zero have their color
+ * channels set to zero.
+ *
+ * This is safe to use with src == dst, but not for other overlapping areas.
+ *
+ * \param width the width of the block to convert, in pixels.
+ * \param height the height of the block to convert, in pixels.
+ * \param src_format an SDL_PixelFormat value of the `src` pixels format.
+ * \param src a pointer to the source pixels.
+ * \param src_pitch the pitch of the source pixels, in bytes.
+ * \param dst_format an SDL_PixelFormat value of the `dst` pixels format.
+ * \param dst a pointer to be filled in with straight alpha pixel data.
+ * \param dst_pitch the pitch of the destination pixels, in bytes.
+ * \param linear true if the pixels were premultiplied in linear space, false
+ *               if they were premultiplied in sRGB space.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety The same destination pixels should not be used from two
+ *               threads at once. It is safe to use the same source pixels
+ *               from multiple threads.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_PremultiplyAlpha
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_UnpremultiplyAlpha(int width, int height, SDL_PixelFormat src_format, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, bool linear);
+
+/**
+ * Remove premultiplied alpha from a surface.
+ *
+ * \param surface the surface to modify.
+ * \param linear true if the pixels were premultiplied in linear space, false
+ *               if they were premultiplied in sRGB space.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety This function can be called on different threads with
+ *               different surfaces.
+ *
+ * \since This function is available since SDL 3.4.0.
+ *
+ * \sa SDL_PremultiplySurfaceAlpha
+ */
+extern SDL_DECLSPEC bool SDLCALL SDL_UnpremultiplySurfaceAlpha(SDL_Surface *surface, bool linear);
+
 /**
  * Clear a surface with a specific color, with floating point precision.
  *
@@ -54,6 +54,7 @@
 #include "render/SDL_sysrender.h"
 #include "sensor/SDL_sensor_c.h"
 #include "stdlib/SDL_getenv_c.h"
+#include "thread/SDL_parallel_c.h"
 #include "thread/SDL_thread_c.h"
 #include "tray/SDL_tray_utils.h"
 #include "video/SDL_pixels_c.h"
@@ -695,6 +696,7 @@ void SDL_Quit(void)
 
     SDL_QuitTimers();
     SDL_QuitAsyncIO();
+    SDL_QuitParallel();
 
     SDL_SetObjectsInvalid();
     SDL_AssertionsQuit();
@@ -1296,3 +1296,23 @@
 #define SDL_RotateSurface SDL_RotateSurface_REAL
 #define SDL_LoadSurface_IO SDL_LoadSurface_IO_REAL
 #define SDL_LoadSurface SDL_LoadSurface_REAL
+#define SDL_CreateSurfaceView SDL_CreateSurfaceView_REAL
+#define SDL_UnpremultiplyAlpha SDL_UnpremultiplyAlpha_REAL
+#define SDL_UnpremultiplySurfaceAlpha SDL_UnpremultiplySurfaceAlpha_REAL
+#define SDL_LoadSurfaceWithProperties SDL_LoadSurfaceWithProperties_REAL
+#define SDL_LoadIntoSurface_IO SDL_LoadIntoSurface_IO_REAL
+#define SDL_CreateSurfaceLoader SDL_CreateSurfaceLoader_REAL
+#define SDL_LoadSurfaceAsync SDL_LoadSurfaceAsync_REAL
+#define SDL_GetSurfaceLoaderResult SDL_GetSurfaceLoaderResult_REAL
+#define SDL_WaitSurfaceLoaderResult SDL_WaitSurfaceLoaderResult_REAL
+#define SDL_DestroySurfaceLoader SDL_DestroySurfaceLoader_REAL
+#define SDL_GetRenderCommandCounts SDL_GetRenderCommandCounts_REAL
+#define SDL_RenderSprites SDL_RenderSprites_REAL
+#define SDL_GetRenderTextureAtlasInfo SDL_GetRenderTextureAtlasInfo_REAL
+#define SDL_CreateDeferredRenderer SDL_CreateDeferredRenderer_REAL
+#define SDL_SubmitDeferredRenderer SDL_SubmitDeferredRenderer_REAL
+#define SDL_RenderDebugTexts SDL_RenderDebugTexts_REAL
+#define SDL_GetRenderStats SDL_GetRenderStats_REAL
+#define SDL_UpdateTextureAsync SDL_UpdateTextureAsync_REAL
+#define SDL_IsTextureUploadComplete SDL_IsTextureUploadComplete_REAL
+#define SDL_WaitForTextureUpload SDL_WaitForTextureUpload_REAL
@@ -1304,3 +1304,23 @@ SDL_DYNAPI_PROC(SDL_Cursor*,SDL_CreateAnimatedCursor,(SDL_CursorFrameInfo *a,int
 SDL_DYNAPI_PROC(SDL_Surface*,SDL_RotateSurface,(SDL_Surface *a,float b),(a,b),return)
 SDL_DYNAPI_PROC(SDL_Surface*,SDL_LoadSurface_IO,(SDL_IOStream *a,bool b),(a,b),return)
 SDL_DYNAPI_PROC(SDL_Surface*,SDL_LoadSurface,(const char *a),(a),return)
+SDL_DYNAPI_PROC(SDL_Surface*,SDL_CreateSurfaceView,(SDL_Surface *a,const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(bool,SDL_UnpremultiplyAlpha,(int a,int b,SDL_PixelFormat c,const void *d,int e,SDL_PixelFormat f,void *g,int h,bool i),(a,b,c,d,e,f,g,h,i),return)
+SDL_DYNAPI_PROC(bool,SDL_UnpremultiplySurfaceAlpha,(SDL_Surface *a,bool b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_Surface*,SDL_LoadSurfaceWithProperties,(SDL_IOStream *a,bool b,SDL_PropertiesID c),(a,b,c),return)
+SDL_DYNAPI_PROC(bool,SDL_LoadIntoSurface_IO,(SDL_IOStream *a,bool b,SDL_Surface *c,SDL_PropertiesID d,SDL_Rect *e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(SDL_SurfaceLoader*,SDL_CreateSurfaceLoader,(SDL_PropertiesID a),(a),return)
+SDL_DYNAPI_PROC(bool,SDL_LoadSurfaceAsync,(SDL_SurfaceLoader *a,const char *b,void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(bool,SDL_GetSurfaceLoaderResult,(SDL_SurfaceLoader *a,SDL_SurfaceLoaderOutcome *b),(a,b),return)
+SDL_DYNAPI_PROC(bool,SDL_WaitSurfaceLoaderResult,(SDL_SurfaceLoader *a,SDL_SurfaceLoaderOutcome *b,Sint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(void,SDL_DestroySurfaceLoader,(SDL_SurfaceLoader *a),(a),)
+SDL_DYNAPI_PROC(bool,SDL_GetRenderCommandCounts,(SDL_Renderer *a,Uint64 *b,Uint64 *c),(a,b,c),return)
+SDL_DYNAPI_PROC(bool,SDL_RenderSprites,(SDL_Renderer *a,SDL_Texture *b,const SDL_Sprite *c,int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(bool,SDL_GetRenderTextureAtlasInfo,(SDL_Renderer *a,int *b,int *c,float *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(SDL_Renderer*,SDL_CreateDeferredRenderer,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(bool,SDL_SubmitDeferredRenderer,(SDL_Renderer *a),(a),return)
+SDL_DYNAPI_PROC(bool,SDL_RenderDebugTexts,(SDL_Renderer *a,const SDL_DebugText *b,int c),(a,b,c),return)
+SDL_DYNAPI_PROC(bool,SDL_GetRenderStats,(SDL_Renderer *a,SDL_RenderStats *b),(a,b),return)
+SDL_DYNAPI_PROC(Uint64,SDL_UpdateTextureAsync,(SDL_Texture *a,const SDL_Rect *b,const void *c,int d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(bool,SDL_IsTextureUploadComplete,(SDL_Renderer *a,Uint64 b),(a,b),return)
+SDL_DYNAPI_PROC(bool,SDL_WaitForTextureUpload,(SDL_Renderer *a,Uint64 b),(a,b),return)
@@ -23,6 +23,7 @@
 // The SDL 2D rendering system
 
 #include "SDL_sysrender.h"
+#include "SDL_render_atlas_c.h"
 #include "SDL_render_debug_font.h"
 #include "software/SDL_render_sw_c.h"
 #include "../events/SDL_windowevents_c.h"
@@ -62,6 +63,15 @@ this should probably be removed at some point in the future.  --ryan. */
         return result;                                                  \
     }
 
+#define CHECK_RENDERER_NOT_DEFERRED(renderer, result)                   \
+    if (renderer->parent) {                                             \
+        SDL_SetError("Deferred renderers can only record drawing");     \
+        return result;                                                  \
+    }
+
+// Deferred renderers draw with the textures of the renderer they record for
+#define TEXTURE_RENDERER(renderer) ((renderer)->parent ? (renderer)->parent : (renderer))
+
 #define CHECK_TEXTURE_MAGIC(texture, result)                            \
     CHECK_PARAM(!SDL_ObjectValid(texture, SDL_OBJECT_TYPE_TEXTURE)) {   \
         SDL_InvalidParamError("texture");                               \
@@ -307,8 +317,220 @@ static SDL_INLINE void DebugLogRenderCommands(const SDL_RenderCommand *cmd)
 #endif
 }
 
+static bool IsMergeableRenderCommand(SDL_Renderer *renderer, SDL_RenderCommandType type)
+{
+    switch (type) {
+    case SDL_RENDERCMD_DRAW_POINTS:
+    case SDL_RENDERCMD_FILL_RECTS:
+    case SDL_RENDERCMD_GEOMETRY:
+        return true;
+    case SDL_RENDERCMD_COPY:
+        return renderer->merge_copy_commands;
+    default:
+        // Lines are connected, so joining two lists would add a segment
+        return false;
+    }
+}
+
+static bool CanMergeRenderCommands(SDL_Renderer *renderer, const SDL_RenderCommand *prev, const SDL_RenderCommand *cmd)
+{
+    if (prev->command != cmd->command || !IsMergeableRenderCommand(renderer, cmd->command)) {
+        return false;
+    }
+
+    // The vertex data has to be one array, so the merged command can simply cover both
+    if (!prev->data.draw.vertex_size || !cmd->data.draw.vertex_size ||
+        prev->data.draw.first + prev->data.draw.vertex_size != cmd->data.draw.first) {
+        return false;
+    }
+
+    if (prev->data.draw.texture != cmd->data.draw.texture ||
+        (cmd->data.draw.texture && prev->data.draw.texture_scale_mode != cmd->data.draw.texture_scale_mode) ||
+        prev->data.draw.texture_address_mode_u != cmd->data.draw.texture_address_mode_u ||
+        prev->data.draw.texture_address_mode_v != cmd->data.draw.texture_address_mode_v ||
+        prev->data.draw.blend != cmd->data.draw.blend ||
+        prev->data.draw.gpu_render_state != cmd->data.draw.gpu_render_state ||
+        prev->data.draw.color_scale != cmd->data.draw.color_scale) {
+        return false;
+    }
+
+    // Geometry has its colors in the vertex data
+    if (cmd->command != SDL_RENDERCMD_GEOMETRY &&
+        SDL_memcmp(&prev->data.draw.color, &cmd->data.draw.color, sizeof(cmd->data.draw.color)) != 0) {
+        return false;
+    }
+    return true;
+}
+
+static bool IsSameRenderState(const SDL_RenderCommand *a, const SDL_RenderCommand *b)
+{
+    if (!a || !b) {
+        return false;
+    }
+
+    switch (a->command) {
+    case SDL_RENDERCMD_SETVIEWPORT:
+        return SDL_memcmp(&a->data.viewport.rect, &b->data.viewport.rect, sizeof(a->data.viewport.rect)) == 0;
+    case SDL_RENDERCMD_SETCLIPRECT:
+        return a->data.cliprect.enabled == b->data.cliprect.enabled &&
+               SDL_memcmp(&a->data.cliprect.rect, &b->data.cliprect.rect, sizeof(a->data.cliprect.rect)) == 0;
+    case SDL_RENDERCMD_SETDRAWCOLOR:
+        return a->data.color.color_scale == b->data.color.color_scale &&
+               SDL_memcmp(&a->data.color.color, &b->data.color.color, sizeof(a->data.color.color)) == 0;
+    default:
+        return false;
+    }
+}
+
+static void FreeRenderCommand(SDL_Renderer *renderer, SDL_RenderCommand *cmd)
+{
+    cmd->next = renderer->render_commands_pool;
+    renderer->render_commands_pool = cmd;
+}
+
+static void AppendRenderCommand(SDL_RenderCommand **head, SDL_RenderCommand **tail, SDL_RenderCommand *cmd)
+{
+    cmd->next = NULL;
+    if (*tail) {
+        (*tail)->next = cmd;
+    } else {
+        *head = cmd;
+    }
+    *tail = cmd;
+}
+
+/* Remove state changes that nothing draws with, and merge runs of draws that share
+ * a texture and render state, so every backend gets the shortest possible queue.
+ *
+ * State changes are held back until something draws. If another change of the same
+ * kind comes first, or the state ends up where it already was, they're dropped.
+ * Draws with nothing between them are joined when their vertex data is adjacent.
+ */
+static void OptimizeRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderCommand *pending[3];
+    const SDL_RenderCommand *current_viewport = NULL;
+    const SDL_RenderCommand *current_cliprect = NULL;
+    const SDL_RenderCommand *current_color = NULL;
+    SDL_RenderCommand *head = NULL, *tail = NULL;
+    SDL_RenderCommand *cmd, *next;
+    int num_pending = 0;
+    Uint64 submitted = 0;
+    int i;
+
+    for (cmd = renderer->render_commands; cmd; cmd = next) {
+        next = cmd->next;
+        ++renderer->num_commands_queued;
+
+        switch (cmd->command) {
+        case SDL_RENDERCMD_NO_OP:
+            FreeRenderCommand(renderer, cmd);
+            break;
+
+        case SDL_RENDERCMD_SETVIEWPORT:
+        case SDL_RENDERCMD_SETCLIPRECT:
+        case SDL_RENDERCMD_SETDRAWCOLOR:
+            // A change that nothing has used yet is replaced, the others keep their order
+            for (i = 0; i < num_pending; ++i) {
+                if (pending[i]->command == cmd->command) {
+                    FreeRenderCommand(renderer, pending[i]);
+                    --num_pending;
+                    SDL_memmove(&pending[i], &pending[i + 1], (num_pending - i) * sizeof(*pending));
+                    break;
+                }
+            }
+            pending[num_pending++] = cmd;
+            break;
+
+        default:
+        {
+            bool state_changed = false;
+
+            for (i = 0; i < num_pending; ++i) {
+                SDL_RenderCommand *state = pending[i];
+                const SDL_RenderCommand **current;
+
+                if (state->command == SDL_RENDERCMD_SETVIEWPORT) {
+                    current = &current_viewport;
+                } else if (state->command == SDL_RENDERCMD_SETCLIPRECT) {
+                    current = &current_cliprect;
+                } else {
+                    current = &current_color;
+                }
+                if (IsSameRenderState(state, *current)) {
+                    FreeRenderCommand(renderer, state);
+                } else {
+                    AppendRenderCommand(&head, &tail, state);
+                    *current = state;
+                    state_changed = true;
+                    ++submitted;
+                }
+            }
+            num_pending = 0;
+
+            if (!state_changed && tail && CanMergeRenderCommands(renderer, tail, cmd)) {
+                tail->data.draw.count += cmd->data.draw.count;
+                tail->data.draw.vertex_size += cmd->data.draw.vertex_size;
+                FreeRenderCommand(renderer, cmd);
+            } else {
+                AppendRenderCommand(&head, &tail, cmd);
+                ++submitted;
+            }
+            break;
+        }
+        }
+    }
+
+    // Changes at the end still apply to whatever the backend does next
+    for (i = 0; i < num_pending; ++i) {
+        AppendRenderCommand(&head, &tail, pending[i]);
+        ++submitted;
+    }
+
+    renderer->render_commands = head;
+    renderer->render_commands_tail = tail;
+    renderer->num_commands_submitted += submitted;
+}
+
+static void CountSubmittedRenderCommands(SDL_Renderer *renderer)
+{
+    SDL_RenderStats *stats = &renderer->frame_stats;
+    const SDL_RenderCommand *cmd;
+    const SDL_Texture *texture = NULL;
+
+    for (cmd = renderer->render_commands; cmd; cmd = cmd->next) {
+        switch (cmd->command) {
+        case SDL_RENDERCMD_SETVIEWPORT:
+        case SDL_RENDERCMD_SETCLIPRECT:
+        case SDL_RENDERCMD_SETDRAWCOLOR:
+            ++stats->num_state_changes;
+            break;
+
+        case SDL_RENDERCMD_CLEAR:
+            ++stats->num_clears;
+            break;
+
+        case SDL_RENDERCMD_NO_OP:
+            break;
+
+        default:
+            // The backend binds a texture for the first textured draw in every batch
+            ++stats->num_draws;
+            if (cmd->data.draw.texture != texture) {
+                ++stats->num_texture_changes;
+                texture = cmd->data.draw.texture;
+            }
+            break;
+        }
+    }
+}
+
 static bool FlushRenderCommands(SDL_Renderer *renderer)
 {
+    SDL_RenderStats *stats = &renderer->frame_stats;
+    const Uint64 queued = renderer->num_commands_queued;
+    const Uint64 submitted = renderer->num_commands_submitted;
+    Uint64 start;
     bool result;
 
     SDL_assert((renderer->render_commands == NULL) == (renderer->render_commands_tail == NULL));
@@ -318,9 +540,23 @@ static bool FlushRenderCommands(SDL_Renderer *renderer)
         return true;
     }
 
+    start = SDL_GetTicksNS();
+
+    OptimizeRenderCommands(renderer);
+
+    ++stats->num_flushes;
+    stats->num_commands_queued += (Uint32)(renderer->num_commands_queued - queued);
+    stats->num_commands_submitted += (Uint32)(renderer->num_commands_submitted - submitted);
+    stats->vertex_bytes += renderer->vertex_data_used;
+    CountSubmittedRenderCommands(renderer);
+
     DebugLogRenderCommands(renderer->render_commands);
 
-    result = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    if (renderer->render_commands) {
+        result = renderer->RunCommandQueue(renderer, renderer->render_commands, renderer->vertex_data, renderer->vertex_data_used);
+    } else {
+        result = true;  // everything queued was a no-op
+    }
 
     // Move the whole render command queue to the unused pool so we can reuse them next time.
     if (renderer->render_commands_tail) {
@@ -330,10 +566,17 @@ static bool FlushRenderCommands(SDL_Renderer *renderer)
         renderer->render_commands = NULL;
     }
     renderer->vertex_data_used = 0;
+    if (renderer->GetVertexMemory) {
+        // The backend has the vertices now, the next batch gets fresh memory
+        renderer->vertex_data = NULL;
+        renderer->vertex_data_allocation = 0;
+    }
     renderer->render_command_generation++;
     renderer->color_queued = false;
     renderer->viewport_queued = false;
     renderer->cliprect_queued = false;
+
+    stats->flush_ns += SDL_GetTicksNS() - start;
     return result;
 }
 
@@ -368,6 +611,9 @@ static bool FlushRenderCommandsIfGPURenderStateNeeded(SDL_GPURenderState *state)
 
 bool SDL_FlushRenderer(SDL_Renderer *renderer)
 {
+    CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
+
     if (!FlushRenderCommands(renderer)) {
         return false;
     }
@@ -375,6 +621,71 @@ bool SDL_FlushRenderer(SDL_Renderer *renderer)
     return true;
 }
 
+bool SDL_GetRenderCommandCounts(SDL_Renderer *renderer, Uint64 *queued, Uint64 *submitted)
+{
+    if (queued) {
+        *queued = 0;
+    }
+    if (submitted) {
+        *submitted = 0;
+    }
+
+    CHECK_RENDERER_MAGIC(renderer, false);
+
+    if (queued) {
+        *queued = renderer->num_commands_queued;
+    }
+    if (submitted) {
+        *submitted = renderer->num_commands_submitted;
+    }
+    return true;
+}
+
+bool SDL_GetRenderStats(SDL_Renderer *renderer, SDL_RenderStats *stats)
+{
+    CHECK_PARAM(!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    SDL_zerop(stats);
+
+    CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
+
+    *stats = renderer->last_frame_stats;
+    return true;
+}
+
+bool SDL_GetRenderTextureAtlasInfo(SDL_Renderer *renderer, int *num_pages, int *num_textures, float *occupancy)
+{
+    int pages = 0, textures = 0;
+    float used = 0.0f;
+
+    if (num_pages) {
+        *num_pages = 0;
+    }
+    if (num_textures) {
+        *num_textures = 0;
+    }
+    if (occupancy) {
+        *occupancy = 0.0f;
+    }
+
+    CHECK_RENDERER_MAGIC(renderer, false);
+
+    SDL_GetTextureAtlasStats(renderer, &pages, &textures, &used);
+    if (num_pages) {
+        *num_pages = pages;
+    }
+    if (num_textures) {
+        *num_textures = textures;
+    }
+    if (occupancy) {
+        *occupancy = used;
+    }
+    return true;
+}
+
 void *SDL_AllocateRenderVertices(SDL_Renderer *renderer, size_t numbytes, size_t alignment, size_t *offset)
 {
     const size_t needed = renderer->vertex_data_used + numbytes + alignment;
@@ -391,7 +702,11 @@ void *SDL_AllocateRenderVertices(SDL_Renderer *renderer, size_t numbytes, size_t
             newsize *= 2;
         }
 
-        ptr = SDL_realloc(renderer->vertex_data, newsize);
+        if (renderer->GetVertexMemory) {
+            ptr = renderer->GetVertexMemory(renderer, current_offset, &newsize);
+        } else {
+            ptr = SDL_realloc(renderer->vertex_data, newsize);
+        }
 
         if (!ptr) {
             return NULL;
@@ -563,8 +878,8 @@ static SDL_RenderCommand *PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_Ren
     SDL_BlendMode blendMode;
 
     if (texture) {
-        color = &texture->color;
-        blendMode = texture->blendMode;
+        color = &renderer->texture_color;
+        blendMode = renderer->texture_blend_mode;
     } else {
         color = &renderer->color;
         blendMode = renderer->blendMode;
@@ -594,12 +909,12 @@ static SDL_RenderCommand *PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_Ren
             cmd->data.draw.blend = blendMode;
             cmd->data.draw.texture = texture;
             if (texture) {
-                cmd->data.draw.texture_scale_mode = texture->scaleMode;
+                cmd->data.draw.texture_scale_mode = renderer->texture_scale_mode;
             }
             cmd->data.draw.texture_address_mode_u = SDL_TEXTURE_ADDRESS_CLAMP;
             cmd->data.draw.texture_address_mode_v = SDL_TEXTURE_ADDRESS_CLAMP;
             cmd->data.draw.gpu_render_state = renderer->gpu_render_state;
-            if (renderer->gpu_render_state) {
+            if (renderer->gpu_render_state && !renderer->parent) {
                 renderer->gpu_render_state->last_command_generation = renderer->render_command_generation;
             }
         }
@@ -607,15 +922,28 @@ static SDL_RenderCommand *PrepQueueCmdDraw(SDL_Renderer *renderer, const SDL_Ren
     return cmd;
 }
 
+static bool FinishQueueCmdDraw(SDL_Renderer *renderer, SDL_RenderCommand *cmd, size_t vertex_data_used, bool result)
+{
+    if (result) {
+        // Backends that keep their vertices elsewhere don't add to the vertex data
+        if (renderer->vertex_data_used > vertex_data_used && cmd->data.draw.first >= vertex_data_used) {
+            cmd->data.draw.vertex_size = renderer->vertex_data_used - cmd->data.draw.first;
+        } else {
+            cmd->data.draw.vertex_size = 0;
+        }
+    } else {
+        cmd->command = SDL_RENDERCMD_NO_OP;
+    }
+    return result;
+}
+
 static bool QueueCmdDrawPoints(SDL_Renderer *renderer, const SDL_FPoint *points, const int count)
 {
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_DRAW_POINTS, NULL);
     bool result = false;
     if (cmd) {
-        result = renderer->QueueDrawPoints(renderer, cmd, points, count);
-        if (!result) {
-            cmd->command = SDL_RENDERCMD_NO_OP;
-        }
+        const size_t vertex_data_used = renderer->vertex_data_used;
+        result = FinishQueueCmdDraw(renderer, cmd, vertex_data_used, renderer->QueueDrawPoints(renderer, cmd, points, count));
     }
     return result;
 }
@@ -625,10 +953,8 @@ static bool QueueCmdDrawLines(SDL_Renderer *renderer, const SDL_FPoint *points,
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_DRAW_LINES, NULL);
     bool result = false;
     if (cmd) {
-        result = renderer->QueueDrawLines(renderer, cmd, points, count);
-        if (!result) {
-            cmd->command = SDL_RENDERCMD_NO_OP;
-        }
+        const size_t vertex_data_used = renderer->vertex_data_used;
+        result = FinishQueueCmdDraw(renderer, cmd, vertex_data_used, renderer->QueueDrawLines(renderer, cmd, points, count));
     }
     return result;
 }
@@ -642,6 +968,8 @@ static bool QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, co
     cmd = PrepQueueCmdDraw(renderer, (use_rendergeometry ? SDL_RENDERCMD_GEOMETRY : SDL_RENDERCMD_FILL_RECTS), NULL);
 
     if (cmd) {
+        const size_t vertex_data_used = renderer->vertex_data_used;
+
         if (use_rendergeometry) {
             bool isstack1;
             bool isstack2;
@@ -688,25 +1016,19 @@ static bool QueueCmdFillRects(SDL_Renderer *renderer, const SDL_FRect *rects, co
                                                  xy, xy_stride, &renderer->color, 0 /* color_stride */, NULL, 0,
                                                  num_vertices, indices, num_indices, size_indices,
                                                  1.0f, 1.0f);
-
-                if (!result) {
-                    cmd->command = SDL_RENDERCMD_NO_OP;
-                }
             }
             SDL_small_free(xy, isstack1);
             SDL_small_free(indices, isstack2);
 
         } else {
             result = renderer->QueueFillRects(renderer, cmd, rects, count);
-            if (!result) {
-                cmd->command = SDL_RENDERCMD_NO_OP;
-            }
         }
+        result = FinishQueueCmdDraw(renderer, cmd, vertex_data_used, result);
     }
     return result;
 }
 
-static bool UpdateTexturePalette(SDL_Texture *texture)
+static bool UpdateTexturePalette(SDL_Renderer *draw_renderer, SDL_Texture *texture)
 {
     SDL_Renderer *renderer = texture->renderer;
     SDL_Palette *public = texture->public_palette;
@@ -719,6 +1041,14 @@ static bool UpdateTexturePalette(SDL_Texture *texture)
         return SDL_SetError("Texture doesn't have a palette");
     }
 
+    if (draw_renderer->parent) {
+        // Deferred renderers can't flush the renderer, the palette is marked as used when they're submitted
+        if (texture->native ? texture->palette_version != public->version : texture->palette->version != public->version) {
+            return SDL_SetError("Texture palette changed, draw with it on its renderer before recording it");
+        }
+        return true;
+    }
+
     if (texture->native) {
         // Keep the native texture in sync with palette updates
         if (texture->palette_version == public->version) {
@@ -760,15 +1090,47 @@ static bool UpdateTexturePalette(SDL_Texture *texture)
     return true;
 }
 
+// Returns the texture that is actually drawn from, moving srcrect to where the pixels are in it
+static SDL_Texture *GetDrawTexture(SDL_Renderer *renderer, SDL_Texture *texture, SDL_FRect *srcrect)
+{
+    // Draws take these from the renderer when they're queued
+    renderer->texture_color = texture->color;
+    renderer->texture_blend_mode = texture->blendMode;
+    renderer->texture_scale_mode = texture->scaleMode;
+
+    if (texture->native) {
+        texture = texture->native;
+    } else if (texture->atlas_page) {
+        SDL_Texture *page = texture->atlas_page->texture;
+
+        if (!renderer->parent) {
+            // The software renderer's geometry path draws the page itself
+            page->color = texture->color;
+            page->blendMode = texture->blendMode;
+            page->scaleMode = texture->scaleMode;
+        }
+
+        if (srcrect) {
+            srcrect->x += (float)texture->atlas_rect.x;
+            srcrect->y += (float)texture->atlas_rect.y;
+        }
+        texture = page;
+    }
+
+    // Deferred renderers mark the textures they used when they're submitted
+    if (!renderer->parent) {
+        texture->last_command_generation = renderer->render_command_generation;
+    }
+    return texture;
+}
+
 static bool QueueCmdCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_FRect *srcrect, const SDL_FRect *dstrect)
 {
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY, texture);
     bool result = false;
     if (cmd) {
-        result = renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect);
-        if (!result) {
-            cmd->command = SDL_RENDERCMD_NO_OP;
-        }
+        const size_t vertex_data_used = renderer->vertex_data_used;
+        result = FinishQueueCmdDraw(renderer, cmd, vertex_data_used, renderer->QueueCopy(renderer, cmd, texture, srcrect, dstrect));
     }
     return result;
 }
@@ -780,10 +1142,8 @@ static bool QueueCmdCopyEx(SDL_Renderer *renderer, SDL_Texture *texture,
     SDL_RenderCommand *cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_COPY_EX, texture);
     bool result = false;
     if (cmd) {
-        result = renderer->QueueCopyEx(renderer, cmd, texture, srcquad, dstrect, angle, center, flip, scale_x, scale_y);
-        if (!result) {
-            cmd->command = SDL_RENDERCMD_NO_OP;
-        }
+        const size_t vertex_data_used = renderer->vertex_data_used;
+        result = FinishQueueCmdDraw(renderer, cmd, vertex_data_used, renderer->QueueCopyEx(renderer, cmd, texture, srcquad, dstrect, angle, center, flip, scale_x, scale_y));
     }
     return result;
 }
@@ -801,6 +1161,7 @@ static bool QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
     bool result = false;
     cmd = PrepQueueCmdDraw(renderer, SDL_RENDERCMD_GEOMETRY, texture);
     if (cmd) {
+        const size_t vertex_data_used = renderer->vertex_data_used;
         cmd->data.draw.texture_address_mode_u = texture_address_mode_u;
         cmd->data.draw.texture_address_mode_v = texture_address_mode_v;
         result = renderer->QueueGeometry(renderer, cmd, texture,
@@ -808,9 +1169,7 @@ static bool QueueCmdGeometry(SDL_Renderer *renderer, SDL_Texture *texture,
                                          color, color_stride, uv, uv_stride,
                                          num_vertices, indices, num_indices, size_indices,
                                          scale_x, scale_y);
-        if (!result) {
-            cmd->command = SDL_RENDERCMD_NO_OP;
-        }
+        result = FinishQueueCmdDraw(renderer, cmd, vertex_data_used, result);
     }
     return result;
 }
@@ -881,6 +1240,7 @@ static void UpdateHDRProperties(SDL_Renderer *renderer)
 }
 
 static void UpdateLogicalPresentation(SDL_Renderer *renderer);
+static bool CreateDebugTextAtlas(SDL_Renderer *renderer);
 
 
 int SDL_GetNumRenderDrivers(void)
@@ -1086,6 +1446,8 @@ SDL_Renderer *SDL_CreateRendererWithProperties(SDL_PropertiesID props)
         SDL_SetNumberProperty(props, SDL_PROP_RENDERER_CREATE_PRESENT_VSYNC_NUMBER, SDL_GetHintBoolean(SDL_HINT_RENDER_VSYNC, true));
     }
 
+    renderer->texture_atlas = SDL_GetBooleanProperty(props, SDL_PROP_RENDERER_CREATE_TEXTURE_ATLAS_BOOLEAN, SDL_GetHintBoolean(SDL_HINT_RENDER_TEXTURE_ATLAS, false));
+
     if (surface) {
 #ifdef SDL_VIDEO_RENDER_SW
         const bool rc = SW_CreateRendererForSurface(renderer, surface, props);
@@ -1197,6 +1559,7 @@ SDL_Renderer *SDL_CreateRendererWithProperties(SDL_PropertiesID props)
     } else {
         renderer->line_method = SDL_GetRenderLineMethod();
     }
+    renderer->sprites_geometry = SDL_GetHintBoolean(SDL_HINT_RENDER_SPRITES_GEOMETRY, false);
 
     renderer->scale_mode = SDL_SCALEMODE_LINEAR;
 
@@ -1488,7 +1851,7 @@ static SDL_PixelFormat GetClosestSupportedFormat(SDL_Renderer *renderer, SDL_Pix
     return renderer->texture_formats[0];
 }
 
-SDL_Texture *SDL_CreateTextureWithProperties(SDL_Renderer *renderer, SDL_PropertiesID props)
+static SDL_Texture *CreateTexture(SDL_Renderer *renderer, SDL_PropertiesID props, bool allow_atlas)
 {
     SDL_Texture *texture;
     SDL_PixelFormat format = (SDL_PixelFormat)SDL_GetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_FORMAT_NUMBER, SDL_PIXELFORMAT_UNKNOWN);
@@ -1500,6 +1863,7 @@ SDL_Texture *SDL_CreateTextureWithProperties(SDL_Renderer *renderer, SDL_Propert
     bool texture_is_fourcc_and_target;
 
     CHECK_RENDERER_MAGIC(renderer, NULL);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, NULL);
 
     if (!format) {
         format = renderer->texture_formats[0];
@@ -1568,7 +1932,13 @@ SDL_Texture *SDL_CreateTextureWithProperties(SDL_Renderer *renderer, SDL_Propert
     // FOURCC format cannot be used directly by renderer back-ends for target texture
     texture_is_fourcc_and_target = (access == SDL_TEXTUREACCESS_TARGET && SDL_ISPIXELFORMAT_FOURCC(format));
 
-    if (!texture_is_fourcc_and_target && IsSupportedFormat(renderer, format)) {
+    if (allow_atlas && access == SDL_TEXTUREACCESS_STATIC && IsSupportedFormat(renderer, format) &&
+        SDL_CanAddTextureToAtlas(renderer, format, texture->colorspace, w, h) &&
+        texture->SDR_white_point == SDL_GetDefaultSDRWhitePoint(texture->colorspace) &&
+        texture->HDR_headroom == SDL_GetDefaultHDRHeadroom(texture->colorspace) &&
+        SDL_AddTextureToAtlas(renderer, texture)) {
+        // The pixels live in a shared atlas page
+    } else if (!texture_is_fourcc_and_target && IsSupportedFormat(renderer, format)) {
         if (!renderer->CreateTexture(renderer, texture, props)) {
             SDL_DestroyTexture(texture);
             return NULL;
@@ -1675,6 +2045,11 @@ SDL_Texture *SDL_CreateTextureWithProperties(SDL_Renderer *renderer, SDL_Propert
     return texture;
 }
 
+SDL_Texture *SDL_CreateTextureWithProperties(SDL_Renderer *renderer, SDL_PropertiesID props)
+{
+    return CreateTexture(renderer, props, false);
+}
+
 SDL_Texture *SDL_CreateTexture(SDL_Renderer *renderer, SDL_PixelFormat format, SDL_TextureAccess access, int w, int h)
 {
     SDL_Texture *texture;
@@ -1774,6 +2149,7 @@ SDL_Texture *SDL_CreateTextureFromSurface(SDL_Renderer *renderer, SDL_Surface *s
     SDL_Colorspace texture_colorspace = SDL_COLORSPACE_UNKNOWN;
 
     CHECK_RENDERER_MAGIC(renderer, NULL);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, NULL);
 
     CHECK_PARAM(!SDL_SurfaceValid(surface)) {
         SDL_InvalidParamError("SDL_CreateTextureFromSurface(): surface");
@@ -1889,7 +2265,7 @@ SDL_Texture *SDL_CreateTextureFromSurface(SDL_Renderer *renderer, SDL_Surface *s
     SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_ACCESS_NUMBER, SDL_TEXTUREACCESS_STATIC);
     SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_WIDTH_NUMBER, surface->w);
     SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_HEIGHT_NUMBER, surface->h);
-    texture = SDL_CreateTextureWithProperties(renderer, props);
+    texture = CreateTexture(renderer, props, true);
     SDL_DestroyProperties(props);
     if (!texture) {
         return NULL;
@@ -2219,6 +2595,16 @@ bool SDL_GetTextureScaleMode(SDL_Texture *texture, SDL_ScaleMode *scaleMode)
     return true;
 }
 
+// Counts the pixels handed to the backend for a texture, after any conversion
+static void CountUploadedPixels(SDL_Texture *texture, const SDL_Rect *rect)
+{
+    size_t size = 0;
+
+    if (SDL_CalculateSurfaceSize(texture->format, rect->w, rect->h, &size, NULL, true)) {
+        texture->renderer->frame_stats.upload_bytes += size;
+    }
+}
+
 #ifdef SDL_HAVE_YUV
 static bool SDL_UpdateTextureYUV(SDL_Texture *texture, const SDL_Rect *rect,
                                 const void *pixels, int pitch)
@@ -2352,15 +2738,94 @@ bool SDL_UpdateTexture(SDL_Texture *texture, const SDL_Rect *rect, const void *p
         return SDL_UpdateTexturePaletteSurface(texture, &real_rect, pixels, pitch);
     } else if (texture->native) {
         return SDL_UpdateTextureNative(texture, &real_rect, pixels, pitch);
+    } else if (texture->atlas_page) {
+        return SDL_UpdateAtlasTexture(texture, &real_rect, pixels, pitch);
     } else {
         SDL_Renderer *renderer = texture->renderer;
         if (!FlushRenderCommandsIfTextureNeeded(texture)) {
             return false;
         }
+        CountUploadedPixels(texture, &real_rect);
         return renderer->UpdateTexture(renderer, texture, &real_rect, pixels, pitch);
     }
 }
 
+Uint64 SDL_UpdateTextureAsync(SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch)
+{
+    SDL_Renderer *renderer;
+    SDL_Rect real_rect;
+    Uint64 upload;
+
+    CHECK_TEXTURE_MAGIC(texture, 0);
+
+    CHECK_PARAM(!pixels) {
+        SDL_InvalidParamError("pixels");
+        return 0;
+    }
+    CHECK_PARAM(!pitch) {
+        SDL_InvalidParamError("pitch");
+        return 0;
+    }
+
+    renderer = texture->renderer;
+    upload = renderer->last_texture_upload + 1;
+
+    real_rect.x = 0;
+    real_rect.y = 0;
+    real_rect.w = texture->w;
+    real_rect.h = texture->h;
+    if (rect && !SDL_GetRectIntersection(rect, &real_rect, &real_rect)) {
+        real_rect.w = real_rect.h = 0;
+    }
+
+    if (!renderer->UpdateTextureAsync || real_rect.w == 0 || real_rect.h == 0 ||
+#ifdef SDL_HAVE_YUV
+        texture->yuv ||
+#endif
+        texture->palette_surface || texture->native || texture->atlas_page) {
+        // The upload is finished by the time this returns
+        if (!SDL_UpdateTexture(texture, &real_rect, pixels, pitch)) {
+            return 0;
+        }
+    } else {
+        if (!FlushRenderCommandsIfTextureNeeded(texture)) {
+            return 0;
+        }
+        CountUploadedPixels(texture, &real_rect);
+        if (!renderer->UpdateTextureAsync(renderer, texture, &real_rect, pixels, pitch, upload)) {
+            return 0;
+        }
+    }
+
+    renderer->last_texture_upload = upload;
+    return upload;
+}
+
+static bool CheckTextureUpload(SDL_Renderer *renderer, Uint64 upload, bool wait)
+{
+    CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
+
+    CHECK_PARAM(upload == 0 || upload > renderer->last_texture_upload) {
+        return SDL_InvalidParamError("upload");
+    }
+
+    if (!renderer->IsTextureUploadComplete) {
+        return true;
+    }
+    return renderer->IsTextureUploadComplete(renderer, upload, wait);
+}
+
+bool SDL_IsTextureUploadComplete(SDL_Renderer *renderer, Uint64 upload)
+{
+    return CheckTextureUpload(renderer, upload, false);
+}
+
+bool SDL_WaitForTextureUpload(SDL_Renderer *renderer, Uint64 upload)
+{
+    return CheckTextureUpload(renderer, upload, true);
+}
+
 #ifdef SDL_HAVE_YUV
 static bool SDL_UpdateTextureYUVPlanar(SDL_Texture *texture, const SDL_Rect *rect,
                                       const Uint8 *Yplane, int Ypitch,
@@ -2524,6 +2989,7 @@ bool SDL_UpdateYUVTexture(SDL_Texture *texture, const SDL_Rect *rect,
             if (!FlushRenderCommandsIfTextureNeeded(texture)) {
                 return false;
             }
+            CountUploadedPixels(texture, &real_rect);
             return renderer->UpdateTextureYUV(renderer, texture, &real_rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -2585,6 +3051,7 @@ bool SDL_UpdateNVTexture(SDL_Texture *texture, const SDL_Rect *rect,
             if (!FlushRenderCommandsIfTextureNeeded(texture)) {
                 return false;
             }
+            CountUploadedPixels(texture, &real_rect);
             return renderer->UpdateTextureNV(renderer, texture, &real_rect, Yplane, Ypitch, UVplane, UVpitch);
         } else {
             return SDL_Unsupported();
@@ -2658,6 +3125,7 @@ bool SDL_LockTexture(SDL_Texture *texture, const SDL_Rect *rect, void **pixels,
         if (!FlushRenderCommandsIfTextureNeeded(texture)) {
             return false;
         }
+        texture->locked_rect = *rect;
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -2765,6 +3233,10 @@ void SDL_UnlockTexture(SDL_Texture *texture)
         SDL_UnlockTextureNative(texture);
     } else {
         SDL_Renderer *renderer = texture->renderer;
+        // The software renderer locks the texture pixels in place, so there's nothing to upload
+        if (!renderer->software) {
+            CountUploadedPixels(texture, &texture->locked_rect);
+        }
         renderer->UnlockTexture(renderer, texture);
     }
 
@@ -2777,6 +3249,7 @@ void SDL_UnlockTexture(SDL_Texture *texture)
 bool SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
 {
     CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
 
     // texture == NULL is valid and means reset the target to the window
     if (texture) {
@@ -2968,6 +3441,7 @@ static void UpdateLogicalPresentation(SDL_Renderer *renderer)
 bool SDL_SetRenderLogicalPresentation(SDL_Renderer *renderer, int w, int h, SDL_RendererLogicalPresentation mode)
 {
     CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
 
     SDL_RenderViewState *view = renderer->view;
     if (mode == SDL_LOGICAL_PRESENTATION_DISABLED) {
@@ -4094,7 +4568,7 @@ static bool SDL_RenderTextureInternal(SDL_Renderer *renderer, SDL_Texture *textu
         xy[7] = maxy;
 
         result = QueueCmdGeometry(renderer, texture,
-                                  xy, xy_stride, &texture->color, 0 /* color_stride */, uv, uv_stride,
+                                  xy, xy_stride, &renderer->texture_color, 0 /* color_stride */, uv, uv_stride,
                                   num_vertices, indices, num_indices, size_indices,
                                   scale_x, scale_y, SDL_TEXTURE_ADDRESS_CLAMP, SDL_TEXTURE_ADDRESS_CLAMP);
     } else {
@@ -4109,7 +4583,7 @@ bool SDL_RenderTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_F
     CHECK_RENDERER_MAGIC(renderer, false);
     CHECK_TEXTURE_MAGIC(texture, false);
 
-    CHECK_PARAM(renderer != texture->renderer) {
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
         return SDL_SetError("Texture was not created with this renderer");
     }
 
@@ -4137,15 +4611,11 @@ bool SDL_RenderTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_F
         dstrect = &full_dstrect;
     }
 
-    if (!UpdateTexturePalette(texture)) {
+    if (!UpdateTexturePalette(renderer, texture)) {
         return false;
     }
 
-    if (texture->native) {
-        texture = texture->native;
-    }
-
-    texture->last_command_generation = renderer->render_command_generation;
+    texture = GetDrawTexture(renderer, texture, &real_srcrect);
 
     return SDL_RenderTextureInternal(renderer, texture, &real_srcrect, dstrect);
 }
@@ -4160,7 +4630,7 @@ bool SDL_RenderTextureAffine(SDL_Renderer *renderer, SDL_Texture *texture,
     CHECK_RENDERER_MAGIC(renderer, false);
     CHECK_TEXTURE_MAGIC(texture, false);
 
-    CHECK_PARAM(renderer != texture->renderer) {
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
         return SDL_SetError("Texture was not created with this renderer");
     }
     if (!renderer->QueueCopyEx && !renderer->QueueGeometry) {
@@ -4186,15 +4656,11 @@ bool SDL_RenderTextureAffine(SDL_Renderer *renderer, SDL_Texture *texture,
 
     GetRenderViewportSize(renderer, &real_dstrect);
 
-    if (!UpdateTexturePalette(texture)) {
+    if (!UpdateTexturePalette(renderer, texture)) {
         return false;
     }
 
-    if (texture->native) {
-        texture = texture->native;
-    }
-
-    texture->last_command_generation = renderer->render_command_generation;
+    texture = GetDrawTexture(renderer, texture, &real_srcrect);
 
     const SDL_RenderViewState *view = renderer->view;
     const float scale_x = view->current_scale.x;
@@ -4263,7 +4729,7 @@ bool SDL_RenderTextureAffine(SDL_Renderer *renderer, SDL_Texture *texture,
         result = QueueCmdGeometry(
             renderer, texture,
             xy, xy_stride,
-            &texture->color, 0 /* color_stride */,
+            &renderer->texture_color, 0 /* color_stride */,
             uv, uv_stride,
             num_vertices, indices, num_indices, size_indices,
             scale_x, scale_y, SDL_TEXTURE_ADDRESS_CLAMP, SDL_TEXTURE_ADDRESS_CLAMP
@@ -4287,7 +4753,7 @@ bool SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL_Texture *texture,
     CHECK_RENDERER_MAGIC(renderer, false);
     CHECK_TEXTURE_MAGIC(texture, false);
 
-    CHECK_PARAM(renderer != texture->renderer) {
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
         return SDL_SetError("Texture was not created with this renderer");
     }
     if (!renderer->QueueCopyEx && !renderer->QueueGeometry) {
@@ -4318,13 +4784,11 @@ bool SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL_Texture *texture,
         dstrect = &full_dstrect;
     }
 
-    if (!UpdateTexturePalette(texture)) {
+    if (!UpdateTexturePalette(renderer, texture)) {
         return false;
     }
 
-    if (texture->native) {
-        texture = texture->native;
-    }
+    texture = GetDrawTexture(renderer, texture, &real_srcrect);
 
     if (center) {
         real_center = *center;
@@ -4333,8 +4797,6 @@ bool SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL_Texture *texture,
         real_center.y = dstrect->h / 2.0f;
     }
 
-    texture->last_command_generation = renderer->render_command_generation;
-
     const SDL_RenderViewState *view = renderer->view;
     const float scale_x = view->current_scale.x;
     const float scale_y = view->current_scale.y;
@@ -4418,7 +4880,7 @@ bool SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL_Texture *texture,
         xy[7] = (s_minx + c_maxy) + centery;
 
         result = QueueCmdGeometry(renderer, texture,
-                                  xy, xy_stride, &texture->color, 0 /* color_stride */, uv, uv_stride,
+                                  xy, xy_stride, &renderer->texture_color, 0 /* color_stride */, uv, uv_stride,
                                   num_vertices, indices, num_indices, size_indices,
                                   scale_x, scale_y, SDL_TEXTURE_ADDRESS_CLAMP, SDL_TEXTURE_ADDRESS_CLAMP);
     } else {
@@ -4427,6 +4889,318 @@ bool SDL_RenderTextureRotated(SDL_Renderer *renderer, SDL_Texture *texture,
     return result;
 }
 
+#define SPRITE_BATCH_SIZE 256
+
+typedef struct SpriteVertices
+{
+    float xy[SPRITE_BATCH_SIZE * 8];
+    float uv[SPRITE_BATCH_SIZE * 8];
+    SDL_FColor color[SPRITE_BATCH_SIZE * 4];
+    Uint16 indices[SPRITE_BATCH_SIZE * 6];
+} SpriteVertices;
+
+// bounds is where the sprite texture is in the texture that is drawn from
+static bool GetSpriteSourceRect(const SDL_FRect *bounds, const SDL_Sprite *sprite, SDL_FRect *srcrect)
+{
+    srcrect->x = 0.0f;
+    srcrect->y = 0.0f;
+    srcrect->w = bounds->w;
+    srcrect->h = bounds->h;
+    if (sprite->srcrect.w != 0.0f || sprite->srcrect.h != 0.0f) {
+        if (!SDL_GetRectIntersectionFloat(&sprite->srcrect, srcrect, srcrect)) {
+            return false;
+        }
+    }
+    srcrect->x += bounds->x;
+    srcrect->y += bounds->y;
+    return true;
+}
+
+static bool IsSpriteTransformed(const SDL_Sprite *sprite)
+{
+    return sprite->flip != SDL_FLIP_NONE || (int)(sprite->angle / 360) != sprite->angle / 360;
+}
+
+// This matches the vertices SDL_RenderTextureRotated() makes, rotating around the center of dstrect
+static void GetTransformedSpriteVertices(SDL_Texture *texture, const SDL_Sprite *sprite, const SDL_FRect *srcrect, float *xy, float *uv)
+{
+    const SDL_FRect *dstrect = &sprite->dstrect;
+    const float radian_angle = (float)((SDL_PI_D * sprite->angle) / 180.0);
+    const float s = SDL_sinf(radian_angle);
+    const float c = SDL_cosf(radian_angle);
+    const float centerx = dstrect->w / 2.0f + dstrect->x;
+    const float centery = dstrect->h / 2.0f + dstrect->y;
+    const float minu = srcrect->x / texture->w;
+    const float minv = srcrect->y / texture->h;
+    const float maxu = (srcrect->x + srcrect->w) / texture->w;
+    const float maxv = (srcrect->y + srcrect->h) / texture->h;
+    float minx, miny, maxx, maxy;
+
+    if (sprite->flip & SDL_FLIP_HORIZONTAL) {
+        minx = dstrect->x + dstrect->w;
+        maxx = dstrect->x;
+    } else {
+        minx = dstrect->x;
+        maxx = dstrect->x + dstrect->w;
+    }
+    if (sprite->flip & SDL_FLIP_VERTICAL) {
+        miny = dstrect->y + dstrect->h;
+        maxy = dstrect->y;
+    } else {
+        miny = dstrect->y;
+        maxy = dstrect->y + dstrect->h;
+    }
+
+    uv[0] = minu;
+    uv[1] = minv;
+    uv[2] = maxu;
+    uv[3] = minv;
+    uv[4] = maxu;
+    uv[5] = maxv;
+    uv[6] = minu;
+    uv[7] = maxv;
+
+    xy[0] = (c * (minx - centerx) - s * (miny - centery)) + centerx;
+    xy[1] = (s * (minx - centerx) + c * (miny - centery)) + centery;
+    xy[2] = (c * (maxx - centerx) - s * (miny - centery)) + centerx;
+    xy[3] = (s * (maxx - centerx) + c * (miny - centery)) + centery;
+    xy[4] = (c * (maxx - centerx) - s * (maxy - centery)) + centerx;
+    xy[5] = (s * (maxx - centerx) + c * (maxy - centery)) + centery;
+    xy[6] = (c * (minx - centerx) - s * (maxy - centery)) + centerx;
+    xy[7] = (s * (minx - centerx) + c * (maxy - centery)) + centery;
+}
+
+#ifdef SDL_SSE_INTRINSICS
+static void SDL_TARGETING("sse") GetSpriteVerticesSSE(SDL_Texture *texture, const SDL_FRect *srcrect, const SDL_FRect *dstrect, const SDL_FColor *color, float *xy, float *uv, SDL_FColor *colors)
+{
+    const __m128 size = _mm_setr_ps((float)texture->w, (float)texture->h, (float)texture->w, (float)texture->h);
+    const __m128 dst = _mm_loadu_ps(&dstrect->x);
+    const __m128 src = _mm_loadu_ps(&srcrect->x);
+    // (x, y, w, h) to (minx, miny, maxx, maxy)
+    const __m128 pos = _mm_add_ps(dst, _mm_movelh_ps(_mm_setzero_ps(), dst));
+    const __m128 tex = _mm_div_ps(_mm_add_ps(src, _mm_movelh_ps(_mm_setzero_ps(), src)), size);
+    const __m128 rgba = _mm_loadu_ps(&color->r);
+
+    _mm_storeu_ps(xy, _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(1, 2, 1, 0)));
+    _mm_storeu_ps(xy + 4, _mm_shuffle_ps(pos, pos, _MM_SHUFFLE(3, 0, 3, 2)));
+    _mm_storeu_ps(uv, _mm_shuffle_ps(tex, tex, _MM_SHUFFLE(1, 2, 1, 0)));
+    _mm_storeu_ps(uv + 4, _mm_shuffle_ps(tex, tex, _MM_SHUFFLE(3, 0, 3, 2)));
+    _mm_storeu_ps(&colors[0].r, rgba);
+    _mm_storeu_ps(&colors[1].r, rgba);
+    _mm_storeu_ps(&colors[2].r, rgba);
+    _mm_storeu_ps(&colors[3].r, rgba);
+}
+#endif
+
+static void GetSpriteVertices(SDL_Texture *texture, const SDL_FRect *srcrect, const SDL_FRect *dstrect, const SDL_FColor *color, float *xy, float *uv, SDL_FColor *colors)
+{
+    const float minu = srcrect->x / texture->w;
+    const float minv = srcrect->y / texture->h;
+    const float maxu = (srcrect->x + srcrect->w) / texture->w;
+    const float maxv = (srcrect->y + srcrect->h) / texture->h;
+    const float minx = dstrect->x;
+    const float miny = dstrect->y;
+    const float maxx = dstrect->x + dstrect->w;
+    const float maxy = dstrect->y + dstrect->h;
+
+    xy[0] = minx;
+    xy[1] = miny;
+    xy[2] = maxx;
+    xy[3] = miny;
+    xy[4] = maxx;
+    xy[5] = maxy;
+    xy[6] = minx;
+    xy[7] = maxy;
+
+    uv[0] = minu;
+    uv[1] = minv;
+    uv[2] = maxu;
+    uv[3] = minv;
+    uv[4] = maxu;
+    uv[5] = maxv;
+    uv[6] = minu;
+    uv[7] = maxv;
+
+    colors[0] = colors[1] = colors[2] = colors[3] = *color;
+}
+
+static SpriteVertices *CreateSpriteVertices(void)
+{
+    SpriteVertices *verts;
+    int i, n;
+
+    verts = (SpriteVertices *)SDL_malloc(sizeof(*verts));
+    if (!verts) {
+        return NULL;
+    }
+    for (i = 0; i < SPRITE_BATCH_SIZE; ++i) {
+        for (n = 0; n < 6; ++n) {
+            verts->indices[i * 6 + n] = (Uint16)(i * 4 + rect_index_order[n]);
+        }
+    }
+    return verts;
+}
+
+// If scratch is NULL, the vertices are built in a temporary buffer, otherwise in *scratch, which is created on first use
+static bool RenderSpritesGeometry(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_FRect *bounds, const SDL_Sprite *sprites, int count, SpriteVertices **scratch)
+{
+    const SDL_RenderViewState *view = renderer->view;
+    const float scale_x = view->current_scale.x;
+    const float scale_y = view->current_scale.y;
+    const SDL_FColor texture_color = renderer->texture_color;
+#ifdef SDL_SSE_INTRINSICS
+    const bool use_sse = SDL_HasSSE();
+#endif
+    SpriteVertices *verts = scratch ? *scratch : NULL;
+    bool result = true;
+    int i, n;
+
+    if (!verts) {
+        verts = CreateSpriteVertices();
+        if (!verts) {
+            return false;
+        }
+        if (scratch) {
+            *scratch = verts;
+        }
+    }
+
+    while (count > 0 && result) {
+        // Each batch becomes one geometry command
+        n = 0;
+        for (i = 0; i < count && n < SPRITE_BATCH_SIZE; ++i) {
+            const SDL_Sprite *sprite = &sprites[i];
+            float *xy = &verts->xy[n * 8];
+            float *uv = &verts->uv[n * 8];
+            SDL_FColor *colors = &verts->color[n * 4];
+            SDL_FColor color;
+            SDL_FRect srcrect;
+
+            if (!GetSpriteSourceRect(bounds, sprite, &srcrect)) {
+                continue;
+            }
+
+            color.r = sprite->color.r * texture_color.r;
+            color.g = sprite->color.g * texture_color.g;
+            color.b = sprite->color.b * texture_color.b;
+            color.a = sprite->color.a * texture_color.a;
+
+            if (IsSpriteTransformed(sprite)) {
+                GetTransformedSpriteVertices(texture, sprite, &srcrect, xy, uv);
+                colors[0] = colors[1] = colors[2] = colors[3] = color;
+#ifdef SDL_SSE_INTRINSICS
+            } else if (use_sse) {
+                GetSpriteVerticesSSE(texture, &srcrect, &sprite->dstrect, &color, xy, uv, colors);
+#endif
+            } else {
+                GetSpriteVertices(texture, &srcrect, &sprite->dstrect, &color, xy, uv, colors);
+            }
+            ++n;
+        }
+        sprites += i;
+        count -= i;
+
+        if (n > 0) {
+            result = QueueCmdGeometry(renderer, texture,
+                                      verts->xy, 2 * sizeof(float), verts->color, sizeof(SDL_FColor), verts->uv, 2 * sizeof(float),
+                                      n * 4, verts->indices, n * 6, sizeof(Uint16),
+                                      scale_x, scale_y, SDL_TEXTURE_ADDRESS_CLAMP, SDL_TEXTURE_ADDRESS_CLAMP);
+        }
+    }
+    if (!scratch) {
+        SDL_free(verts);
+    }
+    return result;
+}
+
+static bool RenderSpritesCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_FRect *bounds, const SDL_Sprite *sprites, int count)
+{
+    const SDL_RenderViewState *view = renderer->view;
+    const float scale_x = view->current_scale.x;
+    const float scale_y = view->current_scale.y;
+    const SDL_FColor texture_color = renderer->texture_color;
+    SpriteVertices *verts = NULL;
+    bool result = true;
+    int i;
+
+    // Copies take their color from the texture state, and adjacent ones with the same color are merged when flushing
+    for (i = 0; i < count && result; ++i) {
+        const SDL_Sprite *sprite = &sprites[i];
+        SDL_FRect srcrect;
+
+        if (!GetSpriteSourceRect(bounds, sprite, &srcrect)) {
+            continue;
+        }
+
+        if (IsSpriteTransformed(sprite) && !renderer->QueueCopyEx) {
+            renderer->texture_color = texture_color;
+            result = RenderSpritesGeometry(renderer, texture, bounds, sprite, 1, &verts);
+            continue;
+        }
+
+        renderer->texture_color.r = sprite->color.r * texture_color.r;
+        renderer->texture_color.g = sprite->color.g * texture_color.g;
+        renderer->texture_color.b = sprite->color.b * texture_color.b;
+        renderer->texture_color.a = sprite->color.a * texture_color.a;
+
+        if (IsSpriteTransformed(sprite)) {
+            const SDL_FPoint center = { sprite->dstrect.w / 2.0f, sprite->dstrect.h / 2.0f };
+            result = QueueCmdCopyEx(renderer, texture, &srcrect, &sprite->dstrect, sprite->angle, &center, sprite->flip, scale_x, scale_y);
+        } else {
+            const SDL_FRect rect = { sprite->dstrect.x * scale_x, sprite->dstrect.y * scale_y, sprite->dstrect.w * scale_x, sprite->dstrect.h * scale_y };
+            result = QueueCmdCopy(renderer, texture, &srcrect, &rect);
+        }
+    }
+    renderer->texture_color = texture_color;
+    SDL_free(verts);
+    return result;
+}
+
+bool SDL_RenderSprites(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Sprite *sprites, int count)
+{
+    SDL_FRect bounds;
+
+    CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_TEXTURE_MAGIC(texture, false);
+
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
+        return SDL_SetError("Texture was not created with this renderer");
+    }
+    CHECK_PARAM(!sprites) {
+        return SDL_InvalidParamError("sprites");
+    }
+    CHECK_PARAM(count < 0) {
+        return SDL_InvalidParamError("count");
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+#if DONT_DRAW_WHILE_HIDDEN
+    // Don't draw while we're hidden
+    if (renderer->hidden) {
+        return true;
+    }
+#endif
+
+    if (!UpdateTexturePalette(renderer, texture)) {
+        return false;
+    }
+
+    bounds.x = 0.0f;
+    bounds.y = 0.0f;
+    bounds.w = (float)texture->w;
+    bounds.h = (float)texture->h;
+    texture = GetDrawTexture(renderer, texture, &bounds);
+
+    if (renderer->QueueCopy && !renderer->sprites_geometry) {
+        return RenderSpritesCopy(renderer, texture, &bounds, sprites, count);
+    } else {
+        return RenderSpritesGeometry(renderer, texture, &bounds, sprites, count, NULL);
+    }
+}
+
 static bool SDL_RenderTextureTiled_Wrap(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_FRect *srcrect, float scale, const SDL_FRect *dstrect)
 {
     float xy[8];
@@ -4470,7 +5244,7 @@ static bool SDL_RenderTextureTiled_Wrap(SDL_Renderer *renderer, SDL_Texture *tex
 
     const SDL_RenderViewState *view = renderer->view;
     return QueueCmdGeometry(renderer, texture,
-                            xy, xy_stride, &texture->color, 0 /* color_stride */, uv, uv_stride,
+                            xy, xy_stride, &renderer->texture_color, 0 /* color_stride */, uv, uv_stride,
                             num_vertices, indices, num_indices, size_indices,
                             view->current_scale.x, view->current_scale.y,
                             SDL_TEXTURE_ADDRESS_WRAP, SDL_TEXTURE_ADDRESS_WRAP);
@@ -4547,7 +5321,7 @@ bool SDL_RenderTextureTiled(SDL_Renderer *renderer, SDL_Texture *texture, const
     CHECK_RENDERER_MAGIC(renderer, false);
     CHECK_TEXTURE_MAGIC(texture, false);
 
-    CHECK_PARAM(renderer != texture->renderer) {
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
         return SDL_SetError("Texture was not created with this renderer");
     }
 
@@ -4578,17 +5352,12 @@ bool SDL_RenderTextureTiled(SDL_Renderer *renderer, SDL_Texture *texture, const
         dstrect = &full_dstrect;
     }
 
-    if (!UpdateTexturePalette(texture)) {
+    if (!UpdateTexturePalette(renderer, texture)) {
         return false;
     }
 
-    if (texture->native) {
-        texture = texture->native;
-    }
-
-    texture->last_command_generation = renderer->render_command_generation;
-
-    bool do_wrapping = !renderer->software &&
+    // Textures in an atlas page can't repeat, so they're always drawn a tile at a time
+    bool do_wrapping = !renderer->software && !texture->atlas_page &&
                         (!srcrect ||
                             (real_srcrect.x == 0.0f && real_srcrect.y == 0.0f &&
                              real_srcrect.w == (float)texture->w && real_srcrect.h == (float)texture->h));
@@ -4598,6 +5367,8 @@ bool SDL_RenderTextureTiled(SDL_Renderer *renderer, SDL_Texture *texture, const
         }
     }
 
+    texture = GetDrawTexture(renderer, texture, &real_srcrect);
+
     // See if we can use geometry with repeating texture coordinates
     if (do_wrapping) {
         return SDL_RenderTextureTiled_Wrap(renderer, texture, &real_srcrect, scale, dstrect);
@@ -4618,7 +5389,7 @@ bool SDL_RenderTexture9Grid(SDL_Renderer *renderer, SDL_Texture *texture, const
     CHECK_RENDERER_MAGIC(renderer, false);
     CHECK_TEXTURE_MAGIC(texture, false);
 
-    CHECK_PARAM(renderer != texture->renderer) {
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
         return SDL_SetError("Texture was not created with this renderer");
     }
 
@@ -4755,7 +5526,7 @@ bool SDL_RenderTexture9GridTiled(SDL_Renderer *renderer, SDL_Texture *texture, c
     CHECK_RENDERER_MAGIC(renderer, false);
     CHECK_TEXTURE_MAGIC(texture, false);
 
-    CHECK_PARAM(renderer != texture->renderer) {
+    CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
         return SDL_SetError("Texture was not created with this renderer");
     }
 
@@ -5164,10 +5935,10 @@ static bool SDLCALL SDL_SW_RenderGeometryRaw(SDL_Renderer *renderer,
 
         // Check if UVs within range
         if (is_quad) {
-            const float *uv0_ = (const float *)((const char *)uv + A * color_stride);
-            const float *uv1_ = (const float *)((const char *)uv + B * color_stride);
-            const float *uv2_ = (const float *)((const char *)uv + C * color_stride);
-            const float *uv3_ = (const float *)((const char *)uv + C2 * color_stride);
+            const float *uv0_ = (const float *)((const char *)uv + A * uv_stride);
+            const float *uv1_ = (const float *)((const char *)uv + B * uv_stride);
+            const float *uv2_ = (const float *)((const char *)uv + C * uv_stride);
+            const float *uv3_ = (const float *)((const char *)uv + C2 * uv_stride);
             if (uv0_[0] >= 0.0f && uv0_[0] <= 1.0f &&
                 uv1_[0] >= 0.0f && uv1_[0] <= 1.0f &&
                 uv2_[0] >= 0.0f && uv2_[0] <= 1.0f &&
@@ -5299,13 +6070,17 @@ bool SDL_RenderGeometryRaw(SDL_Renderer *renderer,
     int count = indices ? num_indices : num_vertices;
     SDL_TextureAddressMode texture_address_mode_u = SDL_TEXTURE_ADDRESS_CLAMP;
     SDL_TextureAddressMode texture_address_mode_v = SDL_TEXTURE_ADDRESS_CLAMP;
+    SDL_Texture *atlas_texture = NULL;
+    float *atlas_uv = NULL;
+    bool isstack = false;
+    bool result;
 
     CHECK_RENDERER_MAGIC(renderer, false);
 
     if (texture) {
         CHECK_TEXTURE_MAGIC(texture, false);
 
-        CHECK_PARAM(renderer != texture->renderer) {
+        CHECK_PARAM(TEXTURE_RENDERER(renderer) != texture->renderer) {
             return SDL_SetError("Texture was not created with this renderer");
         }
     }
@@ -5353,13 +6128,14 @@ bool SDL_RenderGeometryRaw(SDL_Renderer *renderer,
     }
 
     if (texture) {
-        if (!UpdateTexturePalette(texture)) {
+        if (!UpdateTexturePalette(renderer, texture)) {
             return false;
         }
 
-        if (texture->native) {
-            texture = texture->native;
+        if (texture->atlas_page) {
+            atlas_texture = texture;
         }
+        texture = GetDrawTexture(renderer, texture, NULL);
 
         if (renderer->npot_texture_wrap_unsupported && IsNPOT(texture->w)) {
             texture_address_mode_u = SDL_TEXTURE_ADDRESS_CLAMP;
@@ -5402,6 +6178,12 @@ bool SDL_RenderGeometryRaw(SDL_Renderer *renderer,
                 texture_address_mode_v = SDL_TEXTURE_ADDRESS_CLAMP;
             }
         }
+
+        // Textures in an atlas page can't repeat
+        if (atlas_texture) {
+            texture_address_mode_u = SDL_TEXTURE_ADDRESS_CLAMP;
+            texture_address_mode_v = SDL_TEXTURE_ADDRESS_CLAMP;
+        }
     }
 
     if (indices) {
@@ -5420,27 +6202,50 @@ bool SDL_RenderGeometryRaw(SDL_Renderer *renderer,
         }
     }
 
-    if (texture) {
-        texture->last_command_generation = renderer->render_command_generation;
+    if (atlas_texture) {
+        // Move the texture coordinates to where the texture is in the atlas page
+        const SDL_Rect *rect = &atlas_texture->atlas_rect;
+        const float scale_u = (float)rect->w / texture->w;
+        const float scale_v = (float)rect->h / texture->h;
+        const float offset_u = (float)rect->x / texture->w;
+        const float offset_v = (float)rect->y / texture->h;
+
+        atlas_uv = SDL_small_alloc(float, num_vertices * 2, &isstack);
+        if (!atlas_uv) {
+            return false;
+        }
+        for (i = 0; i < num_vertices; ++i) {
+            const float *uv_ = (const float *)((const char *)uv + i * uv_stride);
+            atlas_uv[i * 2 + 0] = offset_u + SDL_clamp(uv_[0], 0.0f, 1.0f) * scale_u;
+            atlas_uv[i * 2 + 1] = offset_v + SDL_clamp(uv_[1], 0.0f, 1.0f) * scale_v;
+        }
+        uv = atlas_uv;
+        uv_stride = 2 * sizeof(float);
     }
 
     // For the software renderer, try to reinterpret triangles as SDL_Rect
 #ifdef SDL_VIDEO_RENDER_SW
-    if (renderer->software &&
+    if (renderer->software && !renderer->parent &&
         texture_address_mode_u == SDL_TEXTURE_ADDRESS_CLAMP &&
         texture_address_mode_v == SDL_TEXTURE_ADDRESS_CLAMP) {
-        return SDL_SW_RenderGeometryRaw(renderer, texture,
-                                        xy, xy_stride, color, color_stride, uv, uv_stride, num_vertices,
-                                        indices, num_indices, size_indices);
-    }
+        result = SDL_SW_RenderGeometryRaw(renderer, texture,
+                                          xy, xy_stride, color, color_stride, uv, uv_stride, num_vertices,
+                                          indices, num_indices, size_indices);
+    } else
 #endif
+    {
+        const SDL_RenderViewState *view = renderer->view;
+        result = QueueCmdGeometry(renderer, texture,
+                                  xy, xy_stride, color, color_stride, uv, uv_stride,
+                                  num_vertices, indices, num_indices, size_indices,
+                                  view->current_scale.x, view->current_scale.y,
+                                  texture_address_mode_u, texture_address_mode_v);
+    }
 
-    const SDL_RenderViewState *view = renderer->view;
-    return QueueCmdGeometry(renderer, texture,
-                            xy, xy_stride, color, color_stride, uv, uv_stride,
-                            num_vertices, indices, num_indices, size_indices,
-                            view->current_scale.x, view->current_scale.y,
-                            texture_address_mode_u, texture_address_mode_v);
+    if (atlas_uv) {
+        SDL_small_free(atlas_uv, isstack);
+    }
+    return result;
 }
 
 bool SDL_SetRenderTextureAddressMode(SDL_Renderer *renderer, SDL_TextureAddressMode u_mode, SDL_TextureAddressMode v_mode)
@@ -5475,6 +6280,7 @@ bool SDL_GetRenderTextureAddressMode(SDL_Renderer *renderer, SDL_TextureAddressM
 SDL_Surface *SDL_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect *rect)
 {
     CHECK_RENDERER_MAGIC(renderer, NULL);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, NULL);
 
     if (!renderer->RenderReadPixels) {
         SDL_Unsupported();
@@ -5578,6 +6384,7 @@ bool SDL_RenderPresent(SDL_Renderer *renderer)
     bool presented = true;
 
     CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
 
     CHECK_PARAM(renderer->target) {
         if (!renderer->window && SDL_strcmp(renderer->name, SDL_GPU_RENDERER) == 0) {
@@ -5587,6 +6394,9 @@ bool SDL_RenderPresent(SDL_Renderer *renderer)
         }
     }
 
+    const Uint64 start = SDL_GetTicksNS();
+    renderer->frame_stats.frame = renderer->last_frame_stats.frame + 1;
+
     if (renderer->transparent_window) {
         SDL_RenderApplyWindowShape(renderer);
     }
@@ -5607,6 +6417,14 @@ bool SDL_RenderPresent(SDL_Renderer *renderer)
         (!presented && renderer->wanted_vsync)) {
         SDL_SimulateRenderVSync(renderer);
     }
+
+    // The frame is done, start counting the next one
+    renderer->frame_stats.present_ns = SDL_GetTicksNS() - start;
+    if (renderer->GetGPUFrameTime) {
+        renderer->GetGPUFrameTime(renderer, &renderer->frame_stats.gpu_frame, &renderer->frame_stats.gpu_ns);
+    }
+    renderer->last_frame_stats = renderer->frame_stats;
+    SDL_zero(renderer->frame_stats);
     return true;
 }
 
@@ -5645,6 +6463,12 @@ static void SDL_DestroyTextureInternal(SDL_Texture *texture, bool is_destroying)
     if (texture->native) {
         SDL_DestroyTextureInternal(texture->native, is_destroying);
     }
+    if (texture->atlas_page) {
+        SDL_Texture *page = SDL_RemoveTextureFromAtlas(texture);
+        if (page) {
+            SDL_DestroyTextureInternal(page, is_destroying);
+        }
+    }
 #ifdef SDL_HAVE_YUV
     if (texture->yuv) {
         SDL_SW_DestroyYUVTexture(texture->yuv);
@@ -5707,6 +6531,30 @@ void SDL_DestroyRendererWithoutFreeing(SDL_Renderer *renderer)
 
     renderer->destroyed = true;
 
+    if (renderer->parent) {
+        // Deferred renderers only have the commands they recorded
+        SDL_Renderer **prev = &renderer->parent->deferred_renderers;
+        while (*prev != renderer) {
+            prev = &(*prev)->next;
+        }
+        *prev = renderer->next;
+
+        SDL_DiscardAllCommands(renderer);
+        SDL_free(renderer->vertex_data);
+        renderer->vertex_data = NULL;
+        SDL_free(renderer->debug_text_vertices);
+        renderer->debug_text_vertices = NULL;
+        if (renderer->props) {
+            SDL_DestroyProperties(renderer->props);
+            renderer->props = 0;
+        }
+        return;
+    }
+
+    while (renderer->deferred_renderers) {
+        SDL_DestroyRenderer(renderer->deferred_renderers);
+    }
+
     SDL_RemoveWindowEventWatch(SDL_WINDOW_EVENT_WATCH_NORMAL, SDL_RendererEventWatch, renderer);
 
     if (renderer->window) {
@@ -5727,6 +6575,8 @@ void SDL_DestroyRendererWithoutFreeing(SDL_Renderer *renderer)
         SDL_DestroyTexture(renderer->debug_char_texture_atlas);
         renderer->debug_char_texture_atlas = NULL;
     }
+    SDL_free(renderer->debug_text_vertices);
+    renderer->debug_text_vertices = NULL;
 
     // Free existing textures for this renderer
     while (renderer->textures) {
@@ -5734,6 +6584,7 @@ void SDL_DestroyRendererWithoutFreeing(SDL_Renderer *renderer)
         SDL_DestroyTextureInternal(renderer->textures, true /* is_destroying */);
         SDL_assert(tex != renderer->textures); // satisfy static analysis.
     }
+    SDL_assert(!renderer->atlas_pages); // they go away with the last texture in them
 
     // Free palette cache, which should be empty now
     if (renderer->palettes) {
@@ -5752,7 +6603,9 @@ void SDL_DestroyRendererWithoutFreeing(SDL_Renderer *renderer)
         renderer->target_mutex = NULL;
     }
     if (renderer->vertex_data) {
-        SDL_free(renderer->vertex_data);
+        if (!renderer->GetVertexMemory) {
+            SDL_free(renderer->vertex_data);
+        }
         renderer->vertex_data = NULL;
     }
     if (renderer->texture_formats) {
@@ -5796,6 +6649,166 @@ void SDL_DestroyRenderer(SDL_Renderer *renderer)
     SDL_free(renderer);
 }
 
+// The first vertex data of submitted commands is aligned for every backend's uniform and vertex data
+#define DEFERRED_VERTEX_ALIGNMENT 256
+
+static void SyncDeferredRenderer(SDL_Renderer *deferred)
+{
+    SDL_Renderer *renderer = deferred->parent;
+
+    // Recording starts with the view of whatever the renderer is drawing to
+    SDL_copyp(&deferred->main_view, renderer->view);
+    deferred->view = &deferred->main_view;
+    deferred->desired_color_scale = renderer->desired_color_scale;
+    deferred->color_scale = renderer->color_scale;
+    deferred->color_queued = false;
+    deferred->viewport_queued = false;
+    deferred->cliprect_queued = false;
+}
+
+SDL_Renderer *SDL_CreateDeferredRenderer(SDL_Renderer *renderer)
+{
+    SDL_Renderer *deferred;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, NULL);
+
+    if (renderer->deferred_unsupported) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    // Deferred renderers draw debug text with this renderer's font texture, which can't be created on other threads
+    if (!renderer->debug_char_texture_atlas && !CreateDebugTextAtlas(renderer)) {
+        return NULL;
+    }
+
+    deferred = (SDL_Renderer *)SDL_calloc(1, sizeof(*deferred));
+    if (!deferred) {
+        return NULL;
+    }
+
+    // Commands are recorded by the backend's Queue* functions, which only write to the command and vertex data
+    deferred->SupportsBlendMode = renderer->SupportsBlendMode;
+    deferred->QueueSetViewport = renderer->QueueSetViewport;
+    deferred->QueueSetDrawColor = renderer->QueueSetDrawColor;
+    deferred->QueueDrawPoints = renderer->QueueDrawPoints;
+    deferred->QueueDrawLines = renderer->QueueDrawLines;
+    deferred->QueueFillRects = renderer->QueueFillRects;
+    deferred->QueueCopy = renderer->QueueCopy;
+    deferred->QueueCopyEx = renderer->QueueCopyEx;
+    deferred->QueueGeometry = renderer->QueueGeometry;
+
+    deferred->name = renderer->name;
+    deferred->software = renderer->software;
+    deferred->npot_texture_wrap_unsupported = renderer->npot_texture_wrap_unsupported;
+    deferred->dpi_scale = renderer->dpi_scale;
+    deferred->line_method = renderer->line_method;
+    deferred->sprites_geometry = renderer->sprites_geometry;
+    deferred->scale_mode = renderer->scale_mode;
+    deferred->output_colorspace = renderer->output_colorspace;
+    deferred->SDR_white_point = renderer->SDR_white_point;
+    deferred->HDR_headroom = renderer->HDR_headroom;
+    deferred->color = renderer->color;
+    deferred->blendMode = renderer->blendMode;
+    deferred->texture_address_mode_u = renderer->texture_address_mode_u;
+    deferred->texture_address_mode_v = renderer->texture_address_mode_v;
+    deferred->internal = renderer->internal;
+    deferred->parent = renderer;
+    SyncDeferredRenderer(deferred);
+
+    SDL_SetObjectValid(deferred, SDL_OBJECT_TYPE_RENDERER, true);
+
+    deferred->next = renderer->deferred_renderers;
+    renderer->deferred_renderers = deferred;
+
+    return deferred;
+}
+
+bool SDL_SubmitDeferredRenderer(SDL_Renderer *deferred)
+{
+    SDL_Renderer *renderer;
+    SDL_RenderCommand *cmd;
+    size_t offset = 0;
+    int num_commands = 0;
+
+    CHECK_RENDERER_MAGIC(deferred, false);
+
+    renderer = deferred->parent;
+    CHECK_PARAM(!renderer) {
+        return SDL_SetError("Renderer is not a deferred renderer");
+    }
+
+    if (deferred->render_commands) {
+        if (deferred->vertex_data_used > 0) {
+            void *vertices = SDL_AllocateRenderVertices(renderer, deferred->vertex_data_used, DEFERRED_VERTEX_ALIGNMENT, &offset);
+            if (!vertices) {
+                return false;
+            }
+            SDL_memcpy(vertices, deferred->vertex_data, deferred->vertex_data_used);
+        }
+
+        // Move the commands to where their vertex data is now, and mark what they use as needed by the renderer
+        for (cmd = deferred->render_commands; cmd; cmd = cmd->next) {
+            switch (cmd->command) {
+            case SDL_RENDERCMD_SETVIEWPORT:
+                cmd->data.viewport.first += offset;
+                break;
+            case SDL_RENDERCMD_SETDRAWCOLOR:
+            case SDL_RENDERCMD_CLEAR:
+                cmd->data.color.first += offset;
+                break;
+            case SDL_RENDERCMD_DRAW_POINTS:
+            case SDL_RENDERCMD_DRAW_LINES:
+            case SDL_RENDERCMD_FILL_RECTS:
+            case SDL_RENDERCMD_COPY:
+            case SDL_RENDERCMD_COPY_EX:
+            case SDL_RENDERCMD_GEOMETRY:
+                cmd->data.draw.first += offset;
+                if (cmd->data.draw.texture) {
+                    cmd->data.draw.texture->last_command_generation = renderer->render_command_generation;
+                    if (cmd->data.draw.texture->palette) {
+                        cmd->data.draw.texture->palette->last_command_generation = renderer->render_command_generation;
+                    }
+                }
+                if (cmd->data.draw.gpu_render_state) {
+                    cmd->data.draw.gpu_render_state->last_command_generation = renderer->render_command_generation;
+                }
+                break;
+            default:
+                break;
+            }
+            ++num_commands;
+        }
+
+        if (renderer->render_commands_tail) {
+            renderer->render_commands_tail->next = deferred->render_commands;
+        } else {
+            renderer->render_commands = deferred->render_commands;
+        }
+        renderer->render_commands_tail = deferred->render_commands_tail;
+        deferred->render_commands = NULL;
+        deferred->render_commands_tail = NULL;
+        deferred->vertex_data_used = 0;
+
+        // Give back as many unused commands as were handed over, so recording again doesn't allocate
+        while (num_commands-- > 0 && renderer->render_commands_pool) {
+            cmd = renderer->render_commands_pool;
+            renderer->render_commands_pool = cmd->next;
+            cmd->next = deferred->render_commands_pool;
+            deferred->render_commands_pool = cmd;
+        }
+
+        // The commands set their own state, so the renderer has to set its state again
+        renderer->color_queued = false;
+        renderer->viewport_queued = false;
+        renderer->cliprect_queued = false;
+    }
+
+    SyncDeferredRenderer(deferred);
+    return true;
+}
+
 void *SDL_GetRenderMetalLayer(SDL_Renderer *renderer)
 {
     CHECK_RENDERER_MAGIC(renderer, NULL);
@@ -5929,6 +6942,7 @@ SDL_BlendOperation SDL_GetBlendModeAlphaOperation(SDL_BlendMode blendMode)
 bool SDL_SetRenderVSync(SDL_Renderer *renderer, int vsync)
 {
     CHECK_RENDERER_MAGIC(renderer, false);
+    CHECK_RENDERER_NOT_DEFERRED(renderer, false);
 
     renderer->wanted_vsync = vsync ? true : false;
 
@@ -6043,61 +7057,275 @@ static bool CreateDebugTextAtlas(SDL_Renderer *renderer)
     return texture != NULL;
 }
 
-static bool DrawDebugCharacter(SDL_Renderer *renderer, float x, float y, Uint32 c)
+// The most glyphs that can be drawn with one geometry command, using 16-bit indices
+#define SDL_DEBUG_TEXT_BATCH_SIZE 16384
+
+typedef struct DebugTextVertices
 {
-    SDL_assert(renderer->debug_char_texture_atlas != NULL);   // should have been created by now!
+    float *xy;
+    float *uv;
+    SDL_FColor *color;
+    Uint16 *indices;
+} DebugTextVertices;
+
+// Returns the glyph's position in the atlas, or -1 if the character is blank
+static int GetDebugGlyph(Uint32 c)
+{
+    if ((c <= 32) || ((c >= 127) && (c <= 160))) {
+        return -1;  // these are just completely blank chars, don't bother doing anything.
+    } else if (c >= SDL_DEBUG_FONT_NUM_GLYPHS) {
+        return SDL_DEBUG_FONT_NUM_GLYPHS - 1;  // use our "not a valid/supported character" glyph.
+    } else if (c < 127) {
+        return c - 33;     // adjust for the 33 blank glyphs at the start
+    } else {
+        return c - 67;     // adjust for the 33 blank glyphs at the start AND the 34 gap in the middle.
+    }
+}
 
+// bounds is where the atlas is in the texture that is drawn from
+static void GetDebugGlyphRect(const SDL_FRect *bounds, int glyph, SDL_FRect *srcrect)
+{
     const int charWidth = SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
     const int charHeight = SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
 
-    // Character index in cache
-    Uint32 ci = c;
-    if ((ci <= 32) || ((ci >= 127) && (ci <= 160))) {
-        return true;  // these are just completely blank chars, don't bother doing anything.
-    } else if (ci >= SDL_DEBUG_FONT_NUM_GLYPHS) {
-        ci = SDL_DEBUG_FONT_NUM_GLYPHS - 1;  // use our "not a valid/supported character" glyph.
-    } else if (ci < 127) {
-        ci -= 33;     // adjust for the 33 blank glyphs at the start
+    srcrect->x = bounds->x + (float)(((glyph % SDL_DEBUG_FONT_GLYPHS_PER_ROW) * (charWidth + 2)) + 1);
+    srcrect->y = bounds->y + (float)(((glyph / SDL_DEBUG_FONT_GLYPHS_PER_ROW) * (charHeight + 2)) + 1);
+    srcrect->w = (float)charWidth;
+    srcrect->h = (float)charHeight;
+}
+
+static bool GetDebugTextVertices(SDL_Renderer *renderer, int max_glyphs, DebugTextVertices *verts)
+{
+    const bool grow = (max_glyphs > renderer->debug_text_max_glyphs);
+    int i, n;
+
+    // The scratch space is kept with the renderer, so drawing text every frame doesn't allocate memory
+    if (grow) {
+        const size_t size = (size_t)max_glyphs * (16 * sizeof(float) + 4 * sizeof(SDL_FColor) + 6 * sizeof(Uint16));
+        void *vertices = SDL_realloc(renderer->debug_text_vertices, size);
+        if (!vertices) {
+            return false;
+        }
+        renderer->debug_text_vertices = vertices;
+        renderer->debug_text_max_glyphs = max_glyphs;
     } else {
-        ci -= 67;     // adjust for the 33 blank glyphs at the start AND the 34 gap in the middle.
+        max_glyphs = renderer->debug_text_max_glyphs;
+    }
+
+    verts->xy = (float *)renderer->debug_text_vertices;
+    verts->uv = verts->xy + max_glyphs * 8;
+    verts->color = (SDL_FColor *)(verts->uv + max_glyphs * 8);
+    verts->indices = (Uint16 *)(verts->color + max_glyphs * 4);
+    if (grow) {
+        // The indices are the same every time
+        for (i = 0; i < max_glyphs; ++i) {
+            for (n = 0; n < 6; ++n) {
+                verts->indices[i * 6 + n] = (Uint16)(i * 4 + rect_index_order[n]);
+            }
+        }
+    }
+    return true;
+}
+
+static bool RenderDebugTextGeometry(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_FRect *bounds, const SDL_DebugText *texts, int count)
+{
+    const SDL_RenderViewState *view = renderer->view;
+    const float scale_x = view->current_scale.x;
+    const float scale_y = view->current_scale.y;
+    const SDL_FColor texture_color = renderer->texture_color;
+#ifdef SDL_SSE_INTRINSICS
+    const bool use_sse = SDL_HasSSE();
+#endif
+    DebugTextVertices verts;
+    size_t max_glyphs = 0;
+    bool result = true;
+    int i, n = 0;
+
+    // Every glyph takes at least one byte of UTF-8
+    for (i = 0; i < count && max_glyphs < SDL_DEBUG_TEXT_BATCH_SIZE; ++i) {
+        max_glyphs += SDL_strlen(texts[i].text);
+    }
+    if (max_glyphs == 0) {
+        return true;
+    }
+    if (!GetDebugTextVertices(renderer, (int)SDL_min(max_glyphs, SDL_DEBUG_TEXT_BATCH_SIZE), &verts)) {
+        return false;
     }
 
-    const float src_x = (float) (((ci % SDL_DEBUG_FONT_GLYPHS_PER_ROW) * (charWidth + 2)) + 1);
-    const float src_y = (float) (((ci / SDL_DEBUG_FONT_GLYPHS_PER_ROW) * (charHeight + 2)) + 1);
+    for (i = 0; i < count && result; ++i) {
+        const SDL_DebugText *text = &texts[i];
+        const char *s = text->text;
+        SDL_FColor color;
+        SDL_FRect dstrect;
+        Uint32 ch;
+
+        color.r = text->color.r * texture_color.r;
+        color.g = text->color.g * texture_color.g;
+        color.b = text->color.b * texture_color.b;
+        color.a = text->color.a * texture_color.a;
+
+        dstrect.x = text->x;
+        dstrect.y = text->y;
+        dstrect.w = (float)SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+        dstrect.h = (float)SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+
+        while (result && (ch = SDL_StepUTF8(&s, NULL)) != 0) {
+            const int glyph = GetDebugGlyph(ch);
+
+            if (glyph >= 0) {
+                float *xy = &verts.xy[n * 8];
+                float *uv = &verts.uv[n * 8];
+                SDL_FColor *colors = &verts.color[n * 4];
+                SDL_FRect srcrect;
+
+                GetDebugGlyphRect(bounds, glyph, &srcrect);
+#ifdef SDL_SSE_INTRINSICS
+                if (use_sse) {
+                    GetSpriteVerticesSSE(texture, &srcrect, &dstrect, &color, xy, uv, colors);
+                } else
+#endif
+                {
+                    GetSpriteVertices(texture, &srcrect, &dstrect, &color, xy, uv, colors);
+                }
 
-    // Draw texture onto destination
-    const SDL_FRect srect = { src_x, src_y, (float) charWidth, (float) charHeight };
-    const SDL_FRect drect = { x, y, (float) charWidth, (float) charHeight };
-    return SDL_RenderTexture(renderer, renderer->debug_char_texture_atlas, &srect, &drect);
+                // All the text goes in one geometry command, unless there's more than one batch of it
+                if (++n == renderer->debug_text_max_glyphs) {
+                    result = QueueCmdGeometry(renderer, texture,
+                                              verts.xy, 2 * sizeof(float), verts.color, sizeof(SDL_FColor), verts.uv, 2 * sizeof(float),
+                                              n * 4, verts.indices, n * 6, sizeof(Uint16),
+                                              scale_x, scale_y, SDL_TEXTURE_ADDRESS_CLAMP, SDL_TEXTURE_ADDRESS_CLAMP);
+                    n = 0;
+                }
+            }
+            dstrect.x += (float)SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+        }
+    }
+
+    if (n > 0 && result) {
+        result = QueueCmdGeometry(renderer, texture,
+                                  verts.xy, 2 * sizeof(float), verts.color, sizeof(SDL_FColor), verts.uv, 2 * sizeof(float),
+                                  n * 4, verts.indices, n * 6, sizeof(Uint16),
+                                  scale_x, scale_y, SDL_TEXTURE_ADDRESS_CLAMP, SDL_TEXTURE_ADDRESS_CLAMP);
+    }
+    return result;
 }
 
-bool SDL_RenderDebugText(SDL_Renderer *renderer, float x, float y, const char *s)
+static bool RenderDebugTextCopy(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_FRect *bounds, const SDL_DebugText *texts, int count)
 {
-    CHECK_RENDERER_MAGIC(renderer, false);
+    const SDL_RenderViewState *view = renderer->view;
+    const float scale_x = view->current_scale.x;
+    const float scale_y = view->current_scale.y;
+    const float size = (float)SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+    const SDL_FColor texture_color = renderer->texture_color;
+    bool result = true;
+    int i;
+
+    // Adjacent copies in the same color are merged into one command when flushing
+    for (i = 0; i < count && result; ++i) {
+        const SDL_DebugText *text = &texts[i];
+        const char *s = text->text;
+        float x = text->x;
+        Uint32 ch;
+
+        renderer->texture_color.r = text->color.r * texture_color.r;
+        renderer->texture_color.g = text->color.g * texture_color.g;
+        renderer->texture_color.b = text->color.b * texture_color.b;
+        renderer->texture_color.a = text->color.a * texture_color.a;
+
+        while (result && (ch = SDL_StepUTF8(&s, NULL)) != 0) {
+            const int glyph = GetDebugGlyph(ch);
 
-    // Allocate a texture atlas for this renderer if needed.
-    if (!renderer->debug_char_texture_atlas) {
-        if (!CreateDebugTextAtlas(renderer)) {
+            if (glyph >= 0) {
+                const SDL_FRect rect = { x * scale_x, text->y * scale_y, size * scale_x, size * scale_y };
+                SDL_FRect srcrect;
+
+                GetDebugGlyphRect(bounds, glyph, &srcrect);
+                result = QueueCmdCopy(renderer, texture, &srcrect, &rect);
+            }
+            x += size;
+        }
+    }
+    renderer->texture_color = texture_color;
+    return result;
+}
+
+static bool RenderDebugTexts(SDL_Renderer *renderer, const SDL_DebugText *texts, int count)
+{
+    SDL_Texture *texture;
+    SDL_FRect bounds;
+
+#if DONT_DRAW_WHILE_HIDDEN
+    // Don't draw while we're hidden
+    if (renderer->hidden) {
+        return true;
+    }
+#endif
+
+    // Allocate a texture atlas for this renderer if needed. Deferred renderers use the one created with them.
+    SDL_Renderer *owner = TEXTURE_RENDERER(renderer);
+    if (!owner->debug_char_texture_atlas) {
+        if (!CreateDebugTextAtlas(owner)) {
             return false;
         }
     }
 
-    bool result = true;
+    texture = owner->debug_char_texture_atlas;
+    bounds.x = 0.0f;
+    bounds.y = 0.0f;
+    bounds.w = (float)texture->w;
+    bounds.h = (float)texture->h;
+    texture = GetDrawTexture(renderer, texture, &bounds);
+
+    if (renderer->QueueCopy) {
+        return RenderDebugTextCopy(renderer, texture, &bounds, texts, count);
+    } else {
+        return RenderDebugTextGeometry(renderer, texture, &bounds, texts, count);
+    }
+}
 
+bool SDL_RenderDebugText(SDL_Renderer *renderer, float x, float y, const char *s)
+{
+    SDL_DebugText text;
     Uint8 r, g, b, a;
-    result &= SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a);
-    result &= SDL_SetTextureColorMod(renderer->debug_char_texture_atlas, r, g, b);
-    result &= SDL_SetTextureAlphaMod(renderer->debug_char_texture_atlas, a);
 
-    float curx = x;
-    Uint32 ch;
+    CHECK_RENDERER_MAGIC(renderer, false);
 
-    while (result && ((ch = SDL_StepUTF8(&s, NULL)) != 0)) {
-        result &= DrawDebugCharacter(renderer, curx, y, ch);
-        curx += SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE;
+    if (!SDL_GetRenderDrawColor(renderer, &r, &g, &b, &a)) {
+        return false;
     }
 
-    return result;
+    text.x = x;
+    text.y = y;
+    text.color.r = r / 255.0f;
+    text.color.g = g / 255.0f;
+    text.color.b = b / 255.0f;
+    text.color.a = a / 255.0f;
+    text.text = s;
+    return RenderDebugTexts(renderer, &text, 1);
+}
+
+bool SDL_RenderDebugTexts(SDL_Renderer *renderer, const SDL_DebugText *texts, int count)
+{
+    int i;
+
+    CHECK_RENDERER_MAGIC(renderer, false);
+
+    CHECK_PARAM(!texts) {
+        return SDL_InvalidParamError("texts");
+    }
+    CHECK_PARAM(count < 0) {
+        return SDL_InvalidParamError("count");
+    }
+    for (i = 0; i < count; ++i) {
+        if (!texts[i].text) {
+            return SDL_InvalidParamError("texts[i].text");
+        }
+    }
+
+    if (count == 0) {
+        return true;
+    }
+    return RenderDebugTexts(renderer, texts, count);
 }
 
 bool SDL_RenderDebugTextFormat(SDL_Renderer *renderer, float x, float y, SDL_PRINTF_FORMAT_STRING const char *fmt, ...)
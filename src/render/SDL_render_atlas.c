@@ -0,0 +1,278 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#include "SDL_render_atlas_c.h"
+#include "../video/SDL_pixels_c.h"
+
+/* Textures are packed into pages on shelves: rows as tall as the first texture placed in them,
+   filled left to right. Space is only given back when every texture on a page is destroyed,
+   which suits icons and sprites that are loaded up front and live as long as the renderer.
+ */
+
+#define ATLAS_PAGE_SIZE         1024
+#define ATLAS_MAX_TEXTURE_SIZE  128
+
+// The edge pixels of each texture are repeated around it, so linear filtering doesn't pick up its neighbors
+#define ATLAS_PADDING           1
+
+static int GetAtlasPageSize(SDL_Renderer *renderer)
+{
+    const int max_texture_size = (int)SDL_GetNumberProperty(SDL_GetRendererProperties(renderer), SDL_PROP_RENDERER_MAX_TEXTURE_SIZE_NUMBER, 0);
+
+    if (max_texture_size > 0 && max_texture_size < ATLAS_PAGE_SIZE) {
+        return max_texture_size;
+    }
+    return ATLAS_PAGE_SIZE;
+}
+
+bool SDL_CanAddTextureToAtlas(SDL_Renderer *renderer, SDL_PixelFormat format, SDL_Colorspace colorspace, int w, int h)
+{
+    const int max_size = SDL_min(ATLAS_MAX_TEXTURE_SIZE, GetAtlasPageSize(renderer) / 4);
+
+    if (!renderer->texture_atlas) {
+        return false;
+    }
+    if (w > max_size || h > max_size) {
+        return false;
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format)) {
+        return false;
+    }
+    // Pages are plain SDR textures
+    if (colorspace != SDL_COLORSPACE_SRGB || SDL_GetDefaultColorspaceForFormat(format) != SDL_COLORSPACE_SRGB) {
+        return false;
+    }
+    return true;
+}
+
+static bool AllocateAtlasRect(SDL_TextureAtlasPage *page, int w, int h, SDL_Rect *rect)
+{
+    SDL_TextureAtlasShelf *shelf = NULL;
+    int i;
+
+    // Use the shortest shelf the texture fits on
+    for (i = 0; i < page->num_shelves; ++i) {
+        SDL_TextureAtlasShelf *candidate = &page->shelves[i];
+        if (candidate->h >= h && candidate->x + w <= page->size) {
+            if (!shelf || candidate->h < shelf->h) {
+                shelf = candidate;
+            }
+        }
+    }
+
+    // Start a new shelf rather than waste more than half of one
+    if ((!shelf || shelf->h > h * 2) && page->next_y + h <= page->size) {
+        if (page->num_shelves == page->max_shelves) {
+            const int max_shelves = page->max_shelves ? page->max_shelves * 2 : 16;
+            SDL_TextureAtlasShelf *shelves = (SDL_TextureAtlasShelf *)SDL_realloc(page->shelves, max_shelves * sizeof(*shelves));
+            if (!shelves) {
+                return false;
+            }
+            page->shelves = shelves;
+            page->max_shelves = max_shelves;
+        }
+        shelf = &page->shelves[page->num_shelves++];
+        shelf->x = 0;
+        shelf->y = page->next_y;
+        shelf->h = h;
+        page->next_y += h;
+    }
+
+    if (!shelf) {
+        return false;
+    }
+
+    rect->x = shelf->x;
+    rect->y = shelf->y;
+    rect->w = w;
+    rect->h = h;
+    shelf->x += w;
+    return true;
+}
+
+static SDL_TextureAtlasPage *CreateAtlasPage(SDL_Renderer *renderer, SDL_PixelFormat format)
+{
+    SDL_TextureAtlasPage *page;
+    SDL_PropertiesID props;
+    SDL_Texture *texture;
+
+    page = (SDL_TextureAtlasPage *)SDL_calloc(1, sizeof(*page));
+    if (!page) {
+        return NULL;
+    }
+    page->size = GetAtlasPageSize(renderer);
+
+    props = SDL_CreateProperties();
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_FORMAT_NUMBER, format);
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_ACCESS_NUMBER, SDL_TEXTUREACCESS_STATIC);
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_WIDTH_NUMBER, page->size);
+    SDL_SetNumberProperty(props, SDL_PROP_TEXTURE_CREATE_HEIGHT_NUMBER, page->size);
+    texture = SDL_CreateTextureWithProperties(renderer, props);
+    SDL_DestroyProperties(props);
+    if (!texture) {
+        SDL_free(page);
+        return NULL;
+    }
+    page->texture = texture;
+
+    // Move the page to the end of the texture list, so it's destroyed after the textures in it
+    SDL_assert(renderer->textures == texture);
+    if (texture->next) {
+        SDL_Texture *tail = texture->next;
+        while (tail->next) {
+            tail = tail->next;
+        }
+        renderer->textures = texture->next;
+        renderer->textures->prev = NULL;
+        tail->next = texture;
+        texture->prev = tail;
+        texture->next = NULL;
+    }
+
+    page->next = renderer->atlas_pages;
+    renderer->atlas_pages = page;
+    return page;
+}
+
+bool SDL_AddTextureToAtlas(SDL_Renderer *renderer, SDL_Texture *texture)
+{
+    const int w = texture->w + ATLAS_PADDING * 2;
+    const int h = texture->h + ATLAS_PADDING * 2;
+    SDL_TextureAtlasPage *page;
+    SDL_Rect rect;
+
+    for (page = renderer->atlas_pages; page; page = page->next) {
+        if (page->texture->format == texture->format && AllocateAtlasRect(page, w, h, &rect)) {
+            break;
+        }
+    }
+    if (!page) {
+        page = CreateAtlasPage(renderer, texture->format);
+        if (!page) {
+            return false;
+        }
+        if (!AllocateAtlasRect(page, w, h, &rect)) {
+            // We're out of memory
+            renderer->atlas_pages = page->next;
+            SDL_DestroyTexture(page->texture);
+            SDL_free(page);
+            return false;
+        }
+    }
+
+    texture->atlas_page = page;
+    texture->atlas_rect.x = rect.x + ATLAS_PADDING;
+    texture->atlas_rect.y = rect.y + ATLAS_PADDING;
+    texture->atlas_rect.w = texture->w;
+    texture->atlas_rect.h = texture->h;
+    ++page->num_textures;
+    page->used_pixels += (Sint64)texture->w * texture->h;
+    return true;
+}
+
+SDL_Texture *SDL_RemoveTextureFromAtlas(SDL_Texture *texture)
+{
+    SDL_TextureAtlasPage *page = texture->atlas_page;
+    SDL_Renderer *renderer = texture->renderer;
+    SDL_TextureAtlasPage **prev;
+    SDL_Texture *result;
+
+    texture->atlas_page = NULL;
+    --page->num_textures;
+    page->used_pixels -= (Sint64)texture->w * texture->h;
+    if (page->num_textures > 0) {
+        return NULL;
+    }
+
+    // The page is empty, hand its texture back to be destroyed
+    for (prev = &renderer->atlas_pages; *prev != page; prev = &(*prev)->next) {
+    }
+    *prev = page->next;
+
+    result = page->texture;
+    SDL_free(page->shelves);
+    SDL_free(page);
+    return result;
+}
+
+bool SDL_UpdateAtlasTexture(SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch)
+{
+    const int bpp = SDL_BYTESPERPIXEL(texture->format);
+    const int left = (rect->x == 0) ? ATLAS_PADDING : 0;
+    const int right = (rect->x + rect->w == texture->w) ? ATLAS_PADDING : 0;
+    const int top = (rect->y == 0) ? ATLAS_PADDING : 0;
+    const int bottom = (rect->y + rect->h == texture->h) ? ATLAS_PADDING : 0;
+    SDL_Rect dstrect;
+    int dstpitch;
+    Uint8 *buffer;
+    int x, y;
+    bool result;
+
+    dstrect.x = texture->atlas_rect.x + rect->x - left;
+    dstrect.y = texture->atlas_rect.y + rect->y - top;
+    dstrect.w = rect->w + left + right;
+    dstrect.h = rect->h + top + bottom;
+    dstpitch = dstrect.w * bpp;
+
+    buffer = (Uint8 *)SDL_malloc((size_t)dstpitch * dstrect.h);
+    if (!buffer) {
+        return false;
+    }
+
+    // Repeat the pixels along any edge of the texture into the padding around it
+    for (y = 0; y < dstrect.h; ++y) {
+        const Uint8 *src = (const Uint8 *)pixels + SDL_clamp(y - top, 0, rect->h - 1) * pitch;
+        Uint8 *dst = buffer + y * dstpitch;
+
+        for (x = 0; x < left; ++x) {
+            SDL_memcpy(dst, src, bpp);
+            dst += bpp;
+        }
+        SDL_memcpy(dst, src, (size_t)rect->w * bpp);
+        dst += rect->w * bpp;
+        for (x = 0; x < right; ++x) {
+            SDL_memcpy(dst, src + (rect->w - 1) * bpp, bpp);
+            dst += bpp;
+        }
+    }
+
+    result = SDL_UpdateTexture(texture->atlas_page->texture, &dstrect, buffer, dstpitch);
+    SDL_free(buffer);
+    return result;
+}
+
+void SDL_GetTextureAtlasStats(SDL_Renderer *renderer, int *num_pages, int *num_textures, float *occupancy)
+{
+    SDL_TextureAtlasPage *page;
+    Sint64 used_pixels = 0;
+    Sint64 total_pixels = 0;
+
+    *num_pages = 0;
+    *num_textures = 0;
+    for (page = renderer->atlas_pages; page; page = page->next) {
+        ++*num_pages;
+        *num_textures += page->num_textures;
+        used_pixels += page->used_pixels;
+        total_pixels += (Sint64)page->size * page->size;
+    }
+    *occupancy = total_pixels ? (float)((double)used_pixels / total_pixels) : 0.0f;
+}
@@ -0,0 +1,57 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#ifndef SDL_render_atlas_c_h_
+#define SDL_render_atlas_c_h_
+
+#include "SDL_internal.h"
+
+#include "SDL_sysrender.h"
+
+// Small static textures can share atlas pages, so draws of different textures can be batched together
+
+typedef struct SDL_TextureAtlasShelf
+{
+    int x;
+    int y;
+    int h;
+} SDL_TextureAtlasShelf;
+
+struct SDL_TextureAtlasPage
+{
+    SDL_Texture *texture;
+    int size;
+    int num_textures;
+    Sint64 used_pixels;
+    SDL_TextureAtlasShelf *shelves;
+    int num_shelves;
+    int max_shelves;
+    int next_y;
+    SDL_TextureAtlasPage *next;
+};
+
+extern bool SDL_CanAddTextureToAtlas(SDL_Renderer *renderer, SDL_PixelFormat format, SDL_Colorspace colorspace, int w, int h);
+extern bool SDL_AddTextureToAtlas(SDL_Renderer *renderer, SDL_Texture *texture);
+extern SDL_Texture *SDL_RemoveTextureFromAtlas(SDL_Texture *texture);
+extern bool SDL_UpdateAtlasTexture(SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch);
+extern void SDL_GetTextureAtlasStats(SDL_Renderer *renderer, int *num_pages, int *num_textures, float *occupancy);
+
+#endif // SDL_render_atlas_c_h_
@@ -46,6 +46,7 @@ typedef struct SDL_DRect
 // The SDL 2D rendering system
 
 typedef struct SDL_RenderDriver SDL_RenderDriver;
+typedef struct SDL_TextureAtlasPage SDL_TextureAtlasPage;
 
 // Rendering view state
 typedef struct SDL_RenderViewState
@@ -112,6 +113,10 @@ struct SDL_Texture
     SDL_Rect locked_rect;
     SDL_Surface *locked_surface; // Locked region exposed as a SDL surface
 
+    // Small static textures may live in a shared atlas page instead
+    SDL_TextureAtlasPage *atlas_page;
+    SDL_Rect atlas_rect;
+
     Uint32 last_command_generation; // last command queue generation this texture was in.
 
     SDL_PropertiesID props;
@@ -186,6 +191,7 @@ typedef struct SDL_RenderCommand
         {
             size_t first;
             size_t count;
+            size_t vertex_size; // bytes of vertex data at first, filled in by SDL_render.c
             float color_scale;
             SDL_FColor color;
             SDL_BlendMode blend;
@@ -245,6 +251,10 @@ struct SDL_Renderer
 
     void (*InvalidateCachedState)(SDL_Renderer *renderer);
     bool (*RunCommandQueue)(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize);
+    // Optional: returns upload memory of at least *size bytes that vertices are written into directly, keeping
+    //  the first used bytes written since the last flush, and sets *size to how big it really is.
+    //  RunCommandQueue is then handed this memory, so it doesn't need to copy the vertices again.
+    void *(*GetVertexMemory)(SDL_Renderer *renderer, size_t used, size_t *size);
     bool (*CreatePalette)(SDL_Renderer *renderer, SDL_TexturePalette *palette);
     bool (*UpdatePalette)(SDL_Renderer *renderer, SDL_TexturePalette *palette, int ncolors, SDL_Color *colors);
     void (*DestroyPalette)(SDL_Renderer *renderer, SDL_TexturePalette *palette);
@@ -266,9 +276,17 @@ struct SDL_Renderer
     bool (*LockTexture)(SDL_Renderer *renderer, SDL_Texture *texture,
                        const SDL_Rect *rect, void **pixels, int *pitch);
     void (*UnlockTexture)(SDL_Renderer *renderer, SDL_Texture *texture);
+    // Optional: starts uploading to the texture without waiting for the frame to be drawn, the upload
+    //  is finished when IsTextureUploadComplete is called with it or any later upload
+    bool (*UpdateTextureAsync)(SDL_Renderer *renderer, SDL_Texture *texture,
+                               const SDL_Rect *rect, const void *pixels, int pitch, Uint64 upload);
+    bool (*IsTextureUploadComplete)(SDL_Renderer *renderer, Uint64 upload, bool wait);
     bool (*SetRenderTarget)(SDL_Renderer *renderer, SDL_Texture *texture);
     SDL_Surface *(*RenderReadPixels)(SDL_Renderer *renderer, const SDL_Rect *rect);
     bool (*RenderPresent)(SDL_Renderer *renderer);
+    // Optional: gets the GPU time of the most recent frame whose timing is known, where frame is the
+    //  frame_stats.frame that was being drawn when RenderPresent was called for it
+    bool (*GetGPUFrameTime)(SDL_Renderer *renderer, Uint64 *frame, Uint64 *ns);
     void (*DestroyTexture)(SDL_Renderer *renderer, SDL_Texture *texture);
 
     void (*DestroyRenderer)(SDL_Renderer *renderer);
@@ -306,6 +324,9 @@ struct SDL_Renderer
     // The method of drawing lines
     SDL_RenderLineMethod line_method;
 
+    // Whether sprites are drawn as geometry even if the backend can copy
+    bool sprites_geometry;
+
     // Default scale mode for textures created with this renderer
     SDL_ScaleMode scale_mode;
 
@@ -329,6 +350,11 @@ struct SDL_Renderer
     SDL_TextureAddressMode texture_address_mode_v;
     SDL_GPURenderState *gpu_render_state;
 
+    // The modulation and modes of the texture being drawn, taken from it so draws never change a shared texture
+    SDL_FColor texture_color;
+    SDL_BlendMode texture_blend_mode;
+    SDL_ScaleMode texture_scale_mode;
+
     SDL_RenderCommand *render_commands;
     SDL_RenderCommand *render_commands_tail;
     SDL_RenderCommand *render_commands_pool;
@@ -342,10 +368,34 @@ struct SDL_Renderer
     bool viewport_queued;
     bool cliprect_queued;
 
+    // Whether COPY commands hold count copies, so adjacent ones can be merged
+    bool merge_copy_commands;
+    Uint64 num_commands_queued;
+    Uint64 num_commands_submitted;
+
+    // Statistics for the frame being drawn and the last one presented
+    SDL_RenderStats frame_stats;
+    SDL_RenderStats last_frame_stats;
+
+    // The handle of the last asynchronous texture upload
+    Uint64 last_texture_upload;
+
     void *vertex_data;
     size_t vertex_data_used;
     size_t vertex_data_allocation;
 
+    // Whether small textures from SDL_CreateTextureFromSurface() are packed into shared atlas pages
+    bool texture_atlas;
+    SDL_TextureAtlasPage *atlas_pages;
+
+    // Deferred renderers record commands on other threads for the renderer they were created for,
+    //  which keeps them in a list linked through next
+    SDL_Renderer *parent;
+    SDL_Renderer *deferred_renderers;
+
+    // Set by backends whose Queue* functions use their own memory or state instead of the vertex data
+    bool deferred_unsupported;
+
     // Shaped window support
     bool transparent_window;
     SDL_Surface *shape_surface;
@@ -355,6 +405,10 @@ struct SDL_Renderer
 
     SDL_Texture *debug_char_texture_atlas;
 
+    // Scratch space the vertices of debug text are built in, with room for debug_text_max_glyphs glyphs
+    void *debug_text_vertices;
+    int debug_text_max_glyphs;
+
     bool destroyed;   // already destroyed by SDL_DestroyWindow; just free this struct in SDL_DestroyRenderer.
 
     void *internal;
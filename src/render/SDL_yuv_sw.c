@@ -337,65 +337,46 @@ void SDL_SW_UnlockYUVTexture(SDL_SW_YUVTexture *swdata)
 {
 }
 
-bool SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture *swdata, const SDL_Rect *srcrect, SDL_PixelFormat target_format, int w, int h, void *pixels, int pitch)
+bool SDL_SW_BlitYUVToRGB(SDL_SW_YUVTexture *swdata, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode)
 {
-    int stretch;
+    return SDL_ConvertPixels_YUV_to_RGB_Scaled(swdata->w, swdata->h, swdata->format, swdata->colorspace, swdata->planes[0], swdata->pitches[0], srcrect,
+                                               dst, dstrect, scaleMode);
+}
 
+bool SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture *swdata, const SDL_Rect *srcrect, SDL_PixelFormat target_format, int w, int h, void *pixels, int pitch)
+{
     // Make sure we're set up to display in the desired format
     if (target_format != swdata->target_format && swdata->display) {
         SDL_DestroySurface(swdata->display);
         swdata->display = NULL;
     }
 
-    stretch = 0;
-    if (srcrect->x || srcrect->y || srcrect->w < swdata->w || srcrect->h < swdata->h) {
-        /* The source rectangle has been clipped.
-           Using a scratch surface is easier than adding clipped
-           source support to all the blitters, plus that would
-           slow them down in the general unclipped case.
-         */
-        stretch = 1;
-    } else if ((srcrect->w != w) || (srcrect->h != h)) {
-        stretch = 1;
+    if (!srcrect->x && !srcrect->y && srcrect->w == swdata->w && srcrect->h == swdata->h &&
+        srcrect->w == w && srcrect->h == h) {
+        return SDL_ConvertPixelsAndColorspace(swdata->w, swdata->h, swdata->format, swdata->colorspace, 0, swdata->planes[0], swdata->pitches[0], target_format, SDL_COLORSPACE_SRGB, 0, pixels, pitch);
     }
-    if (stretch) {
-        if (swdata->display) {
-            swdata->display->w = w;
-            swdata->display->h = h;
-            swdata->display->pixels = pixels;
-            swdata->display->pitch = pitch;
-        } else {
-            swdata->display = SDL_CreateSurfaceFrom(w, h, target_format, pixels, pitch);
-            if (!swdata->display) {
-                return false;
-            }
-            swdata->target_format = target_format;
-        }
-        if (!swdata->stretch) {
-            swdata->stretch = SDL_CreateSurface(swdata->w, swdata->h, target_format);
-            if (!swdata->stretch) {
-                return false;
-            }
-        }
-        pixels = swdata->stretch->pixels;
-        pitch = swdata->stretch->pitch;
-    }
-    if (!SDL_ConvertPixelsAndColorspace(swdata->w, swdata->h, swdata->format, swdata->colorspace, 0, swdata->planes[0], swdata->pitches[0], target_format, SDL_COLORSPACE_SRGB, 0, pixels, pitch)) {
-        return false;
-    }
-    if (stretch) {
-        SDL_Rect rect = *srcrect;
-        return SDL_StretchSurface(swdata->stretch, &rect, swdata->display, NULL, SDL_SCALEMODE_NEAREST);
+
+    // Only the part of the texture in the source rectangle is converted, scaling as we go
+    if (swdata->display) {
+        swdata->display->w = w;
+        swdata->display->h = h;
+        swdata->display->pixels = pixels;
+        swdata->display->pitch = pitch;
+        SDL_SetSurfaceClipRect(swdata->display, NULL);
     } else {
-        return true;
+        swdata->display = SDL_CreateSurfaceFrom(w, h, target_format, pixels, pitch);
+        if (!swdata->display) {
+            return false;
+        }
+        swdata->target_format = target_format;
     }
+    return SDL_SW_BlitYUVToRGB(swdata, srcrect, swdata->display, NULL, SDL_SCALEMODE_NEAREST);
 }
 
 void SDL_SW_DestroyYUVTexture(SDL_SW_YUVTexture *swdata)
 {
     if (swdata) {
         SDL_aligned_free(swdata->pixels);
-        SDL_DestroySurface(swdata->stretch);
         SDL_DestroySurface(swdata->display);
         SDL_free(swdata);
     }
@@ -38,8 +38,7 @@ struct SDL_SW_YUVTexture
     int pitches[3];
     Uint8 *planes[3];
 
-    // This is a temporary surface in case we have to stretch copy
-    SDL_Surface *stretch;
+    // This wraps the pixels passed to SDL_SW_CopyYUVToRGB() for scaled copies
     SDL_Surface *display;
 };
 
@@ -57,6 +56,7 @@ extern bool SDL_SW_UpdateNVTexturePlanar(SDL_SW_YUVTexture *swdata, const SDL_Re
                                          const Uint8 *UVplane, int UVpitch);
 extern bool SDL_SW_LockYUVTexture(SDL_SW_YUVTexture *swdata, const SDL_Rect *rect, void **pixels, int *pitch);
 extern void SDL_SW_UnlockYUVTexture(SDL_SW_YUVTexture *swdata);
+extern bool SDL_SW_BlitYUVToRGB(SDL_SW_YUVTexture *swdata, const SDL_Rect *srcrect, SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode);
 extern bool SDL_SW_CopyYUVToRGB(SDL_SW_YUVTexture *swdata, const SDL_Rect *srcrect, SDL_PixelFormat target_format, int w, int h, void *pixels, int pitch);
 extern void SDL_SW_DestroyYUVTexture(SDL_SW_YUVTexture *swdata);
 
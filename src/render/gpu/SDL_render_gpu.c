@@ -81,6 +81,23 @@ static const float INPUTTYPE_SRGB = 1;
 static const float INPUTTYPE_SCRGB = 2;
 static const float INPUTTYPE_HDR10 = 3;
 
+// Texture updates are staged in a ring of upload memory and copied to their textures together
+#define GPU_STAGING_SIZE      (4 * 1024 * 1024)
+#define GPU_STAGING_ALIGNMENT 512
+
+typedef struct GPU_PendingUpload
+{
+    SDL_GPUTexture *texture;
+    Uint32 offset;
+    int x, y, w, h;
+} GPU_PendingUpload;
+
+typedef struct GPU_AsyncUpload
+{
+    Uint64 upload;
+    SDL_GPUFence *fence;
+} GPU_AsyncUpload;
+
 typedef struct GPU_RenderData
 {
     bool external_device;
@@ -107,8 +124,28 @@ typedef struct GPU_RenderData
         SDL_GPUTransferBuffer *transfer_buf;
         SDL_GPUBuffer *buffer;
         Uint32 buffer_size;
+        Uint32 transfer_size;
+        void *mapped; // the transfer buffer, while vertices are being queued into it
     } vertices;
 
+    struct
+    {
+        SDL_GPUTransferBuffer *transfer_buf;
+        Uint32 size;
+        Uint32 used;  // reset when the uploads are submitted, so the next ones cycle to fresh memory
+        Uint8 *mapped;
+        GPU_PendingUpload *pending;
+        int num_pending;
+        int max_pending;
+    } staging;
+
+    struct
+    {
+        GPU_AsyncUpload *uploads;  // in the order they were submitted
+        int count;
+        int max;
+    } async;
+
     struct
     {
         SDL_GPURenderPass *render_pass;
@@ -119,6 +156,7 @@ typedef struct GPU_RenderData
         SDL_Rect scissor;
         bool scissor_enabled;
         bool scissor_was_enabled;
+        bool command_buffer_used;  // whether anything has been recorded in command_buffer yet
     } state;
 
     SDL_GPUSampler *samplers[RENDER_SAMPLER_COUNT];
@@ -174,6 +212,191 @@ static bool GPU_SupportsBlendMode(SDL_Renderer *renderer, SDL_BlendMode blendMod
     return true;
 }
 
+static void UnmapStaging(GPU_RenderData *data)
+{
+    if (data->staging.mapped) {
+        SDL_UnmapGPUTransferBuffer(data->device, data->staging.transfer_buf);
+        data->staging.mapped = NULL;
+    }
+}
+
+static void RecordPendingUploads(GPU_RenderData *data, SDL_GPUCopyPass *pass)
+{
+    for (int i = 0; i < data->staging.num_pending; ++i) {
+        const GPU_PendingUpload *upload = &data->staging.pending[i];
+
+        SDL_GPUTextureTransferInfo tex_src;
+        SDL_zero(tex_src);
+        tex_src.transfer_buffer = data->staging.transfer_buf;
+        tex_src.offset = upload->offset;
+        tex_src.rows_per_layer = upload->h;
+        tex_src.pixels_per_row = upload->w;
+
+        SDL_GPUTextureRegion tex_dst;
+        SDL_zero(tex_dst);
+        tex_dst.texture = upload->texture;
+        tex_dst.x = upload->x;
+        tex_dst.y = upload->y;
+        tex_dst.w = upload->w;
+        tex_dst.h = upload->h;
+        tex_dst.d = 1;
+
+        SDL_UploadToGPUTexture(pass, &tex_src, &tex_dst, false);
+    }
+    data->staging.num_pending = 0;
+}
+
+// Records the staged texture updates into cbuf, in one copy pass
+static bool FlushUploads(GPU_RenderData *data, SDL_GPUCommandBuffer *cbuf)
+{
+    UnmapStaging(data);
+
+    if (data->staging.num_pending == 0) {
+        return true;
+    }
+
+    SDL_GPUCopyPass *pass = SDL_BeginGPUCopyPass(cbuf);
+    if (!pass) {
+        return false;
+    }
+    RecordPendingUploads(data, pass);
+    SDL_EndGPUCopyPass(pass);
+
+    if (cbuf == data->state.command_buffer) {
+        data->state.command_buffer_used = true;
+    }
+    return true;
+}
+
+static void DiscardPendingUploads(GPU_RenderData *data, SDL_GPUTexture *texture)
+{
+    int i = 0;
+
+    while (i < data->staging.num_pending) {
+        if (data->staging.pending[i].texture == texture) {
+            --data->staging.num_pending;
+            SDL_memmove(&data->staging.pending[i], &data->staging.pending[i + 1], (data->staging.num_pending - i) * sizeof(*data->staging.pending));
+        } else {
+            ++i;
+        }
+    }
+}
+
+// Returns upload memory for size bytes, which is copied to the texture when the uploads are flushed
+static Uint8 *AllocateStaging(GPU_RenderData *data, size_t size, Uint32 *offset)
+{
+    size_t start = (data->staging.used + (GPU_STAGING_ALIGNMENT - 1)) & ~(size_t)(GPU_STAGING_ALIGNMENT - 1);
+
+    if (!data->staging.transfer_buf || start + size > data->staging.size) {
+        // What's staged so far is recorded first, so the memory can be cycled
+        if (!FlushUploads(data, data->state.command_buffer)) {
+            return NULL;
+        }
+        start = 0;
+        data->staging.used = 0;
+
+        if (size > data->staging.size) {
+            Uint32 staging_size = SDL_max(data->staging.size, GPU_STAGING_SIZE);
+
+            while (staging_size < size) {
+                if (staging_size > SDL_MAX_UINT32 / 2) {
+                    SDL_SetError("update size overflow");
+                    return NULL;
+                }
+                staging_size *= 2;
+            }
+
+            SDL_GPUTransferBufferCreateInfo tbci;
+            SDL_zero(tbci);
+            tbci.size = staging_size;
+            tbci.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+
+            SDL_GPUTransferBuffer *transfer_buf = SDL_CreateGPUTransferBuffer(data->device, &tbci);
+            if (!transfer_buf) {
+                return NULL;
+            }
+            if (data->staging.transfer_buf) {
+                SDL_ReleaseGPUTransferBuffer(data->device, data->staging.transfer_buf);
+            }
+            data->staging.transfer_buf = transfer_buf;
+            data->staging.size = staging_size;
+        }
+    }
+
+    if (data->staging.num_pending == data->staging.max_pending) {
+        const int max_pending = data->staging.max_pending ? data->staging.max_pending * 2 : 16;
+        GPU_PendingUpload *pending = (GPU_PendingUpload *)SDL_realloc(data->staging.pending, max_pending * sizeof(*pending));
+        if (!pending) {
+            return NULL;
+        }
+        data->staging.pending = pending;
+        data->staging.max_pending = max_pending;
+    }
+
+    if (!data->staging.mapped) {
+        // Starting over cycles to memory the GPU isn't still uploading from
+        data->staging.mapped = (Uint8 *)SDL_MapGPUTransferBuffer(data->device, data->staging.transfer_buf, (start == 0));
+        if (!data->staging.mapped) {
+            return NULL;
+        }
+    }
+
+    *offset = (Uint32)start;
+    data->staging.used = (Uint32)(start + size);
+    return data->staging.mapped + start;
+}
+
+static bool StageUpload(GPU_RenderData *data, SDL_GPUTexture *texture, int bpp, int x, int y, int w, int h, const void *pixels, int pitch)
+{
+    size_t row_size, data_size;
+    if (!SDL_size_mul_check_overflow(w, bpp, &row_size) ||
+        !SDL_size_mul_check_overflow(h, row_size, &data_size)) {
+        return SDL_SetError("update size overflow");
+    }
+
+    Uint32 offset = 0;
+    Uint8 *output = AllocateStaging(data, data_size, &offset);
+    if (!output) {
+        return false;
+    }
+    if ((size_t)pitch == row_size) {
+        SDL_memcpy(output, pixels, data_size);
+    } else {
+        const Uint8 *input = pixels;
+        for (int i = 0; i < h; ++i) {
+            SDL_memcpy(output, input, row_size);
+            output += row_size;
+            input += pitch;
+        }
+    }
+
+    GPU_PendingUpload *upload = &data->staging.pending[data->staging.num_pending++];
+    upload->texture = texture;
+    upload->offset = offset;
+    upload->x = x;
+    upload->y = y;
+    upload->w = w;
+    upload->h = h;
+    return true;
+}
+
+// Submits the command buffer, with everything staged for it, and starts a new one
+static SDL_GPUFence *SubmitCommandBuffer(GPU_RenderData *data, bool acquire_fence)
+{
+    SDL_GPUFence *fence = NULL;
+
+    FlushUploads(data, data->state.command_buffer);
+    if (acquire_fence) {
+        fence = SDL_SubmitGPUCommandBufferAndAcquireFence(data->state.command_buffer);
+    } else {
+        SDL_SubmitGPUCommandBuffer(data->state.command_buffer);
+    }
+    data->state.command_buffer = SDL_AcquireGPUCommandBuffer(data->device);
+    data->state.command_buffer_used = false;
+    data->staging.used = 0;
+    return fence;
+}
+
 static bool GPU_CreatePalette(SDL_Renderer *renderer, SDL_TexturePalette *palette)
 {
     GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
@@ -204,45 +427,8 @@ static bool GPU_UpdatePalette(SDL_Renderer *renderer, SDL_TexturePalette *palett
 {
     GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
     GPU_PaletteData *palettedata = (GPU_PaletteData *)palette->internal;
-    const Uint32 data_size = ncolors * sizeof(*colors);
-
-    SDL_GPUTransferBufferCreateInfo tbci;
-    SDL_zero(tbci);
-    tbci.size = data_size;
-    tbci.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-
-    SDL_GPUTransferBuffer *tbuf = SDL_CreateGPUTransferBuffer(data->device, &tbci);
-    if (tbuf == NULL) {
-        return false;
-    }
-
-    Uint8 *output = SDL_MapGPUTransferBuffer(data->device, tbuf, false);
-    SDL_memcpy(output, colors, data_size);
-    SDL_UnmapGPUTransferBuffer(data->device, tbuf);
 
-    SDL_GPUCommandBuffer *cbuf = data->state.command_buffer;
-    SDL_GPUCopyPass *cpass = SDL_BeginGPUCopyPass(cbuf);
-
-    SDL_GPUTextureTransferInfo tex_src;
-    SDL_zero(tex_src);
-    tex_src.transfer_buffer = tbuf;
-    tex_src.rows_per_layer = 1;
-    tex_src.pixels_per_row = ncolors;
-
-    SDL_GPUTextureRegion tex_dst;
-    SDL_zero(tex_dst);
-    tex_dst.texture = palettedata->texture;
-    tex_dst.x = 0;
-    tex_dst.y = 0;
-    tex_dst.w = ncolors;
-    tex_dst.h = 1;
-    tex_dst.d = 1;
-
-    SDL_UploadToGPUTexture(cpass, &tex_src, &tex_dst, false);
-    SDL_EndGPUCopyPass(cpass);
-    SDL_ReleaseGPUTransferBuffer(data->device, tbuf);
-
-    return true;
+    return StageUpload(data, palettedata->texture, sizeof(*colors), 0, 0, ncolors, 1, colors, ncolors * sizeof(*colors));
 }
 
 static void GPU_DestroyPalette(SDL_Renderer *renderer, SDL_TexturePalette *palette)
@@ -251,6 +437,7 @@ static void GPU_DestroyPalette(SDL_Renderer *renderer, SDL_TexturePalette *palet
     GPU_PaletteData *palettedata = (GPU_PaletteData *)palette->internal;
 
     if (palettedata) {
+        DiscardPendingUploads(data, palettedata->texture);
         SDL_ReleaseGPUTexture(data->device, palettedata->texture);
         SDL_free(palettedata);
     }
@@ -432,61 +619,6 @@ static bool GPU_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture, SDL_
     return true;
 }
 
-static bool GPU_UpdateTextureInternal(GPU_RenderData *renderdata, SDL_GPUCopyPass *cpass, SDL_GPUTexture *texture, int bpp, int x, int y, int w, int h, const void *pixels, int pitch)
-{
-    size_t row_size, data_size;
-    if (!SDL_size_mul_check_overflow(w, bpp, &row_size) ||
-        !SDL_size_mul_check_overflow(h, row_size, &data_size)) {
-        return SDL_SetError("update size overflow");
-    }
-
-    SDL_GPUTransferBufferCreateInfo tbci;
-    SDL_zero(tbci);
-    tbci.size = (Uint32)data_size;
-    tbci.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
-
-    SDL_GPUTransferBuffer *tbuf = SDL_CreateGPUTransferBuffer(renderdata->device, &tbci);
-    if (tbuf == NULL) {
-        return false;
-    }
-
-    Uint8 *output = SDL_MapGPUTransferBuffer(renderdata->device, tbuf, false);
-    if (!output) {
-        return false;
-    }
-    if ((size_t)pitch == row_size) {
-        SDL_memcpy(output, pixels, data_size);
-    } else {
-        const Uint8 *input = pixels;
-        for (int i = 0; i < h; ++i) {
-            SDL_memcpy(output, input, row_size);
-            output += row_size;
-            input += pitch;
-        }
-    }
-    SDL_UnmapGPUTransferBuffer(renderdata->device, tbuf);
-
-    SDL_GPUTextureTransferInfo tex_src;
-    SDL_zero(tex_src);
-    tex_src.transfer_buffer = tbuf;
-    tex_src.rows_per_layer = h;
-    tex_src.pixels_per_row = w;
-
-    SDL_GPUTextureRegion tex_dst;
-    SDL_zero(tex_dst);
-    tex_dst.texture = texture;
-    tex_dst.x = x;
-    tex_dst.y = y;
-    tex_dst.w = w;
-    tex_dst.h = h;
-    tex_dst.d = 1;
-
-    SDL_UploadToGPUTexture(cpass, &tex_src, &tex_dst, false);
-    SDL_ReleaseGPUTransferBuffer(renderdata->device, tbuf);
-
-    return true;
-}
-
 #ifdef SDL_HAVE_YUV
 static bool GPU_UpdateTextureNV(SDL_Renderer *renderer, SDL_Texture *texture,
                                 const SDL_Rect *rect,
@@ -506,11 +638,9 @@ static bool GPU_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, cons
     GPU_TextureData *data = (GPU_TextureData *)texture->internal;
 
     bool retval = true;
-    SDL_GPUCommandBuffer *cbuf = renderdata->state.command_buffer;
-    SDL_GPUCopyPass *cpass = SDL_BeginGPUCopyPass(cbuf);
     int bpp = SDL_BYTESPERPIXEL(texture->format);
 
-    retval = GPU_UpdateTextureInternal(renderdata, cpass, data->texture, bpp, rect->x, rect->y, rect->w, rect->h, pixels, pitch);
+    retval = StageUpload(renderdata, data->texture, bpp, rect->x, rect->y, rect->w, rect->h, pixels, pitch);
 
 #ifdef SDL_HAVE_YUV
     if (data->nv12) {
@@ -525,7 +655,7 @@ static bool GPU_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, cons
             bpp = 1;
             UVpitch = (pitch + 1) & ~1;
         }
-        retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->textureNV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, UVplane, UVpitch);
+        retval &= StageUpload(renderdata, data->textureNV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, UVplane, UVpitch);
 
     } else if (data->yuv) {
         int Ypitch = pitch;
@@ -534,12 +664,11 @@ static bool GPU_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture, cons
         const Uint8 *Uplane = Yplane + rect->h * Ypitch;
         const Uint8 *Vplane = Uplane + ((rect->h + 1) / 2) * UVpitch;
 
-        retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->textureU, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Uplane, UVpitch);
-        retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->textureV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Vplane, UVpitch);
+        retval &= StageUpload(renderdata, data->textureU, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Uplane, UVpitch);
+        retval &= StageUpload(renderdata, data->textureV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Vplane, UVpitch);
     }
 #endif
 
-    SDL_EndGPUCopyPass(cpass);
     return retval;
 }
 
@@ -555,12 +684,9 @@ static bool GPU_UpdateTextureYUV(SDL_Renderer *renderer, SDL_Texture *texture,
     int bpp = SDL_BYTESPERPIXEL(texture->format);
 
     bool retval = true;
-    SDL_GPUCommandBuffer *cbuf = renderdata->state.command_buffer;
-    SDL_GPUCopyPass *cpass = SDL_BeginGPUCopyPass(cbuf);
-    retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->texture, bpp, rect->x, rect->y, rect->w, rect->h, Yplane, Ypitch);
-    retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->textureU, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Uplane, Upitch);
-    retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->textureV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Vplane, Vpitch);
-    SDL_EndGPUCopyPass(cpass);
+    retval &= StageUpload(renderdata, data->texture, bpp, rect->x, rect->y, rect->w, rect->h, Yplane, Ypitch);
+    retval &= StageUpload(renderdata, data->textureU, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Uplane, Upitch);
+    retval &= StageUpload(renderdata, data->textureV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, Vplane, Vpitch);
     return retval;
 }
 
@@ -574,12 +700,9 @@ static bool GPU_UpdateTextureNV(SDL_Renderer *renderer, SDL_Texture *texture,
     int bpp = SDL_BYTESPERPIXEL(texture->format);
 
     bool retval = true;
-    SDL_GPUCommandBuffer *cbuf = renderdata->state.command_buffer;
-    SDL_GPUCopyPass *cpass = SDL_BeginGPUCopyPass(cbuf);
-    retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->texture, bpp, rect->x, rect->y, rect->w, rect->h, Yplane, Ypitch);
+    retval &= StageUpload(renderdata, data->texture, bpp, rect->x, rect->y, rect->w, rect->h, Yplane, Ypitch);
     bpp *= 2;
-    retval &= GPU_UpdateTextureInternal(renderdata, cpass, data->textureNV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, UVplane, UVpitch);
-    SDL_EndGPUCopyPass(cpass);
+    retval &= StageUpload(renderdata, data->textureNV, bpp, rect->x / 2, rect->y / 2, (rect->w + 1) / 2, (rect->h + 1) / 2, UVplane, UVpitch);
     return retval;
 }
 #endif // SDL_HAVE_YUV
@@ -610,6 +733,70 @@ static void GPU_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
     GPU_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
 }
 
+// Returns true if every asynchronous upload up to and including upload has finished
+static bool ReleaseCompletedUploads(GPU_RenderData *data, Uint64 upload, bool wait)
+{
+    int i;
+
+    for (i = 0; i < data->async.count && data->async.uploads[i].upload <= upload; ++i) {
+        SDL_GPUFence *fence = data->async.uploads[i].fence;
+
+        if (wait) {
+            SDL_WaitForGPUFences(data->device, true, &fence, 1);
+        } else if (!SDL_QueryGPUFence(data->device, fence)) {
+            break;
+        }
+        SDL_ReleaseGPUFence(data->device, fence);
+    }
+
+    data->async.count -= i;
+    SDL_memmove(data->async.uploads, &data->async.uploads[i], data->async.count * sizeof(*data->async.uploads));
+
+    return (data->async.count == 0 || data->async.uploads[0].upload > upload);
+}
+
+static bool GPU_UpdateTextureAsync(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *rect, const void *pixels, int pitch, Uint64 upload)
+{
+    GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
+
+    if (data->async.count == data->async.max) {
+        const int max = data->async.max ? data->async.max * 2 : 16;
+        GPU_AsyncUpload *uploads = (GPU_AsyncUpload *)SDL_realloc(data->async.uploads, max * sizeof(*uploads));
+        if (!uploads) {
+            return false;
+        }
+        data->async.uploads = uploads;
+        data->async.max = max;
+    }
+
+    // The upload gets a command buffer to itself, so it can be fenced without waiting on the frame.
+    // Anything already recorded or staged is submitted first, so the GPU sees updates in order.
+    if (data->state.command_buffer_used || data->staging.num_pending > 0) {
+        SubmitCommandBuffer(data, false);
+    }
+
+    if (!GPU_UpdateTexture(renderer, texture, rect, pixels, pitch)) {
+        return false;
+    }
+
+    SDL_GPUFence *fence = SubmitCommandBuffer(data, true);
+    if (!fence) {
+        return false;
+    }
+
+    GPU_AsyncUpload *entry = &data->async.uploads[data->async.count++];
+    entry->upload = upload;
+    entry->fence = fence;
+    return true;
+}
+
+static bool GPU_IsTextureUploadComplete(SDL_Renderer *renderer, Uint64 upload, bool wait)
+{
+    GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
+
+    return ReleaseCompletedUploads(data, upload, wait);
+}
+
 static bool GPU_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
 {
     GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
@@ -1077,13 +1264,20 @@ static void ReleaseVertexBuffer(GPU_RenderData *data)
 {
     if (data->vertices.buffer) {
         SDL_ReleaseGPUBuffer(data->device, data->vertices.buffer);
+        data->vertices.buffer = NULL;
     }
 
     if (data->vertices.transfer_buf) {
+        if (data->vertices.mapped) {
+            SDL_UnmapGPUTransferBuffer(data->device, data->vertices.transfer_buf);
+            data->vertices.mapped = NULL;
+        }
         SDL_ReleaseGPUTransferBuffer(data->device, data->vertices.transfer_buf);
+        data->vertices.transfer_buf = NULL;
     }
 
     data->vertices.buffer_size = 0;
+    data->vertices.transfer_size = 0;
 }
 
 static bool InitVertexBuffer(GPU_RenderData *data, Uint32 size)
@@ -1111,26 +1305,90 @@ static bool InitVertexBuffer(GPU_RenderData *data, Uint32 size)
     }
 
     data->vertices.buffer_size = size;
+    data->vertices.transfer_size = size;
 
     return true;
 }
 
+// The renderer queues vertices straight into the mapped transfer buffer, so they only get written once.
+// Mapping with cycling gives us a fresh buffer whenever the GPU is still uploading from the last one.
+static void *GPU_GetVertexMemory(SDL_Renderer *renderer, size_t used, size_t *size)
+{
+    GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
+
+    if (*size > data->vertices.transfer_size) {
+        if (*size > SDL_MAX_UINT32) {
+            SDL_OutOfMemory();
+            return NULL;
+        }
+
+        SDL_GPUTransferBufferCreateInfo tbci;
+        SDL_zero(tbci);
+        tbci.size = (Uint32)*size;
+        tbci.usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD;
+
+        SDL_GPUTransferBuffer *transfer_buf = SDL_CreateGPUTransferBuffer(data->device, &tbci);
+        if (!transfer_buf) {
+            return NULL;
+        }
+
+        void *mapped = SDL_MapGPUTransferBuffer(data->device, transfer_buf, false);
+        if (!mapped) {
+            SDL_ReleaseGPUTransferBuffer(data->device, transfer_buf);
+            return NULL;
+        }
+
+        if (data->vertices.mapped) {
+            SDL_memcpy(mapped, data->vertices.mapped, used);
+            SDL_UnmapGPUTransferBuffer(data->device, data->vertices.transfer_buf);
+        }
+        if (data->vertices.transfer_buf) {
+            SDL_ReleaseGPUTransferBuffer(data->device, data->vertices.transfer_buf);
+        }
+        data->vertices.transfer_buf = transfer_buf;
+        data->vertices.transfer_size = tbci.size;
+        data->vertices.mapped = mapped;
+    } else if (!data->vertices.mapped) {
+        data->vertices.mapped = SDL_MapGPUTransferBuffer(data->device, data->vertices.transfer_buf, true);
+        if (!data->vertices.mapped) {
+            return NULL;
+        }
+    }
+
+    *size = data->vertices.transfer_size;
+    return data->vertices.mapped;
+}
+
+// Texture updates staged since the last flush are recorded in the same copy pass as the vertices
 static bool UploadVertices(GPU_RenderData *data, void *vertices, size_t vertsize)
 {
     if (vertsize == 0) {
-        return true;
+        return FlushUploads(data, data->state.command_buffer);
     }
 
+    // The vertices were queued into the transfer buffer by GPU_GetVertexMemory()
+    SDL_assert(vertices == data->vertices.mapped);
+    SDL_UnmapGPUTransferBuffer(data->device, data->vertices.transfer_buf);
+    data->vertices.mapped = NULL;
+
     if (vertsize > data->vertices.buffer_size) {
-        ReleaseVertexBuffer(data);
-        if (!InitVertexBuffer(data, (Uint32)vertsize)) {
+        SDL_GPUBufferCreateInfo bci;
+        SDL_zero(bci);
+        bci.size = data->vertices.transfer_size;
+        bci.usage = SDL_GPU_BUFFERUSAGE_VERTEX;
+
+        if (data->vertices.buffer) {
+            SDL_ReleaseGPUBuffer(data->device, data->vertices.buffer);
+        }
+        data->vertices.buffer = SDL_CreateGPUBuffer(data->device, &bci);
+        if (!data->vertices.buffer) {
+            data->vertices.buffer_size = 0;
             return false;
         }
+        data->vertices.buffer_size = bci.size;
     }
 
-    void *staging_buf = SDL_MapGPUTransferBuffer(data->device, data->vertices.transfer_buf, true);
-    SDL_memcpy(staging_buf, vertices, vertsize);
-    SDL_UnmapGPUTransferBuffer(data->device, data->vertices.transfer_buf);
+    UnmapStaging(data);
 
     SDL_GPUCopyPass *pass = SDL_BeginGPUCopyPass(data->state.command_buffer);
 
@@ -1138,6 +1396,8 @@ static bool UploadVertices(GPU_RenderData *data, void *vertices, size_t vertsize
         return false;
     }
 
+    RecordPendingUploads(data, pass);
+
     SDL_GPUTransferBufferLocation src;
     SDL_zero(src);
     src.transfer_buffer = data->vertices.transfer_buf;
@@ -1150,6 +1410,7 @@ static bool UploadVertices(GPU_RenderData *data, void *vertices, size_t vertsize
     SDL_UploadToGPUBuffer(pass, &src, &dst, true);
     SDL_EndGPUCopyPass(pass);
 
+    data->state.command_buffer_used = true;
     return true;
 }
 
@@ -1395,6 +1656,8 @@ static SDL_Surface *GPU_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect
         return NULL;
     }
 
+    FlushUploads(data, data->state.command_buffer);
+
     SDL_GPUCopyPass *pass = SDL_BeginGPUCopyPass(data->state.command_buffer);
 
     SDL_GPUTextureRegion src;
@@ -1415,10 +1678,9 @@ static SDL_Surface *GPU_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect
     SDL_DownloadFromGPUTexture(pass, &src, &dst);
     SDL_EndGPUCopyPass(pass);
 
-    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(data->state.command_buffer);
+    SDL_GPUFence *fence = SubmitCommandBuffer(data, true);
     SDL_WaitForGPUFences(data->device, true, &fence, 1);
     SDL_ReleaseGPUFence(data->device, fence);
-    data->state.command_buffer = SDL_AcquireGPUCommandBuffer(data->device);
 
     void *mapped_tbuf = SDL_MapGPUTransferBuffer(data->device, tbuf, false);
 
@@ -1469,6 +1731,8 @@ static bool GPU_RenderPresent(SDL_Renderer *renderer)
 {
     GPU_RenderData *data = (GPU_RenderData *)renderer->internal;
 
+    FlushUploads(data, data->state.command_buffer);
+
     if (renderer->window) {
         SDL_GPUTexture *swapchain;
         Uint32 swapchain_texture_width, swapchain_texture_height;
@@ -1506,6 +1770,11 @@ static bool GPU_RenderPresent(SDL_Renderer *renderer)
     }
 
     data->state.command_buffer = SDL_AcquireGPUCommandBuffer(data->device);
+    data->state.command_buffer_used = false;
+    data->staging.used = 0;
+
+    // Don't hold on to the fences of uploads that have finished
+    ReleaseCompletedUploads(data, SDL_MAX_UINT64, false);
 
     return true;
 }
@@ -1523,10 +1792,14 @@ static void GPU_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         return;
     }
 
+    DiscardPendingUploads(renderdata, data->texture);
     if (!data->external_texture) {
         SDL_ReleaseGPUTexture(renderdata->device, data->texture);
     }
 #ifdef SDL_HAVE_YUV
+    DiscardPendingUploads(renderdata, data->textureU);
+    DiscardPendingUploads(renderdata, data->textureV);
+    DiscardPendingUploads(renderdata, data->textureNV);
     if (!data->external_texture_u) {
         SDL_ReleaseGPUTexture(renderdata->device, data->textureU);
     }
@@ -1569,6 +1842,15 @@ static void GPU_DestroyRenderer(SDL_Renderer *renderer)
         SDL_ReleaseWindowFromGPUDevice(data->device, renderer->window);
     }
 
+    ReleaseCompletedUploads(data, SDL_MAX_UINT64, true);
+    SDL_free(data->async.uploads);
+
+    UnmapStaging(data);
+    if (data->staging.transfer_buf) {
+        SDL_ReleaseGPUTransferBuffer(data->device, data->staging.transfer_buf);
+    }
+    SDL_free(data->staging.pending);
+
     ReleaseVertexBuffer(data);
     GPU_DestroyPipelineCache(&data->pipeline_cache);
 
@@ -1672,6 +1954,8 @@ static bool GPU_CreateRenderer(SDL_Renderer *renderer, SDL_Window *window, SDL_P
 #endif
     renderer->LockTexture = GPU_LockTexture;
     renderer->UnlockTexture = GPU_UnlockTexture;
+    renderer->UpdateTextureAsync = GPU_UpdateTextureAsync;
+    renderer->IsTextureUploadComplete = GPU_IsTextureUploadComplete;
     renderer->SetRenderTarget = GPU_SetRenderTarget;
     renderer->QueueSetViewport = GPU_QueueNoOp;
     renderer->QueueSetDrawColor = GPU_QueueNoOp;
@@ -1680,6 +1964,7 @@ static bool GPU_CreateRenderer(SDL_Renderer *renderer, SDL_Window *window, SDL_P
     renderer->QueueGeometry = GPU_QueueGeometry;
     renderer->InvalidateCachedState = GPU_InvalidateCachedState;
     renderer->RunCommandQueue = GPU_RunCommandQueue;
+    renderer->GetVertexMemory = GPU_GetVertexMemory;
     renderer->RenderReadPixels = GPU_RenderReadPixels;
     renderer->RenderPresent = GPU_RenderPresent;
     renderer->DestroyTexture = GPU_DestroyTexture;
@@ -49,6 +49,12 @@
    http://developer.apple.com/library/mac/#documentation/GraphicsImaging/Conceptual/OpenGL-MacProgGuide/opengl_texturedata/opengl_texturedata.html
 */
 
+// The most command queues whose GPU time can be waiting to be read back
+#define GL_TIMER_QUERY_COUNT 16
+
+// The number of pixel buffers a streaming texture locks into in turn
+#define GL_STREAMING_BUFFER_COUNT 3
+
 typedef struct GL_FBOList GL_FBOList;
 
 struct GL_FBOList
@@ -123,6 +129,31 @@ typedef struct
     // Shader support
     GL_ShaderContext *shaders;
 
+    // GPU timing support, each command queue is timed with a pair of timestamps and the times are added up for each frame
+    bool GL_ARB_timer_query_supported;
+    PFNGLGENQUERIESPROC glGenQueries;
+    PFNGLDELETEQUERIESPROC glDeleteQueries;
+    PFNGLQUERYCOUNTERPROC glQueryCounter;
+    PFNGLGETQUERYOBJECTIVPROC glGetQueryObjectiv;
+    PFNGLGETQUERYOBJECTUI64VPROC glGetQueryObjectui64v;
+    GLuint timer_queries[GL_TIMER_QUERY_COUNT * 2];
+    Uint64 timer_query_frames[GL_TIMER_QUERY_COUNT];
+    int timer_query_first;
+    int timer_query_count;
+    Uint64 timer_frame;
+    Uint64 timer_ns;
+    Uint64 gpu_frame;
+    Uint64 gpu_ns;
+
+    // Streaming texture support, locks are written into pixel buffers that are uploaded from asynchronously
+    bool GL_ARB_pixel_buffer_object_supported;
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+
     GL_DrawStateCache drawstate;
 } GL_RenderData;
 
@@ -143,8 +174,14 @@ typedef struct
     float texel_size[4];
     const float *shader_params;
     void *pixels;
+    size_t pixels_size;
     int pitch;
     SDL_Rect locked_rect;
+    // Each lock uses the next pixel buffer, so it doesn't wait for the upload from the lock before
+    GLuint pixel_buffers[GL_STREAMING_BUFFER_COUNT];
+    size_t pixel_buffer_sizes[GL_STREAMING_BUFFER_COUNT];
+    int pixel_buffer;
+    void *mapped_pixels;
 #ifdef SDL_HAVE_YUV
     // YUV texture support
     bool yuv;
@@ -598,6 +635,7 @@ static bool GL_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture, SDL_P
             SDL_free(data);
             return false;
         }
+        data->pixels_size = size;
     }
 
     if (texture->access == SDL_TEXTUREACCESS_TARGET) {
@@ -908,26 +946,98 @@ static bool GL_UpdateTextureNV(SDL_Renderer *renderer, SDL_Texture *texture,
 }
 #endif
 
+// Maps the next pixel buffer, with room for size bytes
+static void *GL_MapPixelBuffer(SDL_Renderer *renderer, GL_TextureData *data, size_t size)
+{
+    GL_RenderData *renderdata = (GL_RenderData *)renderer->internal;
+    void *mapped;
+
+    if (!data->pixel_buffers[0]) {
+        renderdata->glGenBuffersARB(GL_STREAMING_BUFFER_COUNT, data->pixel_buffers);
+    }
+    data->pixel_buffer = (data->pixel_buffer + 1) % GL_STREAMING_BUFFER_COUNT;
+
+    renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pixel_buffers[data->pixel_buffer]);
+    if (data->pixel_buffer_sizes[data->pixel_buffer] != size) {
+        renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, size, NULL, GL_STREAM_DRAW_ARB);
+        data->pixel_buffer_sizes[data->pixel_buffer] = size;
+    }
+    mapped = renderdata->glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+    renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+    return mapped;
+}
+
+static bool GL_IsFullLock(SDL_Texture *texture, const SDL_Rect *rect)
+{
+    return rect->x == 0 && rect->y == 0 && rect->w == texture->w && rect->h == texture->h;
+}
+
+// The pixel buffer holds the rows that were locked, or everything for a full lock, which includes any YUV planes
+static size_t GL_GetLockedPixelsSize(SDL_Texture *texture, GL_TextureData *data, const SDL_Rect *rect)
+{
+    if (GL_IsFullLock(texture, rect)) {
+        return data->pixels_size;
+    }
+    return (size_t)rect->h * data->pitch;
+}
+
+// Partial locks of YUV textures upload chroma planes past the locked rows, which only the shadow buffer has room for
+static bool GL_CanLockPixelBuffer(SDL_Texture *texture, GL_TextureData *data, const SDL_Rect *rect)
+{
+#ifdef SDL_HAVE_YUV
+    if ((data->yuv || data->nv12) && !GL_IsFullLock(texture, rect)) {
+        return false;
+    }
+#endif
+    return true;
+}
+
 static bool GL_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture,
                           const SDL_Rect *rect, void **pixels, int *pitch)
 {
+    GL_RenderData *renderdata = (GL_RenderData *)renderer->internal;
     GL_TextureData *data = (GL_TextureData *)texture->internal;
 
     data->locked_rect = *rect;
+    *pitch = data->pitch;
+
+    if (renderdata->GL_ARB_pixel_buffer_object_supported && GL_CanLockPixelBuffer(texture, data, rect)) {
+        GL_ActivateRenderer(renderer);
+
+        data->mapped_pixels = GL_MapPixelBuffer(renderer, data, GL_GetLockedPixelsSize(texture, data, rect));
+        if (data->mapped_pixels) {
+            *pixels = (void *)((Uint8 *)data->mapped_pixels + rect->x * SDL_BYTESPERPIXEL(texture->format));
+            return true;
+        }
+    }
+
     *pixels =
         (void *)((Uint8 *)data->pixels + rect->y * data->pitch +
                  rect->x * SDL_BYTESPERPIXEL(texture->format));
-    *pitch = data->pitch;
     return true;
 }
 
 static void GL_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
+    GL_RenderData *renderdata = (GL_RenderData *)renderer->internal;
     GL_TextureData *data = (GL_TextureData *)texture->internal;
     const SDL_Rect *rect;
     void *pixels;
 
     rect = &data->locked_rect;
+    if (data->mapped_pixels) {
+        GL_ActivateRenderer(renderer);
+
+        // The upload reads from the pixel buffer, so it can happen after this returns
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pixel_buffers[data->pixel_buffer]);
+        renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+        data->mapped_pixels = NULL;
+        pixels = (void *)(uintptr_t)(rect->x * SDL_BYTESPERPIXEL(texture->format));
+        GL_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        return;
+    }
+
     pixels =
         (void *)((Uint8 *)data->pixels + rect->y * data->pitch +
                  rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -1355,6 +1465,91 @@ static void GL_InvalidateCachedState(SDL_Renderer *renderer)
     cache->clear_color_dirty = true;
 }
 
+static void GL_BeginTimerQuery(SDL_Renderer *renderer)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->internal;
+    int index;
+
+    // If the GPU is that far behind, this command queue isn't timed
+    if (!data->GL_ARB_timer_query_supported || data->timer_query_count == GL_TIMER_QUERY_COUNT) {
+        return;
+    }
+
+    index = (data->timer_query_first + data->timer_query_count) % GL_TIMER_QUERY_COUNT;
+    data->timer_query_frames[index] = renderer->last_frame_stats.frame + 1;
+    data->glQueryCounter(data->timer_queries[index * 2], GL_TIMESTAMP);
+}
+
+static void GL_EndTimerQuery(SDL_Renderer *renderer)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->internal;
+    int index;
+
+    if (!data->GL_ARB_timer_query_supported || data->timer_query_count == GL_TIMER_QUERY_COUNT) {
+        return;
+    }
+
+    index = (data->timer_query_first + data->timer_query_count) % GL_TIMER_QUERY_COUNT;
+    data->glQueryCounter(data->timer_queries[index * 2 + 1], GL_TIMESTAMP);
+    ++data->timer_query_count;
+}
+
+static bool GL_GetGPUFrameTime(SDL_Renderer *renderer, Uint64 *frame, Uint64 *ns)
+{
+    GL_RenderData *data = (GL_RenderData *)renderer->internal;
+
+    if (!data->GL_ARB_timer_query_supported) {
+        return false;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    // Queries finish in order, a frame is complete when the queries after it belong to a later frame
+    while (data->timer_query_count > 0) {
+        const int index = data->timer_query_first;
+        GLint available = 0;
+        GLuint64 start = 0, end = 0;
+
+        data->glGetQueryObjectiv(data->timer_queries[index * 2 + 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+        data->glGetQueryObjectui64v(data->timer_queries[index * 2], GL_QUERY_RESULT, &start);
+        data->glGetQueryObjectui64v(data->timer_queries[index * 2 + 1], GL_QUERY_RESULT, &end);
+
+        if (data->timer_query_frames[index] != data->timer_frame) {
+            if (data->timer_frame) {
+                data->gpu_frame = data->timer_frame;
+                data->gpu_ns = data->timer_ns;
+            }
+            data->timer_frame = data->timer_query_frames[index];
+            data->timer_ns = 0;
+        }
+        if (end > start) {
+            data->timer_ns += end - start;
+        }
+
+        data->timer_query_first = (index + 1) % GL_TIMER_QUERY_COUNT;
+        --data->timer_query_count;
+    }
+
+    // Nothing else can be queued for frames that have been presented
+    if (data->timer_frame && data->timer_frame <= renderer->frame_stats.frame &&
+        (data->timer_query_count == 0 || data->timer_query_frames[data->timer_query_first] != data->timer_frame)) {
+        data->gpu_frame = data->timer_frame;
+        data->gpu_ns = data->timer_ns;
+        data->timer_frame = 0;
+        data->timer_ns = 0;
+    }
+
+    if (!data->gpu_frame) {
+        return false;
+    }
+    *frame = data->gpu_frame;
+    *ns = data->gpu_ns;
+    return true;
+}
+
 static bool GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
 {
     // !!! FIXME: it'd be nice to use a vertex buffer instead of immediate mode...
@@ -1364,6 +1559,8 @@ static bool GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
         return false;
     }
 
+    GL_BeginTimerQuery(renderer);
+
     data->drawstate.target = renderer->target;
     if (!data->drawstate.target) {
         int w, h;
@@ -1607,6 +1804,8 @@ static bool GL_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
         data->drawstate.texture_array = false;
     }
 
+    GL_EndTimerQuery(renderer);
+
     return GL_CheckError("", renderer);
 }
 
@@ -1696,6 +1895,14 @@ static void GL_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         }
     }
 #endif
+    if (data->pixel_buffers[0]) {
+        if (data->mapped_pixels) {
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pixel_buffers[data->pixel_buffer]);
+            renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        }
+        renderdata->glDeleteBuffersARB(GL_STREAMING_BUFFER_COUNT, data->pixel_buffers);
+    }
     SDL_free(data->pixels);
     SDL_free(data);
     texture->internal = NULL;
@@ -1722,6 +1929,9 @@ static void GL_DestroyRenderer(SDL_Renderer *renderer)
         if (data->shaders) {
             GL_DestroyShaderContext(data->shaders);
         }
+        if (data->GL_ARB_timer_query_supported) {
+            data->glDeleteQueries(SDL_arraysize(data->timer_queries), data->timer_queries);
+        }
         if (data->context) {
             while (data->framebuffers) {
                 GL_FBOList *nextnode = data->framebuffers->next;
@@ -1829,6 +2039,7 @@ static bool GL_CreateRenderer(SDL_Renderer *renderer, SDL_Window *window, SDL_Pr
     renderer->RunCommandQueue = GL_RunCommandQueue;
     renderer->RenderReadPixels = GL_RenderReadPixels;
     renderer->RenderPresent = GL_RenderPresent;
+    renderer->GetGPUFrameTime = GL_GetGPUFrameTime;
     renderer->DestroyTexture = GL_DestroyTexture;
     renderer->DestroyRenderer = GL_DestroyRenderer;
     renderer->SetVSync = GL_SetVSync;
@@ -2008,6 +2219,32 @@ static bool GL_CreateRenderer(SDL_Renderer *renderer, SDL_Window *window, SDL_Pr
         goto error;
     }
 
+    if (SDL_GL_ExtensionSupported("GL_ARB_timer_query")) {
+        data->glGenQueries = (PFNGLGENQUERIESPROC)SDL_GL_GetProcAddress("glGenQueries");
+        data->glDeleteQueries = (PFNGLDELETEQUERIESPROC)SDL_GL_GetProcAddress("glDeleteQueries");
+        data->glQueryCounter = (PFNGLQUERYCOUNTERPROC)SDL_GL_GetProcAddress("glQueryCounter");
+        data->glGetQueryObjectiv = (PFNGLGETQUERYOBJECTIVPROC)SDL_GL_GetProcAddress("glGetQueryObjectiv");
+        data->glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VPROC)SDL_GL_GetProcAddress("glGetQueryObjectui64v");
+        if (data->glGenQueries && data->glDeleteQueries && data->glQueryCounter &&
+            data->glGetQueryObjectiv && data->glGetQueryObjectui64v) {
+            data->glGenQueries(SDL_arraysize(data->timer_queries), data->timer_queries);
+            data->GL_ARB_timer_query_supported = true;
+        }
+    }
+
+    if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC)SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC)SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC)SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC)SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)SDL_GL_GetProcAddress("glUnmapBufferARB");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB && data->glBindBufferARB &&
+            data->glBufferDataARB && data->glMapBufferARB && data->glUnmapBufferARB) {
+            data->GL_ARB_pixel_buffer_object_supported = true;
+        }
+    }
+
     // Set up parameters for rendering
     data->glMatrixMode(GL_MODELVIEW);
     data->glLoadIdentity();
@@ -25,6 +25,214 @@
 #include "SDL_draw.h"
 #include "SDL_blendfillrect.h"
 
+// Divide by 255 with the same result as DRAW_MUL, for values up to 255 * 255
+#define SPAN_DIV255(x) (((x) + 1 + ((x) >> 8)) >> 8)
+
+static Uint8 BlendSpanChannel(unsigned d, unsigned mul1, unsigned mul2, unsigned add)
+{
+    const unsigned value = SPAN_DIV255(d * mul1) + SPAN_DIV255(d * mul2) + add;
+    return (Uint8)SDL_min(value, 0xff);
+}
+
+bool SDL_GetBlendSpanInfo(const SDL_PixelFormatDetails *fmt, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendSpanInfo *info)
+{
+    const Uint8 inva = 0xff - a;
+    Uint8 mul1[4], mul2[4], add[4];  // R, G, B, A
+    int i;
+
+    switch (blendMode) {
+    case SDL_BLENDMODE_BLEND:
+    case SDL_BLENDMODE_BLEND_PREMULTIPLIED:
+        mul1[0] = mul1[1] = mul1[2] = mul1[3] = inva;
+        mul2[0] = mul2[1] = mul2[2] = mul2[3] = 0;
+        add[0] = r;
+        add[1] = g;
+        add[2] = b;
+        add[3] = a;
+        break;
+    case SDL_BLENDMODE_ADD:
+    case SDL_BLENDMODE_ADD_PREMULTIPLIED:
+        mul1[0] = mul1[1] = mul1[2] = mul1[3] = 0xff;
+        mul2[0] = mul2[1] = mul2[2] = mul2[3] = 0;
+        add[0] = r;
+        add[1] = g;
+        add[2] = b;
+        add[3] = 0;
+        break;
+    case SDL_BLENDMODE_MOD:
+    case SDL_BLENDMODE_MUL:
+        mul1[0] = r;
+        mul1[1] = g;
+        mul1[2] = b;
+        mul1[3] = 0xff;
+        if (blendMode == SDL_BLENDMODE_MUL) {
+            mul2[0] = mul2[1] = mul2[2] = inva;
+        } else {
+            mul2[0] = mul2[1] = mul2[2] = 0;
+        }
+        mul2[3] = 0;
+        add[0] = add[1] = add[2] = add[3] = 0;
+        break;
+    default:
+        return false;
+    }
+
+    SDL_zerop(info);
+    info->bytes_per_pixel = fmt->bytes_per_pixel;
+    if (fmt->format == SDL_PIXELFORMAT_RGB565) {
+        SDL_memcpy(info->mul1, mul1, 3);
+        SDL_memcpy(info->mul2, mul2, 3);
+        SDL_memcpy(info->add, add, 3);
+        return true;
+    }
+    if (fmt->bytes_per_pixel == 4 && fmt->Rbits == 8 && fmt->Gbits == 8 && fmt->Bbits == 8 &&
+        (fmt->Abits == 8 || fmt->Abits == 0)) {
+        const Uint8 shifts[4] = { fmt->Rshift, fmt->Gshift, fmt->Bshift, fmt->Ashift };
+
+        for (i = 0; i < 4; ++i) {
+            int byte;
+
+            if (i == 3 && !fmt->Abits) {
+                continue;
+            }
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+            byte = 3 - shifts[i] / 8;
+#else
+            byte = shifts[i] / 8;
+#endif
+            info->mul1[byte] = mul1[i];
+            info->mul2[byte] = mul2[i];
+            info->add[byte] = add[i];
+            info->keep[byte] = 0xff;
+        }
+        return true;
+    }
+    return false;
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static __m128i SDL_TARGETING("sse2") BlendSpanPixelsSSE2(__m128i d, __m128i mul1, __m128i mul2, __m128i add)
+{
+    const __m128i one = _mm_set1_epi16(1);
+    __m128i x1 = _mm_mullo_epi16(d, mul1);
+    __m128i x2 = _mm_mullo_epi16(d, mul2);
+
+    x1 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x1, one), _mm_srli_epi16(x1, 8)), 8);
+    x2 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x2, one), _mm_srli_epi16(x2, 8)), 8);
+    return _mm_add_epi16(_mm_add_epi16(x1, x2), add);
+}
+
+static int SDL_TARGETING("sse2") BlendSpan8888SSE2(const SDL_BlendSpanInfo *info, Uint32 *pixels, int width)
+{
+    const __m128i zero = _mm_setzero_si128();
+    Uint32 mul1, mul2, add, keep;
+    __m128i vmul1, vmul2, vadd, vkeep;
+    int i;
+
+    SDL_memcpy(&mul1, info->mul1, 4);
+    SDL_memcpy(&mul2, info->mul2, 4);
+    SDL_memcpy(&add, info->add, 4);
+    SDL_memcpy(&keep, info->keep, 4);
+    vmul1 = _mm_unpacklo_epi8(_mm_set1_epi32((int)mul1), zero);
+    vmul2 = _mm_unpacklo_epi8(_mm_set1_epi32((int)mul2), zero);
+    vadd = _mm_unpacklo_epi8(_mm_set1_epi32((int)add), zero);
+    vkeep = _mm_set1_epi32((int)keep);
+
+    for (i = 0; i + 4 <= width; i += 4) {
+        const __m128i d = _mm_loadu_si128((const __m128i *)(pixels + i));
+        const __m128i lo = BlendSpanPixelsSSE2(_mm_unpacklo_epi8(d, zero), vmul1, vmul2, vadd);
+        const __m128i hi = BlendSpanPixelsSSE2(_mm_unpackhi_epi8(d, zero), vmul1, vmul2, vadd);
+
+        // Packing with unsigned saturation clamps the channels to 255
+        _mm_storeu_si128((__m128i *)(pixels + i), _mm_and_si128(_mm_packus_epi16(lo, hi), vkeep));
+    }
+    return i;
+}
+
+static __m128i SDL_TARGETING("sse2") BlendSpanChannelSSE2(__m128i c, Uint8 mul1, Uint8 mul2, Uint8 add)
+{
+    c = BlendSpanPixelsSSE2(c, _mm_set1_epi16(mul1), _mm_set1_epi16(mul2), _mm_set1_epi16(add));
+    return _mm_min_epi16(c, _mm_set1_epi16(0xff));
+}
+
+static int SDL_TARGETING("sse2") BlendSpan565SSE2(const SDL_BlendSpanInfo *info, Uint16 *pixels, int width)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1f);
+    const __m128i mask6 = _mm_set1_epi16(0x3f);
+    int i;
+
+    for (i = 0; i + 8 <= width; i += 8) {
+        const __m128i d = _mm_loadu_si128((const __m128i *)(pixels + i));
+        __m128i r = _mm_srli_epi16(d, 11);
+        __m128i g = _mm_and_si128(_mm_srli_epi16(d, 5), mask6);
+        __m128i b = _mm_and_si128(d, mask5);
+
+        // Expand to 8 bits the same way as SDL_expand_byte
+        r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+        g = _mm_or_si128(_mm_slli_epi16(g, 2), _mm_srli_epi16(g, 4));
+        b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+        r = BlendSpanChannelSSE2(r, info->mul1[0], info->mul2[0], info->add[0]);
+        g = BlendSpanChannelSSE2(g, info->mul1[1], info->mul2[1], info->add[1]);
+        b = BlendSpanChannelSSE2(b, info->mul1[2], info->mul2[2], info->add[2]);
+
+        _mm_storeu_si128((__m128i *)(pixels + i),
+                         _mm_or_si128(_mm_or_si128(_mm_slli_epi16(_mm_srli_epi16(r, 3), 11),
+                                                   _mm_slli_epi16(_mm_srli_epi16(g, 2), 5)),
+                                      _mm_srli_epi16(b, 3)));
+    }
+    return i;
+}
+#endif // SDL_SSE2_INTRINSICS
+
+void SDL_BlendSpan(const SDL_BlendSpanInfo *info, void *pixels, int width)
+{
+    int i = 0;
+
+    if (info->bytes_per_pixel == 4) {
+        Uint8 *p;
+
+#ifdef SDL_SSE2_INTRINSICS
+        if (width >= 4 && SDL_HasSSE2()) {
+            i = BlendSpan8888SSE2(info, (Uint32 *)pixels, width);
+        }
+#endif
+        for (p = (Uint8 *)pixels + i * 4; i < width; ++i, p += 4) {
+            p[0] = BlendSpanChannel(p[0], info->mul1[0], info->mul2[0], info->add[0]) & info->keep[0];
+            p[1] = BlendSpanChannel(p[1], info->mul1[1], info->mul2[1], info->add[1]) & info->keep[1];
+            p[2] = BlendSpanChannel(p[2], info->mul1[2], info->mul2[2], info->add[2]) & info->keep[2];
+            p[3] = BlendSpanChannel(p[3], info->mul1[3], info->mul2[3], info->add[3]) & info->keep[3];
+        }
+    } else {
+        Uint16 *p = (Uint16 *)pixels;
+
+#ifdef SDL_SSE2_INTRINSICS
+        if (width >= 8 && SDL_HasSSE2()) {
+            i = BlendSpan565SSE2(info, p, width);
+        }
+#endif
+        for (; i < width; ++i) {
+            const Uint16 pixel = p[i];
+            const unsigned sr = BlendSpanChannel(SDL_expand_byte[5][pixel >> 11], info->mul1[0], info->mul2[0], info->add[0]);
+            const unsigned sg = BlendSpanChannel(SDL_expand_byte[6][(pixel >> 5) & 0x3f], info->mul1[1], info->mul2[1], info->add[1]);
+            const unsigned sb = BlendSpanChannel(SDL_expand_byte[5][pixel & 0x1f], info->mul1[2], info->mul2[2], info->add[2]);
+
+            RGB565_FROM_RGB(p[i], sr, sg, sb);
+        }
+    }
+}
+
+static void SDL_BlendFillRect_Span(SDL_Surface *dst, const SDL_Rect *rect, const SDL_BlendSpanInfo *info)
+{
+    Uint8 *pixels = (Uint8 *)dst->pixels + rect->y * dst->pitch + rect->x * info->bytes_per_pixel;
+    int height = rect->h;
+
+    while (height--) {
+        SDL_BlendSpan(info, pixels, rect->w);
+        pixels += dst->pitch;
+    }
+}
+
 static bool SDL_BlendFillRect_RGB555(SDL_Surface *dst, const SDL_Rect *rect,
                                     SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
@@ -236,6 +444,7 @@ static bool SDL_BlendFillRect_RGBA(SDL_Surface *dst, const SDL_Rect *rect,
 
 bool SDL_BlendFillRect(SDL_Surface *dst, const SDL_Rect *rect, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
+    SDL_BlendSpanInfo info;
     SDL_Rect clipped;
 
     CHECK_PARAM(!SDL_SurfaceValid(dst)) {
@@ -264,6 +473,11 @@ bool SDL_BlendFillRect(SDL_Surface *dst, const SDL_Rect *rect, SDL_BlendMode ble
         b = DRAW_MUL(b, a);
     }
 
+    if (SDL_GetBlendSpanInfo(dst->fmt, blendMode, r, g, b, a, &info)) {
+        SDL_BlendFillRect_Span(dst, rect, &info);
+        return true;
+    }
+
     switch (dst->fmt->bits_per_pixel) {
     case 15:
         switch (dst->fmt->Rmask) {
@@ -301,6 +515,7 @@ bool SDL_BlendFillRect(SDL_Surface *dst, const SDL_Rect *rect, SDL_BlendMode ble
 
 bool SDL_BlendFillRects(SDL_Surface *dst, const SDL_Rect *rects, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
+    SDL_BlendSpanInfo info;
     SDL_Rect rect;
     int i;
     bool (*func)(SDL_Surface * dst, const SDL_Rect *rect, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a) = NULL;
@@ -321,6 +536,15 @@ bool SDL_BlendFillRects(SDL_Surface *dst, const SDL_Rect *rects, int count, SDL_
         b = DRAW_MUL(b, a);
     }
 
+    if (SDL_GetBlendSpanInfo(dst->fmt, blendMode, r, g, b, a, &info)) {
+        for (i = 0; i < count; ++i) {
+            if (SDL_GetRectIntersection(&rects[i], &dst->clip_rect, &rect)) {
+                SDL_BlendFillRect_Span(dst, &rect, &info);
+            }
+        }
+        return true;
+    }
+
     // FIXME: Does this function pointer slow things down significantly?
     switch (dst->fmt->bits_per_pixel) {
     case 15:
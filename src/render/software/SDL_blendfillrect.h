@@ -24,6 +24,22 @@
 
 #include "SDL_internal.h"
 
+/* A solid color blended over runs of pixels, for the formats that have a fast path.
+ * Each destination channel becomes (d * mul1 / 255) + (d * mul2 / 255) + add, clamped to 255,
+ * which gives the same result as the per-pixel blend operators in SDL_draw.h.
+ * As there, the color is premultiplied by alpha for SDL_BLENDMODE_BLEND and SDL_BLENDMODE_ADD.
+ */
+typedef struct SDL_BlendSpanInfo
+{
+    int bytes_per_pixel;
+    Uint8 mul1[4];  // in memory byte order for 32-bit formats, in R, G, B order for RGB565
+    Uint8 mul2[4];
+    Uint8 add[4];
+    Uint8 keep[4];  // 0 for the unused byte of 32-bit formats, which is always cleared
+} SDL_BlendSpanInfo;
+
+extern bool SDL_GetBlendSpanInfo(const SDL_PixelFormatDetails *fmt, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendSpanInfo *info);
+extern void SDL_BlendSpan(const SDL_BlendSpanInfo *info, void *pixels, int width);
 extern bool SDL_BlendFillRect(SDL_Surface *dst, const SDL_Rect *rect, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 extern bool SDL_BlendFillRects(SDL_Surface *dst, const SDL_Rect *rects, int count, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
@@ -23,6 +23,7 @@
 #ifdef SDL_VIDEO_RENDER_SW
 
 #include "SDL_draw.h"
+#include "SDL_blendfillrect.h"
 #include "SDL_blendline.h"
 #include "SDL_blendpoint.h"
 
@@ -919,8 +920,36 @@ static BlendLineFunc SDL_CalculateBlendLineFunc(const SDL_PixelFormatDetails *fm
     return NULL;
 }
 
+static bool SDL_GetBlendLineSpanInfo(SDL_Surface *dst, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a, SDL_BlendSpanInfo *info)
+{
+    if (blendMode == SDL_BLENDMODE_BLEND || blendMode == SDL_BLENDMODE_ADD) {
+        r = DRAW_MUL(r, a);
+        g = DRAW_MUL(g, a);
+        b = DRAW_MUL(b, a);
+    }
+    return SDL_GetBlendSpanInfo(dst->fmt, blendMode, r, g, b, a, info);
+}
+
+// Horizontal lines are blended as spans, with the same end point handling as HLINE
+static void SDL_BlendLineSpan(SDL_Surface *dst, int x1, int y1, int x2, const SDL_BlendSpanInfo *info, bool draw_end)
+{
+    const int bpp = info->bytes_per_pixel;
+    Uint8 *pixels;
+    int length;
+
+    if (x1 <= x2) {
+        pixels = (Uint8 *)dst->pixels + y1 * dst->pitch + x1 * bpp;
+        length = draw_end ? (x2 - x1 + 1) : (x2 - x1);
+    } else {
+        pixels = (Uint8 *)dst->pixels + y1 * dst->pitch + (draw_end ? x2 : x2 + 1) * bpp;
+        length = draw_end ? (x1 - x2 + 1) : (x1 - x2);
+    }
+    SDL_BlendSpan(info, pixels, length);
+}
+
 bool SDL_BlendLine(SDL_Surface *dst, int x1, int y1, int x2, int y2, SDL_BlendMode blendMode, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
+    SDL_BlendSpanInfo info;
     BlendLineFunc func;
 
     CHECK_PARAM(!SDL_SurfaceValid(dst)) {
@@ -938,6 +967,10 @@ bool SDL_BlendLine(SDL_Surface *dst, int x1, int y1, int x2, int y2, SDL_BlendMo
         return true;
     }
 
+    if (y1 == y2 && SDL_GetBlendLineSpanInfo(dst, blendMode, r, g, b, a, &info)) {
+        SDL_BlendLineSpan(dst, x1, y1, x2, &info, true);
+        return true;
+    }
     func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, true);
     return true;
 }
@@ -949,6 +982,8 @@ bool SDL_BlendLines(SDL_Surface *dst, const SDL_Point *points, int count, SDL_Bl
     int x2, y2;
     bool draw_end;
     BlendLineFunc func;
+    SDL_BlendSpanInfo info;
+    bool spans;
 
     if (!SDL_SurfaceValid(dst)) {
         return SDL_SetError("SDL_BlendLines(): Passed NULL destination surface");
@@ -958,6 +993,7 @@ bool SDL_BlendLines(SDL_Surface *dst, const SDL_Point *points, int count, SDL_Bl
     if (!func) {
         return SDL_SetError("SDL_BlendLines(): Unsupported surface format");
     }
+    spans = SDL_GetBlendLineSpanInfo(dst, blendMode, r, g, b, a, &info);
 
     for (i = 1; i < count; ++i) {
         x1 = points[i - 1].x;
@@ -974,6 +1010,10 @@ bool SDL_BlendLines(SDL_Surface *dst, const SDL_Point *points, int count, SDL_Bl
         // Draw the end if it was clipped
         draw_end = (x2 != points[i].x || y2 != points[i].y);
 
+        if (spans && y1 == y2) {
+            SDL_BlendLineSpan(dst, x1, y1, x2, &info, draw_end);
+            continue;
+        }
         func(dst, x1, y1, x2, y2, blendMode, r, g, b, a, draw_end);
     }
     if (points[0].x != points[count - 1].x || points[0].y != points[count - 1].y) {
@@ -32,6 +32,7 @@
 #include "SDL_drawline.h"
 #include "SDL_drawpoint.h"
 #include "SDL_triangle.h"
+#include "../SDL_yuv_sw_c.h"
 #include "../../video/SDL_pixels_c.h"
 #include "../../video/SDL_rotate.h"
 
@@ -45,12 +46,59 @@ typedef struct
     SDL_Color color;
 } SW_DrawStateCache;
 
+// Past this many separate dirty rects, they're merged into the one rect that encloses them all
+#define SW_MAX_DIRTY_RECTS 16
+
 typedef struct
 {
     SDL_Surface *surface;
     SDL_Surface *window;
+
+    // The parts of the window surface drawn to since the last present, only these are sent to the window
+    SDL_Rect dirty_rects[SW_MAX_DIRTY_RECTS];
+    int num_dirty_rects;
+    bool dirty_all;
 } SW_RenderData;
 
+typedef struct
+{
+    SDL_Surface *surface;
+#ifdef SDL_HAVE_YUV
+    /* YUV textures are drawn straight from the YUV planes when possible,
+     * and converted into the surface above for anything else.
+     */
+    SDL_SW_YUVTexture *yuv;
+    SDL_PixelFormat yuv_target_format;
+    bool yuv_dirty;
+#endif
+} SW_TextureData;
+
+static SDL_Surface *SW_GetTextureSurface(SDL_Texture *texture)
+{
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
+
+#ifdef SDL_HAVE_YUV
+    if (texturedata->yuv && texturedata->yuv_dirty) {
+        SDL_Surface *surface = texturedata->surface;
+
+        if (!surface) {
+            surface = SDL_CreateSurface(texture->w, texture->h, texturedata->yuv_target_format);
+            if (!surface) {
+                return NULL;
+            }
+            texturedata->surface = surface;
+        }
+        if (!SDL_ConvertPixelsAndColorspace(texture->w, texture->h, texturedata->yuv->format, texturedata->yuv->colorspace, 0,
+                                            texturedata->yuv->planes[0], texturedata->yuv->pitches[0],
+                                            surface->format, SDL_COLORSPACE_SRGB, 0, surface->pixels, surface->pitch)) {
+            return NULL;
+        }
+        texturedata->yuv_dirty = false;
+    }
+#endif
+    return texturedata->surface;
+}
+
 static SDL_Surface *SW_ActivateRenderer(SDL_Renderer *renderer)
 {
     SW_RenderData *data = (SW_RenderData *)renderer->internal;
@@ -62,6 +110,7 @@ static SDL_Surface *SW_ActivateRenderer(SDL_Renderer *renderer)
         SDL_Surface *surface = SDL_GetWindowSurface(renderer->window);
         if (surface) {
             data->surface = data->window = surface;
+            data->dirty_all = true;
         }
     }
     return data->surface;
@@ -74,6 +123,9 @@ static void SW_WindowEvent(SDL_Renderer *renderer, const SDL_WindowEvent *event)
     if (event->type == SDL_EVENT_WINDOW_PIXEL_SIZE_CHANGED) {
         data->surface = NULL;
         data->window = NULL;
+    } else if (event->type == SDL_EVENT_WINDOW_EXPOSED) {
+        // The window contents may have been lost, send all of them next time
+        data->dirty_all = true;
     }
 }
 
@@ -123,7 +175,7 @@ static void SW_DestroyPalette(SDL_Renderer *renderer, SDL_TexturePalette *palett
 
 static bool SW_ChangeTexturePalette(SDL_Renderer *renderer, SDL_Texture *texture)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->internal;
+    SDL_Surface *surface = ((SW_TextureData *)texture->internal)->surface;
     SDL_Palette *surface_palette = NULL;
     if (texture->palette) {
         surface_palette = (SDL_Palette *)texture->palette->internal;
@@ -133,11 +185,33 @@ static bool SW_ChangeTexturePalette(SDL_Renderer *renderer, SDL_Texture *texture
 
 static bool SW_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture, SDL_PropertiesID create_props)
 {
-    SDL_Surface *surface = SDL_CreateSurface(texture->w, texture->h, texture->format);
+    SW_TextureData *texturedata;
+    SDL_Surface *surface;
+
+    texturedata = (SW_TextureData *)SDL_calloc(1, sizeof(*texturedata));
+    if (!texturedata) {
+        return false;
+    }
+    texture->internal = texturedata;
+
+#ifdef SDL_HAVE_YUV
+    if (SDL_ISPIXELFORMAT_FOURCC(texture->format)) {
+        texturedata->yuv = SDL_SW_CreateYUVTexture(texture->format, texture->colorspace, texture->w, texture->h);
+        if (!texturedata->yuv) {
+            return false;
+        }
+        // The RGB copy is only created if the texture is drawn in a way that needs it
+        texturedata->yuv_target_format = renderer->texture_formats[0];
+        texturedata->yuv_dirty = true;
+        return true;
+    }
+#endif
+
+    surface = SDL_CreateSurface(texture->w, texture->h, texture->format);
     if (!surface) {
         return SDL_SetError("Can't create surface");
     }
-    texture->internal = surface;
+    texturedata->surface = surface;
 
     Uint8 r = (Uint8)SDL_roundf(SDL_clamp(texture->color.r, 0.0f, 1.0f) * 255.0f);
     Uint8 g = (Uint8)SDL_roundf(SDL_clamp(texture->color.g, 0.0f, 1.0f) * 255.0f);
@@ -164,11 +238,19 @@ static bool SW_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture, SDL_P
 static bool SW_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture,
                             const SDL_Rect *rect, const void *pixels, int pitch)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->internal;
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
+    SDL_Surface *surface = texturedata->surface;
     Uint8 *src, *dst;
     int row;
     size_t length;
 
+#ifdef SDL_HAVE_YUV
+    if (texturedata->yuv) {
+        texturedata->yuv_dirty = true;
+        return SDL_SW_UpdateYUVTexture(texturedata->yuv, rect, pixels, pitch);
+    }
+#endif
+
     if (SDL_MUSTLOCK(surface)) {
         if (!SDL_LockSurface(surface)) {
             return false;
@@ -190,10 +272,43 @@ static bool SW_UpdateTexture(SDL_Renderer *renderer, SDL_Texture *texture,
     return true;
 }
 
+#ifdef SDL_HAVE_YUV
+static bool SW_UpdateTextureYUV(SDL_Renderer *renderer, SDL_Texture *texture,
+                               const SDL_Rect *rect,
+                               const Uint8 *Yplane, int Ypitch,
+                               const Uint8 *Uplane, int Upitch,
+                               const Uint8 *Vplane, int Vpitch)
+{
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
+
+    texturedata->yuv_dirty = true;
+    return SDL_SW_UpdateYUVTexturePlanar(texturedata->yuv, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
+}
+
+static bool SW_UpdateTextureNV(SDL_Renderer *renderer, SDL_Texture *texture,
+                              const SDL_Rect *rect,
+                              const Uint8 *Yplane, int Ypitch,
+                              const Uint8 *UVplane, int UVpitch)
+{
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
+
+    texturedata->yuv_dirty = true;
+    return SDL_SW_UpdateNVTexturePlanar(texturedata->yuv, rect, Yplane, Ypitch, UVplane, UVpitch);
+}
+#endif // SDL_HAVE_YUV
+
 static bool SW_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture,
                           const SDL_Rect *rect, void **pixels, int *pitch)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->internal;
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
+    SDL_Surface *surface = texturedata->surface;
+
+#ifdef SDL_HAVE_YUV
+    if (texturedata->yuv) {
+        texturedata->yuv_dirty = true;
+        return SDL_SW_LockYUVTexture(texturedata->yuv, rect, pixels, pitch);
+    }
+#endif
 
     *pixels =
         (void *)((Uint8 *)surface->pixels + rect->y * surface->pitch +
@@ -204,6 +319,13 @@ static bool SW_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture,
 
 static void SW_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
+#ifdef SDL_HAVE_YUV
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
+
+    if (texturedata->yuv) {
+        SDL_SW_UnlockYUVTexture(texturedata->yuv);
+    }
+#endif
 }
 
 static bool SW_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
@@ -211,7 +333,7 @@ static bool SW_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
     SW_RenderData *data = (SW_RenderData *)renderer->internal;
 
     if (texture) {
-        data->surface = (SDL_Surface *)texture->internal;
+        data->surface = ((SW_TextureData *)texture->internal)->surface;
     } else {
         data->surface = data->window;
     }
@@ -354,11 +476,10 @@ static bool Blit_to_Screen(SDL_Surface *src, SDL_Rect *srcrect, SDL_Surface *sur
     return result;
 }
 
-static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Texture *texture,
+static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Surface *src,
                             const SDL_Rect *srcrect, const SDL_Rect *final_rect,
                             const double angle, const SDL_FPoint *center, const SDL_FlipMode flip, float scale_x, float scale_y, const SDL_ScaleMode scaleMode)
 {
-    SDL_Surface *src = (SDL_Surface *)texture->internal;
     SDL_Rect tmp_rect;
     SDL_Surface *src_clone, *src_rotated, *src_scaled;
     SDL_Surface *mask = NULL, *mask_rotated = NULL;
@@ -559,19 +680,6 @@ static bool SW_RenderCopyEx(SDL_Renderer *renderer, SDL_Surface *surface, SDL_Te
     return result;
 }
 
-typedef struct GeometryFillData
-{
-    SDL_Point dst;
-    SDL_Color color;
-} GeometryFillData;
-
-typedef struct GeometryCopyData
-{
-    SDL_Point src;
-    SDL_Point dst;
-    SDL_Color color;
-} GeometryCopyData;
-
 static bool SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL_Texture *texture,
                             const float *xy, int xy_stride, const SDL_FColor *color, int color_stride, const float *uv, int uv_stride,
                             int num_vertices, const void *indices, int num_indices, int size_indices,
@@ -662,15 +770,13 @@ static bool SW_QueueGeometry(SDL_Renderer *renderer, SDL_RenderCommand *cmd, SDL
     return true;
 }
 
-static void PrepTextureForCopy(const SDL_RenderCommand *cmd, SW_DrawStateCache *drawstate)
+static void PrepTextureForCopy(const SDL_RenderCommand *cmd, SW_DrawStateCache *drawstate, SDL_Surface *surface)
 {
     const Uint8 r = drawstate->color.r;
     const Uint8 g = drawstate->color.g;
     const Uint8 b = drawstate->color.b;
     const Uint8 a = drawstate->color.a;
     const SDL_BlendMode blend = cmd->data.draw.blend;
-    SDL_Texture *texture = cmd->data.draw.texture;
-    SDL_Surface *surface = (SDL_Surface *)texture->internal;
 
     // !!! FIXME: we can probably avoid some of these calls.
     SDL_SetSurfaceColorMod(surface, r, g, b);
@@ -678,6 +784,50 @@ static void PrepTextureForCopy(const SDL_RenderCommand *cmd, SW_DrawStateCache *
     SDL_SetSurfaceBlendMode(surface, blend);
 }
 
+#ifdef SDL_HAVE_YUV
+static bool SW_CanCopyYUVTexture(const SDL_RenderCommand *cmd, const SW_DrawStateCache *drawstate, SDL_Surface *surface, const SDL_Rect *srcrect, const SDL_Rect *dstrect)
+{
+    SW_TextureData *texturedata = (SW_TextureData *)cmd->data.draw.texture->internal;
+    const SDL_BlendMode blend = cmd->data.draw.blend;
+    SDL_Rect visible;
+
+    /* YUV textures are opaque, so without modulation or an unusual blend mode they're just copied,
+     * and that can be done without converting the parts of the texture that aren't visible.
+     */
+    if (!texturedata->yuv ||
+        drawstate->color.r != 255 || drawstate->color.g != 255 || drawstate->color.b != 255 || drawstate->color.a != 255 ||
+        (blend != SDL_BLENDMODE_NONE && blend != SDL_BLENDMODE_BLEND && blend != SDL_BLENDMODE_BLEND_PREMULTIPLIED) ||
+        SDL_ISPIXELFORMAT_INDEXED(surface->format)) {
+        return false;
+    }
+
+    // When scaling up into a fully visible rectangle the whole texture is needed, so scale the RGB copy instead
+    if (srcrect->w <= dstrect->w && srcrect->h <= dstrect->h &&
+        SDL_GetRectIntersection(dstrect, &surface->clip_rect, &visible) && SDL_RectsEqual(dstrect, &visible) &&
+        !(srcrect->w == dstrect->w && srcrect->h == dstrect->h)) {
+        return false;
+    }
+    return true;
+}
+
+static bool SW_CopyYUVTexture(const SDL_RenderCommand *cmd, SDL_Surface *surface, const SDL_Rect *srcrect, const SDL_Rect *dstrect)
+{
+    SW_TextureData *texturedata = (SW_TextureData *)cmd->data.draw.texture->internal;
+    bool result;
+
+    if (SDL_MUSTLOCK(surface)) {
+        if (!SDL_LockSurface(surface)) {
+            return false;
+        }
+    }
+    result = SDL_SW_BlitYUVToRGB(texturedata->yuv, srcrect, surface, dstrect, cmd->data.draw.texture_scale_mode);
+    if (SDL_MUSTLOCK(surface)) {
+        SDL_UnlockSurface(surface);
+    }
+    return result;
+}
+#endif // SDL_HAVE_YUV
+
 static void SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
 {
     if (drawstate->surface_cliprect_dirty) {
@@ -700,6 +850,41 @@ static void SetDrawState(SDL_Surface *surface, SW_DrawStateCache *drawstate)
     }
 }
 
+// Marks rect as drawn to, or the whole clip rect if rect is NULL. Call this after SetDrawState().
+static void AddDirtyRect(SW_RenderData *data, SDL_Surface *surface, const SDL_Rect *rect)
+{
+    SDL_Rect dirty;
+    int i;
+
+    if (surface != data->window || data->dirty_all) {
+        return;
+    }
+
+    if (!rect) {
+        dirty = surface->clip_rect;
+    } else if (!SDL_GetRectIntersection(rect, &surface->clip_rect, &dirty)) {
+        return;
+    }
+
+    // Grow a rect this overlaps, so those pixels aren't sent twice
+    for (i = 0; i < data->num_dirty_rects; ++i) {
+        if (SDL_HasRectIntersection(&dirty, &data->dirty_rects[i])) {
+            SDL_GetRectUnion(&dirty, &data->dirty_rects[i], &data->dirty_rects[i]);
+            return;
+        }
+    }
+
+    if (data->num_dirty_rects == SW_MAX_DIRTY_RECTS) {
+        for (i = 1; i < data->num_dirty_rects; ++i) {
+            SDL_GetRectUnion(&data->dirty_rects[0], &data->dirty_rects[i], &data->dirty_rects[0]);
+        }
+        SDL_GetRectUnion(&data->dirty_rects[0], &dirty, &data->dirty_rects[0]);
+        data->num_dirty_rects = 1;
+        return;
+    }
+    data->dirty_rects[data->num_dirty_rects++] = dirty;
+}
+
 static void SW_InvalidateCachedState(SDL_Renderer *renderer)
 {
     // SW_DrawStateCache only lives during SW_RunCommandQueue, so nothing to do here!
@@ -708,6 +893,7 @@ static void SW_InvalidateCachedState(SDL_Renderer *renderer)
 
 static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, void *vertices, size_t vertsize)
 {
+    SW_RenderData *data = (SW_RenderData *)renderer->internal;
     SDL_Surface *surface = SW_ActivateRenderer(renderer);
     SW_DrawStateCache drawstate;
 
@@ -758,6 +944,9 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
             SDL_SetSurfaceClipRect(surface, NULL);
             SDL_FillSurfaceRect(surface, NULL, SDL_MapSurfaceRGBA(surface, r, g, b, a));
             drawstate.surface_cliprect_dirty = true;
+            if (surface == data->window) {
+                data->dirty_all = true;
+            }
             break;
         }
 
@@ -770,6 +959,7 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
             const int count = (int)cmd->data.draw.count;
             SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
             const SDL_BlendMode blend = cmd->data.draw.blend;
+            SDL_Rect bounds;
             SetDrawState(surface, &drawstate);
 
             // Apply viewport
@@ -781,6 +971,10 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
                 }
             }
 
+            if (SDL_GetRectEnclosingPoints(verts, count, NULL, &bounds)) {
+                AddDirtyRect(data, surface, &bounds);
+            }
+
             if (blend == SDL_BLENDMODE_NONE) {
                 SDL_DrawPoints(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
             } else {
@@ -798,6 +992,7 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
             const int count = (int)cmd->data.draw.count;
             SDL_Point *verts = (SDL_Point *)(((Uint8 *)vertices) + cmd->data.draw.first);
             const SDL_BlendMode blend = cmd->data.draw.blend;
+            SDL_Rect bounds;
             SetDrawState(surface, &drawstate);
 
             // Apply viewport
@@ -809,6 +1004,10 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
                 }
             }
 
+            if (SDL_GetRectEnclosingPoints(verts, count, NULL, &bounds)) {
+                AddDirtyRect(data, surface, &bounds);
+            }
+
             if (blend == SDL_BLENDMODE_NONE) {
                 SDL_DrawLines(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
             } else {
@@ -826,17 +1025,21 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
             const int count = (int)cmd->data.draw.count;
             SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
             const SDL_BlendMode blend = cmd->data.draw.blend;
+            int i;
             SetDrawState(surface, &drawstate);
 
             // Apply viewport
             if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                int i;
                 for (i = 0; i < count; i++) {
                     verts[i].x += drawstate.viewport->x;
                     verts[i].y += drawstate.viewport->y;
                 }
             }
 
+            for (i = 0; i < count; i++) {
+                AddDirtyRect(data, surface, &verts[i]);
+            }
+
             if (blend == SDL_BLENDMODE_NONE) {
                 SDL_FillSurfaceRects(surface, verts, count, SDL_MapSurfaceRGBA(surface, r, g, b, a));
             } else {
@@ -848,58 +1051,82 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
         case SDL_RENDERCMD_COPY:
         {
             SDL_Rect *verts = (SDL_Rect *)(((Uint8 *)vertices) + cmd->data.draw.first);
-            const SDL_Rect *srcrect = verts;
-            SDL_Rect *dstrect = verts + 1;
+            const size_t count = cmd->data.draw.count;
             SDL_Texture *texture = cmd->data.draw.texture;
-            SDL_Surface *src = (SDL_Surface *)texture->internal;
+            SDL_Surface *src = NULL;
+            size_t i;
 
             SetDrawState(surface, &drawstate);
 
-            PrepTextureForCopy(cmd, &drawstate);
+            // Merged copies share their texture and state, so that's only set up once
+            for (i = 0; i < count; i++, verts += 2) {
+                const SDL_Rect *srcrect = verts;
+                SDL_Rect *dstrect = verts + 1;
 
-            // Apply viewport
-            if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
-                dstrect->x += drawstate.viewport->x;
-                dstrect->y += drawstate.viewport->y;
-            }
+                // Apply viewport
+                if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
+                    dstrect->x += drawstate.viewport->x;
+                    dstrect->y += drawstate.viewport->y;
+                }
+                AddDirtyRect(data, surface, dstrect);
 
-            if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
-                SDL_BlitSurface(src, srcrect, surface, dstrect);
-            } else {
-                // Prevent to do scaling + clipping on viewport boundaries as it may lose proportion
-                if (dstrect->x < 0 || dstrect->y < 0 || dstrect->x + dstrect->w > surface->w || dstrect->y + dstrect->h > surface->h) {
-                    SDL_Surface *tmp = SDL_CreateSurface(dstrect->w, dstrect->h, surface->format);
-                    // Scale to an intermediate surface, then blit
-                    if (tmp) {
-                        SDL_Rect r;
-                        SDL_BlendMode blendmode;
-                        Uint8 alphaMod, rMod, gMod, bMod;
-
-                        SDL_GetSurfaceBlendMode(src, &blendmode);
-                        SDL_GetSurfaceAlphaMod(src, &alphaMod);
-                        SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
-
-                        r.x = 0;
-                        r.y = 0;
-                        r.w = dstrect->w;
-                        r.h = dstrect->h;
-
-                        SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
-                        SDL_SetSurfaceColorMod(src, 255, 255, 255);
-                        SDL_SetSurfaceAlphaMod(src, 255);
-
-                        SDL_BlitSurfaceScaled(src, srcrect, tmp, &r, cmd->data.draw.texture_scale_mode);
-
-                        SDL_SetSurfaceColorMod(tmp, rMod, gMod, bMod);
-                        SDL_SetSurfaceAlphaMod(tmp, alphaMod);
-                        SDL_SetSurfaceBlendMode(tmp, blendmode);
-
-                        SDL_BlitSurface(tmp, NULL, surface, dstrect);
-                        SDL_DestroySurface(tmp);
-                        // No need to set back r/g/b/a/blendmode to 'src' since it's done in PrepTextureForCopy()
+#ifdef SDL_HAVE_YUV
+                if (SW_CanCopyYUVTexture(cmd, &drawstate, surface, srcrect, dstrect)) {
+                    SW_CopyYUVTexture(cmd, surface, srcrect, dstrect);
+                    continue;
+                }
+#endif
+
+                if (!src) {
+                    src = SW_GetTextureSurface(texture);
+                    if (!src) {
+                        break;
                     }
+                    PrepTextureForCopy(cmd, &drawstate, src);
+                }
+
+                if (srcrect->w == dstrect->w && srcrect->h == dstrect->h) {
+                    SDL_BlitSurface(src, srcrect, surface, dstrect);
                 } else {
-                    SDL_BlitSurfaceScaled(src, srcrect, surface, dstrect, cmd->data.draw.texture_scale_mode);
+                    // Prevent to do scaling + clipping on viewport boundaries as it may lose proportion
+                    if (dstrect->x < 0 || dstrect->y < 0 || dstrect->x + dstrect->w > surface->w || dstrect->y + dstrect->h > surface->h) {
+                        SDL_Surface *tmp = SDL_CreateSurface(dstrect->w, dstrect->h, surface->format);
+                        // Scale to an intermediate surface, then blit
+                        if (tmp) {
+                            SDL_Rect r;
+                            SDL_BlendMode blendmode;
+                            Uint8 alphaMod, rMod, gMod, bMod;
+
+                            SDL_GetSurfaceBlendMode(src, &blendmode);
+                            SDL_GetSurfaceAlphaMod(src, &alphaMod);
+                            SDL_GetSurfaceColorMod(src, &rMod, &gMod, &bMod);
+
+                            r.x = 0;
+                            r.y = 0;
+                            r.w = dstrect->w;
+                            r.h = dstrect->h;
+
+                            SDL_SetSurfaceBlendMode(src, SDL_BLENDMODE_NONE);
+                            SDL_SetSurfaceColorMod(src, 255, 255, 255);
+                            SDL_SetSurfaceAlphaMod(src, 255);
+
+                            SDL_BlitSurfaceScaled(src, srcrect, tmp, &r, cmd->data.draw.texture_scale_mode);
+
+                            SDL_SetSurfaceColorMod(tmp, rMod, gMod, bMod);
+                            SDL_SetSurfaceAlphaMod(tmp, alphaMod);
+                            SDL_SetSurfaceBlendMode(tmp, blendmode);
+
+                            SDL_BlitSurface(tmp, NULL, surface, dstrect);
+                            SDL_DestroySurface(tmp);
+
+                            // Restore the texture state for the copies that follow
+                            SDL_SetSurfaceColorMod(src, rMod, gMod, bMod);
+                            SDL_SetSurfaceAlphaMod(src, alphaMod);
+                            SDL_SetSurfaceBlendMode(src, blendmode);
+                        }
+                    } else {
+                        SDL_BlitSurfaceScaled(src, srcrect, surface, dstrect, cmd->data.draw.texture_scale_mode);
+                    }
                 }
             }
             break;
@@ -908,8 +1135,12 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
         case SDL_RENDERCMD_COPY_EX:
         {
             CopyExData *copydata = (CopyExData *)(((Uint8 *)vertices) + cmd->data.draw.first);
+            SDL_Surface *src = SW_GetTextureSurface(cmd->data.draw.texture);
+            if (!src) {
+                break;
+            }
             SetDrawState(surface, &drawstate);
-            PrepTextureForCopy(cmd, &drawstate);
+            PrepTextureForCopy(cmd, &drawstate, src);
 
             // Apply viewport
             if (drawstate.viewport &&
@@ -919,7 +1150,10 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
                 copydata->dstrect.y += (int)(drawstate.viewport->y / copydata->scale_y);
             }
 
-            SW_RenderCopyEx(renderer, surface, cmd->data.draw.texture, &copydata->srcrect,
+            // Rotated copies can land anywhere in the clip rect
+            AddDirtyRect(data, surface, NULL);
+
+            SW_RenderCopyEx(renderer, surface, src, &copydata->srcrect,
                             &copydata->dstrect, copydata->angle, &copydata->center, copydata->flip,
                             copydata->scale_x, copydata->scale_y, cmd->data.draw.texture_scale_mode);
             break;
@@ -932,15 +1166,20 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
             const int count = (int)cmd->data.draw.count;
             SDL_Texture *texture = cmd->data.draw.texture;
             const SDL_BlendMode blend = cmd->data.draw.blend;
+            SDL_Rect bounds;
 
             SetDrawState(surface, &drawstate);
 
             if (texture) {
-                SDL_Surface *src = (SDL_Surface *)texture->internal;
+                SDL_Surface *src = SW_GetTextureSurface(texture);
 
                 GeometryCopyData *ptr = (GeometryCopyData *)verts;
 
-                PrepTextureForCopy(cmd, &drawstate);
+                if (!src) {
+                    break;
+                }
+
+                PrepTextureForCopy(cmd, &drawstate, src);
 
                 // Apply viewport
                 if (drawstate.viewport && (drawstate.viewport->x || drawstate.viewport->y)) {
@@ -954,16 +1193,12 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
                     }
                 }
 
-                for (i = 0; i < count; i += 3, ptr += 3) {
-                    SDL_SW_BlitTriangle(
-                        src,
-                        &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
-                        surface,
-                        &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst),
-                        ptr[0].color, ptr[1].color, ptr[2].color,
-                        cmd->data.draw.texture_address_mode_u,
-                        cmd->data.draw.texture_address_mode_v);
-                }
+                SDL_SW_GetTrianglesBounds(&ptr->dst, sizeof(*ptr), count, &bounds);
+                AddDirtyRect(data, surface, &bounds);
+
+                SDL_SW_BlitTriangles(src, surface, ptr, count,
+                                     cmd->data.draw.texture_address_mode_u,
+                                     cmd->data.draw.texture_address_mode_v);
             } else {
                 GeometryFillData *ptr = (GeometryFillData *)verts;
 
@@ -979,9 +1214,10 @@ static bool SW_RunCommandQueue(SDL_Renderer *renderer, SDL_RenderCommand *cmd, v
                     }
                 }
 
-                for (i = 0; i < count; i += 3, ptr += 3) {
-                    SDL_SW_FillTriangle(surface, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), blend, ptr[0].color, ptr[1].color, ptr[2].color);
-                }
+                SDL_SW_GetTrianglesBounds(&ptr->dst, sizeof(*ptr), count, &bounds);
+                AddDirtyRect(data, surface, &bounds);
+
+                SDL_SW_FillTriangles(surface, ptr, count, blend);
             }
             break;
         }
@@ -1024,19 +1260,50 @@ static SDL_Surface *SW_RenderReadPixels(SDL_Renderer *renderer, const SDL_Rect *
 
 static bool SW_RenderPresent(SDL_Renderer *renderer)
 {
+    SW_RenderData *data = (SW_RenderData *)renderer->internal;
     SDL_Window *window = renderer->window;
+    Uint64 pixels = 0;
+    bool result = true;
+    int i;
 
     if (!window) {
         return false;
     }
-    return SDL_UpdateWindowSurface(window);
+
+    if (data->dirty_all || !data->window) {
+        int w = 0, h = 0;
+
+        SDL_GetWindowSizeInPixels(window, &w, &h);
+        pixels = (Uint64)w * h;
+        result = SDL_UpdateWindowSurface(window);
+    } else if (data->num_dirty_rects > 0) {
+        for (i = 0; i < data->num_dirty_rects; ++i) {
+            pixels += (Uint64)data->dirty_rects[i].w * data->dirty_rects[i].h;
+        }
+        result = SDL_UpdateWindowSurfaceRects(window, data->dirty_rects, data->num_dirty_rects);
+    }
+    renderer->frame_stats.present_pixels += pixels;
+
+    data->num_dirty_rects = 0;
+    data->dirty_all = false;
+    return result;
 }
 
 static void SW_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
-    SDL_Surface *surface = (SDL_Surface *)texture->internal;
+    SW_TextureData *texturedata = (SW_TextureData *)texture->internal;
 
-    SDL_DestroySurface(surface);
+    if (!texturedata) {
+        return;
+    }
+    SDL_DestroySurface(texturedata->surface);
+#ifdef SDL_HAVE_YUV
+    if (texturedata->yuv) {
+        SDL_SW_DestroyYUVTexture(texturedata->yuv);
+    }
+#endif
+    SDL_free(texturedata);
+    texture->internal = NULL;
 }
 
 static void SW_DestroyRenderer(SDL_Renderer *renderer)
@@ -1146,6 +1413,17 @@ static void SW_SelectBestFormats(SDL_Renderer *renderer, SDL_PixelFormat format)
 
     // Add 8-bit palettized format
     SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_INDEX8);
+
+#ifdef SDL_HAVE_YUV
+    // YUV textures are converted as they're drawn
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_YV12);
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_IYUV);
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_NV12);
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_NV21);
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_YUY2);
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_UYVY);
+    SDL_AddSupportedTextureFormat(renderer, SDL_PIXELFORMAT_YVYU);
+#endif
 }
 
 bool SW_CreateRendererForSurface(SDL_Renderer *renderer, SDL_Surface *surface, SDL_PropertiesID create_props)
@@ -1175,6 +1453,7 @@ bool SW_CreateRendererForSurface(SDL_Renderer *renderer, SDL_Surface *surface, S
     }
     data->surface = surface;
     data->window = surface;
+    data->dirty_all = true;
 
     renderer->WindowEvent = SW_WindowEvent;
     renderer->GetOutputSize = SW_GetOutputSize;
@@ -1184,6 +1463,10 @@ bool SW_CreateRendererForSurface(SDL_Renderer *renderer, SDL_Surface *surface, S
     renderer->ChangeTexturePalette = SW_ChangeTexturePalette;
     renderer->CreateTexture = SW_CreateTexture;
     renderer->UpdateTexture = SW_UpdateTexture;
+#ifdef SDL_HAVE_YUV
+    renderer->UpdateTextureYUV = SW_UpdateTextureYUV;
+    renderer->UpdateTextureNV = SW_UpdateTextureNV;
+#endif
     renderer->LockTexture = SW_LockTexture;
     renderer->UnlockTexture = SW_UnlockTexture;
     renderer->SetRenderTarget = SW_SetRenderTarget;
@@ -1194,6 +1477,7 @@ bool SW_CreateRendererForSurface(SDL_Renderer *renderer, SDL_Surface *surface, S
     renderer->QueueFillRects = SW_QueueFillRects;
     renderer->QueueCopy = SW_QueueCopy;
     renderer->QueueCopyEx = SW_QueueCopyEx;
+    renderer->merge_copy_commands = true;
     renderer->QueueGeometry = SW_QueueGeometry;
     renderer->InvalidateCachedState = SW_InvalidateCachedState;
     renderer->RunCommandQueue = SW_RunCommandQueue;
@@ -25,8 +25,11 @@
 #include <limits.h>
 
 #include "SDL_triangle.h"
+#include "SDL_blendfillrect.h"
+#include "SDL_draw.h"
 
 #include "../../video/SDL_surface_c.h"
+#include "../../thread/SDL_parallel_c.h"
 
 /* fixed points bits precision
  * Set to 1, so that it can start rendering with middle of a pixel precision.
@@ -38,14 +41,6 @@
 
 #define COLOR_EQ(c1, c2) ((c1).r == (c2).r && (c1).g == (c2).g && (c1).b == (c2).b && (c1).a == (c2).a)
 
-static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
-                                  SDL_Point s2_x_area, SDL_Rect dstrect, int area, int bias_w0, int bias_w1, int bias_w2,
-                                  int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x,
-                                  int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y, int w0_row, int w1_row, int w2_row,
-                                  SDL_Color c0, SDL_Color c1, SDL_Color c2, bool is_uniform,
-                                  SDL_TextureAddressMode texture_address_mode_u,
-                                  SDL_TextureAddressMode texture_address_mode_v);
-
 #if 0
 bool SDL_BlitTriangle(SDL_Surface *src, const SDL_Point srcpoints[3], SDL_Surface *dst, const SDL_Point dstpoints[3])
 {
@@ -135,6 +130,33 @@ void trianglepoint_2_fixedpoint(SDL_Point *a)
     PRECOMP(a->y, a->y);
 }
 
+void SDL_SW_GetTrianglesBounds(const SDL_Point *verts, size_t stride, int count, SDL_Rect *rect)
+{
+    const Uint8 *ptr = (const Uint8 *)verts;
+    int min_x = SDL_MAX_SINT32, min_y = SDL_MAX_SINT32;
+    int max_x = SDL_MIN_SINT32, max_y = SDL_MIN_SINT32;
+    int i;
+
+    if (count <= 0) {
+        SDL_zerop(rect);
+        return;
+    }
+
+    for (i = 0; i < count; ++i, ptr += stride) {
+        const SDL_Point *p = (const SDL_Point *)ptr;
+        min_x = SDL_min(min_x, p->x);
+        max_x = SDL_max(max_x, p->x);
+        min_y = SDL_min(min_y, p->y);
+        max_y = SDL_max(max_y, p->y);
+    }
+
+    // points are in fixed point, shift back and include the last pixel
+    rect->x = min_x >> FP_BITS;
+    rect->y = min_y >> FP_BITS;
+    rect->w = (max_x >> FP_BITS) - rect->x + 1;
+    rect->h = (max_y >> FP_BITS) - rect->y + 1;
+}
+
 // bounding rect of three points (in fixed point)
 static void bounding_rect_fixedpoint(const SDL_Point *a, const SDL_Point *b, const SDL_Point *c, SDL_Rect *r)
 {
@@ -151,223 +173,491 @@ static void bounding_rect_fixedpoint(const SDL_Point *a, const SDL_Point *b, con
 
 /* Triangle rendering, using Barycentric coordinates (w0, w1, w2)
  *
- * The cross product isn't computed from scratch at each iteration,
- * but optimized using constant step increments
- *
+ * The edge functions are linear in x, so instead of testing them at every
+ * pixel, each row solves them for the span of pixels inside the triangle.
+ * Colors and texture coordinates are divided once per span and then stepped
+ * across it, giving the same results as dividing at every pixel.
  */
 
-#define TRIANGLE_BEGIN_LOOP                                                        \
-    {                                                                              \
-        int x, y;                                                                  \
-        for (y = 0; y < dstrect.h; y++) {                                          \
-            /* y start */                                                          \
-            Sint64 w0 = w0_row;                                                    \
-            Sint64 w1 = w1_row;                                                    \
-            Sint64 w2 = w2_row;                                                    \
-            for (x = 0; x < dstrect.w; x++) {                                      \
-                /* In triangle */                                                  \
-                if (w0 + bias_w0 >= 0 && w1 + bias_w1 >= 0 && w2 + bias_w2 >= 0) { \
-                    Uint8 *dptr = (Uint8 *)dst_ptr + x * dstbpp;
-
-// Use 64 bits precision to prevent overflow when interpolating color / texture with wide triangles
-#define TRIANGLE_GET_TEXTCOORD                                                          \
-    int srcx = (int)(((Sint64)w0 * s2s0_x + (Sint64)w1 * s2s1_x + s2_x_area.x) / area); \
-    int srcy = (int)(((Sint64)w0 * s2s0_y + (Sint64)w1 * s2s1_y + s2_x_area.y) / area); \
-    if (texture_address_mode_u == SDL_TEXTURE_ADDRESS_CLAMP) {                          \
-        if (srcx < 0) {                                                                 \
-            srcx = 0;                                                                   \
-        } else if (srcx >= src_surface->w) {                                            \
-            srcx = src_surface->w - 1;                                                  \
-        }                                                                               \
-    } else if (texture_address_mode_u == SDL_TEXTURE_ADDRESS_WRAP) {                    \
-        srcx %= src_surface->w;                                                         \
-        if (srcx < 0) {                                                                 \
-            srcx += (src_surface->w - 1);                                               \
-        }                                                                               \
-    }                                                                                   \
-    if (texture_address_mode_v == SDL_TEXTURE_ADDRESS_CLAMP) {                          \
-        if (srcy < 0) {                                                                 \
-            srcy = 0;                                                                   \
-        } else if (srcy >= src_surface->h) {                                            \
-            srcy = src_surface->h - 1;                                                  \
-        }                                                                               \
-    } else if (texture_address_mode_v == SDL_TEXTURE_ADDRESS_WRAP) {                    \
-        srcy %= src_surface->h;                                                         \
-        if (srcy < 0) {                                                                 \
-            srcy += (src_surface->h - 1);                                               \
-        }                                                                               \
-    }
-
-#define TRIANGLE_GET_MAPPED_COLOR                                                      \
-    Uint8 r = (Uint8)(((Sint64)w0 * c0.r + (Sint64)w1 * c1.r + (Sint64)w2 * c2.r) / area); \
-    Uint8 g = (Uint8)(((Sint64)w0 * c0.g + (Sint64)w1 * c1.g + (Sint64)w2 * c2.g) / area); \
-    Uint8 b = (Uint8)(((Sint64)w0 * c0.b + (Sint64)w1 * c1.b + (Sint64)w2 * c2.b) / area); \
-    Uint8 a = (Uint8)(((Sint64)w0 * c0.a + (Sint64)w1 * c1.a + (Sint64)w2 * c2.a) / area); \
-    Uint32 color = SDL_MapRGBA(format, palette, r, g, b, a);
-
-#define TRIANGLE_GET_COLOR                                                             \
-    int r = (int)(((Sint64)w0 * c0.r + (Sint64)w1 * c1.r + (Sint64)w2 * c2.r) / area); \
-    int g = (int)(((Sint64)w0 * c0.g + (Sint64)w1 * c1.g + (Sint64)w2 * c2.g) / area); \
-    int b = (int)(((Sint64)w0 * c0.b + (Sint64)w1 * c1.b + (Sint64)w2 * c2.b) / area); \
-    int a = (int)(((Sint64)w0 * c0.a + (Sint64)w1 * c1.a + (Sint64)w2 * c2.a) / area);
-
-#define TRIANGLE_END_LOOP \
-    }                     \
-    /* x += 1 */          \
-    w0 += d2d1_y;         \
-    w1 += d0d2_y;         \
-    w2 += d1d0_y;         \
-    }                     \
-    /* y += 1 */          \
-    w0_row += d1d2_x;     \
-    w1_row += d2d0_x;     \
-    w2_row += d0d1_x;     \
-    dst_ptr += dst_pitch; \
-    }                     \
-    }
-
-bool SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Point *d2, SDL_BlendMode blend, SDL_Color c0, SDL_Color c1, SDL_Color c2)
+typedef struct TriangleRaster
 {
-    bool result = true;
-    int dst_locked = 0;
-
-    SDL_Rect dstrect;
-
-    int dstbpp;
-    Uint8 *dst_ptr;
-    int dst_pitch;
+    SDL_Rect dstrect; // Clipped bounding rect
+    Sint64 area;      // Always positive
+    Sint64 w_row[3];  // Edge functions at the middle of the first pixel of the current row
+    int step_x[3];    // Edge function increments for x += 1
+    int step_y[3];    // Edge function increments for y += 1
+    int bias[3];      // Bias to respect the top-left rasterization rule
+} TriangleRaster;
+
+/* An interpolated value (numerator + x * step) / area, rounded toward zero.
+ * The quotient is kept floored, with 0 <= rem < area, so stepping is exact.
+ */
+typedef struct TriangleInterp
+{
+    Sint64 quot;
+    Sint64 rem;
+    Sint64 step_quot;
+    Sint64 step_rem;
+} TriangleInterp;
+
+static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info, TriangleRaster *t, SDL_Point s2_x_area,
+                                  int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y,
+                                  SDL_Color c0, SDL_Color c1, SDL_Color c2, bool is_uniform,
+                                  SDL_TextureAddressMode texture_address_mode_u,
+                                  SDL_TextureAddressMode texture_address_mode_v);
 
+static bool SetupTriangle(const SDL_Point *d0, const SDL_Point *d1, const SDL_Point *d2, const SDL_Rect *cliprect, TriangleRaster *t)
+{
     Sint64 area;
     int is_clockwise;
+    int val, i;
 
-    int d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x;
-    Sint64 w0_row, w1_row, w2_row;
-    int bias_w0, bias_w1, bias_w2;
+    area = cross_product(d0, d1, d2->x, d2->y);
 
-    bool is_uniform;
+    // Flat triangle
+    if (area == 0) {
+        return false;
+    }
 
-    SDL_Surface *tmp = NULL;
+    bounding_rect_fixedpoint(d0, d1, d2, &t->dstrect);
 
-    if (!SDL_SurfaceValid(dst)) {
+    // Clip triangle rect with the clip rect
+    if (!SDL_GetRectIntersection(&t->dstrect, cliprect, &t->dstrect)) {
         return false;
     }
 
-    area = cross_product(d0, d1, d2->x, d2->y);
+    is_clockwise = area > 0;
+    t->area = is_clockwise ? area : -area;
 
-    is_uniform = COLOR_EQ(c0, c1) && COLOR_EQ(c1, c2);
+    PRECOMP(t->step_x[0], d1->y - d2->y)
+    PRECOMP(t->step_x[1], d2->y - d0->y)
+    PRECOMP(t->step_x[2], d0->y - d1->y)
+    PRECOMP(t->step_y[0], d2->x - d1->x)
+    PRECOMP(t->step_y[1], d0->x - d2->x)
+    PRECOMP(t->step_y[2], d1->x - d0->x)
 
-    // Flat triangle
-    if (area == 0) {
-        return true;
+    // Starting point for rendering, at the middle of a pixel
+    {
+        SDL_Point p;
+        p.x = t->dstrect.x;
+        p.y = t->dstrect.y;
+        trianglepoint_2_fixedpoint(&p);
+        p.x += (1 << FP_BITS) / 2;
+        p.y += (1 << FP_BITS) / 2;
+        t->w_row[0] = cross_product(d1, d2, p.x, p.y);
+        t->w_row[1] = cross_product(d2, d0, p.x, p.y);
+        t->w_row[2] = cross_product(d0, d1, p.x, p.y);
     }
 
-    // Lock the destination, if needed
-    if (SDL_MUSTLOCK(dst)) {
-        if (!SDL_LockSurface(dst)) {
-            result = false;
-            goto end;
-        } else {
-            dst_locked = 1;
+    // Handle anti-clockwise triangles
+    if (!is_clockwise) {
+        for (i = 0; i < 3; i++) {
+            t->step_x[i] *= -1;
+            t->step_y[i] *= -1;
+            t->w_row[i] *= -1;
         }
     }
 
-    bounding_rect_fixedpoint(d0, d1, d2, &dstrect);
+    // Add a bias to respect top-left rasterization rule
+    t->bias[0] = (is_top_left(d1, d2, is_clockwise) ? 0 : -1);
+    t->bias[1] = (is_top_left(d2, d0, is_clockwise) ? 0 : -1);
+    t->bias[2] = (is_top_left(d0, d1, is_clockwise) ? 0 : -1);
+    return true;
+}
 
-    {
-        // Clip triangle rect with surface rect
-        SDL_Rect rect;
-        rect.x = 0;
-        rect.y = 0;
-        rect.w = dst->w;
-        rect.h = dst->h;
-        SDL_GetRectIntersection(&dstrect, &rect, &dstrect);
+// Get the pixels [*start, *end) of the current row that are inside the triangle
+static void GetTriangleSpan(const TriangleRaster *t, int *start, int *end)
+{
+    Sint64 x0 = 0;
+    Sint64 x1 = t->dstrect.w;
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        // Solve w_row + x * step_x + bias >= 0
+        const Sint64 w = t->w_row[i] + t->bias[i];
+        const Sint64 step = t->step_x[i];
+
+        if (step > 0) {
+            if (w < 0) {
+                x0 = SDL_max(x0, (-w + step - 1) / step);
+            }
+        } else if (step < 0) {
+            if (w < 0) {
+                x1 = 0;
+            } else {
+                x1 = SDL_min(x1, w / -step + 1);
+            }
+        } else if (w < 0) {
+            x1 = 0;
+        }
     }
 
-    {
-        // Clip triangle with surface clip rect
-        SDL_Rect rect;
-        SDL_GetSurfaceClipRect(dst, &rect);
-        SDL_GetRectIntersection(&dstrect, &rect, &dstrect);
+    if (x0 < x1) {
+        *start = (int)x0;
+        *end = (int)x1;
+    } else {
+        *start = 0;
+        *end = 0;
     }
+}
 
-    if (blend != SDL_BLENDMODE_NONE) {
-        SDL_PixelFormat format = dst->format;
+static void NextTriangleRow(TriangleRaster *t)
+{
+    t->w_row[0] += t->step_y[0];
+    t->w_row[1] += t->step_y[1];
+    t->w_row[2] += t->step_y[2];
+}
 
-        // need an alpha format
-        if (!SDL_ISPIXELFORMAT_ALPHA(format)) {
-            format = SDL_PIXELFORMAT_ARGB8888;
+static void FloorDivide(Sint64 numerator, Sint64 area, Sint64 *quot, Sint64 *rem)
+{
+    *quot = numerator / area;
+    *rem = numerator % area;
+    if (*rem < 0) {
+        *rem += area;
+        *quot -= 1;
+    }
+}
+
+/* Interpolate w0 * k0 + w1 * k1 + w2 * k2 + k, from pixel x of the current row,
+ * stepping either along the row or down to the next rows
+ */
+static void SetupTriangleInterp(TriangleInterp *it, const TriangleRaster *t, int x, int k0, int k1, int k2, Sint64 k, bool down)
+{
+    const int *step = down ? t->step_y : t->step_x;
+    Sint64 numerator = k;
+
+    numerator += (t->w_row[0] + (Sint64)x * t->step_x[0]) * k0;
+    numerator += (t->w_row[1] + (Sint64)x * t->step_x[1]) * k1;
+    numerator += (t->w_row[2] + (Sint64)x * t->step_x[2]) * k2;
+    FloorDivide(numerator, t->area, &it->quot, &it->rem);
+    FloorDivide((Sint64)step[0] * k0 + (Sint64)step[1] * k1 + (Sint64)step[2] * k2, t->area, &it->step_quot, &it->step_rem);
+}
+
+static SDL_INLINE int GetTriangleInterp(const TriangleInterp *it)
+{
+    return (int)(it->quot + (it->quot < 0 && it->rem != 0));
+}
+
+static SDL_INLINE void StepTriangleInterp(TriangleInterp *it, Sint64 area)
+{
+    // The carry comes at irregular intervals, so avoid branching on it
+    const Sint64 rem = it->rem + it->step_rem - area;
+    const Sint64 carry = (rem >= 0);
+    it->quot += it->step_quot + carry;
+    it->rem = rem + (area & (carry - 1));
+}
+
+static SDL_INLINE int GetTextureCoord(int coord, int size, SDL_TextureAddressMode texture_address_mode)
+{
+    if (texture_address_mode == SDL_TEXTURE_ADDRESS_CLAMP) {
+        if (coord < 0) {
+            coord = 0;
+        } else if (coord >= size) {
+            coord = size - 1;
+        }
+    } else if (texture_address_mode == SDL_TEXTURE_ADDRESS_WRAP) {
+        coord %= size;
+        if (coord < 0) {
+            coord += (size - 1);
         }
+    }
+    return coord;
+}
 
-        // Use an intermediate surface
-        tmp = SDL_CreateSurface(dstrect.w, dstrect.h, format);
-        if (!tmp) {
-            result = false;
-            goto end;
+static SDL_INLINE void WriteTrianglePixel(Uint8 *dptr, int dstbpp, Uint32 color)
+{
+    if (dstbpp == 4) {
+        *(Uint32 *)dptr = color;
+    } else if (dstbpp == 3) {
+        Uint8 *s = (Uint8 *)&color;
+        dptr[0] = s[0];
+        dptr[1] = s[1];
+        dptr[2] = s[2];
+    } else if (dstbpp == 2) {
+        *(Uint16 *)dptr = (Uint16)color;
+    } else {
+        *dptr = (Uint8)color;
+    }
+}
+
+static void FillTriangleSpan(Uint8 *dst_row, int dstbpp, int x, int x_end, Uint32 color)
+{
+    if (dstbpp == 4) {
+        SDL_memset4(dst_row + x * 4, color, x_end - x);
+    } else if (dstbpp == 1) {
+        SDL_memset(dst_row + x, (Uint8)color, x_end - x);
+    } else {
+        for (; x < x_end; x++) {
+            WriteTrianglePixel(dst_row + x * dstbpp, dstbpp, color);
+        }
+    }
+}
+
+// Whether colors can be mapped like SDL_MapRGBA() does, without a function call per pixel
+static bool CanMapTriangleColor(const SDL_PixelFormatDetails *format)
+{
+    return !SDL_ISPIXELFORMAT_INDEXED(format->format) && !SDL_ISPIXELFORMAT_10BIT(format->format);
+}
+
+/* The shifts for mapping colors, copied out of the format so they stay in
+ * registers while writing pixels
+ */
+typedef struct TriangleColorMap
+{
+    int Rloss, Gloss, Bloss, Aloss;
+    int Rshift, Gshift, Bshift, Ashift;
+    Uint32 Amask;
+} TriangleColorMap;
+
+static void GetTriangleColorMap(const SDL_PixelFormatDetails *format, TriangleColorMap *map)
+{
+    map->Rloss = 8 - format->Rbits;
+    map->Gloss = 8 - format->Gbits;
+    map->Bloss = 8 - format->Bbits;
+    map->Aloss = 8 - format->Abits;
+    map->Rshift = format->Rshift;
+    map->Gshift = format->Gshift;
+    map->Bshift = format->Bshift;
+    map->Ashift = format->Ashift;
+    map->Amask = format->Amask;
+}
+
+#define MAP_TRIANGLE_COLOR(map, r, g, b, a)                 \
+    (((Uint32)((r) >> (map).Rloss) << (map).Rshift) |       \
+     ((Uint32)((g) >> (map).Gloss) << (map).Gshift) |       \
+     ((Uint32)((b) >> (map).Bloss) << (map).Bshift) |       \
+     (((Uint32)((a) >> (map).Aloss) << (map).Ashift) & (map).Amask))
+
+// Fill a span with colors interpolated between the vertices, in R, G, B, A order
+static void FillTriangleGradientSpan(Uint8 *dst_row, int dstbpp, int x, int x_end, TriangleInterp color[4], Sint64 area, const SDL_PixelFormatDetails *format, const SDL_Palette *palette)
+{
+    const bool map_inline = CanMapTriangleColor(format);
+    TriangleColorMap map;
+
+    GetTriangleColorMap(format, &map);
+
+    for (; x < x_end; x++) {
+        const Uint8 r = (Uint8)GetTriangleInterp(&color[0]);
+        const Uint8 g = (Uint8)GetTriangleInterp(&color[1]);
+        const Uint8 b = (Uint8)GetTriangleInterp(&color[2]);
+        const Uint8 a = (Uint8)GetTriangleInterp(&color[3]);
+        Uint32 pixel;
+
+        if (map_inline) {
+            pixel = MAP_TRIANGLE_COLOR(map, r, g, b, a);
+        } else {
+            pixel = SDL_MapRGBA(format, palette, r, g, b, a);
         }
+        WriteTrianglePixel(dst_row + x * dstbpp, dstbpp, pixel);
+        StepTriangleInterp(&color[0], area);
+        StepTriangleInterp(&color[1], area);
+        StepTriangleInterp(&color[2], area);
+        StepTriangleInterp(&color[3], area);
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/* Step all four channels at once. The colors are never negative, and with an
+ * area below 2^30 the interpolation fits in 32 bits without overflowing.
+ * For 32-bit formats with 8-bit channels, the channels are kept in the order
+ * of the bytes of a pixel, so packing them gives the pixel value directly.
+ */
+static void SDL_TARGETING("sse2") FillTriangleGradientSpanSSE2(Uint8 *dst_row, int dstbpp, int x, int x_end, const TriangleInterp color[4], Sint64 area, const SDL_PixelFormatDetails *format)
+{
+    const bool is_8888 = (dstbpp == 4 && format->Rbits == 8 && format->Gbits == 8 && format->Bbits == 8 && (format->Abits == 8 || format->Abits == 0));
+    const __m128i varea = _mm_set1_epi32((int)area);
+    const __m128i varea_minus_one = _mm_set1_epi32((int)area - 1);
+    int lanes[4] = { 0, 1, 2, 3 };
+    int quot[4], rem[4], step_quot[4], step_rem[4];
+    __m128i vquot, vrem, vstep_quot, vstep_rem;
+    TriangleColorMap map;
+    int i;
 
-        if (blend == SDL_BLENDMODE_MOD) {
-            Uint32 c = SDL_MapSurfaceRGBA(tmp, 255, 255, 255, 255);
-            SDL_FillSurfaceRect(tmp, NULL, c);
+    if (is_8888) {
+        lanes[0] = lanes[1] = lanes[2] = lanes[3] = -1;
+        lanes[format->Rshift / 8] = 0;
+        lanes[format->Gshift / 8] = 1;
+        lanes[format->Bshift / 8] = 2;
+        if (format->Abits) {
+            lanes[format->Ashift / 8] = 3;
         }
+    }
+    for (i = 0; i < 4; i++) {
+        if (lanes[i] < 0) {
+            // The unused byte is always cleared
+            quot[i] = rem[i] = step_quot[i] = step_rem[i] = 0;
+        } else {
+            quot[i] = (int)color[lanes[i]].quot;
+            rem[i] = (int)color[lanes[i]].rem;
+            step_quot[i] = (int)color[lanes[i]].step_quot;
+            step_rem[i] = (int)color[lanes[i]].step_rem;
+        }
+    }
+    vquot = _mm_loadu_si128((const __m128i *)quot);
+    vrem = _mm_loadu_si128((const __m128i *)rem);
+    vstep_quot = _mm_loadu_si128((const __m128i *)step_quot);
+    vstep_rem = _mm_loadu_si128((const __m128i *)step_rem);
 
-        SDL_SetSurfaceBlendMode(tmp, blend);
+    GetTriangleColorMap(format, &map);
 
-        dstbpp = tmp->fmt->bytes_per_pixel;
-        dst_ptr = (Uint8 *)tmp->pixels;
-        dst_pitch = tmp->pitch;
+    for (; x < x_end; x++) {
+        const __m128i packed = _mm_packs_epi32(vquot, vquot);
+        const Uint32 bytes = (Uint32)_mm_cvtsi128_si32(_mm_packus_epi16(packed, packed));
+        __m128i carry;
 
+        if (is_8888) {
+            ((Uint32 *)dst_row)[x] = bytes;
+        } else {
+            const Uint32 pixel = MAP_TRIANGLE_COLOR(map, bytes & 0xFF, (bytes >> 8) & 0xFF, (bytes >> 16) & 0xFF, bytes >> 24);
+            WriteTrianglePixel(dst_row + x * dstbpp, dstbpp, pixel);
+        }
+
+        vrem = _mm_add_epi32(vrem, vstep_rem);
+        carry = _mm_cmpgt_epi32(vrem, varea_minus_one);
+        vquot = _mm_sub_epi32(_mm_add_epi32(vquot, vstep_quot), carry);
+        vrem = _mm_sub_epi32(vrem, _mm_and_si128(carry, varea));
+    }
+}
+#endif // SDL_SSE2_INTRINSICS
+
+static SDL_INLINE void CopyTrianglePixel(Uint8 *dptr, const Uint8 *sptr, int bpp)
+{
+    if (bpp == 4) {
+        *(Uint32 *)dptr = *(const Uint32 *)sptr;
+    } else if (bpp == 3) {
+        dptr[0] = sptr[0];
+        dptr[1] = sptr[1];
+        dptr[2] = sptr[2];
+    } else if (bpp == 2) {
+        *(Uint16 *)dptr = *(const Uint16 *)sptr;
     } else {
-        // Write directly to destination surface
-        dstbpp = dst->fmt->bytes_per_pixel;
-        dst_ptr = (Uint8 *)dst->pixels + dstrect.x * dstbpp + dstrect.y * dst->pitch;
-        dst_pitch = dst->pitch;
+        *dptr = *sptr;
     }
+}
 
-    is_clockwise = area > 0;
-    if (area < 0) {
-        area = -area;
+// Copy a span with a source column for every destination column
+static void CopyTriangleSpan(Uint8 *dst_row, const Uint8 *src_row, int bpp, const int *srcx, int x, int x_end, bool unit_step)
+{
+    if (x >= x_end) {
+        return;
     }
 
-    {
-        int val;
-        PRECOMP(d2d1_y, d1->y - d2->y)
-        PRECOMP(d0d2_y, d2->y - d0->y)
-        PRECOMP(d1d0_y, d0->y - d1->y)
-        PRECOMP(d1d2_x, d2->x - d1->x)
-        PRECOMP(d2d0_x, d0->x - d2->x)
-        PRECOMP(d0d1_x, d1->x - d0->x)
+    // With a unit step, the span is only contiguous in the source if none of it was clamped or wrapped
+    if (unit_step && srcx[x_end - 1] - srcx[x] == x_end - 1 - x) {
+        SDL_memcpy(dst_row + x * bpp, src_row + srcx[x] * bpp, (size_t)(x_end - x) * bpp);
+        return;
     }
 
-    // Starting point for rendering, at the middle of a pixel
-    {
-        SDL_Point p;
-        p.x = dstrect.x;
-        p.y = dstrect.y;
-        trianglepoint_2_fixedpoint(&p);
-        p.x += (1 << FP_BITS) / 2;
-        p.y += (1 << FP_BITS) / 2;
-        w0_row = cross_product(d1, d2, p.x, p.y);
-        w1_row = cross_product(d2, d0, p.x, p.y);
-        w2_row = cross_product(d0, d1, p.x, p.y);
+    if (bpp == 4) {
+        for (; x < x_end; x++) {
+            ((Uint32 *)dst_row)[x] = ((const Uint32 *)src_row)[srcx[x]];
+        }
+    } else if (bpp == 2) {
+        for (; x < x_end; x++) {
+            ((Uint16 *)dst_row)[x] = ((const Uint16 *)src_row)[srcx[x]];
+        }
+    } else {
+        for (; x < x_end; x++) {
+            CopyTrianglePixel(dst_row + x * bpp, src_row + srcx[x] * bpp, bpp);
+        }
     }
+}
 
-    // Handle anti-clockwise triangles
-    if (!is_clockwise) {
-        d2d1_y *= -1;
-        d0d2_y *= -1;
-        d1d0_y *= -1;
-        d1d2_x *= -1;
-        d2d0_x *= -1;
-        d0d1_x *= -1;
-        w0_row *= -1;
-        w1_row *= -1;
-        w2_row *= -1;
+// Blend a span of the scratch row into the destination
+static bool BlendTriangleRow(SDL_Surface *row, SDL_Surface *dst, const TriangleRaster *t, int x, int x_end, int y)
+{
+    SDL_Rect srcrect, dstrect;
+
+    srcrect.x = x;
+    srcrect.y = 0;
+    srcrect.w = x_end - x;
+    srcrect.h = 1;
+    dstrect.x = t->dstrect.x + x;
+    dstrect.y = t->dstrect.y + y;
+    dstrect.w = srcrect.w;
+    dstrect.h = 1;
+    return SDL_BlitSurfaceUnchecked(row, &srcrect, dst, &dstrect);
+}
+
+/* Blended triangles that can't be blended straight into the destination are drawn a row at a time
+ * into scratch, a one row surface as wide as the clip rect that is created on first use and kept
+ * for the rest of the batch.
+ */
+static bool SW_FillTriangle(SDL_Surface *dst, const SDL_Rect *cliprect, SDL_Surface **scratch, const SDL_Point *d0, const SDL_Point *d1, const SDL_Point *d2, SDL_BlendMode blend, SDL_Color c0, SDL_Color c1, SDL_Color c2)
+{
+    TriangleRaster t;
+
+    int dstbpp;
+    Uint8 *dst_ptr;
+    int dst_pitch;
+    int y;
+
+    bool is_uniform;
+
+    SDL_Surface *tmp = NULL;
+
+    if (!SetupTriangle(d0, d1, d2, cliprect, &t)) {
+        return true;
     }
 
-    // Add a bias to respect top-left rasterization rule
-    bias_w0 = (is_top_left(d1, d2, is_clockwise) ? 0 : -1);
-    bias_w1 = (is_top_left(d2, d0, is_clockwise) ? 0 : -1);
-    bias_w2 = (is_top_left(d0, d1, is_clockwise) ? 0 : -1);
+    is_uniform = COLOR_EQ(c0, c1) && COLOR_EQ(c1, c2);
+
+    if (blend != SDL_BLENDMODE_NONE && is_uniform) {
+        SDL_BlendSpanInfo info;
+        Uint8 r = c0.r, g = c0.g, b = c0.b;
+
+        if (blend == SDL_BLENDMODE_BLEND || blend == SDL_BLENDMODE_ADD) {
+            r = DRAW_MUL(r, c0.a);
+            g = DRAW_MUL(g, c0.a);
+            b = DRAW_MUL(b, c0.a);
+        }
+
+        // Blend straight into the destination, the same way as filled rectangles
+        if (SDL_GetBlendSpanInfo(dst->fmt, blend, r, g, b, c0.a, &info)) {
+            dstbpp = dst->fmt->bytes_per_pixel;
+            dst_ptr = (Uint8 *)dst->pixels + t.dstrect.x * dstbpp + t.dstrect.y * dst->pitch;
+            for (y = 0; y < t.dstrect.h; y++) {
+                int x, x_end;
+
+                GetTriangleSpan(&t, &x, &x_end);
+                if (x < x_end) {
+                    SDL_BlendSpan(&info, dst_ptr + x * dstbpp, x_end - x);
+                }
+                NextTriangleRow(&t);
+                dst_ptr += dst->pitch;
+            }
+            return true;
+        }
+    }
+
+    if (blend != SDL_BLENDMODE_NONE) {
+        if (!*scratch) {
+            SDL_PixelFormat format = dst->format;
+
+            // need an alpha format
+            if (!SDL_ISPIXELFORMAT_ALPHA(format)) {
+                format = SDL_PIXELFORMAT_ARGB8888;
+            }
+
+            *scratch = SDL_CreateSurface(cliprect->w, 1, format);
+            if (!*scratch) {
+                return false;
+            }
+            SDL_SetSurfaceBlendMode(*scratch, blend);
+        }
+        tmp = *scratch;
+
+        // Every row is drawn into the same scratch row and blended from there
+        dstbpp = tmp->fmt->bytes_per_pixel;
+        dst_ptr = (Uint8 *)tmp->pixels;
+        dst_pitch = 0;
+
+    } else {
+        // Write directly to destination surface
+        dstbpp = dst->fmt->bytes_per_pixel;
+        dst_ptr = (Uint8 *)dst->pixels + t.dstrect.x * dstbpp + t.dstrect.y * dst->pitch;
+        dst_pitch = dst->pitch;
+    }
 
     if (is_uniform) {
         Uint32 color;
@@ -377,37 +667,21 @@ bool SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poi
             color = SDL_MapSurfaceRGBA(dst, c0.r, c0.g, c0.b, c0.a);
         }
 
-        if (dstbpp == 4) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                *(Uint32 *)dptr = color;
-            }
-            TRIANGLE_END_LOOP
-        } else if (dstbpp == 3) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                Uint8 *s = (Uint8 *)&color;
-                dptr[0] = s[0];
-                dptr[1] = s[1];
-                dptr[2] = s[2];
-            }
-            TRIANGLE_END_LOOP
-        } else if (dstbpp == 2) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                *(Uint16 *)dptr = (Uint16)color;
-            }
-            TRIANGLE_END_LOOP
-        } else if (dstbpp == 1) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                *dptr = (Uint8)color;
+        for (y = 0; y < t.dstrect.h; y++) {
+            int x, x_end;
+
+            GetTriangleSpan(&t, &x, &x_end);
+            FillTriangleSpan(dst_ptr, dstbpp, x, x_end, color);
+            if (tmp && x < x_end && !BlendTriangleRow(tmp, dst, &t, x, x_end, y)) {
+                return false;
             }
-            TRIANGLE_END_LOOP
+            NextTriangleRow(&t);
+            dst_ptr += dst_pitch;
         }
     } else {
         const SDL_PixelFormatDetails *format;
         SDL_Palette *palette;
+        bool use_sse2 = false;
         if (tmp) {
             format = tmp->fmt;
             palette = tmp->palette;
@@ -415,70 +689,55 @@ bool SDL_SW_FillTriangle(SDL_Surface *dst, SDL_Point *d0, SDL_Point *d1, SDL_Poi
             format = dst->fmt;
             palette = dst->palette;
         }
-        if (dstbpp == 4) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                TRIANGLE_GET_MAPPED_COLOR
-                *(Uint32 *)dptr = color;
-            }
-            TRIANGLE_END_LOOP
-        } else if (dstbpp == 3) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                TRIANGLE_GET_MAPPED_COLOR
-                Uint8 *s = (Uint8 *)&color;
-                dptr[0] = s[0];
-                dptr[1] = s[1];
-                dptr[2] = s[2];
-            }
-            TRIANGLE_END_LOOP
-        } else if (dstbpp == 2) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                TRIANGLE_GET_MAPPED_COLOR
-                *(Uint16 *)dptr = (Uint16)color;
-            }
-            TRIANGLE_END_LOOP
-        } else if (dstbpp == 1) {
-            TRIANGLE_BEGIN_LOOP
-            {
-                TRIANGLE_GET_MAPPED_COLOR
-                *dptr = (Uint8)color;
-            }
-            TRIANGLE_END_LOOP
-        }
-    }
 
-    if (tmp) {
-        SDL_BlitSurface(tmp, NULL, dst, &dstrect);
-        SDL_DestroySurface(tmp);
-    }
+#ifdef SDL_SSE2_INTRINSICS
+        use_sse2 = CanMapTriangleColor(format) && t.area < (1 << 30) && SDL_HasSSE2();
+#endif
 
-end:
-    if (dst_locked) {
-        SDL_UnlockSurface(dst);
+        for (y = 0; y < t.dstrect.h; y++) {
+            TriangleInterp color[4];
+            int x, x_end;
+
+            GetTriangleSpan(&t, &x, &x_end);
+            if (x < x_end) {
+                SetupTriangleInterp(&color[0], &t, x, c0.r, c1.r, c2.r, 0, false);
+                SetupTriangleInterp(&color[1], &t, x, c0.g, c1.g, c2.g, 0, false);
+                SetupTriangleInterp(&color[2], &t, x, c0.b, c1.b, c2.b, 0, false);
+                SetupTriangleInterp(&color[3], &t, x, c0.a, c1.a, c2.a, 0, false);
+#ifdef SDL_SSE2_INTRINSICS
+                if (use_sse2) {
+                    FillTriangleGradientSpanSSE2(dst_ptr, dstbpp, x, x_end, color, t.area, format);
+                } else
+#endif
+                {
+                    FillTriangleGradientSpan(dst_ptr, dstbpp, x, x_end, color, t.area, format, palette);
+                }
+                if (tmp && !BlendTriangleRow(tmp, dst, &t, x, x_end, y)) {
+                    return false;
+                }
+            }
+            NextTriangleRow(&t);
+            dst_ptr += dst_pitch;
+        }
     }
 
-    return result;
+    return true;
 }
 
-bool SDL_SW_BlitTriangle(
+static bool SW_BlitTriangle(
     SDL_Surface *src,
-    SDL_Point *s0, SDL_Point *s1, SDL_Point *s2,
-    SDL_Surface *dst,
-    SDL_Point *d0, SDL_Point *d1, SDL_Point *d2,
+    const SDL_Point *s0, const SDL_Point *s1, const SDL_Point *s2,
+    SDL_Surface *dst, const SDL_Rect *cliprect,
+    const SDL_Point *d0, const SDL_Point *d1, const SDL_Point *d2,
     SDL_Color c0, SDL_Color c1, SDL_Color c2,
     SDL_TextureAddressMode texture_address_mode_u,
     SDL_TextureAddressMode texture_address_mode_v)
 {
     bool result = true;
-    SDL_Surface *src_surface = src;
-    int src_locked = 0;
-    int dst_locked = 0;
 
     SDL_BlendMode blend;
 
-    SDL_Rect dstrect;
+    TriangleRaster t;
 
     SDL_Point s2_x_area;
 
@@ -486,60 +745,24 @@ bool SDL_SW_BlitTriangle(
     Uint8 *dst_ptr;
     int dst_pitch;
 
-    const int *src_ptr;
+    const Uint8 *src_ptr;
     int src_pitch;
 
-    Sint64 area, tmp64;
-    int is_clockwise;
+    Sint64 tmp64;
 
-    int d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x;
     int s2s0_x, s2s1_x, s2s0_y, s2s1_y;
-
-    Sint64 w0_row, w1_row, w2_row;
-    int bias_w0, bias_w1, bias_w2;
+    int y;
 
     bool is_uniform;
 
     bool has_modulation;
 
-    CHECK_PARAM(!SDL_SurfaceValid(src)) {
-        return SDL_InvalidParamError("src");
-    }
-    CHECK_PARAM(!SDL_SurfaceValid(dst)) {
-        return SDL_InvalidParamError("dst");
-    }
-
-    area = cross_product(d0, d1, d2->x, d2->y);
-
-    // Flat triangle
-    if (area == 0) {
+    if (!SetupTriangle(d0, d1, d2, cliprect, &t)) {
         return true;
     }
 
-    // Lock the destination, if needed
-    if (SDL_MUSTLOCK(dst)) {
-        if (!SDL_LockSurface(dst)) {
-            result = false;
-            goto end;
-        } else {
-            dst_locked = 1;
-        }
-    }
-
-    // Lock the source, if needed
-    if (SDL_MUSTLOCK(src)) {
-        if (!SDL_LockSurface(src)) {
-            result = false;
-            goto end;
-        } else {
-            src_locked = 1;
-        }
-    }
-
     is_uniform = COLOR_EQ(c0, c1) && COLOR_EQ(c1, c2);
 
-    bounding_rect_fixedpoint(d0, d1, d2, &dstrect);
-
     SDL_GetSurfaceBlendMode(src, &blend);
 
     if (is_uniform) {
@@ -549,87 +772,32 @@ bool SDL_SW_BlitTriangle(
         has_modulation = true;
     }
 
-    {
-        // Clip triangle with surface clip rect
-        SDL_Rect rect;
-        SDL_GetSurfaceClipRect(dst, &rect);
-        SDL_GetRectIntersection(&dstrect, &rect, &dstrect);
-    }
-
     // Set destination pointer
     dstbpp = dst->fmt->bytes_per_pixel;
-    dst_ptr = (Uint8 *)dst->pixels + dstrect.x * dstbpp + dstrect.y * dst->pitch;
+    dst_ptr = (Uint8 *)dst->pixels + t.dstrect.x * dstbpp + t.dstrect.y * dst->pitch;
     dst_pitch = dst->pitch;
 
     // Set source pointer
-    src_ptr = (const int *)src->pixels;
+    src_ptr = (const Uint8 *)src->pixels;
     src_pitch = src->pitch;
 
-    is_clockwise = area > 0;
-    if (area < 0) {
-        area = -area;
-    }
-
-    {
-        int val;
-        PRECOMP(d2d1_y, d1->y - d2->y)
-        PRECOMP(d0d2_y, d2->y - d0->y)
-        PRECOMP(d1d0_y, d0->y - d1->y)
-        PRECOMP(d1d2_x, d2->x - d1->x)
-        PRECOMP(d2d0_x, d0->x - d2->x)
-        PRECOMP(d0d1_x, d1->x - d0->x)
-    }
-
     s2s0_x = s0->x - s2->x;
     s2s1_x = s1->x - s2->x;
     s2s0_y = s0->y - s2->y;
     s2s1_y = s1->y - s2->y;
 
-    // Starting point for rendering, at the middle of a pixel
-    {
-        SDL_Point p;
-        p.x = dstrect.x;
-        p.y = dstrect.y;
-        trianglepoint_2_fixedpoint(&p);
-        p.x += (1 << FP_BITS) / 2;
-        p.y += (1 << FP_BITS) / 2;
-        w0_row = cross_product(d1, d2, p.x, p.y);
-        w1_row = cross_product(d2, d0, p.x, p.y);
-        w2_row = cross_product(d0, d1, p.x, p.y);
-    }
-
-    // Handle anti-clockwise triangles
-    if (!is_clockwise) {
-        d2d1_y *= -1;
-        d0d2_y *= -1;
-        d1d0_y *= -1;
-        d1d2_x *= -1;
-        d2d0_x *= -1;
-        d0d1_x *= -1;
-        w0_row *= -1;
-        w1_row *= -1;
-        w2_row *= -1;
-    }
-
-    // Add a bias to respect top-left rasterization rule
-    bias_w0 = (is_top_left(d1, d2, is_clockwise) ? 0 : -1);
-    bias_w1 = (is_top_left(d2, d0, is_clockwise) ? 0 : -1);
-    bias_w2 = (is_top_left(d0, d1, is_clockwise) ? 0 : -1);
-
-    /* precompute constant 's2->x * area' used in TRIANGLE_GET_TEXTCOORD */
-    tmp64 = s2->x * area;
+    /* precompute constant 's2->x * area' used for the texture coordinates */
+    tmp64 = s2->x * t.area;
     if (tmp64 >= INT_MIN && tmp64 <= INT_MAX) {
         s2_x_area.x = (int)tmp64;
     } else {
-        result = SDL_SetError("triangle area overflow");
-        goto end;
+        return SDL_SetError("triangle area overflow");
     }
-    tmp64 = s2->y * area;
+    tmp64 = s2->y * t.area;
     if (tmp64 >= INT_MIN && tmp64 <= INT_MAX) {
         s2_x_area.y = (int)tmp64;
     } else {
-        result = SDL_SetError("triangle area overflow");
-        goto end;
+        return SDL_SetError("triangle area overflow");
     }
 
     if (blend != SDL_BLENDMODE_NONE || src->format != dst->format || has_modulation || !is_uniform) {
@@ -669,7 +837,7 @@ bool SDL_SW_BlitTriangle(
         tmp_info.colorkey = info->colorkey;
 
         // src
-        tmp_info.src_surface = src_surface;
+        tmp_info.src_surface = src;
         tmp_info.src = (Uint8 *)src_ptr;
         tmp_info.src_pitch = src_pitch;
 
@@ -677,59 +845,208 @@ bool SDL_SW_BlitTriangle(
         tmp_info.dst = dst_ptr;
         tmp_info.dst_pitch = dst_pitch;
 
-#define CHECK_INT_RANGE(X) \
-    if ((X) < INT_MIN || (X) > INT_MAX) { \
-        result = SDL_SetError("integer overflow (%s = %" SDL_PRIs64 ")", #X, X); \
-        goto end; \
-    }
-        CHECK_INT_RANGE(area);
-        CHECK_INT_RANGE(w0_row);
-        CHECK_INT_RANGE(w1_row);
-        CHECK_INT_RANGE(w2_row);
-        SDL_BlitTriangle_Slow(&tmp_info, s2_x_area, dstrect, (int)area, bias_w0, bias_w1, bias_w2,
-                              d2d1_y, d1d2_x, d0d2_y, d2d0_x, d1d0_y, d0d1_x,
-                              s2s0_x, s2s1_x, s2s0_y, s2s1_y, (int)w0_row, (int)w1_row, (int)w2_row,
+        SDL_BlitTriangle_Slow(&tmp_info, &t, s2_x_area,
+                              s2s0_x, s2s1_x, s2s0_y, s2s1_y,
                               c0, c1, c2, is_uniform, texture_address_mode_u, texture_address_mode_v);
+        return true;
+    }
 
-        goto end;
+    if ((Sint64)t.step_y[0] * s2s0_x + (Sint64)t.step_y[1] * s2s1_x == 0 &&
+        (Sint64)t.step_x[0] * s2s0_y + (Sint64)t.step_x[1] * s2s1_y == 0) {
+        /* The texture is mapped without rotation, as for sprites drawn with two triangles,
+         * so every row reads the same source columns.
+         */
+        TriangleInterp u, v;
+        bool unit_step;
+        bool isstack;
+        int x;
+        int *srcx = SDL_small_alloc(int, t.dstrect.w, &isstack);
+        if (!srcx) {
+            return false;
+        }
+
+        SetupTriangleInterp(&u, &t, 0, s2s0_x, s2s1_x, 0, s2_x_area.x, false);
+        unit_step = (u.step_quot == 1 && u.step_rem == 0);
+        for (x = 0; x < t.dstrect.w; x++) {
+            srcx[x] = GetTextureCoord(GetTriangleInterp(&u), src->w, texture_address_mode_u);
+            StepTriangleInterp(&u, t.area);
+        }
+
+        SetupTriangleInterp(&v, &t, 0, s2s0_y, s2s1_y, 0, s2_x_area.y, true);
+        for (y = 0; y < t.dstrect.h; y++) {
+            const int srcy = GetTextureCoord(GetTriangleInterp(&v), src->h, texture_address_mode_v);
+            int x_end;
+
+            GetTriangleSpan(&t, &x, &x_end);
+            CopyTriangleSpan(dst_ptr, src_ptr + srcy * src_pitch, dstbpp, srcx, x, x_end, unit_step);
+            StepTriangleInterp(&v, t.area);
+            NextTriangleRow(&t);
+            dst_ptr += dst_pitch;
+        }
+        SDL_small_free(srcx, isstack);
+    } else {
+        for (y = 0; y < t.dstrect.h; y++) {
+            TriangleInterp u, v;
+            int x, x_end;
+
+            GetTriangleSpan(&t, &x, &x_end);
+            SetupTriangleInterp(&u, &t, x, s2s0_x, s2s1_x, 0, s2_x_area.x, false);
+            SetupTriangleInterp(&v, &t, x, s2s0_y, s2s1_y, 0, s2_x_area.y, false);
+            for (; x < x_end; x++) {
+                const int srcx = GetTextureCoord(GetTriangleInterp(&u), src->w, texture_address_mode_u);
+                const int srcy = GetTextureCoord(GetTriangleInterp(&v), src->h, texture_address_mode_v);
+                CopyTrianglePixel(dst_ptr + x * dstbpp, src_ptr + srcy * src_pitch + srcx * dstbpp, dstbpp);
+                StepTriangleInterp(&u, t.area);
+                StepTriangleInterp(&v, t.area);
+            }
+            NextTriangleRow(&t);
+            dst_ptr += dst_pitch;
+        }
     }
 
-    if (dstbpp == 4) {
-        TRIANGLE_BEGIN_LOOP
-        {
-            TRIANGLE_GET_TEXTCOORD
-            Uint32 *sptr = (Uint32 *)((Uint8 *)src_ptr + srcy * src_pitch);
-            *(Uint32 *)dptr = sptr[srcx];
+    return result;
+}
+
+/* Batches of triangles are drawn in bands of rows. Every band draws all of
+ * the triangles that overlap it in order, so the bands can be drawn on
+ * separate threads and still give the same result as drawing them in one go.
+ */
+#define TRIANGLE_PARALLEL_MIN_PIXELS (256 * 256)
+#define TRIANGLE_BAND_MIN_ROWS       16
+#define TRIANGLE_BAND_MAX_ROWS       128
+
+typedef struct TriangleBatch
+{
+    SDL_Surface *src;
+    SDL_Surface *dst;
+    const GeometryFillData *fill;
+    const GeometryCopyData *copy;
+    int count;
+    SDL_BlendMode blend;
+    SDL_TextureAddressMode texture_address_mode_u;
+    SDL_TextureAddressMode texture_address_mode_v;
+    SDL_Rect cliprect;
+    int band_height;
+    SDL_Surface **scratch;  // a scratch row for each thread slot, see SW_FillTriangle()
+} TriangleBatch;
+
+static bool DrawTriangles(const TriangleBatch *batch, const SDL_Rect *cliprect, SDL_Surface **scratch)
+{
+    bool result = true;
+    int i;
+
+    if (batch->copy) {
+        const GeometryCopyData *ptr = batch->copy;
+        for (i = 0; i < batch->count; i += 3, ptr += 3) {
+            if (!SW_BlitTriangle(batch->src,
+                                 &(ptr[0].src), &(ptr[1].src), &(ptr[2].src),
+                                 batch->dst, cliprect,
+                                 &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst),
+                                 ptr[0].color, ptr[1].color, ptr[2].color,
+                                 batch->texture_address_mode_u,
+                                 batch->texture_address_mode_v)) {
+                result = false;
+            }
         }
-        TRIANGLE_END_LOOP
-    } else if (dstbpp == 3) {
-        TRIANGLE_BEGIN_LOOP
-        {
-            TRIANGLE_GET_TEXTCOORD
-            Uint8 *sptr = (Uint8 *)src_ptr + srcy * src_pitch;
-            dptr[0] = sptr[3 * srcx];
-            dptr[1] = sptr[3 * srcx + 1];
-            dptr[2] = sptr[3 * srcx + 2];
-        }
-        TRIANGLE_END_LOOP
-    } else if (dstbpp == 2) {
-        TRIANGLE_BEGIN_LOOP
-        {
-            TRIANGLE_GET_TEXTCOORD
-            Uint16 *sptr = (Uint16 *)((Uint8 *)src_ptr + srcy * src_pitch);
-            *(Uint16 *)dptr = sptr[srcx];
+    } else {
+        const GeometryFillData *ptr = batch->fill;
+        for (i = 0; i < batch->count; i += 3, ptr += 3) {
+            if (!SW_FillTriangle(batch->dst, cliprect, scratch, &(ptr[0].dst), &(ptr[1].dst), &(ptr[2].dst), batch->blend, ptr[0].color, ptr[1].color, ptr[2].color)) {
+                result = false;
+            }
         }
-        TRIANGLE_END_LOOP
-    } else if (dstbpp == 1) {
-        TRIANGLE_BEGIN_LOOP
-        {
-            TRIANGLE_GET_TEXTCOORD
-            Uint8 *sptr = (Uint8 *)src_ptr + srcy * src_pitch;
-            *dptr = sptr[srcx];
+    }
+    return result;
+}
+
+static bool SDLCALL DrawTriangleBand(void *userdata, int item, int slot)
+{
+    const TriangleBatch *batch = (const TriangleBatch *)userdata;
+    SDL_Rect band = batch->cliprect;
+
+    band.y += item * batch->band_height;
+    band.h = SDL_min(batch->band_height, batch->cliprect.y + batch->cliprect.h - band.y);
+    return DrawTriangles(batch, &band, &batch->scratch[slot]);
+}
+
+// Estimate the number of pixels a batch touches, from the bounding rects of its triangles
+static Sint64 GetTriangleBatchPixels(const TriangleBatch *batch)
+{
+    Sint64 pixels = 0;
+    int i;
+
+    for (i = 0; i + 2 < batch->count; i += 3) {
+        const SDL_Point *d0, *d1, *d2;
+        SDL_Rect rect;
+
+        if (batch->copy) {
+            d0 = &batch->copy[i].dst;
+            d1 = &batch->copy[i + 1].dst;
+            d2 = &batch->copy[i + 2].dst;
+        } else {
+            d0 = &batch->fill[i].dst;
+            d1 = &batch->fill[i + 1].dst;
+            d2 = &batch->fill[i + 2].dst;
+        }
+        bounding_rect_fixedpoint(d0, d1, d2, &rect);
+        if (SDL_GetRectIntersection(&rect, &batch->cliprect, &rect)) {
+            pixels += (Sint64)rect.w * rect.h;
+        }
+    }
+    return pixels;
+}
+
+static bool DrawTriangleBatch(TriangleBatch *batch)
+{
+    SDL_Surface *src = batch->src;
+    SDL_Surface *dst = batch->dst;
+    bool result = true;
+    int src_locked = 0;
+    int dst_locked = 0;
+    int num_threads, i;
+
+    // Lock the surfaces once for the whole batch, if needed
+    if (SDL_MUSTLOCK(dst)) {
+        if (!SDL_LockSurface(dst)) {
+            return false;
+        }
+        dst_locked = 1;
+    }
+    if (src && SDL_MUSTLOCK(src)) {
+        if (!SDL_LockSurface(src)) {
+            result = false;
+            goto end;
         }
-        TRIANGLE_END_LOOP
+        src_locked = 1;
+    }
+
+    SDL_GetSurfaceClipRect(dst, &batch->cliprect);
+
+    num_threads = SDL_GetParallelThreadCount();
+    if (num_threads > 1 && GetTriangleBatchPixels(batch) < TRIANGLE_PARALLEL_MIN_PIXELS) {
+        num_threads = 1;
+    }
+    batch->scratch = (SDL_Surface **)SDL_calloc(num_threads, sizeof(*batch->scratch));
+    if (!batch->scratch) {
+        result = false;
+        goto end;
+    }
+
+    if (num_threads > 1) {
+        // Aim for a few bands per thread so they balance out if some are busier than others
+        int rows = (batch->cliprect.h + (num_threads * 4) - 1) / (num_threads * 4);
+        rows = SDL_clamp(rows, TRIANGLE_BAND_MIN_ROWS, TRIANGLE_BAND_MAX_ROWS);
+        batch->band_height = rows;
+        result = SDL_RunParallel(DrawTriangleBand, batch, (batch->cliprect.h + rows - 1) / rows, num_threads);
+    } else {
+        result = DrawTriangles(batch, &batch->cliprect, &batch->scratch[0]);
     }
 
+    for (i = 0; i < num_threads; ++i) {
+        SDL_DestroySurface(batch->scratch[i]);
+    }
+    SDL_free(batch->scratch);
+
 end:
     if (dst_locked) {
         SDL_UnlockSurface(dst);
@@ -737,10 +1054,48 @@ end:
     if (src_locked) {
         SDL_UnlockSurface(src);
     }
-
     return result;
 }
 
+bool SDL_SW_FillTriangles(SDL_Surface *dst, const GeometryFillData *verts, int count, SDL_BlendMode blend)
+{
+    TriangleBatch batch;
+
+    if (!SDL_SurfaceValid(dst)) {
+        return false;
+    }
+
+    SDL_zero(batch);
+    batch.dst = dst;
+    batch.fill = verts;
+    batch.count = count;
+    batch.blend = blend;
+    return DrawTriangleBatch(&batch);
+}
+
+bool SDL_SW_BlitTriangles(SDL_Surface *src, SDL_Surface *dst, const GeometryCopyData *verts, int count,
+                          SDL_TextureAddressMode texture_address_mode_u,
+                          SDL_TextureAddressMode texture_address_mode_v)
+{
+    TriangleBatch batch;
+
+    CHECK_PARAM(!SDL_SurfaceValid(src)) {
+        return SDL_InvalidParamError("src");
+    }
+    CHECK_PARAM(!SDL_SurfaceValid(dst)) {
+        return SDL_InvalidParamError("dst");
+    }
+
+    SDL_zero(batch);
+    batch.src = src;
+    batch.dst = dst;
+    batch.copy = verts;
+    batch.count = count;
+    batch.texture_address_mode_u = texture_address_mode_u;
+    batch.texture_address_mode_v = texture_address_mode_v;
+    return DrawTriangleBatch(&batch);
+}
+
 #define FORMAT_ALPHA                0
 #define FORMAT_NO_ALPHA             -1
 #define FORMAT_INDEX8               -2
@@ -761,10 +1116,8 @@ static int detect_format(const SDL_PixelFormatDetails *pf)
     }
 }
 
-static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
-                                  SDL_Point s2_x_area, SDL_Rect dstrect, int area, int bias_w0, int bias_w1, int bias_w2,
-                                  int d2d1_y, int d1d2_x, int d0d2_y, int d2d0_x, int d1d0_y, int d0d1_x,
-                                  int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y, int w0_row, int w1_row, int w2_row,
+static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info, TriangleRaster *t, SDL_Point s2_x_area,
+                                  int s2s0_x, int s2s1_x, int s2s0_y, int s2s1_y,
                                   SDL_Color c0, SDL_Color c1, SDL_Color c2, bool is_uniform,
                                   SDL_TextureAddressMode texture_address_mode_u,
                                   SDL_TextureAddressMode texture_address_mode_v)
@@ -791,142 +1144,168 @@ static void SDL_BlitTriangle_Slow(SDL_BlitInfo *info,
 
     Uint8 *dst_ptr = info->dst;
     int dst_pitch = info->dst_pitch;
+    int y;
 
     srcfmt_val = detect_format(src_fmt);
     dstfmt_val = detect_format(dst_fmt);
 
-    TRIANGLE_BEGIN_LOOP
-    {
-        Uint8 *src;
-        Uint8 *dst = dptr;
-        TRIANGLE_GET_TEXTCOORD
-        src = (info->src + (srcy * info->src_pitch) + (srcx * srcbpp));
-        if (FORMAT_INDEXED(srcfmt_val)) {
-            srcpixel = *src;
-            const SDL_Color *color = &palette->colors[srcpixel];
-            srcR = color->r;
-            srcG = color->g;
-            srcB = color->b;
-            srcA = color->a;
-        } else if (FORMAT_HAS_ALPHA(srcfmt_val)) {
-            DISEMBLE_RGBA(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB, srcA);
-        } else if (FORMAT_HAS_NO_ALPHA(srcfmt_val)) {
-            DISEMBLE_RGB(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB);
-            srcA = 0xFF;
-        } else {
-            // SDL_PIXELFORMAT_ARGB2101010
-            srcpixel = *((Uint32 *)(src));
-            RGBA_FROM_ARGB2101010(srcpixel, srcR, srcG, srcB, srcA);
-        }
-        if (flags & SDL_COPY_COLORKEY) {
-            // srcpixel isn't set for 24 bpp
-            if (srcbpp == 3) {
-                srcpixel = (srcR << src_fmt->Rshift) |
-                           (srcG << src_fmt->Gshift) | (srcB << src_fmt->Bshift);
+    for (y = 0; y < t->dstrect.h; y++) {
+        TriangleInterp u, v, r, g, b, a;
+        int x, x_end;
+
+        GetTriangleSpan(t, &x, &x_end);
+        SetupTriangleInterp(&u, t, x, s2s0_x, s2s1_x, 0, s2_x_area.x, false);
+        SetupTriangleInterp(&v, t, x, s2s0_y, s2s1_y, 0, s2_x_area.y, false);
+        if (!is_uniform) {
+            SetupTriangleInterp(&r, t, x, c0.r, c1.r, c2.r, 0, false);
+            SetupTriangleInterp(&g, t, x, c0.g, c1.g, c2.g, 0, false);
+            SetupTriangleInterp(&b, t, x, c0.b, c1.b, c2.b, 0, false);
+            SetupTriangleInterp(&a, t, x, c0.a, c1.a, c2.a, 0, false);
+        }
+        for (; x < x_end; x++) {
+            Uint8 *src;
+            Uint8 *dst = dst_ptr + x * dstbpp;
+            const int srcx = GetTextureCoord(GetTriangleInterp(&u), src_surface->w, texture_address_mode_u);
+            const int srcy = GetTextureCoord(GetTriangleInterp(&v), src_surface->h, texture_address_mode_v);
+
+            if (!is_uniform) {
+                modulateR = GetTriangleInterp(&r);
+                modulateG = GetTriangleInterp(&g);
+                modulateB = GetTriangleInterp(&b);
+                modulateA = GetTriangleInterp(&a);
             }
-            if ((srcpixel & rgbmask) == ckey) {
-                continue;
+
+            // Step to the next pixel now, so skipping the rest of this one doesn't lose track
+            StepTriangleInterp(&u, t->area);
+            StepTriangleInterp(&v, t->area);
+            if (!is_uniform) {
+                StepTriangleInterp(&r, t->area);
+                StepTriangleInterp(&g, t->area);
+                StepTriangleInterp(&b, t->area);
+                StepTriangleInterp(&a, t->area);
             }
-        }
-        if ((flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL))) {
-            if (FORMAT_HAS_ALPHA(dstfmt_val)) {
-                DISEMBLE_RGBA(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB, dstA);
-            } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
-                DISEMBLE_RGB(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB);
-                dstA = 0xFF;
+
+            src = (info->src + (srcy * info->src_pitch) + (srcx * srcbpp));
+            if (FORMAT_INDEXED(srcfmt_val)) {
+                srcpixel = *src;
+                const SDL_Color *color = &palette->colors[srcpixel];
+                srcR = color->r;
+                srcG = color->g;
+                srcB = color->b;
+                srcA = color->a;
+            } else if (FORMAT_HAS_ALPHA(srcfmt_val)) {
+                DISEMBLE_RGBA(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB, srcA);
+            } else if (FORMAT_HAS_NO_ALPHA(srcfmt_val)) {
+                DISEMBLE_RGB(src, srcbpp, src_fmt, srcpixel, srcR, srcG, srcB);
+                srcA = 0xFF;
             } else {
                 // SDL_PIXELFORMAT_ARGB2101010
-                dstpixel = *((Uint32 *) (dst));
-                RGBA_FROM_ARGB2101010(dstpixel, dstR, dstG, dstB, dstA);
+                srcpixel = *((Uint32 *)(src));
+                RGBA_FROM_ARGB2101010(srcpixel, srcR, srcG, srcB, srcA);
             }
-        } else {
-            // don't care
-            dstR = dstG = dstB = dstA = 0;
-        }
-
-        if (!is_uniform) {
-            TRIANGLE_GET_COLOR
-            modulateR = r;
-            modulateG = g;
-            modulateB = b;
-            modulateA = a;
-        }
-
-        if (flags & SDL_COPY_MODULATE_COLOR) {
-            srcR = (srcR * modulateR) / 255;
-            srcG = (srcG * modulateG) / 255;
-            srcB = (srcB * modulateB) / 255;
-        }
-        if (flags & SDL_COPY_MODULATE_ALPHA) {
-            srcA = (srcA * modulateA) / 255;
-        }
-        if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
-            // This goes away if we ever use premultiplied alpha
-            if (srcA < 255) {
-                srcR = (srcR * srcA) / 255;
-                srcG = (srcG * srcA) / 255;
-                srcB = (srcB * srcA) / 255;
+            if (flags & SDL_COPY_COLORKEY) {
+                // srcpixel isn't set for 24 bpp
+                if (srcbpp == 3) {
+                    srcpixel = (srcR << src_fmt->Rshift) |
+                               (srcG << src_fmt->Gshift) | (srcB << src_fmt->Bshift);
+                }
+                if ((srcpixel & rgbmask) == ckey) {
+                    continue;
+                }
             }
-        }
-        switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
-        case 0:
-            dstR = srcR;
-            dstG = srcG;
-            dstB = srcB;
-            dstA = srcA;
-            break;
-        case SDL_COPY_BLEND:
-            dstR = srcR + ((255 - srcA) * dstR) / 255;
-            dstG = srcG + ((255 - srcA) * dstG) / 255;
-            dstB = srcB + ((255 - srcA) * dstB) / 255;
-            dstA = srcA + ((255 - srcA) * dstA) / 255;
-            break;
-        case SDL_COPY_ADD:
-            dstR = srcR + dstR;
-            if (dstR > 255) {
-                dstR = 255;
+            if ((flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL))) {
+                if (FORMAT_HAS_ALPHA(dstfmt_val)) {
+                    DISEMBLE_RGBA(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB, dstA);
+                } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
+                    DISEMBLE_RGB(dst, dstbpp, dst_fmt, dstpixel, dstR, dstG, dstB);
+                    dstA = 0xFF;
+                } else {
+                    // SDL_PIXELFORMAT_ARGB2101010
+                    dstpixel = *((Uint32 *) (dst));
+                    RGBA_FROM_ARGB2101010(dstpixel, dstR, dstG, dstB, dstA);
+                }
+            } else {
+                // don't care
+                dstR = dstG = dstB = dstA = 0;
             }
-            dstG = srcG + dstG;
-            if (dstG > 255) {
-                dstG = 255;
+
+            if (flags & SDL_COPY_MODULATE_COLOR) {
+                srcR = (srcR * modulateR) / 255;
+                srcG = (srcG * modulateG) / 255;
+                srcB = (srcB * modulateB) / 255;
             }
-            dstB = srcB + dstB;
-            if (dstB > 255) {
-                dstB = 255;
+            if (flags & SDL_COPY_MODULATE_ALPHA) {
+                srcA = (srcA * modulateA) / 255;
             }
-            break;
-        case SDL_COPY_MOD:
-            dstR = (srcR * dstR) / 255;
-            dstG = (srcG * dstG) / 255;
-            dstB = (srcB * dstB) / 255;
-            break;
-        case SDL_COPY_MUL:
-            dstR = ((srcR * dstR) + (dstR * (255 - srcA))) / 255;
-            if (dstR > 255) {
-                dstR = 255;
+            if (flags & (SDL_COPY_BLEND | SDL_COPY_ADD)) {
+                // This goes away if we ever use premultiplied alpha
+                if (srcA < 255) {
+                    srcR = (srcR * srcA) / 255;
+                    srcG = (srcG * srcA) / 255;
+                    srcB = (srcB * srcA) / 255;
+                }
             }
-            dstG = ((srcG * dstG) + (dstG * (255 - srcA))) / 255;
-            if (dstG > 255) {
-                dstG = 255;
+            switch (flags & (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_MUL)) {
+            case 0:
+                dstR = srcR;
+                dstG = srcG;
+                dstB = srcB;
+                dstA = srcA;
+                break;
+            case SDL_COPY_BLEND:
+                dstR = srcR + ((255 - srcA) * dstR) / 255;
+                dstG = srcG + ((255 - srcA) * dstG) / 255;
+                dstB = srcB + ((255 - srcA) * dstB) / 255;
+                dstA = srcA + ((255 - srcA) * dstA) / 255;
+                break;
+            case SDL_COPY_ADD:
+                dstR = srcR + dstR;
+                if (dstR > 255) {
+                    dstR = 255;
+                }
+                dstG = srcG + dstG;
+                if (dstG > 255) {
+                    dstG = 255;
+                }
+                dstB = srcB + dstB;
+                if (dstB > 255) {
+                    dstB = 255;
+                }
+                break;
+            case SDL_COPY_MOD:
+                dstR = (srcR * dstR) / 255;
+                dstG = (srcG * dstG) / 255;
+                dstB = (srcB * dstB) / 255;
+                break;
+            case SDL_COPY_MUL:
+                dstR = ((srcR * dstR) + (dstR * (255 - srcA))) / 255;
+                if (dstR > 255) {
+                    dstR = 255;
+                }
+                dstG = ((srcG * dstG) + (dstG * (255 - srcA))) / 255;
+                if (dstG > 255) {
+                    dstG = 255;
+                }
+                dstB = ((srcB * dstB) + (dstB * (255 - srcA))) / 255;
+                if (dstB > 255) {
+                    dstB = 255;
+                }
+                break;
             }
-            dstB = ((srcB * dstB) + (dstB * (255 - srcA))) / 255;
-            if (dstB > 255) {
-                dstB = 255;
+            if (FORMAT_HAS_ALPHA(dstfmt_val)) {
+                ASSEMBLE_RGBA(dst, dstbpp, dst_fmt, dstR, dstG, dstB, dstA);
+            } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
+                ASSEMBLE_RGB(dst, dstbpp, dst_fmt, dstR, dstG, dstB);
+            } else {
+                // SDL_PIXELFORMAT_ARGB2101010
+                Uint32 pixelvalue;
+                ARGB2101010_FROM_RGBA(pixelvalue, dstR, dstG, dstB, dstA);
+                *(Uint32 *)dst = pixelvalue;
             }
-            break;
-        }
-        if (FORMAT_HAS_ALPHA(dstfmt_val)) {
-            ASSEMBLE_RGBA(dst, dstbpp, dst_fmt, dstR, dstG, dstB, dstA);
-        } else if (FORMAT_HAS_NO_ALPHA(dstfmt_val)) {
-            ASSEMBLE_RGB(dst, dstbpp, dst_fmt, dstR, dstG, dstB);
-        } else {
-            // SDL_PIXELFORMAT_ARGB2101010
-            Uint32 pixelvalue;
-            ARGB2101010_FROM_RGBA(pixelvalue, dstR, dstG, dstB, dstA);
-            *(Uint32 *)dst = pixelvalue;
         }
+        NextTriangleRow(t);
+        dst_ptr += dst_pitch;
     }
-    TRIANGLE_END_LOOP
 }
 
 #endif // SDL_VIDEO_RENDER_SW
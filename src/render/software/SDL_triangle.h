@@ -24,18 +24,29 @@
 
 #include "SDL_internal.h"
 
-extern bool SDL_SW_FillTriangle(SDL_Surface *dst,
-                                SDL_Point *d0, SDL_Point *d1, SDL_Point *d2,
-                                SDL_BlendMode blend, SDL_Color c0, SDL_Color c1, SDL_Color c2);
-
-extern bool SDL_SW_BlitTriangle(SDL_Surface *src,
-                                SDL_Point *s0, SDL_Point *s1, SDL_Point *s2,
-                                SDL_Surface *dst,
-                                SDL_Point *d0, SDL_Point *d1, SDL_Point *d2,
-                                SDL_Color c0, SDL_Color c1, SDL_Color c2,
-                                SDL_TextureAddressMode texture_address_mode_u,
-                                SDL_TextureAddressMode texture_address_mode_v);
+typedef struct GeometryFillData
+{
+    SDL_Point dst;
+    SDL_Color color;
+} GeometryFillData;
+
+typedef struct GeometryCopyData
+{
+    SDL_Point src;
+    SDL_Point dst;
+    SDL_Color color;
+} GeometryCopyData;
+
+// Draw count / 3 triangles, with vertex positions in fixed point
+extern bool SDL_SW_FillTriangles(SDL_Surface *dst, const GeometryFillData *verts, int count, SDL_BlendMode blend);
+
+extern bool SDL_SW_BlitTriangles(SDL_Surface *src, SDL_Surface *dst, const GeometryCopyData *verts, int count,
+                                 SDL_TextureAddressMode texture_address_mode_u,
+                                 SDL_TextureAddressMode texture_address_mode_v);
 
 extern void trianglepoint_2_fixedpoint(SDL_Point *a);
 
+// Get the pixels covered by count fixed point vertices, stride bytes apart
+extern void SDL_SW_GetTrianglesBounds(const SDL_Point *verts, size_t stride, int count, SDL_Rect *rect);
+
 #endif // SDL_triangle_h_
@@ -0,0 +1,258 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#include "SDL_parallel_c.h"
+#include "../SDL_hints_c.h"
+
+#define MAX_PARALLEL_THREADS 64
+
+typedef struct SDL_ParallelJob
+{
+    SDL_ParallelFunc func;
+    void *userdata;
+    int count;
+    int num_threads;    // workers with a slot at or above this leave the job alone
+    int next_item;      // protected by parallel_lock
+    int finished_items; // protected by parallel_lock
+    bool failed;        // protected by parallel_lock
+    char error[256];    // the error of the first item that failed
+    struct SDL_ParallelJob *prev;
+    struct SDL_ParallelJob *next;
+} SDL_ParallelJob;
+
+static SDL_InitState parallel_init;
+static SDL_Mutex *parallel_lock = NULL;
+static SDL_Condition *parallel_work_condition = NULL; // signaled when a job is queued or on shutdown
+static SDL_Condition *parallel_done_condition = NULL; // signaled when the last item of a job finishes
+static SDL_ParallelJob *parallel_jobs = NULL;
+static SDL_ParallelJob *parallel_jobs_tail = NULL;
+static SDL_Thread *parallel_threads[MAX_PARALLEL_THREADS - 1];
+static int num_parallel_threads = 0;
+static bool stop_parallel = false;
+static SDL_TLSID parallel_tls; // set while a thread is running items, so nested work runs serially
+
+int SDL_GetParallelThreadCount(void)
+{
+    int num_threads;
+
+    if (SDL_GetTLS(&parallel_tls)) {
+        // Nested work runs serially on this thread
+        return 1;
+    }
+
+    num_threads = SDL_GetStringInteger(SDL_GetHint(SDL_HINT_WORKER_THREADS), 0);
+    if (num_threads <= 0) {
+        num_threads = SDL_GetNumLogicalCPUCores();
+    }
+    return SDL_clamp(num_threads, 1, MAX_PARALLEL_THREADS);
+}
+
+// This is called with parallel_lock held
+static void UnlinkParallelJob(SDL_ParallelJob *job)
+{
+    if (job->prev) {
+        job->prev->next = job->next;
+    } else {
+        parallel_jobs = job->next;
+    }
+    if (job->next) {
+        job->next->prev = job->prev;
+    } else {
+        parallel_jobs_tail = job->prev;
+    }
+    job->prev = job->next = NULL;
+}
+
+// This is called with parallel_lock held, which is released while the item runs
+static void RunParallelItem(SDL_ParallelJob *job, int slot)
+{
+    const int item = job->next_item++;
+    bool result;
+
+    if (job->next_item == job->count) {
+        // Every item has been handed out, nobody else needs to find this job
+        UnlinkParallelJob(job);
+    }
+
+    SDL_UnlockMutex(parallel_lock);
+    result = job->func(job->userdata, item, slot);
+    SDL_LockMutex(parallel_lock);
+
+    if (!result && !job->failed) {
+        job->failed = true;
+        SDL_strlcpy(job->error, SDL_GetError(), sizeof(job->error));
+    }
+    if (++job->finished_items == job->count) {
+        SDL_BroadcastCondition(parallel_done_condition);
+    }
+}
+
+static int SDLCALL ParallelWorker(void *data)
+{
+    const int slot = (int)(intptr_t)data;
+
+    SDL_SetTLS(&parallel_tls, &parallel_tls, NULL);
+
+    SDL_LockMutex(parallel_lock);
+    while (!stop_parallel) {
+        SDL_ParallelJob *job;
+
+        for (job = parallel_jobs; job; job = job->next) {
+            if (slot < job->num_threads) {
+                break;
+            }
+        }
+        if (job) {
+            RunParallelItem(job, slot);
+        } else {
+            SDL_WaitCondition(parallel_work_condition, parallel_lock);
+        }
+    }
+    SDL_UnlockMutex(parallel_lock);
+
+    return 0;
+}
+
+static bool PrepareParallel(int num_threads)
+{
+    if (SDL_ShouldInit(&parallel_init)) {
+        bool okay = true;
+
+        stop_parallel = false;
+        okay = (okay && ((parallel_lock = SDL_CreateMutex()) != NULL));
+        okay = (okay && ((parallel_work_condition = SDL_CreateCondition()) != NULL));
+        okay = (okay && ((parallel_done_condition = SDL_CreateCondition()) != NULL));
+
+        if (!okay) {
+            SDL_DestroyCondition(parallel_done_condition);
+            parallel_done_condition = NULL;
+            SDL_DestroyCondition(parallel_work_condition);
+            parallel_work_condition = NULL;
+            SDL_DestroyMutex(parallel_lock);
+            parallel_lock = NULL;
+        }
+
+        SDL_SetInitialized(&parallel_init, okay);
+    }
+    if (!parallel_lock) {
+        return false;
+    }
+
+    // The calling thread is slot 0, start workers for the others if we don't have them yet
+    SDL_LockMutex(parallel_lock);
+    while (num_parallel_threads < (num_threads - 1)) {
+        const int slot = num_parallel_threads + 1;
+        char threadname[32];
+        SDL_Thread *thread;
+
+        SDL_snprintf(threadname, sizeof(threadname), "SDLworker%d", slot);
+        thread = SDL_CreateThread(ParallelWorker, threadname, (void *)(intptr_t)slot);
+        if (!thread) {
+            // That's okay, the calling thread will pick up the slack
+            break;
+        }
+        parallel_threads[num_parallel_threads++] = thread;
+    }
+    SDL_UnlockMutex(parallel_lock);
+
+    return true;
+}
+
+bool SDL_RunParallel(SDL_ParallelFunc func, void *userdata, int count, int num_threads)
+{
+    SDL_ParallelJob job;
+    int item;
+
+    num_threads = SDL_min(num_threads, MAX_PARALLEL_THREADS);
+
+    if (count <= 1 || num_threads <= 1 || SDL_GetTLS(&parallel_tls) || !PrepareParallel(num_threads)) {
+        for (item = 0; item < count; ++item) {
+            if (!func(userdata, item, 0)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    SDL_zero(job);
+    job.func = func;
+    job.userdata = userdata;
+    job.count = count;
+    job.num_threads = num_threads;
+
+    SDL_SetTLS(&parallel_tls, &parallel_tls, NULL);
+    SDL_LockMutex(parallel_lock);
+
+    job.prev = parallel_jobs_tail;
+    if (parallel_jobs_tail) {
+        parallel_jobs_tail->next = &job;
+    } else {
+        parallel_jobs = &job;
+    }
+    parallel_jobs_tail = &job;
+    SDL_BroadcastCondition(parallel_work_condition);
+
+    // Work on our own job until every item has been handed out, then wait for the stragglers
+    while (job.next_item < job.count) {
+        RunParallelItem(&job, 0);
+    }
+    while (job.finished_items < job.count) {
+        SDL_WaitCondition(parallel_done_condition, parallel_lock);
+    }
+
+    SDL_UnlockMutex(parallel_lock);
+    SDL_SetTLS(&parallel_tls, NULL, NULL);
+
+    if (job.failed) {
+        return SDL_SetError("%s", job.error);
+    }
+    return true;
+}
+
+void SDL_QuitParallel(void)
+{
+    int i;
+
+    if (!SDL_ShouldQuit(&parallel_init)) {
+        return;
+    }
+
+    SDL_LockMutex(parallel_lock);
+    stop_parallel = true;
+    SDL_BroadcastCondition(parallel_work_condition);
+    SDL_UnlockMutex(parallel_lock);
+
+    for (i = 0; i < num_parallel_threads; ++i) {
+        SDL_WaitThread(parallel_threads[i], NULL);
+        parallel_threads[i] = NULL;
+    }
+    num_parallel_threads = 0;
+
+    SDL_DestroyCondition(parallel_done_condition);
+    parallel_done_condition = NULL;
+    SDL_DestroyCondition(parallel_work_condition);
+    parallel_work_condition = NULL;
+    SDL_DestroyMutex(parallel_lock);
+    parallel_lock = NULL;
+
+    SDL_SetInitialized(&parallel_init, false);
+}
@@ -0,0 +1,52 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#ifndef SDL_parallel_c_h_
+#define SDL_parallel_c_h_
+
+/* A pool of worker threads for splitting up CPU heavy work.
+ *
+ * The work is split into items that are run in any order and on any thread.
+ * Each call gets a thread slot, which is unique among the threads running
+ * items of the same job at the same time and less than the thread count
+ * passed to SDL_RunParallel(), so it can be used to index per-thread scratch
+ * memory.
+ *
+ * If an item fails, it should set the SDL error and return false.
+ */
+typedef bool (*SDL_ParallelFunc)(void *userdata, int item, int slot);
+
+/* Get the number of threads that SDL_RunParallel() should use, including the
+ * calling thread. This is 1 while running an item, since nested jobs are run
+ * serially.
+ */
+extern int SDL_GetParallelThreadCount(void);
+
+/* Run func for every item in [0, count) on up to num_threads threads, and
+ * wait for them to finish. If any item fails, this returns false with the
+ * error of the first failure set on the calling thread.
+ */
+extern bool SDL_RunParallel(SDL_ParallelFunc func, void *userdata, int count, int num_threads);
+
+extern void SDL_QuitParallel(void);
+
+#endif // SDL_parallel_c_h_
@@ -85,6 +85,14 @@
  *
  *   The end of the sequence is marked by a zero <skip>,<run> pair at the
  *   beginning of an opaque line.
+ *
+ * Row index:
+ *
+ *   Both encodings are preceded by the target SDL_PixelFormat value and a
+ *   table of surface->h Uint32 offsets, one per scan line, from the start of
+ *   the encoded data to the first segment of that line. Lines past the last
+ *   non-blank line point at the end marker. Blits clipped at the top look up
+ *   their first visible line directly instead of decoding the lines above it.
  */
 
 #include "SDL_sysvideo.h"
@@ -95,6 +103,85 @@
 #define PIXEL_COPY(to, from, len, bpp) \
     SDL_memcpy(to, from, (size_t)(len) * (bpp))
 
+// The row index follows the destination format at the start of the encoded buffer
+#define RLE_ROW_INDEX(data) ((Uint32 *)((Uint8 *)(data) + sizeof(SDL_PixelFormat)))
+
+// Get the encoded data for scan line y of an RLE surface
+static Uint8 *RLEGetRow(SDL_Surface *surface, int y)
+{
+    Uint32 *index = RLE_ROW_INDEX(surface->map.data);
+    return (Uint8 *)(index + surface->h) + index[y];
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static SDL_INLINE int hasSSE2(void)
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasSSE2();
+    return val;
+}
+
+// The low 32 bits of a lane-wise multiplication, like unsigned multiplication in C
+static SDL_INLINE __m128i SDL_TARGETING("sse2") MULLO_EPI32_SSE2(__m128i a, __m128i b)
+{
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+/*
+ * Four pixels of the 0x00rrggbb blend below, computed with exactly the same
+ * 32-bit arithmetic so the results match the scalar code bit for bit.
+ */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") BLEND4_888_SSE2(__m128i s, __m128i d, __m128i alpha)
+{
+    const __m128i rbmask = _mm_set1_epi32(0xff00ff);
+    const __m128i gmask = _mm_set1_epi32(0xff00);
+    __m128i s1 = _mm_and_si128(s, rbmask);
+    __m128i d1 = _mm_and_si128(d, rbmask);
+    d1 = _mm_add_epi32(d1, _mm_srli_epi32(MULLO_EPI32_SSE2(_mm_sub_epi32(s1, d1), alpha), 8));
+    d1 = _mm_and_si128(d1, rbmask);
+    s = _mm_and_si128(s, gmask);
+    d = _mm_and_si128(d, gmask);
+    d = _mm_add_epi32(d, _mm_srli_epi32(MULLO_EPI32_SSE2(_mm_sub_epi32(s, d), alpha), 8));
+    d = _mm_and_si128(d, gmask);
+    return _mm_or_si128(d1, d);
+}
+
+// Blend a run with per-surface alpha, returns the number of pixels done
+static int SDL_TARGETING("sse2") BlendRun32_888_SSE2(Uint32 *dst, const Uint32 *src, int n, unsigned alpha)
+{
+    const __m128i valpha = _mm_set1_epi32((int)alpha);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        _mm_storeu_si128((__m128i *)(dst + i), BLEND4_888_SSE2(s, d, valpha));
+    }
+    return i;
+}
+
+// Blend a run of translucent pixels with alpha in the top byte, returns the number of pixels done
+static int SDL_TARGETING("sse2") BlendTranslRun32_888_SSE2(Uint32 *dst, const Uint32 *src, int n)
+{
+    const __m128i amask = _mm_set1_epi32((int)0xff000000);
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+        d = BLEND4_888_SSE2(s, d, _mm_srli_epi32(s, 24));
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(d, amask));
+    }
+    return i;
+}
+#endif // SDL_SSE2_INTRINSICS
+
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
  */
@@ -109,23 +196,30 @@
  * of each component, so the bits from the multiplication don't collide.
  * This can be used for any RGB permutation of course.
  */
-#define ALPHA_BLIT32_888(to, from, length, bpp, alpha)       \
-    do {                                                     \
-        int i;                                               \
-        Uint32 *src = (Uint32 *)(from);                      \
-        Uint32 *dst = (Uint32 *)(to);                        \
-        for (i = 0; i < (int)(length); i++) {                \
-            Uint32 s = *src++;                               \
-            Uint32 d = *dst;                                 \
-            Uint32 s1 = s & 0xff00ff;                        \
-            Uint32 d1 = d & 0xff00ff;                        \
-            d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff; \
-            s &= 0xff00;                                     \
-            d &= 0xff00;                                     \
-            d = (d + ((s - d) * alpha >> 8)) & 0xff00;       \
-            *dst++ = d1 | d;                                 \
-        }                                                    \
-    } while (0)
+static void BlendRun32_888(Uint32 *dst, const Uint32 *src, int n, unsigned alpha)
+{
+    int i = 0;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (n >= 4 && hasSSE2()) {
+        i = BlendRun32_888_SSE2(dst, src, n, alpha);
+    }
+#endif
+    for (; i < n; i++) {
+        Uint32 s = src[i];
+        Uint32 d = dst[i];
+        Uint32 s1 = s & 0xff00ff;
+        Uint32 d1 = d & 0xff00ff;
+        d1 = (d1 + ((s1 - d1) * alpha >> 8)) & 0xff00ff;
+        s &= 0xff00;
+        d &= 0xff00;
+        d = (d + ((s - d) * alpha >> 8)) & 0xff00;
+        dst[i] = d1 | d;
+    }
+}
+
+#define ALPHA_BLIT32_888(to, from, length, bpp, alpha) \
+    BlendRun32_888((Uint32 *)(to), (const Uint32 *)(from), (int)(length), alpha)
 
 /*
  * For 16bpp pixels we can go a step further: put the middle component
@@ -461,50 +555,8 @@ static bool SDLCALL SDL_RLEBlit(SDL_Surface *surf_src, const SDL_Rect *srcrect,
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *)surf_dst->pixels + y * surf_dst->pitch + x * surf_src->fmt->bytes_per_pixel;
-    srcbuf = (Uint8 *)surf_src->map.data + sizeof(SDL_PixelFormat);
-
-    {
-        // skip lines at the top if necessary
-        int vskip = srcrect->y;
-        int ofs = 0;
-        if (vskip) {
-
-#define RLESKIP(bpp, Type)          \
-    for (;;) {                      \
-        int run;                    \
-        ofs += *(Type *)srcbuf;     \
-        run = ((Type *)srcbuf)[1];  \
-        srcbuf += sizeof(Type) * 2; \
-        if (run) {                  \
-            srcbuf += run * bpp;    \
-            ofs += run;             \
-        } else if (!ofs)            \
-            goto done;              \
-        if (ofs == w) {             \
-            ofs = 0;                \
-            if (!--vskip)           \
-                break;              \
-        }                           \
-    }
-
-            switch (surf_src->fmt->bytes_per_pixel) {
-            case 1:
-                RLESKIP(1, Uint8);
-                break;
-            case 2:
-                RLESKIP(2, Uint8);
-                break;
-            case 3:
-                RLESKIP(3, Uint8);
-                break;
-            case 4:
-                RLESKIP(4, Uint16);
-                break;
-            }
-
-#undef RLESKIP
-        }
-    }
+    // jump directly to the first visible line
+    srcbuf = RLEGetRow(surf_src, srcrect->y);
 
     alpha = surf_src->map.info.a;
     // if left or right edge clipping needed, call clip blit
@@ -542,7 +594,6 @@ static bool SDLCALL SDL_RLEBlit(SDL_Surface *surf_src, const SDL_Rect *srcrect,
 #undef RLEBLIT
     }
 
-done:
     // Unlock the destination if necessary
     if (SDL_MUSTLOCK(surf_dst)) {
         SDL_UnlockSurface(surf_dst);
@@ -603,6 +654,35 @@ done:
         dst = (Uint16)(d | d >> 16);       \
     } while (0)
 
+/*
+ * Blend a whole run of translucent pixels
+ */
+#define BLIT_TRANSL_RUN(src, dst, n, do_blend) \
+    do {                                       \
+        int i;                                 \
+        for (i = 0; i < (n); i++)              \
+            do_blend((src)[i], (dst)[i]);      \
+    } while (0)
+
+#define BLIT_TRANSL_RUN_565(src, dst, n) BLIT_TRANSL_RUN(src, dst, n, BLIT_TRANSL_565)
+#define BLIT_TRANSL_RUN_555(src, dst, n) BLIT_TRANSL_RUN(src, dst, n, BLIT_TRANSL_555)
+
+static void BlendTranslRun32_888(Uint32 *dst, const Uint32 *src, int n)
+{
+    int i = 0;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (n >= 4 && hasSSE2()) {
+        i = BlendTranslRun32_888_SSE2(dst, src, n);
+    }
+#endif
+    for (; i < n; i++) {
+        BLIT_TRANSL_888(src[i], dst[i]);
+    }
+}
+
+#define BLIT_TRANSL_RUN_888(src, dst, n) BlendTranslRun32_888(dst, src, n)
+
 // blit a pixel-alpha RLE surface clipped at the right and/or left edges
 static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
                              Uint8 *dstbuf, const SDL_Rect *srcrect)
@@ -611,7 +691,7 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
     /*
      * clipped blitter: Ptype is the destination pixel type,
      * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * to blend a run of pixels.
      */
 #define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)                          \
     do {                                                                  \
@@ -670,9 +750,7 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
                     if (crun > 0) {                                       \
                         Ptype *dst = (Ptype *)dstbuf + cofs;              \
                         Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-                        int i;                                            \
-                        for (i = 0; i < crun; i++)                        \
-                            do_blend(src[i], dst[i]);                     \
+                        do_blend(src, dst, crun);                         \
                     }                                                     \
                     srcbuf += run * 4;                                    \
                     ofs += run;                                           \
@@ -685,13 +763,13 @@ static void RLEAlphaClipBlit(int w, Uint8 *srcbuf, SDL_Surface *surf_dst,
     switch (df->bytes_per_pixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
         } else {
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
         }
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
         break;
     }
 }
@@ -715,65 +793,8 @@ static bool SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, const SDL_Rect *srcr
     x = dstrect->x;
     y = dstrect->y;
     dstbuf = (Uint8 *)surf_dst->pixels + y * surf_dst->pitch + x * df->bytes_per_pixel;
-    srcbuf = (Uint8 *)surf_src->map.data + sizeof(SDL_PixelFormat);
-
-    {
-        // skip lines at the top if necessary
-        int vskip = srcrect->y;
-        if (vskip) {
-            int ofs;
-            if (df->bytes_per_pixel == 2) {
-                // the 16/32 interleaved format
-                do {
-                    // skip opaque line
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += srcbuf[0];
-                        run = srcbuf[1];
-                        srcbuf += 2;
-                        if (run) {
-                            srcbuf += 2 * run;
-                            ofs += run;
-                        } else if (ofs == 0) {
-                            goto done;
-                        }
-                    } while (ofs < w);
-
-                    // skip padding
-                    srcbuf += (uintptr_t)srcbuf & 2;
-
-                    // skip translucent line
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *)srcbuf)[0];
-                        run = ((Uint16 *)srcbuf)[1];
-                        srcbuf += 4 * (run + 1);
-                        ofs += run;
-                    } while (ofs < w);
-                } while (--vskip);
-            } else {
-                // the 32/32 interleaved format
-                vskip <<= 1; // opaque and translucent have same format
-                do {
-                    ofs = 0;
-                    do {
-                        int run;
-                        ofs += ((Uint16 *)srcbuf)[0];
-                        run = ((Uint16 *)srcbuf)[1];
-                        srcbuf += 4;
-                        if (run) {
-                            srcbuf += 4 * run;
-                            ofs += run;
-                        } else if (ofs == 0) {
-                            goto done;
-                        }
-                    } while (ofs < w);
-                } while (--vskip);
-            }
-        }
-    }
+    // jump directly to the first visible line
+    srcbuf = RLEGetRow(surf_src, srcrect->y);
 
     // if left or right edge clipping needed, call clip blit
     if (srcrect->x || srcrect->w != surf_src->w) {
@@ -783,7 +804,7 @@ static bool SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, const SDL_Rect *srcr
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
          * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * macro to blend a run of pixels.
          */
 #define RLEALPHABLIT(Ptype, Ctype, do_blend)                         \
     do {                                                             \
@@ -817,13 +838,8 @@ static bool SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, const SDL_Rect *srcr
                 srcbuf += 4;                                         \
                 if (run) {                                           \
                     Ptype *dst = (Ptype *)dstbuf + ofs;              \
-                    unsigned i;                                      \
-                    for (i = 0; i < run; i++) {                      \
-                        Uint32 src = *(Uint32 *)srcbuf;              \
-                        do_blend(src, *dst);                         \
-                        srcbuf += 4;                                 \
-                        dst++;                                       \
-                    }                                                \
+                    do_blend((Uint32 *)srcbuf, dst, (int)run);       \
+                    srcbuf += run * 4;                               \
                     ofs += run;                                      \
                 }                                                    \
             } while (ofs < w);                                       \
@@ -834,13 +850,13 @@ static bool SDLCALL SDL_RLEAlphaBlit(SDL_Surface *surf_src, const SDL_Rect *srcr
         switch (df->bytes_per_pixel) {
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_565);
             } else {
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_RUN_555);
             }
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_RUN_888);
             break;
         }
     }
@@ -936,6 +952,27 @@ static int copy_32(void *dst, const Uint32 *src, int n,
 #define ISTRANSL(pixel, fmt) \
     ((unsigned)((((pixel)&fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
 
+// point the lines after the last non-blank line at the end marker
+static void RLEClampRowIndex(Uint32 *rowindex, int h, Uint32 end)
+{
+    int y;
+    for (y = 0; y < h; y++) {
+        if (rowindex[y] > end) {
+            rowindex[y] = end;
+        }
+    }
+}
+
+static void RLEReportMemoryUsage(SDL_Surface *surface, ptrdiff_t size)
+{
+    const size_t unencoded = (size_t)surface->pitch * surface->h;
+
+    SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "RLE: encoded %dx%d %s surface in %d bytes (%d bytes row index), %d%% of %d unencoded bytes",
+                 surface->w, surface->h, SDL_GetPixelFormatName(surface->format),
+                 (int)size, (int)(surface->h * sizeof(Uint32)),
+                 unencoded ? (int)(size * 100 / unencoded) : 0, (int)unencoded);
+}
+
 // convert surface to be quickly alpha-blittable onto dest, if possible
 static bool RLEAlphaSurface(SDL_Surface *surface)
 {
@@ -945,7 +982,8 @@ static bool RLEAlphaSurface(SDL_Surface *surface)
     int max_opaque_run;
     int max_transl_run = 65535;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *rledata, *dst;
+    Uint32 *rowindex;
     int (*copy_opaque)(void *, const Uint32 *, int,
                        const SDL_PixelFormatDetails *, const SDL_PixelFormatDetails *);
     int (*copy_transl)(void *, const Uint32 *, int,
@@ -1007,14 +1045,16 @@ static bool RLEAlphaSurface(SDL_Surface *surface)
         return false; // anything else unsupported right now
     }
 
-    maxsize += sizeof(SDL_PixelFormat);
+    maxsize += sizeof(SDL_PixelFormat) + surface->h * sizeof(Uint32);
     rlebuf = (Uint8 *)SDL_malloc(maxsize);
     if (!rlebuf) {
         return false;
     }
     // save the destination format so we can undo the encoding later
     *(SDL_PixelFormat *)rlebuf = dest->format;
-    dst = rlebuf + sizeof(SDL_PixelFormat);
+    rowindex = RLE_ROW_INDEX(rlebuf);
+    rledata = (Uint8 *)(rowindex + surface->h);
+    dst = rledata;
 
     // Do the actual encoding
     {
@@ -1043,6 +1083,7 @@ static bool RLEAlphaSurface(SDL_Surface *surface)
         for (y = 0; y < h; y++) {
             int runstart, skipstart;
             int blankline = 0;
+            rowindex[y] = (Uint32)(dst - rledata);
             // First encode all opaque pixels of a scan line
             x = 0;
             do {
@@ -1120,6 +1161,7 @@ static bool RLEAlphaSurface(SDL_Surface *surface)
             src += surface->pitch >> 2;
         }
         dst = lastline; // back up past trailing blank lines
+        RLEClampRowIndex(rowindex, h, (Uint32)(dst - rledata));
         ADD_OPAQUE_COUNTS(0, 0);
     }
 
@@ -1134,6 +1176,7 @@ static bool RLEAlphaSurface(SDL_Surface *surface)
         }
         surface->map.data = p;
     }
+    RLEReportMemoryUsage(surface, dst - rlebuf);
 
     return true;
 }
@@ -1171,7 +1214,8 @@ static const getpix_func getpixes[4] = {
 static bool RLEColorkeySurface(SDL_Surface *surface)
 {
     SDL_Surface *dest;
-    Uint8 *rlebuf, *dst;
+    Uint8 *rlebuf, *rledata, *dst;
+    Uint32 *rowindex;
     int maxn;
     int y;
     Uint8 *srcbuf, *lastline;
@@ -1207,18 +1251,20 @@ static bool RLEColorkeySurface(SDL_Surface *surface)
         return false;
     }
 
-    maxsize += sizeof(SDL_PixelFormat);
+    maxsize += sizeof(SDL_PixelFormat) + surface->h * sizeof(Uint32);
     rlebuf = (Uint8 *)SDL_malloc(maxsize);
     if (!rlebuf) {
         return false;
     }
     // save the destination format so we can undo the encoding later
     *(SDL_PixelFormat *)rlebuf = dest->format;
+    rowindex = RLE_ROW_INDEX(rlebuf);
+    rledata = (Uint8 *)(rowindex + surface->h);
 
     // Set up the conversion
     srcbuf = (Uint8 *)surface->pixels;
     maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf + sizeof(SDL_PixelFormat);
+    dst = rledata;
     rgbmask = ~surface->fmt->Amask;
     ckey = surface->map.info.colorkey & rgbmask;
     lastline = dst;
@@ -1240,6 +1286,7 @@ static bool RLEColorkeySurface(SDL_Surface *surface)
     for (y = 0; y < h; y++) {
         int x = 0;
         int blankline = 0;
+        rowindex[y] = (Uint32)(dst - rledata);
         do {
             int run, skip;
             int len;
@@ -1287,6 +1334,7 @@ static bool RLEColorkeySurface(SDL_Surface *surface)
         srcbuf += surface->pitch;
     }
     dst = lastline; // back up bast trailing blank lines
+    RLEClampRowIndex(rowindex, h, (Uint32)(dst - rledata));
     ADD_COUNTS(0, 0);
 
 #undef ADD_COUNTS
@@ -1300,6 +1348,7 @@ static bool RLEColorkeySurface(SDL_Surface *surface)
         }
         surface->map.data = p;
     }
+    RLEReportMemoryUsage(surface, dst - rlebuf);
 
     return true;
 }
@@ -63,90 +63,318 @@
 #define LCS_GM_GRAPHICS 0x00000002
 #endif
 
+// Rows are read and written in chunks of about this size
+#define BMP_CHUNK_SIZE (256 * 1024)
+
+// Compressed data is read through a small buffer instead of a byte at a time
+typedef struct
+{
+    SDL_IOStream *src;
+    Sint64 offset;  // the stream position of the start of the buffer
+    size_t pos;
+    size_t len;
+    Uint8 data[4096];
+} BMPReader;
+
+static bool ReadBMPBytes(BMPReader *reader, Uint8 *out, size_t size)
+{
+    while (size > 0) {
+        size_t count;
+
+        if (reader->pos == reader->len) {
+            reader->offset += reader->len;
+            reader->pos = 0;
+            reader->len = SDL_ReadIO(reader->src, reader->data, sizeof(reader->data));
+            if (reader->len == 0) {
+                return false;
+            }
+        }
+        count = SDL_min(size, reader->len - reader->pos);
+        SDL_memcpy(out, &reader->data[reader->pos], count);
+        reader->pos += count;
+        out += count;
+        size -= count;
+    }
+    return true;
+}
+
+// Set count pixels starting at x to the alternating nibbles of value, clipped to the row
+static void SetRle4Pixels(Uint8 *row, int x, int count, Uint8 value, int width)
+{
+    if (x < 0 || x >= width) {
+        return;
+    }
+    count = SDL_min(count, width - x);
+
+    if ((x & 1) && count > 0) {
+        // The first pixel is in a low nibble, after that the nibbles are swapped
+        row[x / 2] = (row[x / 2] & 0xF0) | (value >> 4);
+        value = (Uint8)((value << 4) | (value >> 4));
+        ++x;
+        --count;
+    }
+    SDL_memset(&row[x / 2], value, count / 2);
+    if (count & 1) {
+        const int last = x + count - 1;
+        row[last / 2] = (row[last / 2] & 0x0F) | (value & 0xF0);
+    }
+}
+
+// Copy count pixels of packed nibbles to x, clipped to the row
+static void CopyRle4Pixels(Uint8 *row, int x, int count, const Uint8 *pixels, int width)
+{
+    int i;
+
+    if (x < 0 || x >= width) {
+        return;
+    }
+    count = SDL_min(count, width - x);
+
+    if (!(x & 1)) {
+        SDL_memcpy(&row[x / 2], pixels, count / 2);
+        if (count & 1) {
+            row[(x + count - 1) / 2] = (row[(x + count - 1) / 2] & 0x0F) | (pixels[count / 2] & 0xF0);
+        }
+        return;
+    }
+    for (i = 0; i < count; ++i) {
+        const Uint8 pixel = (i & 1) ? (pixels[i / 2] & 0x0F) : (pixels[i / 2] >> 4);
+        const int dst = x + i;
+
+        if (dst & 1) {
+            row[dst / 2] = (row[dst / 2] & 0xF0) | pixel;
+        } else {
+            row[dst / 2] = (row[dst / 2] & 0x0F) | (Uint8)(pixel << 4);
+        }
+    }
+}
+
 static bool readRlePixels(SDL_Surface *surface, SDL_IOStream *src, int isRle8)
 {
     /*
     | Sets the surface pixels from src.  A bmp image is upside down.
+    | Pixels outside the image are dropped.
     */
-    int pitch = surface->pitch;
-    int height = surface->h;
-    Uint8 *start = (Uint8 *)surface->pixels;
-    Uint8 *end = start + (height * pitch);
-    Uint8 *bits = end - pitch, *spot;
-    int ofs = 0;
-    Uint8 ch;
-    Uint8 needsPad;
-    const int pixels_per_byte = (isRle8 ? 1 : 2);
-
-#define COPY_PIXEL(x)                \
-    spot = &bits[ofs++];             \
-    if (spot >= start && spot < end) \
-        *spot = (x)
+    BMPReader reader;
+    Uint8 pixels[256];
+    int x = 0;
+    int y = surface->h - 1;
+    bool result = false;
+
+    reader.src = src;
+    reader.offset = SDL_TellIO(src);
+    reader.pos = 0;
+    reader.len = 0;
+    if (reader.offset < 0) {
+        return false;
+    }
 
     for (;;) {
-        if (!SDL_ReadU8(src, &ch)) {
-            return false;
+        Uint8 code[2];
+        Uint8 *row = (y >= 0 && y < surface->h) ? (Uint8 *)surface->pixels + y * surface->pitch : NULL;
+
+        if (!ReadBMPBytes(&reader, code, 2)) {
+            break;
         }
         /*
         | encoded mode starts with a run length, and then a byte
         | with two colour indexes to alternate between for the run
         */
-        if (ch) {
-            Uint8 pixelvalue;
-            if (!SDL_ReadU8(src, &pixelvalue)) {
-                return false;
+        if (code[0]) {
+            if (row) {
+                if (isRle8) {
+                    if (x >= 0 && x < surface->w) {
+                        SDL_memset(&row[x], code[1], SDL_min(code[0], surface->w - x));
+                    }
+                } else {
+                    SetRle4Pixels(row, x, code[0], code[1], surface->w);
+                }
             }
-            ch /= pixels_per_byte;
-            do {
-                COPY_PIXEL(pixelvalue);
-            } while (--ch);
-        } else {
-            /*
-            | A leading zero is an escape; it may signal the end of the bitmap,
-            | a cursor move, or some absolute data.
-            | zero tag may be absolute mode or an escape
-            */
-            if (!SDL_ReadU8(src, &ch)) {
-                return false;
+            x += code[0];
+            continue;
+        }
+
+        /*
+        | A leading zero is an escape; it may signal the end of the bitmap,
+        | a cursor move, or some absolute data.
+        */
+        if (code[1] == 0) { // end of line
+            x = 0;
+            --y; // go to previous
+        } else if (code[1] == 1) { // end of bitmap
+            result = true; // success!
+            break;
+        } else if (code[1] == 2) { // delta
+            Uint8 delta[2];
+            if (!ReadBMPBytes(&reader, delta, 2)) {
+                break;
             }
-            switch (ch) {
-            case 0: // end of line
-                ofs = 0;
-                bits -= pitch; // go to previous
+            x += delta[0];
+            y -= delta[1];
+        } else { // no compression
+            const int count = code[1];
+            const int size = isRle8 ? count : (count + 1) / 2;
+
+            // absolute runs are padded to an even number of bytes
+            if (!ReadBMPBytes(&reader, pixels, size + (size & 1))) {
                 break;
-            case 1:               // end of bitmap
-                return true; // success!
-            case 2:               // delta
-                if (!SDL_ReadU8(src, &ch)) {
-                    return false;
+            }
+            if (row) {
+                if (isRle8) {
+                    if (x >= 0 && x < surface->w) {
+                        SDL_memcpy(&row[x], pixels, SDL_min(count, surface->w - x));
+                    }
+                } else {
+                    CopyRle4Pixels(row, x, count, pixels, surface->w);
                 }
-                ofs += ch / pixels_per_byte;
+            }
+            x += count;
+        }
+    }
 
-                if (!SDL_ReadU8(src, &ch)) {
-                    return false;
-                }
-                bits -= ((ch / pixels_per_byte) * pitch);
-                break;
-            default: // no compression
-                ch /= pixels_per_byte;
-                needsPad = (ch & 1);
-                do {
-                    Uint8 pixelvalue;
-                    if (!SDL_ReadU8(src, &pixelvalue)) {
-                        return false;
-                    }
-                    COPY_PIXEL(pixelvalue);
-                } while (--ch);
+    // Leave the stream just past the image data, as if it had been read a byte at a time
+    SDL_SeekIO(src, reader.offset + reader.pos, SDL_IO_SEEK_SET);
+    return result;
+}
 
-                // pad at even boundary
-                if (needsPad && !SDL_ReadU8(src, &ch)) {
-                    return false;
-                }
-                break;
+// Read the rows of an uncompressed image, a top-down image is read in large chunks and a bottom-up one a row at a time
+static bool ReadPixelRows(SDL_IOStream *src, Uint8 *pixels, size_t pitch, int height, bool topDown)
+{
+    const int chunk_rows = (int)SDL_clamp(BMP_CHUNK_SIZE / pitch, 1, (size_t)height);
+    int y;
+
+    if (topDown) {
+        for (y = 0; y < height; y += chunk_rows) {
+            const int rows = SDL_min(chunk_rows, height - y);
+            if (SDL_ReadIO(src, pixels + y * pitch, rows * pitch) != rows * pitch) {
+                return false;
+            }
+        }
+    } else {
+        for (y = height; y--;) {
+            if (SDL_ReadIO(src, pixels + y * pitch, pitch) != pitch) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Make a byte shuffle that expands 4 BGR pixels to the 32-bit format, the unused byte is set below
+static void GetExpandShuffle(const SDL_PixelFormatDetails *fmt, Uint8 shuffle[16])
+{
+    int i;
+
+    for (i = 0; i < 4; ++i) {
+        Uint8 *pixel = &shuffle[i * 4];
+        pixel[0] = pixel[1] = pixel[2] = pixel[3] = 0x80;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        pixel[3 - fmt->Rshift / 8] = (Uint8)(i * 3 + 2);
+        pixel[3 - fmt->Gshift / 8] = (Uint8)(i * 3 + 1);
+        pixel[3 - fmt->Bshift / 8] = (Uint8)(i * 3 + 0);
+#else
+        pixel[fmt->Rshift / 8] = (Uint8)(i * 3 + 2);
+        pixel[fmt->Gshift / 8] = (Uint8)(i * 3 + 1);
+        pixel[fmt->Bshift / 8] = (Uint8)(i * 3 + 0);
+#endif
+    }
+}
+
+#ifdef SDL_SSE4_1_INTRINSICS
+static int SDL_TARGETING("sse4.1") ExpandBGRRowSSE41(const Uint8 *src, Uint32 *dst, int width, const Uint8 shuffle[16], Uint32 fill)
+{
+    const __m128i mask = _mm_loadu_si128((const __m128i *)shuffle);
+    const __m128i alpha = _mm_set1_epi32((int)fill);
+    int i;
+
+    // Each load reads 16 bytes for the 12 bytes of 4 pixels, so stop while there's room for the extra 4
+    for (i = 0; i + 6 <= width; i += 4) {
+        const __m128i pixels = _mm_loadu_si128((const __m128i *)(src + i * 3));
+        // This is an SSSE3 instruction
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_shuffle_epi8(pixels, mask), alpha));
+    }
+    return i;
+}
+#endif
+
+// Read the rows of a 24-bit image into a 32-bit RGB surface, expanding them as they're read
+static bool ReadExpandedRows(SDL_IOStream *src, SDL_Surface *surface, bool topDown)
+{
+    const SDL_PixelFormatDetails *fmt = surface->fmt;
+    const size_t src_pitch = ((size_t)surface->w * 3 + 3) & ~3;
+    const int chunk_rows = (int)SDL_clamp(BMP_CHUNK_SIZE / src_pitch, 1, (size_t)surface->h);
+    const Uint32 fill = ~(fmt->Rmask | fmt->Gmask | fmt->Bmask);  // opaque, with the padding bits set like the other loaders
+    Uint8 shuffle[16];
+    Uint8 *chunk;
+    int y, row;
+
+    chunk = (Uint8 *)SDL_malloc(chunk_rows * src_pitch);
+    if (!chunk) {
+        return false;
+    }
+    GetExpandShuffle(fmt, shuffle);
+
+    for (y = 0; y < surface->h; y += chunk_rows) {
+        const int rows = SDL_min(chunk_rows, surface->h - y);
+
+        if (SDL_ReadIO(src, chunk, rows * src_pitch) != rows * src_pitch) {
+            SDL_free(chunk);
+            return false;
+        }
+        for (row = 0; row < rows; ++row) {
+            const int dst_y = topDown ? (y + row) : (surface->h - 1 - (y + row));
+            const Uint8 *s = chunk + row * src_pitch;
+            Uint32 *d = (Uint32 *)((Uint8 *)surface->pixels + dst_y * surface->pitch);
+            int i = 0;
+
+#ifdef SDL_SSE4_1_INTRINSICS
+            if (SDL_HasSSE41()) {
+                i = ExpandBGRRowSSE41(s, d, surface->w, shuffle, fill);
             }
+#endif
+            for (; i < surface->w; ++i) {
+                d[i] = ((Uint32)s[i * 3 + 2] << fmt->Rshift) |
+                       ((Uint32)s[i * 3 + 1] << fmt->Gshift) |
+                       ((Uint32)s[i * 3 + 0] << fmt->Bshift) |
+                       fill;
+            }
+        }
+    }
+    SDL_free(chunk);
+    return true;
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static bool SDL_TARGETING("sse2") CorrectAlphaChannelSSE2(Uint8 *pixels, size_t size)
+{
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+    const __m128i zero = _mm_setzero_si128();
+    size_t i;
+
+    // Check to see if there is any alpha channel data, 64 bytes at a time
+    for (i = 0; i + 64 <= size; i += 64) {
+        __m128i any = _mm_or_si128(_mm_or_si128(_mm_loadu_si128((const __m128i *)(pixels + i)), _mm_loadu_si128((const __m128i *)(pixels + i + 16))),
+                                   _mm_or_si128(_mm_loadu_si128((const __m128i *)(pixels + i + 32)), _mm_loadu_si128((const __m128i *)(pixels + i + 48))));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(_mm_and_si128(any, alpha_mask), zero)) != 0xFFFF) {
+            return true;
+        }
+    }
+    for (; i < size; i += 4) {
+        if (pixels[i + 3] != 0) {
+            return true;
         }
     }
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        __m128i *p = (__m128i *)(pixels + i);
+        _mm_storeu_si128(p, _mm_or_si128(_mm_loadu_si128(p), alpha_mask));
+    }
+    for (; i < size; i += 4) {
+        pixels[i + 3] = SDL_ALPHA_OPAQUE;
+    }
+    return false;
 }
+#endif
 
 static void CorrectAlphaChannel(SDL_Surface *surface)
 {
@@ -160,6 +388,14 @@ static void CorrectAlphaChannel(SDL_Surface *surface)
     Uint8 *alpha = ((Uint8 *)surface->pixels) + alphaChannelOffset;
     Uint8 *end = alpha + surface->h * surface->pitch;
 
+#if defined(SDL_SSE2_INTRINSICS) && (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+    if (SDL_HasSSE2()) {
+        // The rows of a 32-bit surface are packed, so the pixels can be treated as one long row
+        CorrectAlphaChannelSSE2((Uint8 *)surface->pixels, (size_t)surface->h * surface->pitch);
+        return;
+    }
+#endif
+
     while (alpha < end) {
         if (*alpha != 0) {
             hasAlpha = true;
@@ -197,22 +433,21 @@ bool SDL_IsBMP(SDL_IOStream *src)
     return is_BMP;
 }
 
-SDL_Surface *SDL_LoadBMP_IO(SDL_IOStream *src, bool closeio)
+SDL_Surface *SDL_LoadBMP_IOInternal(SDL_IOStream *src, bool closeio, SDL_PixelFormat format)
 {
     bool was_error = true;
     Sint64 fp_offset = 0;
-    int i, pad;
+    int i;
     SDL_Surface *surface;
     Uint32 Rmask = 0;
     Uint32 Gmask = 0;
     Uint32 Bmask = 0;
     Uint32 Amask = 0;
-    Uint8 *bits;
-    Uint8 *top, *end;
     bool topDown;
     bool haveRGBMasks = false;
     bool haveAlphaMask = false;
     bool correctAlpha = false;
+    bool expand = false;
 
     // The Win32 BMP file header (14 bytes)
     // char magic[2];
@@ -428,11 +663,17 @@ SDL_Surface *SDL_LoadBMP_IO(SDL_IOStream *src, bool closeio)
 
     // Create a compatible surface, note that the colors are RGB ordered
     {
-        SDL_PixelFormat format;
+        SDL_PixelFormat image_format;
 
         // Get the pixel format
-        format = SDL_GetPixelFormatForMasks(biBitCount, Rmask, Gmask, Bmask, Amask);
-        surface = SDL_CreateSurface(biWidth, biHeight, format);
+        image_format = SDL_GetPixelFormatForMasks(biBitCount, Rmask, Gmask, Bmask, Amask);
+        if (image_format == SDL_PIXELFORMAT_BGR24 && biCompression == BI_RGB && !SDL_ISPIXELFORMAT_FOURCC(format) &&
+            SDL_PIXELTYPE(format) == SDL_PIXELTYPE_PACKED32 && SDL_PIXELLAYOUT(format) == SDL_PACKEDLAYOUT_8888) {
+            // 24-bit images can be expanded to a 32-bit RGB format while they're read
+            image_format = format;
+            expand = true;
+        }
+        surface = SDL_CreateSurface(biWidth, biHeight, image_format);
 
         if (!surface) {
             goto done;
@@ -469,23 +710,20 @@ SDL_Surface *SDL_LoadBMP_IO(SDL_IOStream *src, bool closeio)
         }
         palette->ncolors = biClrUsed;
 
-        if (biSize == 12) {
-            for (i = 0; i < palette->ncolors; ++i) {
-                if (!SDL_ReadU8(src, &palette->colors[i].b) ||
-                    !SDL_ReadU8(src, &palette->colors[i].g) ||
-                    !SDL_ReadU8(src, &palette->colors[i].r)) {
-                    goto done;
-                }
-                palette->colors[i].a = SDL_ALPHA_OPAQUE;
+        {
+            // Old headers have 3 byte BGR entries, newer ones add a reserved byte
+            const int entry_size = (biSize == 12) ? 3 : 4;
+            Uint8 entries[256 * 4];
+
+            if (SDL_ReadIO(src, entries, (size_t)palette->ncolors * entry_size) != (size_t)palette->ncolors * entry_size) {
+                goto done;
             }
-        } else {
             for (i = 0; i < palette->ncolors; ++i) {
-                if (!SDL_ReadU8(src, &palette->colors[i].b) ||
-                    !SDL_ReadU8(src, &palette->colors[i].g) ||
-                    !SDL_ReadU8(src, &palette->colors[i].r) ||
-                    !SDL_ReadU8(src, &palette->colors[i].a)) {
-                    goto done;
-                }
+                const Uint8 *entry = &entries[i * entry_size];
+
+                palette->colors[i].b = entry[0];
+                palette->colors[i].g = entry[1];
+                palette->colors[i].r = entry[2];
 
                 /* According to Microsoft documentation, the fourth element
                    is reserved and must be zero, so we shouldn't treat it as
@@ -511,19 +749,25 @@ SDL_Surface *SDL_LoadBMP_IO(SDL_IOStream *src, bool closeio)
         was_error = false;
         goto done;
     }
-    top = (Uint8 *)surface->pixels;
-    end = (Uint8 *)surface->pixels + (surface->h * surface->pitch);
-    pad = ((surface->pitch % 4) ? (4 - (surface->pitch % 4)) : 0);
-    if (topDown) {
-        bits = top;
-    } else {
-        bits = end - surface->pitch;
-    }
-    while (bits >= top && bits < end) {
-        if (SDL_ReadIO(src, bits, surface->pitch) != (size_t)surface->pitch) {
+    if (expand) {
+        if (!ReadExpandedRows(src, surface, topDown)) {
             goto done;
         }
-        if (biBitCount == 8 && surface->palette && biClrUsed < (1u << biBitCount)) {
+
+        // Success!
+        was_error = false;
+        goto done;
+    }
+
+    // The rows of the surface are 4 byte aligned, just like the rows of the image
+    if (!ReadPixelRows(src, (Uint8 *)surface->pixels, surface->pitch, surface->h, topDown)) {
+        goto done;
+    }
+    if (biBitCount == 8 && surface->palette && biClrUsed < (1u << biBitCount)) {
+        int y;
+
+        for (y = 0; y < surface->h; ++y) {
+            const Uint8 *bits = (const Uint8 *)surface->pixels + y * surface->pitch;
             for (i = 0; i < surface->w; ++i) {
                 if (bits[i] >= biClrUsed) {
                     SDL_SetError("A BMP image contains a pixel with a color out of the palette");
@@ -531,46 +775,31 @@ SDL_Surface *SDL_LoadBMP_IO(SDL_IOStream *src, bool closeio)
                 }
             }
         }
+    }
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
-        /* Byte-swap the pixels if needed. Note that the 24bpp
-           case has already been taken care of above. */
-        switch (biBitCount) {
-        case 15:
-        case 16:
-        {
-            Uint16 *pix = (Uint16 *)bits;
-            for (i = 0; i < surface->w; i++) {
-                pix[i] = SDL_Swap16(pix[i]);
-            }
-            break;
-        }
-
-        case 32:
-        {
-            Uint32 *pix = (Uint32 *)bits;
-            for (i = 0; i < surface->w; i++) {
-                pix[i] = SDL_Swap32(pix[i]);
-            }
-            break;
-        }
+    /* Byte-swap the pixels if needed. Note that the 24bpp
+       case has already been taken care of above. */
+    switch (biBitCount) {
+    case 15:
+    case 16:
+    {
+        Uint16 *pix = (Uint16 *)surface->pixels;
+        for (i = 0; i < surface->h * surface->pitch / 2; i++) {
+            pix[i] = SDL_Swap16(pix[i]);
         }
-#endif
+        break;
+    }
 
-        // Skip padding bytes, ugh
-        if (pad) {
-            Uint8 padbyte;
-            for (i = 0; i < pad; ++i) {
-                if (!SDL_ReadU8(src, &padbyte)) {
-                    goto done;
-                }
-            }
-        }
-        if (topDown) {
-            bits += surface->pitch;
-        } else {
-            bits -= surface->pitch;
+    case 32:
+    {
+        Uint32 *pix = (Uint32 *)surface->pixels;
+        for (i = 0; i < surface->h * surface->pitch / 4; i++) {
+            pix[i] = SDL_Swap32(pix[i]);
         }
+        break;
     }
+    }
+#endif
     if (correctAlpha) {
         CorrectAlphaChannel(surface);
     }
@@ -591,6 +820,11 @@ done:
     return surface;
 }
 
+SDL_Surface *SDL_LoadBMP_IO(SDL_IOStream *src, bool closeio)
+{
+    return SDL_LoadBMP_IOInternal(src, closeio, SDL_PIXELFORMAT_UNKNOWN);
+}
+
 SDL_Surface *SDL_LoadBMP(const char *file)
 {
     SDL_IOStream *stream = SDL_IOFromFile(file, "rb");
@@ -600,14 +834,102 @@ SDL_Surface *SDL_LoadBMP(const char *file)
     return SDL_LoadBMP_IO(stream, true);
 }
 
+// Make a byte shuffle that packs 4 pixels of a 32-bit RGB format to BGR
+static void GetPackShuffle(const SDL_PixelFormatDetails *fmt, Uint8 shuffle[16])
+{
+    int i;
+
+    SDL_memset(shuffle, 0x80, 16);
+    for (i = 0; i < 4; ++i) {
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        shuffle[i * 3 + 0] = (Uint8)(i * 4 + 3 - fmt->Bshift / 8);
+        shuffle[i * 3 + 1] = (Uint8)(i * 4 + 3 - fmt->Gshift / 8);
+        shuffle[i * 3 + 2] = (Uint8)(i * 4 + 3 - fmt->Rshift / 8);
+#else
+        shuffle[i * 3 + 0] = (Uint8)(i * 4 + fmt->Bshift / 8);
+        shuffle[i * 3 + 1] = (Uint8)(i * 4 + fmt->Gshift / 8);
+        shuffle[i * 3 + 2] = (Uint8)(i * 4 + fmt->Rshift / 8);
+#endif
+    }
+}
+
+#ifdef SDL_SSE4_1_INTRINSICS
+static int SDL_TARGETING("sse4.1") PackBGRRowSSE41(const Uint32 *src, Uint8 *dst, int width, const Uint8 shuffle[16])
+{
+    const __m128i mask = _mm_loadu_si128((const __m128i *)shuffle);
+    int i;
+
+    // Each store writes 16 bytes for the 12 bytes of 4 pixels, the next store overwrites the extra 4
+    for (i = 0; i + 6 <= width; i += 4) {
+        // This is an SSSE3 instruction
+        _mm_storeu_si128((__m128i *)(dst + i * 3), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + i)), mask));
+    }
+    return i;
+}
+#endif
+
+// Write the rows of a surface upside down, a chunk at a time, optionally packing 32-bit RGB pixels to BGR
+static bool WritePixelRows(SDL_IOStream *dst, SDL_Surface *surface, size_t bw, bool pack)
+{
+    const size_t row_size = (bw + 3) & ~3;
+    const int chunk_rows = (int)SDL_clamp(BMP_CHUNK_SIZE / row_size, 1, (size_t)surface->h);
+    const SDL_PixelFormatDetails *fmt = surface->fmt;
+    Uint8 shuffle[16];
+    Uint8 *chunk;
+    int y, row;
+
+    chunk = (Uint8 *)SDL_malloc(chunk_rows * row_size);
+    if (!chunk) {
+        return false;
+    }
+    if (pack) {
+        GetPackShuffle(fmt, shuffle);
+    }
+
+    for (y = surface->h; y > 0;) {
+        const int rows = SDL_min(chunk_rows, y);
+
+        for (row = 0; row < rows; ++row) {
+            const Uint8 *src = (const Uint8 *)surface->pixels + (y - 1 - row) * surface->pitch;
+            Uint8 *out = chunk + row * row_size;
+
+            if (pack) {
+                const Uint32 *pixels = (const Uint32 *)src;
+                int i = 0;
+
+#ifdef SDL_SSE4_1_INTRINSICS
+                if (SDL_HasSSE41()) {
+                    i = PackBGRRowSSE41(pixels, out, surface->w, shuffle);
+                }
+#endif
+                for (; i < surface->w; ++i) {
+                    out[i * 3 + 0] = (Uint8)(pixels[i] >> fmt->Bshift);
+                    out[i * 3 + 1] = (Uint8)(pixels[i] >> fmt->Gshift);
+                    out[i * 3 + 2] = (Uint8)(pixels[i] >> fmt->Rshift);
+                }
+            } else {
+                SDL_memcpy(out, src, bw);
+            }
+            SDL_memset(out + bw, 0, row_size - bw);
+        }
+        if (SDL_WriteIO(dst, chunk, rows * row_size) != rows * row_size) {
+            SDL_free(chunk);
+            return false;
+        }
+        y -= rows;
+    }
+    SDL_free(chunk);
+    return true;
+}
+
 bool SDL_SaveBMP_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
 {
     bool was_error = true;
     Sint64 fp_offset, new_offset;
-    int i, pad;
+    int i;
     SDL_Surface *intermediate_surface = NULL;
-    Uint8 *bits;
     bool save32bit = false;
+    bool pack = false;
     bool saveLegacyBMP = false;
 
     // The Win32 BMP file header (14 bytes)
@@ -677,6 +999,11 @@ bool SDL_SaveBMP_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
     } else if ((surface->format == SDL_PIXELFORMAT_BGR24 && !save32bit) ||
                (surface->format == SDL_PIXELFORMAT_BGRA32 && save32bit)) {
         intermediate_surface = surface;
+    } else if (!save32bit && SDL_PIXELTYPE(surface->format) == SDL_PIXELTYPE_PACKED32 &&
+               SDL_PIXELLAYOUT(surface->format) == SDL_PACKEDLAYOUT_8888) {
+        // 32-bit RGB pixels are packed to BGR as they're written
+        intermediate_surface = surface;
+        pack = true;
     } else {
         SDL_PixelFormat pixel_format;
 
@@ -700,7 +1027,8 @@ bool SDL_SaveBMP_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
     }
 
     if (SDL_LockSurface(intermediate_surface)) {
-        const size_t bw = intermediate_surface->w * intermediate_surface->fmt->bytes_per_pixel;
+        const int bytes_per_pixel = pack ? 3 : intermediate_surface->fmt->bytes_per_pixel;
+        const size_t bw = intermediate_surface->w * bytes_per_pixel;
 
         // Set the BMP file header values
         bfSize = 0; // We'll write this when we're done
@@ -726,9 +1054,9 @@ bool SDL_SaveBMP_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
         biWidth = intermediate_surface->w;
         biHeight = intermediate_surface->h;
         biPlanes = 1;
-        biBitCount = intermediate_surface->fmt->bits_per_pixel;
+        biBitCount = pack ? 24 : intermediate_surface->fmt->bits_per_pixel;
         biCompression = BI_RGB;
-        biSizeImage = intermediate_surface->h * intermediate_surface->pitch;
+        biSizeImage = (Uint32)(intermediate_surface->h * ((bw + 3) & ~3));
         biXPelsPerMeter = 0;
         biYPelsPerMeter = 0;
         if (intermediate_surface->palette) {
@@ -807,16 +1135,18 @@ bool SDL_SaveBMP_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
         if (intermediate_surface->palette) {
             SDL_Color *colors;
             int ncolors;
+            Uint8 entries[256 * 4];
 
             colors = intermediate_surface->palette->colors;
-            ncolors = intermediate_surface->palette->ncolors;
+            ncolors = SDL_min(intermediate_surface->palette->ncolors, 256);
             for (i = 0; i < ncolors; ++i) {
-                if (!SDL_WriteU8(dst, colors[i].b) ||
-                    !SDL_WriteU8(dst, colors[i].g) ||
-                    !SDL_WriteU8(dst, colors[i].r) ||
-                    !SDL_WriteU8(dst, colors[i].a)) {
-                    goto done;
-                }
+                entries[i * 4 + 0] = colors[i].b;
+                entries[i * 4 + 1] = colors[i].g;
+                entries[i * 4 + 2] = colors[i].r;
+                entries[i * 4 + 3] = colors[i].a;
+            }
+            if (SDL_WriteIO(dst, entries, (size_t)ncolors * 4) != (size_t)ncolors * 4) {
+                goto done;
             }
         }
 
@@ -833,21 +1163,8 @@ bool SDL_SaveBMP_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
         }
 
         // Write the bitmap image upside down
-        bits = (Uint8 *)intermediate_surface->pixels + (intermediate_surface->h * intermediate_surface->pitch);
-        pad = ((bw % 4) ? (4 - (bw % 4)) : 0);
-        while (bits > (Uint8 *)intermediate_surface->pixels) {
-            bits -= intermediate_surface->pitch;
-            if (SDL_WriteIO(dst, bits, bw) != bw) {
-                goto done;
-            }
-            if (pad) {
-                const Uint8 padbyte = 0;
-                for (i = 0; i < pad; ++i) {
-                    if (!SDL_WriteU8(dst, padbyte)) {
-                        goto done;
-                    }
-                }
-            }
+        if (!WritePixelRows(dst, intermediate_surface, bw, pack)) {
+            goto done;
         }
 
         // Write the BMP file size
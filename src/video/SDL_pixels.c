@@ -1187,7 +1187,7 @@ void SDL_DitherPalette(SDL_Palette *palette)
 /*
  * Match an RGB value to a particular palette index
  */
-static Uint8 SDL_FindColor(const SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+static Uint8 SDL_FindColorInRange(const SDL_Palette *pal, int first, Uint8 r, Uint8 g, Uint8 b, Uint8 a, unsigned int *smallest_distance)
 {
     // Do colorspace distance matching
     unsigned int smallest;
@@ -1197,7 +1197,7 @@ static Uint8 SDL_FindColor(const SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Ui
     Uint8 pixelvalue = 0;
 
     smallest = ~0U;
-    for (i = 0; i < pal->ncolors; ++i) {
+    for (i = first; i < pal->ncolors; ++i) {
         rd = pal->colors[i].r - r;
         gd = pal->colors[i].g - g;
         bd = pal->colors[i].b - b;
@@ -1206,28 +1206,151 @@ static Uint8 SDL_FindColor(const SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Ui
         if (distance < smallest) {
             pixelvalue = (Uint8)i;
             if (distance == 0) { // Perfect match!
+                smallest = 0;
                 break;
             }
             smallest = distance;
         }
     }
+    *smallest_distance = smallest;
     return pixelvalue;
 }
 
-Uint8 SDL_LookupRGBAColor(SDL_HashTable *palette_map, Uint32 pixelvalue, const SDL_Palette *pal)
+#ifdef SDL_SSE2_INTRINSICS
+/*
+ * Evaluate the squared RGBA distance to four palette entries at a time.
+ * Each lane keeps the first entry with the smallest distance it has seen,
+ * so the result is the same as the scalar search, including ties.
+ */
+static Uint8 SDL_TARGETING("sse2") SDL_FindColor_SSE2(const SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i target = _mm_set_epi16(a, b, g, r, a, b, g, r);
+    const __m128i four = _mm_set1_epi32(4);
+    __m128i index = _mm_set_epi32(3, 2, 1, 0);
+    __m128i smallest = _mm_set1_epi32(SDL_MAX_SINT32);
+    __m128i best = _mm_setzero_si128();
+    SDL_ALIGNED(16) Sint32 distances[4];
+    SDL_ALIGNED(16) Sint32 indices[4];
+    unsigned int tail_distance;
+    Uint8 tail_index;
+    int i, lane, found = -1;
+
+    for (i = 0; i + 4 <= pal->ncolors; i += 4) {
+        __m128i colors = _mm_loadu_si128((const __m128i *)&pal->colors[i]);
+        __m128i d01 = _mm_sub_epi16(_mm_unpacklo_epi8(colors, zero), target);
+        __m128i d23 = _mm_sub_epi16(_mm_unpackhi_epi8(colors, zero), target);
+        __m128i distance, less;
+
+        // { rd*rd + gd*gd, bd*bd + ad*ad } for each entry, then add the halves
+        d01 = _mm_madd_epi16(d01, d01);
+        d23 = _mm_madd_epi16(d23, d23);
+        distance = _mm_add_epi32(
+            _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(d01), _mm_castsi128_ps(d23), _MM_SHUFFLE(2, 0, 2, 0))),
+            _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(d01), _mm_castsi128_ps(d23), _MM_SHUFFLE(3, 1, 3, 1))));
+
+        less = _mm_cmplt_epi32(distance, smallest);
+        smallest = _mm_or_si128(_mm_and_si128(less, distance), _mm_andnot_si128(less, smallest));
+        best = _mm_or_si128(_mm_and_si128(less, index), _mm_andnot_si128(less, best));
+        index = _mm_add_epi32(index, four);
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(distance, zero))) {
+            // Perfect match!
+            break;
+        }
+    }
+
+    _mm_store_si128((__m128i *)distances, smallest);
+    _mm_store_si128((__m128i *)indices, best);
+    for (lane = 0; lane < 4; ++lane) {
+        if (found < 0 || distances[lane] < distances[found] ||
+            (distances[lane] == distances[found] && indices[lane] < indices[found])) {
+            found = lane;
+        }
+    }
+
+    if (distances[found] != 0 && i < pal->ncolors) {
+        // Any remaining entries have higher indices, so they only win when strictly closer
+        tail_index = SDL_FindColorInRange(pal, i, r, g, b, a, &tail_distance);
+        if (tail_distance < (unsigned int)distances[found]) {
+            return tail_index;
+        }
+    }
+    return (Uint8)indices[found];
+}
+
+static SDL_INLINE int hasSSE2(void)
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasSSE2();
+    return val;
+}
+#endif // SDL_SSE2_INTRINSICS
+
+static Uint8 SDL_FindColor(const SDL_Palette *pal, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    unsigned int distance;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (pal->ncolors >= 4 && hasSSE2()) {
+        return SDL_FindColor_SSE2(pal, r, g, b, a);
+    }
+#endif
+    return SDL_FindColorInRange(pal, 0, r, g, b, a, &distance);
+}
+
+/*
+ * A direct mapped cache of RGBA8888 pixel values to palette indices.
+ *
+ * Unlike a hash table this never grows, so converting photos with millions
+ * of unique colors doesn't allocate, and a hit is a single compare.
+ * The cache belongs to a blit map, which is invalidated whenever the
+ * destination palette changes.
+ */
+#define SDL_PALETTE_LOOKUP_BITS 12
+#define SDL_PALETTE_LOOKUP_SIZE (1 << SDL_PALETTE_LOOKUP_BITS)
+#define SDL_PALETTE_LOOKUP_EMPTY 0xFFFF
+
+struct SDL_PaletteLookup
+{
+    Uint32 keys[SDL_PALETTE_LOOKUP_SIZE];
+    Uint16 values[SDL_PALETTE_LOOKUP_SIZE];
+};
+
+SDL_PaletteLookup *SDL_CreatePaletteLookup(void)
+{
+    SDL_PaletteLookup *lookup = (SDL_PaletteLookup *)SDL_malloc(sizeof(*lookup));
+    if (lookup) {
+        SDL_memset(lookup->values, 0xFF, sizeof(lookup->values));
+    }
+    return lookup;
+}
+
+void SDL_DestroyPaletteLookup(SDL_PaletteLookup *lookup)
+{
+    SDL_free(lookup);
+}
+
+Uint8 SDL_LookupRGBAColor(SDL_PaletteLookup *lookup, Uint32 pixelvalue, const SDL_Palette *pal)
 {
     Uint8 color_index = 0;
     if (pal) {
-        const void *value;
-        if (SDL_FindInHashTable(palette_map, (const void *)(uintptr_t)pixelvalue, &value)) {
-            color_index = (Uint8)(uintptr_t)value;
+        const Uint32 slot = (pixelvalue * 0x9E3779B1u) >> (32 - SDL_PALETTE_LOOKUP_BITS);
+        if (lookup && lookup->values[slot] != SDL_PALETTE_LOOKUP_EMPTY && lookup->keys[slot] == pixelvalue) {
+            color_index = (Uint8)lookup->values[slot];
         } else {
             Uint8 r = (Uint8)((pixelvalue >> 24) & 0xFF);
             Uint8 g = (Uint8)((pixelvalue >> 16) & 0xFF);
             Uint8 b = (Uint8)((pixelvalue >>  8) & 0xFF);
             Uint8 a = (Uint8)((pixelvalue >>  0) & 0xFF);
             color_index = SDL_FindColor(pal, r, g, b, a);
-            SDL_InsertIntoHashTable(palette_map, (const void *)(uintptr_t)pixelvalue, (const void *)(uintptr_t)color_index, true);
+            if (lookup) {
+                lookup->keys[slot] = pixelvalue;
+                lookup->values[slot] = color_index;
+            }
         }
     }
     return color_index;
@@ -1545,7 +1668,7 @@ void SDL_InvalidateMap(SDL_BlitMap *map)
         map->info.table = NULL;
     }
     if (map->info.palette_map) {
-        SDL_DestroyHashTable(map->info.palette_map);
+        SDL_DestroyPaletteLookup(map->info.palette_map);
         map->info.palette_map = NULL;
     }
 }
@@ -1601,7 +1724,7 @@ bool SDL_MapSurface(SDL_Surface *src, SDL_Surface *dst)
     } else {
         if (SDL_ISPIXELFORMAT_INDEXED(dstfmt->format)) {
             // BitField --> Palette
-            map->info.palette_map = SDL_CreateHashTable(0, false, SDL_HashID, SDL_KeyMatchID, NULL, NULL);
+            map->info.palette_map = SDL_CreatePaletteLookup();
         } else {
             // BitField --> BitField
             if (srcfmt == dstfmt) {
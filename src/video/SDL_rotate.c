@@ -240,6 +240,244 @@ static void transformSurfaceY90(SDL_Surface *src, SDL_Surface *dst, int angle, i
 
 #undef TRANSFORM_SURFACE_90
 
+/**
+Floor division for possibly negative 64-bit operands.
+*/
+static Sint64 floorDiv(Sint64 a, Sint64 b)
+{
+    Sint64 q = a / b;
+    if ((a % b) != 0 && ((a < 0) != (b < 0))) {
+        --q;
+    }
+    return q;
+}
+
+/**
+Narrows the destination span [*x0, *x1) of a scanline to the pixels whose 16.16 fixed point
+source coordinate (pos + x * inc) >> 16 lies within [lo, hi].
+
+This is exact with respect to the per-pixel check it replaces, so the inner loops
+don't need to test every pixel against the source bounds.
+*/
+static void clipSpan(Sint64 pos, Sint64 inc, int lo, int hi, int *x0, int *x1)
+{
+    const Sint64 minpos = (Sint64)lo << 16;
+    const Sint64 maxpos = ((Sint64)hi << 16) + 0xffff;
+    Sint64 first, last;
+
+    if (lo > hi) {
+        *x1 = *x0;
+        return;
+    }
+
+    if (inc == 0) {
+        if (pos < minpos || pos > maxpos) {
+            *x1 = *x0;
+        }
+        return;
+    }
+
+    if (inc > 0) {
+        first = -floorDiv(pos - minpos, inc);
+        last = floorDiv(maxpos - pos, inc);
+    } else {
+        first = -floorDiv(pos - maxpos, inc);
+        last = floorDiv(minpos - pos, inc);
+    }
+
+    if (first > *x0) {
+        *x0 = (first > *x1) ? *x1 : (int)first;
+    }
+    if (last + 1 < *x1) {
+        *x1 = (last + 1 < *x0) ? *x0 : (int)(last + 1);
+    }
+}
+
+/**
+Computes one bilinear interpolated pixel; the source coordinate must be known to be in range.
+*/
+static SDL_INLINE void interpolateRGBA(SDL_Surface *src, int sdx, int sdy, int flipx, int flipy, tColorRGBA *pc)
+{
+    tColorRGBA c00, c01, c10, c11, cswap;
+    tColorRGBA *sp;
+    int dx = (sdx >> 16);
+    int dy = (sdy >> 16);
+    int ex, ey;
+    int t1, t2;
+
+    if (flipx) {
+        dx = (src->w - 1) - dx;
+    }
+    if (flipy) {
+        dy = (src->h - 1) - dy;
+    }
+    sp = (tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx;
+    c00 = *sp;
+    sp += 1;
+    c01 = *sp;
+    sp += (src->pitch / 4);
+    c11 = *sp;
+    sp -= 1;
+    c10 = *sp;
+    if (flipx) {
+        cswap = c00;
+        c00 = c01;
+        c01 = cswap;
+        cswap = c10;
+        c10 = c11;
+        c11 = cswap;
+    }
+    if (flipy) {
+        cswap = c00;
+        c00 = c10;
+        c10 = cswap;
+        cswap = c01;
+        c01 = c11;
+        c11 = cswap;
+    }
+    /*
+     * Interpolate colors
+     */
+    ex = (sdx & 0xffff);
+    ey = (sdy & 0xffff);
+    t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
+    t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
+    pc->r = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+    t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
+    t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
+    pc->g = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+    t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
+    t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
+    pc->b = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+    t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
+    t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
+    pc->a = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+
+static SDL_INLINE int hasSSE2(void)
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasSSE2();
+    return val;
+}
+
+/* Computes (d * f) >> 16 for signed 16-bit d and unsigned 16-bit f, exactly like the scalar code.
+ * _mm_mulhi_epi16 treats f as signed, which is off by exactly d whenever the top bit of f is set.
+ */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") mulhiSigned16Unsigned16_SSE2(__m128i d, __m128i f)
+{
+    return _mm_add_epi16(_mm_mulhi_epi16(d, f), _mm_and_si128(d, _mm_srai_epi16(f, 15)));
+}
+
+/* Interpolates two pixels; the low and high halves of the 32-bit lanes in top and bottom
+ * hold { c00, c00', c01, c01' } and { c10, c10', c11, c11' }, ex and ey hold the fractions.
+ */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") interpolate2RGBA_SSE2(__m128i top, __m128i bottom, __m128i ex, __m128i ey, __m128i zero, __m128i mask)
+{
+    __m128i c00 = _mm_unpacklo_epi8(top, zero);
+    __m128i c01 = _mm_unpackhi_epi8(top, zero);
+    __m128i c10 = _mm_unpacklo_epi8(bottom, zero);
+    __m128i c11 = _mm_unpackhi_epi8(bottom, zero);
+    __m128i t1 = _mm_and_si128(_mm_add_epi16(mulhiSigned16Unsigned16_SSE2(_mm_sub_epi16(c01, c00), ex), c00), mask);
+    __m128i t2 = _mm_and_si128(_mm_add_epi16(mulhiSigned16Unsigned16_SSE2(_mm_sub_epi16(c11, c10), ex), c10), mask);
+    return _mm_and_si128(_mm_add_epi16(mulhiSigned16Unsigned16_SSE2(_mm_sub_epi16(t2, t1), ey), t1), mask);
+}
+
+/* Replicates the fractional parts of 32-bit lanes 0 and 1 into the 16-bit channels of two pixels */
+static SDL_INLINE __m128i SDL_TARGETING("sse2") spreadFraction_SSE2(__m128i frac)
+{
+    frac = _mm_unpacklo_epi32(frac, frac);
+    frac = _mm_shufflelo_epi16(frac, _MM_SHUFFLE(0, 0, 0, 0));
+    return _mm_shufflehi_epi16(frac, _MM_SHUFFLE(0, 0, 0, 0));
+}
+
+/**
+Bilinear interpolation of a clipped span, four destination pixels at a time.
+
+Produces bit-identical results to interpolateRGBA() and returns the number of pixels written,
+which is a multiple of 4. The caller finishes the remainder with the scalar code.
+*/
+static int SDL_TARGETING("sse2") interpolateSpanRGBA_SSE2(SDL_Surface *src, tColorRGBA *pc, int count,
+                                                          int sdx, int sdy, int icos, int isin, int flipx, int flipy)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i mask = _mm_set1_epi16(0xff);
+    const __m128i lowmask = _mm_set1_epi32(0xffff);
+    const __m128i vicos = _mm_set1_epi32(icos * 4);
+    const __m128i visin = _mm_set1_epi32(isin * 4);
+    const int sw = src->w - 1;
+    const int sh = src->h - 1;
+    const int pitch = src->pitch;
+    const int toprow = flipy ? pitch : 0;
+    const int bottomrow = flipy ? 0 : pitch;
+    const Uint8 *pixels = (const Uint8 *)src->pixels;
+    __m128i vsdx = _mm_set_epi32(sdx + 3 * icos, sdx + 2 * icos, sdx + icos, sdx);
+    __m128i vsdy = _mm_set_epi32(sdy + 3 * isin, sdy + 2 * isin, sdy + isin, sdy);
+    int x;
+
+    for (x = 0; x + 4 <= count; x += 4, pc += 4) {
+        SDL_ALIGNED(16) Sint32 dx[4];
+        SDL_ALIGNED(16) Sint32 dy[4];
+        __m128i top[4], bottom[4];
+        __m128i top01, top23, bottom01, bottom23;
+        __m128i ex, ey, ex23, ey23, result01, result23;
+        int i;
+
+        _mm_store_si128((__m128i *)dx, _mm_srai_epi32(vsdx, 16));
+        _mm_store_si128((__m128i *)dy, _mm_srai_epi32(vsdy, 16));
+        for (i = 0; i < 4; ++i) {
+            const Uint8 *sp;
+            if (flipx) {
+                dx[i] = sw - dx[i];
+            }
+            if (flipy) {
+                dy[i] = sh - dy[i];
+            }
+            sp = pixels + pitch * dy[i] + dx[i] * 4;
+            top[i] = _mm_loadl_epi64((const __m128i *)(sp + toprow));
+            bottom[i] = _mm_loadl_epi64((const __m128i *)(sp + bottomrow));
+        }
+
+        // Rearrange into { c00, c00', c01, c01' }, with the horizontal neighbors swapped when flipping
+        top01 = _mm_unpacklo_epi64(top[0], top[1]);
+        top23 = _mm_unpacklo_epi64(top[2], top[3]);
+        bottom01 = _mm_unpacklo_epi64(bottom[0], bottom[1]);
+        bottom23 = _mm_unpacklo_epi64(bottom[2], bottom[3]);
+        if (flipx) {
+            top01 = _mm_shuffle_epi32(top01, _MM_SHUFFLE(2, 0, 3, 1));
+            top23 = _mm_shuffle_epi32(top23, _MM_SHUFFLE(2, 0, 3, 1));
+            bottom01 = _mm_shuffle_epi32(bottom01, _MM_SHUFFLE(2, 0, 3, 1));
+            bottom23 = _mm_shuffle_epi32(bottom23, _MM_SHUFFLE(2, 0, 3, 1));
+        } else {
+            top01 = _mm_shuffle_epi32(top01, _MM_SHUFFLE(3, 1, 2, 0));
+            top23 = _mm_shuffle_epi32(top23, _MM_SHUFFLE(3, 1, 2, 0));
+            bottom01 = _mm_shuffle_epi32(bottom01, _MM_SHUFFLE(3, 1, 2, 0));
+            bottom23 = _mm_shuffle_epi32(bottom23, _MM_SHUFFLE(3, 1, 2, 0));
+        }
+
+        ex = _mm_and_si128(vsdx, lowmask);
+        ey = _mm_and_si128(vsdy, lowmask);
+        ex23 = spreadFraction_SSE2(_mm_unpackhi_epi64(ex, ex));
+        ey23 = spreadFraction_SSE2(_mm_unpackhi_epi64(ey, ey));
+        ex = spreadFraction_SSE2(ex);
+        ey = spreadFraction_SSE2(ey);
+
+        result01 = interpolate2RGBA_SSE2(top01, bottom01, ex, ey, zero, mask);
+        result23 = interpolate2RGBA_SSE2(top23, bottom23, ex23, ey23, zero, mask);
+        _mm_storeu_si128((__m128i *)pc, _mm_packus_epi16(result01, result23));
+
+        vsdx = _mm_add_epi32(vsdx, vicos);
+        vsdy = _mm_add_epi32(vsdy, visin);
+    }
+    return x;
+}
+#endif // SDL_SSE2_INTRINSICS
+
 /**
 Internal 32 bit rotozoomer with optional anti-aliasing.
 
@@ -249,6 +487,10 @@ by bilinear interpolation.
 Assumes src and dst surfaces are of 32 bit depth.
 Assumes dst surface was allocated with the correct dimensions.
 
+Each destination row is first clipped to the span that maps inside the source surface,
+so the inner loops run without per-pixel bounds checks. The interpolating loop
+is vectorized when SSE2 is available.
+
 \param src Source surface.
 \param dst Destination surface.
 \param isin Integer version of sine of angle.
@@ -266,33 +508,66 @@ static void transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int isin, i
 {
     int sw, sh;
     int cx, cy;
-    tColorRGBA c00, c01, c10, c11, cswap;
-    tColorRGBA *pc, *sp;
-    int gap;
+    tColorRGBA *pc;
     const int fp_half = (1 << 15);
+    int y;
 
     /*
      * Variable setup
      */
     sw = src->w - 1;
     sh = src->h - 1;
-    pc = (tColorRGBA *)dst->pixels;
-    gap = dst->pitch - dst->w * 4;
     cx = (int)(center->x * 65536.0);
     cy = (int)(center->y * 65536.0);
 
-    /*
-     * Switch between interpolating and non-interpolating code
-     */
-    if (smooth) {
-        int y;
-        for (y = 0; y < dst->h; y++) {
-            int x;
-            double src_x = ((double)rect_dest->x + 0 + 0.5 - center->x);
-            double src_y = ((double)rect_dest->y + y + 0.5 - center->y);
-            int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
-            int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
-            for (x = 0; x < dst->w; x++) {
+    for (y = 0; y < dst->h; y++) {
+        int x, x0, x1;
+        double src_x = ((double)rect_dest->x + 0 + 0.5 - center->x);
+        double src_y = ((double)rect_dest->y + y + 0.5 - center->y);
+        int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
+        int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
+
+        /*
+         * Clip the row to the pixels that map inside the source surface.
+         * When smoothing, the 2x2 neighborhood has to fit, which after flipping
+         * shifts the valid range of unflipped coordinates by one.
+         */
+        x0 = 0;
+        x1 = dst->w;
+        if (smooth) {
+            clipSpan(sdx, icos, flipx ? 1 : 0, flipx ? sw : sw - 1, &x0, &x1);
+            clipSpan(sdy, isin, flipy ? 1 : 0, flipy ? sh : sh - 1, &x0, &x1);
+        } else {
+            clipSpan(sdx, icos, 0, sw, &x0, &x1);
+            clipSpan(sdy, isin, 0, sh, &x0, &x1);
+        }
+
+        pc = (tColorRGBA *)((Uint8 *)dst->pixels + dst->pitch * y) + x0;
+        sdx += x0 * icos;
+        sdy += x0 * isin;
+        x = x0;
+
+        /*
+         * Switch between interpolating and non-interpolating code
+         */
+        if (smooth) {
+#ifdef SDL_SSE2_INTRINSICS
+            if (hasSSE2()) {
+                int done = interpolateSpanRGBA_SSE2(src, pc, x1 - x0, sdx, sdy, icos, isin, flipx, flipy);
+                x += done;
+                pc += done;
+                sdx += done * icos;
+                sdy += done * isin;
+            }
+#endif
+            for (; x < x1; x++) {
+                interpolateRGBA(src, sdx, sdy, flipx, flipy, pc);
+                sdx += icos;
+                sdy += isin;
+                pc++;
+            }
+        } else {
+            for (; x < x1; x++) {
                 int dx = (sdx >> 16);
                 int dy = (sdy >> 16);
                 if (flipx) {
@@ -301,82 +576,11 @@ static void transformSurfaceRGBA(SDL_Surface *src, SDL_Surface *dst, int isin, i
                 if (flipy) {
                     dy = sh - dy;
                 }
-                if ((dx > -1) && (dy > -1) && (dx < (src->w - 1)) && (dy < (src->h - 1))) {
-                    int ex, ey;
-                    int t1, t2;
-                    sp = (tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx;
-                    c00 = *sp;
-                    sp += 1;
-                    c01 = *sp;
-                    sp += (src->pitch / 4);
-                    c11 = *sp;
-                    sp -= 1;
-                    c10 = *sp;
-                    if (flipx) {
-                        cswap = c00;
-                        c00 = c01;
-                        c01 = cswap;
-                        cswap = c10;
-                        c10 = c11;
-                        c11 = cswap;
-                    }
-                    if (flipy) {
-                        cswap = c00;
-                        c00 = c10;
-                        c10 = cswap;
-                        cswap = c01;
-                        c01 = c11;
-                        c11 = cswap;
-                    }
-                    /*
-                     * Interpolate colors
-                     */
-                    ex = (sdx & 0xffff);
-                    ey = (sdy & 0xffff);
-                    t1 = ((((c01.r - c00.r) * ex) >> 16) + c00.r) & 0xff;
-                    t2 = ((((c11.r - c10.r) * ex) >> 16) + c10.r) & 0xff;
-                    pc->r = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                    t1 = ((((c01.g - c00.g) * ex) >> 16) + c00.g) & 0xff;
-                    t2 = ((((c11.g - c10.g) * ex) >> 16) + c10.g) & 0xff;
-                    pc->g = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                    t1 = ((((c01.b - c00.b) * ex) >> 16) + c00.b) & 0xff;
-                    t2 = ((((c11.b - c10.b) * ex) >> 16) + c10.b) & 0xff;
-                    pc->b = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                    t1 = ((((c01.a - c00.a) * ex) >> 16) + c00.a) & 0xff;
-                    t2 = ((((c11.a - c10.a) * ex) >> 16) + c10.a) & 0xff;
-                    pc->a = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
-                }
-                sdx += icos;
-                sdy += isin;
-                pc++;
-            }
-            pc = (tColorRGBA *)((Uint8 *)pc + gap);
-        }
-    } else {
-        int y;
-        for (y = 0; y < dst->h; y++) {
-            int x;
-            double src_x = ((double)rect_dest->x + 0 + 0.5 - center->x);
-            double src_y = ((double)rect_dest->y + y + 0.5 - center->y);
-            int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
-            int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
-            for (x = 0; x < dst->w; x++) {
-                int dx = (sdx >> 16);
-                int dy = (sdy >> 16);
-                if ((unsigned)dx < (unsigned)src->w && (unsigned)dy < (unsigned)src->h) {
-                    if (flipx) {
-                        dx = sw - dx;
-                    }
-                    if (flipy) {
-                        dy = sh - dy;
-                    }
-                    *pc = *((tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx);
-                }
+                *pc = *((tColorRGBA *)((Uint8 *)src->pixels + src->pitch * dy) + dx);
                 sdx += icos;
                 sdy += isin;
                 pc++;
             }
-            pc = (tColorRGBA *)((Uint8 *)pc + gap);
         }
     }
 }
@@ -406,7 +610,6 @@ static void transformSurfaceY(SDL_Surface *src, SDL_Surface *dst, int isin, int
     int sw, sh;
     int cx, cy;
     tColorY *pc;
-    int gap;
     const int fp_half = (1 << 15);
     int y;
 
@@ -416,7 +619,6 @@ static void transformSurfaceY(SDL_Surface *src, SDL_Surface *dst, int isin, int
     sw = src->w - 1;
     sh = src->h - 1;
     pc = (tColorY *)dst->pixels;
-    gap = dst->pitch - dst->w;
     cx = (int)(center->x * 65536.0);
     cy = (int)(center->y * 65536.0);
 
@@ -425,31 +627,37 @@ static void transformSurfaceY(SDL_Surface *src, SDL_Surface *dst, int isin, int
      */
     SDL_memset(pc, (int)(get_colorkey(src) & 0xff), (size_t)dst->pitch * dst->h);
     /*
-     * Iterate through destination surface
+     * Iterate through destination surface, clipping each row to the span that maps inside the source
      */
     for (y = 0; y < dst->h; y++) {
-        int x;
+        int x, x0, x1;
         double src_x = ((double)rect_dest->x + 0 + 0.5 - center->x);
         double src_y = ((double)rect_dest->y + y + 0.5 - center->y);
         int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
         int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
-        for (x = 0; x < dst->w; x++) {
+
+        x0 = 0;
+        x1 = dst->w;
+        clipSpan(sdx, icos, 0, sw, &x0, &x1);
+        clipSpan(sdy, isin, 0, sh, &x0, &x1);
+
+        pc = (tColorY *)dst->pixels + dst->pitch * y + x0;
+        sdx += x0 * icos;
+        sdy += x0 * isin;
+        for (x = x0; x < x1; x++) {
             int dx = (sdx >> 16);
             int dy = (sdy >> 16);
-            if ((unsigned)dx < (unsigned)src->w && (unsigned)dy < (unsigned)src->h) {
-                if (flipx) {
-                    dx = sw - dx;
-                }
-                if (flipy) {
-                    dy = sh - dy;
-                }
-                *pc = *((tColorY *)src->pixels + src->pitch * dy + dx);
+            if (flipx) {
+                dx = sw - dx;
+            }
+            if (flipy) {
+                dy = sh - dy;
             }
+            *pc = *((tColorY *)src->pixels + src->pitch * dy + dx);
             sdx += icos;
             sdy += isin;
             pc++;
         }
-        pc += gap;
     }
 }
 
@@ -22,6 +22,7 @@
 
 #include "SDL_stb_c.h"
 #include "SDL_surface_c.h"
+#include "../thread/SDL_parallel_c.h"
 
 #ifdef SDL_HAVE_STB
 ////////////////////////////////////////////////////////////////////////////
@@ -73,6 +74,7 @@
 #define MINIZ_SDL_NOUNUSED
 #include "miniz.h"
 
+#undef memcpy
 #undef memset
 #endif // SDL_HAVE_STB
 
@@ -96,7 +98,7 @@ static bool SDL_ConvertPixels_MJPG_to_NV12(int width, int height, const void *sr
     nv12.y = (stbi_uc *)dst;
     nv12.uv = nv12.y + (nv12.h * nv12.pitch);
 
-    void *pixels = stbi__jpeg_load(&s, &w, &h, &format, 4, &nv12, &ri);
+    void *pixels = stbi__jpeg_load(&s, &w, &h, &format, 4, &nv12, NULL, &ri);
     if (!pixels) {
         return false;
     }
@@ -135,6 +137,220 @@ bool SDL_ConvertPixels_STB(int width, int height,
 }
 
 #ifdef SDL_HAVE_STB
+// Decoded rows that need converting are collected and converted this many at a time
+#define STB_STRIPE_ROWS 16
+
+typedef struct
+{
+    SDL_Surface *surface;   // the destination, created when the image size is known if NULL
+    SDL_PixelFormat format; // the format of a new surface, or SDL_PIXELFORMAT_UNKNOWN for the image format
+    bool created;
+    bool use_palette;
+    unsigned int palette_colors[256];
+    int w, h, comp;
+    SDL_Surface *stripe;    // rows waiting to be converted into the destination, NULL if decoding in place
+    int stripe_y;           // the image row at the top of the stripe
+    Uint8 *row;             // a gray and alpha row waiting to be expanded into the stripe
+    Uint8 *discard;         // rows below the destination are decoded here
+} STBOutput;
+
+static SDL_PixelFormat GetSTBFormat(int comp)
+{
+    switch (comp) {
+    case 1:
+        return SDL_PIXELFORMAT_INDEX8;
+    case 2:
+        // Gray and alpha is expanded to RGBA
+        return SDL_PIXELFORMAT_RGBA32;
+    case 3:
+        return SDL_PIXELFORMAT_RGB24;
+    case 4:
+        return SDL_PIXELFORMAT_RGBA32;
+    default:
+        return SDL_PIXELFORMAT_UNKNOWN;
+    }
+}
+
+// Set the image palette, or a grayscale palette for gray images, on an 8-bit surface
+static bool SetSTBPalette(SDL_Surface *surface, const STBOutput *out)
+{
+    SDL_Palette *palette = SDL_CreateSurfacePalette(surface);
+    int i;
+
+    if (!palette) {
+        return false;
+    }
+    for (i = 0; i < palette->ncolors; i++) {
+        if (out->use_palette) {
+            const Uint8 *palette_bytes = (const Uint8 *)&out->palette_colors[i];
+
+            palette->colors[i].r = palette_bytes[0];
+            palette->colors[i].g = palette_bytes[1];
+            palette->colors[i].b = palette_bytes[2];
+            palette->colors[i].a = palette_bytes[3];
+        } else {
+            palette->colors[i].r = (Uint8)i;
+            palette->colors[i].g = (Uint8)i;
+            palette->colors[i].b = (Uint8)i;
+        }
+    }
+    return true;
+}
+
+// Set the transparency of a new surface loaded from a paletted image
+static void SetSTBTransparency(SDL_Surface *surface, const STBOutput *out)
+{
+    bool has_colorkey = false;
+    int colorkey_index = -1;
+    bool has_alpha = false;
+    int i;
+
+    for (i = 0; i < SDL_arraysize(out->palette_colors); i++) {
+        const Uint8 *palette_bytes = (const Uint8 *)&out->palette_colors[i];
+
+        if (palette_bytes[3] != SDL_ALPHA_OPAQUE) {
+            if (palette_bytes[3] == SDL_ALPHA_TRANSPARENT && !has_colorkey) {
+                has_colorkey = true;
+                colorkey_index = i;
+            } else {
+                /* Partial opacity or multiple colorkeys */
+                has_alpha = true;
+            }
+        }
+    }
+
+    if (surface->format == SDL_PIXELFORMAT_INDEX8) {
+        if (has_alpha) {
+            SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
+        } else if (has_colorkey) {
+            SDL_SetSurfaceColorKey(surface, true, colorkey_index);
+        }
+    } else if (has_colorkey && !has_alpha && !SDL_ISPIXELFORMAT_ALPHA(surface->format)) {
+        const Uint8 *palette_bytes = (const Uint8 *)&out->palette_colors[colorkey_index];
+
+        SDL_SetSurfaceColorKey(surface, true, SDL_MapSurfaceRGB(surface, palette_bytes[0], palette_bytes[1], palette_bytes[2]));
+    }
+}
+
+static int STBBegin(void *userdata, int w, int h, int comp)
+{
+    STBOutput *out = (STBOutput *)userdata;
+    SDL_PixelFormat image_format = GetSTBFormat(comp);
+
+    if (image_format == SDL_PIXELFORMAT_UNKNOWN) {
+        SDL_SetError("Unknown image format: %d", comp);
+        return 0;
+    }
+    out->w = w;
+    out->h = h;
+    out->comp = comp;
+
+    if (!out->surface) {
+        out->surface = SDL_CreateSurface(w, h, out->format ? out->format : image_format);
+        if (!out->surface) {
+            return 0;
+        }
+        out->created = true;
+        if (out->surface->format == SDL_PIXELFORMAT_INDEX8 && !SetSTBPalette(out->surface, out)) {
+            return 0;
+        }
+    }
+
+    // Pixels can go straight into the destination if it has the image format, and the palette for indexed images
+    if (out->surface->format == image_format && comp != 2 && w <= out->surface->w &&
+        (image_format != SDL_PIXELFORMAT_INDEX8 || out->created)) {
+        if (h > out->surface->h) {
+            out->discard = (Uint8 *)SDL_malloc((size_t)w * comp);
+            if (!out->discard) {
+                return 0;
+            }
+        }
+        return 1;
+    }
+
+    out->stripe = SDL_CreateSurface(w, STB_STRIPE_ROWS, image_format);
+    if (!out->stripe) {
+        return 0;
+    }
+    SDL_SetSurfaceBlendMode(out->stripe, SDL_BLENDMODE_NONE);
+    if (image_format == SDL_PIXELFORMAT_INDEX8 && !SetSTBPalette(out->stripe, out)) {
+        return 0;
+    }
+    if (comp == 2) {
+        out->row = (Uint8 *)SDL_malloc((size_t)w * comp);
+        if (!out->row) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Convert the rows in the stripe into the destination
+static bool FlushSTBStripe(STBOutput *out, int rows)
+{
+    SDL_Rect srcrect, dstrect;
+
+    rows = SDL_min(rows, out->surface->h - out->stripe_y);
+    if (rows > 0) {
+        srcrect.x = 0;
+        srcrect.y = 0;
+        srcrect.w = SDL_min(out->w, out->surface->w);
+        srcrect.h = rows;
+        dstrect = srcrect;
+        dstrect.y = out->stripe_y;
+        if (!SDL_BlitSurfaceUnchecked(out->stripe, &srcrect, out->surface, &dstrect)) {
+            return false;
+        }
+        SDL_SetSurfacePaddingBits(out->surface, &dstrect);
+    }
+    out->stripe_y += STB_STRIPE_ROWS;
+    return true;
+}
+
+static bool FinishSTBRow(STBOutput *out, int y)
+{
+    const int stripe_row = y - out->stripe_y;
+
+    if (out->row) {
+        const Uint8 *src = out->row;
+        Uint8 *dst = (Uint8 *)out->stripe->pixels + stripe_row * out->stripe->pitch;
+        int x;
+
+        for (x = 0; x < out->w; ++x) {
+            Uint8 c = *src++;
+            Uint8 a = *src++;
+            *dst++ = c;
+            *dst++ = c;
+            *dst++ = c;
+            *dst++ = a;
+        }
+    }
+    if (stripe_row == STB_STRIPE_ROWS - 1) {
+        return FlushSTBStripe(out, STB_STRIPE_ROWS);
+    }
+    return true;
+}
+
+static stbi_uc *STBGetRow(void *userdata, int y)
+{
+    STBOutput *out = (STBOutput *)userdata;
+
+    if (!out->stripe) {
+        if (y >= out->surface->h) {
+            return out->discard;
+        }
+        return (Uint8 *)out->surface->pixels + y * out->surface->pitch;
+    }
+
+    if (y > 0 && !FinishSTBRow(out, y - 1)) {
+        return NULL;
+    }
+    if (out->row) {
+        return out->row;
+    }
+    return (Uint8 *)out->stripe->pixels + (y - out->stripe_y) * out->stripe->pitch;
+}
+
 static int IMG_LoadSTB_IO_read(void *user, char *data, int size)
 {
     size_t amount = SDL_ReadIO((SDL_IOStream*)user, data, size);
@@ -152,20 +368,21 @@ static int IMG_LoadSTB_IO_eof(void *user)
     return SDL_GetIOStatus(src) == SDL_IO_STATUS_EOF;
 }
 
-static SDL_Surface *SDL_LoadSTB_IO(SDL_IOStream *src)
+SDL_Surface *SDL_LoadSTB_IO(SDL_IOStream *src, SDL_Surface *surface, SDL_PixelFormat format, int scale, SDL_Rect *rect)
 {
     Sint64 start;
     Uint8 magic[26];
-    int w, h, format;
-    stbi_uc *pixels;
     stbi_io_callbacks rw_callbacks;
-    SDL_Surface *surface = NULL;
-    bool use_palette = false;
-    unsigned int palette_colors[256];
+    stbi__output output;
+    STBOutput out;
+    SDL_PixelFormat convert_format = SDL_PIXELFORMAT_UNKNOWN;
+    SDL_PixelFormat target_format;
+    bool result;
 
     // src has already been validated
     start = SDL_TellIO(src);
 
+    SDL_zero(out);
     if (SDL_ReadIO(src, magic, sizeof(magic)) == sizeof(magic)) {
         const Uint8 PNG_COLOR_INDEXED = 3;
         if (magic[0] == 0x89 &&
@@ -177,154 +394,97 @@ static SDL_Surface *SDL_LoadSTB_IO(SDL_IOStream *src)
             magic[14] == 'D' &&
             magic[15] == 'R' &&
             magic[25] == PNG_COLOR_INDEXED) {
-            use_palette = true;
+            out.use_palette = true;
         }
     }
     SDL_SeekIO(src, start, SDL_IO_SEEK_SET);
 
+    if (surface) {
+        target_format = surface->format;
+    } else {
+        target_format = format;
+        if (SDL_ISPIXELFORMAT_FOURCC(format)) {
+            // YUV formats need whole image conversion, which works from RGB pixels
+            convert_format = format;
+            format = SDL_PIXELFORMAT_RGBA32;
+        } else if (SDL_ISPIXELFORMAT_INDEXED(format)) {
+            // These need a palette, so load the image format and convert it afterwards
+            convert_format = format;
+            format = SDL_PIXELFORMAT_UNKNOWN;
+        }
+        out.format = format;
+    }
+    out.surface = surface;
+
+    /* Unused palette entries will be opaque white */
+    SDL_memset(out.palette_colors, 0xff, sizeof(out.palette_colors));
+
+    SDL_zero(output);
+    if (target_format != SDL_PIXELFORMAT_UNKNOWN && !SDL_ISPIXELFORMAT_FOURCC(target_format) &&
+        SDL_BYTESPERPIXEL(target_format) == 4) {
+        // The JPEG decoder has fast paths for RGBA output, which converts quickly to other 32-bit formats
+        output.req_comp = 4;
+    }
+    while (scale > 1 && output.scale_shift < 3) {
+        scale >>= 1;
+        ++output.scale_shift;
+    }
+    output.userdata = &out;
+    output.begin = STBBegin;
+    output.get_row = STBGetRow;
+
     /* Load the image data */
     rw_callbacks.read = IMG_LoadSTB_IO_read;
     rw_callbacks.skip = IMG_LoadSTB_IO_skip;
     rw_callbacks.eof = IMG_LoadSTB_IO_eof;
-    w = h = format = 0; /* silence warning */
-    if (use_palette) {
-        /* Unused palette entries will be opaque white */
-        SDL_memset(palette_colors, 0xff, sizeof(palette_colors));
-
-        pixels = stbi_load_from_callbacks_with_palette(
-            &rw_callbacks,
-            src,
-            &w,
-            &h,
-            palette_colors,
-            SDL_arraysize(palette_colors)
-        );
-    } else {
-        pixels = stbi_load_from_callbacks(
-            &rw_callbacks,
-            src,
-            &w,
-            &h,
-            &format,
-            STBI_default
-        );
+
+    if (surface && !SDL_LockSurface(surface)) {
+        return NULL;
     }
-    if (!pixels) {
+    result = stbi_load_from_callbacks_to_output(&rw_callbacks, src, &output, out.use_palette ? out.palette_colors : NULL, SDL_arraysize(out.palette_colors));
+    if (result && out.stripe) {
+        result = FinishSTBRow(&out, out.h - 1) && FlushSTBStripe(&out, out.h - out.stripe_y);
+    }
+    if (surface) {
+        SDL_UnlockSurface(surface);
+    }
+    SDL_DestroySurface(out.stripe);
+    SDL_free(out.row);
+    SDL_free(out.discard);
+
+    if (!result) {
+        /* The error message should already be set */
+        if (out.created) {
+            SDL_DestroySurface(out.surface);
+        }
         SDL_SeekIO(src, start, SDL_IO_SEEK_SET);
         return NULL;
     }
 
-    if (use_palette) {
-        surface = SDL_CreateSurfaceFrom(
-            w,
-            h,
-            SDL_PIXELFORMAT_INDEX8,
-            pixels,
-            w
-        );
-        if (surface) {
-            bool has_colorkey = false;
-            int colorkey_index = -1;
-            bool has_alpha = false;
-            SDL_Palette *palette = SDL_CreateSurfacePalette(surface);
-            if (palette) {
-                int i;
-                Uint8 *palette_bytes = (Uint8 *)palette_colors;
-
-                for (i = 0; i < palette->ncolors; i++) {
-                    palette->colors[i].r = *palette_bytes++;
-                    palette->colors[i].g = *palette_bytes++;
-                    palette->colors[i].b = *palette_bytes++;
-                    palette->colors[i].a = *palette_bytes++;
-                    if (palette->colors[i].a != SDL_ALPHA_OPAQUE) {
-                        if (palette->colors[i].a == SDL_ALPHA_TRANSPARENT && !has_colorkey) {
-                            has_colorkey = true;
-                            colorkey_index = i;
-                        } else {
-                            /* Partial opacity or multiple colorkeys */
-                            has_alpha = true;
-                        }
-                    }
-                }
-            }
-            if (has_alpha) {
-                SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
-            } else if (has_colorkey) {
-                SDL_SetSurfaceColorKey(surface, true, colorkey_index);
-            }
-
-            /* FIXME: This sucks. It'd be better to allocate the surface first, then
-             * write directly to the pixel buffer:
-             * https://github.com/nothings/stb/issues/58
-             * -flibit
-             */
-            surface->flags &= ~SDL_SURFACE_PREALLOCATED;
-        }
-
-    } else if (format == STBI_grey || format == STBI_rgb || format == STBI_rgb_alpha) {
-        surface = SDL_CreateSurfaceFrom(
-            w,
-            h,
-            (format == STBI_rgb_alpha) ? SDL_PIXELFORMAT_RGBA32 :
-            (format == STBI_rgb) ? SDL_PIXELFORMAT_RGB24 :
-            SDL_PIXELFORMAT_INDEX8,
-            pixels,
-            w * format
-        );
-        if (surface) {
-            /* Set a grayscale palette for gray images */
-            if (surface->format == SDL_PIXELFORMAT_INDEX8) {
-                SDL_Palette *palette = SDL_CreateSurfacePalette(surface);
-                if (palette) {
-                    int i;
-
-                    for (i = 0; i < palette->ncolors; i++) {
-                        palette->colors[i].r = (Uint8)i;
-                        palette->colors[i].g = (Uint8)i;
-                        palette->colors[i].b = (Uint8)i;
-                    }
-                }
-            }
-
-            /* FIXME: This sucks. It'd be better to allocate the surface first, then
-             * write directly to the pixel buffer:
-             * https://github.com/nothings/stb/issues/58
-             * -flibit
-             */
-            surface->flags &= ~SDL_SURFACE_PREALLOCATED;
-        }
-
-    } else if (format == STBI_grey_alpha) {
-        surface = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_RGBA32);
-        if (surface) {
-            Uint8 *src_ptr = pixels;
-            Uint8 *dst = (Uint8 *)surface->pixels;
-            int skip = surface->pitch - (surface->w * 4);
-            int row, col;
-
-            for (row = 0; row < h; ++row) {
-                for (col = 0; col < w; ++col) {
-                    Uint8 c = *src_ptr++;
-                    Uint8 a = *src_ptr++;
-                    *dst++ = c;
-                    *dst++ = c;
-                    *dst++ = c;
-                    *dst++ = a;
-                }
-                dst += skip;
-            }
-            stbi_image_free(pixels);
-        }
-    } else {
-        SDL_SetError("Unknown image format: %d", format);
+    if (rect) {
+        rect->x = 0;
+        rect->y = 0;
+        rect->w = SDL_min(out.w, out.surface->w);
+        rect->h = SDL_min(out.h, out.surface->h);
     }
 
-    if (!surface) {
-        /* The error message should already be set */
-        stbi_image_free(pixels); /* calls SDL_free() */
-        SDL_SeekIO(src, start, SDL_IO_SEEK_SET);
+    if (out.created) {
+        if (out.use_palette) {
+            SetSTBTransparency(out.surface, &out);
+        }
+        if (convert_format != SDL_PIXELFORMAT_UNKNOWN && convert_format != out.surface->format) {
+            SDL_Surface *converted = SDL_ConvertSurface(out.surface, convert_format);
+            SDL_DestroySurface(out.surface);
+            out.surface = converted;
+        }
     }
-    return surface;
+    return out.surface;
+}
+#else
+SDL_Surface *SDL_LoadSTB_IO(SDL_IOStream *src, SDL_Surface *surface, SDL_PixelFormat format, int scale, SDL_Rect *rect)
+{
+    SDL_SetError("SDL not built with STB image support");
+    return NULL;
 }
 #endif // SDL_HAVE_STB
 
@@ -351,6 +511,28 @@ bool SDL_IsPNG(SDL_IOStream *src)
     return is_PNG;
 }
 
+bool SDL_IsJPEG(SDL_IOStream *src)
+{
+    Sint64 start;
+    Uint8 magic[3];
+    bool is_JPEG;
+
+    is_JPEG = false;
+    start = SDL_TellIO(src);
+    if (start >= 0) {
+        if (SDL_ReadIO(src, magic, sizeof(magic)) == sizeof(magic)) {
+            if (magic[0] == 0xFF &&
+                magic[1] == 0xD8 &&
+                magic[2] == 0xFF) {
+                is_JPEG = true;
+            }
+        }
+        SDL_SeekIO(src, start, SDL_IO_SEEK_SET);
+    }
+
+    return is_JPEG;
+}
+
 SDL_Surface *SDL_LoadPNG_IO(SDL_IOStream *src, bool closeio)
 {
     SDL_Surface *surface = NULL;
@@ -366,7 +548,7 @@ SDL_Surface *SDL_LoadPNG_IO(SDL_IOStream *src, bool closeio)
     }
 
 #ifdef SDL_HAVE_STB
-    surface = SDL_LoadSTB_IO(src);
+    surface = SDL_LoadSTB_IO(src, NULL, SDL_PIXELFORMAT_UNKNOWN, 1, NULL);
 #else
     SDL_SetError("SDL not built with STB image support");
 #endif // SDL_HAVE_STB
@@ -388,6 +570,636 @@ SDL_Surface *SDL_LoadPNG(const char *file)
     return SDL_LoadPNG_IO(stream, true);
 }
 
+#ifdef SDL_HAVE_STB
+// Image data is written in IDAT chunks of up to this size
+#define PNG_IDAT_SIZE           (64 * 1024)
+
+// When compressing on multiple threads, the image is split into independent blocks of about this many bytes
+#define PNG_PARALLEL_BLOCK_SIZE (256 * 1024)
+
+typedef enum
+{
+    PNG_FILTER_NONE,
+    PNG_FILTER_SUB,
+    PNG_FILTER_UP,
+    PNG_FILTER_AVERAGE,
+    PNG_FILTER_PAETH,
+    PNG_FILTER_ADAPTIVE
+} PNGFilter;
+
+typedef struct PNGOutput
+{
+    SDL_IOStream *dst;  // if NULL, the chunks are collected in data
+    Uint8 *data;
+    size_t size;
+    size_t capacity;
+    Uint8 idat[PNG_IDAT_SIZE];
+    size_t idat_size;
+} PNGOutput;
+
+typedef struct PNGSaveJob
+{
+    const Uint8 *pixels;
+    int pitch;
+    int row_size;
+    int bpp;
+    int h;
+    PNGFilter filter;
+    int comp_flags;
+    int rows_per_block;
+    int num_blocks;
+    PNGOutput **outputs;
+    Uint32 *adler;
+    tdefl_compressor **compressors;
+    Uint8 *scratch;
+    size_t scratch_size;
+} PNGSaveJob;
+
+static int GetPNGCompressionFlags(SDL_PropertiesID props)
+{
+    // The same settings as tdefl_create_comp_flags_from_zip_params(), which isn't available without the zlib API
+    static const int num_probes[11] = { 0, 1, 6, 32, 16, 32, 128, 256, 512, 768, 1500 };
+    const Sint64 level = SDL_clamp(SDL_GetNumberProperty(props, SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER, 6), 0, 10);
+    const char *strategy = SDL_GetStringProperty(props, SDL_PROP_SURFACE_PNG_STRATEGY_STRING, NULL);
+    int flags = num_probes[level];
+
+    if (level == 0) {
+        return TDEFL_FORCE_ALL_RAW_BLOCKS;
+    }
+    if (level <= 3) {
+        flags |= TDEFL_GREEDY_PARSING_FLAG;
+    }
+    if (strategy) {
+        if (SDL_strcasecmp(strategy, "filtered") == 0) {
+            flags |= TDEFL_FILTER_MATCHES;
+        } else if (SDL_strcasecmp(strategy, "rle") == 0) {
+            flags |= TDEFL_RLE_MATCHES;
+        } else if (SDL_strcasecmp(strategy, "huffman") == 0) {
+            flags &= ~TDEFL_MAX_PROBES_MASK;
+        } else if (SDL_strcasecmp(strategy, "fixed") == 0) {
+            flags |= TDEFL_FORCE_ALL_STATIC_BLOCKS;
+        }
+    }
+    return flags;
+}
+
+static PNGFilter GetPNGFilter(SDL_PropertiesID props)
+{
+    const char *filter = SDL_GetStringProperty(props, SDL_PROP_SURFACE_PNG_FILTER_STRING, NULL);
+
+    if (filter) {
+        if (SDL_strcasecmp(filter, "sub") == 0) {
+            return PNG_FILTER_SUB;
+        }
+        if (SDL_strcasecmp(filter, "up") == 0) {
+            return PNG_FILTER_UP;
+        }
+        if (SDL_strcasecmp(filter, "average") == 0) {
+            return PNG_FILTER_AVERAGE;
+        }
+        if (SDL_strcasecmp(filter, "paeth") == 0) {
+            return PNG_FILTER_PAETH;
+        }
+        if (SDL_strcasecmp(filter, "adaptive") == 0) {
+            return PNG_FILTER_ADAPTIVE;
+        }
+    }
+    return PNG_FILTER_NONE;
+}
+
+static bool WritePNGData(PNGOutput *out, const void *data, size_t size)
+{
+    if (out->dst) {
+        return SDL_WriteIO(out->dst, data, size) == size;
+    }
+
+    if (size > out->capacity - out->size) {
+        size_t capacity = SDL_max(out->capacity * 2, out->size + size);
+        Uint8 *buffer = (Uint8 *)SDL_realloc(out->data, capacity);
+        if (!buffer) {
+            return false;
+        }
+        out->data = buffer;
+        out->capacity = capacity;
+    }
+    SDL_memcpy(out->data + out->size, data, size);
+    out->size += size;
+    return true;
+}
+
+static bool WritePNGChunk(PNGOutput *out, const char *type, const void *data, size_t size)
+{
+    Uint8 header[8], footer[4];
+    Uint32 crc;
+
+    header[0] = (Uint8)(size >> 24);
+    header[1] = (Uint8)(size >> 16);
+    header[2] = (Uint8)(size >> 8);
+    header[3] = (Uint8)(size >> 0);
+    SDL_memcpy(&header[4], type, 4);
+    crc = (Uint32)mz_crc32(MZ_CRC32_INIT, &header[4], 4);
+    if (size > 0) {
+        // mz_crc32() restarts the CRC when given NULL data, as for IEND
+        crc = (Uint32)mz_crc32(crc, (const mz_uint8 *)data, size);
+    }
+    footer[0] = (Uint8)(crc >> 24);
+    footer[1] = (Uint8)(crc >> 16);
+    footer[2] = (Uint8)(crc >> 8);
+    footer[3] = (Uint8)(crc >> 0);
+
+    return WritePNGData(out, header, sizeof(header)) &&
+           (size == 0 || WritePNGData(out, data, size)) &&
+           WritePNGData(out, footer, sizeof(footer));
+}
+
+static bool FlushPNGImageData(PNGOutput *out)
+{
+    if (out->idat_size > 0) {
+        if (!WritePNGChunk(out, "IDAT", out->idat, out->idat_size)) {
+            return false;
+        }
+        out->idat_size = 0;
+    }
+    return true;
+}
+
+// The output callback for the compressor, which splits the compressed data into IDAT chunks as it arrives
+static mz_bool PutPNGImageData(const void *buf, int len, void *user)
+{
+    PNGOutput *out = (PNGOutput *)user;
+    const Uint8 *data = (const Uint8 *)buf;
+    size_t size = (size_t)len;
+
+    while (size > 0) {
+        const size_t amount = SDL_min(size, PNG_IDAT_SIZE - out->idat_size);
+
+        SDL_memcpy(out->idat + out->idat_size, data, amount);
+        out->idat_size += amount;
+        data += amount;
+        size -= amount;
+        if (out->idat_size == PNG_IDAT_SIZE && !FlushPNGImageData(out)) {
+            return MZ_FALSE;
+        }
+    }
+    return MZ_TRUE;
+}
+
+SDL_FORCE_INLINE Uint8 PaethPredictor(int a, int b, int c)
+{
+    int pa = b - c;
+    int pb = a - c;
+    int pc = pa + pb;
+
+    pa = (pa < 0) ? -pa : pa;
+    pb = (pb < 0) ? -pb : pb;
+    pc = (pc < 0) ? -pc : pc;
+
+    if (pa <= pb && pa <= pc) {
+        return (Uint8)a;
+    } else if (pb <= pc) {
+        return (Uint8)b;
+    } else {
+        return (Uint8)c;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/* Filter the bytes of a row from start on, 8 at a time, returning where the scalar code should continue.
+ * Filtering only looks at the unfiltered bytes, so unlike decoding each byte is independent.
+ */
+static int SDL_TARGETING("sse2") FilterPNGRow_SSE2(PNGFilter filter, const Uint8 *row, const Uint8 *prev, int start, int size, int bpp, Uint8 *out)
+{
+    const __m128i zero = _mm_setzero_si128();
+    int i;
+
+    for (i = start; i + 8 <= size; i += 8) {
+        const __m128i x = _mm_loadl_epi64((const __m128i *)(row + i));
+        const __m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(row + i - bpp)), zero);
+        const __m128i b = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(prev + i)), zero);
+        __m128i pred;
+
+        switch (filter) {
+        case PNG_FILTER_SUB:
+            pred = a;
+            break;
+        case PNG_FILTER_UP:
+            pred = b;
+            break;
+        case PNG_FILTER_AVERAGE:
+            pred = _mm_srli_epi16(_mm_add_epi16(a, b), 1);
+            break;
+        default:
+        {
+            const __m128i c = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(prev + i - bpp)), zero);
+            const __m128i b_c = _mm_sub_epi16(b, c);
+            const __m128i a_c = _mm_sub_epi16(a, c);
+            const __m128i pa = _mm_max_epi16(b_c, _mm_sub_epi16(zero, b_c));
+            const __m128i pb = _mm_max_epi16(a_c, _mm_sub_epi16(zero, a_c));
+            const __m128i pc = _mm_max_epi16(_mm_add_epi16(b_c, a_c), _mm_sub_epi16(zero, _mm_add_epi16(b_c, a_c)));
+            const __m128i use_a = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc)), _mm_set1_epi16(-1));
+            const __m128i use_b = _mm_andnot_si128(_mm_cmpgt_epi16(pb, pc), _mm_set1_epi16(-1));
+            const __m128i b_or_c = _mm_or_si128(_mm_and_si128(use_b, b), _mm_andnot_si128(use_b, c));
+
+            pred = _mm_or_si128(_mm_and_si128(use_a, a), _mm_andnot_si128(use_a, b_or_c));
+            break;
+        }
+        }
+        _mm_storel_epi64((__m128i *)(out + i), _mm_sub_epi8(x, _mm_packus_epi16(pred, zero)));
+    }
+    return i;
+}
+
+// The sum of the absolute values of the bytes as signed differences
+static Uint32 SDL_TARGETING("sse2") ScorePNGRow_SSE2(const Uint8 *row, int size, int *end)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum = zero;
+    int i;
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(row + i));
+
+        sum = _mm_add_epi64(sum, _mm_sad_epu8(_mm_min_epu8(v, _mm_sub_epi8(zero, v)), zero));
+    }
+    *end = i;
+    return (Uint32)(_mm_cvtsi128_si32(sum) + _mm_cvtsi128_si32(_mm_srli_si128(sum, 8)));
+}
+#endif
+
+// Filter a row of size bytes with the filter type written in front of it, prev is the row above
+static void FilterPNGRow(PNGFilter filter, const Uint8 *row, const Uint8 *prev, int size, int bpp, Uint8 *out)
+{
+    int i;
+
+    *out++ = (Uint8)filter;
+    if (filter == PNG_FILTER_NONE) {
+        SDL_memcpy(out, row, size);
+        return;
+    }
+
+    // The bytes of the first pixel have no neighbor to the left
+    for (i = 0; i < bpp; ++i) {
+        switch (filter) {
+        case PNG_FILTER_SUB:
+            out[i] = row[i];
+            break;
+        case PNG_FILTER_AVERAGE:
+            out[i] = (Uint8)(row[i] - (prev[i] >> 1));
+            break;
+        default:
+            out[i] = (Uint8)(row[i] - prev[i]);
+            break;
+        }
+    }
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        i = FilterPNGRow_SSE2(filter, row, prev, i, size, bpp, out);
+    }
+#endif
+
+    switch (filter) {
+    case PNG_FILTER_SUB:
+        for (; i < size; ++i) {
+            out[i] = (Uint8)(row[i] - row[i - bpp]);
+        }
+        break;
+    case PNG_FILTER_UP:
+        for (; i < size; ++i) {
+            out[i] = (Uint8)(row[i] - prev[i]);
+        }
+        break;
+    case PNG_FILTER_AVERAGE:
+        for (; i < size; ++i) {
+            out[i] = (Uint8)(row[i] - ((row[i - bpp] + prev[i]) >> 1));
+        }
+        break;
+    default:
+        for (; i < size; ++i) {
+            out[i] = (Uint8)(row[i] - PaethPredictor(row[i - bpp], prev[i], prev[i - bpp]));
+        }
+        break;
+    }
+}
+
+// Estimate how well a filtered row will compress, using the sum of the bytes as signed differences
+static Uint32 ScorePNGRow(const Uint8 *row, int size)
+{
+    Uint32 score = 0;
+    int i = 0;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        score = ScorePNGRow_SSE2(row, size, &i);
+    }
+#endif
+    for (; i < size; ++i) {
+        const int value = (Sint8)row[i];
+        score += (Uint32)((value < 0) ? -value : value);
+    }
+    return score;
+}
+
+static bool CheckPNGCompression(tdefl_status status, tdefl_status expected)
+{
+    if (status == expected) {
+        return true;
+    }
+    if (status != TDEFL_STATUS_PUT_BUF_FAILED) {
+        // Otherwise the output already set the error
+        SDL_SetError("Failed to compress image");
+    }
+    return false;
+}
+
+// Write data in stored deflate blocks, which is much faster than going through the compressor
+static bool StorePNGImageData(PNGOutput *out, const Uint8 *data, size_t size, bool final)
+{
+    do {
+        const size_t amount = SDL_min(size, 0xFFFF);
+        Uint8 header[5];
+
+        header[0] = (final && amount == size) ? 1 : 0;
+        header[1] = (Uint8)(amount >> 0);
+        header[2] = (Uint8)(amount >> 8);
+        header[3] = (Uint8)(~amount >> 0);
+        header[4] = (Uint8)(~amount >> 8);
+        if (!PutPNGImageData(header, sizeof(header), out) || !PutPNGImageData(data, (int)amount, out)) {
+            return false;
+        }
+        data += amount;
+        size -= amount;
+    } while (size > 0);
+
+    return true;
+}
+
+static bool CompressPNGBlock(void *userdata, int item, int slot)
+{
+    PNGSaveJob *job = (PNGSaveJob *)userdata;
+    PNGOutput *out = job->outputs[item];
+    tdefl_compressor *comp = job->compressors[slot];
+    const int filtered_size = 1 + job->row_size;
+    Uint8 *zero = job->scratch + (size_t)slot * job->scratch_size;
+    Uint8 *best = zero + job->row_size;
+    Uint8 *candidate = best + filtered_size;
+    const int y0 = item * job->rows_per_block;
+    const int y1 = SDL_min(y0 + job->rows_per_block, job->h);
+    const bool last = (item == job->num_blocks - 1);
+    const bool stored = ((job->comp_flags & TDEFL_FORCE_ALL_RAW_BLOCKS) != 0);
+    Uint32 adler = (Uint32)MZ_ADLER32_INIT;
+    int y;
+
+    // Unless the compressor writes a whole zlib stream, the blocks are raw deflate data that's joined together
+    if (item == 0 && (job->num_blocks > 1 || stored)) {
+        static const Uint8 zlib_header[2] = { 0x78, 0x01 };
+
+        if (!PutPNGImageData(zlib_header, sizeof(zlib_header), out)) {
+            return false;
+        }
+    }
+    if (!stored) {
+        tdefl_init(comp, PutPNGImageData, out, job->comp_flags | ((job->num_blocks == 1) ? TDEFL_WRITE_ZLIB_HEADER : TDEFL_COMPUTE_ADLER32));
+    }
+
+    for (y = y0; y < y1; ++y) {
+        const Uint8 *row = job->pixels + (size_t)y * job->pitch;
+        const Uint8 *prev = (y > 0) ? row - job->pitch : zero;
+
+        if (job->filter == PNG_FILTER_ADAPTIVE) {
+            Uint32 best_score = SDL_MAX_UINT32;
+            int filter;
+
+            for (filter = PNG_FILTER_NONE; filter < PNG_FILTER_ADAPTIVE; ++filter) {
+                Uint32 score;
+
+                FilterPNGRow((PNGFilter)filter, row, prev, job->row_size, job->bpp, candidate);
+                score = ScorePNGRow(candidate + 1, job->row_size);
+                if (score < best_score) {
+                    Uint8 *swap = best;
+                    best = candidate;
+                    candidate = swap;
+                    best_score = score;
+                }
+            }
+        } else {
+            FilterPNGRow(job->filter, row, prev, job->row_size, job->bpp, best);
+        }
+
+        if (stored) {
+            adler = (Uint32)mz_adler32(adler, best, filtered_size);
+            if (!StorePNGImageData(out, best, filtered_size, (last && y == y1 - 1))) {
+                return false;
+            }
+        } else if (!CheckPNGCompression(tdefl_compress_buffer(comp, best, filtered_size, TDEFL_NO_FLUSH), TDEFL_STATUS_OKAY)) {
+            return false;
+        }
+    }
+
+    if (stored) {
+        if (job->num_blocks == 1) {
+            const Uint8 trailer[4] = { (Uint8)(adler >> 24), (Uint8)(adler >> 16), (Uint8)(adler >> 8), (Uint8)(adler >> 0) };
+
+            if (!PutPNGImageData(trailer, sizeof(trailer), out)) {
+                return false;
+            }
+        }
+    } else {
+        // Every block but the last ends on a byte boundary, so they can be joined
+        if (last) {
+            if (!CheckPNGCompression(tdefl_compress_buffer(comp, NULL, 0, TDEFL_FINISH), TDEFL_STATUS_DONE)) {
+                return false;
+            }
+        } else {
+            if (!CheckPNGCompression(tdefl_compress_buffer(comp, NULL, 0, TDEFL_SYNC_FLUSH), TDEFL_STATUS_OKAY)) {
+                return false;
+            }
+        }
+        adler = comp->m_adler32;
+    }
+    job->adler[item] = adler;
+
+    return FlushPNGImageData(out);
+}
+
+// Combine the Adler-32 of two blocks, like adler32_combine() in zlib
+static Uint32 CombinePNGAdler32(Uint32 adler1, Uint32 adler2, size_t len2)
+{
+    const Uint32 base = 65521;
+    const Uint32 rem = (Uint32)(len2 % base);
+    Uint32 sum1 = adler1 & 0xFFFF;
+    Uint32 sum2 = (rem * sum1) % base;
+
+    sum1 += (adler2 & 0xFFFF) + base - 1;
+    sum2 += ((adler1 >> 16) & 0xFFFF) + ((adler2 >> 16) & 0xFFFF) + base - rem;
+    if (sum1 >= base) {
+        sum1 -= base;
+    }
+    if (sum1 >= base) {
+        sum1 -= base;
+    }
+    if (sum2 >= (base << 1)) {
+        sum2 -= (base << 1);
+    }
+    if (sum2 >= base) {
+        sum2 -= base;
+    }
+    return sum1 | (sum2 << 16);
+}
+
+static bool WritePNGImageData(SDL_IOStream *dst, const Uint8 *pixels, int w, int h, int pitch, int bpp, bool indexed, SDL_PropertiesID props)
+{
+    PNGSaveJob job;
+    PNGOutput *stream = NULL;
+    int num_threads = 1;
+    int i;
+    bool result = false;
+
+    SDL_zero(job);
+    job.pixels = pixels;
+    job.pitch = pitch;
+    job.row_size = w * bpp;
+    job.bpp = bpp;
+    job.h = h;
+    job.filter = GetPNGFilter(props);
+    if (indexed && job.filter == PNG_FILTER_ADAPTIVE) {
+        // Filtering rarely helps palette indices, which aren't continuous
+        job.filter = PNG_FILTER_NONE;
+    }
+    job.comp_flags = GetPNGCompressionFlags(props);
+
+    job.num_blocks = 1;
+    job.rows_per_block = h;
+    if (SDL_GetBooleanProperty(props, SDL_PROP_SURFACE_PNG_PARALLEL_BOOLEAN, false)) {
+        num_threads = SDL_GetParallelThreadCount();
+        if (num_threads > 1) {
+            job.rows_per_block = SDL_max(PNG_PARALLEL_BLOCK_SIZE / (job.row_size + 1), 1);
+            job.num_blocks = (h + job.rows_per_block - 1) / job.rows_per_block;
+        }
+        num_threads = SDL_min(num_threads, job.num_blocks);
+    }
+
+    job.outputs = (PNGOutput **)SDL_calloc(job.num_blocks, sizeof(*job.outputs));
+    job.adler = (Uint32 *)SDL_calloc(job.num_blocks, sizeof(*job.adler));
+    job.compressors = (tdefl_compressor **)SDL_calloc(num_threads, sizeof(*job.compressors));
+    job.scratch_size = (size_t)job.row_size + 2 * ((size_t)job.row_size + 1);
+    job.scratch = (Uint8 *)SDL_malloc(job.scratch_size * num_threads);
+    if (!job.outputs || !job.adler || !job.compressors || !job.scratch) {
+        goto done;
+    }
+    for (i = 0; i < num_threads; ++i) {
+        if (!(job.comp_flags & TDEFL_FORCE_ALL_RAW_BLOCKS)) {
+            job.compressors[i] = (tdefl_compressor *)SDL_malloc(sizeof(tdefl_compressor));
+            if (!job.compressors[i]) {
+                goto done;
+            }
+        }
+        SDL_memset(job.scratch + i * job.scratch_size, 0, job.row_size);
+    }
+    for (i = 0; i < job.num_blocks; ++i) {
+        job.outputs[i] = (PNGOutput *)SDL_calloc(1, sizeof(PNGOutput));
+        if (!job.outputs[i]) {
+            goto done;
+        }
+    }
+
+    if (job.num_blocks == 1) {
+        // Stream the chunks straight to the destination
+        stream = job.outputs[0];
+        stream->dst = dst;
+        result = CompressPNGBlock(&job, 0, 0);
+    } else {
+        result = SDL_RunParallel(CompressPNGBlock, &job, job.num_blocks, num_threads);
+        if (result) {
+            PNGOutput out;
+            Uint32 adler = job.adler[0];
+            Uint8 trailer[4];
+
+            for (i = 0; i < job.num_blocks; ++i) {
+                const int rows = SDL_min(job.rows_per_block, h - i * job.rows_per_block);
+
+                if (i > 0) {
+                    adler = CombinePNGAdler32(adler, job.adler[i], (size_t)rows * (job.row_size + 1));
+                }
+                if (SDL_WriteIO(dst, job.outputs[i]->data, job.outputs[i]->size) != job.outputs[i]->size) {
+                    result = false;
+                    break;
+                }
+            }
+
+            if (result) {
+                SDL_zero(out);
+                out.dst = dst;
+                trailer[0] = (Uint8)(adler >> 24);
+                trailer[1] = (Uint8)(adler >> 16);
+                trailer[2] = (Uint8)(adler >> 8);
+                trailer[3] = (Uint8)(adler >> 0);
+                result = WritePNGChunk(&out, "IDAT", trailer, sizeof(trailer));
+            }
+        }
+    }
+
+done:
+    if (job.outputs) {
+        for (i = 0; i < job.num_blocks; ++i) {
+            if (job.outputs[i]) {
+                SDL_free(job.outputs[i]->data);
+                SDL_free(job.outputs[i]);
+            }
+        }
+        SDL_free(job.outputs);
+    }
+    if (job.compressors) {
+        for (i = 0; i < num_threads; ++i) {
+            SDL_free(job.compressors[i]);
+        }
+        SDL_free(job.compressors);
+    }
+    SDL_free(job.adler);
+    SDL_free(job.scratch);
+    return result;
+}
+
+static bool WritePNG(SDL_IOStream *dst, const Uint8 *pixels, int w, int h, int pitch, int bpp, const Uint8 *plte, int plte_size, const Uint8 *trns, int trns_size, SDL_PropertiesID props)
+{
+    static const Uint8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    PNGOutput out;
+    Uint8 ihdr[13];
+
+    SDL_zero(out);
+    out.dst = dst;
+
+    ihdr[0] = (Uint8)(w >> 24);
+    ihdr[1] = (Uint8)(w >> 16);
+    ihdr[2] = (Uint8)(w >> 8);
+    ihdr[3] = (Uint8)(w >> 0);
+    ihdr[4] = (Uint8)(h >> 24);
+    ihdr[5] = (Uint8)(h >> 16);
+    ihdr[6] = (Uint8)(h >> 8);
+    ihdr[7] = (Uint8)(h >> 0);
+    ihdr[8] = 8;                        // bit depth
+    ihdr[9] = (plte_size > 0) ? 3 : 6;  // indexed or RGBA
+    ihdr[10] = 0;                       // deflate
+    ihdr[11] = 0;                       // adaptive filtering
+    ihdr[12] = 0;                       // no interlacing
+
+    if (!WritePNGData(&out, signature, sizeof(signature)) ||
+        !WritePNGChunk(&out, "IHDR", ihdr, sizeof(ihdr))) {
+        return false;
+    }
+    if (plte_size > 0 && !WritePNGChunk(&out, "PLTE", plte, plte_size)) {
+        return false;
+    }
+    if (trns_size > 0 && !WritePNGChunk(&out, "tRNS", trns, trns_size)) {
+        return false;
+    }
+    if (!WritePNGImageData(dst, pixels, w, h, pitch, bpp, (plte_size > 0), props)) {
+        return false;
+    }
+    return WritePNGChunk(&out, "IEND", NULL, 0);
+}
+#endif // SDL_HAVE_STB
+
 bool SDL_SavePNG_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
 {
     bool retval = false;
@@ -409,6 +1221,9 @@ bool SDL_SavePNG_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
     int plte_size = 0;
     int trns_size = 0;
 
+    // The options are read before the surface is converted
+    SDL_PropertiesID props = surface->props;
+
     if (SDL_ISPIXELFORMAT_INDEXED(surface->format)) {
         if (!surface->palette) {
             SDL_SetError("Indexed surfaces must have a palette");
@@ -447,16 +1262,7 @@ bool SDL_SavePNG_IO(SDL_Surface *surface, SDL_IOStream *dst, bool closeio)
         }
     }
 
-    size_t size = 0;
-    void *png = tdefl_write_image_to_png_file_in_memory_ex(surface->pixels, surface->w, surface->h, SDL_BYTESPERPIXEL(surface->format), surface->pitch, &size, 6, MZ_FALSE, plte, plte_size, trns, trns_size);
-    if (png) {
-        if (SDL_WriteIO(dst, png, size)) {
-            retval = true;
-        }
-        mz_free(png); /* calls SDL_free() */
-    } else {
-        SDL_SetError("Failed to convert and save image");
-    }
+    retval = WritePNG(dst, (const Uint8 *)surface->pixels, surface->w, surface->h, surface->pitch, SDL_BYTESPERPIXEL(surface->format), plte, plte_size, trns, trns_size, props);
 
 #else
     SDL_SetError("SDL not built with STB image support");
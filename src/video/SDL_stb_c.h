@@ -28,4 +28,9 @@
 
 extern bool SDL_ConvertPixels_STB(int width, int height, SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch, SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch);
 
+// Image loading functions
+
+// Decode a PNG or JPEG image into surface, or a new surface with format if surface is NULL. JPEG images are decoded at 1/scale of their size.
+extern SDL_Surface *SDL_LoadSTB_IO(SDL_IOStream *src, SDL_Surface *surface, SDL_PixelFormat format, int scale, SDL_Rect *rect);
+
 #endif // SDL_stb_c_h_
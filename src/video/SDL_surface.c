@@ -30,6 +30,7 @@
 #include "../render/SDL_sysrender.h"
 
 #include "SDL_surface_c.h"
+#include "../thread/SDL_parallel_c.h"
 
 
 // Check to make sure we can safely check multiplication of surface w and pitch and it won't overflow size_t
@@ -288,6 +289,72 @@ SDL_Surface *SDL_CreateSurfaceFrom(int width, int height, SDL_PixelFormat format
     return surface;
 }
 
+SDL_Surface *SDL_CreateSurfaceView(SDL_Surface *surface, const SDL_Rect *rect)
+{
+    SDL_Surface *view;
+    SDL_Rect bounds;
+    Uint8 *pixels;
+    int bpp;
+
+    CHECK_PARAM(!SDL_SurfaceValid(surface)) {
+        SDL_InvalidParamError("surface");
+        return NULL;
+    }
+
+    CHECK_PARAM(SDL_ISPIXELFORMAT_FOURCC(surface->format)) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = surface->w;
+    bounds.h = surface->h;
+    if (rect) {
+        CHECK_PARAM(rect->x < 0 || rect->y < 0 || rect->w < 0 || rect->h < 0 ||
+                    rect->w > surface->w - rect->x || rect->h > surface->h - rect->y) {
+            SDL_InvalidParamError("rect");
+            return NULL;
+        }
+        bounds = *rect;
+    }
+
+    bpp = SDL_BITSPERPIXEL(surface->format);
+    CHECK_PARAM(((bounds.x * bpp) % 8) != 0) {
+        SDL_InvalidParamError("rect");
+        return NULL;
+    }
+
+    // RLE encoded surfaces keep their original pixels around
+    pixels = (Uint8 *)(surface->pixels ? surface->pixels : surface->saved_pixels);
+    if (pixels) {
+        pixels += (size_t)bounds.y * surface->pitch + ((size_t)bounds.x * bpp) / 8;
+    }
+
+    view = (SDL_Surface *)SDL_malloc(sizeof(*view));
+    if (!view ||
+        !SDL_InitializeSurface(view, bounds.w, bounds.h, surface->format, surface->colorspace, surface->props, pixels, surface->pitch, false)) {
+        return NULL;
+    }
+
+    if (surface->palette) {
+        SDL_SetSurfacePalette(view, surface->palette);
+    }
+
+    view->map.info.flags = (surface->map.info.flags & ~(SDL_COPY_RLE_DESIRED | SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY));
+    view->map.info.colorkey = surface->map.info.colorkey;
+    view->map.info.r = surface->map.info.r;
+    view->map.info.g = surface->map.info.g;
+    view->map.info.b = surface->map.info.b;
+    view->map.info.a = surface->map.info.a;
+
+    // Keep the pixels alive as long as the view exists
+    ++surface->refcount;
+    view->parent = surface;
+
+    return view;
+}
+
 SDL_PropertiesID SDL_GetSurfaceProperties(SDL_Surface *surface)
 {
     CHECK_PARAM(!SDL_SurfaceValid(surface)) {
@@ -1855,6 +1922,148 @@ bool SDL_FlipSurface(SDL_Surface *surface, SDL_FlipMode flip)
     return result;
 }
 
+typedef enum
+{
+    SDL_DITHER_NONE,
+    SDL_DITHER_ORDERED,
+    SDL_DITHER_FLOYD_STEINBERG
+} SDL_DitherMode;
+
+static SDL_DitherMode SDL_GetSurfaceDitherMode(SDL_Surface *surface)
+{
+    const char *dither = SDL_GetStringProperty(surface->props, SDL_PROP_SURFACE_DITHER_STRING, NULL);
+
+    if (dither) {
+        if (SDL_strcasecmp(dither, "ordered") == 0) {
+            return SDL_DITHER_ORDERED;
+        }
+        if (SDL_strcasecmp(dither, "floyd-steinberg") == 0) {
+            return SDL_DITHER_FLOYD_STEINBERG;
+        }
+    }
+    return SDL_DITHER_NONE;
+}
+
+static SDL_INLINE Uint8 SDL_DitherClamp(int value)
+{
+    return (Uint8)SDL_clamp(value, 0, 255);
+}
+
+/*
+ * Convert a rectangle of a non-indexed surface to an 8-bit paletted surface,
+ * spreading the quantization error so gradients don't band.
+ */
+static bool SDL_DitherSurface(SDL_Surface *src, const SDL_Rect *rect, SDL_Surface *dst, SDL_DitherMode mode)
+{
+    static const int bayer[4][4] = {
+        { 0, 8, 2, 10 },
+        { 12, 4, 14, 6 },
+        { 3, 11, 1, 9 },
+        { 15, 7, 13, 5 }
+    };
+    const SDL_Palette *palette = dst->palette;
+    const int w = rect->w;
+    const int h = rect->h;
+    SDL_PaletteLookup *lookup = NULL;
+    Uint32 *rgba = NULL;
+    int *errors = NULL;
+    int *error_row, *error_next;
+    const Uint8 *src_pixels;
+    int levels, spread;
+    int x, y, i;
+    bool result = false;
+
+    if (w <= 0 || h <= 0) {
+        return true;
+    }
+
+    lookup = SDL_CreatePaletteLookup();
+    rgba = (Uint32 *)SDL_malloc((size_t)w * h * sizeof(*rgba));
+    errors = (int *)SDL_calloc(2 * (w + 2) * 3, sizeof(*errors));
+    if (!lookup || !rgba || !errors) {
+        goto done;
+    }
+
+    if (!SDL_LockSurface(src)) {
+        goto done;
+    }
+    src_pixels = (const Uint8 *)src->pixels + rect->y * src->pitch + rect->x * SDL_BYTESPERPIXEL(src->format);
+    result = SDL_ConvertPixelsAndColorspace(w, h, src->format, src->colorspace, src->props, src_pixels, src->pitch, SDL_PIXELFORMAT_RGBA8888, SDL_COLORSPACE_SRGB, 0, rgba, w * sizeof(*rgba));
+    SDL_UnlockSurface(src);
+    if (!result) {
+        goto done;
+    }
+
+    // Estimate the distance between palette colors, assuming an RGB cube
+    levels = 2;
+    while ((levels + 1) * (levels + 1) * (levels + 1) <= palette->ncolors) {
+        ++levels;
+    }
+    spread = 255 / (levels - 1);
+
+    error_row = errors;
+    error_next = errors + (w + 2) * 3;
+    for (y = 0; y < h; ++y) {
+        const Uint32 *in = rgba + y * w;
+        Uint8 *out = (Uint8 *)dst->pixels + y * dst->pitch;
+
+        for (x = 0; x < w; ++x) {
+            const Uint32 pixel = in[x];
+            int r = (int)((pixel >> 24) & 0xFF);
+            int g = (int)((pixel >> 16) & 0xFF);
+            int b = (int)((pixel >> 8) & 0xFF);
+            Uint8 index;
+
+            if (mode == SDL_DITHER_ORDERED) {
+                const int offset = ((2 * bayer[y & 3][x & 3] - 15) * spread) / 32;
+                r += offset;
+                g += offset;
+                b += offset;
+            } else {
+                // Errors are stored in 1/16ths, offset by one pixel on each side
+                int *error = &error_row[(x + 1) * 3];
+                r += error[0] / 16;
+                g += error[1] / 16;
+                b += error[2] / 16;
+            }
+            r = SDL_DitherClamp(r);
+            g = SDL_DitherClamp(g);
+            b = SDL_DitherClamp(b);
+
+            index = SDL_LookupRGBAColor(lookup, ((Uint32)r << 24) | ((Uint32)g << 16) | ((Uint32)b << 8) | (pixel & 0xFF), palette);
+            out[x] = index;
+
+            if (mode == SDL_DITHER_FLOYD_STEINBERG) {
+                const SDL_Color *color = &palette->colors[index];
+                const int diff[3] = { r - color->r, g - color->g, b - color->b };
+                int *right = &error_row[(x + 2) * 3];
+                int *below = &error_next[x * 3];
+
+                for (i = 0; i < 3; ++i) {
+                    right[i] += diff[i] * 7;
+                    below[i] += diff[i] * 3;
+                    below[3 + i] += diff[i] * 5;
+                    below[6 + i] += diff[i];
+                }
+            }
+        }
+
+        if (mode == SDL_DITHER_FLOYD_STEINBERG) {
+            int *swap = error_row;
+            error_row = error_next;
+            error_next = swap;
+            SDL_memset(error_next, 0, (w + 2) * 3 * sizeof(*error_next));
+        }
+    }
+    result = true;
+
+done:
+    SDL_free(errors);
+    SDL_free(rgba);
+    SDL_DestroyPaletteLookup(lookup);
+    return result;
+}
+
 static SDL_Surface *SDL_ConvertSurfaceRectAndColorspace(SDL_Surface *surface, const SDL_Rect *rect, SDL_PixelFormat format, SDL_Palette *palette, SDL_Colorspace colorspace, SDL_PropertiesID props)
 {
     SDL_Palette *temp_palette = NULL;
@@ -2008,7 +2217,17 @@ static SDL_Surface *SDL_ConvertSurfaceRectAndColorspace(SDL_Surface *surface, co
     }
 
     if (surface->pixels || SDL_MUSTLOCK(surface)) {
-        result = SDL_BlitSurfaceUnchecked(surface, rect, convert, &bounds);
+        SDL_DitherMode dither = SDL_DITHER_NONE;
+
+        if (format == SDL_PIXELFORMAT_INDEX8 && !SDL_ISPIXELFORMAT_INDEXED(surface->format) &&
+            !(copy_flags & SDL_COPY_COLORKEY)) {
+            dither = SDL_GetSurfaceDitherMode(surface);
+        }
+        if (dither != SDL_DITHER_NONE) {
+            result = SDL_DitherSurface(surface, rect, convert, dither);
+        } else {
+            result = SDL_BlitSurfaceUnchecked(surface, rect, convert, &bounds);
+        }
     } else {
         result = true;
     }
@@ -2338,7 +2557,37 @@ SDL_Surface *SDL_DuplicatePixels(int width, int height, SDL_PixelFormat format,
     return surface;
 }
 
-bool SDL_ConvertPixelsAndColorspace(int width, int height,
+/* Images with fewer pixels than this are converted in one piece on the calling thread */
+#define CONVERSION_STRIPE_MIN_PIXELS (512 * 512)
+#define CONVERSION_STRIPE_MIN_ROWS   16
+#define CONVERSION_STRIPE_MAX_ROWS   128
+
+/* Split the conversion of an image into stripes of rows that can be converted
+ * in parallel. Multi-step conversions use scratch memory for a stripe on each
+ * thread, so the stripes are kept short to bound the memory used.
+ */
+int SDL_GetConversionStripes(int width, int height, int alignment, int *stripe_height, int *num_threads)
+{
+    int rows;
+
+    if ((Sint64)width * height < CONVERSION_STRIPE_MIN_PIXELS) {
+        *stripe_height = height;
+        *num_threads = 1;
+        return 1;
+    }
+
+    *num_threads = SDL_GetParallelThreadCount();
+
+    // Aim for a few stripes per thread so they balance out if some threads are busy
+    rows = (height + (*num_threads * 4) - 1) / (*num_threads * 4);
+    rows = SDL_clamp(rows, CONVERSION_STRIPE_MIN_ROWS, CONVERSION_STRIPE_MAX_ROWS);
+    rows = ((rows + alignment - 1) / alignment) * alignment;
+
+    *stripe_height = rows;
+    return (height + rows - 1) / rows;
+}
+
+static bool SDL_ConvertPixels_Blit(int width, int height,
                       SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch,
                       SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
 {
@@ -2348,6 +2597,63 @@ bool SDL_ConvertPixelsAndColorspace(int width, int height,
     void *nonconst_src = (void *)src;
     bool result;
 
+    if (!SDL_InitializeSurface(&src_surface, width, height, src_format, src_colorspace, src_properties, nonconst_src, src_pitch, true)) {
+        return false;
+    }
+    SDL_SetSurfaceBlendMode(&src_surface, SDL_BLENDMODE_NONE);
+
+    if (!SDL_InitializeSurface(&dst_surface, width, height, dst_format, dst_colorspace, dst_properties, dst, dst_pitch, true)) {
+        return false;
+    }
+
+    // Set up the rect and go!
+    rect.x = 0;
+    rect.y = 0;
+    rect.w = width;
+    rect.h = height;
+    result = SDL_BlitSurfaceUnchecked(&src_surface, &rect, &dst_surface, &rect);
+
+    SDL_DestroySurface(&src_surface);
+    SDL_DestroySurface(&dst_surface);
+
+    return result;
+}
+
+typedef struct SDL_ConvertPixelsStripes
+{
+    int width;
+    int height;
+    int stripe_height;
+    SDL_PixelFormat src_format;
+    SDL_Colorspace src_colorspace;
+    SDL_PropertiesID src_properties;
+    const Uint8 *src;
+    int src_pitch;
+    SDL_PixelFormat dst_format;
+    SDL_Colorspace dst_colorspace;
+    SDL_PropertiesID dst_properties;
+    Uint8 *dst;
+    int dst_pitch;
+} SDL_ConvertPixelsStripes;
+
+static bool SDL_ConvertPixelsStripe(void *userdata, int item, int slot)
+{
+    const SDL_ConvertPixelsStripes *job = (const SDL_ConvertPixelsStripes *)userdata;
+    const int y = item * job->stripe_height;
+    const int rows = SDL_min(job->stripe_height, job->height - y);
+
+    return SDL_ConvertPixels_Blit(job->width, rows,
+                                  job->src_format, job->src_colorspace, job->src_properties, job->src + (size_t)y * job->src_pitch, job->src_pitch,
+                                  job->dst_format, job->dst_colorspace, job->dst_properties, job->dst + (size_t)y * job->dst_pitch, job->dst_pitch);
+}
+
+bool SDL_ConvertPixelsAndColorspace(int width, int height,
+                      SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch,
+                      SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
+{
+    SDL_ConvertPixelsStripes job;
+    int num_stripes, num_threads;
+
     CHECK_PARAM(!src) {
         return SDL_InvalidParamError("src");
     }
@@ -2403,26 +2709,24 @@ bool SDL_ConvertPixelsAndColorspace(int width, int height,
         return true;
     }
 
-    if (!SDL_InitializeSurface(&src_surface, width, height, src_format, src_colorspace, src_properties, nonconst_src, src_pitch, true)) {
-        return false;
+    num_stripes = SDL_GetConversionStripes(width, height, 1, &job.stripe_height, &num_threads);
+    if (num_stripes == 1) {
+        return SDL_ConvertPixels_Blit(width, height, src_format, src_colorspace, src_properties, src, src_pitch, dst_format, dst_colorspace, dst_properties, dst, dst_pitch);
     }
-    SDL_SetSurfaceBlendMode(&src_surface, SDL_BLENDMODE_NONE);
-
-    if (!SDL_InitializeSurface(&dst_surface, width, height, dst_format, dst_colorspace, dst_properties, dst, dst_pitch, true)) {
-        return false;
-    }
-
-    // Set up the rect and go!
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = width;
-    rect.h = height;
-    result = SDL_BlitSurfaceUnchecked(&src_surface, &rect, &dst_surface, &rect);
 
-    SDL_DestroySurface(&src_surface);
-    SDL_DestroySurface(&dst_surface);
-
-    return result;
+    job.width = width;
+    job.height = height;
+    job.src_format = src_format;
+    job.src_colorspace = src_colorspace;
+    job.src_properties = src_properties;
+    job.src = (const Uint8 *)src;
+    job.src_pitch = src_pitch;
+    job.dst_format = dst_format;
+    job.dst_colorspace = dst_colorspace;
+    job.dst_properties = dst_properties;
+    job.dst = (Uint8 *)dst;
+    job.dst_pitch = dst_pitch;
+    return SDL_RunParallel(SDL_ConvertPixelsStripe, &job, num_stripes, num_threads);
 }
 
 bool SDL_ConvertPixels(int width, int height, SDL_PixelFormat src_format, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch)
@@ -2531,13 +2835,333 @@ static void SDL_PremultiplyAlpha_AXYZ128(int width, int height, const void *src,
     }
 }
 
-static bool SDL_PremultiplyAlphaPixelsAndColorspace(int width, int height, SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch, SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch, bool linear)
+static void SDL_UnpremultiplyAlpha_8888(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, int alpha_shift)
+{
+    const Uint32 alpha_mask = (0xFFu << alpha_shift);
+    int c, shift;
+    Uint32 srcpixel, srcA;
+    Uint32 dstpixel, dstC;
+
+    while (height--) {
+        const Uint32 *src_px = (const Uint32 *)src;
+        Uint32 *dst_px = (Uint32 *)dst;
+        for (c = width; c; --c) {
+            srcpixel = *src_px++;
+            srcA = (srcpixel & alpha_mask) >> alpha_shift;
+
+            // Divide each color component by alpha, rounding to nearest.
+            dstpixel = (srcpixel & alpha_mask);
+            if (srcA) {
+                for (shift = 0; shift < 32; shift += 8) {
+                    if (shift != alpha_shift) {
+                        dstC = (((srcpixel >> shift) & 0xFF) * 255 + srcA / 2) / srcA;
+                        if (dstC > 255) {
+                            dstC = 255;
+                        }
+                        dstpixel |= (dstC << shift);
+                    }
+                }
+            }
+            *dst_px++ = dstpixel;
+        }
+        src = (const Uint8 *)src + src_pitch;
+        dst = (Uint8 *)dst + dst_pitch;
+    }
+}
+
+static void SDL_UnpremultiplyAlpha_AXYZ128(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch)
+{
+    int c;
+    float flR, flG, flB, flA;
+
+    while (height--) {
+        const float *src_px = (const float *)src;
+        float *dst_px = (float *)dst;
+        for (c = width; c; --c) {
+            flA = *src_px++;
+            flR = *src_px++;
+            flG = *src_px++;
+            flB = *src_px++;
+
+            // Alpha division of each component.
+            if (flA != 0.0f) {
+                flR /= flA;
+                flG /= flA;
+                flB /= flA;
+            } else {
+                flR = flG = flB = 0.0f;
+            }
+
+            *dst_px++ = flA;
+            *dst_px++ = flR;
+            *dst_px++ = flG;
+            *dst_px++ = flB;
+        }
+        src = (const Uint8 *)src + src_pitch;
+        dst = (Uint8 *)dst + dst_pitch;
+    }
+}
+
+/*
+ * Premultiplying sRGB pixels in linear space normally goes through a float
+ * surface. For 8-bit channels the result only depends on the alpha and
+ * color values, so we look it up in a table computed the same way instead.
+ */
+static SDL_InitState SDL_linear_alpha_init;
+static Uint8 SDL_linear_premultiply[256][256];
+static Uint8 SDL_linear_unpremultiply[256][256];
+
+static void SDL_InitLinearAlphaTables(void)
+{
+    int a, c;
+
+    if (!SDL_ShouldInit(&SDL_linear_alpha_init)) {
+        return;
+    }
+
+    for (a = 0; a < 256; ++a) {
+        const float flA = (float)a / 255.0f;
+        for (c = 0; c < 256; ++c) {
+            const float flC = SDL_sRGBtoLinear((float)c / 255.0f);
+            SDL_linear_premultiply[a][c] = (Uint8)SDL_roundf(SDL_clamp(SDL_sRGBfromLinear(flC * flA), 0.0f, 1.0f) * 255.0f);
+            if (a) {
+                SDL_linear_unpremultiply[a][c] = (Uint8)SDL_roundf(SDL_clamp(SDL_sRGBfromLinear(flC / flA), 0.0f, 1.0f) * 255.0f);
+            } else {
+                SDL_linear_unpremultiply[a][c] = 0;
+            }
+        }
+    }
+
+    SDL_SetInitialized(&SDL_linear_alpha_init, true);
+}
+
+static void SDL_ApplyAlphaTable_8888(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, int alpha_shift, Uint8 table[256][256])
+{
+    const Uint32 alpha_mask = (0xFFu << alpha_shift);
+    int c, shift;
+    Uint32 srcpixel;
+    Uint32 dstpixel;
+    const Uint8 *row;
+
+    while (height--) {
+        const Uint32 *src_px = (const Uint32 *)src;
+        Uint32 *dst_px = (Uint32 *)dst;
+        for (c = width; c; --c) {
+            srcpixel = *src_px++;
+            row = table[(srcpixel & alpha_mask) >> alpha_shift];
+
+            dstpixel = (srcpixel & alpha_mask);
+            for (shift = 0; shift < 32; shift += 8) {
+                if (shift != alpha_shift) {
+                    dstpixel |= ((Uint32)row[(srcpixel >> shift) & 0xFF] << shift);
+                }
+            }
+            *dst_px++ = dstpixel;
+        }
+        src = (const Uint8 *)src + src_pitch;
+        dst = (Uint8 *)dst + dst_pitch;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+/*
+ * These process 4 pixels at a time and leave the remaining columns to the
+ * scalar code. The results are identical to the scalar versions.
+ */
+static int SDL_TARGETING("sse2") SDL_PremultiplyAlpha_8888_SSE2(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, int alpha_shift)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i shift = _mm_cvtsi32_si128(alpha_shift);
+    const __m128i alpha_mask = _mm_sll_epi32(_mm_set1_epi32(0xFF), shift);
+    const int count = (width & ~3);
+    int c;
+
+    while (height--) {
+        const Uint8 *src_px = (const Uint8 *)src;
+        Uint8 *dst_px = (Uint8 *)dst;
+        for (c = 0; c < count; c += 4) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *)src_px);
+            __m128i alpha = _mm_srl_epi32(_mm_and_si128(pixels, alpha_mask), shift);
+            __m128i lo, hi;
+
+            // Spread each pixel's alpha to the 16-bit lanes of its components
+            alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+            lo = _mm_mullo_epi16(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi32(alpha, alpha));
+            hi = _mm_mullo_epi16(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi32(alpha, alpha));
+
+            // x / 255 == (x + 1 + (x >> 8)) >> 8 for x in [0, 255 * 255]
+            lo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(lo, one), _mm_srli_epi16(lo, 8)), 8);
+            hi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(hi, one), _mm_srli_epi16(hi, 8)), 8);
+
+            lo = _mm_packus_epi16(lo, hi);
+            lo = _mm_or_si128(_mm_andnot_si128(alpha_mask, lo), _mm_and_si128(alpha_mask, pixels));
+            _mm_storeu_si128((__m128i *)dst_px, lo);
+
+            src_px += 16;
+            dst_px += 16;
+        }
+        src = (const Uint8 *)src + src_pitch;
+        dst = (Uint8 *)dst + dst_pitch;
+    }
+    return count;
+}
+
+/* Divide the components of one pixel, the alpha and rounding values are broadcast */
+#define UNPREMULTIPLY_PIXEL_SSE2(pixel, alpha, half) \
+    _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_sub_epi32(_mm_slli_epi32(pixel, 8), pixel), half)), alpha))
+
+static int SDL_TARGETING("sse2") SDL_UnpremultiplyAlpha_8888_SSE2(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, int alpha_shift)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i shift = _mm_cvtsi32_si128(alpha_shift);
+    const __m128i alpha_mask = _mm_sll_epi32(_mm_set1_epi32(0xFF), shift);
+    const int count = (width & ~3);
+    int c;
+
+    while (height--) {
+        const Uint8 *src_px = (const Uint8 *)src;
+        Uint8 *dst_px = (Uint8 *)dst;
+        for (c = 0; c < count; c += 4) {
+            const __m128i pixels = _mm_loadu_si128((const __m128i *)src_px);
+            const __m128i alpha = _mm_srl_epi32(_mm_and_si128(pixels, alpha_mask), shift);
+            const __m128i half = _mm_srli_epi32(alpha, 1);
+            const __m128 flA = _mm_cvtepi32_ps(alpha);
+            const __m128i lo = _mm_unpacklo_epi8(pixels, zero);
+            const __m128i hi = _mm_unpackhi_epi8(pixels, zero);
+            __m128i p0, p1, p2, p3;
+
+            /* (c * 255 + a / 2) / a is below 2^24, so the float division
+               truncates to the same value as the integer division. Division
+               by zero gives NaN or infinity, which saturate to 0 below,
+               and results above 255 saturate to 255. */
+            p0 = UNPREMULTIPLY_PIXEL_SSE2(_mm_unpacklo_epi16(lo, zero), _mm_shuffle_ps(flA, flA, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_epi32(half, _MM_SHUFFLE(0, 0, 0, 0)));
+            p1 = UNPREMULTIPLY_PIXEL_SSE2(_mm_unpackhi_epi16(lo, zero), _mm_shuffle_ps(flA, flA, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 1, 1, 1)));
+            p2 = UNPREMULTIPLY_PIXEL_SSE2(_mm_unpacklo_epi16(hi, zero), _mm_shuffle_ps(flA, flA, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 2, 2, 2)));
+            p3 = UNPREMULTIPLY_PIXEL_SSE2(_mm_unpackhi_epi16(hi, zero), _mm_shuffle_ps(flA, flA, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_epi32(half, _MM_SHUFFLE(3, 3, 3, 3)));
+
+            p0 = _mm_packus_epi16(_mm_packs_epi32(p0, p1), _mm_packs_epi32(p2, p3));
+            p0 = _mm_or_si128(_mm_andnot_si128(alpha_mask, p0), _mm_and_si128(alpha_mask, pixels));
+            _mm_storeu_si128((__m128i *)dst_px, p0);
+
+            src_px += 16;
+            dst_px += 16;
+        }
+        src = (const Uint8 *)src + src_pitch;
+        dst = (Uint8 *)dst + dst_pitch;
+    }
+    return count;
+}
+
+#undef UNPREMULTIPLY_PIXEL_SSE2
+
+static void SDL_TARGETING("sse2") SDL_MultiplyAlpha_AXYZ128_SSE2(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, bool premultiply)
+{
+    const __m128 zero = _mm_setzero_ps();
+    int c;
+
+    while (height--) {
+        const float *src_px = (const float *)src;
+        float *dst_px = (float *)dst;
+        for (c = width; c; --c) {
+            const __m128 pixel = _mm_loadu_ps(src_px);
+            const __m128 alpha = _mm_shuffle_ps(pixel, pixel, _MM_SHUFFLE(0, 0, 0, 0));
+            __m128 result;
+
+            if (premultiply) {
+                result = _mm_mul_ps(pixel, alpha);
+            } else {
+                result = _mm_and_ps(_mm_div_ps(pixel, alpha), _mm_cmpneq_ps(alpha, zero));
+            }
+            // Keep the original alpha in the first lane
+            _mm_storeu_ps(dst_px, _mm_move_ss(result, pixel));
+
+            src_px += 4;
+            dst_px += 4;
+        }
+        src = (const Uint8 *)src + src_pitch;
+        dst = (Uint8 *)dst + dst_pitch;
+    }
+}
+
+static SDL_INLINE int hasSSE2(void)
+{
+    static int val = -1;
+    if (val != -1) {
+        return val;
+    }
+    val = SDL_HasSSE2();
+    return val;
+}
+#endif // SDL_SSE2_INTRINSICS
+
+static void SDL_MultiplyAlpha_8888(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, int alpha_shift, bool premultiply)
+{
+    int count = 0;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (hasSSE2()) {
+        if (premultiply) {
+            count = SDL_PremultiplyAlpha_8888_SSE2(width, height, src, src_pitch, dst, dst_pitch, alpha_shift);
+        } else {
+            count = SDL_UnpremultiplyAlpha_8888_SSE2(width, height, src, src_pitch, dst, dst_pitch, alpha_shift);
+        }
+        if (count == width) {
+            return;
+        }
+    }
+#endif
+
+    // Handle the remaining columns
+    src = (const Uint8 *)src + count * 4;
+    dst = (Uint8 *)dst + count * 4;
+    width -= count;
+    if (!premultiply) {
+        SDL_UnpremultiplyAlpha_8888(width, height, src, src_pitch, dst, dst_pitch, alpha_shift);
+    } else if (alpha_shift == 24) {
+        SDL_PremultiplyAlpha_AXYZ8888(width, height, src, src_pitch, dst, dst_pitch);
+    } else {
+        SDL_PremultiplyAlpha_XYZA8888(width, height, src, src_pitch, dst, dst_pitch);
+    }
+}
+
+static void SDL_MultiplyAlpha_AXYZ128(int width, int height, const void *src, int src_pitch, void *dst, int dst_pitch, bool premultiply)
+{
+#ifdef SDL_SSE2_INTRINSICS
+    if (hasSSE2()) {
+        SDL_MultiplyAlpha_AXYZ128_SSE2(width, height, src, src_pitch, dst, dst_pitch, premultiply);
+        return;
+    }
+#endif
+    if (premultiply) {
+        SDL_PremultiplyAlpha_AXYZ128(width, height, src, src_pitch, dst, dst_pitch);
+    } else {
+        SDL_UnpremultiplyAlpha_AXYZ128(width, height, src, src_pitch, dst, dst_pitch);
+    }
+}
+
+static int SDL_GetAlphaShift8888(SDL_PixelFormat format)
+{
+    switch (format) {
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        return 24;
+    case SDL_PIXELFORMAT_RGBA8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+static bool SDL_MultiplyAlphaPixelsAndColorspace(int width, int height, SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch, SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch, bool linear, bool premultiply)
 {
     SDL_Surface *convert = NULL;
     void *final_dst = dst;
     int final_dst_pitch = dst_pitch;
     SDL_PixelFormat format;
     SDL_Colorspace colorspace;
+    int alpha_shift;
     bool result = false;
 
     CHECK_PARAM(!src) {
@@ -2553,6 +3177,16 @@ static bool SDL_PremultiplyAlphaPixelsAndColorspace(int width, int height, SDL_P
         return SDL_InvalidParamError("dst_pitch");
     }
 
+    // Linear alpha on sRGB 8888 pixels can be done without the round trip through a float format
+    alpha_shift = SDL_GetAlphaShift8888(src_format);
+    if (linear && alpha_shift >= 0 && src_format == dst_format &&
+        src_colorspace == SDL_COLORSPACE_SRGB && dst_colorspace == SDL_COLORSPACE_SRGB) {
+        SDL_InitLinearAlphaTables();
+        SDL_ApplyAlphaTable_8888(width, height, src, src_pitch, dst, dst_pitch, alpha_shift,
+                                 premultiply ? SDL_linear_premultiply : SDL_linear_unpremultiply);
+        return true;
+    }
+
     // Use a high precision format if we're converting to linear colorspace or using high precision pixel formats
     if (linear ||
         SDL_ISPIXELFORMAT_10BIT(src_format) || SDL_BITSPERPIXEL(src_format) > 32 ||
@@ -2605,15 +3239,13 @@ static bool SDL_PremultiplyAlphaPixelsAndColorspace(int width, int height, SDL_P
     switch (format) {
     case SDL_PIXELFORMAT_ARGB8888:
     case SDL_PIXELFORMAT_ABGR8888:
-        SDL_PremultiplyAlpha_AXYZ8888(width, height, src, src_pitch, dst, dst_pitch);
-        break;
     case SDL_PIXELFORMAT_RGBA8888:
     case SDL_PIXELFORMAT_BGRA8888:
-        SDL_PremultiplyAlpha_XYZA8888(width, height, src, src_pitch, dst, dst_pitch);
+        SDL_MultiplyAlpha_8888(width, height, src, src_pitch, dst, dst_pitch, SDL_GetAlphaShift8888(format), premultiply);
         break;
     case SDL_PIXELFORMAT_ARGB128_FLOAT:
     case SDL_PIXELFORMAT_ABGR128_FLOAT:
-        SDL_PremultiplyAlpha_AXYZ128(width, height, src, src_pitch, dst, dst_pitch);
+        SDL_MultiplyAlpha_AXYZ128(width, height, src, src_pitch, dst, dst_pitch, premultiply);
         break;
     default:
         SDL_SetError("Unexpected internal pixel format");
@@ -2641,7 +3273,7 @@ bool SDL_PremultiplyAlpha(int width, int height,
     SDL_Colorspace src_colorspace = SDL_GetDefaultColorspaceForFormat(src_format);
     SDL_Colorspace dst_colorspace = SDL_GetDefaultColorspaceForFormat(dst_format);
 
-    return SDL_PremultiplyAlphaPixelsAndColorspace(width, height, src_format, src_colorspace, 0, src, src_pitch, dst_format, dst_colorspace, 0, dst, dst_pitch, linear);
+    return SDL_MultiplyAlphaPixelsAndColorspace(width, height, src_format, src_colorspace, 0, src, src_pitch, dst_format, dst_colorspace, 0, dst, dst_pitch, linear, true);
 }
 
 bool SDL_PremultiplySurfaceAlpha(SDL_Surface *surface, bool linear)
@@ -2654,7 +3286,30 @@ bool SDL_PremultiplySurfaceAlpha(SDL_Surface *surface, bool linear)
 
     colorspace = surface->colorspace;
 
-    return SDL_PremultiplyAlphaPixelsAndColorspace(surface->w, surface->h, surface->format, colorspace, surface->props, surface->pixels, surface->pitch, surface->format, colorspace, surface->props, surface->pixels, surface->pitch, linear);
+    return SDL_MultiplyAlphaPixelsAndColorspace(surface->w, surface->h, surface->format, colorspace, surface->props, surface->pixels, surface->pitch, surface->format, colorspace, surface->props, surface->pixels, surface->pitch, linear, true);
+}
+
+bool SDL_UnpremultiplyAlpha(int width, int height,
+                           SDL_PixelFormat src_format, const void *src, int src_pitch,
+                           SDL_PixelFormat dst_format, void *dst, int dst_pitch, bool linear)
+{
+    SDL_Colorspace src_colorspace = SDL_GetDefaultColorspaceForFormat(src_format);
+    SDL_Colorspace dst_colorspace = SDL_GetDefaultColorspaceForFormat(dst_format);
+
+    return SDL_MultiplyAlphaPixelsAndColorspace(width, height, src_format, src_colorspace, 0, src, src_pitch, dst_format, dst_colorspace, 0, dst, dst_pitch, linear, false);
+}
+
+bool SDL_UnpremultiplySurfaceAlpha(SDL_Surface *surface, bool linear)
+{
+    SDL_Colorspace colorspace;
+
+    CHECK_PARAM(!SDL_SurfaceValid(surface)) {
+        return SDL_InvalidParamError("surface");
+    }
+
+    colorspace = surface->colorspace;
+
+    return SDL_MultiplyAlphaPixelsAndColorspace(surface->w, surface->h, surface->format, colorspace, surface->props, surface->pixels, surface->pitch, surface->format, colorspace, surface->props, surface->pixels, surface->pitch, linear, false);
 }
 
 bool SDL_ClearSurface(SDL_Surface *surface, float r, float g, float b, float a)
@@ -3079,6 +3734,9 @@ void SDL_DestroySurface(SDL_Surface *surface)
 
     surface->reserved = NULL;
 
+    SDL_DestroySurface(surface->parent);
+    surface->parent = NULL;
+
     if (!(surface->internal_flags & SDL_INTERNAL_SURFACE_STACK)) {
         SDL_free(surface);
     }
@@ -3108,3 +3766,160 @@ SDL_Surface *SDL_LoadSurface(const char *file)
 
     return SDL_LoadSurface_IO(stream, true);
 }
+
+void SDL_SetSurfacePaddingBits(SDL_Surface *surface, const SDL_Rect *rect)
+{
+    const SDL_PixelFormatDetails *fmt = surface->fmt;
+    Uint32 padding;
+    int x, y;
+
+    if (fmt->bytes_per_pixel != 4 || fmt->Amask || SDL_ISPIXELFORMAT_INDEXED(surface->format) || SDL_ISPIXELFORMAT_FOURCC(surface->format)) {
+        return;
+    }
+    padding = ~(fmt->Rmask | fmt->Gmask | fmt->Bmask);
+    if (!padding) {
+        return;
+    }
+
+    for (y = rect->y; y < rect->y + rect->h; ++y) {
+        Uint32 *pixel = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch) + rect->x;
+        for (x = 0; x < rect->w; ++x) {
+            *pixel++ |= padding;
+        }
+    }
+}
+
+// Scale down and convert an image that was decoded at full size, or copy it into the destination surface
+static SDL_Surface *SDL_FinishLoadingSurface(SDL_Surface *image, SDL_Surface *surface, SDL_PixelFormat format, int scale, SDL_Rect *rect)
+{
+    if (scale > 1) {
+        SDL_Surface *scaled = SDL_ScaleSurface(image, (image->w + scale - 1) / scale, (image->h + scale - 1) / scale, SDL_SCALEMODE_LINEAR);
+        SDL_DestroySurface(image);
+        if (!scaled) {
+            return NULL;
+        }
+        image = scaled;
+    }
+
+    if (surface) {
+        SDL_Surface *converted;
+        SDL_Rect area;
+        bool result;
+
+        // Convert first so transparency is handled the way SDL_ConvertSurface() does
+        converted = SDL_ConvertSurface(image, surface->format);
+        SDL_DestroySurface(image);
+        if (!converted) {
+            return NULL;
+        }
+        SDL_SetSurfaceBlendMode(converted, SDL_BLENDMODE_NONE);
+        SDL_SetSurfaceColorKey(converted, false, 0);
+
+        area.x = 0;
+        area.y = 0;
+        area.w = SDL_min(converted->w, surface->w);
+        area.h = SDL_min(converted->h, surface->h);
+        SDL_SetSurfacePaddingBits(converted, &area);
+        result = SDL_LockSurface(surface);
+        if (result) {
+            result = SDL_BlitSurfaceUnchecked(converted, &area, surface, &area);
+            SDL_UnlockSurface(surface);
+        }
+        SDL_DestroySurface(converted);
+        if (!result) {
+            return NULL;
+        }
+        if (rect) {
+            *rect = area;
+        }
+        return surface;
+    }
+
+    if (format != SDL_PIXELFORMAT_UNKNOWN && format != image->format) {
+        SDL_Surface *converted = SDL_ConvertSurface(image, format);
+        SDL_DestroySurface(image);
+        image = converted;
+        if (image) {
+            SDL_Rect area = { 0, 0, image->w, image->h };
+            SDL_SetSurfacePaddingBits(image, &area);
+        }
+    }
+    return image;
+}
+
+static SDL_Surface *SDL_LoadSurfaceInternal(SDL_IOStream *src, SDL_Surface *surface, SDL_PropertiesID props, SDL_Rect *rect)
+{
+    SDL_PixelFormat format = SDL_PIXELFORMAT_UNKNOWN;
+    int scale = (int)SDL_GetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, 1);
+    SDL_Surface *image;
+
+    if (!surface) {
+        format = (SDL_PixelFormat)SDL_GetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_UNKNOWN);
+    }
+    if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        SDL_SetError("Unsupported scale %d, expected 1, 2, 4 or 8", scale);
+        return NULL;
+    }
+
+    // JPEG images are scaled while they're decoded, and both are decoded straight into the destination
+    if (SDL_IsJPEG(src) || (SDL_IsPNG(src) && scale == 1)) {
+        return SDL_LoadSTB_IO(src, surface, format, scale, rect);
+    }
+
+    if (SDL_IsBMP(src)) {
+        image = SDL_LoadBMP_IOInternal(src, false, format);
+    } else if (SDL_IsPNG(src)) {
+        image = SDL_LoadPNG_IO(src, false);
+    } else {
+        SDL_SetError("Unsupported image format");
+        return NULL;
+    }
+    if (!image) {
+        return NULL;
+    }
+    return SDL_FinishLoadingSurface(image, surface, format, scale, rect);
+}
+
+SDL_Surface *SDL_LoadSurfaceWithProperties(SDL_IOStream *src, bool closeio, SDL_PropertiesID props)
+{
+    SDL_Surface *surface = NULL;
+
+    CHECK_PARAM(!src) {
+        SDL_InvalidParamError("src");
+        goto done;
+    }
+
+    surface = SDL_LoadSurfaceInternal(src, NULL, props, NULL);
+
+done:
+    if (src && closeio) {
+        SDL_CloseIO(src);
+    }
+    return surface;
+}
+
+bool SDL_LoadIntoSurface_IO(SDL_IOStream *src, bool closeio, SDL_Surface *surface, SDL_PropertiesID props, SDL_Rect *rect)
+{
+    bool result = false;
+
+    CHECK_PARAM(!src) {
+        SDL_InvalidParamError("src");
+        goto done;
+    }
+    CHECK_PARAM(!SDL_SurfaceValid(surface) || (!surface->pixels && !SDL_MUSTLOCK(surface))) {
+        SDL_InvalidParamError("surface");
+        goto done;
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(surface->format)) {
+        SDL_SetError("Can't load images into %s surfaces", SDL_GetPixelFormatName(surface->format));
+        goto done;
+    }
+
+    result = (SDL_LoadSurfaceInternal(src, surface, props, rect) != NULL);
+
+done:
+    if (src && closeio) {
+        SDL_CloseIO(src);
+    }
+    return result;
+}
@@ -81,6 +81,9 @@ struct SDL_Surface
 
     /** Original pixels when RLE is enabled */
     void *saved_pixels;
+
+    /** The surface this view shares pixels with, see SDL_CreateSurfaceView() */
+    SDL_Surface *parent;
 };
 
 // Surface functions
@@ -93,7 +96,13 @@ extern float SDL_GetDefaultHDRHeadroom(SDL_Colorspace colorspace);
 extern float SDL_GetSurfaceHDRHeadroom(SDL_Surface *surface, SDL_Colorspace colorspace);
 extern SDL_Surface *SDL_GetSurfaceImage(SDL_Surface *surface, float display_scale);
 extern SDL_Surface *SDL_ConvertSurfaceRect(SDL_Surface *surface, const SDL_Rect *rect, SDL_PixelFormat format);
+extern int SDL_GetConversionStripes(int width, int height, int alignment, int *stripe_height, int *num_threads);
+// Set the padding bits of 32-bit RGB formats, so every image loader leaves them the same way
+extern void SDL_SetSurfacePaddingBits(SDL_Surface *surface, const SDL_Rect *rect);
 extern bool SDL_IsBMP(SDL_IOStream *src);
+// Load a BMP image, 24-bit images are expanded to format while they're read if it's a 32-bit RGB format
+extern SDL_Surface *SDL_LoadBMP_IOInternal(SDL_IOStream *src, bool closeio, SDL_PixelFormat format);
 extern bool SDL_IsPNG(SDL_IOStream *src);
+extern bool SDL_IsJPEG(SDL_IOStream *src);
 
 #endif // SDL_surface_c_h_
@@ -0,0 +1,313 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "SDL_internal.h"
+
+#include "../thread/SDL_parallel_c.h"
+
+// Loads images in the background: files are read through an async I/O queue and decoded by worker threads waiting on it
+
+typedef struct SDL_SurfaceLoadTask
+{
+    SDL_SurfaceLoader *loader;
+    char *file;
+    void *userdata;
+    SDL_Surface *surface;
+    char *error;        // set if the image couldn't be loaded
+    struct SDL_SurfaceLoadTask *next;
+} SDL_SurfaceLoadTask;
+
+struct SDL_SurfaceLoader
+{
+    SDL_AsyncIOQueue *queue;
+    SDL_PropertiesID props;
+    SDL_Mutex *lock;
+    SDL_Condition *condition;   // signaled when a task finishes or a thread quits
+    SDL_SurfaceLoadTask *done;  // protected by lock
+    SDL_SurfaceLoadTask *done_tail;
+    int num_busy;               // tasks being read or decoded, protected by lock
+    bool shutdown;              // protected by lock
+    int num_running;            // threads that haven't seen the shutdown yet, protected by lock
+    int num_threads;
+    SDL_Thread **threads;
+};
+
+static void FreeSurfaceLoadTask(SDL_SurfaceLoadTask *task)
+{
+    SDL_free(task->file);
+    SDL_free(task->error);
+    SDL_free(task);
+}
+
+static void DecodeSurfaceLoadTask(SDL_SurfaceLoadTask *task, const SDL_AsyncIOOutcome *outcome)
+{
+    SDL_SurfaceLoader *loader = task->loader;
+
+    if (outcome->result == SDL_ASYNCIO_COMPLETE) {
+        SDL_IOStream *src = SDL_IOFromConstMem(outcome->buffer, (size_t)outcome->bytes_transferred);
+        if (src) {
+            task->surface = SDL_LoadSurfaceWithProperties(src, true, loader->props);
+        }
+    } else {
+        SDL_SetError("Couldn't read %s", task->file);
+    }
+    if (!task->surface) {
+        task->error = SDL_strdup(SDL_GetError());
+    }
+    SDL_free(outcome->buffer);
+
+    SDL_LockMutex(loader->lock);
+    if (loader->done_tail) {
+        loader->done_tail->next = task;
+    } else {
+        loader->done = task;
+    }
+    loader->done_tail = task;
+    --loader->num_busy;
+    SDL_BroadcastCondition(loader->condition);
+    SDL_UnlockMutex(loader->lock);
+}
+
+static int SDLCALL SurfaceLoaderThread(void *data)
+{
+    SDL_SurfaceLoader *loader = (SDL_SurfaceLoader *)data;
+
+    for (;;) {
+        SDL_AsyncIOOutcome outcome;
+
+        if (SDL_WaitAsyncIOResult(loader->queue, &outcome, -1)) {
+            DecodeSurfaceLoadTask((SDL_SurfaceLoadTask *)outcome.userdata, &outcome);
+        } else {
+            bool shutdown;
+
+            // We may have been woken up to quit, or the OS may have woken several threads for one task
+            SDL_LockMutex(loader->lock);
+            shutdown = loader->shutdown;
+            if (shutdown) {
+                --loader->num_running;
+                SDL_BroadcastCondition(loader->condition);
+            }
+            SDL_UnlockMutex(loader->lock);
+            if (shutdown) {
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+SDL_SurfaceLoader *SDL_CreateSurfaceLoader(SDL_PropertiesID props)
+{
+    SDL_SurfaceLoader *loader;
+    int i, num_threads;
+
+    num_threads = (int)SDL_GetNumberProperty(props, SDL_PROP_SURFACE_LOADER_THREADS_NUMBER, 0);
+    if (num_threads <= 0) {
+        num_threads = SDL_GetParallelThreadCount();
+    }
+
+    loader = (SDL_SurfaceLoader *)SDL_calloc(1, sizeof(*loader));
+    if (!loader) {
+        return NULL;
+    }
+    loader->threads = (SDL_Thread **)SDL_calloc(num_threads, sizeof(*loader->threads));
+    loader->queue = SDL_CreateAsyncIOQueue();
+    loader->props = SDL_CreateProperties();
+    loader->lock = SDL_CreateMutex();
+    loader->condition = SDL_CreateCondition();
+    if (!loader->threads || !loader->queue || !loader->props || !loader->lock || !loader->condition ||
+        (props && !SDL_CopyProperties(props, loader->props))) {
+        SDL_DestroySurfaceLoader(loader);
+        return NULL;
+    }
+
+    for (i = 0; i < num_threads; ++i) {
+        char threadname[32];
+
+        SDL_LockMutex(loader->lock);
+        ++loader->num_running;
+        SDL_UnlockMutex(loader->lock);
+        SDL_snprintf(threadname, sizeof(threadname), "SDLloader%d", i);
+        loader->threads[i] = SDL_CreateThread(SurfaceLoaderThread, threadname, loader);
+        if (!loader->threads[i]) {
+            SDL_LockMutex(loader->lock);
+            --loader->num_running;
+            SDL_UnlockMutex(loader->lock);
+            break;
+        }
+        ++loader->num_threads;
+    }
+    if (loader->num_threads == 0) {
+        SDL_DestroySurfaceLoader(loader);
+        return NULL;
+    }
+    return loader;
+}
+
+bool SDL_LoadSurfaceAsync(SDL_SurfaceLoader *loader, const char *file, void *userdata)
+{
+    SDL_SurfaceLoadTask *task;
+
+    CHECK_PARAM(!loader) {
+        return SDL_InvalidParamError("loader");
+    }
+    CHECK_PARAM(!file) {
+        return SDL_InvalidParamError("file");
+    }
+
+    task = (SDL_SurfaceLoadTask *)SDL_calloc(1, sizeof(*task));
+    if (!task) {
+        return false;
+    }
+    task->loader = loader;
+    task->userdata = userdata;
+    task->file = SDL_strdup(file);
+    if (!task->file) {
+        FreeSurfaceLoadTask(task);
+        return false;
+    }
+
+    SDL_LockMutex(loader->lock);
+    ++loader->num_busy;
+    SDL_UnlockMutex(loader->lock);
+
+    if (!SDL_LoadFileAsync(file, loader->queue, task)) {
+        SDL_LockMutex(loader->lock);
+        --loader->num_busy;
+        SDL_UnlockMutex(loader->lock);
+        FreeSurfaceLoadTask(task);
+        return false;
+    }
+    return true;
+}
+
+// This is called with the loader lock held
+static bool TakeSurfaceLoaderResult(SDL_SurfaceLoader *loader, SDL_SurfaceLoaderOutcome *outcome)
+{
+    SDL_SurfaceLoadTask *task = loader->done;
+
+    if (!task) {
+        return false;
+    }
+    loader->done = task->next;
+    if (!loader->done) {
+        loader->done_tail = NULL;
+    }
+    outcome->surface = task->surface;
+    outcome->userdata = task->userdata;
+    if (task->error) {
+        SDL_SetError("%s", task->error);
+    }
+    FreeSurfaceLoadTask(task);
+    return true;
+}
+
+bool SDL_GetSurfaceLoaderResult(SDL_SurfaceLoader *loader, SDL_SurfaceLoaderOutcome *outcome)
+{
+    bool result;
+
+    CHECK_PARAM(!loader) {
+        return SDL_InvalidParamError("loader");
+    }
+    CHECK_PARAM(!outcome) {
+        return SDL_InvalidParamError("outcome");
+    }
+
+    SDL_LockMutex(loader->lock);
+    result = TakeSurfaceLoaderResult(loader, outcome);
+    SDL_UnlockMutex(loader->lock);
+    return result;
+}
+
+bool SDL_WaitSurfaceLoaderResult(SDL_SurfaceLoader *loader, SDL_SurfaceLoaderOutcome *outcome, Sint32 timeoutMS)
+{
+    bool result;
+
+    CHECK_PARAM(!loader) {
+        return SDL_InvalidParamError("loader");
+    }
+    CHECK_PARAM(!outcome) {
+        return SDL_InvalidParamError("outcome");
+    }
+
+    SDL_LockMutex(loader->lock);
+    if (!loader->done && loader->num_busy > 0) {
+        if (timeoutMS < 0) {
+            while (!loader->done && loader->num_busy > 0) {
+                SDL_WaitCondition(loader->condition, loader->lock);
+            }
+        } else {
+            const Uint64 deadline = SDL_GetTicks() + timeoutMS;
+            Uint64 now;
+
+            while (!loader->done && loader->num_busy > 0 && (now = SDL_GetTicks()) < deadline) {
+                SDL_WaitConditionTimeout(loader->condition, loader->lock, (Sint32)(deadline - now));
+            }
+        }
+    }
+    result = TakeSurfaceLoaderResult(loader, outcome);
+    SDL_UnlockMutex(loader->lock);
+    return result;
+}
+
+void SDL_DestroySurfaceLoader(SDL_SurfaceLoader *loader)
+{
+    int i;
+
+    if (!loader) {
+        return;
+    }
+
+    if (loader->lock) {
+        SDL_LockMutex(loader->lock);
+
+        // Let the reads in flight finish, they still refer to the queue and tasks
+        while (loader->num_busy > 0) {
+            SDL_WaitCondition(loader->condition, loader->lock);
+        }
+        loader->shutdown = true;
+
+        // Wait for the threads to see the shutdown. A thread between two waits on the queue
+        // misses the signal and goes back to sleep, so signal again if that happens.
+        while (loader->num_running > 0) {
+            SDL_SignalAsyncIOQueue(loader->queue);
+            SDL_WaitConditionTimeout(loader->condition, loader->lock, 100);
+        }
+        SDL_UnlockMutex(loader->lock);
+    }
+
+    for (i = 0; i < loader->num_threads; ++i) {
+        SDL_WaitThread(loader->threads[i], NULL);
+    }
+
+    while (loader->done) {
+        SDL_SurfaceLoadTask *task = loader->done;
+        loader->done = task->next;
+        SDL_DestroySurface(task->surface);
+        FreeSurfaceLoadTask(task);
+    }
+
+    SDL_DestroyCondition(loader->condition);
+    SDL_DestroyMutex(loader->lock);
+    SDL_DestroyProperties(loader->props);
+    SDL_DestroyAsyncIOQueue(loader->queue);
+    SDL_free(loader->threads);
+    SDL_free(loader);
+}
@@ -21,7 +21,9 @@
 #include "SDL_internal.h"
 
 #include "SDL_pixels_c.h"
+#include "SDL_surface_c.h"
 #include "SDL_yuv_c.h"
+#include "../thread/SDL_parallel_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
 
@@ -302,6 +304,155 @@ static bool GetYUVPlanes(int width, int height, SDL_PixelFormat format, const vo
     return true;
 }
 
+#ifdef SDL_AVX2_INTRINSICS
+static bool SDL_TARGETING("avx2") yuv_rgb_avx2(
+    SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    if (!SDL_HasAVX2()) {
+        return false;
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YV12 ||
+        src_format == SDL_PIXELFORMAT_IYUV) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv420_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv420_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv420_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv420_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv420_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv420_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_YUY2 ||
+        src_format == SDL_PIXELFORMAT_UYVY ||
+        src_format == SDL_PIXELFORMAT_YVYU) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuv422_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuv422_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuv422_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuv422_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuv422_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuv422_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_NV12 ||
+        src_format == SDL_PIXELFORMAT_NV21) {
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_RGB565:
+            yuvnv12_rgb565_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuvnv12_rgb24_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvnv12_rgba_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvnv12_bgra_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvnv12_argb_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvnv12_abgr_avx2(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+
+    if (src_format == SDL_PIXELFORMAT_P010) {
+        const uint16_t *y16 = (const uint16_t *)y;
+        const uint16_t *u16 = (const uint16_t *)u;
+        const uint16_t *v16 = (const uint16_t *)v;
+
+        switch (dst_format) {
+        case SDL_PIXELFORMAT_XBGR2101010:
+            yuvp010_xbgr2101010_avx2(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvp010_rgba_avx2(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvp010_bgra_avx2(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvp010_argb_avx2(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvp010_abgr_avx2(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+#else
+static bool yuv_rgb_avx2(
+    SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    return false;
+}
+#endif
+
 #ifdef SDL_SSE2_INTRINSICS
 static bool SDL_TARGETING("sse2") yuv_rgb_sse(
     SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
@@ -575,9 +726,35 @@ static bool yuv_rgb_std(
     }
 
     if (src_format == SDL_PIXELFORMAT_P010) {
+        const uint16_t *y16 = (const uint16_t *)y;
+        const uint16_t *u16 = (const uint16_t *)u;
+        const uint16_t *v16 = (const uint16_t *)v;
+
         switch (dst_format) {
         case SDL_PIXELFORMAT_XBGR2101010:
-            yuvp010_xbgr2101010_std(width, height, (const uint16_t *)y, (const uint16_t *)u, (const uint16_t *)v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            yuvp010_xbgr2101010_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB565:
+            yuvp010_rgb565_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGB24:
+            yuvp010_rgb24_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_RGBX8888:
+        case SDL_PIXELFORMAT_RGBA8888:
+            yuvp010_rgba_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_BGRX8888:
+        case SDL_PIXELFORMAT_BGRA8888:
+            yuvp010_bgra_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XRGB8888:
+        case SDL_PIXELFORMAT_ARGB8888:
+            yuvp010_argb_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
+            return true;
+        case SDL_PIXELFORMAT_XBGR8888:
+        case SDL_PIXELFORMAT_ABGR8888:
+            yuvp010_abgr_std(width, height, y16, u16, v16, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
             return true;
         default:
             break;
@@ -586,328 +763,1564 @@ static bool yuv_rgb_std(
     return false;
 }
 
-bool SDL_ConvertPixels_YUV_to_RGB(int width, int height,
-                                  SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch,
-                                  SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
+static bool IsYUVToRGBDirect(SDL_PixelFormat src_format, SDL_PixelFormat dst_format)
 {
-    const Uint8 *y = NULL;
-    const Uint8 *u = NULL;
-    const Uint8 *v = NULL;
-    Uint32 y_stride = 0;
-    Uint32 uv_stride = 0;
-    YCbCrType yuv_type = YCBCR_601_LIMITED;
-
-    if (!GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride)) {
+    // These are the conversions handled by yuv_rgb_std(), which the SIMD paths are a subset of
+    switch (dst_format) {
+    case SDL_PIXELFORMAT_XBGR2101010:
+        return (src_format == SDL_PIXELFORMAT_P010);
+    case SDL_PIXELFORMAT_RGB565:
+    case SDL_PIXELFORMAT_RGB24:
+    case SDL_PIXELFORMAT_RGBX8888:
+    case SDL_PIXELFORMAT_RGBA8888:
+    case SDL_PIXELFORMAT_BGRX8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+    case SDL_PIXELFORMAT_XRGB8888:
+    case SDL_PIXELFORMAT_ARGB8888:
+    case SDL_PIXELFORMAT_XBGR8888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        return true;
+    default:
         return false;
     }
+}
 
-    if (!GetYUVConversionType(src_colorspace, &yuv_type)) {
-        return false;
+static bool yuv_rgb(
+    SDL_PixelFormat src_format, SDL_PixelFormat dst_format,
+    Uint32 width, Uint32 height,
+    const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride,
+    Uint8 *rgb, Uint32 rgb_stride,
+    YCbCrType yuv_type)
+{
+    if (yuv_rgb_avx2(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
+        return true;
     }
 
-    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
+    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
         return true;
     }
 
-    if (yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
+    if (yuv_rgb_lsx(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
         return true;
     }
 
-    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8 *)dst, dst_pitch, yuv_type)) {
+    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type)) {
         return true;
     }
 
-    // No fast path for the RGB format, instead convert using an intermediate buffer
-    if (src_format == SDL_PIXELFORMAT_P010 && dst_format != SDL_PIXELFORMAT_XBGR2101010) {
-        bool result;
-        void *tmp;
-        int tmp_pitch = (width * sizeof(Uint32));
+    return SDL_SetError("Unsupported YUV conversion");
+}
 
-        tmp = SDL_malloc((size_t)tmp_pitch * height);
-        if (!tmp) {
-            return false;
-        }
+typedef struct YUVToRGBStripes
+{
+    int width;
+    int height;
+    int stripe_height;
+    SDL_PixelFormat src_format;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    YCbCrType yuv_type;
+
+    // If tmp is set, stripes are converted to tmp_format in scratch memory for each thread and then to the destination
+    SDL_PixelFormat tmp_format;
+    SDL_Colorspace tmp_colorspace;
+    SDL_PropertiesID tmp_properties;
+    Uint8 *tmp;
+    int tmp_pitch;
+
+    SDL_PixelFormat dst_format;
+    SDL_Colorspace dst_colorspace;
+    SDL_PropertiesID dst_properties;
+    Uint8 *dst;
+    int dst_pitch;
+} YUVToRGBStripes;
+
+static bool YUVToRGBStripe(void *userdata, int item, int slot)
+{
+    const YUVToRGBStripes *job = (const YUVToRGBStripes *)userdata;
+    const int y0 = item * job->stripe_height;
+    const int rows = SDL_min(job->stripe_height, job->height - y0);
+    const size_t y_offset = (size_t)y0 * job->y_stride;
+    size_t uv_offset;
+    Uint8 *dst = job->dst + (size_t)y0 * job->dst_pitch;
+
+    switch (job->src_format) {
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        // The chroma is interleaved with the luma
+        uv_offset = y_offset;
+        break;
+    default:
+        // The stripes start on even rows, so they line up with the 2x2 subsampled chroma
+        uv_offset = (size_t)(y0 / 2) * job->uv_stride;
+        break;
+    }
 
-        // convert src/src_format to tmp/XBGR2101010
-        result = SDL_ConvertPixels_YUV_to_RGB(width, height, src_format, src_colorspace, src_properties, src, src_pitch, SDL_PIXELFORMAT_XBGR2101010, src_colorspace, src_properties, tmp, tmp_pitch);
-        if (!result) {
-            SDL_free(tmp);
+    if (!job->tmp) {
+        return yuv_rgb(job->src_format, job->dst_format, job->width, rows,
+                       job->y + y_offset, job->u + uv_offset, job->v + uv_offset, job->y_stride, job->uv_stride,
+                       dst, job->dst_pitch, job->yuv_type);
+    } else {
+        Uint8 *tmp = job->tmp + (size_t)slot * job->stripe_height * job->tmp_pitch;
+
+        if (!yuv_rgb(job->src_format, job->tmp_format, job->width, rows,
+                     job->y + y_offset, job->u + uv_offset, job->v + uv_offset, job->y_stride, job->uv_stride,
+                     tmp, job->tmp_pitch, job->yuv_type)) {
             return false;
         }
-
-        // convert tmp/XBGR2101010 to dst/RGB
-        result = SDL_ConvertPixelsAndColorspace(width, height, SDL_PIXELFORMAT_XBGR2101010, src_colorspace, src_properties, tmp, tmp_pitch, dst_format, dst_colorspace, dst_properties, dst, dst_pitch);
-        SDL_free(tmp);
-        return result;
+        return SDL_ConvertPixelsAndColorspace(job->width, rows, job->tmp_format, job->tmp_colorspace, job->tmp_properties, tmp, job->tmp_pitch,
+                                              job->dst_format, job->dst_colorspace, job->dst_properties, dst, job->dst_pitch);
     }
+}
 
-    if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
-        bool result;
-        void *tmp;
-        int tmp_pitch = (width * sizeof(Uint32));
+static bool ConvertYUVPlanesToRGB(YUVToRGBStripes *job, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties)
+{
+    const SDL_PixelFormat src_format = job->src_format;
+    const SDL_PixelFormat dst_format = job->dst_format;
+    const SDL_Colorspace dst_colorspace = job->dst_colorspace;
+    int num_stripes, num_threads;
+    bool result;
 
-        tmp = SDL_malloc((size_t)tmp_pitch * height);
-        if (!tmp) {
-            return false;
-        }
+    num_stripes = SDL_GetConversionStripes(job->width, job->height, 2, &job->stripe_height, &num_threads);
 
-        // convert src/src_format to tmp/ARGB8888
-        result = SDL_ConvertPixels_YUV_to_RGB(width, height, src_format, src_colorspace, src_properties, src, src_pitch, SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, 0, tmp, tmp_pitch);
-        if (!result) {
-            SDL_free(tmp);
-            return false;
-        }
+    /* Converting P010 directly to 8-bit RGB skips the transfer function and color primaries
+     * conversion, so it's only done when the destination doesn't need any.
+     */
+    if (IsYUVToRGBDirect(src_format, dst_format) &&
+        (src_format != SDL_PIXELFORMAT_P010 || dst_format == SDL_PIXELFORMAT_XBGR2101010 ||
+         (SDL_COLORSPACEPRIMARIES(src_colorspace) == SDL_COLORSPACEPRIMARIES(dst_colorspace) &&
+          SDL_COLORSPACETRANSFER(src_colorspace) == SDL_COLORSPACETRANSFER(dst_colorspace)))) {
+        return SDL_RunParallel(YUVToRGBStripe, job, num_stripes, num_threads);
+    }
 
-        // convert tmp/ARGB8888 to dst/RGB
-        result = SDL_ConvertPixelsAndColorspace(width, height, SDL_PIXELFORMAT_ARGB8888, SDL_COLORSPACE_SRGB, 0, tmp, tmp_pitch, dst_format, dst_colorspace, dst_properties, dst, dst_pitch);
-        SDL_free(tmp);
-        return result;
+    // No fast path for the RGB format, instead convert using an intermediate buffer
+    if (src_format == SDL_PIXELFORMAT_P010) {
+        job->tmp_format = SDL_PIXELFORMAT_XBGR2101010;
+        job->tmp_colorspace = src_colorspace;
+        job->tmp_properties = src_properties;
+    } else if (dst_format != SDL_PIXELFORMAT_ARGB8888) {
+        job->tmp_format = SDL_PIXELFORMAT_ARGB8888;
+        job->tmp_colorspace = SDL_COLORSPACE_SRGB;
+        job->tmp_properties = 0;
+    } else {
+        return SDL_SetError("Unsupported YUV conversion");
     }
 
-    return SDL_SetError("Unsupported YUV conversion");
-}
+    // Each thread only needs room for the stripe it's working on
+    job->tmp_pitch = (job->width * sizeof(Uint32));
+    job->tmp = (Uint8 *)SDL_malloc((size_t)job->tmp_pitch * job->stripe_height * num_threads);
+    if (!job->tmp) {
+        return false;
+    }
 
-struct RGB2YUVFactors
-{
-    int y_offset;
-    float y[3]; // Rfactor, Gfactor, Bfactor
-    float u[3]; // Rfactor, Gfactor, Bfactor
-    float v[3]; // Rfactor, Gfactor, Bfactor
-};
+    result = SDL_RunParallel(YUVToRGBStripe, job, num_stripes, num_threads);
 
-static struct RGB2YUVFactors RGB2YUVFactorTables[] = {
-    // ITU-T T.871 (JPEG)
-    {
-        0,
-        { 0.2990f, 0.5870f, 0.1140f },
-        { -0.1687f, -0.3313f, 0.5000f },
-        { 0.5000f, -0.4187f, -0.0813f },
-    },
-    // ITU-R BT.601-7
-    {
-        16,
-        { 0.2568f, 0.5041f, 0.0979f },
-        { -0.1482f, -0.2910f, 0.4392f },
-        { 0.4392f, -0.3678f, -0.0714f },
-    },
-    // ITU-R BT.709-6 full range
-    {
-        0,
-        { 0.2126f, 0.7152f, 0.0722f },
-        { -0.1141f, -0.3839f, 0.498f },
-        { 0.498f, -0.4524f, -0.0457f },
-    },
-    // ITU-R BT.709-6
-    {
-        16,
-        { 0.1826f, 0.6142f, 0.0620f },
-        { -0.1006f, -0.3386f, 0.4392f },
-        { 0.4392f, -0.3989f, -0.0403f },
-    },
-    // ITU-R BT.2020 10-bit full range
-    {
-        0,
-        { 0.2627f, 0.6780f, 0.0593f },
-        { -0.1395f, -0.3600f, 0.4995f },
-        { 0.4995f, -0.4593f, -0.0402f },
-    },
-};
+    SDL_free(job->tmp);
+    job->tmp = NULL;
+    return result;
+}
 
-static bool SDL_ConvertPixels_XRGB8888_to_YUV(int width, int height, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+bool SDL_ConvertPixels_YUV_to_RGB_Rect(int width, int height, const SDL_Rect *rect,
+                                       SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch,
+                                       SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
 {
-    const int src_pitch_x_2 = src_pitch * 2;
-    const int height_half = height / 2;
-    const int height_remainder = (height & 0x1);
-    const int width_half = width / 2;
-    const int width_remainder = (width & 0x1);
-    int i, j;
+    YUVToRGBStripes job;
+    SDL_Rect full_rect;
+    size_t luma_size, chroma_size;
+    bool subsampled_rows;
 
-    const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[yuv_type];
-
-#define MAKE_Y(r, g, b) (Uint8)SDL_clamp(((int)(cvt->y[0] * (r) + cvt->y[1] * (g) + cvt->y[2] * (b) + 0.5f) + cvt->y_offset), 0, 255)
-#define MAKE_U(r, g, b) (Uint8)SDL_clamp(((int)(cvt->u[0] * (r) + cvt->u[1] * (g) + cvt->u[2] * (b) + 0.5f) + 128), 0, 255)
-#define MAKE_V(r, g, b) (Uint8)SDL_clamp(((int)(cvt->v[0] * (r) + cvt->v[1] * (g) + cvt->v[2] * (b) + 0.5f) + 128), 0, 255)
+    if (!rect) {
+        full_rect.x = 0;
+        full_rect.y = 0;
+        full_rect.w = width;
+        full_rect.h = height;
+        rect = &full_rect;
+    }
 
-#define READ_2x2_PIXELS                                                                                     \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-    const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-    const Uint32 p3 = ((const Uint32 *)next_row)[2 * i];                                                    \
-    const Uint32 p4 = ((const Uint32 *)next_row)[2 * i + 1];                                                \
-    const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000) + (p3 & 0x00ff0000) + (p4 & 0x00ff0000)) >> 18; \
-    const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00) + (p3 & 0x0000ff00) + (p4 & 0x0000ff00)) >> 10; \
-    const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff) + (p3 & 0x000000ff) + (p4 & 0x000000ff)) >> 2;
-
-#define READ_2x1_PIXELS                                             \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];            \
-    const Uint32 p2 = ((const Uint32 *)next_row)[2 * i];            \
-    const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17; \
-    const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;  \
-    const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;
-
-#define READ_1x2_PIXELS                                             \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];            \
-    const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];        \
-    const Uint32 r = ((p1 & 0x00ff0000) + (p2 & 0x00ff0000)) >> 17; \
-    const Uint32 g = ((p1 & 0x0000ff00) + (p2 & 0x0000ff00)) >> 9;  \
-    const Uint32 b = ((p1 & 0x000000ff) + (p2 & 0x000000ff)) >> 1;
+    SDL_zero(job);
+    if (!GetYUVPlanes(width, height, src_format, src, src_pitch, &job.y, &job.u, &job.v, &job.y_stride, &job.uv_stride)) {
+        return false;
+    }
 
-#define READ_1x1_PIXEL                                  \
-    const Uint32 p = ((const Uint32 *)curr_row)[2 * i]; \
-    const Uint32 r = (p & 0x00ff0000) >> 16;            \
-    const Uint32 g = (p & 0x0000ff00) >> 8;             \
-    const Uint32 b = (p & 0x000000ff);
+    if (!GetYUVConversionType(src_colorspace, &job.yuv_type)) {
+        return false;
+    }
 
-#define READ_TWO_RGB_PIXELS                                  \
-    const Uint32 p = ((const Uint32 *)curr_row)[2 * i];      \
-    const Uint32 r = (p & 0x00ff0000) >> 16;                 \
-    const Uint32 g = (p & 0x0000ff00) >> 8;                  \
-    const Uint32 b = (p & 0x000000ff);                       \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i + 1]; \
-    const Uint32 r1 = (p1 & 0x00ff0000) >> 16;               \
-    const Uint32 g1 = (p1 & 0x0000ff00) >> 8;                \
-    const Uint32 b1 = (p1 & 0x000000ff);                     \
-    const Uint32 R = (r + r1) / 2;                           \
-    const Uint32 G = (g + g1) / 2;                           \
-    const Uint32 B = (b + b1) / 2;
-
-#define READ_ONE_RGB_PIXEL READ_1x1_PIXEL
-
-    switch (dst_format) {
+    // Find the size of a pixel and of the chroma for a pair of pixels in each plane
+    switch (src_format) {
     case SDL_PIXELFORMAT_YV12:
     case SDL_PIXELFORMAT_IYUV:
+        luma_size = 1;
+        chroma_size = 1;
+        subsampled_rows = true;
+        break;
     case SDL_PIXELFORMAT_NV12:
     case SDL_PIXELFORMAT_NV21:
-    {
-        const Uint8 *curr_row, *next_row;
+        luma_size = 1;
+        chroma_size = 2;
+        subsampled_rows = true;
+        break;
+    case SDL_PIXELFORMAT_P010:
+        luma_size = 2;
+        chroma_size = 4;
+        subsampled_rows = true;
+        break;
+    default:
+        luma_size = 2;
+        chroma_size = 4;
+        subsampled_rows = false;
+        break;
+    }
 
-        Uint8 *plane_y;
-        Uint8 *plane_u;
-        Uint8 *plane_v;
-        Uint8 *plane_interleaved_uv;
-        Uint32 y_stride, uv_stride, y_skip, uv_skip;
+    if (rect->x & 1) {
+        return SDL_SetError("YUV conversions must start on an even column");
+    }
+    if (rect->w <= 0 || rect->h <= 0) {
+        return true;
+    }
 
-        if (!GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
-                          (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
-                          &y_stride, &uv_stride)) {
+    job.y += (size_t)rect->y * job.y_stride + rect->x * luma_size;
+    job.u += (size_t)(subsampled_rows ? rect->y / 2 : rect->y) * job.uv_stride + (rect->x / 2) * chroma_size;
+    job.v += (size_t)(subsampled_rows ? rect->y / 2 : rect->y) * job.uv_stride + (rect->x / 2) * chroma_size;
+    job.width = rect->w;
+    job.height = rect->h;
+    job.src_format = src_format;
+    job.dst_format = dst_format;
+    job.dst_colorspace = dst_colorspace;
+    job.dst_properties = dst_properties;
+    job.dst = (Uint8 *)dst;
+    job.dst_pitch = dst_pitch;
+
+    if (subsampled_rows && (rect->y & 1)) {
+        // The first row shares its chroma with the row above it, so convert it on its own
+        YUVToRGBStripes first = job;
+
+        first.height = 1;
+        if (!ConvertYUVPlanesToRGB(&first, src_colorspace, src_properties)) {
             return false;
         }
+        if (job.height == 1) {
+            return true;
+        }
+        job.y += job.y_stride;
+        job.u += job.uv_stride;
+        job.v += job.uv_stride;
+        job.dst += dst_pitch;
+        --job.height;
+    }
+    return ConvertYUVPlanesToRGB(&job, src_colorspace, src_properties);
+}
 
-        plane_interleaved_uv = (plane_y + height * y_stride);
-        y_skip = (y_stride - width);
+// The number of rows that are sampled before being converted together
+#define YUV_SCALE_CHUNK_ROWS    32
 
-        curr_row = (const Uint8 *)src;
+// Linear sampling weights have 7 bits of precision, like SDL_StretchSurface()
+#define YUV_SCALE_PRECISION     7
+#define YUV_SCALE_FRAC_ONE      (1 << YUV_SCALE_PRECISION)
 
-        // Write Y plane
-        for (j = 0; j < height; j++) {
-            for (i = 0; i < width; i++) {
-                const Uint32 p1 = ((const Uint32 *)curr_row)[i];
-                const Uint32 r = (p1 & 0x00ff0000) >> 16;
-                const Uint32 g = (p1 & 0x0000ff00) >> 8;
-                const Uint32 b = (p1 & 0x000000ff);
-                *plane_y++ = MAKE_Y(r, g, b);
-            }
-            plane_y += y_skip;
-            curr_row += src_pitch;
+typedef struct YUVScaleColumn
+{
+    int offset[2];    // the samples in the source row, in bytes for YUV and in pixels for RGB
+    int uv_offset[2]; // the chroma samples in the source row, in bytes
+    int frac;         // the weight of the second sample, for linear scaling
+} YUVScaleColumn;
+
+typedef struct YUVScaleStripes
+{
+    YCbCrType yuv_type;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    bool subsampled_rows;
+    bool linear;
+
+    // The source sample for each visible column of the destination
+    const YUVScaleColumn *columns;
+
+    // The bytes of each source row that are sampled, the column offsets are relative to these
+    int y_first;
+    int y_span;
+    int uv_first;
+    int uv_span;
+
+    // The destination rows are mapped to the source rows the same way as the columns
+    int src_y;
+    int src_h;
+    int dst_y;
+    int dst_h;
+
+    SDL_Surface *dst;
+    SDL_Rect clip;
+    int stripe_height;
+
+    // The format the samples are converted to, before they're written to the destination
+    SDL_PixelFormat rgb_format;
+
+    // When scaling up, the visible part of the source is converted up front
+    const Uint8 *rgb;
+    int rgb_pitch;
+    int rgb_y;
+
+    Uint8 *scratch;
+    size_t scratch_size;
+} YUVScaleStripes;
+
+/* Find the source sample for destination pixel i when scaling src_nb pixels to dst_nb,
+ * using the same math as SDL_StretchSurface() so the result matches scaling an RGB copy.
+ */
+static void GetYUVScaleSample(int i, int src_nb, int dst_nb, bool linear, int *index, int *frac)
+{
+    if (linear) {
+        const Sint64 step = ((Sint64)src_nb << 16) / dst_nb;
+        const Sint64 fp = ((step + 1) / 2) - 0x8000 + i * step;
+
+        *index = (int)(fp >> 16);
+        *frac = (int)((fp >> (16 - YUV_SCALE_PRECISION)) & (YUV_SCALE_FRAC_ONE - 1));
+        if (fp < 0) {
+            *index = 0;
+            *frac = 0;
+        } else if (*index > src_nb - 2) {
+            *index = src_nb - 1;
+            *frac = 0;
         }
+    } else {
+        const Uint64 step = ((Uint64)src_nb << 16) / dst_nb;
 
-        curr_row = (const Uint8 *)src;
-        next_row = (const Uint8 *)src;
-        next_row += src_pitch;
+        *index = (int)((step / 2 + (Uint64)i * step) >> 16);
+        *frac = 0;
+    }
+}
 
-        if (dst_format == SDL_PIXELFORMAT_YV12 || dst_format == SDL_PIXELFORMAT_IYUV) {
-            // Write UV planes, not interleaved
-            uv_skip = (uv_stride - (width + 1) / 2);
-            for (j = 0; j < height_half; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_2x2_PIXELS;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_2x1_PIXELS;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
+static void CompactYUVScaleRow(const Uint8 *src, Uint8 *dst, int width, int bpp)
+{
+    int x;
+
+    // Every destination pixel was converted twice, keep the first of each pair
+    switch (bpp) {
+    case 4:
+        for (x = 0; x < width; ++x) {
+            ((Uint32 *)dst)[x] = ((const Uint32 *)src)[2 * x];
+        }
+        break;
+    case 2:
+        for (x = 0; x < width; ++x) {
+            ((Uint16 *)dst)[x] = ((const Uint16 *)src)[2 * x];
+        }
+        break;
+    default:
+        for (x = 0; x < width; ++x) {
+            SDL_memcpy(dst + x * bpp, src + 2 * x * bpp, bpp);
+        }
+        break;
+    }
+}
+
+#ifdef SDL_SSE2_INTRINSICS
+static int SDL_TARGETING("sse2") BlendYUVScaleRows_SSE2(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int length, int frac)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i w0 = _mm_set1_epi16((short)(YUV_SCALE_FRAC_ONE - frac));
+    const __m128i w1 = _mm_set1_epi16((short)frac);
+    const __m128i round = _mm_set1_epi16(YUV_SCALE_FRAC_ONE / 2);
+    int i;
+
+    for (i = 0; i + 16 <= length; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(row0 + i));
+        const __m128i b = _mm_loadu_si128((const __m128i *)(row1 + i));
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), w0), _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), w1));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), w0), _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), w1));
+
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, round), YUV_SCALE_PRECISION);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, round), YUV_SCALE_PRECISION);
+        _mm_storeu_si128((__m128i *)(dst + i), _mm_packus_epi16(lo, hi));
+    }
+    return i;
+}
+#endif
+
+// Blend two rows of samples with a weight out of YUV_SCALE_FRAC_ONE for the second one
+static void BlendYUVScaleRows(const Uint8 *row0, const Uint8 *row1, Uint8 *dst, int length, int frac)
+{
+    const int frac0 = YUV_SCALE_FRAC_ONE - frac;
+    int i = 0;
+
+#ifdef SDL_SSE2_INTRINSICS
+    if (SDL_HasSSE2()) {
+        i = BlendYUVScaleRows_SSE2(row0, row1, dst, length, frac);
+    }
+#endif
+    for (; i < length; ++i) {
+        dst[i] = (Uint8)((row0[i] * frac0 + row1[i] * frac + (YUV_SCALE_FRAC_ONE / 2)) >> YUV_SCALE_PRECISION);
+    }
+}
+
+SDL_FORCE_INLINE Uint8 YUVScaleLerp(int p0, int p1, int frac)
+{
+    return (Uint8)(((p0 << YUV_SCALE_PRECISION) + (p1 - p0) * frac + (YUV_SCALE_FRAC_ONE / 2)) >> YUV_SCALE_PRECISION);
+}
+
+/* When scaling down, the YUV samples for each destination pixel are gathered first and then converted.
+ * Each pixel is stored as a YUY2 pair with its own chroma, so it can be converted by the SIMD paths.
+ */
+static bool YUVSampleStripe(void *userdata, int item, int slot)
+{
+    const YUVScaleStripes *job = (const YUVScaleStripes *)userdata;
+    const SDL_Rect *clip = &job->clip;
+    const int y0 = clip->y + item * job->stripe_height;
+    const int y1 = SDL_min(y0 + job->stripe_height, clip->y + clip->h);
+    const int w = clip->w;
+    const int bpp = SDL_BYTESPERPIXEL(job->rgb_format);
+    const int dst_bpp = SDL_BYTESPERPIXEL(job->dst->format);
+    const int yuy2_pitch = w * 4;
+    const int rgb_pitch = w * 2 * bpp;
+    Uint8 *yuy2 = job->scratch + (size_t)slot * job->scratch_size;
+    Uint8 *rgb = yuy2 + (size_t)YUV_SCALE_CHUNK_ROWS * yuy2_pitch;
+    Uint8 *blend_y = rgb + (size_t)YUV_SCALE_CHUNK_ROWS * rgb_pitch;
+    Uint8 *blend_u = blend_y + job->y_span;
+    Uint8 *blend_v = blend_u + job->uv_span;
+    Uint8 *row = blend_v + job->uv_span;
+    const YUVScaleColumn *columns = job->columns;
+    int y, r, x;
+
+    for (y = y0; y < y1; y += YUV_SCALE_CHUNK_ROWS) {
+        const int rows = SDL_min(YUV_SCALE_CHUNK_ROWS, y1 - y);
+
+        for (r = 0; r < rows; ++r) {
+            Uint8 *out = yuy2 + (size_t)r * yuy2_pitch;
+            const Uint8 *y_row, *u_row, *v_row;
+            size_t uv_row;
+            int index, frac;
+
+            GetYUVScaleSample(y + r - job->dst_y, job->src_h, job->dst_h, job->linear, &index, &frac);
+            index += job->src_y;
+
+            uv_row = (size_t)(job->subsampled_rows ? index / 2 : index) * job->uv_stride;
+            y_row = job->y + (size_t)index * job->y_stride + job->y_first;
+            u_row = job->u + uv_row + job->uv_first;
+            v_row = job->v + uv_row + job->uv_first;
+
+            if (job->linear) {
+                // Blend the rows first, so only two samples are left for each pixel
+                if (frac) {
+                    const size_t next_uv_row = (size_t)(job->subsampled_rows ? (index + 1) / 2 : (index + 1)) * job->uv_stride;
+
+                    BlendYUVScaleRows(y_row, y_row + job->y_stride, blend_y, job->y_span, frac);
+                    BlendYUVScaleRows(u_row, job->u + next_uv_row + job->uv_first, blend_u, job->uv_span, frac);
+                    BlendYUVScaleRows(v_row, job->v + next_uv_row + job->uv_first, blend_v, job->uv_span, frac);
+                    y_row = blend_y;
+                    u_row = blend_u;
+                    v_row = blend_v;
                 }
-                plane_u += uv_skip;
-                plane_v += uv_skip;
-                curr_row += src_pitch_x_2;
-                next_row += src_pitch_x_2;
-            }
-            if (height_remainder) {
-                for (i = 0; i < width_half; i++) {
-                    READ_1x2_PIXELS;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
+
+                for (x = 0; x < w; ++x) {
+                    const YUVScaleColumn *column = &columns[x];
+                    const int fx = column->frac;
+                    const int c0 = column->offset[0], c1 = column->offset[1];
+                    const int uv0 = column->uv_offset[0], uv1 = column->uv_offset[1];
+                    const Uint8 luma = YUVScaleLerp(y_row[c0], y_row[c1], fx);
+
+                    out[0] = luma;
+                    out[1] = YUVScaleLerp(u_row[uv0], u_row[uv1], fx);
+                    out[2] = luma;
+                    out[3] = YUVScaleLerp(v_row[uv0], v_row[uv1], fx);
+                    out += 4;
                 }
-                if (width_remainder) {
-                    READ_1x1_PIXEL;
-                    *plane_u++ = MAKE_U(r, g, b);
-                    *plane_v++ = MAKE_V(r, g, b);
+            } else {
+                for (x = 0; x < w; ++x) {
+                    const YUVScaleColumn *column = &columns[x];
+                    const Uint8 luma = y_row[column->offset[0]];
+
+                    out[0] = luma;
+                    out[1] = u_row[column->uv_offset[0]];
+                    out[2] = luma;
+                    out[3] = v_row[column->uv_offset[0]];
+                    out += 4;
                 }
-                plane_u += uv_skip;
-                plane_v += uv_skip;
             }
-        } else if (dst_format == SDL_PIXELFORMAT_NV12) {
-            uv_skip = (uv_stride - ((width + 1) / 2) * 2);
-            for (j = 0; j < height_half; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_2x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_2x1_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
+        }
+
+        if (!yuv_rgb(SDL_PIXELFORMAT_YUY2, job->rgb_format, 2 * w, rows, yuy2, yuy2 + 1, yuy2 + 3, yuy2_pitch, yuy2_pitch, rgb, rgb_pitch, job->yuv_type)) {
+            return false;
+        }
+
+        for (r = 0; r < rows; ++r) {
+            Uint8 *dst_row = (Uint8 *)job->dst->pixels + (size_t)(y + r) * job->dst->pitch + clip->x * dst_bpp;
+
+            if (job->rgb_format == job->dst->format) {
+                CompactYUVScaleRow(rgb + (size_t)r * rgb_pitch, dst_row, w, bpp);
+            } else {
+                CompactYUVScaleRow(rgb + (size_t)r * rgb_pitch, row, w, bpp);
+                if (!SDL_ConvertPixels(w, 1, job->rgb_format, row, w * bpp, job->dst->format, dst_row, job->dst->pitch)) {
+                    return false;
                 }
-                plane_interleaved_uv += uv_skip;
-                curr_row += src_pitch_x_2;
-                next_row += src_pitch_x_2;
             }
-            if (height_remainder) {
-                for (i = 0; i < width_half; i++) {
-                    READ_1x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_1x1_PIXEL;
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                }
+        }
+    }
+    return true;
+}
+
+// Blend two ARGB8888 pixels, two channels at a time
+SDL_FORCE_INLINE Uint32 YUVStretchLerp(Uint32 p0, Uint32 p1, int frac0, int frac1)
+{
+    const Uint32 rb = ((p0 & 0x00FF00FF) * frac0 + (p1 & 0x00FF00FF) * frac1) >> YUV_SCALE_PRECISION;
+    const Uint32 ag = (((p0 >> 8) & 0x00FF00FF) * frac0 + ((p1 >> 8) & 0x00FF00FF) * frac1) >> YUV_SCALE_PRECISION;
+
+    return (rb & 0x00FF00FF) | ((ag & 0x00FF00FF) << 8);
+}
+
+// When scaling up, the source was converted to ARGB8888 and is scaled like SDL_StretchSurface() would
+static bool YUVStretchStripe(void *userdata, int item, int slot)
+{
+    const YUVScaleStripes *job = (const YUVScaleStripes *)userdata;
+    const SDL_Rect *clip = &job->clip;
+    const int y0 = clip->y + item * job->stripe_height;
+    const int y1 = SDL_min(y0 + job->stripe_height, clip->y + clip->h);
+    const int w = clip->w;
+    const int dst_bpp = SDL_BYTESPERPIXEL(job->dst->format);
+    const bool direct = (job->dst->format == job->rgb_format);
+    Uint32 *row = (Uint32 *)(job->scratch + (size_t)slot * job->scratch_size);
+    Uint32 *blend = row + w;
+    int prev_index = -1, prev_frac = -1;
+    int y, x;
+
+    for (y = y0; y < y1; ++y) {
+        Uint8 *dst_row = (Uint8 *)job->dst->pixels + (size_t)y * job->dst->pitch + clip->x * dst_bpp;
+        Uint32 *out = direct ? (Uint32 *)dst_row : row;
+        const Uint32 *s0;
+        int index, frac;
+
+        GetYUVScaleSample(y - job->dst_y, job->src_h, job->dst_h, job->linear, &index, &frac);
+        if (index == prev_index && frac == prev_frac) {
+            // This row samples the same source rows as the one above it
+            SDL_memcpy(dst_row, dst_row - job->dst->pitch, (size_t)w * dst_bpp);
+            continue;
+        }
+        prev_index = index;
+        prev_frac = frac;
+
+        index += job->src_y - job->rgb_y;
+        s0 = (const Uint32 *)(job->rgb + (size_t)index * job->rgb_pitch);
+
+        if (job->linear) {
+            if (frac) {
+                // Blend the rows first, so only two samples are left for each pixel
+                BlendYUVScaleRows((const Uint8 *)s0, (const Uint8 *)s0 + job->rgb_pitch, (Uint8 *)blend, job->rgb_pitch, frac);
+                s0 = blend;
             }
-        } else /* dst_format == SDL_PIXELFORMAT_NV21 */ {
-            uv_skip = (uv_stride - ((width + 1) / 2) * 2);
-            for (j = 0; j < height_half; j++) {
-                for (i = 0; i < width_half; i++) {
-                    READ_2x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                }
-                if (width_remainder) {
-                    READ_2x1_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
-                }
-                plane_interleaved_uv += uv_skip;
-                curr_row += src_pitch_x_2;
-                next_row += src_pitch_x_2;
+            for (x = 0; x < w; ++x) {
+                const YUVScaleColumn *column = &job->columns[x];
+
+                out[x] = YUVStretchLerp(s0[column->offset[0]], s0[column->offset[1]], YUV_SCALE_FRAC_ONE - column->frac, column->frac);
             }
-            if (height_remainder) {
-                for (i = 0; i < width_half; i++) {
-                    READ_1x2_PIXELS;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
+        } else {
+            for (x = 0; x < w; ++x) {
+                out[x] = s0[job->columns[x].offset[0]];
+            }
+        }
+
+        if (!direct) {
+            if (!SDL_ConvertPixels(w, 1, job->rgb_format, row, w * (int)sizeof(Uint32), job->dst->format, dst_row, job->dst->pitch)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Convert the source rectangle and scale it with SDL_StretchSurface(), which has SIMD paths for scaling up
+static bool StretchYUVToRGB(int width, int height, SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, const void *src, int src_pitch, const SDL_Rect *srcrect,
+                            SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode)
+{
+    SDL_Surface *tmp;
+    SDL_Rect rect, tmp_srcrect;
+    bool result;
+
+    // Start on an even column, so the chroma lines up
+    rect.x = srcrect->x & ~1;
+    rect.y = srcrect->y;
+    rect.w = srcrect->x + srcrect->w - rect.x;
+    rect.h = srcrect->h;
+
+    tmp = SDL_CreateSurface(rect.w, rect.h, dst->format);
+    if (!tmp) {
+        return false;
+    }
+    result = SDL_ConvertPixels_YUV_to_RGB_Rect(width, height, &rect, src_format, src_colorspace, 0, src, src_pitch,
+                                               tmp->format, SDL_COLORSPACE_SRGB, 0, tmp->pixels, tmp->pitch);
+    if (result) {
+        tmp_srcrect.x = srcrect->x - rect.x;
+        tmp_srcrect.y = 0;
+        tmp_srcrect.w = srcrect->w;
+        tmp_srcrect.h = srcrect->h;
+        result = SDL_StretchSurface(tmp, &tmp_srcrect, dst, dstrect, scaleMode);
+    }
+    SDL_DestroySurface(tmp);
+    return result;
+}
+
+bool SDL_ConvertPixels_YUV_to_RGB_Scaled(int width, int height, SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, const void *src, int src_pitch, const SDL_Rect *srcrect,
+                                         SDL_Surface *dst, const SDL_Rect *dstrect, SDL_ScaleMode scaleMode)
+{
+    YUVScaleStripes job;
+    SDL_Rect full_src, full_dst;
+    YUVScaleColumn *columns;
+    Uint8 *rgb = NULL;
+    bool sample_yuv;
+    int y_pixel_size, uv_pair_size;
+    int num_stripes, num_threads;
+    int x;
+    bool result;
+
+    if (!srcrect) {
+        full_src.x = 0;
+        full_src.y = 0;
+        full_src.w = width;
+        full_src.h = height;
+        srcrect = &full_src;
+    }
+    if (!dstrect) {
+        full_dst.x = 0;
+        full_dst.y = 0;
+        full_dst.w = dst->w;
+        full_dst.h = dst->h;
+        dstrect = &full_dst;
+    }
+
+    SDL_zero(job);
+    if (srcrect->w <= 0 || srcrect->h <= 0 || !SDL_GetRectIntersection(dstrect, &dst->clip_rect, &job.clip)) {
+        return true;
+    }
+    if (srcrect->x < 0 || srcrect->y < 0 || srcrect->x + srcrect->w > width || srcrect->y + srcrect->h > height) {
+        return SDL_SetError("Source rectangle is outside the image");
+    }
+
+    // Convert straight into the destination if the sizes match and the columns line up with the chroma
+    if (srcrect->w == dstrect->w && srcrect->h == dstrect->h &&
+        ((srcrect->x + job.clip.x - dstrect->x) & 1) == 0) {
+        SDL_Rect rect;
+
+        rect.x = srcrect->x + (job.clip.x - dstrect->x);
+        rect.y = srcrect->y + (job.clip.y - dstrect->y);
+        rect.w = job.clip.w;
+        rect.h = job.clip.h;
+        return SDL_ConvertPixels_YUV_to_RGB_Rect(width, height, &rect, src_format, src_colorspace, 0, src, src_pitch,
+                                                 dst->format, SDL_COLORSPACE_SRGB, 0,
+                                                 (Uint8 *)dst->pixels + job.clip.y * dst->pitch + job.clip.x * SDL_BYTESPERPIXEL(dst->format), dst->pitch);
+    }
+
+    // If the whole destination rectangle is visible when scaling up, every converted pixel is used
+    if (srcrect->w <= dstrect->w && srcrect->h <= dstrect->h && SDL_RectsEqual(dstrect, &job.clip) &&
+        (scaleMode != SDL_SCALEMODE_LINEAR || (SDL_BYTESPERPIXEL(dst->format) == 4 && dst->format != SDL_PIXELFORMAT_ARGB2101010))) {
+        return StretchYUVToRGB(width, height, src_format, src_colorspace, src, src_pitch, srcrect, dst, dstrect, scaleMode);
+    }
+
+    switch (src_format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        y_pixel_size = 1;
+        uv_pair_size = 1;
+        job.subsampled_rows = true;
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        y_pixel_size = 1;
+        uv_pair_size = 2;
+        job.subsampled_rows = true;
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        y_pixel_size = 2;
+        uv_pair_size = 4;
+        job.subsampled_rows = false;
+        break;
+    default:
+        return SDL_SetError("Unsupported YUV format for scaling: %s", SDL_GetPixelFormatName(src_format));
+    }
+
+    if (!GetYUVPlanes(width, height, src_format, src, src_pitch, &job.y, &job.u, &job.v, &job.y_stride, &job.uv_stride)) {
+        return false;
+    }
+    if (!GetYUVConversionType(src_colorspace, &job.yuv_type)) {
+        return false;
+    }
+
+    job.linear = (scaleMode == SDL_SCALEMODE_LINEAR);
+    job.src_y = srcrect->y;
+    job.src_h = srcrect->h;
+    job.dst_y = dstrect->y;
+    job.dst_h = dstrect->h;
+    job.dst = dst;
+
+    // Find the source samples for the visible columns
+    columns = (YUVScaleColumn *)SDL_malloc(job.clip.w * sizeof(*columns));
+    if (!columns) {
+        return false;
+    }
+    for (x = 0; x < job.clip.w; ++x) {
+        YUVScaleColumn *column = &columns[x];
+
+        GetYUVScaleSample(job.clip.x + x - dstrect->x, srcrect->w, dstrect->w, job.linear, &column->offset[0], &column->frac);
+        column->offset[0] += srcrect->x;
+        column->offset[1] = column->frac ? column->offset[0] + 1 : column->offset[0];
+    }
+    job.columns = columns;
+
+    num_stripes = SDL_GetConversionStripes(job.clip.w, job.clip.h, 1, &job.stripe_height, &num_threads);
+
+    /* There are fewer destination pixels than source pixels when scaling down,
+     * so it's faster to convert only the samples that are used.
+     */
+    sample_yuv = (srcrect->w > dstrect->w);
+    if (sample_yuv) {
+        int bpp;
+
+        for (x = 0; x < job.clip.w; ++x) {
+            YUVScaleColumn *column = &columns[x];
+
+            column->uv_offset[0] = (column->offset[0] / 2) * uv_pair_size;
+            column->uv_offset[1] = (column->offset[1] / 2) * uv_pair_size;
+            column->offset[0] *= y_pixel_size;
+            column->offset[1] *= y_pixel_size;
+        }
+
+        // The columns only move forward, so the first and last ones span all the samples
+        job.y_first = columns[0].offset[0];
+        job.y_span = columns[job.clip.w - 1].offset[1] - job.y_first + 1;
+        job.uv_first = columns[0].uv_offset[0];
+        job.uv_span = columns[job.clip.w - 1].uv_offset[1] - job.uv_first + 1;
+        for (x = 0; x < job.clip.w; ++x) {
+            YUVScaleColumn *column = &columns[x];
+
+            column->offset[0] -= job.y_first;
+            column->offset[1] -= job.y_first;
+            column->uv_offset[0] -= job.uv_first;
+            column->uv_offset[1] -= job.uv_first;
+        }
+
+        if (IsYUVToRGBDirect(SDL_PIXELFORMAT_YUY2, dst->format)) {
+            job.rgb_format = dst->format;
+        } else {
+            job.rgb_format = SDL_PIXELFORMAT_ARGB8888;
+        }
+        bpp = SDL_BYTESPERPIXEL(job.rgb_format);
+        job.scratch_size = (size_t)YUV_SCALE_CHUNK_ROWS * job.clip.w * 4 + (size_t)YUV_SCALE_CHUNK_ROWS * job.clip.w * 2 * bpp;
+        if (job.linear) {
+            job.scratch_size += (size_t)job.y_span + 2 * (size_t)job.uv_span;
+        }
+        if (job.rgb_format != dst->format) {
+            job.scratch_size += (size_t)job.clip.w * bpp;
+        }
+    } else {
+        SDL_Rect rect;
+        int first_row, last_row, frac;
+
+        // Convert the part of the source that is visible, starting on an even column
+        rect.x = width;
+        rect.w = 0;
+        for (x = 0; x < job.clip.w; ++x) {
+            rect.x = SDL_min(rect.x, columns[x].offset[0]);
+            rect.w = SDL_max(rect.w, columns[x].offset[1] + 1);
+        }
+        rect.x &= ~1;
+        rect.w -= rect.x;
+        GetYUVScaleSample(job.clip.y - dstrect->y, srcrect->h, dstrect->h, job.linear, &first_row, &frac);
+        GetYUVScaleSample(job.clip.y + job.clip.h - 1 - dstrect->y, srcrect->h, dstrect->h, job.linear, &last_row, &frac);
+        if (frac) {
+            ++last_row;
+        }
+        rect.y = srcrect->y + first_row;
+        rect.h = last_row - first_row + 1;
+
+        for (x = 0; x < job.clip.w; ++x) {
+            columns[x].offset[0] -= rect.x;
+            columns[x].offset[1] -= rect.x;
+        }
+
+        job.rgb_format = SDL_PIXELFORMAT_ARGB8888;
+        job.rgb_pitch = rect.w * 4;
+        job.rgb_y = rect.y;
+        rgb = (Uint8 *)SDL_malloc((size_t)job.rgb_pitch * rect.h);
+        if (!rgb) {
+            SDL_free(columns);
+            return false;
+        }
+        if (!SDL_ConvertPixels_YUV_to_RGB_Rect(width, height, &rect, src_format, src_colorspace, 0, src, src_pitch,
+                                               job.rgb_format, SDL_COLORSPACE_SRGB, 0, rgb, job.rgb_pitch)) {
+            SDL_free(rgb);
+            SDL_free(columns);
+            return false;
+        }
+        job.rgb = rgb;
+
+        if (dst->format == SDL_PIXELFORMAT_XRGB8888) {
+            // The alpha channel is always opaque, so this is the same layout
+            job.rgb_format = SDL_PIXELFORMAT_XRGB8888;
+        }
+        job.scratch_size = (size_t)job.clip.w * sizeof(Uint32);
+        if (job.linear) {
+            job.scratch_size += job.rgb_pitch;
+        }
+    }
+
+    job.scratch = (Uint8 *)SDL_malloc(job.scratch_size * num_threads);
+    if (!job.scratch) {
+        SDL_free(rgb);
+        SDL_free(columns);
+        return false;
+    }
+
+    result = SDL_RunParallel(sample_yuv ? YUVSampleStripe : YUVStretchStripe, &job, num_stripes, num_threads);
+
+    SDL_free(job.scratch);
+    SDL_free(rgb);
+    SDL_free(columns);
+    return result;
+}
+
+bool SDL_ConvertPixels_YUV_to_RGB(int width, int height,
+                                  SDL_PixelFormat src_format, SDL_Colorspace src_colorspace, SDL_PropertiesID src_properties, const void *src, int src_pitch,
+                                  SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
+{
+    return SDL_ConvertPixels_YUV_to_RGB_Rect(width, height, NULL, src_format, src_colorspace, src_properties, src, src_pitch, dst_format, dst_colorspace, dst_properties, dst, dst_pitch);
+}
+
+struct RGB2YUVFactors
+{
+    int y_offset;
+    float y[3]; // Rfactor, Gfactor, Bfactor
+    float u[3]; // Rfactor, Gfactor, Bfactor
+    float v[3]; // Rfactor, Gfactor, Bfactor
+};
+
+static struct RGB2YUVFactors RGB2YUVFactorTables[] = {
+    // ITU-T T.871 (JPEG)
+    {
+        0,
+        { 0.2990f, 0.5870f, 0.1140f },
+        { -0.1687f, -0.3313f, 0.5000f },
+        { 0.5000f, -0.4187f, -0.0813f },
+    },
+    // ITU-R BT.601-7
+    {
+        16,
+        { 0.2568f, 0.5041f, 0.0979f },
+        { -0.1482f, -0.2910f, 0.4392f },
+        { 0.4392f, -0.3678f, -0.0714f },
+    },
+    // ITU-R BT.709-6 full range
+    {
+        0,
+        { 0.2126f, 0.7152f, 0.0722f },
+        { -0.1141f, -0.3839f, 0.498f },
+        { 0.498f, -0.4524f, -0.0457f },
+    },
+    // ITU-R BT.709-6
+    {
+        16,
+        { 0.1826f, 0.6142f, 0.0620f },
+        { -0.1006f, -0.3386f, 0.4392f },
+        { 0.4392f, -0.3989f, -0.0403f },
+    },
+    // ITU-R BT.2020 10-bit full range
+    {
+        0,
+        { 0.2627f, 0.6780f, 0.0593f },
+        { -0.1395f, -0.3600f, 0.4995f },
+        { 0.4995f, -0.4593f, -0.0402f },
+    },
+};
+
+// The filter used to subsample chroma when converting RGB to 4:2:0 YUV
+typedef enum
+{
+    RGB2YUV_CHROMA_BOX,     // truncated average of each 2x2 block
+    RGB2YUV_CHROMA_POINT,   // top-left pixel of each 2x2 block
+    RGB2YUV_CHROMA_CENTER,  // rounded average of each 2x2 block
+    RGB2YUV_CHROMA_LEFT,    // [1 2 1] horizontally, centered between the two rows
+    RGB2YUV_CHROMA_TOPLEFT  // [1 2 1] horizontally and vertically
+} RGB2YUVChromaFilter;
+
+static RGB2YUVChromaFilter GetRGB2YUVChromaFilter(SDL_Colorspace colorspace, SDL_PropertiesID props)
+{
+    const char *filter = SDL_GetStringProperty(props, SDL_PROP_SURFACE_CHROMA_FILTER_STRING, NULL);
+
+    if (filter) {
+        if (SDL_strcasecmp(filter, "point") == 0) {
+            return RGB2YUV_CHROMA_POINT;
+        }
+        if (SDL_strcasecmp(filter, "sited") == 0) {
+            switch (SDL_COLORSPACECHROMA(colorspace)) {
+            case SDL_CHROMA_LOCATION_LEFT:
+                return RGB2YUV_CHROMA_LEFT;
+            case SDL_CHROMA_LOCATION_TOPLEFT:
+                return RGB2YUV_CHROMA_TOPLEFT;
+            default:
+                return RGB2YUV_CHROMA_CENTER;
+            }
+        }
+    }
+    return RGB2YUV_CHROMA_BOX;
+}
+
+// The source rows and filter taps for one row of subsampled chroma
+typedef struct RGB2YUVChromaRow
+{
+    const Uint32 *rows[4]; // source rows, summed vertically
+    int num_rows;          // 1, 2 or 4
+    int taps;              // horizontal taps: 1 (point), 2 ([1 1]) or 3 ([1 2 1])
+    int shift;             // log2 of the total filter weight
+    int bias;              // added before the shift for rounding
+    int width;             // width of the source rows in pixels
+} RGB2YUVChromaRow;
+
+static void SetupRGB2YUVChromaRow(RGB2YUVChromaRow *row, RGB2YUVChromaFilter filter, const Uint8 *prev_row, const Uint8 *curr_row, const Uint8 *next_row, int width)
+{
+    row->width = width;
+    row->rows[0] = (const Uint32 *)curr_row;
+    row->rows[1] = (const Uint32 *)next_row;
+    row->num_rows = 2;
+    row->taps = 2;
+    row->shift = 2;
+    row->bias = 0;
+
+    switch (filter) {
+    case RGB2YUV_CHROMA_POINT:
+        row->num_rows = 1;
+        row->taps = 1;
+        row->shift = 0;
+        break;
+    case RGB2YUV_CHROMA_CENTER:
+        row->bias = 2;
+        break;
+    case RGB2YUV_CHROMA_LEFT:
+        row->taps = 3;
+        row->shift = 3;
+        row->bias = 4;
+        break;
+    case RGB2YUV_CHROMA_TOPLEFT:
+        row->rows[0] = (const Uint32 *)prev_row;
+        row->rows[1] = (const Uint32 *)curr_row;
+        row->rows[2] = (const Uint32 *)curr_row;
+        row->rows[3] = (const Uint32 *)next_row;
+        row->num_rows = 4;
+        row->taps = 3;
+        row->shift = 4;
+        row->bias = 8;
+        break;
+    default:
+        break;
+    }
+}
+
+SDL_FORCE_INLINE void RGB2YUV_SumColumn(const Uint32 *const *rows, int num_rows, int x, bool ten_bit, int *r, int *g, int *b)
+{
+    int k;
+
+    for (k = 0; k < num_rows; ++k) {
+        const Uint32 p = rows[k][x];
+        if (ten_bit) {
+            *r += (p >> 0) & 0x03ff;
+            *g += (p >> 10) & 0x03ff;
+            *b += (p >> 20) & 0x03ff;
+        } else {
+            *r += (p >> 16) & 0xff;
+            *g += (p >> 8) & 0xff;
+            *b += (p >> 0) & 0xff;
+        }
+    }
+}
+
+SDL_FORCE_INLINE void RGBtoY_Pixels(const Uint32 *src, void *dst, int i, int width, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    const float y0 = cvt->y[0], y1 = cvt->y[1], y2 = cvt->y[2];
+    const int y_offset = cvt->y_offset;
+
+    for (; i < width; ++i) {
+        const Uint32 p = src[i];
+        int y;
+
+        if (ten_bit) {
+            const Uint32 r = (p >> 0) & 0x03ff;
+            const Uint32 g = (p >> 10) & 0x03ff;
+            const Uint32 b = (p >> 20) & 0x03ff;
+            y = (int)(y0 * r + y1 * g + y2 * b + 0.5f) + y_offset;
+            ((Uint16 *)dst)[i] = (Uint16)(y << 6);
+        } else {
+            const Uint32 r = (p >> 16) & 0xff;
+            const Uint32 g = (p >> 8) & 0xff;
+            const Uint32 b = (p >> 0) & 0xff;
+            y = (int)(y0 * r + y1 * g + y2 * b + 0.5f) + y_offset;
+            ((Uint8 *)dst)[i] = (Uint8)SDL_clamp(y, 0, 255);
+        }
+    }
+}
+
+static void RGBtoY_Row(const Uint32 *src, void *dst, int i, int width, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    if (ten_bit) {
+        RGBtoY_Pixels(src, dst, i, width, cvt, true);
+    } else {
+        RGBtoY_Pixels(src, dst, i, width, cvt, false);
+    }
+}
+
+/* Convert chroma samples [i, end) of a row.
+ *
+ * If clamp_edges is false, every sample must have a pixel on both sides
+ * within the row, which keeps the loop free of branches.
+ */
+SDL_FORCE_INLINE void RGBtoUV_Samples(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt, bool ten_bit, int num_rows, int taps, bool clamp_edges)
+{
+    const Uint32 *rows[4];
+    const int width = row->width;
+    const int bias = row->bias;
+    const int shift = row->shift;
+    const float u0 = cvt->u[0], u1 = cvt->u[1], u2 = cvt->u[2];
+    const float v0 = cvt->v[0], v1 = cvt->v[1], v2 = cvt->v[2];
+
+    SDL_memcpy(rows, row->rows, sizeof(rows));
+
+    for (; i < end; ++i) {
+        const int x = 2 * i;
+        int left = x - 1;
+        int right = x + 1;
+        int r = 0, g = 0, b = 0, u, v;
+
+        if (clamp_edges) {
+            left = (left < 0) ? x : left;
+            right = (right >= width) ? x : right;
+        }
+        RGB2YUV_SumColumn(rows, num_rows, x, ten_bit, &r, &g, &b);
+        if (taps > 1) {
+            RGB2YUV_SumColumn(rows, num_rows, right, ten_bit, &r, &g, &b);
+        }
+        if (taps > 2) {
+            RGB2YUV_SumColumn(rows, num_rows, left, ten_bit, &r, &g, &b);
+            RGB2YUV_SumColumn(rows, num_rows, x, ten_bit, &r, &g, &b);
+        }
+        r = (r + bias) >> shift;
+        g = (g + bias) >> shift;
+        b = (b + bias) >> shift;
+
+        u = (int)(u0 * r + u1 * g + u2 * b + 0.5f);
+        v = (int)(v0 * r + v1 * g + v2 * b + 0.5f);
+        if (ten_bit) {
+            ((Uint16 *)u_dst)[i] = (Uint16)((u + 512) << 6);
+            ((Uint16 *)v_dst)[i] = (Uint16)((v + 512) << 6);
+        } else {
+            ((Uint8 *)u_dst)[i] = (Uint8)SDL_clamp(u + 128, 0, 255);
+            ((Uint8 *)v_dst)[i] = (Uint8)SDL_clamp(v + 128, 0, 255);
+        }
+    }
+}
+
+static void RGBtoUV_Row(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    // The samples between first and last have all their pixels within the row
+    const int first = SDL_min(SDL_max(i, (row->taps == 3) ? 1 : 0), end);
+    const int last = SDL_max(SDL_min(end, row->width / 2), first);
+
+    RGBtoUV_Samples(row, u_dst, v_dst, i, first, cvt, ten_bit, row->num_rows, row->taps, true);
+
+    // Specialize the default 2x2 box filter, which is what most conversions use
+    if (row->num_rows == 2 && row->taps == 2) {
+        if (ten_bit) {
+            RGBtoUV_Samples(row, u_dst, v_dst, first, last, cvt, true, 2, 2, false);
+        } else {
+            RGBtoUV_Samples(row, u_dst, v_dst, first, last, cvt, false, 2, 2, false);
+        }
+    } else {
+        RGBtoUV_Samples(row, u_dst, v_dst, first, last, cvt, ten_bit, row->num_rows, row->taps, false);
+    }
+
+    RGBtoUV_Samples(row, u_dst, v_dst, last, end, cvt, ten_bit, row->num_rows, row->taps, true);
+}
+
+/* The SIMD row functions convert as many pixels as they can and return the
+ * index of the first pixel left for RGBtoY_Row() and RGBtoUV_Row().
+ *
+ * They do the same float math in the same order as the scalar code, so the
+ * results are bit-exact with it.
+ */
+typedef int (*RGBtoYRowFunc)(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt);
+typedef int (*RGBtoUVRowFunc)(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt);
+
+#ifdef SDL_AVX2_INTRINSICS
+SDL_FORCE_INLINE void SDL_TARGETING("avx2") RGB2YUV_Unpack_AVX2(__m256i p, bool ten_bit, __m256i *r, __m256i *g, __m256i *b)
+{
+    if (ten_bit) {
+        const __m256i mask = _mm256_set1_epi32(0x03ff);
+        *r = _mm256_and_si256(p, mask);
+        *g = _mm256_and_si256(_mm256_srli_epi32(p, 10), mask);
+        *b = _mm256_and_si256(_mm256_srli_epi32(p, 20), mask);
+    } else {
+        const __m256i mask = _mm256_set1_epi32(0xff);
+        *r = _mm256_and_si256(_mm256_srli_epi32(p, 16), mask);
+        *g = _mm256_and_si256(_mm256_srli_epi32(p, 8), mask);
+        *b = _mm256_and_si256(p, mask);
+    }
+}
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2") RGB2YUV_Dot_AVX2(__m256i r, __m256i g, __m256i b, const float *factors, int offset)
+{
+    __m256 sum = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(factors[0]), _mm256_cvtepi32_ps(r)),
+                               _mm256_mul_ps(_mm256_set1_ps(factors[1]), _mm256_cvtepi32_ps(g)));
+    sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_set1_ps(factors[2]), _mm256_cvtepi32_ps(b)));
+    sum = _mm256_add_ps(sum, _mm256_set1_ps(0.5f));
+    return _mm256_add_epi32(_mm256_cvttps_epi32(sum), _mm256_set1_epi32(offset));
+}
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2") RGBtoY8_AVX2(const Uint32 *src, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    __m256i r, g, b;
+
+    RGB2YUV_Unpack_AVX2(_mm256_loadu_si256((const __m256i *)src), ten_bit, &r, &g, &b);
+    return RGB2YUV_Dot_AVX2(r, g, b, cvt->y, cvt->y_offset);
+}
+
+SDL_FORCE_INLINE int SDL_TARGETING("avx2") RGBtoY_Row_AVX2(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    int i = 0;
+
+    if (ten_bit) {
+        const __m256i mask = _mm256_set1_epi32(0xffff);
+        for (; i + 16 <= width; i += 16) {
+            const __m256i y0 = _mm256_and_si256(_mm256_slli_epi32(RGBtoY8_AVX2(src + i, cvt, true), 6), mask);
+            const __m256i y1 = _mm256_and_si256(_mm256_slli_epi32(RGBtoY8_AVX2(src + i + 8, cvt, true), 6), mask);
+            const __m256i y = _mm256_permute4x64_epi64(_mm256_packus_epi32(y0, y1), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256((__m256i *)((Uint16 *)dst + i), y);
+        }
+    } else {
+        const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+        for (; i + 32 <= width; i += 32) {
+            const __m256i y01 = _mm256_packs_epi32(RGBtoY8_AVX2(src + i, cvt, false), RGBtoY8_AVX2(src + i + 8, cvt, false));
+            const __m256i y23 = _mm256_packs_epi32(RGBtoY8_AVX2(src + i + 16, cvt, false), RGBtoY8_AVX2(src + i + 24, cvt, false));
+            const __m256i y = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y01, y23), order);
+            _mm256_storeu_si256((__m256i *)((Uint8 *)dst + i), y);
+        }
+    }
+    return i;
+}
+
+// Sum the channels of 8 pixels starting at x over the rows of the filter
+SDL_FORCE_INLINE void SDL_TARGETING("avx2") RGB2YUV_SumRows_AVX2(const RGB2YUVChromaRow *row, int x, bool ten_bit, __m256i *r, __m256i *g, __m256i *b)
+{
+    int k;
+
+    RGB2YUV_Unpack_AVX2(_mm256_loadu_si256((const __m256i *)(row->rows[0] + x)), ten_bit, r, g, b);
+    for (k = 1; k < row->num_rows; ++k) {
+        __m256i r1, g1, b1;
+
+        RGB2YUV_Unpack_AVX2(_mm256_loadu_si256((const __m256i *)(row->rows[k] + x)), ten_bit, &r1, &g1, &b1);
+        *r = _mm256_add_epi32(*r, r1);
+        *g = _mm256_add_epi32(*g, g1);
+        *b = _mm256_add_epi32(*b, b1);
+    }
+}
+
+// Return { a0+a1, a2+a3, ... a6+a7, b0+b1, ... b6+b7 }
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2") RGB2YUV_PairSum_AVX2(__m256i a, __m256i b)
+{
+    return _mm256_permute4x64_epi64(_mm256_hadd_epi32(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+// Return { a0, a2, a4, a6, b0, b2, b4, b6 }
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2") RGB2YUV_Even_AVX2(__m256i a, __m256i b)
+{
+    const __m256 even = _mm256_shuffle_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _MM_SHUFFLE(2, 0, 2, 0));
+    return _mm256_permute4x64_epi64(_mm256_castps_si256(even), _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+SDL_FORCE_INLINE int SDL_TARGETING("avx2") RGBtoUV_Row_AVX2(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    const __m256i bias = _mm256_set1_epi32(row->bias);
+    const __m128i shift = _mm_cvtsi32_si128(row->shift);
+    const int offset = ten_bit ? 512 : 128;
+
+    for (; i + 8 <= end; i += 8) {
+        const int x = 2 * i;
+        __m256i r0, g0, b0, r1, g1, b1, r, g, b, u, v;
+
+        RGB2YUV_SumRows_AVX2(row, x, ten_bit, &r0, &g0, &b0);
+        RGB2YUV_SumRows_AVX2(row, x + 8, ten_bit, &r1, &g1, &b1);
+        if (row->taps == 1) {
+            r = RGB2YUV_Even_AVX2(r0, r1);
+            g = RGB2YUV_Even_AVX2(g0, g1);
+            b = RGB2YUV_Even_AVX2(b0, b1);
+        } else {
+            r = RGB2YUV_PairSum_AVX2(r0, r1);
+            g = RGB2YUV_PairSum_AVX2(g0, g1);
+            b = RGB2YUV_PairSum_AVX2(b0, b1);
+            if (row->taps == 3) {
+                // Add the pairs starting one pixel to the left, for [1 2 1] weights
+                RGB2YUV_SumRows_AVX2(row, x - 1, ten_bit, &r0, &g0, &b0);
+                RGB2YUV_SumRows_AVX2(row, x + 7, ten_bit, &r1, &g1, &b1);
+                r = _mm256_add_epi32(r, RGB2YUV_PairSum_AVX2(r0, r1));
+                g = _mm256_add_epi32(g, RGB2YUV_PairSum_AVX2(g0, g1));
+                b = _mm256_add_epi32(b, RGB2YUV_PairSum_AVX2(b0, b1));
+            }
+        }
+        r = _mm256_srl_epi32(_mm256_add_epi32(r, bias), shift);
+        g = _mm256_srl_epi32(_mm256_add_epi32(g, bias), shift);
+        b = _mm256_srl_epi32(_mm256_add_epi32(b, bias), shift);
+
+        u = RGB2YUV_Dot_AVX2(r, g, b, cvt->u, offset);
+        v = RGB2YUV_Dot_AVX2(r, g, b, cvt->v, offset);
+        if (ten_bit) {
+            const __m256i mask = _mm256_set1_epi32(0xffff);
+            __m256i uv;
+
+            u = _mm256_and_si256(_mm256_slli_epi32(u, 6), mask);
+            v = _mm256_and_si256(_mm256_slli_epi32(v, 6), mask);
+            uv = _mm256_permute4x64_epi64(_mm256_packus_epi32(u, v), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm_storeu_si128((__m128i *)((Uint16 *)u_dst + i), _mm256_castsi256_si128(uv));
+            _mm_storeu_si128((__m128i *)((Uint16 *)v_dst + i), _mm256_extracti128_si256(uv, 1));
+        } else {
+            __m256i uv = _mm256_permute4x64_epi64(_mm256_packs_epi32(u, v), _MM_SHUFFLE(3, 1, 2, 0));
+
+            uv = _mm256_packus_epi16(uv, uv);
+            _mm_storel_epi64((__m128i *)((Uint8 *)u_dst + i), _mm256_castsi256_si128(uv));
+            _mm_storel_epi64((__m128i *)((Uint8 *)v_dst + i), _mm256_extracti128_si256(uv, 1));
+        }
+    }
+    return i;
+}
+
+static int SDL_TARGETING("avx2") RGBtoY_Row_XRGB8888_AVX2(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoY_Row_AVX2(src, dst, width, cvt, false);
+}
+
+static int SDL_TARGETING("avx2") RGBtoY_Row_XBGR2101010_AVX2(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoY_Row_AVX2(src, dst, width, cvt, true);
+}
+
+static int SDL_TARGETING("avx2") RGBtoUV_Row_XRGB8888_AVX2(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoUV_Row_AVX2(row, u_dst, v_dst, i, end, cvt, false);
+}
+
+static int SDL_TARGETING("avx2") RGBtoUV_Row_XBGR2101010_AVX2(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoUV_Row_AVX2(row, u_dst, v_dst, i, end, cvt, true);
+}
+#endif // SDL_AVX2_INTRINSICS
+
+#ifdef SDL_SSE4_1_INTRINSICS
+SDL_FORCE_INLINE void SDL_TARGETING("sse4.1") RGB2YUV_Unpack_SSE41(__m128i p, bool ten_bit, __m128i *r, __m128i *g, __m128i *b)
+{
+    if (ten_bit) {
+        const __m128i mask = _mm_set1_epi32(0x03ff);
+        *r = _mm_and_si128(p, mask);
+        *g = _mm_and_si128(_mm_srli_epi32(p, 10), mask);
+        *b = _mm_and_si128(_mm_srli_epi32(p, 20), mask);
+    } else {
+        const __m128i mask = _mm_set1_epi32(0xff);
+        *r = _mm_and_si128(_mm_srli_epi32(p, 16), mask);
+        *g = _mm_and_si128(_mm_srli_epi32(p, 8), mask);
+        *b = _mm_and_si128(p, mask);
+    }
+}
+
+SDL_FORCE_INLINE __m128i SDL_TARGETING("sse4.1") RGB2YUV_Dot_SSE41(__m128i r, __m128i g, __m128i b, const float *factors, int offset)
+{
+    __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(factors[0]), _mm_cvtepi32_ps(r)),
+                            _mm_mul_ps(_mm_set1_ps(factors[1]), _mm_cvtepi32_ps(g)));
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(factors[2]), _mm_cvtepi32_ps(b)));
+    sum = _mm_add_ps(sum, _mm_set1_ps(0.5f));
+    return _mm_add_epi32(_mm_cvttps_epi32(sum), _mm_set1_epi32(offset));
+}
+
+SDL_FORCE_INLINE __m128i SDL_TARGETING("sse4.1") RGBtoY4_SSE41(const Uint32 *src, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    __m128i r, g, b;
+
+    RGB2YUV_Unpack_SSE41(_mm_loadu_si128((const __m128i *)src), ten_bit, &r, &g, &b);
+    return RGB2YUV_Dot_SSE41(r, g, b, cvt->y, cvt->y_offset);
+}
+
+SDL_FORCE_INLINE int SDL_TARGETING("sse4.1") RGBtoY_Row_SSE41(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    int i = 0;
+
+    if (ten_bit) {
+        const __m128i mask = _mm_set1_epi32(0xffff);
+        for (; i + 8 <= width; i += 8) {
+            const __m128i y0 = _mm_and_si128(_mm_slli_epi32(RGBtoY4_SSE41(src + i, cvt, true), 6), mask);
+            const __m128i y1 = _mm_and_si128(_mm_slli_epi32(RGBtoY4_SSE41(src + i + 4, cvt, true), 6), mask);
+            _mm_storeu_si128((__m128i *)((Uint16 *)dst + i), _mm_packus_epi32(y0, y1));
+        }
+    } else {
+        for (; i + 16 <= width; i += 16) {
+            const __m128i y01 = _mm_packs_epi32(RGBtoY4_SSE41(src + i, cvt, false), RGBtoY4_SSE41(src + i + 4, cvt, false));
+            const __m128i y23 = _mm_packs_epi32(RGBtoY4_SSE41(src + i + 8, cvt, false), RGBtoY4_SSE41(src + i + 12, cvt, false));
+            _mm_storeu_si128((__m128i *)((Uint8 *)dst + i), _mm_packus_epi16(y01, y23));
+        }
+    }
+    return i;
+}
+
+// Sum the channels of 4 pixels starting at x over the rows of the filter
+SDL_FORCE_INLINE void SDL_TARGETING("sse4.1") RGB2YUV_SumRows_SSE41(const RGB2YUVChromaRow *row, int x, bool ten_bit, __m128i *r, __m128i *g, __m128i *b)
+{
+    int k;
+
+    RGB2YUV_Unpack_SSE41(_mm_loadu_si128((const __m128i *)(row->rows[0] + x)), ten_bit, r, g, b);
+    for (k = 1; k < row->num_rows; ++k) {
+        __m128i r1, g1, b1;
+
+        RGB2YUV_Unpack_SSE41(_mm_loadu_si128((const __m128i *)(row->rows[k] + x)), ten_bit, &r1, &g1, &b1);
+        *r = _mm_add_epi32(*r, r1);
+        *g = _mm_add_epi32(*g, g1);
+        *b = _mm_add_epi32(*b, b1);
+    }
+}
+
+// Return { a0, a2, b0, b2 }
+SDL_FORCE_INLINE __m128i SDL_TARGETING("sse4.1") RGB2YUV_Even_SSE41(__m128i a, __m128i b)
+{
+    return _mm_castps_si128(_mm_shuffle_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b), _MM_SHUFFLE(2, 0, 2, 0)));
+}
+
+SDL_FORCE_INLINE int SDL_TARGETING("sse4.1") RGBtoUV_Row_SSE41(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt, bool ten_bit)
+{
+    const __m128i bias = _mm_set1_epi32(row->bias);
+    const __m128i shift = _mm_cvtsi32_si128(row->shift);
+    const int offset = ten_bit ? 512 : 128;
+
+    for (; i + 4 <= end; i += 4) {
+        const int x = 2 * i;
+        __m128i r0, g0, b0, r1, g1, b1, r, g, b, u, v;
+
+        RGB2YUV_SumRows_SSE41(row, x, ten_bit, &r0, &g0, &b0);
+        RGB2YUV_SumRows_SSE41(row, x + 4, ten_bit, &r1, &g1, &b1);
+        if (row->taps == 1) {
+            r = RGB2YUV_Even_SSE41(r0, r1);
+            g = RGB2YUV_Even_SSE41(g0, g1);
+            b = RGB2YUV_Even_SSE41(b0, b1);
+        } else {
+            r = _mm_hadd_epi32(r0, r1);
+            g = _mm_hadd_epi32(g0, g1);
+            b = _mm_hadd_epi32(b0, b1);
+            if (row->taps == 3) {
+                // Add the pairs starting one pixel to the left, for [1 2 1] weights
+                RGB2YUV_SumRows_SSE41(row, x - 1, ten_bit, &r0, &g0, &b0);
+                RGB2YUV_SumRows_SSE41(row, x + 3, ten_bit, &r1, &g1, &b1);
+                r = _mm_add_epi32(r, _mm_hadd_epi32(r0, r1));
+                g = _mm_add_epi32(g, _mm_hadd_epi32(g0, g1));
+                b = _mm_add_epi32(b, _mm_hadd_epi32(b0, b1));
+            }
+        }
+        r = _mm_srl_epi32(_mm_add_epi32(r, bias), shift);
+        g = _mm_srl_epi32(_mm_add_epi32(g, bias), shift);
+        b = _mm_srl_epi32(_mm_add_epi32(b, bias), shift);
+
+        u = RGB2YUV_Dot_SSE41(r, g, b, cvt->u, offset);
+        v = RGB2YUV_Dot_SSE41(r, g, b, cvt->v, offset);
+        if (ten_bit) {
+            const __m128i mask = _mm_set1_epi32(0xffff);
+            __m128i uv;
+
+            u = _mm_and_si128(_mm_slli_epi32(u, 6), mask);
+            v = _mm_and_si128(_mm_slli_epi32(v, 6), mask);
+            uv = _mm_packus_epi32(u, v);
+            _mm_storel_epi64((__m128i *)((Uint16 *)u_dst + i), uv);
+            _mm_storel_epi64((__m128i *)((Uint16 *)v_dst + i), _mm_srli_si128(uv, 8));
+        } else {
+            __m128i uv = _mm_packs_epi32(u, v);
+            Uint32 packed;
+
+            uv = _mm_packus_epi16(uv, uv);
+            packed = (Uint32)_mm_cvtsi128_si32(uv);
+            SDL_memcpy((Uint8 *)u_dst + i, &packed, sizeof(packed));
+            packed = (Uint32)_mm_cvtsi128_si32(_mm_srli_si128(uv, 4));
+            SDL_memcpy((Uint8 *)v_dst + i, &packed, sizeof(packed));
+        }
+    }
+    return i;
+}
+
+static int SDL_TARGETING("sse4.1") RGBtoY_Row_XRGB8888_SSE41(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoY_Row_SSE41(src, dst, width, cvt, false);
+}
+
+static int SDL_TARGETING("sse4.1") RGBtoY_Row_XBGR2101010_SSE41(const Uint32 *src, void *dst, int width, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoY_Row_SSE41(src, dst, width, cvt, true);
+}
+
+static int SDL_TARGETING("sse4.1") RGBtoUV_Row_XRGB8888_SSE41(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoUV_Row_SSE41(row, u_dst, v_dst, i, end, cvt, false);
+}
+
+static int SDL_TARGETING("sse4.1") RGBtoUV_Row_XBGR2101010_SSE41(const RGB2YUVChromaRow *row, void *u_dst, void *v_dst, int i, int end, const struct RGB2YUVFactors *cvt)
+{
+    return RGBtoUV_Row_SSE41(row, u_dst, v_dst, i, end, cvt, true);
+}
+#endif // SDL_SSE4_1_INTRINSICS
+
+/* Convert XRGB8888 to YV12, IYUV, NV12 or NV21, or XBGR2101010 to P010.
+ *
+ * Each pair of source rows is converted to luma and then chroma while it is
+ * still in the cache.
+ */
+typedef struct RGBToYUVStripes
+{
+    int width;
+    int height;
+    int stripe_height;
+    SDL_PixelFormat src_format;
+    SDL_Colorspace src_colorspace;
+    SDL_PropertiesID src_properties;
+    const Uint8 *src;
+    int src_pitch;
+
+    // If tmp_format is set, stripes are converted to it in scratch memory for each thread first
+    SDL_PixelFormat tmp_format;
+    SDL_Colorspace tmp_colorspace;
+    SDL_PropertiesID tmp_properties;
+    int tmp_pitch;
+    Uint8 *scratch;
+    size_t scratch_size;
+
+    SDL_PixelFormat dst_format;
+    Uint8 *dst;
+    int dst_pitch;
+    Uint8 *plane_y;
+    Uint8 *plane_u;
+    Uint8 *plane_v;
+    Uint8 *plane_uv;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    YCbCrType yuv_type;
+    RGB2YUVChromaFilter filter;
+    RGBtoYRowFunc y_row_func;
+    RGBtoUVRowFunc uv_row_func;
+} RGBToYUVStripes;
+
+/* Convert rows [y0, y0 + rows) of an XRGB8888 or XBGR2101010 image to a 4:2:0 format.
+ * src points at row y0 and prev_row at the row above it, or row 0 for the first stripe.
+ * tmp needs room for a row of U and V samples if the chroma is interleaved.
+ */
+static void RGBtoYUV420_Rows(const RGBToYUVStripes *job, const Uint8 *src, const Uint8 *prev_row, int src_pitch, int y0, int rows, Uint8 *tmp)
+{
+    const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[job->yuv_type];
+    const SDL_PixelFormat dst_format = job->dst_format;
+    const bool ten_bit = (dst_format == SDL_PIXELFORMAT_P010);
+    const bool interleaved = (dst_format == SDL_PIXELFORMAT_NV12 || dst_format == SDL_PIXELFORMAT_NV21 || ten_bit);
+    const size_t sample_size = ten_bit ? sizeof(Uint16) : sizeof(Uint8);
+    const int width = job->width;
+    const int chroma_width = (width + 1) / 2;
+    const int y1 = y0 + rows;
+    const RGBtoYRowFunc y_row_func = job->y_row_func;
+    const RGBtoUVRowFunc uv_row_func = job->uv_row_func;
+    const Uint8 *curr_row, *next_row;
+    Uint8 *plane_y = job->plane_y + (size_t)y0 * job->y_stride;
+    Uint8 *plane_u = job->plane_u + (size_t)(y0 / 2) * job->uv_stride;
+    Uint8 *plane_v = job->plane_v + (size_t)(y0 / 2) * job->uv_stride;
+    Uint8 *plane_uv = job->plane_uv + (size_t)(y0 / 2) * job->uv_stride;
+    int i, j;
+
+    curr_row = src;
+    for (j = y0 / 2; 2 * j < y1; ++j) {
+        RGB2YUVChromaRow row;
+        Uint8 *u = interleaved ? tmp : plane_u;
+        Uint8 *v = interleaved ? tmp + chroma_width * sample_size : plane_v;
+        int start;
+
+        next_row = (2 * j + 1 < y1) ? curr_row + src_pitch : curr_row;
+
+        // Write the Y plane for both rows
+        i = y_row_func ? y_row_func((const Uint32 *)curr_row, plane_y, width, cvt) : 0;
+        RGBtoY_Row((const Uint32 *)curr_row, plane_y, i, width, cvt, ten_bit);
+        plane_y += job->y_stride;
+        if (next_row != curr_row) {
+            i = y_row_func ? y_row_func((const Uint32 *)next_row, plane_y, width, cvt) : 0;
+            RGBtoY_Row((const Uint32 *)next_row, plane_y, i, width, cvt, ten_bit);
+            plane_y += job->y_stride;
+        }
+
+        // Write the UV samples, the SIMD code needs whole pixel pairs and a left neighbor for [1 2 1] weights
+        SetupRGB2YUVChromaRow(&row, job->filter, prev_row, curr_row, next_row, width);
+        start = (row.taps == 3) ? 1 : 0;
+        RGBtoUV_Row(&row, u, v, 0, start, cvt, ten_bit);
+        i = uv_row_func ? uv_row_func(&row, u, v, start, width / 2, cvt) : start;
+        RGBtoUV_Row(&row, u, v, i, chroma_width, cvt, ten_bit);
+
+        if (interleaved) {
+            if (dst_format == SDL_PIXELFORMAT_NV21) {
+                Uint8 *swap = u;
+                u = v;
+                v = swap;
+            }
+            if (ten_bit) {
+                Uint16 *dst_uv = (Uint16 *)plane_uv;
+                for (i = 0; i < chroma_width; ++i) {
+                    *dst_uv++ = ((const Uint16 *)u)[i];
+                    *dst_uv++ = ((const Uint16 *)v)[i];
                 }
-                if (width_remainder) {
-                    READ_1x1_PIXEL;
-                    *plane_interleaved_uv++ = MAKE_V(r, g, b);
-                    *plane_interleaved_uv++ = MAKE_U(r, g, b);
+            } else {
+                Uint8 *dst_uv = plane_uv;
+                for (i = 0; i < chroma_width; ++i) {
+                    *dst_uv++ = u[i];
+                    *dst_uv++ = v[i];
                 }
             }
+            plane_uv += job->uv_stride;
+        } else {
+            plane_u += job->uv_stride;
+            plane_v += job->uv_stride;
         }
-    } break;
 
+        prev_row = next_row;
+        curr_row = next_row + src_pitch;
+    }
+}
+
+static bool SDL_ConvertPixels_XRGB8888_to_YUV422(int width, int height, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+{
+    const int width_half = width / 2;
+    const int width_remainder = (width & 0x1);
+    int i, j;
+
+    const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[yuv_type];
+
+#define MAKE_Y(r, g, b) (Uint8)SDL_clamp(((int)(cvt->y[0] * (r) + cvt->y[1] * (g) + cvt->y[2] * (b) + 0.5f) + cvt->y_offset), 0, 255)
+#define MAKE_U(r, g, b) (Uint8)SDL_clamp(((int)(cvt->u[0] * (r) + cvt->u[1] * (g) + cvt->u[2] * (b) + 0.5f) + 128), 0, 255)
+#define MAKE_V(r, g, b) (Uint8)SDL_clamp(((int)(cvt->v[0] * (r) + cvt->v[1] * (g) + cvt->v[2] * (b) + 0.5f) + 128), 0, 255)
+
+#define READ_1x1_PIXEL                                  \
+    const Uint32 p = ((const Uint32 *)curr_row)[2 * i]; \
+    const Uint32 r = (p & 0x00ff0000) >> 16;            \
+    const Uint32 g = (p & 0x0000ff00) >> 8;             \
+    const Uint32 b = (p & 0x000000ff);
+
+#define READ_TWO_RGB_PIXELS                                  \
+    const Uint32 p = ((const Uint32 *)curr_row)[2 * i];      \
+    const Uint32 r = (p & 0x00ff0000) >> 16;                 \
+    const Uint32 g = (p & 0x0000ff00) >> 8;                  \
+    const Uint32 b = (p & 0x000000ff);                       \
+    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i + 1]; \
+    const Uint32 r1 = (p1 & 0x00ff0000) >> 16;               \
+    const Uint32 g1 = (p1 & 0x0000ff00) >> 8;                \
+    const Uint32 b1 = (p1 & 0x000000ff);                     \
+    const Uint32 R = (r + r1) / 2;                           \
+    const Uint32 G = (g + g1) / 2;                           \
+    const Uint32 B = (b + b1) / 2;
+
+#define READ_ONE_RGB_PIXEL READ_1x1_PIXEL
+
+    switch (dst_format) {
     case SDL_PIXELFORMAT_YUY2:
     case SDL_PIXELFORMAT_UYVY:
     case SDL_PIXELFORMAT_YVYU:
@@ -995,134 +2408,41 @@ static bool SDL_ConvertPixels_XRGB8888_to_YUV(int width, int height, const void
 #undef MAKE_Y
 #undef MAKE_U
 #undef MAKE_V
-#undef READ_2x2_PIXELS
-#undef READ_2x1_PIXELS
-#undef READ_1x2_PIXELS
 #undef READ_1x1_PIXEL
 #undef READ_TWO_RGB_PIXELS
 #undef READ_ONE_RGB_PIXEL
     return true;
 }
 
-static bool SDL_ConvertPixels_XBGR2101010_to_P010(int width, int height, const void *src, int src_pitch, SDL_PixelFormat dst_format, void *dst, int dst_pitch, YCbCrType yuv_type)
+static bool RGBToYUVStripe(void *userdata, int item, int slot)
 {
-    const int src_pitch_x_2 = src_pitch * 2;
-    const int height_half = height / 2;
-    const int height_remainder = (height & 0x1);
-    const int width_half = width / 2;
-    const int width_remainder = (width & 0x1);
-    int i, j;
-
-    const struct RGB2YUVFactors *cvt = &RGB2YUVFactorTables[yuv_type];
-
-#define MAKE_Y(r, g, b) (Uint16)(((int)(cvt->y[0] * (r) + cvt->y[1] * (g) + cvt->y[2] * (b) + 0.5f) + cvt->y_offset) << 6)
-#define MAKE_U(r, g, b) (Uint16)(((int)(cvt->u[0] * (r) + cvt->u[1] * (g) + cvt->u[2] * (b) + 0.5f) + 512) << 6)
-#define MAKE_V(r, g, b) (Uint16)(((int)(cvt->v[0] * (r) + cvt->v[1] * (g) + cvt->v[2] * (b) + 0.5f) + 512) << 6)
-
-#define READ_2x2_PIXELS                                                                                     \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];                                                    \
-    const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];                                                \
-    const Uint32 p3 = ((const Uint32 *)next_row)[2 * i];                                                    \
-    const Uint32 p4 = ((const Uint32 *)next_row)[2 * i + 1];                                                \
-    const Uint32 r = ((p1 & 0x000003ff) + (p2 & 0x000003ff) + (p3 & 0x000003ff) + (p4 & 0x000003ff)) >> 2;  \
-    const Uint32 g = ((p1 & 0x000ffc00) + (p2 & 0x000ffc00) + (p3 & 0x000ffc00) + (p4 & 0x000ffc00)) >> 12; \
-    const Uint32 b = ((p1 & 0x3ff00000) + (p2 & 0x3ff00000) + (p3 & 0x3ff00000) + (p4 & 0x3ff00000)) >> 22;
-
-#define READ_2x1_PIXELS                                             \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];            \
-    const Uint32 p2 = ((const Uint32 *)next_row)[2 * i];            \
-    const Uint32 r = ((p1 & 0x000003ff) + (p2 & 0x000003ff)) >> 1;  \
-    const Uint32 g = ((p1 & 0x000ffc00) + (p2 & 0x000ffc00)) >> 11; \
-    const Uint32 b = ((p1 & 0x3ff00000) + (p2 & 0x3ff00000)) >> 21;
-
-#define READ_1x2_PIXELS                                             \
-    const Uint32 p1 = ((const Uint32 *)curr_row)[2 * i];            \
-    const Uint32 p2 = ((const Uint32 *)curr_row)[2 * i + 1];        \
-    const Uint32 r = ((p1 & 0x000003ff) + (p2 & 0x000003ff)) >> 1;  \
-    const Uint32 g = ((p1 & 0x000ffc00) + (p2 & 0x000ffc00)) >> 11; \
-    const Uint32 b = ((p1 & 0x3ff00000) + (p2 & 0x3ff00000)) >> 21;
-
-#define READ_1x1_PIXEL                                  \
-    const Uint32 p = ((const Uint32 *)curr_row)[2 * i]; \
-    const Uint32 r = (p & 0x000003ff);                  \
-    const Uint32 g = (p & 0x000ffc00) >> 10;            \
-    const Uint32 b = (p & 0x3ff00000) >> 20;
-
-    const Uint8 *curr_row, *next_row;
-
-    Uint16 *plane_y;
-    Uint16 *plane_u;
-    Uint16 *plane_v;
-    Uint16 *plane_interleaved_uv;
-    Uint32 y_stride, uv_stride, y_skip, uv_skip;
-
-    if (!GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
-                      (const Uint8 **)&plane_y, (const Uint8 **)&plane_u, (const Uint8 **)&plane_v,
-                      &y_stride, &uv_stride)) {
-        return false;
-    }
-
-    y_stride /= sizeof(Uint16);
-    uv_stride /= sizeof(Uint16);
-
-    plane_interleaved_uv = (plane_y + height * y_stride);
-    y_skip = (y_stride - width);
-
-    curr_row = (const Uint8 *)src;
-
-    // Write Y plane
-    for (j = 0; j < height; j++) {
-        for (i = 0; i < width; i++) {
-            const Uint32 p1 = ((const Uint32 *)curr_row)[i];
-            const Uint32 r = (p1 >>  0) & 0x03ff;
-            const Uint32 g = (p1 >> 10) & 0x03ff;
-            const Uint32 b = (p1 >> 20) & 0x03ff;
-            *plane_y++ = MAKE_Y(r, g, b);
+    const RGBToYUVStripes *job = (const RGBToYUVStripes *)userdata;
+    const int y0 = item * job->stripe_height;
+    const int rows = SDL_min(job->stripe_height, job->height - y0);
+    const Uint8 *src = job->src + (size_t)y0 * job->src_pitch;
+    const Uint8 *prev_row = (y0 > 0) ? src - job->src_pitch : src;
+    int src_pitch = job->src_pitch;
+    Uint8 *scratch = job->scratch ? job->scratch + (size_t)slot * job->scratch_size : NULL;
+
+    if (job->tmp_format != SDL_PIXELFORMAT_UNKNOWN) {
+        // Convert the stripe, and the row above it if the chroma filter uses it
+        const int extra = (y0 > 0 && job->filter == RGB2YUV_CHROMA_TOPLEFT) ? 1 : 0;
+
+        if (!SDL_ConvertPixelsAndColorspace(job->width, rows + extra, job->src_format, job->src_colorspace, job->src_properties, src - extra * src_pitch, src_pitch,
+                                            job->tmp_format, job->tmp_colorspace, job->tmp_properties, scratch, job->tmp_pitch)) {
+            return false;
         }
-        plane_y += y_skip;
-        curr_row += src_pitch;
+        prev_row = scratch;
+        src = scratch + extra * job->tmp_pitch;
+        src_pitch = job->tmp_pitch;
+        scratch += (size_t)job->tmp_pitch * (job->stripe_height + 1);
     }
 
-    curr_row = (const Uint8 *)src;
-    next_row = (const Uint8 *)src;
-    next_row += src_pitch;
-
-    uv_skip = (uv_stride - ((width + 1) / 2) * 2);
-    for (j = 0; j < height_half; j++) {
-        for (i = 0; i < width_half; i++) {
-            READ_2x2_PIXELS;
-            *plane_interleaved_uv++ = MAKE_U(r, g, b);
-            *plane_interleaved_uv++ = MAKE_V(r, g, b);
-        }
-        if (width_remainder) {
-            READ_2x1_PIXELS;
-            *plane_interleaved_uv++ = MAKE_U(r, g, b);
-            *plane_interleaved_uv++ = MAKE_V(r, g, b);
-        }
-        plane_interleaved_uv += uv_skip;
-        curr_row += src_pitch_x_2;
-        next_row += src_pitch_x_2;
-    }
-    if (height_remainder) {
-        for (i = 0; i < width_half; i++) {
-            READ_1x2_PIXELS;
-            *plane_interleaved_uv++ = MAKE_U(r, g, b);
-            *plane_interleaved_uv++ = MAKE_V(r, g, b);
-        }
-        if (width_remainder) {
-            READ_1x1_PIXEL;
-            *plane_interleaved_uv++ = MAKE_U(r, g, b);
-            *plane_interleaved_uv++ = MAKE_V(r, g, b);
-        }
+    if (!job->plane_y) {
+        return SDL_ConvertPixels_XRGB8888_to_YUV422(job->width, rows, src, src_pitch, job->dst_format, job->dst + (size_t)y0 * job->dst_pitch, job->dst_pitch, job->yuv_type);
     }
 
-#undef MAKE_Y
-#undef MAKE_U
-#undef MAKE_V
-#undef READ_2x2_PIXELS
-#undef READ_2x1_PIXELS
-#undef READ_1x2_PIXELS
-#undef READ_1x1_PIXEL
+    RGBtoYUV420_Rows(job, src, prev_row, src_pitch, y0, rows, scratch);
     return true;
 }
 
@@ -1131,10 +2451,17 @@ bool SDL_ConvertPixels_RGB_to_YUV(int width, int height,
                                   SDL_PixelFormat dst_format, SDL_Colorspace dst_colorspace, SDL_PropertiesID dst_properties, void *dst, int dst_pitch)
 {
     YCbCrType yuv_type = YCBCR_601_LIMITED;
+    RGB2YUVChromaFilter filter;
+    RGBToYUVStripes job;
+    bool planar = false;
+    bool ten_bit = false;
+    int num_stripes, num_threads;
+    bool result;
 
     if (!GetYUVConversionType(dst_colorspace, &yuv_type)) {
         return false;
     }
+    filter = GetRGB2YUVChromaFilter(dst_colorspace, dst_properties);
 
 #if 0 // Doesn't handle odd widths
     // RGB24 to FOURCC
@@ -1154,62 +2481,96 @@ bool SDL_ConvertPixels_RGB_to_YUV(int width, int height,
     }
 #endif
 
-    // ARGB8888 to FOURCC
-    if (src_format == SDL_PIXELFORMAT_ARGB8888 || src_format == SDL_PIXELFORMAT_XRGB8888) {
-        return SDL_ConvertPixels_XRGB8888_to_YUV(width, height, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
-    }
+    // Fill in the job for the destination and the conversion needed to get the source to XRGB8888 or XBGR2101010
+    SDL_zero(job);
+    job.width = width;
+    job.height = height;
+    job.src_format = src_format;
+    job.src_colorspace = src_colorspace;
+    job.src_properties = src_properties;
+    job.src = (const Uint8 *)src;
+    job.src_pitch = src_pitch;
+    job.dst_format = dst_format;
+    job.dst = (Uint8 *)dst;
+    job.dst_pitch = dst_pitch;
+    job.yuv_type = yuv_type;
+    job.filter = filter;
 
-    if (dst_format == SDL_PIXELFORMAT_P010) {
-        if (src_format == SDL_PIXELFORMAT_XBGR2101010) {
-            return SDL_ConvertPixels_XBGR2101010_to_P010(width, height, src, src_pitch, dst_format, dst, dst_pitch, yuv_type);
+    switch (dst_format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+    case SDL_PIXELFORMAT_P010:
+        planar = true;
+        ten_bit = (dst_format == SDL_PIXELFORMAT_P010);
+        if (!GetYUVPlanes(width, height, dst_format, dst, dst_pitch,
+                          (const Uint8 **)&job.plane_y, (const Uint8 **)&job.plane_u, (const Uint8 **)&job.plane_v,
+                          &job.y_stride, &job.uv_stride)) {
+            return false;
         }
+        job.plane_uv = job.plane_y + height * job.y_stride;
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        break;
+    default:
+        return SDL_SetError("Unsupported YUV destination format: %s", SDL_GetPixelFormatName(dst_format));
+    }
 
+    if (ten_bit) {
         // We currently only support converting from XBGR2101010 to P010
-        bool result;
-        void *tmp;
-        int tmp_pitch = (width * sizeof(Uint32));
-
-        tmp = SDL_malloc((size_t)tmp_pitch * height);
-        if (!tmp) {
-            return false;
+        if (src_format != SDL_PIXELFORMAT_XBGR2101010) {
+            job.tmp_format = SDL_PIXELFORMAT_XBGR2101010;
+            job.tmp_colorspace = dst_colorspace;
+            job.tmp_properties = dst_properties;
         }
+    } else if (src_format != SDL_PIXELFORMAT_ARGB8888 && src_format != SDL_PIXELFORMAT_XRGB8888) {
+        // not ARGB8888 to FOURCC : need an intermediate conversion
+        job.tmp_format = SDL_PIXELFORMAT_XRGB8888;
+        job.tmp_colorspace = SDL_COLORSPACE_SRGB;
+        job.tmp_properties = 0;
+    }
 
-        // convert src/src_format to tmp/XBGR2101010
-        result = SDL_ConvertPixelsAndColorspace(width, height, src_format, src_colorspace, src_properties, src, src_pitch, SDL_PIXELFORMAT_XBGR2101010, dst_colorspace, dst_properties, tmp, tmp_pitch);
-        if (!result) {
-            SDL_free(tmp);
-            return false;
+    if (planar) {
+#ifdef SDL_AVX2_INTRINSICS
+        if (SDL_HasAVX2()) {
+            job.y_row_func = ten_bit ? RGBtoY_Row_XBGR2101010_AVX2 : RGBtoY_Row_XRGB8888_AVX2;
+            job.uv_row_func = ten_bit ? RGBtoUV_Row_XBGR2101010_AVX2 : RGBtoUV_Row_XRGB8888_AVX2;
         }
-
-        // convert tmp/XBGR2101010 to dst/P010
-        result = SDL_ConvertPixels_XBGR2101010_to_P010(width, height, tmp, tmp_pitch, dst_format, dst, dst_pitch, yuv_type);
-        SDL_free(tmp);
-        return result;
+#endif
+#ifdef SDL_SSE4_1_INTRINSICS
+        if (!job.y_row_func && SDL_HasSSE41()) {
+            job.y_row_func = ten_bit ? RGBtoY_Row_XBGR2101010_SSE41 : RGBtoY_Row_XRGB8888_SSE41;
+            job.uv_row_func = ten_bit ? RGBtoUV_Row_XBGR2101010_SSE41 : RGBtoUV_Row_XRGB8888_SSE41;
+        }
+#endif
     }
 
-    // not ARGB8888 to FOURCC : need an intermediate conversion
-    {
-        bool result;
-        void *tmp;
-        int tmp_pitch = (width * sizeof(Uint32));
+    num_stripes = SDL_GetConversionStripes(width, height, 2, &job.stripe_height, &num_threads);
 
-        tmp = SDL_malloc((size_t)tmp_pitch * height);
-        if (!tmp) {
+    /* Each thread needs room for its stripe of intermediate pixels, plus the row above it for
+     * the top-left chroma filter, and a row of chroma samples to interleave into the UV plane.
+     */
+    if (job.tmp_format != SDL_PIXELFORMAT_UNKNOWN) {
+        job.tmp_pitch = (width * sizeof(Uint32));
+        job.scratch_size += (size_t)job.tmp_pitch * (job.stripe_height + 1);
+    }
+    if (planar && dst_format != SDL_PIXELFORMAT_YV12 && dst_format != SDL_PIXELFORMAT_IYUV) {
+        job.scratch_size += 2 * ((width + 1) / 2) * (ten_bit ? sizeof(Uint16) : sizeof(Uint8));
+    }
+    if (job.scratch_size) {
+        job.scratch = (Uint8 *)SDL_malloc(job.scratch_size * num_threads);
+        if (!job.scratch) {
             return false;
         }
+    }
 
-        // convert src/src_format to tmp/XRGB8888
-        result = SDL_ConvertPixelsAndColorspace(width, height, src_format, src_colorspace, src_properties, src, src_pitch, SDL_PIXELFORMAT_XRGB8888, SDL_COLORSPACE_SRGB, 0, tmp, tmp_pitch);
-        if (!result) {
-            SDL_free(tmp);
-            return false;
-        }
+    result = SDL_RunParallel(RGBToYUVStripe, &job, num_stripes, num_threads);
 
-        // convert tmp/XRGB8888 to dst/FOURCC
-        result = SDL_ConvertPixels_XRGB8888_to_YUV(width, height, tmp, tmp_pitch, dst_format, dst, dst_pitch, yuv_type);
-        SDL_free(tmp);
-        return result;
-    }
+    SDL_free(job.scratch);
+    return result;
 }
 
 static bool SDL_ConvertPixels_YUV_to_YUV_Copy(int width, int height, SDL_PixelFormat format, const void *src, int src_pitch, void *dst, int dst_pitch)
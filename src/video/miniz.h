@@ -258,7 +258,9 @@ extern "C" {
 typedef unsigned long mz_ulong;
 
 // mz_free() internally uses the MZ_FREE() macro (which by default calls free() unless you've modified the MZ_MALLOC macro) to release a block allocated from the heap.
+#ifndef MINIZ_SDL_NOUNUSED
 MINIZ_STATIC void mz_free(void *p);
+#endif
 
 #define MZ_ADLER32_INIT (1)
 // mz_adler32() returns the initial adler-32 value to use when called with ptr==NULL.
@@ -875,8 +877,8 @@ MINIZ_STATIC size_t tdefl_compress_mem_to_mem(void *pOut_buf, size_t out_buf_len
 //  Function returns a pointer to the compressed data, or NULL on failure.
 //  *pLen_out will be set to the size of the PNG image file.
 //  The caller must mz_free() the returned heap block (which will typically be larger than *pLen_out) when it's no longer needed.
-MINIZ_STATIC void *tdefl_write_image_to_png_file_in_memory_ex(const void *pImage, int w, int h, int num_chans, int bpl, size_t *pLen_out, mz_uint level, mz_bool flip, mz_uint8 *plte, int plte_size, mz_uint8 *trns, int trns_size);
 #ifndef MINIZ_SDL_NOUNUSED
+MINIZ_STATIC void *tdefl_write_image_to_png_file_in_memory_ex(const void *pImage, int w, int h, int num_chans, int bpl, size_t *pLen_out, mz_uint level, mz_bool flip, mz_uint8 *plte, int plte_size, mz_uint8 *trns, int trns_size);
 MINIZ_STATIC void *tdefl_write_image_to_png_file_in_memory(const void *pImage, int w, int h, int num_chans, int bpl, size_t *pLen_out);
 #endif
 
@@ -1075,10 +1077,12 @@ mz_ulong mz_crc32(mz_ulong crc, const mz_uint8 *ptr, size_t buf_len)
   return ~crcu32;
 }
 
+#ifndef MINIZ_SDL_NOUNUSED
 MINIZ_STATIC void mz_free(void *p)
 {
   MZ_FREE(p);
 }
+#endif
 
 #ifndef MINIZ_NO_ZLIB_APIS
 
@@ -2851,6 +2855,7 @@ typedef struct
   mz_bool m_expandable;
 } tdefl_output_buffer;
 
+#ifndef MINIZ_SDL_NOUNUSED
 static mz_bool tdefl_output_buffer_putter(const void *pBuf, int len, void *pUser)
 {
   tdefl_output_buffer *p = (tdefl_output_buffer *)pUser;
@@ -2866,7 +2871,6 @@ static mz_bool tdefl_output_buffer_putter(const void *pBuf, int len, void *pUser
   return MZ_TRUE;
 }
 
-#ifndef MINIZ_SDL_NOUNUSED
 void *tdefl_compress_mem_to_heap(const void *pSrc_buf, size_t src_buf_len, size_t *pOut_len, int flags)
 {
   tdefl_output_buffer out_buf; MZ_CLEAR_OBJ(out_buf);
@@ -2913,6 +2917,7 @@ mz_uint tdefl_create_comp_flags_from_zip_params(int level, int window_bits, int
 // Simple PNG writer function by Alex Evans, 2011. Released into the public domain: https://gist.github.com/908299, more context at
 // http://altdevblogaday.org/2011/04/06/a-smaller-jpg-encoder/.
 // This is actually a modification of Alex's original code so PNG files generated by this function pass pngcheck.
+#ifndef MINIZ_SDL_NOUNUSED
 MINIZ_STATIC void *tdefl_write_image_to_png_file_in_memory_ex(const void *pImage, int w, int h, int num_chans, int bpl, size_t *pLen_out, mz_uint level, mz_bool flip, mz_uint8 *plte, int plte_size, mz_uint8 *trns, int trns_size)
 {
   // Using a local copy of this array here in case MINIZ_NO_ZLIB_APIS was defined.
@@ -3004,7 +3009,6 @@ MINIZ_STATIC void *tdefl_write_image_to_png_file_in_memory_ex(const void *pImage
   MZ_FREE(pComp);
   return out_buf.m_pBuf;
 }
-#ifndef MINIZ_SDL_NOUNUSED
 MINIZ_STATIC void *tdefl_write_image_to_png_file_in_memory(const void *pImage, int w, int h, int num_chans, int bpl, size_t *pLen_out)
 {
   // Level 6 corresponds to TDEFL_DEFAULT_MAX_PROBES or MZ_DEFAULT_LEVEL (but we can't depend on MZ_DEFAULT_LEVEL being available in case the zlib API's where #defined out)
@@ -453,8 +453,8 @@ STBIDEF int stbi_convert_wchar_to_utf8(char *buffer, size_t bufferlen, const wch
 
 #if 0 /* not used in SDL */
 STBIDEF stbi_uc *stbi_load_from_memory_with_palette   (stbi_uc           const *buffer, int len , int *x, int *y, unsigned int *palette_buffer, int palette_buffer_len);
-#endif
 STBIDEF stbi_uc *stbi_load_from_callbacks_with_palette(stbi_io_callbacks const *clbk, void *user, int *x, int *y, unsigned int *palette_buffer, int palette_buffer_len);
+#endif
 
 ////////////////////////////////////
 //
@@ -983,9 +983,21 @@ typedef struct
    int channel_order;
 } stbi__result_info;
 
+/* SDL change: decode straight into memory provided by the caller, one row at a time */
+typedef struct
+{
+   int req_comp;     // components wanted for JPEG images, PNG images are output in their own format
+   int scale_shift;  // JPEG images are decoded at 1 / (1 << scale_shift) of their size
+   void *userdata;
+   // called with the size and number of components of the rows, returns 0 on failure
+   int (*begin)(void *userdata, int w, int h, int comp);
+   // returns where row y should be written, or NULL on failure. Rows are requested in order.
+   stbi_uc *(*get_row)(void *userdata, int y);
+} stbi__output;
+
 #ifndef STBI_NO_JPEG
 static int      stbi__jpeg_test(stbi__context *s);
-static void    *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__nv12 *nv12, stbi__result_info *ri);
+static void    *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__nv12 *nv12, stbi__output *output, stbi__result_info *ri);
 #if 0 /* not used in SDL */
 static int      stbi__jpeg_info(stbi__context *s, int *x, int *y, int *comp);
 #endif
@@ -1261,7 +1273,7 @@ static void *stbi__load_main(stbi__context *s, int *x, int *y, int *comp, int re
    // bytes matching expectations; these are prone to false positives, so
    // try them later
    #ifndef STBI_NO_JPEG
-   if (stbi__jpeg_test(s)) return stbi__jpeg_load(s,x,y,comp,req_comp,NULL, ri);
+   if (stbi__jpeg_test(s)) return stbi__jpeg_load(s,x,y,comp,req_comp,NULL,NULL, ri);
    #endif
    #ifndef STBI_NO_PNM
    if (stbi__pnm_test(s))  return stbi__pnm_load(s,x,y,comp,req_comp, ri);
@@ -1355,6 +1367,7 @@ static void stbi__vertical_flip_slices(void *image, int w, int h, int z, int byt
 }
 #endif
 
+#if 0 /* not used in SDL */
 static unsigned char *stbi__load_indexed(stbi__context *s, int *x, int *y, unsigned int *palette_buffer, int palette_buffer_len)
 {
    stbi__result_info ri;
@@ -1387,6 +1400,7 @@ static unsigned char *stbi__load_indexed(stbi__context *s, int *x, int *y, unsig
 
    return (unsigned char *) result;
 }
+#endif
 
 static unsigned char *stbi__load_and_postprocess_8bit(stbi__context *s, int *x, int *y, int *comp, int req_comp)
 {
@@ -1568,6 +1582,7 @@ STBIDEF stbi_uc *stbi_load_from_memory(stbi_uc const *buffer, int len, int *x, i
    return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
 }
 
+#if 0 /* not used in SDL */
 STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *user, int *x, int *y, int *comp, int req_comp)
 {
    stbi__context s;
@@ -1575,14 +1590,12 @@ STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk, void *u
    return stbi__load_and_postprocess_8bit(&s,x,y,comp,req_comp);
 }
 
-#if 0 /* not used in SDL */
 STBIDEF stbi_uc *stbi_load_from_memory_with_palette(stbi_uc const *buffer, int len, int *x, int *y, unsigned int *palette_buffer, int palette_buffer_len)
 {
     stbi__context s;
     stbi__start_mem(&s, buffer, len);
     return stbi__load_indexed(&s, x, y, palette_buffer, palette_buffer_len);
 }
-#endif
 
 STBIDEF stbi_uc *stbi_load_from_callbacks_with_palette(stbi_io_callbacks const *clbk, void *user, int *x, int *y, unsigned int *palette_buffer, int palette_buffer_len)
 {
@@ -1590,6 +1603,7 @@ STBIDEF stbi_uc *stbi_load_from_callbacks_with_palette(stbi_io_callbacks const *
     stbi__start_callbacks(&s, (stbi_io_callbacks *)clbk, user);
     return stbi__load_indexed(&s, x, y, palette_buffer, palette_buffer_len);
 }
+#endif
 
 #ifndef STBI_NO_GIF
 STBIDEF stbi_uc *stbi_load_gif_from_memory(stbi_uc const *buffer, int len, int **delays, int *x, int *y, int *z, int *comp, int req_comp)
@@ -2152,6 +2166,8 @@ typedef struct
    int scan_n, order[4];
    int restart_interval, todo;
 
+   int scale_shift; // SDL change: blocks are decoded to (8 >> scale_shift) pixels square
+
 // kernels
    void (*idct_block_kernel)(stbi_uc *out, int out_stride, short data[64]);
    void (*YCbCr_to_RGB_kernel)(stbi_uc *out, const stbi_uc *y, const stbi_uc *pcb, const stbi_uc *pcr, int count, int step);
@@ -2681,6 +2697,66 @@ static void stbi__idct_block(stbi_uc *out, int out_stride, short data[64])
    }
 }
 
+/* SDL change: reduced size IDCTs for decoding at 1/2, 1/4 and 1/8 of the size.
+ * An N point IDCT of the N x N lowest frequencies, with the coefficients scaled
+ * by N/8, gives the image scaled down by 8/N, like libjpeg's jidctred.
+ * The tables are c(u) * cos((2x+1) * u * pi / 2N) / 2, indexed by [x][u].
+ */
+static const int stbi__idct_4x4_table[4][4] =
+{
+   { stbi__f2f(0.35355339f), stbi__f2f( 0.46193977f), stbi__f2f( 0.35355339f), stbi__f2f( 0.19134172f) },
+   { stbi__f2f(0.35355339f), stbi__f2f( 0.19134172f), -stbi__f2f(0.35355339f), -stbi__f2f(0.46193977f) },
+   { stbi__f2f(0.35355339f), -stbi__f2f(0.19134172f), -stbi__f2f(0.35355339f), stbi__f2f( 0.46193977f) },
+   { stbi__f2f(0.35355339f), -stbi__f2f(0.46193977f), stbi__f2f( 0.35355339f), -stbi__f2f(0.19134172f) },
+};
+
+static const int stbi__idct_2x2_table[2][2] =
+{
+   { stbi__f2f(0.35355339f), stbi__f2f( 0.35355339f) },
+   { stbi__f2f(0.35355339f), -stbi__f2f(0.35355339f) },
+};
+
+static void stbi__idct_reduced(stbi_uc *out, int out_stride, const short data[64], const int *table, int n)
+{
+   int x,y,k,val[16];
+
+   // rows of coefficients, keeping 2 extra bits of precision
+   for (y=0; y < n; ++y) {
+      for (x=0; x < n; ++x) {
+         int sum = 0;
+         for (k=0; k < n; ++k)
+            sum += data[y*8+k] * table[x*n+k];
+         val[y*n+x] = (sum + 512) >> 10;
+      }
+   }
+
+   // columns, removing the 1<<12 of the table and the 1<<2 of the first pass
+   for (y=0; y < n; ++y, out += out_stride) {
+      for (x=0; x < n; ++x) {
+         int sum = 0;
+         for (k=0; k < n; ++k)
+            sum += val[k*n+x] * table[y*n+k];
+         out[x] = stbi__clamp(((sum + 8192) >> 14) + 128);
+      }
+   }
+}
+
+static void stbi__idct_block_4x4(stbi_uc *out, int out_stride, short data[64])
+{
+   stbi__idct_reduced(out, out_stride, data, &stbi__idct_4x4_table[0][0], 4);
+}
+
+static void stbi__idct_block_2x2(stbi_uc *out, int out_stride, short data[64])
+{
+   stbi__idct_reduced(out, out_stride, data, &stbi__idct_2x2_table[0][0], 2);
+}
+
+static void stbi__idct_block_1x1(stbi_uc *out, int out_stride, short data[64])
+{
+   STBI_NOTUSED(out_stride);
+   out[0] = stbi__clamp(((data[0] + 4) >> 3) + 128);
+}
+
 #ifdef STBI_SSE2
 // sse2 integer IDCT. not the fastest possible implementation but it
 // produces bit-identical results to the generic C version so it's
@@ -3122,7 +3198,7 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                int ha = z->img_comp[n].ha;
                if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               z->idct_block_kernel(z->img_comp[n].data+((z->img_comp[n].w2*j*8+i*8) >> z->scale_shift), z->img_comp[n].w2, data);
                // every data block is an MCU, so countdown the restart interval
                if (--z->todo <= 0) {
                   if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
@@ -3146,8 +3222,8 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
                   // by the basic H and V specified for the component
                   for (y=0; y < z->img_comp[n].v; ++y) {
                      for (x=0; x < z->img_comp[n].h; ++x) {
-                        int x2 = (i*z->img_comp[n].h + x)*8;
-                        int y2 = (j*z->img_comp[n].v + y)*8;
+                        int x2 = ((i*z->img_comp[n].h + x)*8) >> z->scale_shift;
+                        int y2 = ((j*z->img_comp[n].v + y)*8) >> z->scale_shift;
                         int ha = z->img_comp[n].ha;
                         if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
                         z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
@@ -3247,7 +3323,7 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
                stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               z->idct_block_kernel(z->img_comp[n].data+((z->img_comp[n].w2*j*8+i*8) >> z->scale_shift), z->img_comp[n].w2, data);
             }
          }
       }
@@ -3487,8 +3563,8 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       //
       // img_mcu_x, img_mcu_y: <=17 bits; comp[i].h and .v are <=4 (checked earlier)
       // so these muls can't overflow with 32-bit ints (which we require)
-      z->img_comp[i].w2 = z->img_mcu_x * z->img_comp[i].h * 8;
-      z->img_comp[i].h2 = z->img_mcu_y * z->img_comp[i].v * 8;
+      z->img_comp[i].w2 = (z->img_mcu_x * z->img_comp[i].h * 8) >> z->scale_shift;
+      z->img_comp[i].h2 = (z->img_mcu_y * z->img_comp[i].v * 8) >> z->scale_shift;
       z->img_comp[i].coeff = NULL;
       z->img_comp[i].raw_coeff = NULL;
       z->img_comp[i].linebuf = NULL;
@@ -3498,10 +3574,9 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       // align blocks for idct using mmx/sse
       z->img_comp[i].data = (stbi_uc*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
       if (z->progressive) {
-         // w2, h2 are multiples of 8 (see above)
-         z->img_comp[i].coeff_w = z->img_comp[i].w2 / 8;
-         z->img_comp[i].coeff_h = z->img_comp[i].h2 / 8;
-         z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].w2, z->img_comp[i].h2, sizeof(short), 15);
+         z->img_comp[i].coeff_w = z->img_mcu_x * z->img_comp[i].h;
+         z->img_comp[i].coeff_h = z->img_mcu_y * z->img_comp[i].v;
+         z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].coeff_w * 8, z->img_comp[i].coeff_h * 8, sizeof(short), 15);
          if (z->img_comp[i].raw_coeff == NULL)
             return stbi__free_jpeg_components(z, i+1, stbi__err("outofmem", "Out of memory"));
          z->img_comp[i].coeff = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
@@ -3997,6 +4072,13 @@ static void stbi__setup_jpeg(stbi__jpeg *j)
    j->resample_row_hv_2_kernel = stbi__resample_row_hv_2_simd;
   } /**/
 #endif
+   /* SDL change: scaled decoding */
+   if (j->scale_shift == 1)
+      j->idct_block_kernel = stbi__idct_block_4x4;
+   else if (j->scale_shift == 2)
+      j->idct_block_kernel = stbi__idct_block_2x2;
+   else if (j->scale_shift == 3)
+      j->idct_block_kernel = stbi__idct_block_1x1;
 }
 
 // clean up the temporary component buffers
@@ -4064,7 +4146,7 @@ static stbi_uc *output_jpeg_nv12(stbi__jpeg *z, stbi__nv12 *nv12)
    return nv12->y;
 }
 
-static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp, int req_comp, stbi__nv12 *nv12)
+static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp, int req_comp, stbi__nv12 *nv12, stbi__output *dest)
 {
    int n, decode_n, is_rgb;
    z->s->img_n = 0; // make stbi__cleanup_jpeg safe
@@ -4075,6 +4157,17 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
    // load a jpeg image from whichever source, but leave in YCbCr format
    if (!stbi__decode_jpeg_image(z)) { stbi__cleanup_jpeg(z); return NULL; }
 
+   /* SDL change: the components were decoded at a reduced size */
+   if (z->scale_shift) {
+      int k, round = (1 << z->scale_shift) - 1;
+      z->s->img_x = (z->s->img_x + round) >> z->scale_shift;
+      z->s->img_y = (z->s->img_y + round) >> z->scale_shift;
+      for (k=0; k < z->s->img_n; ++k) {
+         z->img_comp[k].x = (z->img_comp[k].x + round) >> z->scale_shift;
+         z->img_comp[k].y = (z->img_comp[k].y + round) >> z->scale_shift;
+      }
+   }
+
    // determine actual number of components to generate
    n = req_comp ? req_comp : z->s->img_n >= 3 ? 3 : 1;
 
@@ -4133,13 +4226,20 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
             else                               r->resample = stbi__resample_row_generic;
          }
 
-         // can't error after this so, this is safe
-         output = (stbi_uc *) stbi__malloc_mad3(n, z->s->img_x, z->s->img_y, 1);
-         if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
+         if (dest) {
+            /* SDL change: the rows go straight to the caller */
+            if (!dest->begin(dest->userdata, z->s->img_x, z->s->img_y, n)) { stbi__cleanup_jpeg(z); return NULL; }
+            output = (stbi_uc *) dest;
+         } else {
+            // can't error after this so, this is safe
+            output = (stbi_uc *) stbi__malloc_mad3(n, z->s->img_x, z->s->img_y, 1);
+            if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
+         }
 
          // now go ahead and resample
          for (j=0; j < z->s->img_y; ++j) {
-            stbi_uc *out = output + n * z->s->img_x * j;
+            stbi_uc *out = dest ? dest->get_row(dest->userdata, j) : output + n * z->s->img_x * j;
+            if (!out) { stbi__cleanup_jpeg(z); return NULL; }
             for (k=0; k < decode_n; ++k) {
                stbi__resample *r = &res_comp[k];
                int y_bot = r->ystep >= (r->vs >> 1);
@@ -4241,7 +4341,8 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
    }
 }
 
-static void *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__nv12 *nv12, stbi__result_info *ri)
+// SDL change: when writing to dest, the result is dest on success
+static void *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int req_comp, stbi__nv12 *nv12, stbi__output *dest, stbi__result_info *ri)
 {
    unsigned char* result;
    stbi__jpeg* j = (stbi__jpeg*) stbi__malloc(sizeof(stbi__jpeg));
@@ -4249,8 +4350,12 @@ static void *stbi__jpeg_load(stbi__context *s, int *x, int *y, int *comp, int re
    memset(j, 0, sizeof(stbi__jpeg));
    STBI_NOTUSED(ri);
    j->s = s;
+   if (dest) {
+      req_comp = dest->req_comp;
+      j->scale_shift = dest->scale_shift;
+   }
    stbi__setup_jpeg(j);
-   result = load_jpeg_image(j, x,y,comp,req_comp,nv12);
+   result = load_jpeg_image(j, x,y,comp,req_comp,nv12,dest);
    STBI_FREE(j);
    return result;
 }
@@ -4854,6 +4959,8 @@ typedef struct
    stbi__context *s;
    stbi_uc *idata, *expanded, *out;
    int depth;
+   stbi__output *output; // SDL change: where the caller would like the rows written
+   stbi__output *dest;   // SDL change: set if the rows are written to output as they're unfiltered
 } stbi__png;
 
 
@@ -4931,8 +5038,12 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
    int width = x;
 
    STBI_ASSERT(out_n == s->img_n || out_n == s->img_n+1);
-   a->out = (stbi_uc *) stbi__malloc_mad3(x, y, output_bytes, 0); // extra bytes to write off the end into
-   if (!a->out) return stbi__err("outofmem", "Out of memory");
+   if (a->dest) {
+      if (!a->dest->begin(a->dest->userdata, x, y, out_n)) return 0;
+   } else {
+      a->out = (stbi_uc *) stbi__malloc_mad3(x, y, output_bytes, 0); // extra bytes to write off the end into
+      if (!a->out) return stbi__err("outofmem", "Out of memory");
+   }
 
    // note: error exits here don't need to clean up a->out individually,
    // stbi__do_png always does on error.
@@ -4960,10 +5071,15 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
       // cur/prior filter buffers alternate
       stbi_uc *cur = filter_buf + (j & 1)*img_width_bytes;
       stbi_uc *prior = filter_buf + (~j & 1)*img_width_bytes;
-      stbi_uc *dest = a->out + stride*j;
+      stbi_uc *dest = a->dest ? a->dest->get_row(a->dest->userdata, j) : a->out + stride*j;
       int nk = width * filter_bytes;
       int filter = *raw++;
 
+      if (!dest) {
+         all_ok = 0;
+         break;
+      }
+
       // check filter type
       if (filter > 4) {
          all_ok = stbi__err("invalid filter","Corrupt PNG");
@@ -5445,6 +5561,9 @@ static int stbi__parse_png_file(stbi__png *z, int scan, int req_comp, unsigned i
                s->img_out_n = s->img_n+1;
             else
                s->img_out_n = s->img_n;
+            /* SDL change: rows that don't need any more processing can be written to the caller as they're unfiltered */
+            if (z->output && !interlace && z->depth <= 8 && !has_trans && !is_iphone && (!pal_img_n || palette_buffer))
+               z->dest = z->output;
             if (!stbi__create_png_image(z, z->expanded, raw_len, s->img_out_n, z->depth, color, interlace)) return 0;
             if (has_trans) {
                if (z->depth == 16) {
@@ -5518,6 +5637,12 @@ static void *stbi__do_png(stbi__png *p, int *x, int *y, int *n, int req_comp, un
          ri->bits_per_channel = 16;
       else
          return stbi__errpuc("bad bits_per_channel", "PNG not supported: unsupported color depth");
+      if (p->dest) {
+         /* SDL change: the rows have already been written */
+         STBI_FREE(p->expanded); p->expanded = NULL;
+         STBI_FREE(p->idata);    p->idata    = NULL;
+         return p->dest;
+      }
       result = p->out;
       p->out = NULL;
       if (req_comp && req_comp != p->s->img_out_n) {
@@ -5550,9 +5675,70 @@ static void *stbi__png_load(stbi__context *s, int *x, int *y, int *comp, int req
 {
    stbi__png p;
    p.s = s;
+   p.output = NULL;
+   p.dest = NULL;
    return stbi__do_png(&p, x,y,comp,req_comp, palette_buffer, palette_buffer_len, ri);
 }
 
+/* SDL change: decode a PNG or JPEG image into memory provided by the caller, returns 0 on failure.
+ * Images that need processing after they're decoded, like interlaced PNG images, are decoded
+ * into a temporary buffer first.
+ */
+static int stbi__load_to_output(stbi__context *s, stbi__output *dest, unsigned int *palette_buffer, int palette_buffer_len)
+{
+   stbi__result_info ri;
+   stbi__png p;
+   stbi_uc *result;
+   int x, y, comp, j;
+
+   memset(&ri, 0, sizeof(ri));
+   ri.bits_per_channel = 8;
+
+#ifndef STBI_NO_JPEG
+   if (!palette_buffer && stbi__jpeg_test(s))
+      return stbi__jpeg_load(s, &x, &y, &comp, dest->req_comp, NULL, dest, &ri) != NULL;
+#endif
+   if (!stbi__png_test(s))
+      return stbi__err("unknown image type", "Image not of any known type, or corrupt");
+
+   p.s = s;
+   p.output = dest;
+   p.dest = NULL;
+   result = (stbi_uc *) stbi__do_png(&p, &x, &y, &comp, palette_buffer ? 1 : 0, palette_buffer, palette_buffer_len, &ri);
+   if (!result)
+      return 0;
+   if (result == (stbi_uc *) dest)
+      return 1;
+
+   comp = s->img_out_n;
+   if (ri.bits_per_channel == 16) {
+      result = stbi__convert_16_to_8((stbi__uint16 *) result, x, y, comp);
+      if (!result)
+         return 0;
+   }
+   if (!dest->begin(dest->userdata, x, y, comp)) {
+      STBI_FREE(result);
+      return 0;
+   }
+   for (j = 0; j < y; ++j) {
+      stbi_uc *row = dest->get_row(dest->userdata, j);
+      if (!row) {
+         STBI_FREE(result);
+         return 0;
+      }
+      memcpy(row, result + (size_t)j * x * comp, (size_t)x * comp);
+   }
+   STBI_FREE(result);
+   return 1;
+}
+
+static int stbi_load_from_callbacks_to_output(stbi_io_callbacks const *clbk, void *user, stbi__output *dest, unsigned int *palette_buffer, int palette_buffer_len)
+{
+   stbi__context s;
+   stbi__start_callbacks(&s, (stbi_io_callbacks *) clbk, user);
+   return stbi__load_to_output(&s, dest, palette_buffer, palette_buffer_len);
+}
+
 static int stbi__png_test(stbi__context *s)
 {
    int r;
@@ -27,6 +27,9 @@
 // yuv to rgb, sse2 implementation
 #include "yuv_rgb_sse.h"
 
+// yuv to rgb, avx2 implementation
+#include "yuv_rgb_avx2.h"
+
 // yuv to rgb, lsx implementation
 #include "yuv_rgb_lsx.h"
 
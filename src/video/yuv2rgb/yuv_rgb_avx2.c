@@ -0,0 +1,280 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+#include "SDL_internal.h"
+
+#ifdef SDL_HAVE_YUV
+#include "yuv_rgb_internal.h"
+
+#ifdef SDL_AVX2_INTRINSICS
+
+#define AVX2_FUNCTION_NAME	yuv420_rgb565_avx2
+#define STD_FUNCTION_NAME	yuv420_rgb565_std
+#define YUV_FORMAT			YUV_FORMAT_420
+#define RGB_FORMAT			RGB_FORMAT_RGB565
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv420_rgb24_avx2
+#define STD_FUNCTION_NAME	yuv420_rgb24_std
+#define YUV_FORMAT			YUV_FORMAT_420
+#define RGB_FORMAT			RGB_FORMAT_RGB24
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv420_rgba_avx2
+#define STD_FUNCTION_NAME	yuv420_rgba_std
+#define YUV_FORMAT			YUV_FORMAT_420
+#define RGB_FORMAT			RGB_FORMAT_RGBA
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv420_bgra_avx2
+#define STD_FUNCTION_NAME	yuv420_bgra_std
+#define YUV_FORMAT			YUV_FORMAT_420
+#define RGB_FORMAT			RGB_FORMAT_BGRA
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv420_argb_avx2
+#define STD_FUNCTION_NAME	yuv420_argb_std
+#define YUV_FORMAT			YUV_FORMAT_420
+#define RGB_FORMAT			RGB_FORMAT_ARGB
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv420_abgr_avx2
+#define STD_FUNCTION_NAME	yuv420_abgr_std
+#define YUV_FORMAT			YUV_FORMAT_420
+#define RGB_FORMAT			RGB_FORMAT_ABGR
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv422_rgb565_avx2
+#define STD_FUNCTION_NAME	yuv422_rgb565_std
+#define YUV_FORMAT			YUV_FORMAT_422
+#define RGB_FORMAT			RGB_FORMAT_RGB565
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv422_rgb24_avx2
+#define STD_FUNCTION_NAME	yuv422_rgb24_std
+#define YUV_FORMAT			YUV_FORMAT_422
+#define RGB_FORMAT			RGB_FORMAT_RGB24
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv422_rgba_avx2
+#define STD_FUNCTION_NAME	yuv422_rgba_std
+#define YUV_FORMAT			YUV_FORMAT_422
+#define RGB_FORMAT			RGB_FORMAT_RGBA
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv422_bgra_avx2
+#define STD_FUNCTION_NAME	yuv422_bgra_std
+#define YUV_FORMAT			YUV_FORMAT_422
+#define RGB_FORMAT			RGB_FORMAT_BGRA
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv422_argb_avx2
+#define STD_FUNCTION_NAME	yuv422_argb_std
+#define YUV_FORMAT			YUV_FORMAT_422
+#define RGB_FORMAT			RGB_FORMAT_ARGB
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuv422_abgr_avx2
+#define STD_FUNCTION_NAME	yuv422_abgr_std
+#define YUV_FORMAT			YUV_FORMAT_422
+#define RGB_FORMAT			RGB_FORMAT_ABGR
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuvnv12_rgb565_avx2
+#define STD_FUNCTION_NAME	yuvnv12_rgb565_std
+#define YUV_FORMAT			YUV_FORMAT_NV12
+#define RGB_FORMAT			RGB_FORMAT_RGB565
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuvnv12_rgb24_avx2
+#define STD_FUNCTION_NAME	yuvnv12_rgb24_std
+#define YUV_FORMAT			YUV_FORMAT_NV12
+#define RGB_FORMAT			RGB_FORMAT_RGB24
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuvnv12_rgba_avx2
+#define STD_FUNCTION_NAME	yuvnv12_rgba_std
+#define YUV_FORMAT			YUV_FORMAT_NV12
+#define RGB_FORMAT			RGB_FORMAT_RGBA
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuvnv12_bgra_avx2
+#define STD_FUNCTION_NAME	yuvnv12_bgra_std
+#define YUV_FORMAT			YUV_FORMAT_NV12
+#define RGB_FORMAT			RGB_FORMAT_BGRA
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuvnv12_argb_avx2
+#define STD_FUNCTION_NAME	yuvnv12_argb_std
+#define YUV_FORMAT			YUV_FORMAT_NV12
+#define RGB_FORMAT			RGB_FORMAT_ARGB
+#include "yuv_rgb_avx2_func.h"
+
+#define AVX2_FUNCTION_NAME	yuvnv12_abgr_avx2
+#define STD_FUNCTION_NAME	yuvnv12_abgr_std
+#define YUV_FORMAT			YUV_FORMAT_NV12
+#define RGB_FORMAT			RGB_FORMAT_ABGR
+#include "yuv_rgb_avx2_func.h"
+
+/* P010 stores 10-bit samples in the high bits of 16-bit words, so intermediate
+ * values don't fit in 16 bits and the math is done on 8 pixels in 32-bit lanes.
+ * The results are identical to the standard C implementation.
+ */
+
+/* Duplicate each of 8 chroma values over the two pixels that share it */
+#define DUPLICATE_8(T, X1, X2) \
+	lo = _mm256_unpacklo_epi32(T, T); \
+	hi = _mm256_unpackhi_epi32(T, T); \
+	X1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	X2 = _mm256_permute2x128_si256(lo, hi, 0x31);
+
+SDL_FORCE_INLINE __m256i SDL_TARGETING("avx2") clamp10_avx2(__m256i v)
+{
+	v = _mm256_srai_epi32(v, PRECISION);
+	return _mm256_min_epi32(_mm256_max_epi32(v, _mm256_setzero_si256()), _mm256_set1_epi32(1023));
+}
+
+SDL_FORCE_INLINE void SDL_TARGETING("avx2") yuvp010_pack8_avx2(const YUV2RGBParam *param, const uint16_t *y_ptr,
+	__m256i r_uv, __m256i g_uv, __m256i b_uv, uint8_t *rgb_ptr, int rgb_format)
+{
+	__m256i y, r, g, b, rgb;
+
+	y = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)y_ptr));
+	y = _mm256_srai_epi32(_mm256_sub_epi32(y, _mm256_set1_epi32(param->y_shift)), 6);
+	y = _mm256_mullo_epi32(y, _mm256_set1_epi32(param->y_factor));
+
+	r = clamp10_avx2(_mm256_add_epi32(y, r_uv));
+	g = clamp10_avx2(_mm256_add_epi32(y, g_uv));
+	b = clamp10_avx2(_mm256_add_epi32(y, b_uv));
+
+	if (rgb_format == RGB_FORMAT_XBGR2101010) {
+		rgb = _mm256_or_si256(_mm256_set1_epi32((int)0xC0000000),
+			_mm256_or_si256(_mm256_slli_epi32(b, 20), _mm256_or_si256(_mm256_slli_epi32(g, 10), r)));
+	} else {
+		r = _mm256_srli_epi32(r, 2);
+		g = _mm256_srli_epi32(g, 2);
+		b = _mm256_srli_epi32(b, 2);
+		if (rgb_format == RGB_FORMAT_RGBA) {
+			rgb = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(r, 24), _mm256_slli_epi32(g, 16)),
+				_mm256_or_si256(_mm256_slli_epi32(b, 8), _mm256_set1_epi32(0x000000FF)));
+		} else if (rgb_format == RGB_FORMAT_BGRA) {
+			rgb = _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi32(b, 24), _mm256_slli_epi32(g, 16)),
+				_mm256_or_si256(_mm256_slli_epi32(r, 8), _mm256_set1_epi32(0x000000FF)));
+		} else if (rgb_format == RGB_FORMAT_ARGB) {
+			rgb = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32((int)0xFF000000), _mm256_slli_epi32(r, 16)),
+				_mm256_or_si256(_mm256_slli_epi32(g, 8), b));
+		} else {
+			rgb = _mm256_or_si256(_mm256_or_si256(_mm256_set1_epi32((int)0xFF000000), _mm256_slli_epi32(b, 16)),
+				_mm256_or_si256(_mm256_slli_epi32(g, 8), r));
+		}
+	}
+	_mm256_storeu_si256((__m256i *)rgb_ptr, rgb);
+}
+
+SDL_FORCE_INLINE void SDL_TARGETING("avx2") yuvp010_avx2(uint32_t width, uint32_t height,
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type, int rgb_format,
+	void (*std_function)(uint32_t, uint32_t, const uint16_t *, const uint16_t *, const uint16_t *, uint32_t, uint32_t, uint8_t *, uint32_t, YCbCrType))
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	const uint32_t converted = (width & ~15);
+	uint32_t xpos, ypos;
+
+	for (ypos = 0; ypos < (height - 1); ypos += 2) {
+		const uint16_t *y_ptr1 = (const uint16_t *)((const uint8_t *)Y + ypos * Y_stride),
+			*y_ptr2 = (const uint16_t *)((const uint8_t *)Y + (ypos + 1) * Y_stride),
+			*u_ptr = (const uint16_t *)((const uint8_t *)U + (ypos / 2) * UV_stride);
+		uint8_t *rgb_ptr1 = RGB + ypos * RGB_stride,
+			*rgb_ptr2 = RGB + (ypos + 1) * RGB_stride;
+
+		for (xpos = 0; xpos < converted; xpos += 16) {
+			__m256i uv, u, v, r_tmp, g_tmp, b_tmp, lo, hi;
+			__m256i r_uv1, g_uv1, b_uv1, r_uv2, g_uv2, b_uv2;
+
+			/* U and V are interleaved, U in the low half of each 32-bit lane */
+			uv = _mm256_loadu_si256((const __m256i *)u_ptr);
+			u = _mm256_sub_epi32(_mm256_srli_epi32(_mm256_and_si256(uv, _mm256_set1_epi32(0xFFFF)), 6), _mm256_set1_epi32(512));
+			v = _mm256_sub_epi32(_mm256_srli_epi32(uv, 16 + 6), _mm256_set1_epi32(512));
+
+			r_tmp = _mm256_mullo_epi32(v, _mm256_set1_epi32(param->v_r_factor));
+			g_tmp = _mm256_add_epi32(_mm256_mullo_epi32(u, _mm256_set1_epi32(param->u_g_factor)),
+				_mm256_mullo_epi32(v, _mm256_set1_epi32(param->v_g_factor)));
+			b_tmp = _mm256_mullo_epi32(u, _mm256_set1_epi32(param->u_b_factor));
+			DUPLICATE_8(r_tmp, r_uv1, r_uv2)
+			DUPLICATE_8(g_tmp, g_uv1, g_uv2)
+			DUPLICATE_8(b_tmp, b_uv1, b_uv2)
+
+			yuvp010_pack8_avx2(param, y_ptr1, r_uv1, g_uv1, b_uv1, rgb_ptr1, rgb_format);
+			yuvp010_pack8_avx2(param, y_ptr1 + 8, r_uv2, g_uv2, b_uv2, rgb_ptr1 + 32, rgb_format);
+			yuvp010_pack8_avx2(param, y_ptr2, r_uv1, g_uv1, b_uv1, rgb_ptr2, rgb_format);
+			yuvp010_pack8_avx2(param, y_ptr2 + 8, r_uv2, g_uv2, b_uv2, rgb_ptr2 + 32, rgb_format);
+
+			y_ptr1 += 16;
+			y_ptr2 += 16;
+			u_ptr += 16;
+			rgb_ptr1 += 64;
+			rgb_ptr2 += 64;
+		}
+	}
+
+	/* Catch the last line, if needed */
+	if (ypos == (height - 1) && converted > 0) {
+		std_function(converted, 1,
+			(const uint16_t *)((const uint8_t *)Y + ypos * Y_stride),
+			(const uint16_t *)((const uint8_t *)U + (ypos / 2) * UV_stride),
+			(const uint16_t *)((const uint8_t *)V + (ypos / 2) * UV_stride),
+			Y_stride, UV_stride, RGB + ypos * RGB_stride, RGB_stride, yuv_type);
+	}
+
+	/* Catch the right column, if needed */
+	if (converted != width) {
+		std_function(width - converted, height, Y + converted, U + converted, V + converted,
+			Y_stride, UV_stride, RGB + converted * 4, RGB_stride, yuv_type);
+	}
+}
+
+#undef DUPLICATE_8
+
+void SDL_TARGETING("avx2") yuvp010_xbgr2101010_avx2(uint32_t width, uint32_t height,
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	yuvp010_avx2(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, RGB_FORMAT_XBGR2101010, yuvp010_xbgr2101010_std);
+}
+
+void SDL_TARGETING("avx2") yuvp010_rgba_avx2(uint32_t width, uint32_t height,
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	yuvp010_avx2(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, RGB_FORMAT_RGBA, yuvp010_rgba_std);
+}
+
+void SDL_TARGETING("avx2") yuvp010_bgra_avx2(uint32_t width, uint32_t height,
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	yuvp010_avx2(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, RGB_FORMAT_BGRA, yuvp010_bgra_std);
+}
+
+void SDL_TARGETING("avx2") yuvp010_argb_avx2(uint32_t width, uint32_t height,
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	yuvp010_avx2(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, RGB_FORMAT_ARGB, yuvp010_argb_std);
+}
+
+void SDL_TARGETING("avx2") yuvp010_abgr_avx2(uint32_t width, uint32_t height,
+	const uint16_t *Y, const uint16_t *U, const uint16_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	yuvp010_avx2(width, height, Y, U, V, Y_stride, UV_stride, RGB, RGB_stride, yuv_type, RGB_FORMAT_ABGR, yuvp010_abgr_std);
+}
+
+#endif // SDL_AVX2_INTRINSICS
+
+#endif // SDL_HAVE_YUV
@@ -0,0 +1,396 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* You need to define the following macros before including this file:
+	AVX2_FUNCTION_NAME
+	STD_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+/* This is the SSE2 algorithm widened to 256-bit registers, producing the exact
+ * same output. AVX2 unpack and pack instructions work within each 128-bit lane,
+ * so the 8-bit color channels are kept in "packed order" (pixels 0-7, 16-23 in
+ * the low lane and 8-15, 24-31 in the high lane), which the unpacks in PACK_PIXEL
+ * turn back into sequential order.
+ */
+
+#define LOAD_SI128 _mm_loadu_si128
+#define SAVE_SI128 _mm_storeu_si128
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI256 _mm256_storeu_si256
+
+/* Duplicate each of 16 chroma values over the two pixels that share it */
+#define DUPLICATE_16(T, X1, X2) \
+	lo = _mm256_unpacklo_epi16(T, T); \
+	hi = _mm256_unpackhi_epi16(T, T); \
+	X1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	X2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+
+#define UV2RGB_16(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = _mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_r_factor)); \
+	g_tmp = _mm256_add_epi16( \
+		_mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_g_factor)), \
+		_mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_g_factor))); \
+	b_tmp = _mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_b_factor)); \
+	DUPLICATE_16(r_tmp, R1, R2) \
+	DUPLICATE_16(g_tmp, G1, G2) \
+	DUPLICATE_16(b_tmp, B1, B2) \
+
+#define ADD_Y2RGB_16(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm256_mullo_epi16(_mm256_sub_epi16(Y1, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	Y2 = _mm256_mullo_epi16(_mm256_sub_epi16(Y2, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	\
+	R1 = _mm256_srai_epi16(_mm256_add_epi16(R1, Y1), PRECISION); \
+	G1 = _mm256_srai_epi16(_mm256_add_epi16(G1, Y1), PRECISION); \
+	B1 = _mm256_srai_epi16(_mm256_add_epi16(B1, Y1), PRECISION); \
+	R2 = _mm256_srai_epi16(_mm256_add_epi16(R2, Y2), PRECISION); \
+	G2 = _mm256_srai_epi16(_mm256_add_epi16(G2, Y2), PRECISION); \
+	B2 = _mm256_srai_epi16(_mm256_add_epi16(B2, Y2), PRECISION); \
+
+#define PACK_RGB565_32(R, G, B, RGB1, RGB2) \
+{ \
+	const __m256i red_mask = _mm256_set1_epi16((short)0xF800); \
+	RGB1 = _mm256_and_si256(_mm256_unpacklo_epi8(_mm256_setzero_si256(), R), red_mask); \
+	RGB2 = _mm256_and_si256(_mm256_unpackhi_epi8(_mm256_setzero_si256(), R), red_mask); \
+	RGB1 = _mm256_or_si256(RGB1, _mm256_slli_epi16(_mm256_srli_epi16(_mm256_unpacklo_epi8(G, _mm256_setzero_si256()), 2), 5)); \
+	RGB2 = _mm256_or_si256(RGB2, _mm256_slli_epi16(_mm256_srli_epi16(_mm256_unpackhi_epi8(G, _mm256_setzero_si256()), 2), 5)); \
+	RGB1 = _mm256_or_si256(RGB1, _mm256_srli_epi16(_mm256_unpacklo_epi8(B, _mm256_setzero_si256()), 3)); \
+	RGB2 = _mm256_or_si256(RGB2, _mm256_srli_epi16(_mm256_unpackhi_epi8(B, _mm256_setzero_si256()), 3)); \
+}
+
+/* The 24-bit interleave is done on 128-bit halves, exactly as in the SSE2 version */
+#define PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+RGB1 = _mm_packus_epi16(_mm_and_si128(R1,_mm_set1_epi16(0xFF)), _mm_and_si128(R2,_mm_set1_epi16(0xFF))); \
+RGB2 = _mm_packus_epi16(_mm_and_si128(G1,_mm_set1_epi16(0xFF)), _mm_and_si128(G2,_mm_set1_epi16(0xFF))); \
+RGB3 = _mm_packus_epi16(_mm_and_si128(B1,_mm_set1_epi16(0xFF)), _mm_and_si128(B2,_mm_set1_epi16(0xFF))); \
+RGB4 = _mm_packus_epi16(_mm_srli_epi16(R1,8), _mm_srli_epi16(R2,8)); \
+RGB5 = _mm_packus_epi16(_mm_srli_epi16(G1,8), _mm_srli_epi16(G2,8)); \
+RGB6 = _mm_packus_epi16(_mm_srli_epi16(B1,8), _mm_srli_epi16(B2,8)); \
+
+#define PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+R1 = _mm_packus_epi16(_mm_and_si128(RGB1,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB2,_mm_set1_epi16(0xFF))); \
+R2 = _mm_packus_epi16(_mm_and_si128(RGB3,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB4,_mm_set1_epi16(0xFF))); \
+G1 = _mm_packus_epi16(_mm_and_si128(RGB5,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB6,_mm_set1_epi16(0xFF))); \
+G2 = _mm_packus_epi16(_mm_srli_epi16(RGB1,8), _mm_srli_epi16(RGB2,8)); \
+B1 = _mm_packus_epi16(_mm_srli_epi16(RGB3,8), _mm_srli_epi16(RGB4,8)); \
+B2 = _mm_packus_epi16(_mm_srli_epi16(RGB5,8), _mm_srli_epi16(RGB6,8)); \
+
+#define PACK_RGB24_32(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+
+/* The first channel ends up in the most significant byte of each pixel */
+#define PACK_RGBA_32(C1, C2, C3, C4, RGB1, RGB2, RGB3, RGB4) \
+{ \
+	__m256i c43, c21, t1, t2; \
+\
+	c43 = _mm256_unpacklo_epi8(C4, C3); \
+	c21 = _mm256_unpacklo_epi8(C2, C1); \
+	t1 = _mm256_unpacklo_epi16(c43, c21); \
+	t2 = _mm256_unpackhi_epi16(c43, c21); \
+	RGB1 = _mm256_permute2x128_si256(t1, t2, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(t1, t2, 0x31); \
+\
+	c43 = _mm256_unpackhi_epi8(C4, C3); \
+	c21 = _mm256_unpackhi_epi8(C2, C1); \
+	t1 = _mm256_unpacklo_epi16(c43, c21); \
+	t2 = _mm256_unpackhi_epi16(c43, c21); \
+	RGB3 = _mm256_permute2x128_si256(t1, t2, 0x20); \
+	RGB4 = _mm256_permute2x128_si256(t1, t2, 0x31); \
+}
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define PACK_PIXEL(rgb_ptr) \
+{ \
+	__m256i rgb_1, rgb_2; \
+	\
+	PACK_RGB565_32(r_8, g_8, b_8, rgb_1, rgb_2) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define PACK_PIXEL(rgb_ptr) \
+{ \
+	__m128i r_8_1, r_8_2, g_8_1, g_8_2, b_8_1, b_8_2; \
+	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
+	\
+	r_8 = _mm256_permute4x64_epi64(r_8, _MM_SHUFFLE(3, 1, 2, 0)); \
+	g_8 = _mm256_permute4x64_epi64(g_8, _MM_SHUFFLE(3, 1, 2, 0)); \
+	b_8 = _mm256_permute4x64_epi64(b_8, _MM_SHUFFLE(3, 1, 2, 0)); \
+	r_8_1 = _mm256_castsi256_si128(r_8); \
+	r_8_2 = _mm256_extracti128_si256(r_8, 1); \
+	g_8_1 = _mm256_castsi256_si128(g_8); \
+	g_8_2 = _mm256_extracti128_si256(g_8, 1); \
+	b_8_1 = _mm256_castsi256_si128(b_8); \
+	b_8_2 = _mm256_extracti128_si256(b_8, 1); \
+	\
+	PACK_RGB24_32(r_8_1, r_8_2, g_8_1, g_8_2, b_8_1, b_8_2, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	SAVE_SI128((__m128i*)(rgb_ptr), rgb_1); \
+	SAVE_SI128((__m128i*)(rgb_ptr+16), rgb_2); \
+	SAVE_SI128((__m128i*)(rgb_ptr+32), rgb_3); \
+	SAVE_SI128((__m128i*)(rgb_ptr+48), rgb_4); \
+	SAVE_SI128((__m128i*)(rgb_ptr+64), rgb_5); \
+	SAVE_SI128((__m128i*)(rgb_ptr+80), rgb_6); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+
+#if RGB_FORMAT == RGB_FORMAT_RGBA
+#define PACK_RGBA_CHANNELS r_8, g_8, b_8, a
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+#define PACK_RGBA_CHANNELS b_8, g_8, r_8, a
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+#define PACK_RGBA_CHANNELS a, r_8, g_8, b_8
+#elif RGB_FORMAT == RGB_FORMAT_ABGR
+#define PACK_RGBA_CHANNELS a, b_8, g_8, r_8
+#endif
+
+#define PACK_RGBA_32_CHANNELS(...) PACK_RGBA_32(__VA_ARGS__)
+
+#define PACK_PIXEL(rgb_ptr) \
+{ \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4; \
+	const __m256i a = _mm256_set1_epi8((char)0xFF); \
+	\
+	PACK_RGBA_32_CHANNELS(PACK_RGBA_CHANNELS, rgb_1, rgb_2, rgb_3, rgb_4) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+64), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr+96), rgb_4); \
+}
+
+#else
+#error PACK_PIXEL unimplemented
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+{ \
+	const __m256i y = LOAD_SI256((const __m256i*)(y_ptr)); \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(y)); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(y, 1)); \
+}
+
+#define READ_UV	\
+	u_16 = _mm256_cvtepu8_epi16(LOAD_SI128((const __m128i*)(u_ptr))); \
+	v_16 = _mm256_cvtepu8_epi16(LOAD_SI128((const __m128i*)(v_ptr))); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+	y_16_1 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr)), _mm256_set1_epi16(0xFF)); \
+	y_16_2 = _mm256_and_si256(LOAD_SI256((const __m256i*)(y_ptr+32)), _mm256_set1_epi16(0xFF)); \
+
+#define READ_UV	\
+{ \
+	__m256i u1, u2, v1, v2; \
+	u1 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(u_ptr)), 24), 24); \
+	u2 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(u_ptr+32)), 24), 24); \
+	u_16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(u1, u2), _MM_SHUFFLE(3, 1, 2, 0)); \
+	v1 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(v_ptr)), 24), 24); \
+	v2 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(v_ptr+32)), 24), 24); \
+	v_16 = _mm256_permute4x64_epi64(_mm256_packs_epi32(v1, v2), _MM_SHUFFLE(3, 1, 2, 0)); \
+}
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+{ \
+	const __m256i y = LOAD_SI256((const __m256i*)(y_ptr)); \
+	y_16_1 = _mm256_cvtepu8_epi16(_mm256_castsi256_si128(y)); \
+	y_16_2 = _mm256_cvtepu8_epi16(_mm256_extracti128_si256(y, 1)); \
+}
+
+#define READ_UV	\
+	u_16 = _mm256_and_si256(LOAD_SI256((const __m256i*)(u_ptr)), _mm256_set1_epi16(0xFF)); \
+	v_16 = _mm256_and_si256(LOAD_SI256((const __m256i*)(v_ptr)), _mm256_set1_epi16(0xFF)); \
+
+#else
+#error READ_UV unimplemented
+#endif
+
+/* Compute the chroma contribution for 32 pixels, shared by both lines */
+#define YUV2RGB_32_UV \
+	__m256i r_tmp, g_tmp, b_tmp, lo, hi; \
+	__m256i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	__m256i u_16, v_16; \
+	\
+	READ_UV \
+	u_16 = _mm256_add_epi16(u_16, _mm256_set1_epi16(-128)); \
+	v_16 = _mm256_add_epi16(v_16, _mm256_set1_epi16(-128)); \
+	\
+	UV2RGB_16(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+
+/* Add the luma of one line of 32 pixels and pack the result into r_8, g_8, b_8 */
+#define YUV2RGB_32_LINE(y_ptr) \
+	__m256i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m256i y_16_1, y_16_2; \
+	__m256i r_8, g_8, b_8; \
+	\
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	READ_Y(y_ptr) \
+	\
+	ADD_Y2RGB_16(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = _mm256_packus_epi16(r_16_1, r_16_2); \
+	g_8 = _mm256_packus_epi16(g_16_1, g_16_2); \
+	b_8 = _mm256_packus_epi16(b_16_1, b_16_2); \
+
+
+void SDL_TARGETING("avx2") AVX2_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+#else
+#error Unknown RGB pixel size
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_NV12
+	/* READ_UV reads one byte past the end of the line for NV21, see yuv_rgb_sse_func.h */
+	const int fix_read_nv12 = ((width & 31) == 0);
+#else
+	const int fix_read_nv12 = 0;
+#endif
+
+#if YUV_FORMAT == YUV_FORMAT_422
+	/* READ_UV reads up to two bytes past the end of the line, avoid invalid read on last line */
+	const int fix_read_422 = 1;
+#else
+	const int fix_read_422 = 0;
+#endif
+
+
+	if (width >= 32) {
+		uint32_t xpos, ypos;
+		for(ypos=0; ypos<(height-(uv_y_sample_interval-1)) - fix_read_422; ypos+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+ypos*Y_stride,
+				*y_ptr2=Y+(ypos+uv_y_sample_interval-1)*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+ypos*RGB_stride,
+				*rgb_ptr2=RGB+(ypos+uv_y_sample_interval-1)*RGB_stride;
+
+			for(xpos=0; xpos<(width-31) - fix_read_nv12; xpos+=32)
+			{
+				YUV2RGB_32_UV
+				{
+					YUV2RGB_32_LINE(y_ptr1)
+					PACK_PIXEL(rgb_ptr1)
+				}
+				if (uv_y_sample_interval > 1)
+				{
+					YUV2RGB_32_LINE(y_ptr2)
+					PACK_PIXEL(rgb_ptr2)
+				}
+
+				y_ptr1+=32*y_pixel_stride;
+				y_ptr2+=32*y_pixel_stride;
+				u_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=32*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=32*rgb_pixel_stride;
+				rgb_ptr2+=32*rgb_pixel_stride;
+			}
+		}
+
+		if (fix_read_422) {
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+			ypos += uv_y_sample_interval;
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && ypos == (height-1))
+		{
+			const uint8_t *y_ptr=Y+ypos*Y_stride,
+				*u_ptr=U+(ypos/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(ypos/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+ypos*RGB_stride;
+
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	{
+		uint32_t converted = (width & ~31);
+		if (fix_read_nv12) {
+			converted -= 32;
+		}
+		if (converted != width)
+		{
+			const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+				*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+				*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+
+			uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+
+			STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+}
+
+#undef AVX2_FUNCTION_NAME
+#undef STD_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef LOAD_SI128
+#undef SAVE_SI128
+#undef LOAD_SI256
+#undef SAVE_SI256
+#undef DUPLICATE_16
+#undef UV2RGB_16
+#undef ADD_Y2RGB_16
+#undef PACK_RGB565_32
+#undef PACK_RGB24_32_STEP1
+#undef PACK_RGB24_32_STEP2
+#undef PACK_RGB24_32
+#undef PACK_RGBA_32
+#undef PACK_RGBA_CHANNELS
+#undef PACK_RGBA_32_CHANNELS
+#undef PACK_PIXEL
+#undef READ_Y
+#undef READ_UV
+#undef YUV2RGB_32_UV
+#undef YUV2RGB_32_LINE
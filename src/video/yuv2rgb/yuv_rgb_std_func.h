@@ -11,26 +11,26 @@
 
 #define PACK_PIXEL(rgb_ptr) \
 	*(Uint16 *)rgb_ptr = \
-		((((Uint16)clampU8(y_tmp+r_tmp)) << 8 ) & 0xF800) | \
-		((((Uint16)clampU8(y_tmp+g_tmp)) << 3) & 0x07E0) | \
-		(((Uint16)clampU8(y_tmp+b_tmp)) >> 3); \
+		((((Uint16)CLAMP8(y_tmp+r_tmp)) << 8 ) & 0xF800) | \
+		((((Uint16)CLAMP8(y_tmp+g_tmp)) << 3) & 0x07E0) | \
+		(((Uint16)CLAMP8(y_tmp+b_tmp)) >> 3); \
 	rgb_ptr += 2; \
 
 #elif RGB_FORMAT == RGB_FORMAT_RGB24
 
 #define PACK_PIXEL(rgb_ptr) \
-	rgb_ptr[0] = clampU8(y_tmp+r_tmp); \
-	rgb_ptr[1] = clampU8(y_tmp+g_tmp); \
-	rgb_ptr[2] = clampU8(y_tmp+b_tmp); \
+	rgb_ptr[0] = CLAMP8(y_tmp+r_tmp); \
+	rgb_ptr[1] = CLAMP8(y_tmp+g_tmp); \
+	rgb_ptr[2] = CLAMP8(y_tmp+b_tmp); \
 	rgb_ptr += 3; \
 
 #elif RGB_FORMAT == RGB_FORMAT_RGBA
 
 #define PACK_PIXEL(rgb_ptr) \
 	*(Uint32 *)rgb_ptr = \
-		(((Uint32)clampU8(y_tmp+r_tmp)) << 24) | \
-		(((Uint32)clampU8(y_tmp+g_tmp)) << 16) | \
-		(((Uint32)clampU8(y_tmp+b_tmp)) << 8) | \
+		(((Uint32)CLAMP8(y_tmp+r_tmp)) << 24) | \
+		(((Uint32)CLAMP8(y_tmp+g_tmp)) << 16) | \
+		(((Uint32)CLAMP8(y_tmp+b_tmp)) << 8) | \
 		0x000000FF; \
 	rgb_ptr += 4; \
 
@@ -38,9 +38,9 @@
 
 #define PACK_PIXEL(rgb_ptr) \
 	*(Uint32 *)rgb_ptr = \
-		(((Uint32)clampU8(y_tmp+b_tmp)) << 24) | \
-		(((Uint32)clampU8(y_tmp+g_tmp)) << 16) | \
-		(((Uint32)clampU8(y_tmp+r_tmp)) << 8) | \
+		(((Uint32)CLAMP8(y_tmp+b_tmp)) << 24) | \
+		(((Uint32)CLAMP8(y_tmp+g_tmp)) << 16) | \
+		(((Uint32)CLAMP8(y_tmp+r_tmp)) << 8) | \
 		0x000000FF; \
 	rgb_ptr += 4; \
 
@@ -49,9 +49,9 @@
 #define PACK_PIXEL(rgb_ptr) \
 	*(Uint32 *)rgb_ptr = \
 		0xFF000000 | \
-		(((Uint32)clampU8(y_tmp+r_tmp)) << 16) | \
-		(((Uint32)clampU8(y_tmp+g_tmp)) << 8) | \
-		(((Uint32)clampU8(y_tmp+b_tmp)) << 0); \
+		(((Uint32)CLAMP8(y_tmp+r_tmp)) << 16) | \
+		(((Uint32)CLAMP8(y_tmp+g_tmp)) << 8) | \
+		(((Uint32)CLAMP8(y_tmp+b_tmp)) << 0); \
 	rgb_ptr += 4; \
 
 #elif RGB_FORMAT == RGB_FORMAT_ABGR
@@ -59,9 +59,9 @@
 #define PACK_PIXEL(rgb_ptr) \
 	*(Uint32 *)rgb_ptr = \
 		0xFF000000 | \
-		(((Uint32)clampU8(y_tmp+b_tmp)) << 16) | \
-		(((Uint32)clampU8(y_tmp+g_tmp)) << 8) | \
-		(((Uint32)clampU8(y_tmp+r_tmp)) << 0); \
+		(((Uint32)CLAMP8(y_tmp+b_tmp)) << 16) | \
+		(((Uint32)CLAMP8(y_tmp+g_tmp)) << 8) | \
+		(((Uint32)CLAMP8(y_tmp+r_tmp)) << 0); \
 	rgb_ptr += 4; \
 
 #elif RGB_FORMAT == RGB_FORMAT_XBGR2101010
@@ -94,10 +94,13 @@
 #define UV_OFFSET	(1 << ((YUV_BITS)-1))
 
 #undef GET
+#undef CLAMP8
 #if YUV_BITS == 10
 #define GET(X)	((X) >> 6)
+#define CLAMP8(X)	((uint8_t)(clamp10(X) >> 2))
 #else
 #define GET(X)	(X)
+#define CLAMP8(X)	clampU8(X)
 #endif
 
 void STD_FUNCTION_NAME(
@@ -959,6 +959,173 @@ static int SDLCALL pixels_allocFreePalette(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Brute force nearest color search, the first of equally close entries wins */
+static Uint8 referenceFindColor(const SDL_Palette *palette, Uint8 r, Uint8 g, Uint8 b, Uint8 a)
+{
+    unsigned int smallest = ~0U;
+    Uint8 index = 0;
+    int i;
+
+    for (i = 0; i < palette->ncolors; i++) {
+        const int rd = palette->colors[i].r - r;
+        const int gd = palette->colors[i].g - g;
+        const int bd = palette->colors[i].b - b;
+        const int ad = palette->colors[i].a - a;
+        const unsigned int distance = (unsigned int)(rd * rd + gd * gd + bd * bd + ad * ad);
+        if (distance < smallest) {
+            smallest = distance;
+            index = (Uint8)i;
+        }
+    }
+    return index;
+}
+
+/**
+ * Verify that mapping colors to a palette finds the nearest entry
+ *
+ * \sa SDL_MapRGBA
+ * \sa SDL_ConvertSurface
+ */
+static int SDLCALL pixels_mapPalette(void *arg)
+{
+    static const int sizes[] = { 1, 2, 3, 5, 7, 16, 63, 256 };
+    const SDL_PixelFormatDetails *details = SDL_GetPixelFormatDetails(SDL_PIXELFORMAT_INDEX8);
+    int s, i, x, y;
+
+    for (s = 0; s < SDL_arraysize(sizes); s++) {
+        const int ncolors = sizes[s];
+        SDL_Palette *palette = SDL_CreatePalette(ncolors);
+        SDL_Surface *surface, *converted;
+        int mismatches = 0;
+
+        SDLTest_AssertCheck(palette != NULL, "Verify SDL_CreatePalette(%d) succeeded", ncolors);
+        if (!palette) {
+            continue;
+        }
+        for (i = 0; i < ncolors; i++) {
+            /* Repeat some entries so ties between identical colors are exercised */
+            if (i > 0 && (i % 5) == 0) {
+                palette->colors[i] = palette->colors[i / 2];
+            } else {
+                palette->colors[i].r = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+                palette->colors[i].g = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+                palette->colors[i].b = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+                palette->colors[i].a = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            }
+        }
+
+        for (i = 0; i < 2000; i++) {
+            const Uint8 r = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            const Uint8 g = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            const Uint8 b = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            const Uint8 a = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+            if (SDL_MapRGBA(details, palette, r, g, b, a) != referenceFindColor(palette, r, g, b, a)) {
+                mismatches++;
+            }
+        }
+        /* Exact matches must map to the first matching entry */
+        for (i = 0; i < ncolors; i++) {
+            const SDL_Color *c = &palette->colors[i];
+            if (SDL_MapRGBA(details, palette, c->r, c->g, c->b, c->a) != referenceFindColor(palette, c->r, c->g, c->b, c->a)) {
+                mismatches++;
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Verify SDL_MapRGBA() with %d colors matches the nearest color, got %d mismatches", ncolors, mismatches);
+
+        /* Converting a surface goes through the cached lookup */
+        surface = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_RGBA8888);
+        SDLTest_AssertCheck(surface != NULL, "Verify SDL_CreateSurface() succeeded");
+        if (surface) {
+            for (y = 0; y < surface->h; y++) {
+                Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+                for (x = 0; x < surface->w; x++) {
+                    /* Reuse colors so that cache hits are exercised as well */
+                    row[x] = (Uint32)SDLTest_RandomIntegerInRange(0, 255) * 0x01010101u ^ (Uint32)((x * 4) << 24 | (y * 4) << 8);
+                }
+            }
+            converted = SDL_ConvertSurfaceAndColorspace(surface, SDL_PIXELFORMAT_INDEX8, palette, SDL_COLORSPACE_SRGB, 0);
+            SDLTest_AssertCheck(converted != NULL, "Verify SDL_ConvertSurfaceAndColorspace() succeeded");
+            if (converted) {
+                mismatches = 0;
+                for (y = 0; y < surface->h; y++) {
+                    const Uint32 *row = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+                    const Uint8 *out = (const Uint8 *)converted->pixels + y * converted->pitch;
+                    for (x = 0; x < surface->w; x++) {
+                        const Uint32 pixel = row[x];
+                        if (out[x] != referenceFindColor(palette, (Uint8)(pixel >> 24), (Uint8)(pixel >> 16), (Uint8)(pixel >> 8), (Uint8)pixel)) {
+                            mismatches++;
+                        }
+                    }
+                }
+                SDLTest_AssertCheck(mismatches == 0, "Verify converted pixels with %d colors match the nearest color, got %d mismatches", ncolors, mismatches);
+                SDL_DestroySurface(converted);
+            }
+            SDL_DestroySurface(surface);
+        }
+        SDL_DestroyPalette(palette);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * Verify that dithering a flat color to a palette mixes the nearest entries
+ *
+ * \sa SDL_ConvertSurface
+ */
+static int SDLCALL pixels_ditherPalette(void *arg)
+{
+    static const char *modes[] = { "none", "ordered", "floyd-steinberg" };
+    SDL_Palette *palette = SDL_CreatePalette(2);
+    SDL_Surface *surface;
+    int m, x, y;
+
+    SDLTest_AssertCheck(palette != NULL, "Verify SDL_CreatePalette() succeeded");
+    if (!palette) {
+        return TEST_ABORTED;
+    }
+    palette->colors[0].r = palette->colors[0].g = palette->colors[0].b = 0;
+    palette->colors[1].r = palette->colors[1].g = palette->colors[1].b = 255;
+    palette->colors[0].a = palette->colors[1].a = SDL_ALPHA_OPAQUE;
+
+    surface = SDL_CreateSurface(32, 32, SDL_PIXELFORMAT_XRGB8888);
+    SDLTest_AssertCheck(surface != NULL, "Verify SDL_CreateSurface() succeeded");
+    if (!surface) {
+        SDL_DestroyPalette(palette);
+        return TEST_ABORTED;
+    }
+    SDL_FillSurfaceRect(surface, NULL, SDL_MapSurfaceRGB(surface, 96, 96, 96));
+
+    for (m = 0; m < SDL_arraysize(modes); m++) {
+        SDL_Surface *converted;
+        int count = 0;
+
+        SDL_SetStringProperty(SDL_GetSurfaceProperties(surface), SDL_PROP_SURFACE_DITHER_STRING, modes[m]);
+        converted = SDL_ConvertSurfaceAndColorspace(surface, SDL_PIXELFORMAT_INDEX8, palette, SDL_COLORSPACE_SRGB, 0);
+        SDLTest_AssertCheck(converted != NULL, "Verify SDL_ConvertSurfaceAndColorspace() with %s dithering succeeded", modes[m]);
+        if (!converted) {
+            continue;
+        }
+        for (y = 0; y < converted->h; y++) {
+            const Uint8 *row = (const Uint8 *)converted->pixels + y * converted->pitch;
+            for (x = 0; x < converted->w; x++) {
+                count += row[x];
+            }
+        }
+        if (SDL_strcmp(modes[m], "none") == 0) {
+            SDLTest_AssertCheck(count == 0, "Verify undithered pixels are all black, got %d white", count);
+        } else {
+            /* 96/255 of the pixels should be white */
+            SDLTest_AssertCheck(count > 300 && count < 500, "Verify %s dithering mixes colors, got %d of 1024 white", modes[m], count);
+        }
+        SDL_DestroySurface(converted);
+    }
+
+    SDL_DestroySurface(surface);
+    SDL_DestroyPalette(palette);
+    return TEST_COMPLETED;
+}
+
 /**
  * Call to SDL_SaveBMP and SDL_LoadBMP
  *
@@ -1179,6 +1346,831 @@ static int SDLCALL pixels_saveLoadPNG(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Walk the chunks of a PNG file and check the CRC of each one, including the empty IEND chunk */
+static bool CheckPNGChunks(const Uint8 *data, size_t size, const char *label)
+{
+    static const Uint8 signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    size_t offset = sizeof(signature);
+    bool found_end = false;
+
+    if (size < sizeof(signature) || SDL_memcmp(data, signature, sizeof(signature)) != 0) {
+        SDLTest_AssertCheck(false, "Verify PNG signature with %s", label);
+        return false;
+    }
+    while (!found_end && offset + 12 <= size) {
+        const Uint8 *chunk = data + offset;
+        Uint32 length = ((Uint32)chunk[0] << 24) | ((Uint32)chunk[1] << 16) | ((Uint32)chunk[2] << 8) | chunk[3];
+        Uint32 crc, expected;
+
+        if (length > size - offset - 12) {
+            break;
+        }
+        crc = ((Uint32)chunk[8 + length] << 24) | ((Uint32)chunk[9 + length] << 16) | ((Uint32)chunk[10 + length] << 8) | chunk[11 + length];
+        expected = SDL_crc32(0, chunk + 4, 4 + length);
+        if (crc != expected) {
+            SDLTest_AssertCheck(false, "Verify CRC of %.4s chunk at offset %d with %s, expected %08" SDL_PRIx32 " got %08" SDL_PRIx32, (const char *)chunk + 4, (int)offset, label, expected, crc);
+            return false;
+        }
+        found_end = (SDL_memcmp(chunk + 4, "IEND", 4) == 0);
+        offset += 12 + length;
+    }
+    SDLTest_AssertCheck(found_end && offset == size, "Verify PNG chunks end with IEND at the end of the file with %s", label);
+    return found_end && offset == size;
+}
+
+/* Save a surface to memory as PNG, load it back and compare the pixels */
+static bool SaveLoadComparePNG(SDL_Surface *surface, const char *label)
+{
+    SDL_IOStream *stream;
+    SDL_Surface *loaded = NULL, *expected = NULL, *actual = NULL;
+    Sint64 size = 0;
+    bool result = false;
+    int y;
+
+    stream = SDL_IOFromDynamicMem();
+    if (!stream) {
+        return false;
+    }
+    if (!SDL_SavePNG_IO(surface, stream, false)) {
+        SDLTest_AssertCheck(false, "Verify SDL_SavePNG_IO() succeeded with %s: %s", label, SDL_GetError());
+        goto done;
+    }
+    size = SDL_TellIO(stream);
+    if (!CheckPNGChunks((const Uint8 *)SDL_GetPointerProperty(SDL_GetIOProperties(stream), SDL_PROP_IOSTREAM_DYNAMIC_MEMORY_POINTER, NULL), (size_t)size, label)) {
+        goto done;
+    }
+    SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+    loaded = SDL_LoadPNG_IO(stream, false);
+    if (!loaded) {
+        SDLTest_AssertCheck(false, "Verify SDL_LoadPNG_IO() succeeded with %s: %s", label, SDL_GetError());
+        goto done;
+    }
+
+    expected = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32);
+    actual = SDL_ConvertSurface(loaded, SDL_PIXELFORMAT_RGBA32);
+    if (!expected || !actual || expected->w != actual->w || expected->h != actual->h) {
+        SDLTest_AssertCheck(false, "Verify the PNG size with %s", label);
+        goto done;
+    }
+    result = true;
+    for (y = 0; y < expected->h; ++y) {
+        if (SDL_memcmp((Uint8 *)expected->pixels + y * expected->pitch, (Uint8 *)actual->pixels + y * actual->pitch, expected->w * 4) != 0) {
+            result = false;
+            break;
+        }
+    }
+    SDLTest_AssertCheck(result, "Verify PNG pixels with %s (%d bytes), first difference on row %d", label, (int)size, result ? -1 : y);
+
+done:
+    SDL_DestroySurface(actual);
+    SDL_DestroySurface(expected);
+    SDL_DestroySurface(loaded);
+    SDL_CloseIO(stream);
+    return result;
+}
+
+/**
+ * Save PNG images with different compression options and load them back
+ *
+ * \sa SDL_SavePNG_IO
+ * \sa SDL_LoadPNG_IO
+ */
+static int SDLCALL pixels_savePNGOptions(void *arg)
+{
+    static const char *filters[] = { "none", "sub", "up", "average", "paeth", "adaptive" };
+    static const char *strategies[] = { "default", "filtered", "rle", "huffman", "fixed" };
+    static const int levels[] = { 0, 1, 3, 6, 10 };
+    SDL_Surface *surface, *indexed;
+    SDL_PropertiesID props;
+    char label[128];
+    Uint32 seed = 1;
+    int i, x, y;
+
+    /* Smooth gradients with some noise, large enough to be split into blocks */
+    surface = SDL_CreateSurface(301, 257, SDL_PIXELFORMAT_RGBA32);
+    SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+    if (!surface) {
+        return TEST_ABORTED;
+    }
+    for (y = 0; y < surface->h; ++y) {
+        Uint8 *row = (Uint8 *)surface->pixels + y * surface->pitch;
+        for (x = 0; x < surface->w; ++x) {
+            seed = seed * 1103515245 + 12345;
+            row[x * 4 + 0] = (Uint8)(x + y);
+            row[x * 4 + 1] = (Uint8)(x * 3 - y);
+            row[x * 4 + 2] = (Uint8)(((x / 16) & 1) ? (seed >> 16) : 128);
+            row[x * 4 + 3] = (Uint8)(255 - y);
+        }
+    }
+    props = SDL_GetSurfaceProperties(surface);
+
+    for (i = 0; i < SDL_arraysize(filters); ++i) {
+        SDL_SetStringProperty(props, SDL_PROP_SURFACE_PNG_FILTER_STRING, filters[i]);
+        SDL_snprintf(label, sizeof(label), "filter %s", filters[i]);
+        SaveLoadComparePNG(surface, label);
+    }
+    SDL_SetStringProperty(props, SDL_PROP_SURFACE_PNG_FILTER_STRING, "paeth");
+    for (i = 0; i < SDL_arraysize(levels); ++i) {
+        SDL_SetNumberProperty(props, SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER, levels[i]);
+        SDL_snprintf(label, sizeof(label), "compression level %d", levels[i]);
+        SaveLoadComparePNG(surface, label);
+    }
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER, 6);
+    for (i = 0; i < SDL_arraysize(strategies); ++i) {
+        SDL_SetStringProperty(props, SDL_PROP_SURFACE_PNG_STRATEGY_STRING, strategies[i]);
+        SDL_snprintf(label, sizeof(label), "strategy %s", strategies[i]);
+        SaveLoadComparePNG(surface, label);
+    }
+    SDL_SetStringProperty(props, SDL_PROP_SURFACE_PNG_STRATEGY_STRING, NULL);
+
+    /* Compress independent blocks on several threads */
+    SDL_SetHint(SDL_HINT_WORKER_THREADS, "4");
+    SDL_SetBooleanProperty(props, SDL_PROP_SURFACE_PNG_PARALLEL_BOOLEAN, true);
+    for (i = 0; i < SDL_arraysize(levels); ++i) {
+        SDL_SetNumberProperty(props, SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER, levels[i]);
+        SDL_snprintf(label, sizeof(label), "parallel compression level %d", levels[i]);
+        SaveLoadComparePNG(surface, label);
+    }
+
+    /* Palette images */
+    indexed = SDL_ConvertSurface(surface, SDL_PIXELFORMAT_INDEX8);
+    SDLTest_AssertCheck(indexed != NULL, "Verify SDL_ConvertSurface() to SDL_PIXELFORMAT_INDEX8 succeeded");
+    if (indexed) {
+        props = SDL_GetSurfaceProperties(indexed);
+        SDL_SetStringProperty(props, SDL_PROP_SURFACE_PNG_FILTER_STRING, "adaptive");
+        SaveLoadComparePNG(indexed, "palette");
+        SDL_SetBooleanProperty(props, SDL_PROP_SURFACE_PNG_PARALLEL_BOOLEAN, true);
+        SaveLoadComparePNG(indexed, "parallel palette");
+        SDL_DestroySurface(indexed);
+    }
+    SDL_ResetHint(SDL_HINT_WORKER_THREADS);
+
+    SDL_DestroySurface(surface);
+    return TEST_COMPLETED;
+}
+
+/* Compare the RGBA pixels in the top left corner of two surfaces */
+static bool ComparePixels(SDL_Surface *a, SDL_Surface *b, int w, int h)
+{
+    SDL_Surface *rgba_a = SDL_ConvertSurface(a, SDL_PIXELFORMAT_RGBA32);
+    SDL_Surface *rgba_b = SDL_ConvertSurface(b, SDL_PIXELFORMAT_RGBA32);
+    bool result = (rgba_a && rgba_b);
+    int y;
+
+    for (y = 0; result && y < h; ++y) {
+        if (SDL_memcmp((Uint8 *)rgba_a->pixels + y * rgba_a->pitch, (Uint8 *)rgba_b->pixels + y * rgba_b->pitch, w * 4) != 0) {
+            result = false;
+        }
+    }
+    SDL_DestroySurface(rgba_a);
+    SDL_DestroySurface(rgba_b);
+    return result;
+}
+
+/* Check that the padding bits of a 32-bit RGB surface are all set, the way every image loader leaves them */
+static bool CheckPaddingBits(SDL_Surface *surface, int w, int h)
+{
+    const SDL_PixelFormatDetails *details = SDL_GetPixelFormatDetails(surface->format);
+    Uint32 padding;
+    int x, y;
+
+    if (!details || details->bytes_per_pixel != 4 || details->Amask) {
+        return true;
+    }
+    padding = ~(details->Rmask | details->Gmask | details->Bmask);
+    for (y = 0; y < h; ++y) {
+        const Uint32 *row = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+        for (x = 0; x < w; ++x) {
+            if ((row[x] & padding) != padding) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Load images with a target format and scale, and into existing surfaces
+ *
+ * \sa SDL_LoadSurfaceWithProperties
+ * \sa SDL_LoadIntoSurface_IO
+ */
+static int SDLCALL pixels_loadSurfaceWithProperties(void *arg)
+{
+    static const SDL_PixelFormat formats[] = {
+        SDL_PIXELFORMAT_RGBA32, SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_RGB565
+    };
+    SDL_Surface *source, *indexed, *rgb, *loaded, *expected, *dst;
+    SDL_IOStream *stream, *indexed_stream, *bmp_stream;
+    SDL_PropertiesID props;
+    SDL_Rect rect;
+    int i, x, y;
+
+    source = SDL_CreateSurface(67, 45, SDL_PIXELFORMAT_RGBA32);
+    SDLTest_AssertCheck(source != NULL, "Verify surface is not NULL");
+    if (!source) {
+        return TEST_ABORTED;
+    }
+    for (y = 0; y < source->h; ++y) {
+        Uint8 *row = (Uint8 *)source->pixels + y * source->pitch;
+        for (x = 0; x < source->w; ++x) {
+            row[x * 4 + 0] = (Uint8)(x * 3);
+            row[x * 4 + 1] = (Uint8)(y * 5);
+            row[x * 4 + 2] = (Uint8)(x ^ y);
+            row[x * 4 + 3] = (Uint8)(255 - x);
+        }
+    }
+    indexed = SDL_ConvertSurface(source, SDL_PIXELFORMAT_INDEX8);
+    SDLTest_AssertCheck(indexed != NULL, "Verify SDL_ConvertSurface() to SDL_PIXELFORMAT_INDEX8 succeeded");
+    rgb = SDL_ConvertSurface(source, SDL_PIXELFORMAT_RGB24);
+    SDLTest_AssertCheck(rgb != NULL, "Verify SDL_ConvertSurface() to SDL_PIXELFORMAT_RGB24 succeeded");
+
+    stream = SDL_IOFromDynamicMem();
+    indexed_stream = SDL_IOFromDynamicMem();
+    bmp_stream = SDL_IOFromDynamicMem();
+    props = SDL_CreateProperties();
+    if (!indexed || !rgb || !stream || !indexed_stream || !bmp_stream || !props ||
+        !SDL_SavePNG_IO(source, stream, false) || !SDL_SavePNG_IO(indexed, indexed_stream, false) || !SDL_SaveBMP_IO(rgb, bmp_stream, false)) {
+        SDLTest_AssertCheck(false, "Verify the test images were saved: %s", SDL_GetError());
+        goto done;
+    }
+
+    /* Decode straight into the requested format */
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, formats[i]);
+        SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+        loaded = SDL_LoadSurfaceWithProperties(stream, false, props);
+        expected = SDL_ConvertSurface(source, formats[i]);
+        SDLTest_AssertCheck(loaded && loaded->format == formats[i], "Verify image loaded as %s", SDL_GetPixelFormatName(formats[i]));
+        if (loaded && expected) {
+            SDLTest_AssertCheck(ComparePixels(loaded, expected, source->w, source->h), "Verify pixels loaded as %s", SDL_GetPixelFormatName(formats[i]));
+        }
+        SDL_DestroySurface(loaded);
+        SDL_DestroySurface(expected);
+
+        SDL_SeekIO(indexed_stream, 0, SDL_IO_SEEK_SET);
+        loaded = SDL_LoadSurfaceWithProperties(indexed_stream, false, props);
+        expected = SDL_ConvertSurface(indexed, formats[i]);
+        SDLTest_AssertCheck(loaded && loaded->format == formats[i], "Verify palette image loaded as %s", SDL_GetPixelFormatName(formats[i]));
+        if (loaded && expected) {
+            SDLTest_AssertCheck(ComparePixels(loaded, expected, source->w, source->h), "Verify palette pixels loaded as %s", SDL_GetPixelFormatName(formats[i]));
+        }
+        SDL_DestroySurface(loaded);
+        SDL_DestroySurface(expected);
+
+        /* 24-bit BMP images are expanded while they're read */
+        SDL_SeekIO(bmp_stream, 0, SDL_IO_SEEK_SET);
+        loaded = SDL_LoadSurfaceWithProperties(bmp_stream, false, props);
+        expected = SDL_ConvertSurface(rgb, formats[i]);
+        SDLTest_AssertCheck(loaded && loaded->format == formats[i], "Verify BMP image loaded as %s", SDL_GetPixelFormatName(formats[i]));
+        if (loaded && expected) {
+            SDLTest_AssertCheck(ComparePixels(loaded, expected, source->w, source->h), "Verify BMP pixels loaded as %s", SDL_GetPixelFormatName(formats[i]));
+        }
+        SDL_DestroySurface(loaded);
+        SDL_DestroySurface(expected);
+    }
+
+    /* Every loader sets the padding bits of 32-bit RGB formats, with and without a conversion */
+    for (i = 0; i < 3; ++i) {
+        static const char *names[] = { "PNG", "palette PNG", "BMP" };
+        SDL_IOStream *streams[3];
+        int scale;
+
+        streams[0] = stream;
+        streams[1] = indexed_stream;
+        streams[2] = bmp_stream;
+        for (scale = 1; scale <= 2; ++scale) {
+            SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_XBGR8888);
+            SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, scale);
+            SDL_SeekIO(streams[i], 0, SDL_IO_SEEK_SET);
+            loaded = SDL_LoadSurfaceWithProperties(streams[i], false, props);
+            SDLTest_AssertCheck(loaded && CheckPaddingBits(loaded, loaded->w, loaded->h), "Verify padding bits of %s image loaded at 1/%d", names[i], scale);
+            SDL_DestroySurface(loaded);
+
+            dst = SDL_CreateSurface(source->w, source->h, SDL_PIXELFORMAT_XRGB8888);
+            if (dst) {
+                SDL_FillSurfaceRect(dst, NULL, 0);
+                SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_UNKNOWN);
+                SDL_SeekIO(streams[i], 0, SDL_IO_SEEK_SET);
+                SDL_zero(rect);
+                SDLTest_AssertCheck(SDL_LoadIntoSurface_IO(streams[i], false, dst, props, &rect) && CheckPaddingBits(dst, rect.w, rect.h),
+                                    "Verify padding bits of %s image loaded into a surface at 1/%d", names[i], scale);
+                SDL_DestroySurface(dst);
+            }
+        }
+    }
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, 1);
+
+    /* Scaled loads round the size up */
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_UNKNOWN);
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, 4);
+    SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+    loaded = SDL_LoadSurfaceWithProperties(stream, false, props);
+    SDLTest_AssertCheck(loaded && loaded->w == 17 && loaded->h == 12, "Verify scaled image is 17x12, got %dx%d", loaded ? loaded->w : 0, loaded ? loaded->h : 0);
+    SDL_DestroySurface(loaded);
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, 3);
+    SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+    loaded = SDL_LoadSurfaceWithProperties(stream, false, props);
+    SDLTest_AssertCheck(loaded == NULL, "Verify scale 3 is rejected");
+    SDL_DestroySurface(loaded);
+
+    /* Load into surfaces smaller and larger than the image */
+    for (i = 0; i < 2; ++i) {
+        int w = i ? source->w / 2 : source->w + 10;
+        int h = i ? source->h / 2 : source->h + 10;
+
+        dst = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_XRGB8888);
+        expected = SDL_ConvertSurface(source, SDL_PIXELFORMAT_XRGB8888);
+        if (!dst || !expected) {
+            SDLTest_AssertCheck(false, "Verify surfaces were created");
+            SDL_DestroySurface(dst);
+            SDL_DestroySurface(expected);
+            continue;
+        }
+        SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+        SDL_zero(rect);
+        SDLTest_AssertCheck(SDL_LoadIntoSurface_IO(stream, false, dst, 0, &rect), "Verify SDL_LoadIntoSurface_IO() into %dx%d succeeded", w, h);
+        SDLTest_AssertCheck(rect.x == 0 && rect.y == 0 && rect.w == SDL_min(w, source->w) && rect.h == SDL_min(h, source->h),
+                            "Verify loaded rect is %d,%d %dx%d", rect.x, rect.y, rect.w, rect.h);
+        SDLTest_AssertCheck(ComparePixels(dst, expected, rect.w, rect.h), "Verify pixels loaded into %dx%d", w, h);
+        SDL_DestroySurface(dst);
+        SDL_DestroySurface(expected);
+    }
+
+done:
+    SDL_DestroyProperties(props);
+    SDL_CloseIO(bmp_stream);
+    SDL_CloseIO(indexed_stream);
+    SDL_CloseIO(stream);
+    SDL_DestroySurface(rgb);
+    SDL_DestroySurface(indexed);
+    SDL_DestroySurface(source);
+    return TEST_COMPLETED;
+}
+
+/* 61x45 4:2:0 images of a gradient with a soft blue spot. Both have the same coefficients,
+   coded as a baseline image and as a progressive image with a DC scan and four AC scans */
+#define JPEG_TEST_WIDTH  61
+#define JPEG_TEST_HEIGHT 45
+
+static const Uint8 jpeg_baseline[] = {
+    0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x84, 0x00, 0x05, 0x03, 0x04, 0x04, 0x04, 0x03, 0x05,
+    0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x06, 0x07, 0x0C, 0x08, 0x07, 0x07, 0x07, 0x07, 0x0F, 0x0B,
+    0x0B, 0x09, 0x0C, 0x11, 0x0F, 0x12, 0x12, 0x11, 0x0F, 0x11, 0x11, 0x13, 0x16, 0x1C, 0x17, 0x13,
+    0x14, 0x1A, 0x15, 0x11, 0x11, 0x18, 0x21, 0x18, 0x1A, 0x1D, 0x1D, 0x1F, 0x1F, 0x1F, 0x13, 0x17,
+    0x22, 0x24, 0x22, 0x1E, 0x24, 0x1C, 0x1E, 0x1F, 0x1E, 0x01, 0x05, 0x05, 0x05, 0x07, 0x06, 0x07,
+    0x0E, 0x08, 0x08, 0x0E, 0x1E, 0x14, 0x11, 0x14, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0xFF, 0xC0, 0x00, 0x11, 0x08, 0x00,
+    0x2D, 0x00, 0x3D, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF, 0xC4, 0x00,
+    0x1F, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4,
+    0x00, 0x1F, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF,
+    0xC4, 0x00, 0xB5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04,
+    0x00, 0x00, 0x01, 0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06,
+    0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1,
+    0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A,
+    0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45,
+    0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65,
+    0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85,
+    0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3,
+    0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA,
+    0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8,
+    0xD9, 0xDA, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4,
+    0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xC4, 0x00, 0xB5, 0x11, 0x00, 0x02, 0x01, 0x02, 0x04,
+    0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11,
+    0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08,
+    0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15, 0x62, 0x72, 0xD1, 0x0A,
+    0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x35,
+    0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55,
+    0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75,
+    0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93,
+    0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA,
+    0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8,
+    0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6,
+    0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xDA, 0x00,
+    0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x3F, 0x00, 0xF2, 0xB8, 0xAD, 0x3D, 0xAA,
+    0xDC, 0x56, 0x9E, 0xD5, 0xA7, 0x15, 0xA7, 0xB5, 0x5A, 0x8E, 0xD7, 0xDA, 0xBF, 0x63, 0xAB, 0x8B,
+    0xB2, 0x3C, 0x2C, 0x26, 0x30, 0xCD, 0x8A, 0xD7, 0xDA, 0xAD, 0x45, 0x6D, 0xED, 0x5A, 0x09, 0x6D,
+    0x8E, 0xD5, 0x3C, 0x70, 0x7B, 0x57, 0x81, 0x8B, 0xCE, 0x23, 0x4D, 0xEA, 0xCF, 0xA9, 0xC1, 0xE2,
+    0xAE, 0x54, 0x86, 0xDB, 0xDA, 0xAE, 0xC3, 0x6B, 0xED, 0x56, 0xAD, 0xE0, 0xCF, 0x6A, 0xD1, 0xB7,
+    0xB6, 0xF6, 0xAE, 0x6A, 0x79, 0xAC, 0x6A, 0xEC, 0xCF, 0xA6, 0xC2, 0xE2, 0xAC, 0x50, 0x86, 0xD3,
+    0xDA, 0xAD, 0x25, 0xA7, 0x1D, 0x2B, 0x4E, 0x1B, 0x5F, 0x6A, 0xB6, 0x96, 0x9C, 0x74, 0xAB, 0x9E,
+    0x2A, 0xE7, 0xD1, 0xE1, 0x71, 0x9A, 0x1C, 0x74, 0x56, 0x9E, 0xD5, 0x65, 0x2D, 0x7D, 0xAB, 0x56,
+    0x2B, 0x4F, 0x6A, 0xB5, 0x1D, 0xA7, 0xB5, 0x18, 0x9C, 0x4E, 0x87, 0xF3, 0x16, 0x0F, 0x18, 0x62,
+    0x7D, 0x97, 0xDA, 0x9E, 0x96, 0xC7, 0x3D, 0x2B, 0x74, 0x59, 0xE7, 0xB5, 0x3D, 0x2C, 0x79, 0xE9,
+    0x5F, 0x9E, 0x67, 0x15, 0x6A, 0xB9, 0x68, 0x7D, 0x7E, 0x07, 0x1A, 0x8C, 0xDB, 0x5B, 0x63, 0xC7,
+    0x15, 0xAB, 0x6B, 0x6B, 0xD3, 0x8A, 0xB7, 0x6D, 0x63, 0xD3, 0x8A, 0xD4, 0xB6, 0xB3, 0xE9, 0xC5,
+    0x19, 0x65, 0x6A, 0x91, 0xF8, 0x8F, 0xA5, 0xA1, 0x8D, 0x45, 0x18, 0x2D, 0x3D, 0xAA, 0xDA, 0x5A,
+    0x71, 0xD2, 0xB4, 0xE1, 0xB4, 0xF6, 0xAB, 0x69, 0x69, 0xC7, 0x4A, 0xF7, 0xDE, 0x27, 0x43, 0xDE,
+    0xC3, 0x63, 0x34, 0x38, 0xE8, 0xAD, 0x3D, 0xAA, 0xDC, 0x56, 0x9E, 0xD5, 0xA1, 0x14, 0x29, 0x57,
+    0x22, 0x85, 0x2B, 0x7A, 0xB8, 0x8B, 0x9F, 0xCC, 0x78, 0x4C, 0x5B, 0x33, 0x23, 0xB3, 0xF6, 0xAB,
+    0x11, 0x58, 0xFB, 0x56, 0xB4, 0x50, 0x25, 0x5B, 0x8A, 0x04, 0xAF, 0x1B, 0x10, 0xA3, 0x37, 0xA9,
+    0xF5, 0x18, 0x3C, 0x63, 0x32, 0xE0, 0xB2, 0xF6, 0xAB, 0xF0, 0x59, 0xFB, 0x56, 0x84, 0x30, 0x25,
+    0x5C, 0x86, 0x04, 0xAE, 0x54, 0xD4, 0x36, 0x3E, 0x9B, 0x0B, 0x8C, 0x6C, 0xA1, 0x0D, 0xA7, 0xB5,
+    0x5A, 0x4B, 0x4E, 0x3A, 0x56, 0x8C, 0x50, 0xA5, 0x5B, 0x48, 0x53, 0x15, 0x13, 0xC4, 0x33, 0xE9,
+    0x30, 0xB8, 0xB7, 0x63, 0xFF, 0xD9
+};
+
+static const Uint8 jpeg_progressive[] = {
+    0xFF, 0xD8, 0xFF, 0xE0, 0x00, 0x10, 0x4A, 0x46, 0x49, 0x46, 0x00, 0x01, 0x01, 0x00, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0xFF, 0xDB, 0x00, 0x84, 0x00, 0x05, 0x03, 0x04, 0x04, 0x04, 0x03, 0x05,
+    0x04, 0x04, 0x04, 0x05, 0x05, 0x05, 0x06, 0x07, 0x0C, 0x08, 0x07, 0x07, 0x07, 0x07, 0x0F, 0x0B,
+    0x0B, 0x09, 0x0C, 0x11, 0x0F, 0x12, 0x12, 0x11, 0x0F, 0x11, 0x11, 0x13, 0x16, 0x1C, 0x17, 0x13,
+    0x14, 0x1A, 0x15, 0x11, 0x11, 0x18, 0x21, 0x18, 0x1A, 0x1D, 0x1D, 0x1F, 0x1F, 0x1F, 0x13, 0x17,
+    0x22, 0x24, 0x22, 0x1E, 0x24, 0x1C, 0x1E, 0x1F, 0x1E, 0x01, 0x05, 0x05, 0x05, 0x07, 0x06, 0x07,
+    0x0E, 0x08, 0x08, 0x0E, 0x1E, 0x14, 0x11, 0x14, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E,
+    0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0x1E, 0xFF, 0xC2, 0x00, 0x11, 0x08, 0x00,
+    0x2D, 0x00, 0x3D, 0x03, 0x01, 0x22, 0x00, 0x02, 0x11, 0x01, 0x03, 0x11, 0x01, 0xFF, 0xC4, 0x00,
+    0x1F, 0x00, 0x00, 0x01, 0x05, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF, 0xC4,
+    0x00, 0x1F, 0x01, 0x00, 0x03, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0xFF,
+    0xC4, 0x00, 0xB5, 0x10, 0x00, 0x02, 0x01, 0x03, 0x03, 0x02, 0x04, 0x03, 0x05, 0x05, 0x04, 0x04,
+    0x00, 0x00, 0x01, 0x7D, 0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06,
+    0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08, 0x23, 0x42, 0xB1, 0xC1,
+    0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A,
+    0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45,
+    0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65,
+    0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85,
+    0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3,
+    0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA,
+    0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8,
+    0xD9, 0xDA, 0xE1, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4,
+    0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xC4, 0x00, 0xB5, 0x11, 0x00, 0x02, 0x01, 0x02, 0x04,
+    0x04, 0x03, 0x04, 0x07, 0x05, 0x04, 0x04, 0x00, 0x01, 0x02, 0x77, 0x00, 0x01, 0x02, 0x03, 0x11,
+    0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08,
+    0x14, 0x42, 0x91, 0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15, 0x62, 0x72, 0xD1, 0x0A,
+    0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x35,
+    0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55,
+    0x56, 0x57, 0x58, 0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75,
+    0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89, 0x8A, 0x92, 0x93,
+    0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA,
+    0xB2, 0xB3, 0xB4, 0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8,
+    0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE2, 0xE3, 0xE4, 0xE5, 0xE6,
+    0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA, 0xFF, 0xDA, 0x00,
+    0x0C, 0x03, 0x01, 0x00, 0x02, 0x11, 0x03, 0x11, 0x00, 0x00, 0x00, 0xF2, 0xBB, 0x7A, 0x76, 0xBF,
+    0x63, 0xF0, 0xB3, 0x6D, 0x68, 0x4F, 0xE0, 0x7D, 0x4D, 0x4B, 0xB6, 0xB4, 0x79, 0xBE, 0x9A, 0x85,
+    0xAD, 0x3B, 0x77, 0xF4, 0x7C, 0x75, 0x9D, 0x5B, 0x47, 0xF3, 0x16, 0x23, 0xF7, 0x5F, 0xF9, 0xE7,
+    0xD7, 0xE6, 0xEA, 0xDB, 0xD4, 0x3E, 0x96, 0x8D, 0xBD, 0x3B, 0x7E, 0xFF, 0x00, 0xBD, 0xC7, 0x5B,
+    0xD0, 0xB9, 0xBF, 0xF3, 0x1E, 0x65, 0x8D, 0x6B, 0x7E, 0x37, 0xD4, 0x65, 0xDF, 0xD0, 0xB9, 0xCB,
+    0xF4, 0xD4, 0x2D, 0x68, 0xDB, 0x8F, 0xA4, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x01, 0x05,
+    0x00, 0x8A, 0xD2, 0xA2, 0xB4, 0xA8, 0xAD, 0x6A, 0x2B, 0x6A, 0x86, 0xDA, 0xA1, 0xB5, 0xA8, 0x6D,
+    0x29, 0x2D, 0x38, 0x8A, 0xD2, 0xA3, 0xB5, 0xA4, 0xB6, 0xC5, 0x47, 0x05, 0x5B, 0xC1, 0x9A, 0xB7,
+    0xB6, 0xA8, 0x6D, 0x69, 0x2D, 0x38, 0x8A, 0xD2, 0x92, 0xD6, 0xBE, 0xCB, 0x49, 0x6C, 0x73, 0x6B,
+    0x6C, 0x6A, 0xD6, 0xD6, 0xA0, 0xB4, 0xA4, 0xB4, 0xE2, 0x2B, 0x4A, 0x8E, 0xD2, 0x85, 0x9E, 0x69,
+    0x2C, 0x79, 0xB6, 0xB1, 0xAB, 0x6B, 0x3A, 0x86, 0xD2, 0x92, 0xD3, 0x88, 0xAD, 0x2A, 0x2B, 0x4A,
+    0x8E, 0xCE, 0xA2, 0xB1, 0xA8, 0x2C, 0xAA, 0x0B, 0x3A, 0x86, 0xD2, 0x92, 0xD3, 0x88, 0xA1, 0x4A,
+    0x8A, 0x14, 0xA8, 0xA0, 0x4A, 0x8A, 0x04, 0xA8, 0x60, 0x4A, 0x86, 0x04, 0xA8, 0xA1, 0x4A, 0x48,
+    0x53, 0x1F, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x02, 0x11, 0x01, 0x3F, 0x00, 0xAB, 0x8B, 0xB2, 0x31,
+    0x79, 0xC4, 0x69, 0xBD, 0x59, 0x4F, 0x35, 0x8D, 0x5D, 0x99, 0x3C, 0x55, 0xCC, 0x4E, 0x27, 0x43,
+    0x38, 0xAB, 0x55, 0xCB, 0x43, 0x2C, 0xAD, 0x52, 0x3F, 0x10, 0xF1, 0x3A, 0x15, 0x71, 0x17, 0x31,
+    0x0A, 0x33, 0x7A, 0x89, 0xA8, 0x6C, 0x4F, 0x10, 0xCF, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x03, 0x11,
+    0x01, 0x3F, 0x00, 0xC2, 0x63, 0x0C, 0x1E, 0x2A, 0xE6, 0x17, 0x15, 0x63, 0x0B, 0x8C, 0xD0, 0xC1,
+    0xE3, 0x0C, 0x0E, 0x35, 0x14, 0x31, 0xA8, 0xC3, 0x63, 0x34, 0x30, 0x98, 0xB6, 0x60, 0xF1, 0x8C,
+    0xC2, 0xE3, 0x1B, 0x30, 0xB8, 0xB7, 0x63, 0xFF, 0xDA, 0x00, 0x08, 0x01, 0x01, 0x00, 0x06, 0x3F,
+    0x00, 0xE9, 0x5D, 0x2B, 0xA5, 0x74, 0xAE, 0x95, 0xD2, 0xBA, 0x57, 0x4A, 0xE9, 0x5D, 0x2B, 0xA5,
+    0x74, 0xAE, 0x95, 0xD2, 0xBA, 0x57, 0x4A, 0xE9, 0x5D, 0x2B, 0xA5, 0x74, 0xA1, 0xC5, 0x0E, 0x2B,
+    0xA5, 0x74, 0xAE, 0x95, 0xD2, 0xBA, 0x57, 0x4A, 0x1C, 0x50, 0xE2, 0xBA, 0x57, 0x4A, 0xE9, 0x5D,
+    0x2B, 0xA5, 0x74, 0xAE, 0x95, 0xD2, 0xBA, 0x57, 0x4A, 0xAA, 0xAA, 0xAA, 0xAA, 0xFF, 0xD9
+};
+
+static void GetJPEGTestPixel(int x, int y, Uint8 *rgb)
+{
+    const double dx = x - 30, dy = y - 22;
+
+    rgb[0] = (Uint8)SDL_min(40 + 3 * x, 255);
+    rgb[1] = (Uint8)SDL_min(50 + 4 * y, 255);
+    rgb[2] = (Uint8)(200 - (int)(120 * SDL_exp(-(dx * dx + dy * dy) / 150.0)));
+}
+
+static SDL_Surface *LoadJPEG(const Uint8 *data, size_t size, int scale)
+{
+    SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_Surface *surface;
+
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_RGBA32);
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, scale);
+    surface = SDL_LoadSurfaceWithProperties(SDL_IOFromConstMem(data, size), true, props);
+    SDL_DestroyProperties(props);
+    return surface;
+}
+
+/**
+ * Load baseline and progressive JPEG images at every scale, and straight into existing surfaces
+ *
+ * \sa SDL_LoadSurfaceWithProperties
+ * \sa SDL_LoadIntoSurface_IO
+ */
+static int SDLCALL pixels_loadJPEG(void *arg)
+{
+    static const struct
+    {
+        const char *name;
+        const Uint8 *data;
+        size_t size;
+    } images[] = {
+        { "baseline", jpeg_baseline, sizeof(jpeg_baseline) },
+        { "progressive", jpeg_progressive, sizeof(jpeg_progressive) }
+    };
+    /* Reduced size transforms aren't a box filter, so allow some difference from a downscaled full size image */
+    static const struct
+    {
+        int scale;
+        double mean_error;
+        int max_error;
+    } scales[] = {
+        { 1, 0.0, 0 }, { 2, 2.0, 12 }, { 4, 3.0, 24 }, { 8, 8.0, 48 }
+    };
+    SDL_Surface *full[SDL_arraysize(images)];
+    int i, j, x, y, c;
+
+    SDL_zeroa(full);
+
+    /* Full size images match the source pixels, and each other */
+    for (i = 0; i < SDL_arraysize(images); ++i) {
+        int max_error = 0;
+
+        full[i] = LoadJPEG(images[i].data, images[i].size, 1);
+        SDLTest_AssertCheck(full[i] && full[i]->w == JPEG_TEST_WIDTH && full[i]->h == JPEG_TEST_HEIGHT,
+                            "Verify %s JPEG loaded at %dx%d: %s", images[i].name, JPEG_TEST_WIDTH, JPEG_TEST_HEIGHT, full[i] ? "" : SDL_GetError());
+        if (!full[i]) {
+            goto done;
+        }
+        for (y = 0; y < JPEG_TEST_HEIGHT; ++y) {
+            const Uint8 *row = (const Uint8 *)full[i]->pixels + y * full[i]->pitch;
+            for (x = 0; x < JPEG_TEST_WIDTH; ++x) {
+                Uint8 rgb[3];
+
+                GetJPEGTestPixel(x, y, rgb);
+                for (c = 0; c < 3; ++c) {
+                    max_error = SDL_max(max_error, SDL_abs(row[x * 4 + c] - rgb[c]));
+                }
+            }
+        }
+        SDLTest_AssertCheck(max_error <= 16, "Verify %s JPEG pixels are close to the source, expected difference <= 16, got %d", images[i].name, max_error);
+    }
+
+    for (j = 0; j < SDL_arraysize(scales); ++j) {
+        const int scale = scales[j].scale;
+        const int w = (JPEG_TEST_WIDTH + scale - 1) / scale;
+        const int h = (JPEG_TEST_HEIGHT + scale - 1) / scale;
+        SDL_Surface *scaled[SDL_arraysize(images)];
+
+        SDL_zeroa(scaled);
+        for (i = 0; i < SDL_arraysize(images); ++i) {
+            SDL_Surface *dst;
+            SDL_PropertiesID props;
+            SDL_Rect rect;
+            double total_error = 0.0;
+            int max_error = 0;
+
+            scaled[i] = LoadJPEG(images[i].data, images[i].size, scale);
+            SDLTest_AssertCheck(scaled[i] && scaled[i]->w == w && scaled[i]->h == h,
+                                "Verify %s JPEG loaded at 1/%d is %dx%d, got %dx%d", images[i].name, scale, w, h, scaled[i] ? scaled[i]->w : 0, scaled[i] ? scaled[i]->h : 0);
+            if (!scaled[i] || scaled[i]->w != w || scaled[i]->h != h) {
+                continue;
+            }
+
+            /* Compare with the full size image, averaged over each block of pixels */
+            for (y = 0; y < h; ++y) {
+                const Uint8 *row = (const Uint8 *)scaled[i]->pixels + y * scaled[i]->pitch;
+                for (x = 0; x < w; ++x) {
+                    for (c = 0; c < 3; ++c) {
+                        int sum = 0, count = 0, fx, fy, error;
+
+                        for (fy = y * scale; fy < SDL_min((y + 1) * scale, JPEG_TEST_HEIGHT); ++fy) {
+                            for (fx = x * scale; fx < SDL_min((x + 1) * scale, JPEG_TEST_WIDTH); ++fx) {
+                                sum += ((const Uint8 *)full[i]->pixels)[fy * full[i]->pitch + fx * 4 + c];
+                                ++count;
+                            }
+                        }
+                        error = SDL_abs((sum + count / 2) / count - row[x * 4 + c]);
+                        total_error += error;
+                        max_error = SDL_max(max_error, error);
+                    }
+                }
+            }
+            total_error /= (double)w * h * 3;
+            SDLTest_AssertCheck(total_error <= scales[j].mean_error && max_error <= scales[j].max_error,
+                                "Verify %s JPEG loaded at 1/%d matches the downscaled image, expected mean difference <= %.1f and max <= %d, got %.2f and %d",
+                                images[i].name, scale, scales[j].mean_error, scales[j].max_error, total_error, max_error);
+
+            /* Decode straight into part of a bigger surface */
+            dst = SDL_CreateSurface(w + 5, h + 3, SDL_PIXELFORMAT_XRGB8888);
+            props = SDL_CreateProperties();
+            if (!dst || !props) {
+                SDL_DestroySurface(dst);
+                SDL_DestroyProperties(props);
+                continue;
+            }
+            SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_SCALE_NUMBER, scale);
+            SDL_zero(rect);
+            SDLTest_AssertCheck(SDL_LoadIntoSurface_IO(SDL_IOFromConstMem(images[i].data, images[i].size), true, dst, props, &rect),
+                                "Verify SDL_LoadIntoSurface_IO() succeeded with %s JPEG at 1/%d", images[i].name, scale);
+            SDLTest_AssertCheck(rect.x == 0 && rect.y == 0 && rect.w == w && rect.h == h,
+                                "Verify loaded rect is 0,0 %dx%d, got %d,%d %dx%d", w, h, rect.x, rect.y, rect.w, rect.h);
+            SDLTest_AssertCheck(ComparePixels(dst, scaled[i], w, h), "Verify pixels of %s JPEG loaded into a surface at 1/%d", images[i].name, scale);
+            SDLTest_AssertCheck(CheckPaddingBits(dst, w, h), "Verify padding bits of %s JPEG loaded into a surface at 1/%d", images[i].name, scale);
+            SDL_DestroyProperties(props);
+            SDL_DestroySurface(dst);
+        }
+
+        /* The progressive image has the same coefficients, so it decodes to the same pixels at every scale */
+        if (scaled[0] && scaled[1]) {
+            SDLTest_AssertCheck(ComparePixels(scaled[0], scaled[1], w, h), "Verify baseline and progressive JPEG pixels match at 1/%d", scale);
+        }
+        for (i = 0; i < SDL_arraysize(images); ++i) {
+            SDL_DestroySurface(scaled[i]);
+        }
+    }
+
+done:
+    for (i = 0; i < SDL_arraysize(images); ++i) {
+        SDL_DestroySurface(full[i]);
+    }
+    return TEST_COMPLETED;
+}
+
+/**
+ * Save and load BMP images with padded rows, and decode RLE4 images
+ *
+ * \sa SDL_SaveBMP_IO
+ * \sa SDL_LoadBMP_IO
+ * \sa SDL_LoadSurfaceWithProperties
+ */
+static int SDLCALL pixels_saveLoadBMPRows(void *arg)
+{
+    static const SDL_PixelFormat formats[] = {
+        SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_BGR24, SDL_PIXELFORMAT_XBGR8888
+    };
+    /* A 5x2 RLE4 image: a run, an absolute run with an odd pixel count, and a run clipped to the row */
+    static const Uint8 rle4[] = {
+        'B', 'M', 0x54, 0, 0, 0, 0, 0, 0, 0, 0x46, 0, 0, 0,
+        40, 0, 0, 0, 5, 0, 0, 0, 2, 0, 0, 0, 1, 0, 4, 0, 2, 0, 0, 0, 20, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0xFF, 0xFF, 0xFF, 0, 0x00, 0x00, 0xFF, 0, 0x00, 0xFF, 0x00, 0,
+        2, 0x12, 0, 3, 0x32, 0x10, 0, 0,
+        9, 0x23, 0, 0, 0, 1
+    };
+    static const Uint8 rle4_expected[2][3] = {
+        { 0x23, 0x23, 0x20 }, { 0x12, 0x32, 0x10 }
+    };
+    SDL_Surface *source, *loaded, *expected;
+    SDL_IOStream *stream;
+    SDL_PropertiesID props;
+    int i, x, y;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        source = SDL_CreateSurface(333, 77, formats[i]);
+        SDLTest_AssertCheck(source != NULL, "Verify surface is not NULL");
+        if (!source) {
+            return TEST_ABORTED;
+        }
+        for (y = 0; y < source->h; ++y) {
+            for (x = 0; x < source->w; ++x) {
+                SDL_WriteSurfacePixel(source, x, y, (Uint8)(x * 7), (Uint8)(y * 3), (Uint8)(x ^ y), 255);
+            }
+        }
+
+        stream = SDL_IOFromDynamicMem();
+        SDLTest_AssertCheck(SDL_SaveBMP_IO(source, stream, false), "Verify SDL_SaveBMP_IO() of %s succeeded", SDL_GetPixelFormatName(formats[i]));
+        SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+        loaded = SDL_LoadBMP_IO(stream, false);
+        SDLTest_AssertCheck(loaded && ComparePixels(loaded, source, source->w, source->h), "Verify %s pixels survive a round trip", SDL_GetPixelFormatName(formats[i]));
+        SDL_DestroySurface(loaded);
+
+        /* 24-bit images are expanded as they're read when a 32-bit format is requested */
+        props = SDL_CreateProperties();
+        SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_XBGR8888);
+        SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+        loaded = SDL_LoadSurfaceWithProperties(stream, false, props);
+        expected = SDL_ConvertSurface(source, SDL_PIXELFORMAT_XBGR8888);
+        SDLTest_AssertCheck(loaded && loaded->format == SDL_PIXELFORMAT_XBGR8888, "Verify image loaded as SDL_PIXELFORMAT_XBGR8888");
+        SDLTest_AssertCheck(loaded && expected && ComparePixels(loaded, expected, source->w, source->h), "Verify loaded pixels match SDL_ConvertSurface()");
+        SDL_DestroySurface(expected);
+        SDL_DestroySurface(loaded);
+        SDL_DestroyProperties(props);
+        SDL_CloseIO(stream);
+        SDL_DestroySurface(source);
+    }
+
+    loaded = SDL_LoadBMP_IO(SDL_IOFromConstMem(rle4, sizeof(rle4)), true);
+    SDLTest_AssertCheck(loaded != NULL, "Verify RLE4 image loaded: %s", loaded ? "" : SDL_GetError());
+    if (loaded) {
+        SDLTest_AssertCheck(loaded->format == SDL_PIXELFORMAT_INDEX4MSB, "Verify RLE4 surface format, expected %s, got %s", SDL_GetPixelFormatName(SDL_PIXELFORMAT_INDEX4MSB), SDL_GetPixelFormatName(loaded->format));
+        for (y = 0; y < 2; ++y) {
+            const Uint8 *row = (const Uint8 *)loaded->pixels + y * loaded->pitch;
+            SDLTest_AssertCheck(SDL_memcmp(row, rle4_expected[y], 3) == 0, "Verify RLE4 row %d, expected %02x %02x %02x, got %02x %02x %02x", y,
+                                rle4_expected[y][0], rle4_expected[y][1], rle4_expected[y][2], row[0], row[1], row[2]);
+        }
+        SDL_DestroySurface(loaded);
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * Load a batch of images in the background
+ *
+ * \sa SDL_CreateSurfaceLoader
+ * \sa SDL_LoadSurfaceAsync
+ * \sa SDL_WaitSurfaceLoaderResult
+ */
+static int SDLCALL pixels_surfaceLoader(void *arg)
+{
+    static const char *files[] = { "loader0.bmp", "loader1.png", "loader2.bmp", "loader3.png", "loader_invalid.png" };
+    const int num_images = SDL_arraysize(files) - 1;
+    SDL_SurfaceLoader *loader;
+    SDL_SurfaceLoaderOutcome outcome;
+    SDL_PropertiesID props;
+    bool seen[SDL_arraysize(files)];
+    int i, num_outcomes = 0;
+
+    /* Write a set of images with a different size each */
+    for (i = 0; i < num_images; ++i) {
+        SDL_Surface *surface = SDL_CreateSurface(10 + i, 20 + i, SDL_PIXELFORMAT_RGB24);
+        bool result = false;
+
+        if (surface) {
+            SDL_FillSurfaceRect(surface, NULL, SDL_MapSurfaceRGB(surface, (Uint8)(i * 50), 128, 255));
+            if (SDL_strstr(files[i], ".bmp")) {
+                result = SDL_SaveBMP(surface, files[i]);
+            } else {
+                result = SDL_SavePNG(surface, files[i]);
+            }
+            SDL_DestroySurface(surface);
+        }
+        SDLTest_AssertCheck(result, "Verify %s was saved", files[i]);
+    }
+    SDLTest_AssertCheck(SDL_SaveFile(files[num_images], "not an image", 12), "Verify %s was saved", files[num_images]);
+
+    props = SDL_CreateProperties();
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, SDL_PIXELFORMAT_XRGB8888);
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOADER_THREADS_NUMBER, 2);
+    loader = SDL_CreateSurfaceLoader(props);
+    SDL_DestroyProperties(props);
+    SDLTest_AssertCheck(loader != NULL, "Verify SDL_CreateSurfaceLoader() succeeded");
+    if (!loader) {
+        goto done;
+    }
+
+    SDLTest_AssertCheck(!SDL_WaitSurfaceLoaderResult(loader, &outcome, -1), "Verify an idle loader doesn't block");
+
+    SDL_ClearError();
+    SDLTest_AssertCheck(!SDL_GetSurfaceLoaderResult(NULL, &outcome) && *SDL_GetError(), "Verify SDL_GetSurfaceLoaderResult() fails with an error without a loader");
+    SDL_ClearError();
+    SDLTest_AssertCheck(!SDL_WaitSurfaceLoaderResult(loader, NULL, 0) && *SDL_GetError(), "Verify SDL_WaitSurfaceLoaderResult() fails with an error without an outcome");
+
+    SDLTest_AssertCheck(!SDL_LoadSurfaceAsync(loader, "loader_missing.png", NULL), "Verify loading a missing file fails right away");
+
+    SDL_zeroa(seen);
+    for (i = 0; i < SDL_arraysize(files); ++i) {
+        SDL_LoadSurfaceAsync(loader, files[i], (void *)(intptr_t)i);
+    }
+    while (SDL_WaitSurfaceLoaderResult(loader, &outcome, -1)) {
+        i = (int)(intptr_t)outcome.userdata;
+        ++num_outcomes;
+        if (i < 0 || i >= SDL_arraysize(files) || seen[i]) {
+            SDLTest_AssertCheck(false, "Verify outcome userdata is valid, got %d", i);
+            SDL_DestroySurface(outcome.surface);
+            continue;
+        }
+        seen[i] = true;
+        if (i < num_images) {
+            SDLTest_AssertCheck(outcome.surface != NULL, "Verify %s loaded: %s", files[i], outcome.surface ? "" : SDL_GetError());
+            if (outcome.surface) {
+                const Uint32 pixel = *(const Uint32 *)outcome.surface->pixels;
+                SDLTest_AssertCheck(outcome.surface->format == SDL_PIXELFORMAT_XRGB8888, "Verify %s format, got %s", files[i], SDL_GetPixelFormatName(outcome.surface->format));
+                SDLTest_AssertCheck(outcome.surface->w == 10 + i && outcome.surface->h == 20 + i, "Verify %s size, got %dx%d", files[i], outcome.surface->w, outcome.surface->h);
+                SDLTest_AssertCheck((pixel & 0x00FFFFFF) == (Uint32)((i * 50) << 16 | 128 << 8 | 255), "Verify %s pixels, got 0x%.8" SDL_PRIx32, files[i], pixel);
+            }
+        } else {
+            SDLTest_AssertCheck(outcome.surface == NULL, "Verify %s failed to load", files[i]);
+        }
+        SDL_DestroySurface(outcome.surface);
+    }
+    SDLTest_AssertCheck(num_outcomes == SDL_arraysize(files), "Verify every load completed, got %d", num_outcomes);
+
+    /* Destroying the loader waits for loads in progress and frees their images */
+    for (i = 0; i < num_images; ++i) {
+        SDL_LoadSurfaceAsync(loader, files[i], NULL);
+    }
+    SDL_DestroySurfaceLoader(loader);
+    SDLTest_AssertPass("Call to SDL_DestroySurfaceLoader() with loads in progress");
+
+done:
+    for (i = 0; i < SDL_arraysize(files); ++i) {
+        SDL_RemovePath(files[i]);
+    }
+    return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -1194,6 +2186,14 @@ static const SDLTest_TestCaseReference pixelsTestAllocFreePalette = {
     pixels_allocFreePalette, "pixels_allocFreePalette", "Call to SDL_CreatePalette and SDL_DestroyPalette", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference pixelsTestMapPalette = {
+    pixels_mapPalette, "pixels_mapPalette", "Map colors to the nearest palette entry", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference pixelsTestDitherPalette = {
+    pixels_ditherPalette, "pixels_ditherPalette", "Dither surfaces converted to a palette", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference pixelsTestSaveLoadBMP = {
     pixels_saveLoadBMP, "pixels_saveLoadBMP", "Call to SDL_SaveBMP and SDL_LoadBMP", TEST_ENABLED
 };
@@ -1202,13 +2202,40 @@ static const SDLTest_TestCaseReference pixelsTestSaveLoadPNG = {
     pixels_saveLoadPNG, "pixels_saveLoadPNG", "Call to SDL_SavePNG and SDL_LoadPNG", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference pixelsTestSavePNGOptions = {
+    pixels_savePNGOptions, "pixels_savePNGOptions", "Save PNG images with different compression options", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference pixelsTestLoadSurfaceWithProperties = {
+    pixels_loadSurfaceWithProperties, "pixels_loadSurfaceWithProperties", "Load images with a target format and scale, and into existing surfaces", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference pixelsTestLoadJPEG = {
+    pixels_loadJPEG, "pixels_loadJPEG", "Load baseline and progressive JPEG images at every scale, and into existing surfaces", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference pixelsTestSaveLoadBMPRows = {
+    pixels_saveLoadBMPRows, "pixels_saveLoadBMPRows", "Save and load BMP images with padded rows, and decode RLE4 images", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference pixelsTestSurfaceLoader = {
+    pixels_surfaceLoader, "pixels_surfaceLoader", "Load a batch of images in the background", TEST_ENABLED
+};
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] = {
     &pixelsTestGetPixelFormatName,
     &pixelsTestGetPixelFormatDetails,
     &pixelsTestAllocFreePalette,
+    &pixelsTestMapPalette,
+    &pixelsTestDitherPalette,
     &pixelsTestSaveLoadBMP,
     &pixelsTestSaveLoadPNG,
+    &pixelsTestSavePNGOptions,
+    &pixelsTestLoadSurfaceWithProperties,
+    &pixelsTestLoadJPEG,
+    &pixelsTestSaveLoadBMPRows,
+    &pixelsTestSurfaceLoader,
     NULL
 };
 
@@ -1331,6 +1331,1378 @@ static int SDLCALL render_testRGBSurfaceNoAlpha(void* arg)
     return TEST_COMPLETED;
 }
 
+/**
+ * Tests that blended rectangles and horizontal lines, which are filled a row at a time
+ * by the software renderer, match the same pixels drawn one point at a time.
+ */
+static int SDLCALL render_testSoftwareBlendedSpans(void *arg)
+{
+    static const SDL_PixelFormat formats[] = {
+        SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGBX8888, SDL_PIXELFORMAT_RGB565
+    };
+    static const SDL_BlendMode modes[] = {
+        SDL_BLENDMODE_BLEND, SDL_BLENDMODE_BLEND_PREMULTIPLIED, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD, SDL_BLENDMODE_MUL
+    };
+    const SDL_FRect rect = { 3.0f, 2.0f, 37.0f, 5.0f };
+    const float line_y = 10.0f;
+    int i, j, x, y;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        for (j = 0; j < SDL_arraysize(modes); ++j) {
+            SDL_Surface *spans = SDL_CreateSurface(45, 12, formats[i]);
+            SDL_Surface *points = SDL_CreateSurface(45, 12, formats[i]);
+            SDL_Renderer *spans_renderer = spans ? SDL_CreateSoftwareRenderer(spans) : NULL;
+            SDL_Renderer *points_renderer = points ? SDL_CreateSoftwareRenderer(points) : NULL;
+            Uint32 seed = 1;
+            bool same = true;
+
+            SDLTest_AssertCheck(spans_renderer && points_renderer, "Verify software renderers were created for %s", SDL_GetPixelFormatName(formats[i]));
+            if (!spans_renderer || !points_renderer) {
+                SDL_DestroyRenderer(spans_renderer);
+                SDL_DestroyRenderer(points_renderer);
+                SDL_DestroySurface(spans);
+                SDL_DestroySurface(points);
+                return TEST_ABORTED;
+            }
+
+            /* Start from the same noisy background */
+            for (y = 0; y < spans->h; ++y) {
+                Uint8 *row = (Uint8 *)spans->pixels + y * spans->pitch;
+                for (x = 0; x < spans->pitch; ++x) {
+                    seed = seed * 1103515245 + 12345;
+                    row[x] = (Uint8)(seed >> 24);
+                }
+                SDL_memcpy((Uint8 *)points->pixels + y * points->pitch, row, spans->pitch);
+            }
+
+            SDL_SetRenderDrawBlendMode(spans_renderer, modes[j]);
+            SDL_SetRenderDrawBlendMode(points_renderer, modes[j]);
+            SDL_SetRenderDrawColor(spans_renderer, 200, 90, 30, 160);
+            SDL_SetRenderDrawColor(points_renderer, 200, 90, 30, 160);
+
+            SDL_RenderFillRect(spans_renderer, &rect);
+            SDL_RenderLine(spans_renderer, 41.0f, line_y, 1.0f, line_y);
+            for (x = 0; x < (int)rect.w; ++x) {
+                for (y = 0; y < (int)rect.h; ++y) {
+                    SDL_RenderPoint(points_renderer, rect.x + x, rect.y + y);
+                }
+            }
+            for (x = 1; x <= 41; ++x) {
+                SDL_RenderPoint(points_renderer, (float)x, line_y);
+            }
+            SDL_RenderPresent(spans_renderer);
+            SDL_RenderPresent(points_renderer);
+
+            for (y = 0; y < spans->h; ++y) {
+                if (SDL_memcmp((Uint8 *)spans->pixels + y * spans->pitch, (Uint8 *)points->pixels + y * points->pitch, spans->w * SDL_BYTESPERPIXEL(formats[i])) != 0) {
+                    same = false;
+                }
+            }
+            SDLTest_AssertCheck(same, "Verify blended spans match points for %s, blend mode 0x%x", SDL_GetPixelFormatName(formats[i]), modes[j]);
+
+            SDL_DestroyRenderer(spans_renderer);
+            SDL_DestroyRenderer(points_renderer);
+            SDL_DestroySurface(spans);
+            SDL_DestroySurface(points);
+        }
+    }
+    return TEST_COMPLETED;
+}
+
+static void DrawMergeableScene(SDL_Renderer *target, SDL_Texture *texture, bool flush)
+{
+    const SDL_Rect viewport = { 4, 3, 50, 40 };
+    SDL_FRect dst;
+    int i;
+
+    SDL_SetRenderDrawColor(target, 10, 20, 30, 255);
+    SDL_RenderClear(target);
+    for (i = 0; i < 48; ++i) {
+        if (i % 16 == 8) {
+            /* Viewport and clip changes that are undone before anything is drawn */
+            SDL_SetRenderViewport(target, &viewport);
+            SDL_SetRenderClipRect(target, &viewport);
+            SDL_SetRenderViewport(target, NULL);
+            SDL_SetRenderClipRect(target, NULL);
+        }
+        SDL_SetTextureColorMod(texture, 255, (i >= 24 && i < 32) ? 128 : 255, 255);
+        dst.x = (float)((i * 7) % 60) - 4.0f;
+        dst.y = (float)((i * 5) % 40) - 3.0f;
+        dst.w = (i & 1) ? 8.0f : 13.0f;
+        dst.h = (i & 1) ? 8.0f : 11.0f;
+        SDL_RenderTexture(target, texture, NULL, &dst);
+        if (flush) {
+            SDL_FlushRenderer(target);
+        }
+    }
+    SDL_SetRenderDrawColor(target, 200, 100, 50, 128);
+    SDL_SetRenderDrawBlendMode(target, SDL_BLENDMODE_BLEND);
+    for (i = 0; i < 8; ++i) {
+        dst.x = (float)(i * 8);
+        dst.y = 30.0f;
+        dst.w = 6.0f;
+        dst.h = 6.0f;
+        SDL_RenderFillRect(target, &dst);
+        if (flush) {
+            SDL_FlushRenderer(target);
+        }
+    }
+    for (i = 0; i < 8; ++i) {
+        /* Lines are never merged, a polyline would join them */
+        SDL_RenderLine(target, (float)(i * 8), 0.0f, (float)(i * 8 + 4), 10.0f);
+    }
+    SDL_RenderPresent(target);
+}
+
+/**
+ * Tests that merging render commands before they're run doesn't change what's drawn.
+ */
+static int SDLCALL render_testCommandMerging(void *arg)
+{
+    SDL_Surface *batched = SDL_CreateSurface(64, 48, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Surface *flushed = SDL_CreateSurface(64, 48, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Renderer *batched_renderer = batched ? SDL_CreateSoftwareRenderer(batched) : NULL;
+    SDL_Renderer *flushed_renderer = flushed ? SDL_CreateSoftwareRenderer(flushed) : NULL;
+    SDL_Surface *image = SDL_CreateSurface(8, 8, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Texture *batched_texture = NULL;
+    SDL_Texture *flushed_texture = NULL;
+    Uint64 queued = 0, submitted = 0, flushed_queued = 0, flushed_submitted = 0;
+    bool same = true;
+    int x, y;
+
+    SDLTest_AssertCheck(batched_renderer && flushed_renderer && image, "Verify software renderers were created");
+    if (batched_renderer && flushed_renderer && image) {
+        for (y = 0; y < image->h; ++y) {
+            for (x = 0; x < image->w; ++x) {
+                ((Uint32 *)((Uint8 *)image->pixels + y * image->pitch))[x] = ((x + y) & 1) ? 0x80FF8040 : 0xFF2060C0;
+            }
+        }
+        batched_texture = SDL_CreateTextureFromSurface(batched_renderer, image);
+        flushed_texture = SDL_CreateTextureFromSurface(flushed_renderer, image);
+        SDL_SetTextureScaleMode(batched_texture, SDL_SCALEMODE_NEAREST);
+        SDL_SetTextureScaleMode(flushed_texture, SDL_SCALEMODE_NEAREST);
+
+        DrawMergeableScene(batched_renderer, batched_texture, false);
+        DrawMergeableScene(flushed_renderer, flushed_texture, true);
+
+        for (y = 0; y < batched->h; ++y) {
+            if (SDL_memcmp((Uint8 *)batched->pixels + y * batched->pitch, (Uint8 *)flushed->pixels + y * flushed->pitch, batched->w * 4) != 0) {
+                same = false;
+            }
+        }
+        SDLTest_AssertCheck(same, "Verify merged commands draw the same pixels as unmerged ones");
+
+        SDLTest_AssertCheck(SDL_GetRenderCommandCounts(batched_renderer, &queued, &submitted), "Call to SDL_GetRenderCommandCounts()");
+        SDLTest_AssertCheck(submitted > 0 && submitted * 4 < queued, "Verify most commands were merged, got %" SDL_PRIu64 " of %" SDL_PRIu64, submitted, queued);
+        SDL_GetRenderCommandCounts(flushed_renderer, &flushed_queued, &flushed_submitted);
+        SDLTest_AssertCheck(flushed_submitted > submitted, "Verify flushing each draw submits more commands, got %" SDL_PRIu64 " and %" SDL_PRIu64, flushed_submitted, submitted);
+    }
+
+    SDLTest_AssertCheck(!SDL_GetRenderCommandCounts(NULL, &queued, &submitted), "Verify SDL_GetRenderCommandCounts(NULL) fails");
+    SDLTest_AssertCheck(queued == 0 && submitted == 0, "Verify counts are cleared on failure");
+
+    SDL_DestroyRenderer(batched_renderer);
+    SDL_DestroyRenderer(flushed_renderer);
+    SDL_DestroySurface(batched);
+    SDL_DestroySurface(flushed);
+    SDL_DestroySurface(image);
+    return TEST_COMPLETED;
+}
+
+/* The vertices SDL_RenderSprites() makes for a sprite, for an 8x8 texture */
+static void GetSpriteTestVertices(const SDL_Sprite *sprite, SDL_Vertex vertices[4])
+{
+    const SDL_FRect bounds = { 0.0f, 0.0f, 8.0f, 8.0f };
+    const float radian_angle = (float)((SDL_PI_D * sprite->angle) / 180.0);
+    const float s = SDL_sinf(radian_angle);
+    const float c = SDL_cosf(radian_angle);
+    const float centerx = sprite->dstrect.w / 2.0f + sprite->dstrect.x;
+    const float centery = sprite->dstrect.h / 2.0f + sprite->dstrect.y;
+    SDL_FRect srcrect = bounds;
+    float x[4], y[4];
+    int i;
+
+    if (sprite->srcrect.w != 0.0f || sprite->srcrect.h != 0.0f) {
+        SDL_GetRectIntersectionFloat(&sprite->srcrect, &bounds, &srcrect);
+    }
+
+    x[0] = x[3] = sprite->dstrect.x;
+    x[1] = x[2] = sprite->dstrect.x + sprite->dstrect.w;
+    y[0] = y[1] = sprite->dstrect.y;
+    y[2] = y[3] = sprite->dstrect.y + sprite->dstrect.h;
+    if (sprite->flip & SDL_FLIP_HORIZONTAL) {
+        x[0] = x[3] = sprite->dstrect.x + sprite->dstrect.w;
+        x[1] = x[2] = sprite->dstrect.x;
+    }
+    if (sprite->flip & SDL_FLIP_VERTICAL) {
+        y[0] = y[1] = sprite->dstrect.y + sprite->dstrect.h;
+        y[2] = y[3] = sprite->dstrect.y;
+    }
+
+    for (i = 0; i < 4; ++i) {
+        if (sprite->angle != 0.0 || sprite->flip != SDL_FLIP_NONE) {
+            vertices[i].position.x = (c * (x[i] - centerx) - s * (y[i] - centery)) + centerx;
+            vertices[i].position.y = (s * (x[i] - centerx) + c * (y[i] - centery)) + centery;
+        } else {
+            vertices[i].position.x = x[i];
+            vertices[i].position.y = y[i];
+        }
+        vertices[i].color = sprite->color;
+        vertices[i].tex_coord.x = ((i == 1 || i == 2) ? srcrect.x + srcrect.w : srcrect.x) / bounds.w;
+        vertices[i].tex_coord.y = ((i >= 2) ? srcrect.y + srcrect.h : srcrect.y) / bounds.h;
+    }
+}
+
+/* Draws sprites with SDL_RenderSprites() and the same textures one at a time, optionally with sprites drawn as geometry */
+static int TestRenderSprites(bool geometry)
+{
+    SDL_Sprite sprites[7];
+    SDL_Sprite grid[300];
+    SDL_Surface *batched = SDL_CreateSurface(64, 48, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Surface *single = SDL_CreateSurface(64, 48, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Renderer *batched_renderer = NULL;
+    SDL_Renderer *single_renderer = single ? SDL_CreateSoftwareRenderer(single) : NULL;
+    SDL_Surface *image = SDL_CreateSurface(8, 8, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Texture *batched_texture = NULL;
+    SDL_Texture *single_texture = NULL;
+    bool same = true;
+    int i, x, y;
+
+    if (geometry) {
+        SDL_SetHint(SDL_HINT_RENDER_SPRITES_GEOMETRY, "1");
+    }
+    batched_renderer = batched ? SDL_CreateSoftwareRenderer(batched) : NULL;
+    SDL_ResetHint(SDL_HINT_RENDER_SPRITES_GEOMETRY);
+
+    SDLTest_AssertCheck(batched_renderer && single_renderer && image, "Verify software renderers were created");
+    if (!batched_renderer || !single_renderer || !image) {
+        SDL_DestroyRenderer(batched_renderer);
+        SDL_DestroyRenderer(single_renderer);
+        SDL_DestroySurface(batched);
+        SDL_DestroySurface(single);
+        SDL_DestroySurface(image);
+        return TEST_ABORTED;
+    }
+
+    for (y = 0; y < image->h; ++y) {
+        for (x = 0; x < image->w; ++x) {
+            ((Uint32 *)((Uint8 *)image->pixels + y * image->pitch))[x] = 0xC0000000 | (Uint32)(x * 32) << 16 | (Uint32)(y * 32) << 8 | 0x40;
+        }
+    }
+    batched_texture = SDL_CreateTextureFromSurface(batched_renderer, image);
+    single_texture = SDL_CreateTextureFromSurface(single_renderer, image);
+
+    SDL_zeroa(sprites);
+    for (i = 0; i < SDL_arraysize(sprites); ++i) {
+        sprites[i].dstrect.x = (float)(i * 9) - 2.0f;
+        sprites[i].dstrect.y = (float)(i * 5);
+        sprites[i].dstrect.w = 8.0f;
+        sprites[i].dstrect.h = 8.0f;
+        sprites[i].color.r = sprites[i].color.g = sprites[i].color.b = sprites[i].color.a = 1.0f;
+    }
+    sprites[1].srcrect.x = 2.0f;
+    sprites[1].srcrect.y = 1.0f;
+    sprites[1].srcrect.w = 4.0f;
+    sprites[1].srcrect.h = 20.0f;
+    sprites[2].color.g = 0.5f;
+    sprites[2].color.a = 0.75f;
+    sprites[3].angle = 90.0;
+    sprites[4].flip = SDL_FLIP_HORIZONTAL;
+    sprites[4].color.b = 0.25f;
+    sprites[5].dstrect.w = 16.0f;
+    sprites[5].dstrect.h = 12.0f;
+    sprites[6].angle = 30.0;
+    sprites[6].flip = SDL_FLIP_VERTICAL;
+
+    /* More sprites than fit in one geometry batch */
+    SDL_zeroa(grid);
+    for (i = 0; i < SDL_arraysize(grid); ++i) {
+        grid[i].srcrect.x = (float)(i % 4);
+        grid[i].srcrect.y = (float)(i % 3);
+        grid[i].srcrect.w = 3.0f;
+        grid[i].srcrect.h = 3.0f;
+        grid[i].dstrect.x = (float)((i % 20) * 3);
+        grid[i].dstrect.y = (float)(16 + (i / 20) * 2);
+        grid[i].dstrect.w = 3.0f;
+        grid[i].dstrect.h = 2.0f;
+        grid[i].color.r = (float)(i % 5) / 4.0f;
+        grid[i].color.g = grid[i].color.b = grid[i].color.a = 1.0f;
+    }
+
+    SDL_SetRenderDrawColor(batched_renderer, 10, 20, 30, 255);
+    SDL_RenderClear(batched_renderer);
+    SDLTest_AssertCheck(SDL_RenderSprites(batched_renderer, batched_texture, grid, SDL_arraysize(grid)), "Call to SDL_RenderSprites() with %d sprites", (int)SDL_arraysize(grid));
+    SDLTest_AssertCheck(SDL_RenderSprites(batched_renderer, batched_texture, sprites, SDL_arraysize(sprites)), "Call to SDL_RenderSprites()");
+    SDL_RenderPresent(batched_renderer);
+
+    SDL_SetRenderDrawColor(single_renderer, 10, 20, 30, 255);
+    SDL_RenderClear(single_renderer);
+    for (i = 0; i < (int)(SDL_arraysize(grid) + SDL_arraysize(sprites)); ++i) {
+        const SDL_Sprite *sprite = (i < SDL_arraysize(grid)) ? &grid[i] : &sprites[i - SDL_arraysize(grid)];
+        if (geometry) {
+            static const int indices[2][3] = { { 0, 1, 2 }, { 0, 2, 3 } };
+            SDL_Vertex vertices[4];
+
+            /* The triangles are drawn separately so the software renderer doesn't turn them back into a copy */
+            GetSpriteTestVertices(sprite, vertices);
+            SDL_RenderGeometry(single_renderer, single_texture, vertices, SDL_arraysize(vertices), indices[0], 3);
+            SDL_RenderGeometry(single_renderer, single_texture, vertices, SDL_arraysize(vertices), indices[1], 3);
+        } else {
+            SDL_SetTextureColorModFloat(single_texture, sprite->color.r, sprite->color.g, sprite->color.b);
+            SDL_SetTextureAlphaModFloat(single_texture, sprite->color.a);
+            SDL_RenderTextureRotated(single_renderer, single_texture, (sprite->srcrect.w != 0.0f) ? &sprite->srcrect : NULL, &sprite->dstrect, sprite->angle, NULL, sprite->flip);
+        }
+    }
+    SDL_RenderPresent(single_renderer);
+
+    for (y = 0; y < batched->h; ++y) {
+        if (SDL_memcmp((Uint8 *)batched->pixels + y * batched->pitch, (Uint8 *)single->pixels + y * single->pitch, batched->w * 4) != 0) {
+            same = false;
+        }
+    }
+    SDLTest_AssertCheck(same, "Verify sprites drawn as %s match the same textures drawn one at a time", geometry ? "geometry" : "copies");
+
+    SDLTest_AssertCheck(SDL_RenderSprites(batched_renderer, batched_texture, sprites, 0), "Verify drawing no sprites succeeds");
+    SDLTest_AssertCheck(!SDL_RenderSprites(batched_renderer, batched_texture, NULL, 1), "Verify NULL sprites fails");
+    SDLTest_AssertCheck(!SDL_RenderSprites(batched_renderer, single_texture, sprites, 1), "Verify a texture from another renderer fails");
+
+    SDL_DestroyRenderer(batched_renderer);
+    SDL_DestroyRenderer(single_renderer);
+    SDL_DestroySurface(batched);
+    SDL_DestroySurface(single);
+    SDL_DestroySurface(image);
+    return TEST_COMPLETED;
+}
+
+/**
+ * Tests that SDL_RenderSprites() draws the same as the matching SDL_RenderTextureRotated() calls.
+ */
+static int SDLCALL render_testRenderSprites(void *arg)
+{
+    return TestRenderSprites(false);
+}
+
+/**
+ * Tests that SDL_RenderSprites() draws the same as the matching SDL_RenderGeometry() calls when sprites are drawn as geometry.
+ */
+static int SDLCALL render_testRenderSpritesGeometry(void *arg)
+{
+    return TestRenderSprites(true);
+}
+
+static SDL_Texture *CreateAtlasTestTexture(SDL_Renderer *target, int w, int h, Uint32 seed)
+{
+    SDL_Surface *surface = SDL_CreateSurface(w, h, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Texture *texture = NULL;
+    int x, y;
+
+    if (surface) {
+        for (y = 0; y < h; ++y) {
+            for (x = 0; x < w; ++x) {
+                ((Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch))[x] = 0xFF000000 | ((Uint32)(x * 37 + seed) & 0xFF) << 16 | ((Uint32)(y * 53 + seed) & 0xFF) << 8 | (seed & 0xFF);
+            }
+        }
+        texture = SDL_CreateTextureFromSurface(target, surface);
+        SDL_DestroySurface(surface);
+    }
+    return texture;
+}
+
+static void DrawAtlasTestScene(SDL_Renderer *target, SDL_Texture **textures)
+{
+    static const SDL_FRect srcrect = { 1.0f, 2.0f, 3.0f, 2.0f };
+    SDL_FRect dstrect;
+    SDL_Vertex verts[4];
+    static const int indices[6] = { 0, 1, 2, 0, 2, 3 };
+    SDL_Sprite sprites[2];
+    Uint32 patch[6];
+    SDL_Rect update = { 2, 1, 3, 2 };
+    int i;
+
+    SDL_SetRenderDrawColor(target, 10, 20, 30, 255);
+    SDL_RenderClear(target);
+
+    for (i = 0; i < 3; ++i) {
+        dstrect.x = (float)(i * 14);
+        dstrect.y = 0.0f;
+        dstrect.w = (float)textures[i]->w;
+        dstrect.h = (float)textures[i]->h;
+        SDL_RenderTexture(target, textures[i], NULL, &dstrect);
+    }
+
+    dstrect.x = 0.0f;
+    dstrect.y = 14.0f;
+    dstrect.w = 9.0f;
+    dstrect.h = 6.0f;
+    SDL_SetTextureColorMod(textures[0], 255, 128, 64);
+    SDL_RenderTexture(target, textures[0], &srcrect, &dstrect);
+    SDL_SetTextureColorMod(textures[0], 255, 255, 255);
+
+    dstrect.x = 12.0f;
+    dstrect.w = 10.0f;
+    dstrect.h = 7.0f;
+    SDL_RenderTextureRotated(target, textures[1], NULL, &dstrect, 90.0, NULL, SDL_FLIP_HORIZONTAL);
+
+    dstrect.x = 26.0f;
+    dstrect.w = 30.0f;
+    dstrect.h = 10.0f;
+    SDL_RenderTextureTiled(target, textures[2], NULL, 1.0f, &dstrect);
+
+    SDL_zeroa(verts);
+    for (i = 0; i < 4; ++i) {
+        verts[i].position.x = (i == 1 || i == 2) ? 16.0f : 0.0f;
+        verts[i].position.y = (i >= 2) ? 40.0f : 24.0f;
+        verts[i].tex_coord.x = (i == 1 || i == 2) ? 1.0f : 0.0f;
+        verts[i].tex_coord.y = (i >= 2) ? 1.0f : 0.0f;
+        verts[i].color.r = verts[i].color.g = verts[i].color.b = verts[i].color.a = 1.0f;
+    }
+    SDL_RenderGeometry(target, textures[0], verts, 4, indices, 6);
+
+    SDL_zeroa(sprites);
+    for (i = 0; i < SDL_arraysize(sprites); ++i) {
+        sprites[i].dstrect.x = 20.0f + i * 10.0f;
+        sprites[i].dstrect.y = 26.0f;
+        sprites[i].dstrect.w = 8.0f;
+        sprites[i].dstrect.h = 8.0f;
+        sprites[i].color.r = sprites[i].color.g = sprites[i].color.b = sprites[i].color.a = 1.0f;
+    }
+    sprites[1].srcrect = srcrect;
+    sprites[1].color.b = 0.5f;
+    SDL_RenderSprites(target, textures[1], sprites, SDL_arraysize(sprites));
+
+    /* Updating part of a texture changes it where it is drawn afterwards */
+    for (i = 0; i < SDL_arraysize(patch); ++i) {
+        patch[i] = 0xFFFF00FF;
+    }
+    SDL_UpdateTexture(textures[2], &update, patch, 3 * sizeof(Uint32));
+    dstrect.x = 44.0f;
+    dstrect.y = 26.0f;
+    dstrect.w = (float)textures[2]->w;
+    dstrect.h = (float)textures[2]->h;
+    SDL_RenderTexture(target, textures[2], NULL, &dstrect);
+
+    SDL_RenderPresent(target);
+}
+
+/**
+ * Tests drawing textures packed into an atlas matches drawing separate textures
+ */
+static int SDLCALL render_testTextureAtlas(void *arg)
+{
+    SDL_Surface *atlas = SDL_CreateSurface(64, 48, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Surface *separate = SDL_CreateSurface(64, 48, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Renderer *atlas_renderer = NULL;
+    SDL_Renderer *separate_renderer = separate ? SDL_CreateSoftwareRenderer(separate) : NULL;
+    SDL_Texture *atlas_textures[3];
+    SDL_Texture *separate_textures[3];
+    SDL_Texture *large = NULL;
+    SDL_PropertiesID props;
+    Uint64 queued, submitted, atlas_queued, atlas_submitted;
+    int num_pages = 0, num_textures = 0;
+    float occupancy = 0.0f;
+    bool same = true;
+    int i, y;
+
+    props = SDL_CreateProperties();
+    SDL_SetPointerProperty(props, SDL_PROP_RENDERER_CREATE_SURFACE_POINTER, atlas);
+    SDL_SetBooleanProperty(props, SDL_PROP_RENDERER_CREATE_TEXTURE_ATLAS_BOOLEAN, true);
+    atlas_renderer = atlas ? SDL_CreateRendererWithProperties(props) : NULL;
+    SDL_DestroyProperties(props);
+
+    SDLTest_AssertCheck(atlas_renderer && separate_renderer, "Verify software renderers were created");
+    if (!atlas_renderer || !separate_renderer) {
+        SDL_DestroyRenderer(atlas_renderer);
+        SDL_DestroyRenderer(separate_renderer);
+        SDL_DestroySurface(atlas);
+        SDL_DestroySurface(separate);
+        return TEST_ABORTED;
+    }
+
+    for (i = 0; i < 3; ++i) {
+        static const int sizes[3][2] = { { 8, 8 }, { 5, 7 }, { 12, 4 } };
+        atlas_textures[i] = CreateAtlasTestTexture(atlas_renderer, sizes[i][0], sizes[i][1], (Uint32)i * 80);
+        separate_textures[i] = CreateAtlasTestTexture(separate_renderer, sizes[i][0], sizes[i][1], (Uint32)i * 80);
+        SDLTest_AssertCheck(atlas_textures[i] && separate_textures[i], "Verify texture %d was created", i);
+        if (!atlas_textures[i] || !separate_textures[i]) {
+            SDL_DestroyRenderer(atlas_renderer);
+            SDL_DestroyRenderer(separate_renderer);
+            SDL_DestroySurface(atlas);
+            SDL_DestroySurface(separate);
+            return TEST_ABORTED;
+        }
+    }
+    large = CreateAtlasTestTexture(atlas_renderer, 300, 20, 7);
+
+    SDLTest_AssertCheck(SDL_GetRenderTextureAtlasInfo(atlas_renderer, &num_pages, &num_textures, &occupancy), "Call to SDL_GetRenderTextureAtlasInfo()");
+    SDLTest_AssertCheck(num_pages == 1 && num_textures == 3, "Verify the small textures share one atlas page, got %d pages with %d textures", num_pages, num_textures);
+    SDLTest_AssertCheck(occupancy > 0.0f && occupancy < 1.0f, "Verify atlas occupancy is between 0 and 1, got %f", occupancy);
+    SDLTest_AssertCheck(SDL_GetRenderTextureAtlasInfo(separate_renderer, &num_pages, &num_textures, NULL) && num_pages == 0 && num_textures == 0, "Verify renderers don't use an atlas by default");
+
+    DrawAtlasTestScene(atlas_renderer, atlas_textures);
+    DrawAtlasTestScene(separate_renderer, separate_textures);
+    for (y = 0; y < atlas->h; ++y) {
+        if (SDL_memcmp((Uint8 *)atlas->pixels + y * atlas->pitch, (Uint8 *)separate->pixels + y * separate->pitch, atlas->w * 4) != 0) {
+            same = false;
+        }
+    }
+    SDLTest_AssertCheck(same, "Verify textures in an atlas draw the same as separate textures");
+
+    /* Drawing different textures from the same atlas page one after another can be merged */
+    SDL_GetRenderCommandCounts(atlas_renderer, &queued, &submitted);
+    for (i = 0; i < 30; ++i) {
+        const SDL_FRect dstrect = { (float)(i % 6) * 10.0f, (float)(i / 6) * 9.0f, 8.0f, 8.0f };
+        SDL_RenderTexture(atlas_renderer, atlas_textures[i % 3], NULL, &dstrect);
+    }
+    SDL_FlushRenderer(atlas_renderer);
+    SDL_GetRenderCommandCounts(atlas_renderer, &atlas_queued, &atlas_submitted);
+    atlas_queued -= queued;
+    atlas_submitted -= submitted;
+    SDLTest_AssertCheck(atlas_submitted < atlas_queued / 4, "Verify draws of different atlas textures were merged, %d commands submitted of %d", (int)atlas_submitted, (int)atlas_queued);
+
+    for (i = 0; i < 3; ++i) {
+        SDL_DestroyTexture(atlas_textures[i]);
+    }
+    SDL_GetRenderTextureAtlasInfo(atlas_renderer, &num_pages, &num_textures, &occupancy);
+    SDLTest_AssertCheck(num_pages == 0 && num_textures == 0 && occupancy == 0.0f, "Verify the atlas page is freed with its last texture");
+
+    SDL_DestroyTexture(large);
+    SDL_DestroyRenderer(atlas_renderer);
+    SDL_DestroyRenderer(separate_renderer);
+    SDL_DestroySurface(atlas);
+    SDL_DestroySurface(separate);
+    return TEST_COMPLETED;
+}
+
+typedef struct DeferredTestBand
+{
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    int band;
+} DeferredTestBand;
+
+static bool DrawDeferredTestBand(SDL_Renderer *target, SDL_Texture *texture, int band)
+{
+    const float y = (float)(band * 16);
+    const SDL_FRect rect = { 2.0f, y + 1.0f, 20.0f, 6.0f };
+    const SDL_FRect dstrect = { 24.0f, y + 1.0f, 12.0f, 12.0f };
+    SDL_Vertex verts[3];
+    SDL_Sprite sprite;
+    bool result = true;
+
+    SDL_zeroa(verts);
+    verts[0].position.x = 40.0f;
+    verts[0].position.y = y;
+    verts[1].position.x = 56.0f;
+    verts[1].position.y = y + 4.0f;
+    verts[2].position.x = 44.0f;
+    verts[2].position.y = y + 14.0f;
+    verts[0].color.r = verts[1].color.g = verts[2].color.b = 1.0f;
+    verts[0].color.a = verts[1].color.a = verts[2].color.a = 1.0f;
+
+    SDL_zero(sprite);
+    sprite.dstrect.x = 58.0f;
+    sprite.dstrect.y = y + 2.0f;
+    sprite.dstrect.w = 6.0f;
+    sprite.dstrect.h = 6.0f;
+    sprite.color.r = sprite.color.a = 1.0f;
+    sprite.color.g = sprite.color.b = 0.5f;
+
+    result &= SDL_SetRenderDrawColor(target, (Uint8)(50 * band), 200, 100, 255);
+    result &= SDL_RenderFillRect(target, &rect);
+    result &= SDL_RenderLine(target, 2.0f, y + 12.0f, 20.0f, y + 14.0f);
+    result &= SDL_RenderTexture(target, texture, NULL, &dstrect);
+    result &= SDL_RenderGeometry(target, NULL, verts, 3, NULL, 0);
+    result &= SDL_RenderSprites(target, texture, &sprite, 1);
+    result &= SDL_RenderDebugText(target, 66.0f, y + 4.0f, "Hi");
+    return result;
+}
+
+static int SDLCALL RecordDeferredTestBand(void *data)
+{
+    DeferredTestBand *band = (DeferredTestBand *)data;
+
+    return DrawDeferredTestBand(band->renderer, band->texture, band->band) ? 1 : 0;
+}
+
+/**
+ * Tests commands recorded on other threads draw the same as drawing directly
+ */
+static int SDLCALL render_testDeferredRenderer(void *arg)
+{
+    SDL_Surface *deferred_surface = SDL_CreateSurface(96, 64, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Surface *direct_surface = SDL_CreateSurface(96, 64, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Renderer *deferred_target = deferred_surface ? SDL_CreateSoftwareRenderer(deferred_surface) : NULL;
+    SDL_Renderer *direct_target = direct_surface ? SDL_CreateSoftwareRenderer(direct_surface) : NULL;
+    SDL_Texture *deferred_texture = NULL;
+    SDL_Texture *direct_texture = NULL;
+    SDL_Surface *surface;
+    DeferredTestBand bands[4];
+    SDL_Thread *threads[4];
+    bool same = true;
+    int i, y;
+
+    SDLTest_AssertCheck(deferred_target && direct_target, "Verify software renderers were created");
+    if (!deferred_target || !direct_target) {
+        goto done;
+    }
+
+    surface = SDLTest_ImageBlit();
+    if (surface) {
+        deferred_texture = SDL_CreateTextureFromSurface(deferred_target, surface);
+        direct_texture = SDL_CreateTextureFromSurface(direct_target, surface);
+        SDL_DestroySurface(surface);
+    }
+    SDLTest_AssertCheck(deferred_texture && direct_texture, "Verify textures were created");
+    if (!deferred_texture || !direct_texture) {
+        goto done;
+    }
+    SDL_SetTextureColorMod(deferred_texture, 255, 128, 255);
+    SDL_SetTextureColorMod(direct_texture, 255, 128, 255);
+
+    SDL_SetRenderDrawColor(direct_target, 0, 0, 64, 255);
+    SDL_RenderClear(direct_target);
+    for (i = 0; i < SDL_arraysize(bands); ++i) {
+        DrawDeferredTestBand(direct_target, direct_texture, i);
+    }
+    SDL_RenderPresent(direct_target);
+
+    SDL_SetRenderDrawColor(deferred_target, 0, 0, 64, 255);
+    SDL_RenderClear(deferred_target);
+    for (i = 0; i < SDL_arraysize(bands); ++i) {
+        bands[i].renderer = SDL_CreateDeferredRenderer(deferred_target);
+        bands[i].texture = deferred_texture;
+        bands[i].band = i;
+        SDLTest_AssertCheck(bands[i].renderer != NULL, "Verify deferred renderer %d was created", i);
+        if (!bands[i].renderer) {
+            goto done;
+        }
+    }
+    SDLTest_AssertCheck(!SDL_RenderPresent(bands[0].renderer), "Verify deferred renderers can't present");
+    SDLTest_AssertCheck(!SDL_CreateTexture(bands[0].renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 4, 4), "Verify deferred renderers can't create textures");
+
+    for (i = 0; i < SDL_arraysize(bands); ++i) {
+        threads[i] = SDL_CreateThread(RecordDeferredTestBand, "RecordDeferred", &bands[i]);
+    }
+    for (i = 0; i < SDL_arraysize(bands); ++i) {
+        int status = 0;
+        SDL_WaitThread(threads[i], &status);
+        SDLTest_AssertCheck(status == 1, "Verify band %d was recorded", i);
+    }
+
+    /* Submitting in order draws the bands in order, whichever thread finished first */
+    for (i = 0; i < SDL_arraysize(bands); ++i) {
+        SDLTest_AssertCheck(SDL_SubmitDeferredRenderer(bands[i].renderer), "Call to SDL_SubmitDeferredRenderer(%d)", i);
+    }
+    SDL_RenderPresent(deferred_target);
+
+    for (y = 0; y < deferred_surface->h; ++y) {
+        if (SDL_memcmp((Uint8 *)deferred_surface->pixels + y * deferred_surface->pitch, (Uint8 *)direct_surface->pixels + y * direct_surface->pitch, deferred_surface->w * 4) != 0) {
+            same = false;
+        }
+    }
+    SDLTest_AssertCheck(same, "Verify submitted deferred renderers draw the same as drawing directly");
+
+    /* A submitted deferred renderer is empty and can record again */
+    SDLTest_AssertCheck(DrawDeferredTestBand(bands[0].renderer, deferred_texture, 0) && SDL_SubmitDeferredRenderer(bands[0].renderer), "Verify a deferred renderer can record again");
+    SDL_DestroyRenderer(bands[0].renderer);
+
+done:
+    /* The other deferred renderers are destroyed with the renderer */
+    SDL_DestroyRenderer(deferred_target);
+    SDL_DestroyRenderer(direct_target);
+    SDL_DestroySurface(deferred_surface);
+    SDL_DestroySurface(direct_surface);
+    return TEST_COMPLETED;
+}
+
+/**
+ * Tests that SDL_RenderDebugTexts draws the same as SDL_RenderDebugText
+ */
+static int SDLCALL render_testDebugTexts(void *arg)
+{
+    static const char *strings[] = { "FPS: 60.0", "draw calls: 12", "\xc3\xa9t\xc3\xa9 ~{|}", "", "   spaces   " };
+    SDL_Surface *batched = SDL_CreateSurface(128, 64, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Surface *separate = SDL_CreateSurface(128, 64, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Renderer *batched_renderer = batched ? SDL_CreateSoftwareRenderer(batched) : NULL;
+    SDL_Renderer *separate_renderer = separate ? SDL_CreateSoftwareRenderer(separate) : NULL;
+    SDL_DebugText texts[SDL_arraysize(strings)];
+    SDL_DebugText text;
+    Uint64 queued = 0, submitted = 0, batched_queued = 0, batched_submitted = 0, short_submitted;
+    bool same = true;
+    int i, y;
+
+    SDLTest_AssertCheck(batched_renderer && separate_renderer, "Verify software renderers were created");
+    if (!batched_renderer || !separate_renderer) {
+        goto done;
+    }
+
+    SDL_SetRenderDrawColor(batched_renderer, 0, 0, 64, 255);
+    SDL_RenderClear(batched_renderer);
+    SDL_SetRenderDrawColor(separate_renderer, 0, 0, 64, 255);
+    SDL_RenderClear(separate_renderer);
+    for (i = 0; i < SDL_arraysize(strings); ++i) {
+        const Uint8 r = (Uint8)(255 - i * 40);
+        const Uint8 g = (Uint8)(64 + i * 32);
+        const Uint8 b = (Uint8)(i * 60);
+
+        texts[i].x = 2.0f + i * 3.0f;
+        texts[i].y = 2.0f + i * 11.0f;
+        texts[i].color.r = r / 255.0f;
+        texts[i].color.g = g / 255.0f;
+        texts[i].color.b = b / 255.0f;
+        texts[i].color.a = 1.0f;
+        texts[i].text = strings[i];
+
+        SDL_SetRenderDrawColor(separate_renderer, r, g, b, 255);
+        SDLTest_AssertCheck(SDL_RenderDebugText(separate_renderer, texts[i].x, texts[i].y, strings[i]), "Call to SDL_RenderDebugText(\"%s\")", strings[i]);
+    }
+    SDLTest_AssertCheck(SDL_RenderDebugTexts(batched_renderer, texts, SDL_arraysize(texts)), "Call to SDL_RenderDebugTexts()");
+    SDL_RenderPresent(batched_renderer);
+    SDL_RenderPresent(separate_renderer);
+
+    for (y = 0; y < batched->h; ++y) {
+        if (SDL_memcmp((Uint8 *)batched->pixels + y * batched->pitch, (Uint8 *)separate->pixels + y * separate->pitch, batched->w * 4) != 0) {
+            same = false;
+        }
+    }
+    SDLTest_AssertCheck(same, "Verify SDL_RenderDebugTexts() draws the same as SDL_RenderDebugText()");
+
+    /* A long string costs as many commands as a single character */
+    text = texts[0];
+    text.text = "A";
+    SDL_GetRenderCommandCounts(batched_renderer, &queued, &submitted);
+    SDL_RenderDebugTexts(batched_renderer, &text, 1);
+    SDL_FlushRenderer(batched_renderer);
+    SDL_GetRenderCommandCounts(batched_renderer, &batched_queued, &batched_submitted);
+    short_submitted = batched_submitted - submitted;
+
+    text.text = "The quick brown fox jumps over the lazy dog";
+    SDL_GetRenderCommandCounts(batched_renderer, &queued, &submitted);
+    SDL_RenderDebugTexts(batched_renderer, &text, 1);
+    SDL_FlushRenderer(batched_renderer);
+    SDL_GetRenderCommandCounts(batched_renderer, &batched_queued, &batched_submitted);
+    SDLTest_AssertCheck(batched_submitted - submitted == short_submitted, "Verify a string of text was drawn as one batch, %d commands submitted, expected %d", (int)(batched_submitted - submitted), (int)short_submitted);
+
+    text.text = NULL;
+    SDLTest_AssertCheck(!SDL_RenderDebugTexts(batched_renderer, &text, 1), "Verify SDL_RenderDebugTexts() fails with a NULL string");
+    SDLTest_AssertCheck(SDL_RenderDebugTexts(batched_renderer, texts, 0), "Verify SDL_RenderDebugTexts() succeeds with no strings");
+
+done:
+    SDL_DestroyRenderer(batched_renderer);
+    SDL_DestroyRenderer(separate_renderer);
+    SDL_DestroySurface(batched);
+    SDL_DestroySurface(separate);
+    return TEST_COMPLETED;
+}
+
+/**
+ * Tests the frame statistics reported by SDL_GetRenderStats
+ */
+static int SDLCALL render_testRenderStats(void *arg)
+{
+    SDL_Surface *target = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_XRGB8888);
+    SDL_Renderer *stats_renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    SDL_Texture *textures[2] = { NULL, NULL };
+    SDL_RenderStats stats;
+    SDL_Rect rect = { 0, 0, 8, 4 };
+    Uint32 pixels[16 * 16];
+    void *locked = NULL;
+    int pitch = 0;
+    int i;
+
+    SDLTest_AssertCheck(stats_renderer != NULL, "Verify software renderer was created");
+    if (!stats_renderer) {
+        goto done;
+    }
+    for (i = 0; i < SDL_arraysize(textures); ++i) {
+        textures[i] = SDL_CreateTexture(stats_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 16, 16);
+        SDLTest_AssertCheck(textures[i] != NULL, "Verify texture %d was created", i);
+        if (!textures[i]) {
+            goto done;
+        }
+    }
+    SDL_memset(pixels, 0xff, sizeof(pixels));
+
+    SDLTest_AssertCheck(SDL_GetRenderStats(stats_renderer, &stats) && stats.frame == 0 && stats.num_commands_queued == 0, "Verify the stats are zero before the first frame is presented");
+
+    /* 1 KB uploaded, then a lock that the software renderer doesn't upload */
+    SDL_UpdateTexture(textures[0], NULL, pixels, 16 * sizeof(Uint32));
+    if (SDL_LockTexture(textures[1], &rect, &locked, &pitch)) {
+        SDL_UnlockTexture(textures[1]);
+    }
+
+    SDL_SetRenderDrawColor(stats_renderer, 0, 0, 0, 255);
+    SDL_RenderClear(stats_renderer);
+    for (i = 0; i < 6; ++i) {
+        const SDL_FRect dstrect = { (float)i * 8.0f, 0.0f, 8.0f, 8.0f };
+        SDL_RenderTexture(stats_renderer, textures[i / 3], NULL, &dstrect);
+    }
+    SDL_FlushRenderer(stats_renderer);
+    SDL_SetRenderDrawColor(stats_renderer, 255, 0, 0, 255);
+    SDL_RenderLine(stats_renderer, 0.0f, 20.0f, 63.0f, 20.0f);
+    SDLTest_AssertCheck(SDL_RenderPresent(stats_renderer), "Call to SDL_RenderPresent()");
+
+    SDLTest_AssertCheck(SDL_GetRenderStats(stats_renderer, &stats), "Call to SDL_GetRenderStats()");
+    SDLTest_AssertCheck(stats.frame == 1, "Verify the first frame is frame 1, got %d", (int)stats.frame);
+    SDLTest_AssertCheck(stats.num_flushes == 2, "Verify 2 flushes were counted, got %d", (int)stats.num_flushes);
+    SDLTest_AssertCheck(stats.num_clears == 1, "Verify 1 clear was counted, got %d", (int)stats.num_clears);
+    SDLTest_AssertCheck(stats.num_draws >= 3, "Verify at least 3 draws were counted, got %d", (int)stats.num_draws);
+    SDLTest_AssertCheck(stats.num_texture_changes == 2, "Verify 2 texture changes were counted, got %d", (int)stats.num_texture_changes);
+    SDLTest_AssertCheck(stats.num_commands_submitted == stats.num_draws + stats.num_clears + stats.num_state_changes, "Verify the submitted commands add up, got %d", (int)stats.num_commands_submitted);
+    SDLTest_AssertCheck(stats.num_commands_queued >= stats.num_commands_submitted, "Verify at least as many commands were queued as submitted");
+    SDLTest_AssertCheck(stats.upload_bytes == 16 * 16 * 4, "Verify %d bytes were uploaded, got %d", 16 * 16 * 4, (int)stats.upload_bytes);
+    SDLTest_AssertCheck(stats.vertex_bytes > 0, "Verify vertex data was counted");
+    SDLTest_AssertCheck(stats.flush_ns > 0 && stats.present_ns > 0, "Verify flushing and presenting were timed");
+    SDLTest_AssertCheck(stats.gpu_frame == 0, "Verify the software renderer doesn't report GPU time");
+
+    /* Each frame starts counting from zero */
+    SDL_RenderPresent(stats_renderer);
+    SDL_GetRenderStats(stats_renderer, &stats);
+    SDLTest_AssertCheck(stats.frame == 2 && stats.num_draws == 0 && stats.upload_bytes == 0, "Verify an empty frame has no draws or uploads");
+
+    SDLTest_AssertCheck(!SDL_GetRenderStats(stats_renderer, NULL), "Verify SDL_GetRenderStats() fails with NULL stats");
+    SDLTest_AssertCheck(!SDL_GetRenderStats(NULL, &stats), "Verify SDL_GetRenderStats(NULL) fails");
+
+done:
+    SDL_DestroyRenderer(stats_renderer);
+    SDL_DestroySurface(target);
+    return TEST_COMPLETED;
+}
+
+/**
+ * Tests SDL_UpdateTextureAsync and waiting on the uploads it starts
+ */
+static int SDLCALL render_testUpdateTextureAsync(void *arg)
+{
+    SDL_Surface *target = SDL_CreateSurface(16, 16, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Renderer *upload_renderer = target ? SDL_CreateSoftwareRenderer(target) : NULL;
+    SDL_Texture *texture = NULL;
+    SDL_Surface *result = NULL;
+    const SDL_Rect rect = { 4, 4, 8, 8 };
+    Uint32 pixels[8 * 8];
+    Uint64 first, second;
+    int i;
+
+    SDLTest_AssertCheck(upload_renderer != NULL, "Verify software renderer was created");
+    if (!upload_renderer) {
+        goto done;
+    }
+    texture = SDL_CreateTexture(upload_renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STATIC, 16, 16);
+    SDLTest_AssertCheck(texture != NULL, "Verify texture was created");
+    if (!texture) {
+        goto done;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+
+    for (i = 0; i < SDL_arraysize(pixels); ++i) {
+        pixels[i] = 0xFF0000FF;
+    }
+    first = SDL_UpdateTextureAsync(texture, NULL, pixels, 8 * sizeof(Uint32));
+    SDLTest_AssertCheck(first != 0, "Verify SDL_UpdateTextureAsync() returned a handle");
+
+    /* The pixels can be reused as soon as the call returns */
+    for (i = 0; i < SDL_arraysize(pixels); ++i) {
+        pixels[i] = 0xFF00FF00;
+    }
+    second = SDL_UpdateTextureAsync(texture, &rect, pixels, 8 * sizeof(Uint32));
+    SDLTest_AssertCheck(second > first, "Verify handles increase, got %d then %d", (int)first, (int)second);
+
+    SDLTest_AssertCheck(SDL_WaitForTextureUpload(upload_renderer, second), "Call to SDL_WaitForTextureUpload()");
+    SDLTest_AssertCheck(SDL_IsTextureUploadComplete(upload_renderer, first), "Verify an earlier upload is complete");
+
+    SDL_RenderTexture(upload_renderer, texture, NULL, NULL);
+    result = SDL_RenderReadPixels(upload_renderer, NULL);
+    SDLTest_AssertCheck(result != NULL, "Call to SDL_RenderReadPixels()");
+    if (result) {
+        Uint8 r, g, b, a;
+        SDL_ReadSurfacePixel(result, 2, 2, &r, &g, &b, &a);
+        SDLTest_AssertCheck(b == 255 && g == 0, "Verify the first upload landed, got %d,%d,%d", r, g, b);
+        SDL_ReadSurfacePixel(result, 8, 8, &r, &g, &b, &a);
+        SDLTest_AssertCheck(g == 255 && b == 0, "Verify the second upload landed over it, got %d,%d,%d", r, g, b);
+    }
+
+    SDLTest_AssertCheck(!SDL_IsTextureUploadComplete(upload_renderer, 0), "Verify a zero handle is rejected");
+    SDLTest_AssertCheck(!SDL_WaitForTextureUpload(upload_renderer, second + 1), "Verify a handle that wasn't returned is rejected");
+
+done:
+    SDL_DestroySurface(result);
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(upload_renderer);
+    SDL_DestroySurface(target);
+    return TEST_COMPLETED;
+}
+
+/**
+ * Tests the software renderer only sends the parts of the window that were drawn to
+ */
+static int SDLCALL render_testDirtyRectPresent(void *arg)
+{
+    SDL_Window *dirty_window = SDL_CreateWindow("render_testDirtyRectPresent", 64, 64, 0);
+    SDL_Renderer *dirty_renderer = dirty_window ? SDL_CreateRenderer(dirty_window, SDL_SOFTWARE_RENDERER) : NULL;
+    const SDL_FRect first = { 5.0f, 5.0f, 10.0f, 10.0f };
+    const SDL_FRect second = { 40.0f, 40.0f, 8.0f, 8.0f };
+    const SDL_FRect overlapping = { 10.0f, 10.0f, 10.0f, 10.0f };
+    SDL_RenderStats stats;
+
+    SDLTest_AssertCheck(dirty_renderer != NULL, "Verify software renderer was created");
+    if (!dirty_renderer) {
+        goto done;
+    }
+    SDL_SetRenderDrawColor(dirty_renderer, 255, 0, 0, 255);
+
+    /* A clear changes the whole window */
+    SDL_RenderClear(dirty_renderer);
+    SDL_RenderPresent(dirty_renderer);
+    SDL_GetRenderStats(dirty_renderer, &stats);
+    SDLTest_AssertCheck(stats.present_pixels == 64 * 64, "Verify a cleared frame sends %d pixels, got %d", 64 * 64, (int)stats.present_pixels);
+
+    SDL_RenderFillRect(dirty_renderer, &first);
+    SDL_RenderFillRect(dirty_renderer, &second);
+    SDL_RenderPresent(dirty_renderer);
+    SDL_GetRenderStats(dirty_renderer, &stats);
+    SDLTest_AssertCheck(stats.present_pixels == 10 * 10 + 8 * 8, "Verify only the filled rects are sent, got %d pixels", (int)stats.present_pixels);
+
+    SDL_RenderPresent(dirty_renderer);
+    SDL_GetRenderStats(dirty_renderer, &stats);
+    SDLTest_AssertCheck(stats.present_pixels == 0, "Verify an empty frame sends nothing, got %d pixels", (int)stats.present_pixels);
+
+    /* Overlapping draws are sent as the rect enclosing them */
+    SDL_RenderFillRect(dirty_renderer, &first);
+    SDL_RenderFillRect(dirty_renderer, &overlapping);
+    SDL_RenderPresent(dirty_renderer);
+    SDL_GetRenderStats(dirty_renderer, &stats);
+    SDLTest_AssertCheck(stats.present_pixels == 15 * 15, "Verify overlapping rects are merged, got %d pixels", (int)stats.present_pixels);
+
+    /* Drawing is clipped before it's counted */
+    SDL_RenderLine(dirty_renderer, -100.0f, 32.0f, 100.0f, 32.0f);
+    SDL_RenderPresent(dirty_renderer);
+    SDL_GetRenderStats(dirty_renderer, &stats);
+    SDLTest_AssertCheck(stats.present_pixels == 64, "Verify a clipped line sends one row, got %d pixels", (int)stats.present_pixels);
+
+done:
+    SDL_DestroyRenderer(dirty_renderer);
+    SDL_DestroyWindow(dirty_window);
+    return TEST_COMPLETED;
+}
+
+/* Fills a locked IYUV or NV12 area, with the chroma planes following the locked rows */
+static void FillLockedYUV(SDL_PixelFormat format, Uint8 *pixels, int pitch, int w, int h, Uint8 y, Uint8 u, Uint8 v)
+{
+    const int chroma_w = (w + 1) / 2;
+    const int chroma_h = (h + 1) / 2;
+    const int chroma_pitch = (pitch + 1) / 2;
+    Uint8 *chroma = pixels + h * pitch;
+    int row, col;
+
+    for (row = 0; row < h; ++row) {
+        SDL_memset(pixels + row * pitch, y, w);
+    }
+    for (row = 0; row < chroma_h; ++row) {
+        if (format == SDL_PIXELFORMAT_NV12) {
+            for (col = 0; col < chroma_w; ++col) {
+                chroma[row * chroma_pitch * 2 + col * 2 + 0] = u;
+                chroma[row * chroma_pitch * 2 + col * 2 + 1] = v;
+            }
+        } else {
+            SDL_memset(chroma + row * chroma_pitch, u, chroma_w);
+            SDL_memset(chroma + chroma_h * chroma_pitch + row * chroma_pitch, v, chroma_w);
+        }
+    }
+}
+
+/* Draws a 32x32 texture over the whole target and reads back the color of one of its texels */
+static Uint32 ReadRenderedTexel(SDL_Texture *texture, int x, int y)
+{
+    SDL_Surface *result;
+    Uint8 r = 0, g = 0, b = 0, a = 0;
+
+    SDL_RenderTexture(renderer, texture, NULL, NULL);
+    result = SDL_RenderReadPixels(renderer, NULL);
+    if (result) {
+        SDL_ReadSurfacePixel(result, (int)((x + 0.5f) * result->w / 32.0f), (int)((y + 0.5f) * result->h / 32.0f), &r, &g, &b, &a);
+        SDL_DestroySurface(result);
+    }
+    return ((Uint32)r << 16) | ((Uint32)g << 8) | b;
+}
+
+static Uint32 ReadFilledYUVTexel(SDL_PixelFormat format, Uint8 y, Uint8 u, Uint8 v)
+{
+    SDL_Texture *texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, 32, 32);
+    void *pixels = NULL;
+    int pitch = 0;
+    Uint32 color = 0;
+
+    if (texture && SDL_LockTexture(texture, NULL, &pixels, &pitch)) {
+        FillLockedYUV(format, (Uint8 *)pixels, pitch, 32, 32, y, u, v);
+        SDL_UnlockTexture(texture);
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+        color = ReadRenderedTexel(texture, 16, 16);
+    }
+    SDL_DestroyTexture(texture);
+    return color;
+}
+
+/* Partial locks of planar textures either fail, or upload the chroma planes that follow the locked rows */
+static void CheckPartialYUVLock(SDL_PixelFormat format)
+{
+    static const SDL_Rect rect = { 0, 8, 32, 8 };
+    const Uint32 outside = ReadFilledYUVTexel(format, 80, 90, 240);
+    const Uint32 inside = ReadFilledYUVTexel(format, 160, 200, 60);
+    SDL_Texture *texture = SDL_CreateTexture(renderer, format, SDL_TEXTUREACCESS_STREAMING, 32, 32);
+    void *pixels = NULL;
+    int pitch = 0;
+
+    SDLTest_AssertCheck(texture != NULL, "Verify %s streaming texture was created", SDL_GetPixelFormatName(format));
+    if (!texture) {
+        return;
+    }
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+
+    if (SDL_LockTexture(texture, NULL, &pixels, &pitch)) {
+        FillLockedYUV(format, (Uint8 *)pixels, pitch, 32, 32, 80, 90, 240);
+        SDL_UnlockTexture(texture);
+    }
+
+    SDL_ClearError();
+    if (SDL_LockTexture(texture, &rect, &pixels, &pitch)) {
+        FillLockedYUV(format, (Uint8 *)pixels, pitch, rect.w, rect.h, 160, 200, 60);
+        SDL_UnlockTexture(texture);
+
+        SDLTest_AssertCheck(ReadRenderedTexel(texture, 16, 12) == inside, "Verify the partial %s lock was uploaded", SDL_GetPixelFormatName(format));
+        SDLTest_AssertCheck(ReadRenderedTexel(texture, 16, 4) == outside && ReadRenderedTexel(texture, 16, 20) == outside, "Verify the partial %s lock only changed the locked rows", SDL_GetPixelFormatName(format));
+    } else {
+        SDLTest_AssertCheck(*SDL_GetError() != '\0', "Verify the partial %s lock was refused with an error", SDL_GetPixelFormatName(format));
+        SDLTest_AssertCheck(ReadRenderedTexel(texture, 16, 12) == outside, "Verify the refused %s lock left the texture alone", SDL_GetPixelFormatName(format));
+    }
+    SDL_DestroyTexture(texture);
+}
+
+/**
+ * Tests partial locks of a streaming texture, more of them than the backend has buffers to lock into
+ */
+static int SDLCALL render_testStreamingLocks(void *arg)
+{
+    static const SDL_Rect rects[] = {
+        { 0, 0, 32, 32 }, { 4, 4, 8, 8 }, { 20, 2, 6, 24 }, { 0, 28, 32, 4 }, { 12, 12, 1, 1 }
+    };
+    static const Uint32 colors[] = { 0xFFFF0000, 0xFF00FF00, 0xFF0000FF, 0xFFFFFFFF, 0xFF808080 };
+    SDL_Texture *texture;
+    SDL_Surface *result = NULL;
+    int i, x, y;
+
+    texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, 32, 32);
+    SDLTest_AssertCheck(texture != NULL, "Verify streaming texture was created");
+    if (!texture) {
+        return TEST_ABORTED;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
+    SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+
+    for (i = 0; i < SDL_arraysize(rects); ++i) {
+        void *pixels = NULL;
+        int pitch = 0;
+
+        SDLTest_AssertCheck(SDL_LockTexture(texture, &rects[i], &pixels, &pitch), "Call to SDL_LockTexture()");
+        if (!pixels) {
+            continue;
+        }
+        for (y = 0; y < rects[i].h; ++y) {
+            Uint32 *row = (Uint32 *)((Uint8 *)pixels + y * pitch);
+            for (x = 0; x < rects[i].w; ++x) {
+                row[x] = colors[i];
+            }
+        }
+        SDL_UnlockTexture(texture);
+
+        /* Draw in between, so the texture is in use while it's locked again */
+        SDL_RenderTexture(renderer, texture, NULL, NULL);
+    }
+
+    SDL_RenderTexture(renderer, texture, NULL, NULL);
+    result = SDL_RenderReadPixels(renderer, NULL);
+    SDLTest_AssertCheck(result != NULL, "Call to SDL_RenderReadPixels()");
+    if (result) {
+        static const struct
+        {
+            int x, y;
+            Uint32 color;
+        } expected[] = {
+            { 0, 0, 0xFFFF0000 }, { 5, 5, 0xFF00FF00 }, { 22, 10, 0xFF0000FF }, { 1, 30, 0xFFFFFFFF }, { 12, 12, 0xFF808080 }, { 30, 20, 0xFFFF0000 }
+        };
+        const float scale_x = (float)result->w / 32.0f;
+        const float scale_y = (float)result->h / 32.0f;
+
+        for (i = 0; i < SDL_arraysize(expected); ++i) {
+            Uint8 r, g, b, a;
+            Uint32 pixel;
+
+            SDL_ReadSurfacePixel(result, (int)((expected[i].x + 0.5f) * scale_x), (int)((expected[i].y + 0.5f) * scale_y), &r, &g, &b, &a);
+            pixel = 0xFF000000 | ((Uint32)r << 16) | ((Uint32)g << 8) | b;
+            SDLTest_AssertCheck(pixel == expected[i].color, "Verify texel %d,%d is 0x%.8" SDL_PRIx32 ", got 0x%.8" SDL_PRIx32, expected[i].x, expected[i].y, expected[i].color, pixel);
+        }
+        SDL_DestroySurface(result);
+    }
+
+    SDL_DestroyTexture(texture);
+
+    CheckPartialYUVLock(SDL_PIXELFORMAT_IYUV);
+    CheckPartialYUVLock(SDL_PIXELFORMAT_NV12);
+    return TEST_COMPLETED;
+}
+
+#define TRIANGLE_FLAT     0
+#define TRIANGLE_GRADIENT 1
+#define TRIANGLE_TEXTURED 2
+
+/* Lone triangles, none of them pairs up into a rectangle */
+static const float triangle_positions[4][3][2] = {
+    { { 0.0f, 0.0f }, { 300.0f, 0.0f }, { 0.0f, 250.0f } },
+    { { 320.0f, 256.0f }, { 60.0f, 256.0f }, { 320.0f, 40.0f } },
+    { { 170.0f, 8.0f }, { 310.0f, 150.0f }, { 24.0f, 232.0f } },
+    { { 16.0f, 70.0f }, { 150.0f, 14.0f }, { 260.0f, 246.0f } }
+};
+
+static void GetTriangleTestVertices(int kind, bool blended, int triangle, SDL_Vertex vertices[3])
+{
+    static const float base[4][3] = {
+        { 200.0f, 60.0f, 40.0f }, { 50.0f, 190.0f, 70.0f }, { 60.0f, 80.0f, 210.0f }, { 180.0f, 170.0f, 60.0f }
+    };
+    static const float offset[3][3] = {
+        { 0.0f, 0.0f, 0.0f }, { 40.0f, -50.0f, 30.0f }, { -30.0f, 45.0f, -40.0f }
+    };
+    int i, c;
+
+    for (i = 0; i < 3; ++i) {
+        float color[3];
+
+        for (c = 0; c < 3; ++c) {
+            if (kind == TRIANGLE_TEXTURED) {
+                color[c] = 255.0f;
+            } else if (kind == TRIANGLE_GRADIENT) {
+                color[c] = base[triangle][c] + offset[i][c];
+            } else {
+                color[c] = base[triangle][c];
+            }
+        }
+        vertices[i].position.x = triangle_positions[triangle][i][0];
+        vertices[i].position.y = triangle_positions[triangle][i][1];
+        vertices[i].color.r = color[0] / 255.0f;
+        vertices[i].color.g = color[1] / 255.0f;
+        vertices[i].color.b = color[2] / 255.0f;
+        vertices[i].color.a = blended ? 160.0f / 255.0f : 1.0f;
+        vertices[i].tex_coord.x = vertices[i].position.x / 64.0f;
+        vertices[i].tex_coord.y = vertices[i].position.y / 64.0f;
+    }
+}
+
+/* A 64x64 texture of 8x8 cells */
+static void GetTriangleTestTexel(int x, int y, Uint8 *r, Uint8 *g, Uint8 *b)
+{
+    *r = (Uint8)((x / 8) * 32);
+    *g = (Uint8)((y / 8) * 32);
+    *b = (Uint8)(255 - (x / 8 + y / 8) * 16);
+}
+
+static bool DrawTriangleTestScene(SDL_Surface *surface, int kind, bool blended)
+{
+    SDL_Renderer *target = SDL_CreateSoftwareRenderer(surface);
+    SDL_Texture *texture = NULL;
+    SDL_Vertex vertices[12];
+    bool result;
+    int i;
+
+    if (!target) {
+        return false;
+    }
+
+    if (kind == TRIANGLE_TEXTURED) {
+        SDL_Surface *cells = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_ARGB8888);
+        int x, y;
+
+        if (!cells) {
+            SDL_DestroyRenderer(target);
+            return false;
+        }
+        for (y = 0; y < cells->h; ++y) {
+            for (x = 0; x < cells->w; ++x) {
+                Uint8 r, g, b;
+
+                GetTriangleTestTexel(x, y, &r, &g, &b);
+                SDL_WriteSurfacePixel(cells, x, y, r, g, b, 255);
+            }
+        }
+        texture = SDL_CreateTextureFromSurface(target, cells);
+        SDL_DestroySurface(cells);
+        if (!texture) {
+            SDL_DestroyRenderer(target);
+            return false;
+        }
+        SDL_SetTextureScaleMode(texture, SDL_SCALEMODE_NEAREST);
+        SDL_SetTextureBlendMode(texture, blended ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+        SDL_SetRenderTextureAddressMode(target, SDL_TEXTURE_ADDRESS_WRAP, SDL_TEXTURE_ADDRESS_WRAP);
+    }
+
+    SDL_SetRenderDrawBlendMode(target, SDL_BLENDMODE_NONE);
+    SDL_SetRenderDrawColor(target, 60, 70, 80, 255);
+    SDL_RenderClear(target);
+    SDL_SetRenderDrawBlendMode(target, blended ? SDL_BLENDMODE_BLEND : SDL_BLENDMODE_NONE);
+
+    for (i = 0; i < 4; ++i) {
+        GetTriangleTestVertices(kind, blended, i, &vertices[i * 3]);
+    }
+    result = SDL_RenderGeometry(target, texture, vertices, SDL_arraysize(vertices), NULL, 0);
+    SDL_RenderPresent(target);
+
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(target);
+    return result;
+}
+
+/* Returns false if the color can't be predicted because the pixel center is near an edge */
+static bool GetTriangleTestPixel(int kind, bool blended, int x, int y, float expected[3])
+{
+    const float px = x + 0.5f, py = y + 0.5f;
+    int i, j, c;
+
+    expected[0] = 60.0f;
+    expected[1] = 70.0f;
+    expected[2] = 80.0f;
+
+    for (i = 0; i < 4; ++i) {
+        SDL_Vertex v[3];
+        float area, weight[3], distance = 1000.0f;
+        float color[3], alpha;
+
+        GetTriangleTestVertices(kind, blended, i, v);
+        area = (v[1].position.x - v[0].position.x) * (v[2].position.y - v[0].position.y) -
+               (v[1].position.y - v[0].position.y) * (v[2].position.x - v[0].position.x);
+        for (j = 0; j < 3; ++j) {
+            const SDL_FPoint *a = &v[(j + 1) % 3].position;
+            const SDL_FPoint *b = &v[(j + 2) % 3].position;
+            const float cross = (b->x - a->x) * (py - a->y) - (b->y - a->y) * (px - a->x);
+            const float length = SDL_sqrtf((b->x - a->x) * (b->x - a->x) + (b->y - a->y) * (b->y - a->y));
+
+            weight[j] = cross / area;
+            distance = SDL_min(distance, weight[j] * SDL_fabsf(area) / length);
+        }
+        if (distance < -1.0f) {
+            continue;
+        } else if (distance <= 1.0f) {
+            return false;
+        }
+
+        if (kind == TRIANGLE_TEXTURED) {
+            float u = 0.0f, tv = 0.0f;
+            int tx, ty;
+            Uint8 r, g, b;
+
+            for (j = 0; j < 3; ++j) {
+                u += weight[j] * v[j].tex_coord.x * 64.0f;
+                tv += weight[j] * v[j].tex_coord.y * 64.0f;
+            }
+            /* Texels next to a cell boundary may land in either cell */
+            if (SDL_fabsf(u - 8.0f * SDL_roundf(u / 8.0f)) < 1.0f ||
+                SDL_fabsf(tv - 8.0f * SDL_roundf(tv / 8.0f)) < 1.0f) {
+                return false;
+            }
+            tx = (int)SDL_floorf(u) & 63;
+            ty = (int)SDL_floorf(tv) & 63;
+            GetTriangleTestTexel(tx, ty, &r, &g, &b);
+            color[0] = r;
+            color[1] = g;
+            color[2] = b;
+        } else {
+            color[0] = color[1] = color[2] = 0.0f;
+            for (j = 0; j < 3; ++j) {
+                color[0] += weight[j] * v[j].color.r * 255.0f;
+                color[1] += weight[j] * v[j].color.g * 255.0f;
+                color[2] += weight[j] * v[j].color.b * 255.0f;
+            }
+        }
+
+        /* Blended layers are truncated to whole steps before the next one is blended over them */
+        alpha = 160.0f / 255.0f;
+        for (c = 0; c < 3; ++c) {
+            if (blended) {
+                expected[c] = SDL_floorf(color[c] * alpha + expected[c] * (1.0f - alpha));
+            } else {
+                expected[c] = color[c];
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * Tests flat, gradient and textured triangles drawn in bands match triangles drawn in one pass and the reference colors.
+ */
+static int SDLCALL render_testSoftwareTriangles(void *arg)
+{
+    static const SDL_PixelFormat formats[] = { SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ABGR8888 };
+    static const char *kinds[] = { "flat", "gradient", "textured" };
+    int i, kind, blended, x, y;
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        for (kind = 0; kind < SDL_arraysize(kinds); ++kind) {
+            for (blended = 0; blended <= 1; ++blended) {
+                /* 320x256 is large enough for the batch to be split into bands */
+                SDL_Surface *banded = SDL_CreateSurface(320, 256, formats[i]);
+                SDL_Surface *single = SDL_CreateSurface(320, 256, formats[i]);
+                const int tolerance = blended ? 2 : 1;
+                bool drawn, same = true;
+                int checked = 0, max_error = 0;
+
+                SDLTest_AssertCheck(banded && single, "Verify surfaces were created for %s", SDL_GetPixelFormatName(formats[i]));
+                if (!banded || !single) {
+                    SDL_DestroySurface(banded);
+                    SDL_DestroySurface(single);
+                    return TEST_ABORTED;
+                }
+
+                SDL_SetHint(SDL_HINT_WORKER_THREADS, "4");
+                drawn = DrawTriangleTestScene(banded, kind, blended != 0);
+                SDL_SetHint(SDL_HINT_WORKER_THREADS, "1");
+                drawn = DrawTriangleTestScene(single, kind, blended != 0) && drawn;
+                SDL_ResetHint(SDL_HINT_WORKER_THREADS);
+                SDLTest_AssertCheck(drawn, "Verify %s%s triangles were drawn on %s", blended ? "blended " : "", kinds[kind], SDL_GetPixelFormatName(formats[i]));
+
+                for (y = 0; y < banded->h; ++y) {
+                    if (SDL_memcmp((Uint8 *)banded->pixels + y * banded->pitch, (Uint8 *)single->pixels + y * single->pitch, banded->w * SDL_BYTESPERPIXEL(formats[i])) != 0) {
+                        same = false;
+                    }
+                }
+                SDLTest_AssertCheck(same, "Verify %s%s triangles drawn in bands match triangles drawn in one pass on %s", blended ? "blended " : "", kinds[kind], SDL_GetPixelFormatName(formats[i]));
+
+                /* Colors are within one step per channel of the exact result, plus rounding when blended */
+                for (y = 0; y < banded->h; ++y) {
+                    for (x = 0; x < banded->w; ++x) {
+                        float expected[3];
+                        Uint8 actual[3];
+                        int c;
+
+                        if (!GetTriangleTestPixel(kind, blended != 0, x, y, expected)) {
+                            continue;
+                        }
+                        SDL_ReadSurfacePixel(banded, x, y, &actual[0], &actual[1], &actual[2], NULL);
+                        for (c = 0; c < 3; ++c) {
+                            const int error = (int)SDL_ceilf(SDL_fabsf(actual[c] - expected[c]) - 0.5f);
+
+                            max_error = SDL_max(max_error, error);
+                        }
+                        ++checked;
+                    }
+                }
+                SDLTest_AssertCheck(checked > banded->w * banded->h / 2, "Verify most pixels were checked, got %d", checked);
+                SDLTest_AssertCheck(max_error <= tolerance, "Verify %s%s triangles on %s are within %d of the reference, got %d", blended ? "blended " : "", kinds[kind], SDL_GetPixelFormatName(formats[i]), tolerance, max_error);
+
+                SDL_DestroySurface(banded);
+                SDL_DestroySurface(single);
+            }
+        }
+    }
+    return TEST_COMPLETED;
+}
+
 /**
  * Test clip rect
  */
@@ -2375,6 +3747,54 @@ static const SDLTest_TestCaseReference renderTestRGBSurfaceNoAlpha = {
     render_testRGBSurfaceNoAlpha, "render_testRGBSurfaceNoAlpha", "Tests RGB surface with no alpha using software renderer", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference renderTestSoftwareBlendedSpans = {
+    render_testSoftwareBlendedSpans, "render_testSoftwareBlendedSpans", "Tests blended rectangles and lines match points using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestCommandMerging = {
+    render_testCommandMerging, "render_testCommandMerging", "Tests merged render commands draw the same as unmerged ones using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestRenderSprites = {
+    render_testRenderSprites, "render_testRenderSprites", "Tests SDL_RenderSprites matches drawing textures one at a time using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestRenderSpritesGeometry = {
+    render_testRenderSpritesGeometry, "render_testRenderSpritesGeometry", "Tests SDL_RenderSprites drawn as geometry matches drawing textures one at a time using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestTextureAtlas = {
+    render_testTextureAtlas, "render_testTextureAtlas", "Tests textures packed into an atlas draw the same as separate textures using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestDeferredRenderer = {
+    render_testDeferredRenderer, "render_testDeferredRenderer", "Tests deferred renderers recorded on other threads draw the same as drawing directly using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestDebugTexts = {
+    render_testDebugTexts, "render_testDebugTexts", "Tests SDL_RenderDebugTexts matches drawing strings one at a time using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestRenderStats = {
+    render_testRenderStats, "render_testRenderStats", "Tests SDL_GetRenderStats counts the commands and uploads of a frame using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestUpdateTextureAsync = {
+    render_testUpdateTextureAsync, "render_testUpdateTextureAsync", "Tests SDL_UpdateTextureAsync uploads in order and its handles can be waited on using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestDirtyRectPresent = {
+    render_testDirtyRectPresent, "render_testDirtyRectPresent", "Tests only the parts of the window that were drawn to are presented using software renderer", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestStreamingLocks = {
+    render_testStreamingLocks, "render_testStreamingLocks", "Tests partial locks of a streaming texture are each uploaded", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference renderTestSoftwareTriangles = {
+    render_testSoftwareTriangles, "render_testSoftwareTriangles", "Tests flat, gradient and textured triangles drawn in bands using software renderer", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference renderTestColorspaceLinear = {
     render_testColorspaceLinear, "render_testColorspaceLinear", "Tests colorspace support (sRGB -> linear)", TEST_ENABLED
 };
@@ -2402,6 +3822,18 @@ static const SDLTest_TestCaseReference *renderTests[] = {
     &renderTestTextureState,
     &renderTestGetSetTextureScaleMode,
     &renderTestRGBSurfaceNoAlpha,
+    &renderTestSoftwareBlendedSpans,
+    &renderTestCommandMerging,
+    &renderTestRenderSprites,
+    &renderTestRenderSpritesGeometry,
+    &renderTestTextureAtlas,
+    &renderTestDeferredRenderer,
+    &renderTestDebugTexts,
+    &renderTestRenderStats,
+    &renderTestUpdateTextureAsync,
+    &renderTestDirtyRectPresent,
+    &renderTestStreamingLocks,
+    &renderTestSoftwareTriangles,
     &renderTestColorspaceLinear,
     &renderTestColorspaceSRGB,
     NULL
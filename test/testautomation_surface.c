@@ -948,6 +948,105 @@ static int SDLCALL surface_testSurfaceRLEPixels(void *arg)
     return TEST_COMPLETED;
 }
 
+/* Fill a sprite with transparent, translucent and opaque runs, blank lines in the middle and at the bottom */
+static void fillRLETestSprite(SDL_Surface *sprite)
+{
+    int x, y;
+
+    for (y = 0; y < sprite->h; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)sprite->pixels + y * sprite->pitch);
+        for (x = 0; x < sprite->w; ++x) {
+            Uint8 a;
+            if (y == sprite->h / 3 || y >= sprite->h - 5 || ((x / 7 + y / 5) % 3) == 0) {
+                a = SDL_ALPHA_TRANSPARENT;
+            } else if ((x / 3 + y) % 4 == 0) {
+                a = (Uint8)(x * 255 / sprite->w) | 1;
+            } else {
+                a = SDL_ALPHA_OPAQUE;
+            }
+            row[x] = SDL_MapSurfaceRGBA(sprite, (Uint8)(x * 4), (Uint8)(y * 5), (Uint8)(x ^ y), a);
+        }
+    }
+}
+
+/**
+ *  Tests that clipped blits from RLE surfaces match the unclipped blit
+ */
+static int SDLCALL surface_testRLEClippedBlit(void *arg)
+{
+    const struct
+    {
+        SDL_PixelFormat src_format;
+        SDL_PixelFormat dst_format;
+        bool colorkey;
+        Uint8 alpha;
+    } cases[] = {
+        { SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XRGB8888, true, 255 },
+        { SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XRGB8888, true, 128 },
+        { SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_XRGB8888, true, 77 },
+        { SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB565, true, 255 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_XRGB8888, false, 255 },
+        { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565, false, 255 },
+    };
+    const SDL_Rect clips[] = {
+        { 0, 0, 67, 45 }, { 0, 13, 67, 20 }, { 5, 0, 40, 45 }, { 9, 14, 31, 17 }, { 0, 40, 67, 5 }, { 66, 44, 1, 1 },
+    };
+    int i, c, y;
+
+    for (i = 0; i < SDL_arraysize(cases); ++i) {
+        SDL_Surface *sprite = SDL_CreateSurface(67, 45, SDL_PIXELFORMAT_ARGB8888);
+        SDL_Surface *source = NULL, *expected = NULL, *actual = NULL;
+        const int bpp = SDL_BYTESPERPIXEL(cases[i].dst_format);
+
+        SDLTest_AssertCheck(sprite != NULL, "SDL_CreateSurface()");
+        if (!sprite) {
+            continue;
+        }
+        fillRLETestSprite(sprite);
+        source = SDL_ConvertSurface(sprite, cases[i].src_format);
+        expected = SDL_CreateSurface(80, 60, cases[i].dst_format);
+        actual = SDL_CreateSurface(80, 60, cases[i].dst_format);
+        SDLTest_AssertCheck(source && expected && actual, "Create test surfaces");
+        if (source && expected && actual) {
+            const SDL_Rect dstrect = { 7, 9, 0, 0 };
+
+            if (cases[i].colorkey) {
+                SDL_SetSurfaceColorKey(source, true, SDL_MapSurfaceRGB(source, 0, 0, 0));
+                SDL_SetSurfaceAlphaMod(source, cases[i].alpha);
+            }
+            SDL_SetSurfaceRLE(source, true);
+            SDL_FillSurfaceRect(expected, NULL, SDL_MapSurfaceRGB(expected, 40, 200, 90));
+            CHECK_FUNC(SDL_BlitSurface, (source, NULL, expected, &dstrect));
+            SDLTest_AssertCheck(SDL_MUSTLOCK(source), "Verify the source surface was RLE encoded");
+
+            for (c = 0; c < SDL_arraysize(clips); ++c) {
+                SDL_Rect r = clips[c];
+                SDL_Rect d = { dstrect.x + r.x, dstrect.y + r.y, 0, 0 };
+                int mismatches = 0;
+
+                SDL_FillSurfaceRect(actual, NULL, SDL_MapSurfaceRGB(actual, 40, 200, 90));
+                CHECK_FUNC(SDL_BlitSurface, (source, &r, actual, &d));
+                for (y = 0; y < r.h; ++y) {
+                    if (SDL_memcmp((Uint8 *)expected->pixels + (d.y + y) * expected->pitch + d.x * bpp,
+                                   (Uint8 *)actual->pixels + (d.y + y) * actual->pitch + d.x * bpp,
+                                   (size_t)r.w * bpp) != 0) {
+                        ++mismatches;
+                    }
+                }
+                SDLTest_AssertCheck(mismatches == 0, "Clipped RLE blit %s -> %s (alpha %d) of {%d,%d,%d,%d}, expected 0 mismatched rows, got %d",
+                                    SDL_GetPixelFormatName(cases[i].src_format), SDL_GetPixelFormatName(cases[i].dst_format),
+                                    cases[i].alpha, r.x, r.y, r.w, r.h, mismatches);
+            }
+        }
+        SDL_DestroySurface(sprite);
+        SDL_DestroySurface(source);
+        SDL_DestroySurface(expected);
+        SDL_DestroySurface(actual);
+    }
+
+    return TEST_COMPLETED;
+}
+
 /**
  *  Tests surface conversion.
  */
@@ -1950,6 +2049,147 @@ static int SDLCALL surface_testPremultiplyAlpha(void *arg)
 }
 
 
+static int SDLCALL surface_testUnpremultiplyAlpha(void *arg)
+{
+    const int widths[] = { 256, 253 };
+    SDL_Surface *surface, *premultiplied, *unpremultiplied, *swizzled;
+    int w, x, y, ret, mismatches;
+
+    /* Every alpha and color combination, one alpha value per row */
+    surface = SDL_CreateSurface(256, 256, SDL_PIXELFORMAT_ARGB8888);
+    premultiplied = SDL_CreateSurface(256, 256, SDL_PIXELFORMAT_ARGB8888);
+    unpremultiplied = SDL_CreateSurface(256, 256, SDL_PIXELFORMAT_ARGB8888);
+    swizzled = SDL_CreateSurface(256, 256, SDL_PIXELFORMAT_ABGR8888);
+    SDLTest_AssertCheck(surface && premultiplied && unpremultiplied && swizzled, "SDL_CreateSurface()");
+    if (!surface || !premultiplied || !unpremultiplied || !swizzled) {
+        goto done;
+    }
+    for (y = 0; y < 256; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+        for (x = 0; x < 256; ++x) {
+            row[x] = ((Uint32)y << 24) | ((Uint32)x << 16) | ((Uint32)(255 - x) << 8) | (Uint32)(x ^ 0x5A);
+        }
+    }
+
+    /* Odd widths exercise the remaining columns of the vectorized code */
+    for (w = 0; w < SDL_arraysize(widths); ++w) {
+        const int width = widths[w];
+
+        SDL_FillSurfaceRect(premultiplied, NULL, 0);
+        SDL_FillSurfaceRect(unpremultiplied, NULL, 0);
+        ret = SDL_PremultiplyAlpha(width, 256, surface->format, surface->pixels, surface->pitch, premultiplied->format, premultiplied->pixels, premultiplied->pitch, false);
+        SDLTest_AssertCheck(ret == true, "SDL_PremultiplyAlpha(%d)", width);
+        ret = SDL_UnpremultiplyAlpha(width, 256, premultiplied->format, premultiplied->pixels, premultiplied->pitch, unpremultiplied->format, unpremultiplied->pixels, unpremultiplied->pitch, false);
+        SDLTest_AssertCheck(ret == true, "SDL_UnpremultiplyAlpha(%d)", width);
+
+        mismatches = 0;
+        for (y = 0; y < 256; ++y) {
+            const Uint32 *src = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+            const Uint32 *pre = (const Uint32 *)((const Uint8 *)premultiplied->pixels + y * premultiplied->pitch);
+            const Uint32 *unpre = (const Uint32 *)((const Uint8 *)unpremultiplied->pixels + y * unpremultiplied->pitch);
+            const Uint32 a = (Uint32)y;
+            for (x = 0; x < width; ++x) {
+                Uint32 expected = (a << 24);
+                Uint32 expected_unpre = (a << 24);
+                int shift;
+                for (shift = 0; shift < 24; shift += 8) {
+                    const Uint32 c = (src[x] >> shift) & 0xFF;
+                    const Uint32 p = (a * c) / 255;
+                    expected |= (p << shift);
+                    if (a) {
+                        expected_unpre |= (SDL_min((p * 255 + a / 2) / a, 255) << shift);
+                    }
+                }
+                if (pre[x] != expected || unpre[x] != expected_unpre) {
+                    ++mismatches;
+                }
+            }
+        }
+        SDLTest_AssertCheck(mismatches == 0, "Checking ARGB8888 alpha premultiply and unpremultiply at width %d, got %d mismatches", width, mismatches);
+    }
+
+    /* Straight alpha colors survive a round trip within rounding */
+    mismatches = 0;
+    for (y = 0; y < 256; ++y) {
+        const Uint32 *src = (const Uint32 *)((const Uint8 *)surface->pixels + y * surface->pitch);
+        const Uint32 *unpre = (const Uint32 *)((const Uint8 *)unpremultiplied->pixels + y * unpremultiplied->pitch);
+        for (x = 0; x < 253; ++x) {
+            int shift;
+            for (shift = 0; shift < 24; shift += 8) {
+                const int c = (int)((src[x] >> shift) & 0xFF);
+                const int u = (int)((unpre[x] >> shift) & 0xFF);
+                /* Each premultiplied step loses up to 255 / alpha */
+                if (y > 0 && SDL_abs(c - u) > (255 + y - 1) / y) {
+                    ++mismatches;
+                }
+            }
+        }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Checking alpha unpremultiply round trip, got %d mismatches", mismatches);
+
+    /* Linear alpha on the same format matches the path through a different format */
+    ret = SDL_PremultiplyAlpha(256, 256, surface->format, surface->pixels, surface->pitch, premultiplied->format, premultiplied->pixels, premultiplied->pitch, true);
+    SDLTest_AssertCheck(ret == true, "SDL_PremultiplyAlpha(linear)");
+    ret = SDL_PremultiplyAlpha(256, 256, surface->format, surface->pixels, surface->pitch, swizzled->format, swizzled->pixels, swizzled->pitch, true);
+    SDLTest_AssertCheck(ret == true, "SDL_PremultiplyAlpha(linear, swizzled)");
+    ret = SDL_ConvertPixels(256, 256, swizzled->format, swizzled->pixels, swizzled->pitch, unpremultiplied->format, unpremultiplied->pixels, unpremultiplied->pitch);
+    SDLTest_AssertCheck(ret == true, "SDL_ConvertPixels()");
+    mismatches = 0;
+    for (y = 0; y < 256; ++y) {
+        if (SDL_memcmp((Uint8 *)premultiplied->pixels + y * premultiplied->pitch, (Uint8 *)unpremultiplied->pixels + y * unpremultiplied->pitch, 256 * 4) != 0) {
+            ++mismatches;
+        }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Checking linear alpha premultiply, got %d mismatched rows", mismatches);
+
+    ret = SDL_UnpremultiplyAlpha(256, 256, premultiplied->format, premultiplied->pixels, premultiplied->pitch, unpremultiplied->format, unpremultiplied->pixels, unpremultiplied->pitch, true);
+    SDLTest_AssertCheck(ret == true, "SDL_UnpremultiplyAlpha(linear)");
+    ret = SDL_UnpremultiplyAlpha(256, 256, premultiplied->format, premultiplied->pixels, premultiplied->pitch, swizzled->format, swizzled->pixels, swizzled->pitch, true);
+    SDLTest_AssertCheck(ret == true, "SDL_UnpremultiplyAlpha(linear, swizzled)");
+    ret = SDL_ConvertPixels(256, 256, swizzled->format, swizzled->pixels, swizzled->pitch, premultiplied->format, premultiplied->pixels, premultiplied->pitch);
+    SDLTest_AssertCheck(ret == true, "SDL_ConvertPixels()");
+    mismatches = 0;
+    for (y = 0; y < 256; ++y) {
+        if (SDL_memcmp((Uint8 *)premultiplied->pixels + y * premultiplied->pitch, (Uint8 *)unpremultiplied->pixels + y * unpremultiplied->pitch, 256 * 4) != 0) {
+            ++mismatches;
+        }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Checking linear alpha unpremultiply, got %d mismatched rows", mismatches);
+
+done:
+    SDL_DestroySurface(surface);
+    SDL_DestroySurface(premultiplied);
+    SDL_DestroySurface(unpremultiplied);
+    SDL_DestroySurface(swizzled);
+
+    /* Floating point surfaces */
+    surface = SDL_CreateSurface(3, 1, SDL_PIXELFORMAT_ARGB128_FLOAT);
+    SDLTest_AssertCheck(surface != NULL, "SDL_CreateSurface()");
+    if (surface) {
+        const float expected[3][4] = {
+            { 0.5f, 0.25f, 0.125f, 0.5f },
+            { 0.0f, 0.0f, 0.0f, 0.0f },
+            { 1.0f, 0.75f, 0.5f, 0.25f }
+        };
+        float *pixels = (float *)surface->pixels;
+
+        SDL_memcpy(pixels, expected, sizeof(expected));
+        pixels[4 + 1] = 0.5f; /* Color with zero alpha becomes zero */
+
+        /* Float surfaces are linear, so this doesn't do any colorspace conversion */
+        ret = SDL_PremultiplySurfaceAlpha(surface, true);
+        SDLTest_AssertCheck(ret == true, "SDL_PremultiplySurfaceAlpha()");
+        SDLTest_AssertCheck(pixels[0] == 0.5f && pixels[1] == 0.125f && pixels[2] == 0.0625f && pixels[3] == 0.25f,
+                            "Checking float alpha premultiply, got %g,%g,%g,%g", pixels[0], pixels[1], pixels[2], pixels[3]);
+        ret = SDL_UnpremultiplySurfaceAlpha(surface, true);
+        SDLTest_AssertCheck(ret == true, "SDL_UnpremultiplySurfaceAlpha()");
+        SDLTest_AssertCheck(SDL_memcmp(pixels, expected, sizeof(expected)) == 0, "Checking float alpha unpremultiply");
+        SDL_DestroySurface(surface);
+    }
+
+    return TEST_COMPLETED;
+}
+
 static int SDLCALL surface_testScale(void *arg)
 {
     SDL_PixelFormat formats[] = {
@@ -2058,6 +2298,230 @@ static Uint32 Calculate565toARGB(int v, const SDL_PixelFormatDetails *fmt)
             Calculate(b, 5, 31, fmt->Bshift);
 }
 
+/* Reference implementation of the original per-pixel rotation, used to validate the optimized paths */
+static void referenceRotate(SDL_Surface *src, SDL_Surface *dst, float fangle)
+{
+    const int bpp = SDL_BYTESPERPIXEL(src->format);
+    const double angle = fangle;
+    const double radangle = angle * (SDL_PI_D / 180.0);
+    const double sinangle = SDL_sin(radangle);
+    const double cosangle = SDL_cos(radangle);
+    const SDL_FPoint center = { src->w * 0.5f, src->h * 0.5f };
+    const int fp_half = (1 << 15);
+    double px[4], py[4];
+    double minx, miny;
+    int isin, icos, cx, cy, i, x, y;
+
+    for (i = 0; i < 4; ++i) {
+        double sx = ((i & 1) ? (src->w - 0.5) : 0.5) - center.x;
+        double sy = ((i & 2) ? (src->h - 0.5) : 0.5) - center.y;
+        px[i] = cosangle * sx - sinangle * sy + center.x;
+        py[i] = sinangle * sx + cosangle * sy + center.y;
+    }
+    minx = SDL_floor(SDL_min(SDL_min(px[0], px[1]), SDL_min(px[2], px[3])));
+    miny = SDL_floor(SDL_min(SDL_min(py[0], py[1]), SDL_min(py[2], py[3])));
+
+    isin = (int)(-sinangle * 65536.0);
+    icos = (int)(cosangle * 65536.0);
+    cx = (int)(center.x * 65536.0);
+    cy = (int)(center.y * 65536.0);
+
+    for (y = 0; y < dst->h; y++) {
+        Uint8 *pc = (Uint8 *)dst->pixels + dst->pitch * y;
+        double src_x = ((double)(int)minx + 0.5 - center.x);
+        double src_y = ((double)(int)miny + y + 0.5 - center.y);
+        int sdx = (int)((icos * src_x - isin * src_y) + cx - fp_half);
+        int sdy = (int)((isin * src_x + icos * src_y) + cy - fp_half);
+        for (x = 0; x < dst->w; x++, pc += bpp, sdx += icos, sdy += isin) {
+            int dx = (sdx >> 16);
+            int dy = (sdy >> 16);
+            if (bpp == 1) {
+                if ((unsigned)dx < (unsigned)src->w && (unsigned)dy < (unsigned)src->h) {
+                    *pc = *((Uint8 *)src->pixels + src->pitch * dy + dx);
+                }
+            } else if ((dx > -1) && (dy > -1) && (dx < (src->w - 1)) && (dy < (src->h - 1))) {
+                const Uint8 *c00 = (const Uint8 *)src->pixels + src->pitch * dy + dx * 4;
+                const Uint8 *c01 = c00 + 4;
+                const Uint8 *c10 = c00 + src->pitch;
+                const Uint8 *c11 = c10 + 4;
+                int ex = (sdx & 0xffff);
+                int ey = (sdy & 0xffff);
+                int c;
+                for (c = 0; c < 4; ++c) {
+                    int t1 = ((((c01[c] - c00[c]) * ex) >> 16) + c00[c]) & 0xff;
+                    int t2 = ((((c11[c] - c10[c]) * ex) >> 16) + c10[c]) & 0xff;
+                    pc[c] = (Uint8)((((t2 - t1) * ey) >> 16) + t1);
+                }
+            }
+        }
+    }
+}
+
+static int SDLCALL surface_testRotate(void *arg)
+{
+    const float angles[] = { 1.0f, 17.5f, 33.3f, 45.0f, 89.9f, 123.0f, -30.0f, 200.5f, 315.0f };
+    const SDL_PixelFormat formats[] = { SDL_PIXELFORMAT_RGBA32, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_INDEX8 };
+    const int sizes[][2] = { { 1, 1 }, { 2, 3 }, { 17, 9 }, { 64, 64 }, { 97, 41 } };
+    int f, s, a, x, y;
+
+    for (f = 0; f < SDL_arraysize(formats); ++f) {
+        for (s = 0; s < SDL_arraysize(sizes); ++s) {
+            SDL_Surface *source = SDL_CreateSurface(sizes[s][0], sizes[s][1], formats[f]);
+            SDLTest_AssertCheck(source != NULL, "SDL_CreateSurface(%d, %d, %s)", sizes[s][0], sizes[s][1], SDL_GetPixelFormatName(formats[f]));
+            if (!source) {
+                continue;
+            }
+            if (formats[f] == SDL_PIXELFORMAT_INDEX8) {
+                SDL_CreateSurfacePalette(source);
+                SDL_SetSurfaceColorKey(source, true, 0);
+            }
+            for (y = 0; y < source->h; ++y) {
+                Uint8 *row = (Uint8 *)source->pixels + y * source->pitch;
+                for (x = 0; x < source->w * SDL_BYTESPERPIXEL(formats[f]); ++x) {
+                    row[x] = (Uint8)SDLTest_RandomIntegerInRange(0, 255);
+                }
+            }
+
+            for (a = 0; a < SDL_arraysize(angles); ++a) {
+                SDL_Surface *rotated = SDL_RotateSurface(source, angles[a]);
+                SDL_Surface *expected;
+                int mismatches = 0;
+
+                SDLTest_AssertCheck(rotated != NULL, "SDL_RotateSurface(%g)", angles[a]);
+                if (!rotated) {
+                    continue;
+                }
+                expected = SDL_CreateSurface(rotated->w, rotated->h, formats[f]);
+                SDLTest_AssertCheck(expected != NULL, "SDL_CreateSurface()");
+                if (expected) {
+                    if (formats[f] == SDL_PIXELFORMAT_INDEX8) {
+                        SDL_memset(expected->pixels, 0, (size_t)expected->pitch * expected->h);
+                    }
+                    referenceRotate(source, expected, angles[a]);
+                    for (y = 0; y < rotated->h; ++y) {
+                        if (SDL_memcmp((Uint8 *)rotated->pixels + y * rotated->pitch,
+                                       (Uint8 *)expected->pixels + y * expected->pitch,
+                                       (size_t)rotated->w * SDL_BYTESPERPIXEL(formats[f])) != 0) {
+                            ++mismatches;
+                        }
+                    }
+                    SDLTest_AssertCheck(mismatches == 0, "Rotating %dx%d %s by %g degrees, expected 0 mismatched rows, got %d",
+                                        source->w, source->h, SDL_GetPixelFormatName(formats[f]), angles[a], mismatches);
+                    SDL_DestroySurface(expected);
+                }
+                SDL_DestroySurface(rotated);
+            }
+            SDL_DestroySurface(source);
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * Tests surface views sharing the pixels of their parent surface
+ */
+static int SDLCALL surface_testSurfaceView(void *arg)
+{
+    const SDL_Rect rect = { 8, 4, 16, 12 };
+    const SDL_Rect bad_rects[] = { { -1, 0, 4, 4 }, { 0, 0, 65, 4 }, { 60, 60, 8, 8 }, { 0, 0, -1, 4 } };
+    SDL_Surface *parent, *view, *nested, *sprite, *bitmap;
+    Uint8 r, g, b, a;
+    int i, x, y, mismatches;
+
+    parent = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_RGBA8888);
+    SDLTest_AssertCheck(parent != NULL, "SDL_CreateSurface()");
+    if (!parent) {
+        return TEST_ABORTED;
+    }
+    SDL_FillSurfaceRect(parent, NULL, SDL_MapSurfaceRGBA(parent, 10, 20, 30, 255));
+
+    view = SDL_CreateSurfaceView(parent, &rect);
+    SDLTest_AssertCheck(view != NULL, "SDL_CreateSurfaceView()");
+    if (!view) {
+        SDL_DestroySurface(parent);
+        return TEST_ABORTED;
+    }
+    SDLTest_AssertCheck(view->w == rect.w && view->h == rect.h, "Verify view size, expected %dx%d, got %dx%d", rect.w, rect.h, view->w, view->h);
+    SDLTest_AssertCheck(view->pitch == parent->pitch, "Verify view pitch, expected %d, got %d", parent->pitch, view->pitch);
+    SDLTest_AssertCheck(view->pixels == (Uint8 *)parent->pixels + rect.y * parent->pitch + rect.x * 4, "Verify view pixels point into the parent");
+    SDLTest_AssertCheck(parent->refcount == 2, "Verify the view references the parent, refcount %d", parent->refcount);
+
+    /* Drawing to the view is clipped to the view and visible in the parent */
+    SDL_FillSurfaceRect(view, NULL, SDL_MapSurfaceRGBA(view, 200, 100, 50, 255));
+    mismatches = 0;
+    for (y = 0; y < parent->h; ++y) {
+        for (x = 0; x < parent->w; ++x) {
+            const bool inside = (x >= rect.x && x < rect.x + rect.w && y >= rect.y && y < rect.y + rect.h);
+            SDL_ReadSurfacePixel(parent, x, y, &r, &g, &b, &a);
+            if (inside ? (r != 200 || g != 100 || b != 50) : (r != 10 || g != 20 || b != 30)) {
+                ++mismatches;
+            }
+        }
+    }
+    SDLTest_AssertCheck(mismatches == 0, "Verify fill through the view, got %d mismatches", mismatches);
+
+    /* Blits to a view are clipped to the view */
+    sprite = SDL_CreateSurface(32, 32, SDL_PIXELFORMAT_XRGB8888);
+    SDLTest_AssertCheck(sprite != NULL, "SDL_CreateSurface()");
+    if (sprite) {
+        SDL_Rect dstrect = { -4, -4, 0, 0 };
+
+        SDL_FillSurfaceRect(sprite, NULL, SDL_MapSurfaceRGB(sprite, 1, 2, 3));
+        SDL_BlitSurface(sprite, NULL, view, &dstrect);
+        SDL_ReadSurfacePixel(parent, rect.x + rect.w - 1, rect.y + rect.h - 1, &r, &g, &b, &a);
+        SDLTest_AssertCheck(r == 1 && g == 2 && b == 3, "Verify blit to view, got %d,%d,%d", r, g, b);
+        SDL_ReadSurfacePixel(parent, rect.x + rect.w, rect.y, &r, &g, &b, &a);
+        SDLTest_AssertCheck(r == 10 && g == 20 && b == 30, "Verify blit to view is clipped, got %d,%d,%d", r, g, b);
+
+        /* Views work as blit sources as well */
+        SDL_FillSurfaceRect(sprite, NULL, 0);
+        SDL_BlitSurface(view, NULL, sprite, NULL);
+        SDL_ReadSurfacePixel(sprite, rect.w - 1, rect.h - 1, &r, &g, &b, &a);
+        SDLTest_AssertCheck(r == 1 && g == 2 && b == 3, "Verify blit from view, got %d,%d,%d", r, g, b);
+        SDL_ReadSurfacePixel(sprite, rect.w, 0, &r, &g, &b, &a);
+        SDLTest_AssertCheck(r == 0 && g == 0 && b == 0, "Verify blit from view is limited to the view, got %d,%d,%d", r, g, b);
+        SDL_DestroySurface(sprite);
+    }
+
+    /* Views of views, and views outliving their parent */
+    nested = SDL_CreateSurfaceView(view, NULL);
+    SDLTest_AssertCheck(nested != NULL && nested->pixels == view->pixels, "SDL_CreateSurfaceView(view, NULL)");
+    SDL_DestroySurface(view);
+    SDL_DestroySurface(parent);
+    if (nested) {
+        SDL_ReadSurfacePixel(nested, 0, 0, &r, &g, &b, &a);
+        SDLTest_AssertCheck(r == 1 && g == 2 && b == 3, "Verify view is valid after the parent is destroyed, got %d,%d,%d", r, g, b);
+        SDL_DestroySurface(nested);
+    }
+
+    /* Invalid rectangles */
+    parent = SDL_CreateSurface(64, 64, SDL_PIXELFORMAT_RGBA8888);
+    for (i = 0; i < SDL_arraysize(bad_rects); ++i) {
+        view = SDL_CreateSurfaceView(parent, &bad_rects[i]);
+        SDLTest_AssertCheck(view == NULL, "Verify SDL_CreateSurfaceView() fails for rect { %d, %d, %d, %d }", bad_rects[i].x, bad_rects[i].y, bad_rects[i].w, bad_rects[i].h);
+        SDL_DestroySurface(view);
+    }
+    SDL_DestroySurface(parent);
+
+    /* Bitmap views must start on a byte boundary */
+    bitmap = SDL_CreateSurface(64, 8, SDL_PIXELFORMAT_INDEX1MSB);
+    if (bitmap) {
+        SDL_Rect aligned = { 8, 0, 8, 8 };
+        SDL_Rect unaligned = { 3, 0, 8, 8 };
+
+        view = SDL_CreateSurfaceView(bitmap, &aligned);
+        SDLTest_AssertCheck(view != NULL && view->pixels == (Uint8 *)bitmap->pixels + 1, "Verify byte aligned bitmap view");
+        SDL_DestroySurface(view);
+        view = SDL_CreateSurfaceView(bitmap, &unaligned);
+        SDLTest_AssertCheck(view == NULL, "Verify unaligned bitmap view fails");
+        SDL_DestroySurface(view);
+        SDL_DestroySurface(bitmap);
+    }
+
+    return TEST_COMPLETED;
+}
+
 static int SDLCALL surface_test16BitTo32Bit(void *arg)
 {
     static const SDL_PixelFormat formats[] = {
@@ -2142,6 +2606,10 @@ static const SDLTest_TestCaseReference surfaceTestRLEPixels = {
     surface_testSurfaceRLEPixels, "surface_testSurfaceRLEPixels", "Tests surface operations with RLE surfaces.", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference surfaceTestRLEClippedBlit = {
+    surface_testRLEClippedBlit, "surface_testRLEClippedBlit", "Tests clipped blits from RLE encoded surfaces.", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference surfaceTestSurfaceConversion = {
     surface_testSurfaceConversion, "surface_testSurfaceConversion", "Tests surface conversion.", TEST_ENABLED
 };
@@ -2222,10 +2690,22 @@ static const SDLTest_TestCaseReference surfaceTestPremultiplyAlpha = {
     surface_testPremultiplyAlpha, "surface_testPremultiplyAlpha", "Test alpha premultiply operations.", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference surfaceTestUnpremultiplyAlpha = {
+    surface_testUnpremultiplyAlpha, "surface_testUnpremultiplyAlpha", "Test alpha unpremultiply operations.", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference surfaceTestScale = {
     surface_testScale, "surface_testScale", "Test scaling operations.", TEST_ENABLED
 };
 
+static const SDLTest_TestCaseReference surfaceTestRotate = {
+    surface_testRotate, "surface_testRotate", "Test arbitrary angle rotation against the reference algorithm.", TEST_ENABLED
+};
+
+static const SDLTest_TestCaseReference surfaceTestSurfaceView = {
+    surface_testSurfaceView, "surface_testSurfaceView", "Test surface views sharing pixels with their parent.", TEST_ENABLED
+};
+
 static const SDLTest_TestCaseReference surfaceTest16BitTo32Bit = {
     surface_test16BitTo32Bit, "surface_test16BitTo32Bit", "Test conversion from 16-bit to 32-bit pixels.", TEST_ENABLED
 };
@@ -2242,6 +2722,7 @@ static const SDLTest_TestCaseReference *surfaceTests[] = {
     &surfaceTestLoadFailure,
     &surfaceTestNULLPixels,
     &surfaceTestRLEPixels,
+    &surfaceTestRLEClippedBlit,
     &surfaceTestSurfaceConversion,
     &surfaceTestCompleteSurfaceConversion,
     &surfaceTestBlitColorMod,
@@ -2262,7 +2743,10 @@ static const SDLTest_TestCaseReference *surfaceTests[] = {
     &surfaceTestPalettization,
     &surfaceTestClearSurface,
     &surfaceTestPremultiplyAlpha,
+    &surfaceTestUnpremultiplyAlpha,
     &surfaceTestScale,
+    &surfaceTestRotate,
+    &surfaceTestSurfaceView,
     &surfaceTest16BitTo32Bit,
     NULL
 };
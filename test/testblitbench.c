@@ -0,0 +1,153 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark software surface blits */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define SCREEN_WIDTH  1280
+#define SCREEN_HEIGHT 720
+#define FRAME_SIZE    96
+#define FRAME_COUNT   16
+
+/* Create a vertical sprite sheet of round sprites with soft edges, like typical game art */
+static SDL_Surface *CreateSpriteSheet(void)
+{
+    SDL_Surface *sheet = SDL_CreateSurface(FRAME_SIZE, FRAME_SIZE * FRAME_COUNT, SDL_PIXELFORMAT_ARGB8888);
+    int frame, x, y;
+
+    if (!sheet) {
+        return NULL;
+    }
+    for (frame = 0; frame < FRAME_COUNT; ++frame) {
+        const float radius = FRAME_SIZE * 0.3f + frame;
+        for (y = 0; y < FRAME_SIZE; ++y) {
+            Uint32 *row = (Uint32 *)((Uint8 *)sheet->pixels + (frame * FRAME_SIZE + y) * sheet->pitch);
+            for (x = 0; x < FRAME_SIZE; ++x) {
+                const float dx = x - FRAME_SIZE / 2.0f;
+                const float dy = y - FRAME_SIZE / 2.0f;
+                const float edge = radius - SDL_sqrtf(dx * dx + dy * dy);
+                Uint8 a;
+
+                if (edge <= 0.0f) {
+                    a = SDL_ALPHA_TRANSPARENT;
+                } else if (edge < 3.0f) {
+                    a = (Uint8)(edge * 85.0f);
+                } else {
+                    a = SDL_ALPHA_OPAQUE;
+                }
+                row[x] = SDL_MapSurfaceRGBA(sheet, (Uint8)(x * 2 + frame * 8), (Uint8)(y * 2), (Uint8)(255 - frame * 12), a);
+            }
+        }
+    }
+    return sheet;
+}
+
+static void BenchmarkBlits(const char *name, SDL_Surface *sprite, SDL_Surface *screen, int iterations)
+{
+    Uint64 start, elapsed;
+    int i, count = 0;
+
+    start = SDL_GetTicksNS();
+    for (i = 0; i < iterations; ++i) {
+        const int frame = i % FRAME_COUNT;
+        SDL_Rect srcrect = { 0, frame * FRAME_SIZE, FRAME_SIZE, FRAME_SIZE };
+        SDL_Rect dstrect;
+
+        /* Sprites partly off the left and top edges exercise clipped blits */
+        dstrect.x = ((i * 37) % (SCREEN_WIDTH + FRAME_SIZE)) - FRAME_SIZE / 2;
+        dstrect.y = ((i * 53) % (SCREEN_HEIGHT + FRAME_SIZE)) - FRAME_SIZE / 2;
+        SDL_BlitSurface(sprite, &srcrect, screen, &dstrect);
+        ++count;
+    }
+    elapsed = SDL_GetTicksNS() - start;
+
+    SDL_Log("%-28s %8d blits in %8.2f ms, %6.3f us/blit", name, count, elapsed / 1000000.0, elapsed / 1000.0 / count);
+}
+
+static void BenchmarkSprite(const char *name, SDL_Surface *sprite, SDL_Surface *screen, int iterations)
+{
+    char label[64];
+
+    SDL_SetSurfaceRLE(sprite, false);
+    SDL_snprintf(label, sizeof(label), "%s", name);
+    BenchmarkBlits(label, sprite, screen, iterations);
+
+    SDL_SetSurfaceRLE(sprite, true);
+    SDL_snprintf(label, sizeof(label), "%s RLE", name);
+    BenchmarkBlits(label, sprite, screen, iterations);
+}
+
+int main(int argc, char *argv[])
+{
+    SDLTest_CommonState *state;
+    SDL_Surface *sheet = NULL, *colorkey = NULL, *screen = NULL;
+    int iterations = 20000;
+    int i;
+
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_atoi(argv[i + 1]);
+                consumed = 2;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    sheet = CreateSpriteSheet();
+    screen = SDL_CreateSurface(SCREEN_WIDTH, SCREEN_HEIGHT, SDL_PIXELFORMAT_XRGB8888);
+    if (!sheet || !screen) {
+        SDL_Log("Couldn't create surfaces: %s", SDL_GetError());
+        goto done;
+    }
+
+    /* Binary transparency with a colorkey */
+    colorkey = SDL_CreateSurface(sheet->w, sheet->h, SDL_PIXELFORMAT_XRGB8888);
+    if (!colorkey) {
+        SDL_Log("Couldn't create surface: %s", SDL_GetError());
+        goto done;
+    }
+    SDL_FillSurfaceRect(colorkey, NULL, SDL_MapSurfaceRGB(colorkey, 255, 0, 255));
+    SDL_BlitSurface(sheet, NULL, colorkey, NULL);
+    SDL_SetSurfaceColorKey(colorkey, true, SDL_MapSurfaceRGB(colorkey, 255, 0, 255));
+
+    SDL_FillSurfaceRect(screen, NULL, SDL_MapSurfaceRGB(screen, 32, 64, 96));
+
+    BenchmarkSprite("colorkey", colorkey, screen, iterations);
+    SDL_SetSurfaceAlphaMod(colorkey, 160);
+    BenchmarkSprite("colorkey + alpha mod", colorkey, screen, iterations);
+    BenchmarkSprite("per-pixel alpha", sheet, screen, iterations);
+
+done:
+    SDL_DestroySurface(colorkey);
+    SDL_DestroySurface(sheet);
+    SDL_DestroySurface(screen);
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
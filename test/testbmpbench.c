@@ -0,0 +1,290 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark loading and saving BMP images */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define IMAGE_WIDTH  1920
+#define IMAGE_HEIGHT 1080
+#define TEMP_FILE    "testbmpbench.bmp"
+
+/* A frame dump: smooth gradients with some noise and flat areas */
+static SDL_Surface *CreateImage(SDL_PixelFormat format)
+{
+    SDL_Surface *surface = SDL_CreateSurface(IMAGE_WIDTH, IMAGE_HEIGHT, SDL_PIXELFORMAT_ARGB8888);
+    SDL_Surface *converted;
+    Uint32 seed = 1;
+    int x, y;
+
+    if (!surface) {
+        return NULL;
+    }
+    for (y = 0; y < surface->h; ++y) {
+        Uint32 *row = (Uint32 *)((Uint8 *)surface->pixels + y * surface->pitch);
+        for (x = 0; x < surface->w; ++x) {
+            seed = seed * 1103515245 + 12345;
+            if ((x / 128 + y / 128) & 1) {
+                row[x] = SDL_MapSurfaceRGBA(surface, 32, 64, 96, 255);
+            } else {
+                row[x] = SDL_MapSurfaceRGBA(surface, (Uint8)(x / 8), (Uint8)(y / 5), (Uint8)(seed >> 28), (Uint8)(255 - y / 8));
+            }
+        }
+    }
+    if (format == surface->format) {
+        return surface;
+    }
+    converted = SDL_ConvertSurface(surface, format);
+    SDL_DestroySurface(surface);
+    return converted;
+}
+
+/* Write an 8-bit surface as an RLE8 compressed BMP */
+static SDL_IOStream *CreateRLE8(SDL_Surface *surface)
+{
+    SDL_IOStream *stream = SDL_IOFromDynamicMem();
+    SDL_Palette *palette = SDL_GetSurfacePalette(surface);
+    Sint64 data_offset, end_offset;
+    int i, x, y;
+
+    if (!stream || !palette) {
+        SDL_CloseIO(stream);
+        return NULL;
+    }
+    SDL_WriteU8(stream, 'B');
+    SDL_WriteU8(stream, 'M');
+    SDL_WriteU32LE(stream, 0);
+    SDL_WriteU32LE(stream, 0);
+    SDL_WriteU32LE(stream, 14 + 40 + 256 * 4);
+    SDL_WriteU32LE(stream, 40);
+    SDL_WriteS32LE(stream, surface->w);
+    SDL_WriteS32LE(stream, surface->h);
+    SDL_WriteU16LE(stream, 1);
+    SDL_WriteU16LE(stream, 8);
+    SDL_WriteU32LE(stream, 1 /* BI_RLE8 */);
+    SDL_WriteU32LE(stream, 0);
+    SDL_WriteU32LE(stream, 0);
+    SDL_WriteU32LE(stream, 0);
+    SDL_WriteU32LE(stream, 256);
+    SDL_WriteU32LE(stream, 0);
+    for (i = 0; i < 256; ++i) {
+        const SDL_Color *color = &palette->colors[i < palette->ncolors ? i : 0];
+        SDL_WriteU8(stream, color->b);
+        SDL_WriteU8(stream, color->g);
+        SDL_WriteU8(stream, color->r);
+        SDL_WriteU8(stream, 0);
+    }
+
+    data_offset = SDL_TellIO(stream);
+    for (y = surface->h - 1; y >= 0; --y) {
+        const Uint8 *row = (const Uint8 *)surface->pixels + y * surface->pitch;
+
+        for (x = 0; x < surface->w;) {
+            int run = 1;
+
+            while (x + run < surface->w && run < 255 && row[x + run] == row[x]) {
+                ++run;
+            }
+            if (run >= 3) {
+                SDL_WriteU8(stream, (Uint8)run);
+                SDL_WriteU8(stream, row[x]);
+            } else {
+                /* Absolute mode, until the next run of 3 or more pixels */
+                int count = 0;
+
+                while (x + count < surface->w && count < 255 &&
+                       !(x + count + 2 < surface->w && row[x + count] == row[x + count + 1] && row[x + count] == row[x + count + 2])) {
+                    ++count;
+                }
+                if (count < 3) {
+                    /* Absolute mode needs at least 3 pixels */
+                    run = count;
+                    for (i = 0; i < count; ++i) {
+                        SDL_WriteU8(stream, 1);
+                        SDL_WriteU8(stream, row[x + i]);
+                    }
+                } else {
+                    run = count;
+                    SDL_WriteU8(stream, 0);
+                    SDL_WriteU8(stream, (Uint8)count);
+                    SDL_WriteIO(stream, &row[x], count);
+                    if (count & 1) {
+                        SDL_WriteU8(stream, 0);
+                    }
+                }
+            }
+            x += run;
+        }
+        SDL_WriteU8(stream, 0);
+        SDL_WriteU8(stream, 0);
+    }
+    SDL_WriteU8(stream, 0);
+    SDL_WriteU8(stream, 1);
+
+    end_offset = SDL_TellIO(stream);
+    SDL_SeekIO(stream, 2, SDL_IO_SEEK_SET);
+    SDL_WriteU32LE(stream, (Uint32)end_offset);
+    SDL_SeekIO(stream, 34, SDL_IO_SEEK_SET);
+    SDL_WriteU32LE(stream, (Uint32)(end_offset - data_offset));
+    SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+    return stream;
+}
+
+static void BenchmarkLoad(const char *name, SDL_IOStream *stream, SDL_PixelFormat format, int iterations)
+{
+    SDL_PropertiesID props = SDL_CreateProperties();
+    const Sint64 size = SDL_GetIOSize(stream);
+    void *data = SDL_GetPointerProperty(SDL_GetIOProperties(stream), SDL_PROP_IOSTREAM_DYNAMIC_MEMORY_POINTER, NULL);
+    Uint64 start, memory_elapsed = 0, file_elapsed = 0;
+    int i;
+
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOAD_FORMAT_NUMBER, format);
+
+    start = SDL_GetTicksNS();
+    for (i = 0; i < iterations; ++i) {
+        SDL_Surface *surface = SDL_LoadSurfaceWithProperties(SDL_IOFromConstMem(data, (size_t)size), true, props);
+        if (!surface) {
+            SDL_Log("Couldn't load %s: %s", name, SDL_GetError());
+            break;
+        }
+        SDL_DestroySurface(surface);
+    }
+    memory_elapsed = SDL_GetTicksNS() - start;
+
+    if (SDL_SaveFile(TEMP_FILE, data, (size_t)size)) {
+        start = SDL_GetTicksNS();
+        for (i = 0; i < iterations; ++i) {
+            SDL_Surface *surface = SDL_LoadSurfaceWithProperties(SDL_IOFromFile(TEMP_FILE, "rb"), true, props);
+            SDL_DestroySurface(surface);
+        }
+        file_elapsed = SDL_GetTicksNS() - start;
+        SDL_RemovePath(TEMP_FILE);
+    }
+    SDL_DestroyProperties(props);
+
+    SDL_Log("  load %-24s %8.3f ms from memory, %8.3f ms from file, %9d bytes", name,
+            memory_elapsed / 1000000.0 / iterations, file_elapsed / 1000000.0 / iterations, (int)size);
+}
+
+static SDL_IOStream *BenchmarkSave(const char *name, SDL_Surface *surface, int iterations)
+{
+    SDL_IOStream *stream = NULL;
+    Uint64 start, memory_elapsed, file_elapsed;
+    int i;
+
+    start = SDL_GetTicksNS();
+    for (i = 0; i < iterations; ++i) {
+        SDL_CloseIO(stream);
+        stream = SDL_IOFromDynamicMem();
+        if (!stream) {
+            return NULL;
+        }
+        /* Grow the stream in large steps so the timing measures the encoder rather than reallocation */
+        SDL_SetNumberProperty(SDL_GetIOProperties(stream), SDL_PROP_IOSTREAM_DYNAMIC_CHUNKSIZE_NUMBER, 1024 * 1024);
+        if (!SDL_SaveBMP_IO(surface, stream, false)) {
+            SDL_Log("Couldn't save %s: %s", name, SDL_GetError());
+            SDL_CloseIO(stream);
+            return NULL;
+        }
+    }
+    memory_elapsed = SDL_GetTicksNS() - start;
+
+    start = SDL_GetTicksNS();
+    for (i = 0; i < iterations; ++i) {
+        SDL_SaveBMP(surface, TEMP_FILE);
+    }
+    file_elapsed = SDL_GetTicksNS() - start;
+    SDL_RemovePath(TEMP_FILE);
+
+    SDL_Log("  save %-24s %8.3f ms to memory,   %8.3f ms to file", name,
+            memory_elapsed / 1000000.0 / iterations, file_elapsed / 1000000.0 / iterations);
+
+    SDL_SeekIO(stream, 0, SDL_IO_SEEK_SET);
+    return stream;
+}
+
+int main(int argc, char *argv[])
+{
+    static const struct
+    {
+        const char *name;
+        SDL_PixelFormat format;
+    } images[] = {
+        { "8-bit", SDL_PIXELFORMAT_INDEX8 },
+        { "24-bit", SDL_PIXELFORMAT_XRGB8888 },
+        { "32-bit", SDL_PIXELFORMAT_ARGB8888 },
+    };
+    SDLTest_CommonState *state;
+    int iterations = 10;
+    int i;
+
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    if (!SDL_Init(0)) {
+        SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+
+    SDL_Log("%dx%d images", IMAGE_WIDTH, IMAGE_HEIGHT);
+    for (i = 0; i < SDL_arraysize(images); ++i) {
+        SDL_Surface *surface = CreateImage(images[i].format);
+        SDL_IOStream *stream;
+
+        if (!surface) {
+            SDL_Log("Couldn't create %s image: %s", images[i].name, SDL_GetError());
+            continue;
+        }
+        stream = BenchmarkSave(images[i].name, surface, iterations);
+        if (stream) {
+            BenchmarkLoad(images[i].name, stream, SDL_PIXELFORMAT_UNKNOWN, iterations);
+            if (images[i].format == SDL_PIXELFORMAT_XRGB8888) {
+                BenchmarkLoad("24-bit as XRGB8888", stream, SDL_PIXELFORMAT_XRGB8888, iterations);
+            }
+            SDL_CloseIO(stream);
+        }
+        if (images[i].format == SDL_PIXELFORMAT_INDEX8) {
+            stream = CreateRLE8(surface);
+            if (stream) {
+                BenchmarkLoad("8-bit RLE", stream, SDL_PIXELFORMAT_UNKNOWN, iterations);
+                SDL_CloseIO(stream);
+            }
+        }
+        SDL_DestroySurface(surface);
+    }
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
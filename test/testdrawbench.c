@@ -0,0 +1,160 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark blended rectangles, lines and points with the software renderer */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define SCREEN_WIDTH  1280
+#define SCREEN_HEIGHT 720
+#define NUM_RECTS     64
+#define NUM_LINES     256
+#define NUM_POINTS    20000
+
+static SDL_FRect rects[NUM_RECTS];
+static SDL_FPoint lines[NUM_LINES * 2];
+static SDL_FPoint points[NUM_POINTS];
+
+/* A dashboard: panels, a grid of horizontal and vertical lines and a scatter plot */
+static void CreateShapes(void)
+{
+    Uint64 seed = 1;
+    int i;
+
+    for (i = 0; i < NUM_RECTS; ++i) {
+        rects[i].x = (float)((i % 8) * 160 + 4);
+        rects[i].y = (float)((i / 8) * 90 + 4);
+        rects[i].w = 152.0f;
+        rects[i].h = 82.0f;
+    }
+    for (i = 0; i < NUM_LINES; ++i) {
+        if (i & 1) {
+            const float x = (float)((i * 5) % SCREEN_WIDTH);
+            lines[i * 2].x = x;
+            lines[i * 2].y = 0.0f;
+            lines[i * 2 + 1].x = x;
+            lines[i * 2 + 1].y = (float)(SCREEN_HEIGHT - 1);
+        } else {
+            const float y = (float)((i * 3) % SCREEN_HEIGHT);
+            lines[i * 2].x = 0.0f;
+            lines[i * 2].y = y;
+            lines[i * 2 + 1].x = (float)(SCREEN_WIDTH - 1);
+            lines[i * 2 + 1].y = y;
+        }
+    }
+    for (i = 0; i < NUM_POINTS; ++i) {
+        points[i].x = (float)SDL_rand_r(&seed, SCREEN_WIDTH);
+        points[i].y = (float)SDL_rand_r(&seed, SCREEN_HEIGHT);
+    }
+}
+
+static double TimeFrames(SDL_Renderer *renderer, int shape, int iterations)
+{
+    Uint64 start = SDL_GetTicksNS();
+    int i, j;
+
+    for (i = 0; i < iterations; ++i) {
+        switch (shape) {
+        case 0:
+            SDL_RenderFillRects(renderer, rects, NUM_RECTS);
+            break;
+        case 1:
+            for (j = 0; j < NUM_LINES; ++j) {
+                SDL_RenderLine(renderer, lines[j * 2].x, lines[j * 2].y, lines[j * 2 + 1].x, lines[j * 2 + 1].y);
+            }
+            break;
+        default:
+            SDL_RenderPoints(renderer, points, NUM_POINTS);
+            break;
+        }
+        SDL_FlushRenderer(renderer);
+    }
+    return (SDL_GetTicksNS() - start) / 1000000.0 / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    static const SDL_PixelFormat formats[] = {
+        SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB565
+    };
+    static const struct
+    {
+        const char *name;
+        SDL_BlendMode mode;
+    } blendmodes[] = {
+        { "blend", SDL_BLENDMODE_BLEND },
+        { "add", SDL_BLENDMODE_ADD },
+        { "mod", SDL_BLENDMODE_MOD },
+        { "mul", SDL_BLENDMODE_MUL },
+    };
+    SDLTest_CommonState *state;
+    int iterations = 50;
+    int i, j;
+
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    CreateShapes();
+
+    SDL_Log("%dx%d, %d rects, %d lines, %d points, ms per frame", SCREEN_WIDTH, SCREEN_HEIGHT, NUM_RECTS, NUM_LINES, NUM_POINTS);
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_Surface *screen = SDL_CreateSurface(SCREEN_WIDTH, SCREEN_HEIGHT, formats[i]);
+        SDL_Renderer *renderer = screen ? SDL_CreateSoftwareRenderer(screen) : NULL;
+
+        if (!renderer) {
+            SDL_Log("Couldn't create renderer: %s", SDL_GetError());
+            SDL_DestroySurface(screen);
+            continue;
+        }
+        SDL_SetRenderDrawColor(renderer, 32, 64, 96, 255);
+        SDL_RenderClear(renderer);
+
+        for (j = 0; j < SDL_arraysize(blendmodes); ++j) {
+            double fill, line, point;
+
+            SDL_SetRenderDrawBlendMode(renderer, blendmodes[j].mode);
+            SDL_SetRenderDrawColor(renderer, 200, 120, 40, 96);
+            fill = TimeFrames(renderer, 0, iterations);
+            line = TimeFrames(renderer, 1, iterations);
+            point = TimeFrames(renderer, 2, iterations);
+            SDL_Log("  %-24s %-6s fill %8.3f  lines %8.3f  points %8.3f", SDL_GetPixelFormatName(formats[i]), blendmodes[j].name, fill, line, point);
+        }
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroySurface(screen);
+    }
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
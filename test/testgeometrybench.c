@@ -0,0 +1,215 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark drawing geometry with the software renderer */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+#define SCREEN_WIDTH  1280
+#define SCREEN_HEIGHT 720
+#define NUM_PANELS    96
+#define NUM_CIRCLES   48
+#define NUM_SEGMENTS  32
+#define NUM_SPRITES   256
+#define NUM_TILES     16
+
+static SDL_Vertex panels[NUM_PANELS * 6];
+static SDL_Vertex circles[NUM_CIRCLES * NUM_SEGMENTS * 3];
+static SDL_Vertex sprites[NUM_SPRITES * 6];
+static SDL_Vertex tiles[NUM_TILES * 6];
+
+static void SetVertex(SDL_Vertex *vertex, float x, float y, float r, float g, float b, float a, float u, float v)
+{
+    vertex->position.x = x;
+    vertex->position.y = y;
+    vertex->color.r = r;
+    vertex->color.g = g;
+    vertex->color.b = b;
+    vertex->color.a = a;
+    vertex->tex_coord.x = u;
+    vertex->tex_coord.y = v;
+}
+
+/* Two triangles from four corners, in the order top left, top right, bottom right, bottom left */
+static void SetQuad(SDL_Vertex *quad, const SDL_Vertex corners[4])
+{
+    quad[0] = corners[0];
+    quad[1] = corners[1];
+    quad[2] = corners[2];
+    quad[3] = corners[2];
+    quad[4] = corners[3];
+    quad[5] = corners[0];
+}
+
+/* A user interface: gradient panels, translucent round buttons, rotated icons and a tiled background */
+static void CreateGeometry(void)
+{
+    SDL_Vertex corners[4];
+    int i, j;
+
+    for (i = 0; i < NUM_PANELS; ++i) {
+        const float x = (float)((i % 12) * 106 + 4);
+        const float y = (float)((i / 12) * 90 + 4);
+        SetVertex(&corners[0], x, y, 0.2f, 0.3f, 0.5f, 1.0f, 0.0f, 0.0f);
+        SetVertex(&corners[1], x + 100.0f, y, 0.2f, 0.3f, 0.5f, 1.0f, 0.0f, 0.0f);
+        SetVertex(&corners[2], x + 100.0f, y + 84.0f, 0.1f, 0.1f, 0.2f, 1.0f, 0.0f, 0.0f);
+        SetVertex(&corners[3], x, y + 84.0f, 0.1f, 0.1f, 0.2f, 1.0f, 0.0f, 0.0f);
+        SetQuad(&panels[i * 6], corners);
+    }
+
+    for (i = 0; i < NUM_CIRCLES; ++i) {
+        const float cx = (float)((i % 8) * 160 + 80);
+        const float cy = (float)((i / 8) * 120 + 60);
+        const float radius = 50.0f;
+
+        for (j = 0; j < NUM_SEGMENTS; ++j) {
+            const float a0 = (SDL_PI_F * 2.0f * j) / NUM_SEGMENTS;
+            const float a1 = (SDL_PI_F * 2.0f * (j + 1)) / NUM_SEGMENTS;
+            SDL_Vertex *triangle = &circles[(i * NUM_SEGMENTS + j) * 3];
+            SetVertex(&triangle[0], cx, cy, 0.9f, 0.6f, 0.2f, 0.5f, 0.0f, 0.0f);
+            SetVertex(&triangle[1], cx + SDL_cosf(a0) * radius, cy + SDL_sinf(a0) * radius, 0.9f, 0.6f, 0.2f, 0.5f, 0.0f, 0.0f);
+            SetVertex(&triangle[2], cx + SDL_cosf(a1) * radius, cy + SDL_sinf(a1) * radius, 0.9f, 0.6f, 0.2f, 0.5f, 0.0f, 0.0f);
+        }
+    }
+
+    for (i = 0; i < NUM_SPRITES; ++i) {
+        const float cx = (float)((i % 16) * 80 + 40);
+        const float cy = (float)((i / 16) * 45 + 22);
+        const float angle = (float)i * 0.1f;
+        const float dx = SDL_cosf(angle) * 24.0f, dy = SDL_sinf(angle) * 24.0f;
+        SetVertex(&corners[0], cx - dx + dy, cy - dy - dx, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+        SetVertex(&corners[1], cx + dx + dy, cy + dy - dx, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f);
+        SetVertex(&corners[2], cx + dx - dy, cy + dy + dx, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+        SetVertex(&corners[3], cx - dx - dy, cy - dy + dx, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 1.0f);
+        SetQuad(&sprites[i * 6], corners);
+    }
+
+    for (i = 0; i < NUM_TILES; ++i) {
+        const float x = (float)((i % 4) * 320);
+        const float y = (float)((i / 4) * 180);
+        SetVertex(&corners[0], x, y, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f);
+        SetVertex(&corners[1], x + 320.0f, y, 1.0f, 1.0f, 1.0f, 1.0f, 5.0f, 0.0f);
+        SetVertex(&corners[2], x + 320.0f, y + 180.0f, 1.0f, 1.0f, 1.0f, 1.0f, 5.0f, 2.8125f);
+        SetVertex(&corners[3], x, y + 180.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0.0f, 2.8125f);
+        SetQuad(&tiles[i * 6], corners);
+    }
+}
+
+static SDL_Texture *CreateTexture(SDL_Renderer *renderer, SDL_PixelFormat format)
+{
+    SDL_Surface *surface = SDL_CreateSurface(64, 64, format);
+    SDL_Texture *texture;
+    int x, y;
+
+    if (!surface) {
+        return NULL;
+    }
+    for (y = 0; y < surface->h; ++y) {
+        for (x = 0; x < surface->w; ++x) {
+            const Uint8 alpha = ((x / 8 + y / 8) & 1) ? 255 : 128;
+            SDL_WriteSurfacePixel(surface, x, y, (Uint8)(x * 4), (Uint8)(y * 4), 128, alpha);
+        }
+    }
+    texture = SDL_CreateTextureFromSurface(renderer, surface);
+    SDL_DestroySurface(surface);
+    return texture;
+}
+
+static double TimeFrames(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Vertex *vertices, int num_vertices, int iterations)
+{
+    Uint64 start = SDL_GetTicksNS();
+    int i;
+
+    for (i = 0; i < iterations; ++i) {
+        SDL_RenderGeometry(renderer, texture, vertices, num_vertices, NULL, 0);
+        SDL_FlushRenderer(renderer);
+    }
+    return (SDL_GetTicksNS() - start) / 1000000.0 / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    static const SDL_PixelFormat formats[] = {
+        SDL_PIXELFORMAT_XRGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB565
+    };
+    SDLTest_CommonState *state;
+    int iterations = 20;
+    int i;
+
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    CreateGeometry();
+
+    SDL_Log("%dx%d, ms per frame", SCREEN_WIDTH, SCREEN_HEIGHT);
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_Surface *screen = SDL_CreateSurface(SCREEN_WIDTH, SCREEN_HEIGHT, formats[i]);
+        SDL_Renderer *renderer = screen ? SDL_CreateSoftwareRenderer(screen) : NULL;
+        SDL_Texture *sprite, *tile;
+        double panel_time, circle_time, sprite_time, tile_time;
+
+        if (!renderer) {
+            SDL_Log("Couldn't create renderer: %s", SDL_GetError());
+            SDL_DestroySurface(screen);
+            continue;
+        }
+        sprite = CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888);
+        tile = CreateTexture(renderer, formats[i]);
+        SDL_SetTextureBlendMode(sprite, SDL_BLENDMODE_BLEND);
+        SDL_SetTextureBlendMode(tile, SDL_BLENDMODE_NONE);
+
+        SDL_SetRenderDrawColor(renderer, 32, 64, 96, 255);
+        SDL_RenderClear(renderer);
+
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+        panel_time = TimeFrames(renderer, NULL, panels, SDL_arraysize(panels), iterations);
+        SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+        circle_time = TimeFrames(renderer, NULL, circles, SDL_arraysize(circles), iterations);
+        sprite_time = TimeFrames(renderer, sprite, sprites, SDL_arraysize(sprites), iterations);
+        SDL_SetRenderTextureAddressMode(renderer, SDL_TEXTURE_ADDRESS_WRAP, SDL_TEXTURE_ADDRESS_WRAP);
+        tile_time = TimeFrames(renderer, tile, tiles, SDL_arraysize(tiles), iterations);
+
+        SDL_Log("  %-24s gradients %8.3f  blended %8.3f  sprites %8.3f  tiles %8.3f",
+                SDL_GetPixelFormatName(formats[i]), panel_time, circle_time, sprite_time, tile_time);
+
+        SDL_DestroyTexture(sprite);
+        SDL_DestroyTexture(tile);
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroySurface(screen);
+    }
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
@@ -0,0 +1,170 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark loading a directory of images serially and with SDL_SurfaceLoader */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+
+static char **files = NULL;
+static int num_files = 0;
+
+static void AddFiles(const char *directory, const char *pattern)
+{
+    char **matches;
+    char **new_files;
+    int count = 0;
+    int i;
+
+    matches = SDL_GlobDirectory(directory, pattern, SDL_GLOB_CASEINSENSITIVE, &count);
+    if (!matches) {
+        return;
+    }
+    new_files = (char **)SDL_realloc(files, (num_files + count) * sizeof(*files));
+    if (new_files) {
+        files = new_files;
+        for (i = 0; i < count; ++i) {
+            SDL_asprintf(&files[num_files++], "%s%s", directory, matches[i]);
+        }
+    }
+    SDL_free(matches);
+}
+
+static double LoadSerial(void)
+{
+    Uint64 start = SDL_GetTicksNS();
+    int i;
+
+    for (i = 0; i < num_files; ++i) {
+        SDL_Surface *surface = SDL_LoadSurface(files[i]);
+        if (!surface) {
+            SDL_Log("Couldn't load %s: %s", files[i], SDL_GetError());
+        }
+        SDL_DestroySurface(surface);
+    }
+    return (SDL_GetTicksNS() - start) / 1000000.0;
+}
+
+static double LoadAsync(int num_threads)
+{
+    SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_SurfaceLoader *loader;
+    SDL_SurfaceLoaderOutcome outcome;
+    Uint64 start;
+    int i;
+
+    SDL_SetNumberProperty(props, SDL_PROP_SURFACE_LOADER_THREADS_NUMBER, num_threads);
+
+    start = SDL_GetTicksNS();
+    loader = SDL_CreateSurfaceLoader(props);
+    SDL_DestroyProperties(props);
+    if (!loader) {
+        SDL_Log("Couldn't create loader: %s", SDL_GetError());
+        return 0.0;
+    }
+    for (i = 0; i < num_files; ++i) {
+        if (!SDL_LoadSurfaceAsync(loader, files[i], files[i])) {
+            SDL_Log("Couldn't start loading %s: %s", files[i], SDL_GetError());
+        }
+    }
+    while (SDL_WaitSurfaceLoaderResult(loader, &outcome, -1)) {
+        if (!outcome.surface) {
+            SDL_Log("Couldn't load %s: %s", (const char *)outcome.userdata, SDL_GetError());
+        }
+        SDL_DestroySurface(outcome.surface);
+    }
+    SDL_DestroySurfaceLoader(loader);
+    return (SDL_GetTicksNS() - start) / 1000000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *patterns[] = { "*.bmp", "*.png", "*.jpg", "*.jpeg" };
+    SDLTest_CommonState *state;
+    const char *directory = NULL;
+    char *base_directory = NULL;
+    int iterations = 5;
+    int i, j, num_threads;
+
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            } else if (argv[i][0] != '-' && !directory) {
+                directory = argv[i];
+                consumed = 1;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", "[directory]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    if (!SDL_Init(0)) {
+        SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+
+    if (directory) {
+        size_t len = SDL_strlen(directory);
+        SDL_asprintf(&base_directory, "%s%s", directory, (len > 0 && directory[len - 1] != '/' && directory[len - 1] != '\\') ? "/" : "");
+    } else {
+        base_directory = SDL_strdup(SDL_GetBasePath());
+    }
+    if (base_directory) {
+        for (i = 0; i < SDL_arraysize(patterns); ++i) {
+            AddFiles(base_directory, patterns[i]);
+        }
+    }
+    if (num_files == 0) {
+        SDL_Log("No images found in %s", base_directory ? base_directory : "(null)");
+        SDL_free(base_directory);
+        SDL_Quit();
+        SDLTest_CommonDestroyState(state);
+        return 1;
+    }
+
+    SDL_Log("Loading %d images from %s", num_files, base_directory);
+
+    /* Warm up the file cache, so every run measures the same thing */
+    LoadSerial();
+
+    for (i = 0; i < iterations; ++i) {
+        SDL_Log("  serial:             %8.3f ms", LoadSerial());
+        for (num_threads = 1; num_threads <= SDL_GetNumLogicalCPUCores(); num_threads *= 2) {
+            SDL_Log("  loader, %2d threads: %8.3f ms", num_threads, LoadAsync(num_threads));
+        }
+    }
+
+    for (j = 0; j < num_files; ++j) {
+        SDL_free(files[j]);
+    }
+    SDL_free(files);
+    SDL_free(base_directory);
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
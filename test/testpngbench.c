@@ -0,0 +1,169 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark saving PNG images with different compression options */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+#include "testutils.h"
+
+#define SCREENSHOT_WIDTH  1920
+#define SCREENSHOT_HEIGHT 1080
+
+static const struct
+{
+    int level;
+    const char *filter;
+    bool parallel;
+} configs[] = {
+    { 1, "none", false },
+    { 1, "adaptive", false },
+    { 6, "none", false },
+    { 6, "adaptive", false },
+    { 6, "adaptive", true },
+    { 9, "adaptive", false },
+    { 9, "adaptive", true },
+};
+
+static void BenchmarkSave(const char *name, SDL_Surface *surface, int iterations)
+{
+    SDL_PropertiesID props = SDL_GetSurfaceProperties(surface);
+    int i, c;
+
+    SDL_Log("%s: %dx%d", name, surface->w, surface->h);
+    for (c = 0; c < SDL_arraysize(configs); ++c) {
+        Uint64 start, elapsed;
+        Sint64 size = 0;
+
+        SDL_SetNumberProperty(props, SDL_PROP_SURFACE_PNG_COMPRESSION_LEVEL_NUMBER, configs[c].level);
+        SDL_SetStringProperty(props, SDL_PROP_SURFACE_PNG_FILTER_STRING, configs[c].filter);
+        SDL_SetBooleanProperty(props, SDL_PROP_SURFACE_PNG_PARALLEL_BOOLEAN, configs[c].parallel);
+
+        start = SDL_GetTicksNS();
+        for (i = 0; i < iterations; ++i) {
+            SDL_IOStream *stream = SDL_IOFromDynamicMem();
+
+            if (!stream) {
+                SDL_Log("Couldn't create stream: %s", SDL_GetError());
+                return;
+            }
+            /* Grow the stream in large steps so the timing measures the encoder rather than reallocation */
+            SDL_SetNumberProperty(SDL_GetIOProperties(stream), SDL_PROP_IOSTREAM_DYNAMIC_CHUNKSIZE_NUMBER, 1024 * 1024);
+            if (!SDL_SavePNG_IO(surface, stream, false)) {
+                SDL_Log("Couldn't save PNG: %s", SDL_GetError());
+                SDL_CloseIO(stream);
+                return;
+            }
+            size = SDL_TellIO(stream);
+            SDL_CloseIO(stream);
+        }
+        elapsed = SDL_GetTicksNS() - start;
+
+        SDL_Log("  level %2d, filter %-8s%-9s %8.3f ms/save, %8d bytes",
+                configs[c].level, configs[c].filter, configs[c].parallel ? ", threads" : "",
+                elapsed / 1000000.0 / iterations, (int)size);
+    }
+}
+
+/* Tile an image over a screen sized surface, like a typical screenshot */
+static SDL_Surface *CreateScreenshot(SDL_Surface *image)
+{
+    SDL_Surface *screenshot = SDL_CreateSurface(SCREENSHOT_WIDTH, SCREENSHOT_HEIGHT, SDL_PIXELFORMAT_RGBA32);
+    int x, y;
+
+    if (!screenshot) {
+        return NULL;
+    }
+    SDL_FillSurfaceRect(screenshot, NULL, SDL_MapSurfaceRGB(screenshot, 32, 64, 96));
+    for (y = 0; y < SCREENSHOT_HEIGHT; y += image->h + 16) {
+        for (x = 0; x < SCREENSHOT_WIDTH; x += image->w + 16) {
+            SDL_Rect dstrect = { x, y, image->w, image->h };
+            SDL_BlitSurface(image, NULL, screenshot, &dstrect);
+        }
+    }
+    return screenshot;
+}
+
+int main(int argc, char *argv[])
+{
+    static const char *default_files[] = { "sample.png", "testyuv.png", "glass.png", "gamepad_front.png" };
+    SDLTest_CommonState *state;
+    const char *files[64];
+    int num_files = 0;
+    int iterations = 10;
+    int i;
+
+    state = SDLTest_CommonCreateState(argv, 0);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            } else if (argv[i][0] != '-' && num_files < SDL_arraysize(files)) {
+                files[num_files++] = argv[i];
+                consumed = 1;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", "[image.png ...]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    if (!SDL_Init(0)) {
+        SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
+        return 1;
+    }
+
+    if (num_files == 0) {
+        for (i = 0; i < SDL_arraysize(default_files); ++i) {
+            files[num_files++] = default_files[i];
+        }
+    }
+
+    for (i = 0; i < num_files; ++i) {
+        char *path = GetNearbyFilename(files[i]);
+        SDL_Surface *image, *screenshot;
+
+        image = SDL_LoadPNG(path ? path : files[i]);
+        SDL_free(path);
+        if (!image) {
+            SDL_Log("Couldn't load %s: %s", files[i], SDL_GetError());
+            continue;
+        }
+        BenchmarkSave(files[i], image, iterations);
+
+        screenshot = CreateScreenshot(image);
+        if (screenshot) {
+            char name[128];
+
+            SDL_snprintf(name, sizeof(name), "%s tiled", files[i]);
+            BenchmarkSave(name, screenshot, iterations);
+            SDL_DestroySurface(screenshot);
+        }
+        SDL_DestroySurface(image);
+    }
+
+    SDL_Quit();
+    SDLTest_CommonDestroyState(state);
+    return 0;
+}
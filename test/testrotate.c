@@ -147,14 +147,70 @@ void SDL_AppQuit(void *appstate, SDL_AppResult result)
     SDLTest_CommonQuit(state);
 }
 
+static void RunBenchmark(int iterations)
+{
+    static const float angles[] = { 7.0f, 33.0f, 45.0f, 100.0f, 251.0f };
+    Uint64 start, elapsed;
+    int i, f, a;
+
+    for (f = 0; f < SDL_arraysize(formats); ++f) {
+        if (!UpdateImageFormat()) {
+            return;
+        }
+        start = SDL_GetTicksNS();
+        for (i = 0; i < iterations; ++i) {
+            for (a = 0; a < SDL_arraysize(angles); ++a) {
+                SDL_DestroySurface(SDL_RotateSurface(image, angles[a]));
+            }
+        }
+        elapsed = SDL_GetTicksNS() - start;
+        SDL_Log("%-24s %d rotations of %dx%d in %.2f ms, %.1f us/rotation",
+                SDL_GetPixelFormatName(formats[format_index]),
+                iterations * (int)SDL_arraysize(angles), IMAGE_SIZE, IMAGE_SIZE,
+                elapsed / 1000000.0, elapsed / 1000.0 / (iterations * (int)SDL_arraysize(angles)));
+    }
+}
+
 SDL_AppResult SDL_AppInit(void **appstate, int argc, char *argv[])
 {
+    int benchmark = 0;
+    int i;
+
     /* Initialize test framework */
     state = SDLTest_CommonCreateState(argv, SDL_INIT_VIDEO);
     if (!state) {
         return SDL_APP_FAILURE;
     }
 
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--benchmark") == 0) {
+                benchmark = 200;
+                consumed = 1;
+                if (argv[i + 1] && SDL_isdigit((unsigned char)*argv[i + 1])) {
+                    benchmark = SDL_atoi(argv[i + 1]);
+                    consumed = 2;
+                }
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--benchmark [iterations]]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return SDL_APP_FAILURE;
+        }
+        i += consumed;
+    }
+
+    if (benchmark > 0) {
+        /* Time SDL_RotateSurface() for each format without opening a window */
+        RunBenchmark(benchmark);
+        return SDL_APP_SUCCESS;
+    }
+
     if (!SDLTest_CommonInit(state)) {
         return SDL_APP_FAILURE;
     }
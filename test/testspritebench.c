@@ -0,0 +1,183 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark drawing sprites one call at a time against SDL_RenderSprites() */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+#include <SDL3/SDL_test_common.h>
+#include "testutils.h"
+
+#define NUM_SPRITES 10000
+
+enum
+{
+    SCENE_PLAIN,
+    SCENE_TINTED,
+    SCENE_ROTATED,
+    NUM_SCENES
+};
+
+static const char *scene_names[NUM_SCENES] = { "plain", "tinted", "rotated" };
+
+static SDL_Sprite *sprites;
+static int num_sprites = NUM_SPRITES;
+
+/* The same field of moving sprites as testsprite, with a color and angle for each */
+static void CreateSprites(SDL_Renderer *renderer, SDL_Texture *texture, int scene, int frame)
+{
+    Uint64 seed = 1;
+    int w = 0, h = 0;
+    int i;
+
+    SDL_GetCurrentRenderOutputSize(renderer, &w, &h);
+    w = SDL_max(w - texture->w, 1);
+    h = SDL_max(h - texture->h, 1);
+
+    for (i = 0; i < num_sprites; ++i) {
+        SDL_Sprite *sprite = &sprites[i];
+        const int x = SDL_rand_r(&seed, w) + frame * (1 + i % 3);
+        const int y = SDL_rand_r(&seed, h) + frame * (1 + i % 2);
+
+        SDL_zerop(sprite);
+        sprite->dstrect.x = (float)(x % w);
+        sprite->dstrect.y = (float)(y % h);
+        sprite->dstrect.w = (float)texture->w;
+        sprite->dstrect.h = (float)texture->h;
+        sprite->color.r = sprite->color.g = sprite->color.b = sprite->color.a = 1.0f;
+        if (scene == SCENE_TINTED) {
+            sprite->color.r = (float)(i % 4) / 3.0f;
+            sprite->color.b = (float)(i % 5) / 4.0f;
+            sprite->color.a = 0.5f + (float)(i % 2) / 2.0f;
+        } else if (scene == SCENE_ROTATED) {
+            sprite->angle = (double)((i * 7 + frame) % 360);
+        }
+    }
+}
+
+static void DrawSprites(SDL_Renderer *renderer, SDL_Texture *texture, bool batched)
+{
+    int i;
+
+    if (batched) {
+        SDL_RenderSprites(renderer, texture, sprites, num_sprites);
+        return;
+    }
+
+    for (i = 0; i < num_sprites; ++i) {
+        const SDL_Sprite *sprite = &sprites[i];
+
+        SDL_SetTextureColorModFloat(texture, sprite->color.r, sprite->color.g, sprite->color.b);
+        SDL_SetTextureAlphaModFloat(texture, sprite->color.a);
+        if (sprite->angle != 0.0) {
+            SDL_RenderTextureRotated(renderer, texture, NULL, &sprite->dstrect, sprite->angle, NULL, SDL_FLIP_NONE);
+        } else {
+            SDL_RenderTexture(renderer, texture, NULL, &sprite->dstrect);
+        }
+    }
+}
+
+/* Measures sprites per second, both for queueing the draws and for whole frames */
+static void TimeFrames(SDL_Renderer *renderer, SDL_Texture *texture, int scene, bool batched, int iterations, double *queue_rate, double *frame_rate)
+{
+    Uint64 queue_elapsed = 0, frame_elapsed = 0;
+    int i;
+
+    for (i = 0; i < iterations; ++i) {
+        Uint64 start, queued;
+
+        CreateSprites(renderer, texture, scene, i);
+        SDL_PumpEvents();
+
+        start = SDL_GetTicksNS();
+        SDL_SetRenderDrawColor(renderer, 0xA0, 0xA0, 0xA0, 0xFF);
+        SDL_RenderClear(renderer);
+        DrawSprites(renderer, texture, batched);
+        queued = SDL_GetTicksNS();
+        SDL_RenderPresent(renderer);
+        queue_elapsed += queued - start;
+        frame_elapsed += SDL_GetTicksNS() - start;
+    }
+    SDL_SetTextureColorMod(texture, 255, 255, 255);
+    SDL_SetTextureAlphaMod(texture, 255);
+    *queue_rate = (double)num_sprites * iterations / ((double)SDL_max(queue_elapsed, 1) / SDL_NS_PER_SECOND);
+    *frame_rate = (double)num_sprites * iterations / ((double)SDL_max(frame_elapsed, 1) / SDL_NS_PER_SECOND);
+}
+
+int main(int argc, char *argv[])
+{
+    SDLTest_CommonState *state;
+    SDL_Renderer *renderer;
+    SDL_Texture *texture;
+    int iterations = 20;
+    int i;
+
+    state = SDLTest_CommonCreateState(argv, SDL_INIT_VIDEO);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            } else if (SDL_strcasecmp(argv[i], "--sprites") == 0 && argv[i + 1]) {
+                num_sprites = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", "[--sprites N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    if (!SDLTest_CommonInit(state)) {
+        SDLTest_CommonQuit(state);
+        return 2;
+    }
+    renderer = state->renderers[0];
+
+    texture = LoadTexture(renderer, "icon.png", true);
+    sprites = (SDL_Sprite *)SDL_calloc(num_sprites, sizeof(*sprites));
+    if (!texture || !sprites) {
+        SDL_Log("Couldn't set up the sprites: %s", SDL_GetError());
+        SDL_free(sprites);
+        SDLTest_CommonQuit(state);
+        return 1;
+    }
+    SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+
+    SDL_Log("%s renderer, %d sprites, millions of sprites per second queued / drawn", SDL_GetRendererName(renderer), num_sprites);
+    for (i = 0; i < NUM_SCENES; ++i) {
+        double single_queue, single_frame, batched_queue, batched_frame;
+
+        /* Warm up, so the first measurement doesn't pay for setting things up */
+        TimeFrames(renderer, texture, i, true, 1, &batched_queue, &batched_frame);
+
+        TimeFrames(renderer, texture, i, false, iterations, &single_queue, &single_frame);
+        TimeFrames(renderer, texture, i, true, iterations, &batched_queue, &batched_frame);
+        SDL_Log("  %-8s one at a time %8.3f / %7.3f  batched %8.3f / %7.3f", scene_names[i],
+                single_queue / 1000000.0, single_frame / 1000000.0, batched_queue / 1000000.0, batched_frame / 1000000.0);
+    }
+
+    SDL_free(sprites);
+    SDLTest_CommonQuit(state);
+    return 0;
+}
@@ -0,0 +1,233 @@
+/*
+  Copyright (C) 1997-2025 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+/* Simple program: Benchmark streaming video sized frames into a texture, the way a video player would */
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include <SDL3/SDL_test.h>
+#include <SDL3/SDL_test_common.h>
+
+#define FRAME_WIDTH  1920
+#define FRAME_HEIGHT 1080
+
+/* The part of the frame that changes in the partial lock test, like a video playing in a corner of the screen */
+#define PARTIAL_WIDTH  480
+#define PARTIAL_HEIGHT 270
+
+/* How many frames the application lets an asynchronous upload run behind */
+#define UPLOADS_IN_FLIGHT 2
+
+enum
+{
+    STREAM_UPDATE,
+    STREAM_UPDATE_ASYNC,
+    STREAM_LOCK,
+    STREAM_LOCK_PARTIAL,
+    NUM_STREAM_METHODS
+};
+
+static const char *method_names[NUM_STREAM_METHODS] = { "update", "async update", "lock", "partial lock" };
+
+/* A decoded frame, tightly packed. Planar YUV frames have the U and V planes after the Y plane */
+static Uint8 *frame_pixels;
+
+static int GetFramePitch(SDL_PixelFormat format)
+{
+    return SDL_ISPIXELFORMAT_FOURCC(format) ? FRAME_WIDTH : FRAME_WIDTH * SDL_BYTESPERPIXEL(format);
+}
+
+static void GenerateFrame(SDL_PixelFormat format, int frame)
+{
+    int x, y;
+
+    if (format == SDL_PIXELFORMAT_IYUV) {
+        const size_t chroma_size = (size_t)(FRAME_WIDTH / 2) * (FRAME_HEIGHT / 2);
+        Uint8 *luma = frame_pixels;
+
+        for (y = 0; y < FRAME_HEIGHT; ++y) {
+            for (x = 0; x < FRAME_WIDTH; ++x) {
+                *luma++ = (Uint8)(x + y + frame);
+            }
+        }
+        SDL_memset(luma, (Uint8)(frame * 3), chroma_size);
+        SDL_memset(luma + chroma_size, (Uint8)(frame * 5), chroma_size);
+    } else {
+        Uint32 *pixel = (Uint32 *)frame_pixels;
+
+        for (y = 0; y < FRAME_HEIGHT; ++y) {
+            for (x = 0; x < FRAME_WIDTH; ++x) {
+                *pixel++ = 0xFF000000 | ((Uint32)((x + frame) & 0xFF) << 16) | ((Uint32)((y + frame) & 0xFF) << 8) | (Uint32)(frame & 0xFF);
+            }
+        }
+    }
+}
+
+static void CopyRows(Uint8 *dst, int dst_pitch, const Uint8 *src, int src_pitch, int row_size, int rows)
+{
+    int y;
+
+    for (y = 0; y < rows; ++y) {
+        SDL_memcpy(dst, src, row_size);
+        dst += dst_pitch;
+        src += src_pitch;
+    }
+}
+
+static void CopyFrameToLock(SDL_Texture *texture, const SDL_Rect *rect)
+{
+    const SDL_PixelFormat format = texture->format;
+    const int src_pitch = GetFramePitch(format);
+    void *pixels;
+    int pitch;
+
+    if (!SDL_LockTexture(texture, rect, &pixels, &pitch)) {
+        return;
+    }
+    if (format == SDL_PIXELFORMAT_IYUV) {
+        const Uint8 *src = frame_pixels;
+        Uint8 *dst = (Uint8 *)pixels;
+
+        CopyRows(dst, pitch, src, src_pitch, FRAME_WIDTH, FRAME_HEIGHT);
+        src += src_pitch * FRAME_HEIGHT;
+        dst += pitch * FRAME_HEIGHT;
+        CopyRows(dst, (pitch + 1) / 2, src, src_pitch / 2, FRAME_WIDTH / 2, FRAME_HEIGHT);
+    } else {
+        const Uint8 *src = frame_pixels + rect->y * src_pitch + rect->x * SDL_BYTESPERPIXEL(format);
+
+        CopyRows((Uint8 *)pixels, pitch, src, src_pitch, rect->w * SDL_BYTESPERPIXEL(format), rect->h);
+    }
+    SDL_UnlockTexture(texture);
+}
+
+static double TimeFrames(SDL_Renderer *renderer, SDL_Texture *texture, int method, int iterations)
+{
+    const SDL_Rect full = { 0, 0, FRAME_WIDTH, FRAME_HEIGHT };
+    Uint64 uploads[UPLOADS_IN_FLIGHT];
+    Uint64 elapsed = 0;
+    int i;
+
+    SDL_zeroa(uploads);
+
+    for (i = 0; i < iterations; ++i) {
+        Uint64 start;
+
+        /* Decoding the frame isn't part of what's being measured */
+        GenerateFrame(texture->format, i);
+
+        start = SDL_GetTicksNS();
+        switch (method) {
+        case STREAM_UPDATE:
+            SDL_UpdateTexture(texture, NULL, frame_pixels, GetFramePitch(texture->format));
+            break;
+        case STREAM_UPDATE_ASYNC:
+        {
+            Uint64 *slot = &uploads[i % UPLOADS_IN_FLIGHT];
+            if (*slot) {
+                SDL_WaitForTextureUpload(renderer, *slot);
+            }
+            *slot = SDL_UpdateTextureAsync(texture, NULL, frame_pixels, GetFramePitch(texture->format));
+            break;
+        }
+        case STREAM_LOCK:
+            CopyFrameToLock(texture, &full);
+            break;
+        default:
+        {
+            SDL_Rect partial;
+            partial.x = (i * 16) % (FRAME_WIDTH - PARTIAL_WIDTH);
+            partial.y = (i * 9) % (FRAME_HEIGHT - PARTIAL_HEIGHT);
+            partial.w = PARTIAL_WIDTH;
+            partial.h = PARTIAL_HEIGHT;
+            CopyFrameToLock(texture, &partial);
+            break;
+        }
+        }
+        SDL_RenderTexture(renderer, texture, NULL, NULL);
+        SDL_RenderPresent(renderer);
+        elapsed += SDL_GetTicksNS() - start;
+    }
+    return elapsed / 1000000.0 / iterations;
+}
+
+int main(int argc, char *argv[])
+{
+    static const SDL_PixelFormat formats[] = { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_IYUV };
+    SDLTest_CommonState *state;
+    SDL_Renderer *renderer;
+    int iterations = 100;
+    int i, j;
+
+    state = SDLTest_CommonCreateState(argv, SDL_INIT_VIDEO);
+    if (!state) {
+        return 1;
+    }
+
+    for (i = 1; i < argc;) {
+        int consumed;
+
+        consumed = SDLTest_CommonArg(state, i);
+        if (consumed == 0) {
+            consumed = -1;
+            if (SDL_strcasecmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_max(SDL_atoi(argv[i + 1]), 1);
+                consumed = 2;
+            }
+        }
+        if (consumed < 0) {
+            static const char *options[] = { "[--iterations N]", NULL };
+            SDLTest_CommonLogUsage(state, argv[0], options);
+            return 1;
+        }
+        i += consumed;
+    }
+
+    if (!SDLTest_CommonInit(state)) {
+        SDLTest_CommonQuit(state);
+        return 2;
+    }
+    renderer = state->renderers[0];
+
+    frame_pixels = (Uint8 *)SDL_malloc((size_t)FRAME_WIDTH * FRAME_HEIGHT * 4);
+    if (!frame_pixels) {
+        SDLTest_CommonQuit(state);
+        return 1;
+    }
+
+    SDL_Log("%s renderer, %dx%d frames, ms per frame", SDL_GetRendererName(renderer), FRAME_WIDTH, FRAME_HEIGHT);
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        SDL_Texture *texture = SDL_CreateTexture(renderer, formats[i], SDL_TEXTUREACCESS_STREAMING, FRAME_WIDTH, FRAME_HEIGHT);
+
+        if (!texture) {
+            SDL_Log("Couldn't create %s texture: %s", SDL_GetPixelFormatName(formats[i]), SDL_GetError());
+            continue;
+        }
+        for (j = 0; j < NUM_STREAM_METHODS; ++j) {
+            double elapsed;
+
+            /* Planar YUV textures can only be locked as a whole */
+            if (j == STREAM_LOCK_PARTIAL && SDL_ISPIXELFORMAT_FOURCC(formats[i])) {
+                continue;
+            }
+
+            /* Warm up, so the first measurement doesn't pay for setting things up */
+            TimeFrames(renderer, texture, j, 1);
+
+            elapsed = TimeFrames(renderer, texture, j, iterations);
+            SDL_Log("  %-24s %-12s %8.3f", SDL_GetPixelFormatName(formats[i]), method_names[j], elapsed);
+        }
+        SDL_DestroyTexture(texture);
+    }
+
+    SDL_free(frame_pixels);
+    SDLTest_CommonQuit(state);
+    return 0;
+}
@@ -161,6 +161,40 @@ static bool run_automated_tests(int pattern_size, int extra_pitch)
         }
     }
 
+    /* Verify the chroma filters, which all match the default on 2x2 blocks of color */
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        const char *filters[] = { "point", "sited" };
+        const int yuv_size = MAX_YUV_SURFACE_SIZE(pattern->w, pattern->h, extra_pitch);
+
+        if (is_packed_yuv_format(formats[i])) {
+            continue;
+        }
+
+        yuv1_pitch = CalculateYUVPitch(formats[i], pattern->w) + extra_pitch;
+        SDL_memset(yuv1, 0, yuv_len);
+        if (!SDL_ConvertPixelsAndColorspace(pattern->w, pattern->h, pattern->format, SDL_COLORSPACE_SRGB, 0, pattern->pixels, pattern->pitch, formats[i], colorspace, 0, yuv1, yuv1_pitch)) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s", SDL_GetPixelFormatName(pattern->format), SDL_GetPixelFormatName(formats[i]), SDL_GetError());
+            goto done;
+        }
+        for (j = 0; j < SDL_arraysize(filters); ++j) {
+            SDL_PropertiesID props = SDL_CreateProperties();
+            bool converted;
+
+            SDL_SetStringProperty(props, SDL_PROP_SURFACE_CHROMA_FILTER_STRING, filters[j]);
+            SDL_memset(yuv2, 0, yuv_len);
+            converted = SDL_ConvertPixelsAndColorspace(pattern->w, pattern->h, pattern->format, SDL_COLORSPACE_SRGB, 0, pattern->pixels, pattern->pitch, formats[i], colorspace, props, yuv2, yuv1_pitch);
+            SDL_DestroyProperties(props);
+            if (!converted) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s", SDL_GetPixelFormatName(pattern->format), SDL_GetPixelFormatName(formats[i]), SDL_GetError());
+                goto done;
+            }
+            if (SDL_memcmp(yuv1, yuv2, yuv_size) != 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Chroma filter \"%s\" doesn't match the default for %s", filters[j], SDL_GetPixelFormatName(formats[i]));
+                goto done;
+            }
+        }
+    }
+
     /* Verify conversion between YUV formats */
     for (i = 0; i < SDL_arraysize(formats); ++i) {
         for (j = 0; j < SDL_arraysize(formats); ++j) {
@@ -362,6 +396,78 @@ done:
     return result;
 }
 
+static void run_benchmark(int iterations)
+{
+    const Uint32 yuv_formats[] = {
+        SDL_PIXELFORMAT_YV12,
+        SDL_PIXELFORMAT_IYUV,
+        SDL_PIXELFORMAT_NV12,
+        SDL_PIXELFORMAT_NV21,
+        SDL_PIXELFORMAT_YUY2,
+        SDL_PIXELFORMAT_UYVY,
+        SDL_PIXELFORMAT_YVYU,
+        SDL_PIXELFORMAT_P010
+    };
+    const Uint32 rgb_formats[] = {
+        SDL_PIXELFORMAT_RGB565,
+        SDL_PIXELFORMAT_RGB24,
+        SDL_PIXELFORMAT_XRGB8888,
+        SDL_PIXELFORMAT_XBGR8888,
+        SDL_PIXELFORMAT_RGBX8888,
+        SDL_PIXELFORMAT_BGRX8888,
+        SDL_PIXELFORMAT_XBGR2101010
+    };
+    const int w = 1920, h = 1080;
+    SDL_Surface *pattern = generate_test_pattern(w);
+    Uint8 *yuv = (Uint8 *)SDL_malloc(MAX_YUV_SURFACE_SIZE(w, h, 0));
+    Uint8 *rgb = (Uint8 *)SDL_malloc(w * h * 4);
+    int i, j, n;
+
+    if (!pattern || !yuv || !rgb) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't allocate benchmark surfaces");
+        goto done;
+    }
+
+    SDL_Log("Converting %dx%d frames, %d iterations", w, h, iterations);
+    for (i = 0; i < SDL_arraysize(yuv_formats); ++i) {
+        const bool is_p010 = (yuv_formats[i] == SDL_PIXELFORMAT_P010);
+        const YUV_CONVERSION_MODE mode = is_p010 ? YUV_CONVERSION_BT2020 : YUV_CONVERSION_BT709;
+        const SDL_Colorspace colorspace = GetColorspaceForYUVConversionMode(mode);
+        /* Keep the color primaries and transfer function, so P010 is converted directly */
+        const SDL_Colorspace rgb_colorspace = is_p010 ? SDL_COLORSPACE_HDR10 : SDL_COLORSPACE_SRGB;
+        const int yuv_pitch = CalculateYUVPitch(yuv_formats[i], w);
+
+        ConvertRGBtoYUV(yuv_formats[i], pattern->pixels, pattern->pitch, yuv, w, h, mode, 0, 100);
+        for (j = 0; j < SDL_arraysize(rgb_formats); ++j) {
+            const int rgb_pitch = w * SDL_BYTESPERPIXEL(rgb_formats[j]);
+            Uint64 start, elapsed;
+
+            if (rgb_formats[j] == SDL_PIXELFORMAT_XBGR2101010 && !is_p010) {
+                continue;
+            }
+
+            start = SDL_GetTicksNS();
+            for (n = 0; n < iterations; ++n) {
+                if (!SDL_ConvertPixelsAndColorspace(w, h, yuv_formats[i], colorspace, 0, yuv, yuv_pitch, rgb_formats[j], rgb_colorspace, 0, rgb, rgb_pitch)) {
+                    SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't convert %s to %s: %s", SDL_GetPixelFormatName(yuv_formats[i]), SDL_GetPixelFormatName(rgb_formats[j]), SDL_GetError());
+                    goto done;
+                }
+            }
+            elapsed = SDL_GetTicksNS() - start;
+            SDL_Log("%-20s -> %-28s %7.3f ms/frame, %8.1f Mpixels/s",
+                    SDL_GetPixelFormatName(yuv_formats[i]),
+                    SDL_GetPixelFormatName(rgb_formats[j]),
+                    elapsed / 1000000.0 / iterations,
+                    ((double)w * h * iterations) / (elapsed / 1000.0));
+        }
+    }
+
+done:
+    SDL_free(yuv);
+    SDL_free(rgb);
+    SDL_DestroySurface(pattern);
+}
+
 int main(int argc, char **argv)
 {
     struct
@@ -423,6 +529,7 @@ int main(int argc, char **argv)
     int i, iterations = 100;
     bool should_run_automated_tests = false;
     bool should_run_colorspace_test = false;
+    bool should_run_benchmark = false;
     SDLTest_CommonState *state;
 
     /* Initialize test framework */
@@ -509,6 +616,12 @@ int main(int argc, char **argv)
             } else if (SDL_strcmp(argv[i], "--colorspace-test") == 0) {
                 should_run_colorspace_test = true;
                 consumed = 1;
+            } else if (SDL_strcmp(argv[i], "--benchmark") == 0) {
+                should_run_benchmark = true;
+                consumed = 1;
+            } else if (SDL_strcmp(argv[i], "--iterations") == 0 && argv[i + 1]) {
+                iterations = SDL_atoi(argv[i + 1]);
+                consumed = 2;
             } else if (SDL_strcmp(argv[i], "--renderer") == 0 && argv[i + 1]) {
                 renderer_name = argv[i + 1];
                 consumed = 2;
@@ -524,6 +637,7 @@ int main(int argc, char **argv)
                 "[--rgb555|--rgb565|--rgb24|--argb|--abgr|--rgba|--bgra]",
                 "[--monochrome] [--luminance N%] [--planar]",
                 "[--automated] [--colorspace-test] [--renderer NAME]",
+                "[--benchmark] [--iterations N]",
                 "[sample.png]",
                 NULL,
             };
@@ -549,6 +663,13 @@ int main(int argc, char **argv)
         return 0;
     }
 
+    if (should_run_benchmark) {
+        run_benchmark(iterations);
+        SDL_Quit();
+        SDLTest_CommonDestroyState(state);
+        return 0;
+    }
+
     if (should_run_colorspace_test) {
         if (!run_colorspace_test()) {
             return 2;